@@ -0,0 +1,222 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateDistanceField.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/CalculateSignedDistanceField.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  /// Latitude-longitude sphere with outward-facing triangles.
+  FieldHandle makeSphere(double radius, int rings, int segments)
+  {
+    FieldInformation fi(TRISURFMESH_E, LINEARDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    auto vmesh = field->vmesh();
+
+    const double pi = std::acos(-1.0);
+    vmesh->add_point(Point(0, 0, radius));
+    for (int r = 1; r < rings; ++r)
+    {
+      const double theta = pi * r / rings;
+      for (int s = 0; s < segments; ++s)
+      {
+        const double phi = 2 * pi * s / segments;
+        vmesh->add_point(Point(radius * std::sin(theta) * std::cos(phi),
+          radius * std::sin(theta) * std::sin(phi), radius * std::cos(theta)));
+      }
+    }
+    vmesh->add_point(Point(0, 0, -radius));
+
+    const VMesh::index_type south = 1 + (rings - 1) * segments;
+    auto at = [segments](int r, int s) { return static_cast<VMesh::index_type>(1 + (r - 1) * segments + s % segments); };
+    VMesh::Node::array_type tri(3);
+    for (int s = 0; s < segments; ++s)
+    {
+      tri[0] = at(1, s); tri[1] = at(1, s + 1); tri[2] = 0;
+      vmesh->add_elem(tri);
+      for (int r = 1; r + 1 < rings; ++r)
+      {
+        tri[0] = at(r + 1, s); tri[1] = at(r + 1, s + 1); tri[2] = at(r, s + 1);
+        vmesh->add_elem(tri);
+        tri[0] = at(r + 1, s); tri[1] = at(r, s + 1); tri[2] = at(r, s);
+        vmesh->add_elem(tri);
+      }
+      tri[0] = south; tri[1] = at(rings - 1, s + 1); tri[2] = at(rings - 1, s);
+      vmesh->add_elem(tri);
+    }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  std::vector<double> valuesOf(FieldHandle field)
+  {
+    std::vector<double> values;
+    field->vfield()->get_values(values);
+    return values;
+  }
+
+  const double radius = 0.6;
+}
+
+class CalculateDistanceFieldFastSweepingTests : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    sphere_ = makeSphere(radius, 24, 48);
+  }
+
+  FieldHandle sphere_;
+};
+
+TEST_F(CalculateDistanceFieldFastSweepingTests, SignedDistanceIsExactInBandAndCloseOutside)
+{
+  const size_type n = 41;
+  const double step = 2.0 / (n - 1);
+  auto grid = CreateEmptyLatVol(n, n, n);
+
+  CalculateSignedDistanceFieldAlgo algo;
+  FieldHandle exactField, sweptField;
+  ASSERT_TRUE(algo.run(grid, sphere_, exactField));
+  algo.set(Parameters::UseFastSweeping, true);
+  ASSERT_TRUE(algo.run(grid, sphere_, sweptField));
+
+  const auto exact = valuesOf(exactField);
+  const auto swept = valuesOf(sweptField);
+  ASSERT_EQ(exact.size(), swept.size());
+
+  const double band = 2.0 * step;
+  double maxError = 0;
+  for (size_t i = 0; i < exact.size(); ++i)
+  {
+    if (std::fabs(exact[i]) <= band)
+      ASSERT_EQ(exact[i], swept[i]) << i;
+    else
+    {
+      ASSERT_EQ(exact[i] < 0, swept[i] < 0) << i;
+      maxError = std::max(maxError, std::fabs(exact[i] - swept[i]));
+    }
+  }
+  EXPECT_LT(maxError, step);
+
+  // Far corner of the grid lies well outside the sphere, its center well inside.
+  EXPECT_NEAR(std::sqrt(3.0) - radius, swept.back(), step);
+  EXPECT_LT(swept[(n * n * n) / 2], -radius + 2 * step);
+}
+
+TEST_F(CalculateDistanceFieldFastSweepingTests, ElementCentersUseTheCellGrid)
+{
+  FieldInformation fi(LATVOLMESH_E, CONSTANTDATA_E, DOUBLE_E);
+  MeshHandle mesh = CreateMesh(fi, 21, 17, 25, Point(-1, -0.8, -1.2), Point(1, 0.8, 1.2));
+  FieldHandle grid = CreateField(fi, mesh);
+
+  CalculateSignedDistanceFieldAlgo algo;
+  FieldHandle exactField, sweptField;
+  ASSERT_TRUE(algo.run(grid, sphere_, exactField));
+  algo.set(Parameters::UseFastSweeping, true);
+  ASSERT_TRUE(algo.run(grid, sphere_, sweptField));
+
+  const auto exact = valuesOf(exactField);
+  const auto swept = valuesOf(sweptField);
+  ASSERT_EQ(20u * 16u * 24u, swept.size());
+  for (size_t i = 0; i < exact.size(); ++i)
+  {
+    ASSERT_EQ(exact[i] < 0, swept[i] < 0) << i;
+    ASSERT_NEAR(exact[i], swept[i], 0.1) << i;
+  }
+}
+
+TEST_F(CalculateDistanceFieldFastSweepingTests, UnsignedDistanceRespectsTruncation)
+{
+  auto grid = CreateEmptyLatVol(33, 33, 33);
+
+  CalculateDistanceFieldAlgo algo;
+  algo.set(Parameters::Truncate, true);
+  algo.set(Parameters::TruncateDistance, 0.5);
+  FieldHandle exactField, sweptField;
+  ASSERT_TRUE(algo.runImpl(grid, sphere_, exactField));
+  algo.set(Parameters::UseFastSweeping, true);
+  ASSERT_TRUE(algo.runImpl(grid, sphere_, sweptField));
+
+  const auto exact = valuesOf(exactField);
+  const auto swept = valuesOf(sweptField);
+  const double step = 2.0 / 32;
+  for (size_t i = 0; i < exact.size(); ++i)
+  {
+    ASSERT_GE(swept[i], 0.0);
+    ASSERT_LE(swept[i], 0.5);
+    if (exact[i] <= 2.0 * step)
+      ASSERT_EQ(exact[i], swept[i]) << i;
+    else
+      ASSERT_NEAR(exact[i], swept[i], step) << i;
+  }
+}
+
+TEST_F(CalculateDistanceFieldFastSweepingTests, UnstructuredInputFallsBackToExactDistances)
+{
+  auto tets = CubeTetVolLinearBasis(DOUBLE_E);
+
+  CalculateSignedDistanceFieldAlgo algo;
+  FieldHandle exactField, sweptField;
+  ASSERT_TRUE(algo.run(tets, sphere_, exactField));
+  algo.set(Parameters::UseFastSweeping, true);
+  ASSERT_TRUE(algo.run(tets, sphere_, sweptField));
+
+  EXPECT_EQ(valuesOf(exactField), valuesOf(sweptField));
+}
+
+TEST_F(CalculateDistanceFieldFastSweepingTests, ValueOutputComputesExactDistances)
+{
+  auto grid = CreateEmptyLatVol(17, 17, 17);
+
+  CalculateSignedDistanceFieldAlgo algo;
+  FieldHandle exactField, sweptField, value;
+  ASSERT_TRUE(algo.run(grid, sphere_, exactField));
+  algo.set(Parameters::UseFastSweeping, true);
+  ASSERT_TRUE(algo.run(grid, sphere_, sweptField, value));
+  EXPECT_EQ(valuesOf(exactField), valuesOf(sweptField));
+
+  CalculateDistanceFieldAlgo unsignedAlgo;
+  ASSERT_TRUE(unsignedAlgo.runImpl(grid, sphere_, exactField));
+  unsignedAlgo.set(Parameters::UseFastSweeping, true);
+  ASSERT_TRUE(unsignedAlgo.runImpl(grid, sphere_, sweptField, value));
+  EXPECT_EQ(valuesOf(exactField), valuesOf(sweptField));
+}
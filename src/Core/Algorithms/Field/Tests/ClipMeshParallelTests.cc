@@ -0,0 +1,379 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Legacy/Fields/ClipMesh/ClipMeshByIsovalue.h>
+#include <Core/Algorithms/Legacy/Fields/ClipMesh/ClipMeshBySelection.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <tuple>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  /// Lattice of n^3 cubes over [-1,1]^3 with node values x^2 + y^2 + z^2.
+  /// Tets split every cube into six around its main diagonal, which keeps
+  /// neighboring cubes conforming.
+  FieldHandle makeLattice(mesh_info_type meshType, int n)
+  {
+    FieldInformation fi(meshType, LINEARDATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    auto vmesh = field->vmesh();
+    const int nn = n + 1;
+    vmesh->node_reserve(nn * nn * nn);
+    for (int k = 0; k < nn; ++k)
+      for (int j = 0; j < nn; ++j)
+        for (int i = 0; i < nn; ++i)
+          vmesh->add_point(Point(2.0 * i / n - 1, 2.0 * j / n - 1, 2.0 * k / n - 1));
+
+    auto node = [nn](int i, int j, int k) { return static_cast<VMesh::index_type>((k * nn + j) * nn + i); };
+    const int axes[6][3] = { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+    const bool tets = (meshType == TETVOLMESH_E);
+    vmesh->elem_reserve(static_cast<size_t>(n) * n * n * (tets ? 6 : 1));
+    VMesh::Node::array_type nodes(tets ? 4 : 8);
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+          if (tets)
+          {
+            for (const auto& a : axes)
+            {
+              int c[3] = { i, j, k };
+              nodes[0] = node(c[0], c[1], c[2]);
+              c[a[0]]++;
+              nodes[1] = node(c[0], c[1], c[2]);
+              c[a[1]]++;
+              nodes[2] = node(c[0], c[1], c[2]);
+              c[a[2]]++;
+              nodes[3] = node(c[0], c[1], c[2]);
+              vmesh->add_elem(nodes);
+            }
+          }
+          else
+          {
+            nodes[0] = node(i, j, k);     nodes[1] = node(i+1, j, k);
+            nodes[2] = node(i+1, j+1, k); nodes[3] = node(i, j+1, k);
+            nodes[4] = node(i, j, k+1);   nodes[5] = node(i+1, j, k+1);
+            nodes[6] = node(i+1, j+1, k+1); nodes[7] = node(i, j+1, k+1);
+            vmesh->add_elem(nodes);
+          }
+        }
+
+    auto vfield = field->vfield();
+    vfield->resize_values();
+    Point p;
+    for (VMesh::Node::index_type idx = 0; idx < vmesh->num_nodes(); ++idx)
+    {
+      vmesh->get_center(p, idx);
+      vfield->set_value(Vector(p).length2(), idx);
+    }
+    return field;
+  }
+
+  double tetVolume(VMesh* mesh)
+  {
+    double volume = 0;
+    VMesh::Node::array_type nodes;
+    VMesh::points_type p;
+    for (VMesh::Elem::index_type idx = 0; idx < mesh->num_elems(); ++idx)
+    {
+      mesh->get_nodes(nodes, idx);
+      mesh->get_centers(p, nodes);
+      volume += std::fabs(Dot(Cross(p[1] - p[0], p[2] - p[0]), p[3] - p[0])) / 6.0;
+    }
+    return volume;
+  }
+
+  std::vector<double> valuesOf(FieldHandle field)
+  {
+    std::vector<double> values;
+    field->vfield()->get_values(values);
+    return values;
+  }
+
+  // Off the lattice values, so no cut lands exactly on an input node.
+  const double isovalue = 0.55;
+}
+
+TEST(ClipMeshParallelTests, TetClipSplitsVolumeAndMergesSharedNodes)
+{
+  auto lattice = makeLattice(TETVOLMESH_E, 12);
+
+  ClipMeshByIsovalueAlgo algo;
+  algo.set(ClipMeshByIsovalueAlgo::ScalarIsoValue, isovalue);
+  FieldHandle inside, outside;
+  algo.set(ClipMeshByIsovalueAlgo::LessThanIsoValue, false);
+  ASSERT_TRUE(algo.run(lattice, inside));
+  algo.set(ClipMeshByIsovalueAlgo::LessThanIsoValue, true);
+  ASSERT_TRUE(algo.run(lattice, outside));
+
+  // The two sides tile the cube and the inside approximates the ball.
+  const double vin = tetVolume(inside->vmesh());
+  const double vout = tetVolume(outside->vmesh());
+  EXPECT_NEAR(8.0, vin + vout, 1e-9);
+  EXPECT_NEAR(4.0 / 3.0 * M_PI * std::pow(isovalue, 1.5), vin, 0.1);
+
+  // Edge and face nodes shared by neighboring elements appear once.
+  auto mesh = inside->vmesh();
+  std::set<std::tuple<double, double, double>> positions;
+  Point p;
+  for (VMesh::Node::index_type idx = 0; idx < mesh->num_nodes(); ++idx)
+  {
+    mesh->get_center(p, idx);
+    positions.insert(std::make_tuple(p.x(), p.y(), p.z()));
+  }
+  EXPECT_EQ(mesh->num_nodes(), static_cast<size_type>(positions.size()));
+  EXPECT_EQ(mesh->num_nodes(), inside->vfield()->num_values());
+
+  // Every node is referenced and values never cross the isovalue.
+  std::vector<char> referenced(mesh->num_nodes(), 0);
+  VMesh::Node::array_type nodes;
+  for (VMesh::Elem::index_type idx = 0; idx < mesh->num_elems(); ++idx)
+  {
+    mesh->get_nodes(nodes, idx);
+    for (auto n : nodes)
+      referenced[n] = 1;
+  }
+  EXPECT_EQ(std::count(referenced.begin(), referenced.end(), 1), mesh->num_nodes());
+  for (double v : valuesOf(inside))
+    EXPECT_LE(v, isovalue + 1e-12);
+}
+
+TEST(ClipMeshParallelTests, TetMappingInterpolatesOutputValues)
+{
+  auto lattice = makeLattice(TETVOLMESH_E, 8);
+
+  ClipMeshByIsovalueAlgo algo;
+  algo.set(ClipMeshByIsovalueAlgo::ScalarIsoValue, isovalue);
+  algo.set(ClipMeshByIsovalueAlgo::LessThanIsoValue, false);
+  FieldHandle output;
+  MatrixHandle mapping;
+  ASSERT_TRUE(algo.run(lattice, output, mapping));
+
+  auto matrix = boost::dynamic_pointer_cast<SparseRowMatrix>(mapping);
+  ASSERT_TRUE(matrix != nullptr);
+  ASSERT_EQ(output->vmesh()->num_nodes(), matrix->nrows());
+  ASSERT_EQ(lattice->vmesh()->num_nodes(), matrix->ncols());
+
+  auto in = valuesOf(lattice);
+  auto out = valuesOf(output);
+  Eigen::Map<Eigen::VectorXd> x(in.data(), in.size());
+  Eigen::VectorXd mapped = *matrix * x;
+  for (size_t i = 0; i < out.size(); ++i)
+    EXPECT_NEAR(out[i], mapped[i], 1e-12);
+
+  FieldHandle withoutMapping;
+  ASSERT_TRUE(algo.run(lattice, withoutMapping));
+  EXPECT_EQ(out, valuesOf(withoutMapping));
+}
+
+TEST(ClipMeshParallelTests, HexClipKeepsValuesAndAddsSheet)
+{
+  auto lattice = makeLattice(HEXVOLMESH_E, 8);
+
+  ClipMeshByIsovalueAlgo algo;
+  algo.set(ClipMeshByIsovalueAlgo::ScalarIsoValue, isovalue);
+  algo.set(ClipMeshByIsovalueAlgo::LessThanIsoValue, true);
+  FieldHandle output;
+  MatrixHandle mapping;
+  ASSERT_TRUE(algo.run(lattice, output, mapping));
+
+  auto mesh = output->vmesh();
+  ASSERT_GT(mesh->num_elems(), 0);
+  auto matrix = boost::dynamic_pointer_cast<SparseRowMatrix>(mapping);
+  ASSERT_TRUE(matrix != nullptr);
+  ASSERT_EQ(mesh->num_nodes(), matrix->nrows());
+
+  // Nodes kept from the input carry their values, the projected sheet
+  // nodes sit on the isosurface, and every mapping row is a partition of unity.
+  auto out = valuesOf(output);
+  auto in = valuesOf(lattice);
+  Point p;
+  for (index_type row = 0; row < matrix->nrows(); ++row)
+  {
+    double sum = 0;
+    for (SparseRowMatrix::InnerIterator it(*matrix, row); it; ++it)
+      sum += it.value();
+    EXPECT_NEAR(1.0, sum, 1e-9);
+    mesh->get_center(p, VMesh::Node::index_type(row));
+    if (out[row] != isovalue)
+      EXPECT_NEAR(Vector(p).length2(), out[row], 1e-12);
+  }
+}
+
+TEST(ClipMeshParallelTests, SelectionKeepsElementOrderAndBuildsMapping)
+{
+  auto lattice = makeLattice(TETVOLMESH_E, 6);
+  auto imesh = lattice->vmesh();
+
+  FieldInformation fi(lattice);
+  fi.make_constantdata();
+  fi.make_char();
+  FieldHandle selection = CreateField(fi, lattice->mesh());
+  selection->vfield()->resize_values();
+  for (VMesh::Elem::index_type idx = 0; idx < imesh->num_elems(); ++idx)
+    selection->vfield()->set_value(static_cast<char>(idx % 3 == 0), idx);
+
+  ClipMeshBySelectionAlgo algo;
+  FieldHandle output;
+  MatrixHandle mapping;
+  ASSERT_TRUE(algo.runImpl(lattice, selection, output, mapping));
+
+  auto omesh = output->vmesh();
+  ASSERT_EQ((imesh->num_elems() + 2) / 3, omesh->num_elems());
+  VMesh::Node::array_type inodes, onodes;
+  Point pi, po;
+  for (VMesh::Elem::index_type idx = 0; idx < omesh->num_elems(); ++idx)
+  {
+    imesh->get_nodes(inodes, VMesh::Elem::index_type(3 * idx));
+    omesh->get_nodes(onodes, idx);
+    for (size_t k = 0; k < onodes.size(); ++k)
+    {
+      imesh->get_center(pi, inodes[k]);
+      omesh->get_center(po, onodes[k]);
+      EXPECT_EQ(pi, po);
+    }
+  }
+
+  auto matrix = boost::dynamic_pointer_cast<SparseRowMatrix>(mapping);
+  ASSERT_TRUE(matrix != nullptr);
+  EXPECT_EQ(omesh->num_nodes(), matrix->nrows());
+  EXPECT_EQ(omesh->num_nodes(), matrix->nonZeros());
+  auto in = valuesOf(lattice);
+  auto out = valuesOf(output);
+  for (index_type row = 0; row < matrix->nrows(); ++row)
+    for (SparseRowMatrix::InnerIterator it(*matrix, row); it; ++it)
+      EXPECT_EQ(in[it.col()], out[row]);
+
+  algo.setOption(Parameters::ClipMethod, "All Nodes");
+  FieldInformation nodeInfo(TETVOLMESH_E, LINEARDATA_E, CHAR_E);
+  FieldHandle nodeSelection = CreateField(nodeInfo, lattice->mesh());
+  nodeSelection->vfield()->resize_values();
+  Point p;
+  for (VMesh::Node::index_type idx = 0; idx < imesh->num_nodes(); ++idx)
+  {
+    imesh->get_center(p, idx);
+    nodeSelection->vfield()->set_value(static_cast<char>(p.x() <= 0), idx);
+  }
+  ASSERT_TRUE(algo.runImpl(lattice, nodeSelection, output));
+  EXPECT_EQ(imesh->num_elems() / 2, output->vmesh()->num_elems());
+  EXPECT_NEAR(4.0, tetVolume(output->vmesh()), 1e-9);
+}
+
+TEST(ClipMeshParallelTests, ResultDoesNotDependOnTaskCount)
+{
+  // NumCores does not cap forced task counts, so every split below runs as
+  // that many ranges even on a single core.
+  auto tets = makeLattice(TETVOLMESH_E, 20);
+  auto hexes = makeLattice(HEXVOLMESH_E, 12);
+
+  ClipMeshByIsovalueAlgo algo;
+  algo.set(ClipMeshByIsovalueAlgo::ScalarIsoValue, isovalue);
+  algo.set(ClipMeshByIsovalueAlgo::LessThanIsoValue, false);
+  FieldInformation fi(tets);
+  fi.make_constantdata();
+  fi.make_char();
+  FieldHandle selection = CreateField(fi, tets->mesh());
+  selection->vfield()->resize_values();
+  for (VMesh::Elem::index_type idx = 0; idx < tets->vmesh()->num_elems(); ++idx)
+    selection->vfield()->set_value(static_cast<char>(idx % 2), idx);
+  ClipMeshBySelectionAlgo selectAlgo;
+
+  const int taskCounts[] = { 1, 3, 7 };
+  FieldHandle output[3][3];
+  MatrixHandle mapping[3][3];
+  for (int pass = 0; pass < 3; ++pass)
+  {
+    Parallel::ForceTaskCount(taskCounts[pass]);
+    ASSERT_TRUE(algo.run(tets, output[0][pass], mapping[0][pass]));
+    ASSERT_TRUE(algo.run(hexes, output[1][pass], mapping[1][pass]));
+    ASSERT_TRUE(selectAlgo.runImpl(tets, selection, output[2][pass], mapping[2][pass]));
+  }
+  Parallel::ForceTaskCount(0);
+  EXPECT_EQ(tets->vmesh()->num_elems() / 2, output[2][0]->vmesh()->num_elems());
+
+  for (int run = 0; run < 3; ++run)
+    for (int pass = 1; pass < 3; ++pass)
+    {
+      SCOPED_TRACE(testing::Message() << "run " << run << ", " << taskCounts[pass] << " tasks");
+      auto expected = output[run][0]->vmesh();
+      auto actual = output[run][pass]->vmesh();
+      ASSERT_EQ(expected->num_nodes(), actual->num_nodes());
+      ASSERT_EQ(expected->num_elems(), actual->num_elems());
+      ASSERT_GT(actual->num_elems(), 0);
+
+      Point p, q;
+      for (VMesh::Node::index_type idx = 0; idx < expected->num_nodes(); ++idx)
+      {
+        expected->get_center(p, idx);
+        actual->get_center(q, idx);
+        EXPECT_EQ(p, q) << "node " << idx;
+      }
+      VMesh::Node::array_type a, b;
+      for (VMesh::Elem::index_type idx = 0; idx < expected->num_elems(); ++idx)
+      {
+        expected->get_nodes(a, idx);
+        actual->get_nodes(b, idx);
+        EXPECT_EQ(a, b) << "element " << idx;
+      }
+      EXPECT_EQ(valuesOf(output[run][0]), valuesOf(output[run][pass]));
+
+      auto m0 = boost::dynamic_pointer_cast<SparseRowMatrix>(mapping[run][0]);
+      auto m1 = boost::dynamic_pointer_cast<SparseRowMatrix>(mapping[run][pass]);
+      ASSERT_TRUE(m0 && m1);
+      ASSERT_EQ(m0->nrows(), m1->nrows());
+      ASSERT_EQ(m0->ncols(), m1->ncols());
+      ASSERT_EQ(m0->nonZeros(), m1->nonZeros());
+      for (index_type row = 0; row < m0->nrows(); ++row)
+      {
+        SparseRowMatrix::InnerIterator i0(*m0, row), i1(*m1, row);
+        for (; i0 && i1; ++i0, ++i1)
+        {
+          EXPECT_EQ(i0.col(), i1.col()) << "row " << row;
+          EXPECT_EQ(i0.value(), i1.value()) << "row " << row;
+        }
+        EXPECT_EQ(bool(i0), bool(i1)) << "row " << row;
+      }
+    }
+}
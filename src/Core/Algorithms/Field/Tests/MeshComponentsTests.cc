@@ -0,0 +1,265 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/MeshDerivatives/SplitByConnectedRegion.h>
+#include <Core/Algorithms/Legacy/Fields/DomainFields/SplitFieldByDomainAlgo.h>
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+namespace
+{
+  /// Row of separate tet lattices of n^3 cubes each. Nodes and elements are
+  /// shuffled, so the islands interleave in both lists. Node values are the
+  /// node indices, element values the island index modulo four, minus one.
+  FieldHandle makeIslands(int numIslands, int n, databasis_info_type basis)
+  {
+    const int nn = n + 1;
+    const int nodesPerIsland = nn * nn * nn;
+    std::vector<Point> points;
+    for (int island = 0; island < numIslands; ++island)
+      for (int k = 0; k < nn; ++k)
+        for (int j = 0; j < nn; ++j)
+          for (int i = 0; i < nn; ++i)
+            points.push_back(Point(3.0 * island + static_cast<double>(i) / n, static_cast<double>(j) / n, static_cast<double>(k) / n));
+
+    std::mt19937 random(7);
+    std::vector<VMesh::index_type> nodeOrder(points.size());
+    for (size_t j = 0; j < nodeOrder.size(); ++j) nodeOrder[j] = j;
+    std::shuffle(nodeOrder.begin(), nodeOrder.end(), random);
+
+    const int axes[6][3] = { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+    std::vector<std::pair<int, std::vector<VMesh::index_type>>> tets;
+    for (int island = 0; island < numIslands; ++island)
+      for (int k = 0; k < n; ++k)
+        for (int j = 0; j < n; ++j)
+          for (int i = 0; i < n; ++i)
+            for (const auto& a : axes)
+            {
+              std::vector<VMesh::index_type> tet;
+              int c[3] = { i, j, k };
+              for (int v = 0; v < 4; ++v)
+              {
+                tet.push_back(nodeOrder[island * nodesPerIsland + (c[2] * nn + c[1]) * nn + c[0]]);
+                if (v < 3) c[a[v]]++;
+              }
+              tets.push_back(std::make_pair(island, tet));
+            }
+    std::shuffle(tets.begin(), tets.end(), random);
+
+    FieldInformation fi(TETVOLMESH_E, basis, basis == CONSTANTDATA_E ? INT_E : DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    auto vmesh = field->vmesh();
+    std::vector<Point> shuffled(points.size());
+    for (size_t j = 0; j < points.size(); ++j) shuffled[nodeOrder[j]] = points[j];
+    vmesh->node_reserve(shuffled.size());
+    for (const auto& p : shuffled) vmesh->add_point(p);
+    vmesh->elem_reserve(tets.size());
+    VMesh::Node::array_type nodes(4);
+    for (const auto& tet : tets)
+    {
+      std::copy(tet.second.begin(), tet.second.end(), nodes.begin());
+      vmesh->add_elem(nodes);
+    }
+
+    auto vfield = field->vfield();
+    vfield->resize_values();
+    if (basis == CONSTANTDATA_E)
+    {
+      for (VMesh::Elem::index_type idx = 0; idx < vmesh->num_elems(); ++idx)
+        vfield->set_value(tets[idx].first % 4 - 1, idx);
+    }
+    else
+    {
+      for (VMesh::Node::index_type idx = 0; idx < vmesh->num_nodes(); ++idx)
+        vfield->set_value(static_cast<double>(idx), idx);
+    }
+    return field;
+  }
+
+  /// A piece as a list of input nodes and elements, in output order.
+  struct Piece
+  {
+    std::vector<VMesh::index_type> nodes;
+    std::vector<VMesh::index_type> elems;
+  };
+
+  /// Checks an output field against the input nodes and elements it should hold.
+  void expectPiece(FieldHandle input, const Piece& piece, FieldHandle output)
+  {
+    auto imesh = input->vmesh();
+    auto omesh = output->vmesh();
+    ASSERT_EQ(piece.nodes.size(), omesh->num_nodes());
+    ASSERT_EQ(piece.elems.size(), omesh->num_elems());
+
+    std::map<VMesh::index_type, VMesh::index_type> renumber;
+    Point ip, op;
+    for (size_t q = 0; q < piece.nodes.size(); ++q)
+    {
+      renumber[piece.nodes[q]] = q;
+      imesh->get_center(ip, VMesh::Node::index_type(piece.nodes[q]));
+      omesh->get_center(op, VMesh::Node::index_type(q));
+      ASSERT_EQ(ip, op);
+    }
+
+    VMesh::Node::array_type inodes, onodes;
+    for (size_t q = 0; q < piece.elems.size(); ++q)
+    {
+      imesh->get_nodes(inodes, VMesh::Elem::index_type(piece.elems[q]));
+      omesh->get_nodes(onodes, VMesh::Elem::index_type(q));
+      ASSERT_EQ(inodes.size(), onodes.size());
+      for (size_t r = 0; r < inodes.size(); ++r)
+        ASSERT_EQ(renumber[inodes[r]], onodes[r]);
+    }
+  }
+}
+
+TEST(MeshComponentsTests, ConnectedRegionsMatchElementWalk)
+{
+  auto input = makeIslands(37, 3, LINEARDATA_E);
+  auto imesh = input->vmesh();
+
+  // Reference: regions in the order a walk over the elements meets them,
+  // nodes and elements of each region in input order.
+  imesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+  std::vector<int> region(imesh->num_elems(), -1);
+  std::vector<Piece> expected;
+  VMesh::Node::array_type nodes;
+  VMesh::Elem::array_type elems;
+  for (VMesh::Elem::index_type idx = 0; idx < imesh->num_elems(); ++idx)
+  {
+    if (region[idx] >= 0) continue;
+    std::vector<VMesh::index_type> stack(1, idx);
+    region[idx] = expected.size();
+    while (!stack.empty())
+    {
+      VMesh::Elem::index_type e = stack.back();
+      stack.pop_back();
+      imesh->get_nodes(nodes, e);
+      for (const auto& node : nodes)
+      {
+        imesh->get_elems(elems, node);
+        for (const auto& other : elems)
+          if (region[other] < 0) { region[other] = expected.size(); stack.push_back(other); }
+      }
+    }
+    expected.push_back(Piece());
+  }
+  std::vector<int> nodeRegion(imesh->num_nodes(), -1);
+  for (VMesh::Elem::index_type idx = 0; idx < imesh->num_elems(); ++idx)
+  {
+    expected[region[idx]].elems.push_back(idx);
+    imesh->get_nodes(nodes, idx);
+    for (const auto& node : nodes) nodeRegion[node] = region[idx];
+  }
+  for (VMesh::index_type idx = 0; idx < imesh->num_nodes(); ++idx)
+    expected[nodeRegion[idx]].nodes.push_back(idx);
+
+  SplitFieldByConnectedRegionAlgo algo;
+  auto result = algo.run(input);
+
+  ASSERT_EQ(37, expected.size());
+  ASSERT_EQ(expected.size(), result.size());
+  for (size_t j = 0; j < result.size(); ++j)
+  {
+    expectPiece(input, expected[j], result[j]);
+    std::vector<double> values;
+    result[j]->vfield()->get_values(values);
+    for (size_t q = 0; q < values.size(); ++q)
+      ASSERT_EQ(static_cast<double>(expected[j].nodes[q]), values[q]);
+  }
+}
+
+TEST(MeshComponentsTests, DomainsFollowLabelsAndFirstNodeUse)
+{
+  auto input = makeIslands(10, 2, CONSTANTDATA_E);
+  auto imesh = input->vmesh();
+
+  std::vector<int> labels;
+  input->vfield()->get_values(labels);
+  std::map<int, Piece> expected;
+  std::map<int, std::vector<bool>> used;
+  VMesh::Node::array_type nodes;
+  for (VMesh::Elem::index_type idx = 0; idx < imesh->num_elems(); ++idx)
+  {
+    auto& piece = expected[labels[idx]];
+    auto& seen = used[labels[idx]];
+    seen.resize(imesh->num_nodes(), false);
+    piece.elems.push_back(idx);
+    imesh->get_nodes(nodes, idx);
+    for (const auto& node : nodes)
+      if (!seen[node]) { seen[node] = true; piece.nodes.push_back(node); }
+  }
+
+  SplitFieldByDomainAlgo algo;
+  FieldList result;
+  ASSERT_TRUE(algo.runImpl(input, result));
+
+  ASSERT_EQ(4, expected.size());
+  ASSERT_EQ(expected.size(), result.size());
+  size_t j = 0;
+  for (const auto& domain : expected)
+  {
+    expectPiece(input, domain.second, result[j]);
+    std::vector<int> values;
+    result[j]->vfield()->get_values(values);
+    EXPECT_EQ(std::vector<int>(domain.second.elems.size(), domain.first), values);
+    ++j;
+  }
+}
+
+TEST(MeshComponentsTests, SplitManyIslands)
+{
+  // 23k tets, enough for several ranges per pass.
+  auto input = makeIslands(60, 4, CONSTANTDATA_E);
+
+  SplitFieldByConnectedRegionAlgo regions;
+  auto pieces = regions.run(input);
+  ASSERT_EQ(60, pieces.size());
+  for (const auto& piece : pieces)
+    EXPECT_EQ(384, piece->vmesh()->num_elems());
+
+  SplitFieldByDomainAlgo domains;
+  FieldList labelled;
+  ASSERT_TRUE(domains.runImpl(input, labelled));
+  ASSERT_EQ(4, labelled.size());
+  for (const auto& domain : labelled)
+    EXPECT_EQ(15 * 384, domain->vmesh()->num_elems());
+}
@@ -0,0 +1,302 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Algorithms/Legacy/Fields/SmoothMesh/FairMesh.h>
+#include <Core/Algorithms/Legacy/Fields/FieldData/SmoothVecFieldMedianAlgo.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+namespace
+{
+  /// Torus of n x 2n quads split into triangles, with a radial ripple so the
+  /// fairing has something to remove.
+  FieldHandle makeBumpyTorus(int n)
+  {
+    FieldInformation fi(TRISURFMESH_E, NODATA_E, DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    auto vmesh = field->vmesh();
+    const int m = 2 * n;
+    for (int j = 0; j < n; ++j)
+      for (int i = 0; i < m; ++i)
+      {
+        double u = 2 * M_PI * i / m, v = 2 * M_PI * j / n;
+        double r = 0.5 + 0.05 * std::sin(7.0 * i + 3.0 * j) * std::cos(5.0 * j);
+        vmesh->add_point(Point((2 + r * std::cos(v)) * std::cos(u), (2 + r * std::cos(v)) * std::sin(u), r * std::sin(v)));
+      }
+
+    auto node = [n, m](int i, int j) { return static_cast<VMesh::index_type>((j % n) * m + (i % m)); };
+    VMesh::Node::array_type nodes(3);
+    for (int j = 0; j < n; ++j)
+      for (int i = 0; i < m; ++i)
+      {
+        nodes[0] = node(i, j); nodes[1] = node(i + 1, j); nodes[2] = node(i + 1, j + 1);
+        vmesh->add_elem(nodes);
+        nodes[0] = node(i, j); nodes[1] = node(i + 1, j + 1); nodes[2] = node(i, j + 1);
+        vmesh->add_elem(nodes);
+      }
+    return field;
+  }
+
+  /// The serial fairing loops as they were before the operator was assembled once.
+  void referenceFairing(VMesh* mesh, bool desbrun, int iterations, double lambda, double mu)
+  {
+    const VMesh::size_type num_nodes = mesh->num_nodes();
+    mesh->synchronize(Mesh::NODE_NEIGHBORS_E | Mesh::EPSILON_E);
+    Point* point = mesh->get_points_pointer();
+    std::vector<Vector> disp(num_nodes);
+    std::vector<VMesh::Node::array_type> neighbors(num_nodes);
+    std::vector<std::vector<std::pair<VMesh::index_type, VMesh::index_type>>> pairs(num_nodes);
+    VMesh::Elem::array_type elems;
+    VMesh::Node::array_type nodes;
+    for (VMesh::Node::index_type idx = 0; idx < num_nodes; ++idx)
+    {
+      mesh->get_neighbors(neighbors[idx], idx);
+      mesh->get_elems(elems, idx);
+      for (const auto& e : elems)
+      {
+        mesh->get_nodes(nodes, e);
+        nodes.push_back(nodes[0]);
+        for (size_t k = 1; k < nodes.size(); ++k)
+          if (nodes[k - 1] != idx && nodes[k] != idx)
+            pairs[idx].push_back(std::make_pair(nodes[k - 1], nodes[k]));
+      }
+    }
+    const double epsilon = mesh->get_epsilon();
+
+    for (int it = 0; it < 2 * iterations; ++it)
+    {
+      for (VMesh::index_type idx = 0; idx < num_nodes; ++idx)
+      {
+        const Point p0 = point[idx];
+        Vector d(0, 0, 0);
+        if (!desbrun)
+        {
+          const double w = 1.0 / neighbors[idx].size();
+          for (const auto& nb : neighbors[idx])
+            d += w * (point[nb] - p0);
+          disp[idx] = d;
+          continue;
+        }
+        double totw = 0;
+        for (const auto& pr : pairs[idx])
+        {
+          const Point p1 = point[pr.first], p2 = point[pr.second];
+          Vector p12 = p1 - p2;
+          double e = Dot(p12, p12);
+          if (e <= 0) continue;
+          double dot = Dot(p1 - p0, p12) / e;
+          Point p3 = p1 - dot * p12;
+          double A = (p1 - p3).length(), B = (p0 - p3).length(), C = (p2 - p3).length();
+          if (B < 10 * epsilon) continue;
+          if (dot < 0.0) A = -A;
+          if (dot > 1.0) C = -C;
+          totw += (A + C) / B;
+          d += (A / B) * (p2 - p0) + (C / B) * (p1 - p0);
+        }
+        if (totw != 0.0) disp[idx] = d * (1.0 / totw);
+      }
+      for (VMesh::index_type idx = 0; idx < num_nodes; ++idx)
+        point[idx] = point[idx] + ((it % 2 == 0) ? lambda : mu) * disp[idx];
+    }
+  }
+
+  /// Largest distance of a node from the average of its edge neighbors.
+  double roughness(VMesh* mesh)
+  {
+    mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+    VMesh::Node::array_type neighbors;
+    Point p, q;
+    double worst = 0;
+    for (VMesh::Node::index_type idx = 0; idx < mesh->num_nodes(); ++idx)
+    {
+      mesh->get_neighbors(neighbors, idx);
+      mesh->get_center(p, idx);
+      Vector avg(0, 0, 0);
+      for (const auto& nb : neighbors)
+      {
+        mesh->get_center(q, nb);
+        avg += Vector(q) / neighbors.size();
+      }
+      worst = std::max(worst, (Vector(p) - avg).length());
+    }
+    return worst;
+  }
+
+  double maxNodeDistance(VMesh* a, VMesh* b)
+  {
+    Point p, q;
+    double worst = 0;
+    for (VMesh::Node::index_type idx = 0; idx < a->num_nodes(); ++idx)
+    {
+      a->get_center(p, idx);
+      b->get_center(q, idx);
+      worst = std::max(worst, (p - q).length());
+    }
+    return worst;
+  }
+
+  void expectFairingMatchesReference(const std::string& method, int n = 24)
+  {
+    auto input = makeBumpyTorus(n);
+    FairMeshAlgo algo;
+    algo.setOption(Parameters::FairMeshMethod, method);
+    algo.set(Parameters::NumIterations, 10);
+    FieldHandle output;
+    ASSERT_TRUE(algo.runImpl(input, output));
+
+    FieldHandle expected(input->deep_clone());
+    const double lambda = 0.6307;
+    referenceFairing(expected->vmesh(), method == "desbrun", 10, lambda, 1.0 / (0.1 - 1.0 / lambda));
+
+    EXPECT_LT(maxNodeDistance(output->vmesh(), expected->vmesh()), 1e-10);
+    EXPECT_LT(roughness(output->vmesh()), 0.5 * roughness(input->vmesh()));
+  }
+}
+
+TEST(MeshSmootherTests, FastFairingMatchesNeighborLoop)
+{
+  expectFairingMatchesReference("fast");
+}
+
+TEST(MeshSmootherTests, DesbrunFairingMatchesNeighborLoop)
+{
+  expectFairingMatchesReference("desbrun");
+}
+
+TEST(MeshSmootherTests, ImplicitFairingIsStableForLargeSteps)
+{
+  auto input = makeBumpyTorus(24);
+  FairMeshAlgo algo;
+  algo.set(Parameters::ImplicitFairing, true);
+  algo.set(Parameters::NumIterations, 3);
+  algo.set(Parameters::Lambda, 20.0);
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(input, output));
+
+  // Explicit steps this large blow up; backward Euler only flattens the ripple.
+  BBox ibox = input->vmesh()->get_bounding_box();
+  BBox obox = output->vmesh()->get_bounding_box();
+  EXPECT_TRUE(ibox.inside(obox.get_min()));
+  EXPECT_TRUE(ibox.inside(obox.get_max()));
+  EXPECT_LT(roughness(output->vmesh()), 0.25 * roughness(input->vmesh()));
+}
+
+TEST(MeshSmootherTests, VectorMedianMatchesNeighborLoop)
+{
+  // Tets of a 4^3 lattice with vectors that repeat, so equal angles occur.
+  FieldInformation fi(TETVOLMESH_E, CONSTANTDATA_E, VECTOR_E);
+  FieldHandle input = CreateField(fi);
+  auto vmesh = input->vmesh();
+  const int n = 4, nn = n + 1;
+  for (int k = 0; k < nn; ++k)
+    for (int j = 0; j < nn; ++j)
+      for (int i = 0; i < nn; ++i)
+        vmesh->add_point(Point(i, j, k));
+  auto node = [nn](int i, int j, int k) { return static_cast<VMesh::index_type>((k * nn + j) * nn + i); };
+  const int axes[6][3] = { {0,1,2}, {0,2,1}, {1,0,2}, {1,2,0}, {2,0,1}, {2,1,0} };
+  VMesh::Node::array_type nodes(4);
+  for (int k = 0; k < n; ++k)
+    for (int j = 0; j < n; ++j)
+      for (int i = 0; i < n; ++i)
+        for (const auto& a : axes)
+        {
+          int c[3] = { i, j, k };
+          for (int v = 0; v < 4; ++v)
+          {
+            nodes[v] = node(c[0], c[1], c[2]);
+            if (v < 3) c[a[v]]++;
+          }
+          vmesh->add_elem(nodes);
+        }
+  auto vfield = input->vfield();
+  vfield->resize_values();
+  for (VMesh::Elem::index_type idx = 0; idx < vmesh->num_elems(); ++idx)
+    vfield->set_value(Vector(idx % 3, (idx / 3) % 2, 1.0 + idx % 4), idx);
+
+  SmoothVecFieldMedianAlgo algo;
+  FieldHandle output;
+  ASSERT_TRUE(algo.runImpl(input, output));
+
+  // Median of the angles to every element up to three face neighbors away.
+  vmesh->synchronize(Mesh::ELEM_NEIGHBORS_E);
+  for (VMesh::Elem::index_type idx = 0; idx < vmesh->num_elems(); ++idx)
+  {
+    VMesh::Elem::array_type ring1, ring2, ring3, all, unique;
+    all.push_back(idx);
+    vmesh->get_neighbors(ring1, idx);
+    for (const auto& e1 : ring1)
+    {
+      all.push_back(e1);
+      vmesh->get_neighbors(ring2, e1);
+      all.insert(all.end(), ring2.begin(), ring2.end());
+      for (const auto& e2 : ring2)
+      {
+        vmesh->get_neighbors(ring3, e2);
+        all.insert(all.end(), ring3.begin(), ring3.end());
+      }
+    }
+    for (const auto& e : all)
+      if (std::find(unique.begin(), unique.end(), e) == unique.end()) unique.push_back(e);
+
+    Vector v0, v1;
+    vfield->get_value(v0, idx);
+    std::vector<double> angles;
+    for (const auto& e : unique)
+    {
+      vfield->get_value(v1, e);
+      angles.push_back(Dot(v0, v1) / (v0.length() * v1.length()));
+    }
+    std::vector<double> sorted(angles);
+    std::sort(sorted.begin(), sorted.end());
+    auto pick = std::find(angles.begin(), angles.end(), sorted[(sorted.size() + 1) / 2]) - angles.begin();
+
+    Vector expected, result;
+    vfield->get_value(expected, unique[pick]);
+    output->vfield()->get_value(result, idx);
+    ASSERT_EQ(expected, result);
+  }
+}
+
+TEST(MeshSmootherTests, FairingMatchesNeighborLoopAcrossTasks)
+{
+  // 64 x 128 nodes, enough for several ranges per pass.
+  expectFairingMatchesReference("fast", 64);
+  expectFairingMatchesReference("desbrun", 64);
+}
@@ -0,0 +1,156 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Algorithms/Legacy/Fields/Mapping/RadialBasisInterpolation.h>
+#include <cmath>
+#include <random>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+namespace
+{
+  MeshHandle randomPoints(int count, unsigned seed)
+  {
+    FieldInformation fi("PointCloudMesh", 0, "double");
+    MeshHandle mesh = CreateMesh(fi);
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (int i = 0; i < count; ++i)
+      mesh->vmesh()->add_point(Point(unit(random), unit(random), unit(random)));
+    return mesh;
+  }
+
+  double smooth(const Point& p)
+  {
+    return std::sin(2.0 * p.x()) + p.y() * p.z() + 0.5 * p.z();
+  }
+
+  std::vector<double> sample(VMesh* mesh)
+  {
+    std::vector<double> values(mesh->num_nodes());
+    Point p;
+    for (VMesh::Node::index_type i = 0; i < mesh->num_nodes(); ++i)
+    {
+      mesh->get_point(p, i);
+      values[i] = smooth(p);
+    }
+    return values;
+  }
+
+  double rmsError(VMesh* mesh, const std::vector<double>& result)
+  {
+    double sum = 0;
+    Point p;
+    for (VMesh::Node::index_type i = 0; i < mesh->num_nodes(); ++i)
+    {
+      mesh->get_point(p, i);
+      sum += (result[i] - smooth(p)) * (result[i] - smooth(p));
+    }
+    return std::sqrt(sum / mesh->num_nodes());
+  }
+}
+
+TEST(RadialBasisInterpolationTests, PartitionOfUnityMatchesDenseAccuracy)
+{
+  auto sources = randomPoints(300, 3);
+  auto targets = randomPoints(1000, 4);
+  auto values = sample(sources->vmesh());
+  const double maxDistance = std::numeric_limits<double>::max();
+
+  std::vector<double> dense, patches;
+  RadialBasisInterpolation::thinPlateSpline(sources->vmesh(), values, targets->vmesh(), maxDistance, 0.0, dense);
+  ASSERT_TRUE(RadialBasisInterpolation::partitionOfUnity(sources->vmesh(), values, targets->vmesh(), maxDistance, 0.0, patches));
+
+  const double denseError = rmsError(targets->vmesh(), dense);
+  const double patchError = rmsError(targets->vmesh(), patches);
+  EXPECT_LT(patchError, 2 * denseError);
+
+  std::vector<double> atSources;
+  ASSERT_TRUE(RadialBasisInterpolation::partitionOfUnity(sources->vmesh(), values, sources->vmesh(), maxDistance, 0.0, atSources));
+  for (size_t i = 0; i < values.size(); ++i)
+    EXPECT_NEAR(values[i], atSources[i], 1e-6);
+}
+
+TEST(RadialBasisInterpolationTests, PlanarSourcesReproduceLinearData)
+{
+  FieldInformation fi("PointCloudMesh", 0, "double");
+  MeshHandle sources = CreateMesh(fi);
+  std::vector<double> values;
+  for (int j = 0; j < 20; ++j)
+    for (int i = 0; i < 20; ++i)
+    {
+      sources->vmesh()->add_point(Point(i / 19.0, j / 19.0, 0.0));
+      values.push_back(1.0 + 2.0 * i / 19.0 - 3.0 * j / 19.0);
+    }
+  MeshHandle targets = CreateMesh(fi);
+  targets->vmesh()->add_point(Point(0.31, 0.77, 0.0));
+  targets->vmesh()->add_point(Point(0.5, 0.5, 0.0));
+
+  std::vector<double> result;
+  ASSERT_TRUE(RadialBasisInterpolation::partitionOfUnity(sources->vmesh(), values, targets->vmesh(),
+    std::numeric_limits<double>::max(), 0.0, result));
+  EXPECT_NEAR(1.0 + 2.0 * 0.31 - 3.0 * 0.77, result[0], 1e-8);
+  EXPECT_NEAR(0.5, result[1], 1e-8);
+}
+
+TEST(RadialBasisInterpolationTests, TargetsBeyondMaxDistanceGetOutsideValue)
+{
+  auto sources = randomPoints(100, 5);
+  auto values = sample(sources->vmesh());
+  FieldInformation fi("PointCloudMesh", 0, "double");
+  MeshHandle targets = CreateMesh(fi);
+  targets->vmesh()->add_point(Point(0.5, 0.5, 0.5));
+  targets->vmesh()->add_point(Point(10, 10, 10));
+
+  std::vector<double> result;
+  ASSERT_TRUE(RadialBasisInterpolation::partitionOfUnity(sources->vmesh(), values, targets->vmesh(), 1.0, -7.0, result));
+  EXPECT_NEAR(smooth(Point(0.5, 0.5, 0.5)), result[0], 0.05);
+  EXPECT_EQ(-7.0, result[1]);
+}
+
+TEST(RadialBasisInterpolationTests, PartitionOfUnityHandlesManyPatches)
+{
+  // Enough sources and targets for several patches and several ranges per pass.
+  auto sources = randomPoints(5000, 6);
+  auto targets = randomPoints(10000, 7);
+  auto values = sample(sources->vmesh());
+
+  std::vector<double> result;
+  ASSERT_TRUE(RadialBasisInterpolation::partitionOfUnity(sources->vmesh(), values, targets->vmesh(),
+    std::numeric_limits<double>::max(), 0.0, result));
+  EXPECT_LT(rmsError(targets->vmesh(), result), 0.01);
+}
@@ -0,0 +1,266 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Legacy/FiniteElements/LeadField/BuildLeadField.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/Thread/Parallel.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::FiniteElements;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  // Unit cube split into n^3 cells of six tetrahedra sharing the main diagonal.
+  FieldHandle tetGrid(int n)
+  {
+    FieldInformation fi("TetVolMesh", 1, "double");
+    auto field = CreateField(fi);
+    auto vmesh = field->vmesh();
+    const double h = 1.0 / n;
+    auto node = [n](int i, int j, int k) { return static_cast<index_type>((k * (n + 1) + j) * (n + 1) + i); };
+    for (int k = 0; k <= n; ++k)
+      for (int j = 0; j <= n; ++j)
+        for (int i = 0; i <= n; ++i)
+          vmesh->add_point(Point(i * h, j * h, k * h));
+
+    const int cellTets[6][4] = { {5,6,0,4}, {0,7,2,3}, {2,6,0,1}, {0,6,5,1}, {0,6,2,7}, {6,7,0,4} };
+    VMesh::Node::array_type vdata(4);
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+          const index_type corners[8] = { node(i,j,k), node(i+1,j,k), node(i+1,j+1,k), node(i,j+1,k),
+            node(i,j,k+1), node(i+1,j,k+1), node(i+1,j+1,k+1), node(i,j+1,k+1) };
+          for (const auto& tet : cellTets)
+          {
+            for (int c = 0; c < 4; ++c)
+              vdata[c] = corners[tet[c]];
+            vmesh->add_elem(vdata);
+          }
+        }
+    return field;
+  }
+
+  // Linear element stiffness matrix with unit conductivity.
+  SparseRowMatrixHandle stiffnessMatrix(FieldHandle field)
+  {
+    auto vmesh = field->vmesh();
+    std::vector<SparseRowMatrix::Triplet> entries;
+    VMesh::Node::array_type nodes;
+    for (VMesh::Elem::index_type e = 0; e < vmesh->num_elems(); ++e)
+    {
+      vmesh->get_nodes(nodes, e);
+      Point p[4];
+      for (int c = 0; c < 4; ++c)
+        vmesh->get_center(p[c], nodes[c]);
+      Eigen::Matrix3d edges;
+      for (int c = 0; c < 3; ++c)
+        edges.row(c) << p[c+1].x() - p[0].x(), p[c+1].y() - p[0].y(), p[c+1].z() - p[0].z();
+      const double volume = std::fabs(edges.determinant()) / 6;
+      Eigen::Matrix<double, 4, 3> grads;
+      grads.bottomRows<3>() = edges.inverse().transpose();
+      grads.row(0) = -grads.bottomRows<3>().colwise().sum();
+      for (int a = 0; a < 4; ++a)
+        for (int b = 0; b < 4; ++b)
+          entries.emplace_back(nodes[a], nodes[b], volume * grads.row(a).dot(grads.row(b)));
+    }
+    auto K = boost::make_shared<SparseRowMatrix>(vmesh->num_nodes(), vmesh->num_nodes());
+    K->setFromTriplets(entries.begin(), entries.end());
+    return K;
+  }
+
+  FieldHandle dipolePositions(int count)
+  {
+    FieldInformation fi("PointCloudMesh", 0, "double");
+    auto field = CreateField(fi);
+    for (int k = 0; k < count; ++k)
+    {
+      const double t = (k + 0.5) / count;
+      field->vmesh()->add_point(Point(0.2 + 0.6 * t, 0.3 + 0.4 * t * t, 0.7 - 0.5 * t));
+    }
+    return field;
+  }
+
+  DenseMatrixHandle electrodeNodes(int count, index_type numNodes)
+  {
+    auto electrodes = boost::make_shared<DenseMatrix>(count, 1);
+    for (int e = 0; e < count; ++e)
+      (*electrodes)(e, 0) = static_cast<double>((e * 7919 + 3) % numNodes);
+    return electrodes;
+  }
+
+  // Potentials at the electrodes from one grounded solve per dipole.
+  Eigen::MatrixXd directLeadField(const SparseRowMatrix& K, const SparseRowMatrix& B, const DenseMatrix& electrodes, index_type reference)
+  {
+    Eigen::MatrixXd grounded(K);
+    grounded.row(reference).setZero();
+    grounded.col(reference).setZero();
+    grounded(reference, reference) = 1;
+    Eigen::MatrixXd rhs(B);
+    rhs.row(reference).setZero();
+    Eigen::MatrixXd potentials = grounded.ldlt().solve(rhs);
+    Eigen::MatrixXd lead(electrodes.rows(), B.cols());
+    for (int e = 0; e < electrodes.rows(); ++e)
+      lead.row(e) = potentials.row(static_cast<index_type>(electrodes(e, 0)));
+    return lead;
+  }
+
+  double relativeError(const Eigen::MatrixXd& actual, const Eigen::MatrixXd& expected)
+  {
+    return (actual - expected).norm() / expected.norm();
+  }
+}
+
+TEST(BuildLeadFieldAlgoTests, DipoleSourcesReproduceGradientOfLinearPotential)
+{
+  auto mesh = tetGrid(3);
+  auto sources = dipolePositions(7);
+  BuildLeadFieldAlgo algo;
+  auto B = algo.dipoleSources(mesh, sources);
+  ASSERT_EQ(mesh->vmesh()->num_nodes(), B->nrows());
+  ASSERT_EQ(21, B->ncols());
+
+  // For u = a . x the dipole along axis d sees sum_i grad(phi_i)_d u_i = a_d.
+  const double a[3] = { 0.3, -1.2, 2.5 };
+  Eigen::VectorXd u(B->nrows());
+  for (index_type i = 0; i < B->nrows(); ++i)
+  {
+    Point p;
+    mesh->vmesh()->get_center(p, VMesh::Node::index_type(i));
+    u[i] = a[0] * p.x() + a[1] * p.y() + a[2] * p.z();
+  }
+  Eigen::VectorXd response = B->transpose() * u;
+  for (index_type col = 0; col < B->ncols(); ++col)
+    EXPECT_NEAR(a[col % 3], response[col], 1e-10);
+}
+
+TEST(BuildLeadFieldAlgoTests, ReciprocityMatchesPerDipoleSolves)
+{
+  auto mesh = tetGrid(4);
+  auto K = stiffnessMatrix(mesh);
+  auto sources = dipolePositions(5);
+  auto electrodes = electrodeNodes(40, K->nrows());
+  BuildLeadFieldAlgo algo;
+  algo.set(Parameters::ReferenceNode, 3);
+
+  auto lead = algo.run(K, mesh, electrodes, sources);
+  ASSERT_EQ(40, lead->nrows());
+  ASSERT_EQ(15, lead->ncols());
+
+  auto expected = directLeadField(*K, *algo.dipoleSources(mesh, sources), *electrodes, 3);
+  EXPECT_LT(relativeError(*lead, expected), 1e-10);
+
+  // A second run with the same stiffness matrix reuses the factorization.
+  auto again = algo.run(K, mesh, electrodes, sources);
+  EXPECT_EQ(0, (*again - *lead).norm());
+}
+
+TEST(BuildLeadFieldAlgoTests, ConjugateGradientMatchesDirectSolver)
+{
+  auto mesh = tetGrid(4);
+  auto K = stiffnessMatrix(mesh);
+  auto sources = dipolePositions(4);
+  auto electrodes = electrodeNodes(20, K->nrows());
+  BuildLeadFieldAlgo algo;
+  auto direct = algo.run(K, mesh, electrodes, sources);
+
+  algo.setOption(Variables::Method, "cg");
+  algo.set(Variables::TargetError, 1e-12);
+  auto iterative = algo.run(K, mesh, electrodes, sources);
+  EXPECT_LT(relativeError(*iterative, *direct), 1e-9);
+}
+
+TEST(BuildLeadFieldAlgoTests, AverageReferenceGivesZeroMeanColumns)
+{
+  auto mesh = tetGrid(3);
+  auto K = stiffnessMatrix(mesh);
+  auto sources = dipolePositions(3);
+  auto electrodes = electrodeNodes(12, K->nrows());
+  BuildLeadFieldAlgo algo;
+  auto referenced = algo.run(K, mesh, electrodes, sources);
+
+  algo.set(Parameters::AverageReference, true);
+  auto averaged = algo.run(K, mesh, electrodes, sources);
+  EXPECT_LT(averaged->colwise().sum().norm(), 1e-12 * referenced->norm());
+
+  Eigen::MatrixXd expected = referenced->rowwise() - referenced->colwise().mean();
+  EXPECT_LT(relativeError(*averaged, expected), 1e-12);
+}
+
+TEST(BuildLeadFieldAlgoTests, ThrowsForInvalidInputs)
+{
+  auto mesh = tetGrid(2);
+  auto K = stiffnessMatrix(mesh);
+  auto sources = dipolePositions(2);
+  BuildLeadFieldAlgo algo;
+
+  EXPECT_THROW(algo.run(nullptr, mesh, electrodeNodes(2, K->nrows()), sources), AlgorithmInputException);
+  EXPECT_THROW(algo.run(K, mesh, nullptr, sources), AlgorithmInputException);
+
+  auto outside = boost::make_shared<DenseMatrix>(1, 1);
+  (*outside)(0, 0) = static_cast<double>(K->nrows());
+  EXPECT_THROW(algo.run(K, mesh, outside, sources), AlgorithmInputException);
+
+  algo.set(Parameters::ReferenceNode, -1);
+  EXPECT_THROW(algo.run(K, mesh, electrodeNodes(2, K->nrows()), sources), AlgorithmInputException);
+}
+
+TEST(BuildLeadFieldAlgoTests, ElectrodeBlocksDoNotDependOnTaskCount)
+{
+  // 40 electrodes make three blocks, which go to different tasks when there are cores for them.
+  auto mesh = tetGrid(4);
+  auto K = stiffnessMatrix(mesh);
+  auto sources = dipolePositions(5);
+  auto electrodes = electrodeNodes(40, K->nrows());
+
+  for (const std::string method : { "ldlt", "cg" })
+  {
+    BuildLeadFieldAlgo serialAlgo, parallelAlgo;
+    serialAlgo.setOption(Variables::Method, method);
+    parallelAlgo.setOption(Variables::Method, method);
+    Parallel::SetMaximumCores(1);
+    auto serial = serialAlgo.run(K, mesh, electrodes, sources);
+    Parallel::SetMaximumCores(0);
+    auto parallel = parallelAlgo.run(K, mesh, electrodes, sources);
+    EXPECT_EQ(0, (*parallel - *serial).norm()) << method;
+  }
+}
@@ -32,18 +32,18 @@
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
-#include <Core/Datatypes/Matrix.h>
-#include <Core/Datatypes/SparseRowMatrixFromMap.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
-#include <unordered_map>
+#include <Core/Algorithms/Legacy/Fields/MeshData/FlaggedNodes.h>
+#include <Core/Thread/Parallel.h>
 
 #include <algorithm>
-#include <set>
 
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
 
@@ -78,877 +78,555 @@ int tri_permute_table[7][3] = {
 
 namespace detail
 {
-  struct edgepair_t
-  {
-    VField::index_type first;
-    VField::index_type second;
-    double dfirst;
-  };
+  typedef FlaggedNodes::Flags node_flags_type;
 
-  struct edgepairhash
+  /// A corner of a clipped element: either a node of the input mesh or a new
+  /// node on one of its edges or faces. The spanning input nodes are kept in
+  /// ascending order, so elements sharing an edge or face produce equal keys.
+  struct ClipNode
   {
-    size_t operator()(const edgepair_t &a) const
-    {
-      std::hash<size_t> h;
-      return h(a.first ^ a.second);
-    }
+    int size;
+    VMesh::index_type nodes[3];
+    double weights[3];
+    Point point;
   };
 
-  typedef std::unordered_map<VField::index_type, VMesh::Node::index_type> node_hash_type;
-  typedef std::unordered_map<edgepair_t, VMesh::Node::index_type, edgepairhash> edge_hash_type;
-
-  bool operator==(const edgepair_t &a, const edgepair_t &b)
+  bool operator<(const ClipNode& a, const ClipNode& b)
   {
-    return a.first == b.first && a.second == b.second;
+    if (a.size != b.size) return a.size < b.size;
+    for (int k = 0; k < a.size; k++)
+      if (a.nodes[k] != b.nodes[k]) return a.nodes[k] < b.nodes[k];
+    return false;
   }
 
-  bool operator!=(const edgepair_t &a, const edgepair_t &b)
+  bool sameKey(const ClipNode& a, const ClipNode& b)
   {
-    return !(a == b);
+    return !(a < b) && !(b < a);
   }
 
-  struct facetriple_t
-  {
-    VField::index_type first, second, third;
-    double dsecond, dthird;
-  };
-
-  bool operator==(const facetriple_t &a, const facetriple_t &b)
+  /// The pieces one input element is cut into. Cells refer to the corners by
+  /// their position in nodes.
+  struct ClippedElement
   {
-    return a.first == b.first && a.second == b.second && a.third == b.third;
-  }
+    int numNodes;
+    ClipNode nodes[9];
+    int numCells;
+    int cells[7][4];
 
-  bool operator!=(const facetriple_t &a, const facetriple_t &b)
-  {
-    return !(a == b);
-  }
+    void clear() { numNodes = 0; numCells = 0; }
 
-  struct facetriplehash
-  {
-    size_t operator()(const facetriple_t &a) const
+    int addNode(VMesh::index_type u0, const Point& p)
     {
-      std::hash<size_t> h;
-      return h(a.first ^ a.second ^ a.third);
+      ClipNode& n = nodes[numNodes];
+      n.size = 1;
+      n.nodes[0] = u0;
+      n.weights[0] = 1.0;
+      n.point = p;
+      return numNodes++;
     }
-  };
-
-  typedef std::unordered_map<facetriple_t, VMesh::Node::index_type, facetriplehash> face_hash_type;
-
-}
-
-ClipMeshByIsovalueAlgo::ClipMeshByIsovalueAlgo()
-{
- addParameter(LessThanIsoValue, 1);
- addParameter(ScalarIsoValue, 0.0);
-}
-
-class ClipMeshByIsovalueAlgoTet {
 
-  public:
-    bool run(const AlgorithmBase* algo,FieldHandle input, FieldHandle& output, MatrixHandle& mapping) const;
-
-  private:
-    VMesh::Node::index_type
-    edge_lookup(VField::index_type u0, VField::index_type u1, double d0,
-          const Point &p, detail::edge_hash_type &edgemap,
-          VMesh *clipped) const;
-
-    VMesh::Node::index_type
-    face_lookup(VField::index_type u0, VField::index_type u1, VField::index_type u2,
-          double d1, double d2,
-          const Point &p, detail::face_hash_type &facemap,
-          VMesh *clipped) const;
-
- };
-
-VMesh::Node::index_type ClipMeshByIsovalueAlgoTet::edge_lookup(VField::index_type u0, VField::index_type u1, double d0, const Point &p, detail::edge_hash_type &edgemap, VMesh *clipped) const
-{
-  using namespace detail;
-  edgepair_t np;
-  if (u0 < u1)  { np.first = u0; np.second = u1; np.dfirst = d0; }
-  else { np.first = u1; np.second = u0; np.dfirst = 1.0 - d0; }
-
-  auto loc = edgemap.find(np);
-
-  if (loc == edgemap.end())
-  {
-    const VMesh::Node::index_type nodeindex = clipped->add_point(p);
-    edgemap[np] = nodeindex;
-    return nodeindex;
-  }
-  else
-  {
-   return loc->second;
-  }
-}
-
-VMesh::Node::index_type ClipMeshByIsovalueAlgoTet::face_lookup(VField::index_type u0, VField::index_type u1, VField::index_type u2, double d1, double d2, const Point &p, detail::face_hash_type &facemap, VMesh *clipped) const
-{
-  using namespace detail;
-  facetriple_t nt;
-  if (u0 < u1)
-  {
-    if (u2 < u0)
-    {
-      nt.first = u2; nt.second = u0; nt.third = u1;
-      nt.dsecond = 1.0 - d1 - d2; nt.dthird = d1;
-    }
-    else if (u2 < u1)
+    int addEdgeNode(VMesh::index_type u0, VMesh::index_type u1, double d0, const Point& p)
     {
-      nt.first = u0; nt.second = u2; nt.third = u1;
-      nt.dsecond = d2; nt.dthird = d1;
+      ClipNode& n = nodes[numNodes];
+      n.size = 2;
+      if (u0 < u1)  { n.nodes[0] = u0; n.nodes[1] = u1; n.weights[0] = 1.0 - d0; n.weights[1] = d0; }
+      else { n.nodes[0] = u1; n.nodes[1] = u0; n.weights[0] = d0; n.weights[1] = 1.0 - d0; }
+      n.point = p;
+      return numNodes++;
     }
-    else
-    {
-      nt.first = u0; nt.second = u1; nt.third = u2;
-      nt.dsecond = d1; nt.dthird = d2;
-    }
-  }
-  else
-  {
-    if (u2 > u0)
-    {
-      nt.first = u1; nt.second = u0; nt.third = u2;
-      nt.dsecond = 1.0 - d1 - d2; nt.dthird = d2;
-    }
-    else if (u2 > u1)
+
+    int addFaceNode(VMesh::index_type u0, VMesh::index_type u1, VMesh::index_type u2,
+      double d1, double d2, const Point& p)
     {
-      nt.first = u1; nt.second = u2; nt.third = u0;
-      nt.dsecond = d2; nt.dthird = 1.0 - d1 - d2;
+      ClipNode& n = nodes[numNodes];
+      n.size = 3;
+      n.nodes[0] = u0; n.nodes[1] = u1; n.nodes[2] = u2;
+      n.weights[0] = 1.0 - d1 - d2; n.weights[1] = d1; n.weights[2] = d2;
+      for (int i = 1; i < 3; i++)
+      {
+        for (int j = i; j > 0 && n.nodes[j] < n.nodes[j-1]; j--)
+        {
+          std::swap(n.nodes[j], n.nodes[j-1]);
+          std::swap(n.weights[j], n.weights[j-1]);
+        }
+      }
+      n.point = p;
+      return numNodes++;
     }
-    else
+
+    void addCell(int a, int b, int c, int d = -1)
     {
-      nt.first = u2; nt.second = u1; nt.third = u0;
-      nt.dsecond = d1; nt.dthird = 1.0 - d1 - d2;
+      int* cell = cells[numCells++];
+      cell[0] = a; cell[1] = b; cell[2] = c; cell[3] = d;
     }
-  }
-  const face_hash_type::iterator loc = facemap.find(nt);
-  if (loc == facemap.end())
-  {
-    const VMesh::Node::index_type nodeindex = clipped->add_point(p);
-    facemap[nt] = nodeindex;
-    return nodeindex;
-  }
-  else
-  {
-    return (*loc).second;
-  }
-}
-
-bool ClipMeshByIsovalueAlgoTet::run(const AlgorithmBase* algo, FieldHandle input, FieldHandle& output, MatrixHandle &mapping) const
-{
-  VField* field = input->vfield();
-  VMesh*  mesh  = input->vmesh();
-  VMesh*  clipped = output->vmesh();
+  };
 
-  using namespace detail;
-  node_hash_type nodemap;
-  edge_hash_type edgemap;
-  face_hash_type facemap;
+  /// Clips elements in three passes over the same element ranges:
+  /// 1. clip every element, flag the input nodes that are kept and collect the
+  ///    new edge and face nodes of each range;
+  /// 2. merge the new nodes by sorting on their spanning input nodes, keeping
+  ///    the one from the first element that produced it;
+  /// 3. clip again and write the cells straight into their slots in the output.
+  /// Kept input nodes are numbered in input order, followed by the new nodes in
+  /// key order, so the result is the same for any number of tasks.
+  template <class CLIPPER>
+  class ParallelClip
+  {
+  public:
+    ParallelClip(const AlgorithmBase* algo, const CLIPPER& clipper) :
+      algo_(algo), clipper_(clipper) {}
 
-  VMesh::Node::array_type onodes(4);
-  std::vector<double> v(4);
-  std::vector<Point> p(4);
+    bool run(FieldHandle input, FieldHandle& output, MatrixHandle* mapping, double isoval) const;
 
-  double isoval = algo->get(ClipMeshByIsovalueAlgo::ScalarIsoValue).toDouble();
+  private:
+    const AlgorithmBase* algo_;
+    CLIPPER clipper_;
+  };
 
-  bool lte = !algo->get(ClipMeshByIsovalueAlgo::LessThanIsoValue).toBool();
+  template <class CLIPPER>
+  bool ParallelClip<CLIPPER>::run(FieldHandle input, FieldHandle& output, MatrixHandle* mapping, double isoval) const
+  {
+    VField* field = input->vfield();
+    VMesh*  mesh  = input->vmesh();
+    VMesh*  clipped = output->vmesh();
+    VField* ofield = output->vfield();
 
-  VMesh::size_type num_elems = mesh->num_elems();
+    const VMesh::size_type num_elems = mesh->num_elems();
+    const VMesh::size_type num_nodes = mesh->num_nodes();
+    const int numTasks = Parallel::NumTasks(num_elems);
 
-  for (VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
-  {
-    mesh->get_nodes(onodes, idx);
+    node_flags_type kept(num_nodes);
+    std::vector<std::vector<ClipNode> > taskNodes(numTasks);
+    std::vector<VMesh::size_type> cellOffsets(numTasks + 1, 0);
 
-      // Get the values and compute an inside/outside mask.
-    VField::index_type inside = 0;
-    mesh->get_centers(p, onodes);
-    field->get_values(v,onodes);
-    for (size_t i = 0; i < onodes.size(); i++)
+    Parallel::RunRange(num_elems, numTasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
     {
-      inside = inside << 1;
-      if (v[i] > isoval)
+      CLIPPER clipper(clipper_);
+      ClippedElement piece;
+      std::vector<ClipNode>& newNodes = taskNodes[task];
+      VMesh::size_type numCells = 0;
+      int cnt = 0;
+      for (VMesh::Elem::index_type idx = begin; idx < end; idx++)
       {
-        inside |= 1;
+        clipper.clip(idx, piece);
+        numCells += piece.numCells;
+        for (int i = 0; i < piece.numNodes; i++)
+        {
+          if (piece.nodes[i].size == 1)
+            kept[piece.nodes[i].nodes[0]].store(1, std::memory_order_relaxed);
+          else
+            newNodes.push_back(piece.nodes[i]);
+        }
+        if (task == 0) { cnt++; if (cnt == 100) { cnt = 0; algo_->update_progress_max(idx, 2*end); } }
       }
-
+      // Equal keys stay in element order, so the first occurrence survives.
+      std::stable_sort(newNodes.begin(), newNodes.end());
+      newNodes.erase(std::unique(newNodes.begin(), newNodes.end(), sameKey), newNodes.end());
+      cellOffsets[task + 1] = numCells;
+    });
+
+    std::vector<ClipNode> newNodes;
+    for (int task = 0; task < numTasks; task++)
+    {
+      newNodes.insert(newNodes.end(), taskNodes[task].begin(), taskNodes[task].end());
+      std::vector<ClipNode>().swap(taskNodes[task]);
+      cellOffsets[task + 1] += cellOffsets[task];
     }
+    std::stable_sort(newNodes.begin(), newNodes.end());
+    newNodes.erase(std::unique(newNodes.begin(), newNodes.end(), sameKey), newNodes.end());
 
-      // Invert the mask if we are doing less than.
-    if (lte) { inside = ~inside & 0xf; }
+    std::vector<VMesh::index_type> nodemap, nodemap2;
+    const VMesh::size_type num_kept = FlaggedNodes::number(kept, nodemap, nodemap2);
+    const VMesh::size_type num_new = newNodes.size();
 
-    if (inside == 0)
-    {
-        // Discard outside elements.
-    }
-    else if (inside == 0xf)
+    clipped->resize_nodes(num_kept + num_new);
+    clipped->resize_elems(cellOffsets[numTasks]);
+    ofield->resize_values();
+    CopyProperties(*input, *output);
+
+    Parallel::RunRange(num_elems, numTasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
     {
-        // Add this element to the new mesh.
-      VMesh::Node::array_type nnodes(onodes.size());
-      for (size_t i = 0; i<onodes.size(); i++)
+      CLIPPER clipper(clipper_);
+      ClippedElement piece;
+      VMesh::Node::array_type nnodes(CLIPPER::CellSize);
+      VMesh::index_type corners[9];
+      VMesh::index_type cell = cellOffsets[task];
+      int cnt = 0;
+      for (VMesh::Elem::index_type idx = begin; idx < end; idx++)
       {
-        if (nodemap.find((VField::index_type)onodes[i]) == nodemap.end())
+        clipper.clip(idx, piece);
+        if (piece.numCells == 0) continue;
+        for (int i = 0; i < piece.numNodes; i++)
         {
-          const VMesh::Node::index_type nodeindex = clipped->add_point(p[i]);
-          nodemap[(VField::index_type)onodes[i]] = nodeindex;
-          nnodes[i] = nodeindex;
+          const ClipNode& n = piece.nodes[i];
+          if (n.size == 1)
+            corners[i] = nodemap[n.nodes[0]];
+          else
+            corners[i] = num_kept + (std::lower_bound(newNodes.begin(), newNodes.end(), n) - newNodes.begin());
         }
-        else
+        for (int c = 0; c < piece.numCells; c++)
         {
-          nnodes[i] = nodemap[(VField::index_type)onodes[i]];
+          for (int k = 0; k < CLIPPER::CellSize; k++)
+            nnodes[k] = corners[piece.cells[c][k]];
+          clipped->set_nodes(nnodes, VMesh::Elem::index_type(cell++));
         }
+        if (task == 0) { cnt++; if (cnt == 100) { cnt = 0; algo_->update_progress_max(end + idx, 2*end); } }
       }
+    });
 
-      clipped->add_elem(nnodes);
-    }
-    else if (inside == 0x8 || inside == 0x4 || inside == 0x2 || inside == 0x1)
+    // Add the data values from the old field to the new field and put the
+    // isovalue at the edge and face break points. Face values assume linear
+    // interpolation across the faces, which is what we used to cut with.
+    Parallel::RunRange(num_kept, Parallel::NumTasks(num_kept), [&](int, VMesh::index_type begin, VMesh::index_type end)
     {
-        // Lop off 3 points and add resulting tet to the new mesh.
-      const int *perm = tet_permute_table[inside];
-      VMesh::Node::array_type nnodes(4);
-
-      if (nodemap.find((VField::index_type)onodes[perm[0]]) == nodemap.end())
-      {
-        const VMesh::Node::index_type nodeindex = clipped->add_point(p[perm[0]]);
-        nodemap[(VField::index_type)onodes[perm[0]]] = nodeindex;
-        nnodes[0] = nodeindex;
-      }
-      else
+      Point p;
+      for (VMesh::index_type idx = begin; idx < end; idx++)
       {
-        nnodes[0] = nodemap[(VField::index_type)onodes[perm[0]]];
+        mesh->get_center(p, VMesh::Node::index_type(nodemap2[idx]));
+        clipped->set_point(p, VMesh::Node::index_type(idx));
+        ofield->copy_value(field, nodemap2[idx], idx);
       }
-
-      const double imv = isoval - v[perm[0]];
-      const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
-      const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
-      const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
-      const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
-      const double dl3 = imv / (v[perm[3]] - v[perm[0]]);
-      const Point l3 = Interpolate(p[perm[0]], p[perm[3]], dl3);
-
-
-      nnodes[1] = edge_lookup((VField::index_type)onodes[perm[0]],
-                              (VField::index_type)onodes[perm[1]],
-                              dl1, l1, edgemap, clipped);
-
-      nnodes[2] = edge_lookup((VField::index_type)onodes[perm[0]],
-                              (VField::index_type)onodes[perm[2]],
-                              dl2, l2, edgemap, clipped);
-
-      nnodes[3] = edge_lookup((VField::index_type)onodes[perm[0]],
-                              (VField::index_type)onodes[perm[3]],
-                              dl3, l3, edgemap, clipped);
-
-      clipped->add_elem(nnodes);
-    }
-    else if (inside == 0x7 || inside == 0xb || inside == 0xd || inside == 0xe)
+    });
+    Parallel::RunRange(num_new, Parallel::NumTasks(num_new), [&](int, VMesh::index_type begin, VMesh::index_type end)
     {
-        // Lop off 1 point, break up the resulting quads and add the
-        // resulting tets to the mesh.
-      const int *perm = tet_permute_table[inside];
-      VMesh::Node::array_type nnodes(4);
-
-      VMesh::Node::index_type inodes[9];
-      for (size_t i = 1; i < 4; i++)
+      for (VMesh::index_type idx = begin; idx < end; idx++)
       {
-        if (nodemap.find((VField::index_type)onodes[perm[i]]) == nodemap.end())
-        {
-          const VMesh::Node::index_type nodeindex = clipped->add_point(p[perm[i]]);
-          nodemap[(VField::index_type)onodes[perm[i]]] = nodeindex;
-          inodes[i-1] = nodeindex;
-        }
-        else
-        {
-          inodes[i-1] = nodemap[(VField::index_type)onodes[perm[i]]];
-        }
+        clipped->set_point(newNodes[idx].point, VMesh::Node::index_type(num_kept + idx));
+        ofield->set_value(isoval, num_kept + idx);
       }
+    });
 
-      const double imv = isoval - v[perm[0]];
-      const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
-      const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
-      const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
-      const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
-      const double dl3 = imv / (v[perm[3]] - v[perm[0]]);
-      const Point l3 = Interpolate(p[perm[0]], p[perm[3]], dl3);
-
-
-      inodes[3] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[1]],
-                              dl1, l1, edgemap, clipped);
-
-      inodes[4] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[2]],
-                              dl2, l2, edgemap, clipped);
-
-      inodes[5] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[3]],
-                              dl3, l3, edgemap, clipped);
-
-      const Point c1 = Interpolate(l1, l2, 0.5);
-      const Point c2 = Interpolate(l2, l3, 0.5);
-      const Point c3 = Interpolate(l3, l1, 0.5);
-
-      inodes[6] = face_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[1]],
-                              (index_type)onodes[perm[2]],
-                              dl1*0.5, dl2*0.5,
-                              c1, facemap, clipped);
-      inodes[7] = face_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[2]],
-                              (index_type)onodes[perm[3]],
-                              dl2*0.5, dl3*0.5,
-                              c2, facemap, clipped);
-      inodes[8] = face_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[3]],
-                              (index_type)onodes[perm[1]],
-                              dl3*0.5, dl1*0.5,
-                              c3, facemap, clipped);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[3];
-      nnodes[2] = inodes[8];
-      nnodes[3] = inodes[6];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[1];
-      nnodes[1] = inodes[4];
-      nnodes[2] = inodes[6];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[2];
-      nnodes[1] = inodes[5];
-      nnodes[2] = inodes[7];
-      nnodes[3] = inodes[8];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[6];
-      nnodes[2] = inodes[8];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[8];
-      nnodes[2] = inodes[2];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[6];
-      nnodes[2] = inodes[7];
-      nnodes[3] = inodes[1];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[1];
-      nnodes[2] = inodes[7];
-      nnodes[3] = inodes[2];
-      clipped->add_elem(nnodes);
-    }
-    else// if (inside == 0x3 || inside == 0x5 || inside == 0x6 ||
-          //     inside == 0x9 || inside == 0xa || inside == 0xc)
+    if (mapping)
     {
-        // Lop off two points, break the resulting quads, then add the
-        // new tets to the mesh.
-      const int *perm = tet_permute_table[inside];
-      VMesh::Node::array_type nnodes(4);
-
-      VMesh::Node::index_type inodes[8];
-      for (size_t i = 2; i < 4; i++)
+      // Interpolant matrix from the input nodes to the clipped nodes.
+      typedef SparseRowMatrix::Triplet T;
+      std::vector<T> tripletList;
+      tripletList.reserve(num_kept + 3 * num_new);
+      for (VMesh::index_type idx = 0; idx < num_kept; idx++)
+        tripletList.push_back(T(idx, nodemap2[idx], 1.0));
+      for (VMesh::index_type idx = 0; idx < num_new; idx++)
       {
-        if (nodemap.find((VField::index_type)onodes[perm[i]]) == nodemap.end())
-        {
-          const VMesh::Node::index_type nodeindex = clipped->add_point(p[perm[i]]);
-          nodemap[(VField::index_type)onodes[perm[i]]] = nodeindex;
-          inodes[i-2] = nodeindex;
-        }
-        else
-        {
-          inodes[i-2] = nodemap[(VField::index_type)onodes[perm[i]]];
-        }
+        const ClipNode& n = newNodes[idx];
+        for (int k = 0; k < n.size; k++)
+          tripletList.push_back(T(num_kept + idx, n.nodes[k], n.weights[k]));
       }
-      const double imv0 = isoval - v[perm[0]];
-      const double dl02 = imv0 / (v[perm[2]] - v[perm[0]]);
-      const Point l02 = Interpolate(p[perm[0]], p[perm[2]], dl02);
-      const double dl03 = imv0 / (v[perm[3]] - v[perm[0]]);
-      const Point l03 = Interpolate(p[perm[0]], p[perm[3]], dl03);
-
-      const double imv1 = isoval - v[perm[1]];
-      const double dl12 = imv1 / (v[perm[2]] - v[perm[1]]);
-      const Point l12 = Interpolate(p[perm[1]], p[perm[2]], dl12);
-      const double dl13 = imv1 / (v[perm[3]] - v[perm[1]]);
-      const Point l13 = Interpolate(p[perm[1]], p[perm[3]], dl13);
-
-
-      inodes[2] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[2]],
-                              dl02, l02, edgemap, clipped);
-      inodes[3] = edge_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[3]],
-                              dl03, l03, edgemap, clipped);
-      inodes[4] = edge_lookup((index_type)onodes[perm[1]],
-                              (index_type)onodes[perm[2]],
-                              dl12, l12, edgemap, clipped);
-      inodes[5] = edge_lookup((index_type)onodes[perm[1]],
-                              (index_type)onodes[perm[3]],
-                              dl13, l13, edgemap, clipped);
-
-      const Point c1 = Interpolate(l02, l03, 0.5);
-      const Point c2 = Interpolate(l12, l13, 0.5);
-
-      inodes[6] = face_lookup((index_type)onodes[perm[0]],
-                              (index_type)onodes[perm[2]],
-                              (index_type)onodes[perm[3]],
-                              dl02*0.5,
-                              dl03*0.5,
-                              c1, facemap, clipped);
-      inodes[7] = face_lookup((index_type)onodes[perm[1]],
-                              (index_type)onodes[perm[2]],
-                              (index_type)onodes[perm[3]],
-                              dl12*0.5,
-                              dl13*0.5,
-                              c2, facemap, clipped);
-
-      nnodes[0] = inodes[7];
-      nnodes[1] = inodes[2];
-      nnodes[2] = inodes[0];
-      nnodes[3] = inodes[4];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[1];
-      nnodes[1] = inodes[5];
-      nnodes[2] = inodes[3];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[1];
-      nnodes[1] = inodes[3];
-      nnodes[2] = inodes[6];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[7];
-      nnodes[2] = inodes[6];
-      nnodes[3] = inodes[2];
-      clipped->add_elem(nnodes);
-
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[1];
-      nnodes[2] = inodes[6];
-      nnodes[3] = inodes[7];
-      clipped->add_elem(nnodes);
+      SparseRowMatrixHandle mat(new SparseRowMatrix(num_kept + num_new, num_nodes));
+      mat->setFromTriplets(tripletList.begin(), tripletList.end());
+      *mapping = mat;
     }
-  }
 
-  VField* ofield = output->vfield();
-  ofield->resize_values();
-  CopyProperties(*input, *output);
-
-    // Add the data values from the old field to the new field.
-  node_hash_type::iterator nmitr = nodemap.begin();
-  while (nmitr != nodemap.end())
-  {
-    ofield->copy_value(field,((*nmitr).first),((*nmitr).second));
-    ++nmitr;
-  }
-
-    // Put the isovalue at the edge break points.
-  edge_hash_type::iterator emitr = edgemap.begin();
-  while (emitr != edgemap.end())
-  {
-    ofield->set_value(isoval,((*emitr).second));
-    ++emitr;
+    return (true);
   }
+}
 
-    // Put the isovalue at the face break points.  Assumes linear
-    // interpolation across the faces (which seems safe, this is what we
-    // used to cut with.)
-  face_hash_type::iterator fmitr = facemap.begin();
-  while (fmitr != facemap.end())
-  {
-    ofield->set_value(isoval,((*fmitr).second));
-    ++fmitr;
-  }
+ClipMeshByIsovalueAlgo::ClipMeshByIsovalueAlgo()
+{
+ addParameter(LessThanIsoValue, 1);
+ addParameter(ScalarIsoValue, 0.0);
+}
 
-  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  if (algo->get_bool("build_mapping"))
-  {
-      // Create the interpolant matrix.
-    const size_type nrows = clipped->num_nodes();
-    const size_type ncols = mesh->num_nodes();
+class ClipMeshByIsovalueAlgoTet {
 
-    std::vector<index_type> cctmp(nrows*3);
-    std::vector<double> dtmp(nrows*3);
-    SparseRowMatrix::Builder sparseBuilder;
-    const SparseRowMatrix::Rows& rr = sparseBuilder.allocate_rows(nrows + 1);
+  public:
+    static const int CellSize = 4;
 
-    for (index_type i = 0; i < nrows * 3; i++)
-    {
-      cctmp[i] = -1;
-    }
+    ClipMeshByIsovalueAlgoTet(VMesh* mesh, VField* field, double isoval, bool lte) :
+      mesh_(mesh), field_(field), isoval_(isoval), lte_(lte), onodes_(4), v_(4), p_(4) {}
 
-    size_type nnz = 0;
+    bool run(const AlgorithmBase* algo,FieldHandle input, FieldHandle& output, MatrixHandle* mapping) const;
 
-      // Add the data values from the old field to the new field.
-    nmitr = nodemap.begin();
-    while (nmitr != nodemap.end())
-    {
-      cctmp[(*nmitr).second * 3] = (*nmitr).first;
-      dtmp[(*nmitr).second * 3 + 0] = 1.0;
-      nnz++;
-      ++nmitr;
-    }
+    /// Cut one tetrahedron; lookups of shared nodes are left to ParallelClip.
+    void clip(VMesh::Elem::index_type idx, detail::ClippedElement& piece);
 
-      // Insert the double hits into cc.
-      // Put the isovalue at the edge break points.
-    emitr = edgemap.begin();
-    while (emitr != edgemap.end())
-    {
-      cctmp[(*emitr).second * 3 + 0] = (*emitr).first.first;
-      cctmp[(*emitr).second * 3 + 1] = (*emitr).first.second;
-      dtmp[(*emitr).second * 3 + 0] = 1.0 - (*emitr).first.dfirst;
-      dtmp[(*emitr).second * 3 + 1] = (*emitr).first.dfirst;
-      nnz+=2;
-      ++emitr;
-    }
+  private:
+    VMesh*  mesh_;
+    VField* field_;
+    double  isoval_;
+    bool    lte_;
+
+    VMesh::Node::array_type onodes_;
+    std::vector<double> v_;
+    std::vector<Point> p_;
+ };
 
-      // Insert the double hits into cc.
-      // Put the isovalue at the edge break points.
-    fmitr = facemap.begin();
-    while (fmitr != facemap.end())
-    {
-      cctmp[(*fmitr).second * 3 + 0] = (*fmitr).first.first;
-      cctmp[(*fmitr).second * 3 + 1] = (*fmitr).first.second;
-      cctmp[(*fmitr).second * 3 + 2] = (*fmitr).first.third;
-      dtmp[(*fmitr).second * 3 + 0] =
-          1.0 - (*fmitr).first.dsecond - (*fmitr).first.dthird;;
-      dtmp[(*fmitr).second * 3 + 1] = (*fmitr).first.dsecond;
-      dtmp[(*fmitr).second * 3 + 2] = (*fmitr).first.dthird;
-      nnz+=3;
-
-      ++fmitr;
-    }
+void ClipMeshByIsovalueAlgoTet::clip(VMesh::Elem::index_type idx, detail::ClippedElement& piece)
+{
+  VMesh::Node::array_type& onodes = onodes_;
+  std::vector<double>& v = v_;
+  std::vector<Point>& p = p_;
+  const double isoval = isoval_;
 
-    const SparseRowMatrix::Columns& cc = sparseBuilder.allocate_columns(nnz);
-    const SparseRowMatrix::Storage& d = sparseBuilder.allocate_data(nnz);
+  piece.clear();
+  mesh_->get_nodes(onodes, idx);
 
-    index_type j;
-    index_type counter = 0;
-    rr[0] = 0;
-    for (j = 0; j < nrows*3; j++)
+    // Get the values and compute an inside/outside mask.
+  VField::index_type inside = 0;
+  mesh_->get_centers(p, onodes);
+  field_->get_values(v,onodes);
+  for (size_t i = 0; i < onodes.size(); i++)
+  {
+    inside = inside << 1;
+    if (v[i] > isoval)
     {
-      if (j%3 == 0) { rr[j/3 + 1] = rr[j/3]; }
-      if (cctmp[j] != -1)
-      {
-        cc[counter] = cctmp[j];
-        d[counter] = dtmp[j];
-        rr[j/3 + 1]++;
-        counter++;
-      }
+      inside |= 1;
     }
-    mapping = new SparseRowMatrix(nrows, ncols, sparseBuilder.build(), nnz);
-  }
-  #endif
 
-  return (true);
-}
-
-// Algorithm for tri meshes
-
-class ClipMeshByIsovalueAlgoTri
-{
-  public:
-    bool run(const AlgorithmBase* algo,FieldHandle input, FieldHandle& output, MatrixHandle& mapping) const;
+  }
 
-private:
-    VMesh::Node::index_type
-    edge_lookup(VField::index_type u0, VField::index_type u1, double d0,
-          const Point &p, detail::edge_hash_type &edgemap,
-          VMesh *clipped) const;
-};
+    // Invert the mask if we are doing less than.
+  if (lte_) { inside = ~inside & 0xf; }
 
-VMesh::Node::index_type ClipMeshByIsovalueAlgoTri::edge_lookup(VField::index_type u0, VField::index_type u1, double d0, const Point &p, detail::edge_hash_type &edgemap, VMesh *clipped) const
-{
-  using namespace detail;
-  edgepair_t np;
-  if (u0 < u1)  { np.first = u0; np.second = u1; np.dfirst = d0; }
-  else { np.first = u1; np.second = u0; np.dfirst = 1.0 - d0; }
-  const auto loc = edgemap.find(np);
-  if (loc == edgemap.end())
+  if (inside == 0)
   {
-    const VMesh::Node::index_type nodeindex = clipped->add_point(p);
-    edgemap[np] = nodeindex;
-    return nodeindex;
+      // Discard outside elements.
   }
-  else
+  else if (inside == 0xf)
   {
-    return loc->second;
-  }
-}
-
-bool ClipMeshByIsovalueAlgoTri::run(const AlgorithmBase* algo, FieldHandle input, FieldHandle& output, MatrixHandle &mapping) const
-{
-  VField* field = input->vfield();
-  VMesh*  mesh  = input->vmesh();
-  VMesh*  clipped = output->vmesh();
-
-  using namespace detail;
+      // Add this element to the new mesh.
+    for (size_t i = 0; i<onodes.size(); i++)
+    {
+      piece.addNode(onodes[i], p[i]);
+    }
 
-  node_hash_type nodemap;
-  edge_hash_type edgemap;
+    piece.addCell(0, 1, 2, 3);
+  }
+  else if (inside == 0x8 || inside == 0x4 || inside == 0x2 || inside == 0x1)
+  {
+      // Lop off 3 points and add resulting tet to the new mesh.
+    const int *perm = tet_permute_table[inside];
 
-  VMesh::Node::array_type onodes(3);
-  std::vector<double> v(3);
-  std::vector<Point>  p(3);
+    piece.addNode(onodes[perm[0]], p[perm[0]]);
 
-  double isoval = algo->get(ClipMeshByIsovalueAlgo::ScalarIsoValue).toDouble();
+    const double imv = isoval - v[perm[0]];
+    const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
+    const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
+    const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
+    const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
+    const double dl3 = imv / (v[perm[3]] - v[perm[0]]);
+    const Point l3 = Interpolate(p[perm[0]], p[perm[3]], dl3);
 
-  bool lte = !algo->get(ClipMeshByIsovalueAlgo::LessThanIsoValue).toBool();
+    piece.addEdgeNode(onodes[perm[0]], onodes[perm[1]], dl1, l1);
+    piece.addEdgeNode(onodes[perm[0]], onodes[perm[2]], dl2, l2);
+    piece.addEdgeNode(onodes[perm[0]], onodes[perm[3]], dl3, l3);
 
-  VMesh::size_type num_elems = mesh->num_elems();
-  for (VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
+    piece.addCell(0, 1, 2, 3);
+  }
+  else if (inside == 0x7 || inside == 0xb || inside == 0xd || inside == 0xe)
   {
-    mesh->get_nodes(onodes, idx);
-
-    // Get the values and compute an inside/outside mask.
-    VField::index_type inside = 0;
-    mesh->get_centers(p, onodes);
-    field->get_values(v, onodes);
+      // Lop off 1 point, break up the resulting quads and add the
+      // resulting tets to the mesh.
+    const int *perm = tet_permute_table[inside];
 
-    for (size_t i = 0; i < onodes.size(); i++)
+    for (size_t i = 1; i < 4; i++)
     {
-      inside = inside << 1;
-      if (v[i] > isoval)
-      {
-        inside |= 1;
-      }
+      piece.addNode(onodes[perm[i]], p[perm[i]]);
     }
 
-    // Invert the mask if we are doing less than.
-    if (lte) { inside = ~inside & 0x7; }
+    const double imv = isoval - v[perm[0]];
+    const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
+    const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
+    const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
+    const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
+    const double dl3 = imv / (v[perm[3]] - v[perm[0]]);
+    const Point l3 = Interpolate(p[perm[0]], p[perm[3]], dl3);
+
+    piece.addEdgeNode(onodes[perm[0]], onodes[perm[1]], dl1, l1);
+    piece.addEdgeNode(onodes[perm[0]], onodes[perm[2]], dl2, l2);
+    piece.addEdgeNode(onodes[perm[0]], onodes[perm[3]], dl3, l3);
+
+    const Point c1 = Interpolate(l1, l2, 0.5);
+    const Point c2 = Interpolate(l2, l3, 0.5);
+    const Point c3 = Interpolate(l3, l1, 0.5);
+
+    piece.addFaceNode(onodes[perm[0]], onodes[perm[1]], onodes[perm[2]],
+                      dl1*0.5, dl2*0.5, c1);
+    piece.addFaceNode(onodes[perm[0]], onodes[perm[2]], onodes[perm[3]],
+                      dl2*0.5, dl3*0.5, c2);
+    piece.addFaceNode(onodes[perm[0]], onodes[perm[3]], onodes[perm[1]],
+                      dl3*0.5, dl1*0.5, c3);
+
+    piece.addCell(0, 3, 8, 6);
+    piece.addCell(1, 4, 6, 7);
+    piece.addCell(2, 5, 7, 8);
+    piece.addCell(0, 6, 8, 7);
+    piece.addCell(0, 8, 2, 7);
+    piece.addCell(0, 6, 7, 1);
+    piece.addCell(0, 1, 7, 2);
+  }
+  else// if (inside == 0x3 || inside == 0x5 || inside == 0x6 ||
+        //     inside == 0x9 || inside == 0xa || inside == 0xc)
+  {
+      // Lop off two points, break the resulting quads, then add the
+      // new tets to the mesh.
+    const int *perm = tet_permute_table[inside];
 
-    if (inside == 0)
-    {
-      // Discard outside elements.
-    }
-    else if (inside == 0x7)
+    for (size_t i = 2; i < 4; i++)
     {
-      // Add this element to the new mesh.
-      VMesh::Node::array_type nnodes(onodes.size());
-
-      for (size_t i = 0; i<onodes.size(); i++)
-      {
-        if (nodemap.find((VField::index_type)onodes[i]) == nodemap.end())
-        {
-          const VMesh::Node::index_type nodeindex = clipped->add_point(p[i]);
-          nodemap[(VField::index_type)onodes[i]] = nodeindex;
-          nnodes[i] = nodeindex;
-        }
-        else
-        {
-          nnodes[i] = nodemap[(VField::index_type)onodes[i]];
-        }
-      }
-
-      clipped->add_elem(nnodes);
+      piece.addNode(onodes[perm[i]], p[perm[i]]);
     }
-    else if (inside == 0x1 || inside == 0x2 || inside == 0x4)
-    {
-      // Add the corner containing the inside point to the mesh.
-      const int *perm = tri_permute_table[inside];
-      VMesh::Node::array_type nnodes(onodes.size());
-      if (nodemap.find((VField::index_type)onodes[perm[0]]) == nodemap.end())
-      {
-        const VMesh::Node::index_type nodeindex =
-            clipped->add_point(p[perm[0]]);
-        nodemap[(VField::index_type)onodes[perm[0]]] = nodeindex;
-        nnodes[0] = nodeindex;
-      }
-      else
-      {
-        nnodes[0] = nodemap[(VField::index_type)onodes[perm[0]]];
-      }
-
-      const double imv = isoval - v[perm[0]];
+    const double imv0 = isoval - v[perm[0]];
+    const double dl02 = imv0 / (v[perm[2]] - v[perm[0]]);
+    const Point l02 = Interpolate(p[perm[0]], p[perm[2]], dl02);
+    const double dl03 = imv0 / (v[perm[3]] - v[perm[0]]);
+    const Point l03 = Interpolate(p[perm[0]], p[perm[3]], dl03);
+
+    const double imv1 = isoval - v[perm[1]];
+    const double dl12 = imv1 / (v[perm[2]] - v[perm[1]]);
+    const Point l12 = Interpolate(p[perm[1]], p[perm[2]], dl12);
+    const double dl13 = imv1 / (v[perm[3]] - v[perm[1]]);
+    const Point l13 = Interpolate(p[perm[1]], p[perm[3]], dl13);
+
+    piece.addEdgeNode(onodes[perm[0]], onodes[perm[2]], dl02, l02);
+    piece.addEdgeNode(onodes[perm[0]], onodes[perm[3]], dl03, l03);
+    piece.addEdgeNode(onodes[perm[1]], onodes[perm[2]], dl12, l12);
+    piece.addEdgeNode(onodes[perm[1]], onodes[perm[3]], dl13, l13);
+
+    const Point c1 = Interpolate(l02, l03, 0.5);
+    const Point c2 = Interpolate(l12, l13, 0.5);
+
+    piece.addFaceNode(onodes[perm[0]], onodes[perm[2]], onodes[perm[3]],
+                      dl02*0.5, dl03*0.5, c1);
+    piece.addFaceNode(onodes[perm[1]], onodes[perm[2]], onodes[perm[3]],
+                      dl12*0.5, dl13*0.5, c2);
+
+    piece.addCell(7, 2, 0, 4);
+    piece.addCell(1, 5, 3, 7);
+    piece.addCell(1, 3, 6, 7);
+    piece.addCell(0, 7, 6, 2);
+    piece.addCell(0, 1, 6, 7);
+  }
+}
 
-      const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
-      const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
-      const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
-      const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
+bool ClipMeshByIsovalueAlgoTet::run(const AlgorithmBase* algo, FieldHandle input, FieldHandle& output, MatrixHandle* mapping) const
+{
+  detail::ParallelClip<ClipMeshByIsovalueAlgoTet> clip(algo, *this);
+  return clip.run(input, output, mapping, isoval_);
+}
 
+// Algorithm for tri meshes
 
-      nnodes[1] = edge_lookup((VField::index_type)onodes[perm[0]],
-			      (index_type)onodes[perm[1]],
-			      dl1, l1, edgemap, clipped);
+class ClipMeshByIsovalueAlgoTri
+{
+  public:
+    static const int CellSize = 3;
 
-      nnodes[2] = edge_lookup((VField::index_type)onodes[perm[0]],
-			      (index_type)onodes[perm[2]],
-			      dl2, l2, edgemap, clipped);
+    ClipMeshByIsovalueAlgoTri(VMesh* mesh, VField* field, double isoval, bool lte) :
+      mesh_(mesh), field_(field), isoval_(isoval), lte_(lte), onodes_(3), v_(3), p_(3) {}
 
-      clipped->add_elem(nnodes);
-    }
-    else
-    {
-      // Lop off the one point that is outside of the mesh, then add
-      // the remaining quad to the mesh by dicing it into two
-      // triangles.
-      const int *perm = tri_permute_table[inside];
-      VMesh::Node::array_type inodes(4);
-      if (nodemap.find((index_type)onodes[perm[1]]) == nodemap.end())
-      {
-        const VMesh::Node::index_type nodeindex = clipped->add_point(p[perm[1]]);
-        nodemap[(VField::index_type)onodes[perm[1]]] = nodeindex;
-        inodes[0] = nodeindex;
-      }
-      else
-      {
-        inodes[0] = nodemap[(VField::index_type)onodes[perm[1]]];
-      }
+    bool run(const AlgorithmBase* algo,FieldHandle input, FieldHandle& output, MatrixHandle* mapping) const;
 
-      if (nodemap.find((VField::index_type)onodes[perm[2]]) == nodemap.end())
-      {
-        const VMesh::Node::index_type nodeindex = clipped->add_point(p[perm[2]]);
-        nodemap[(VField::index_type)onodes[perm[2]]] = nodeindex;
-        inodes[1] = nodeindex;
-      }
-      else
-      {
-        inodes[1] = nodemap[(VField::index_type)onodes[perm[2]]];
-      }
+    /// Cut one triangle; lookups of shared nodes are left to ParallelClip.
+    void clip(VMesh::Elem::index_type idx, detail::ClippedElement& piece);
 
-      const double imv = isoval - v[perm[0]];
-      const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
-      const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
-      const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
-      const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
-
-      inodes[2] = edge_lookup((VField::index_type)onodes[perm[0]],
-			      (VField::index_type)onodes[perm[1]],
-			      dl1, l1, edgemap, clipped);
+  private:
+    VMesh*  mesh_;
+    VField* field_;
+    double  isoval_;
+    bool    lte_;
+
+    VMesh::Node::array_type onodes_;
+    std::vector<double> v_;
+    std::vector<Point> p_;
+};
 
-      inodes[3] = edge_lookup((VField::index_type)onodes[perm[0]],
-			      (VField::index_type)onodes[perm[2]],
-			      dl2, l2, edgemap, clipped);
+void ClipMeshByIsovalueAlgoTri::clip(VMesh::Elem::index_type idx, detail::ClippedElement& piece)
+{
+  VMesh::Node::array_type& onodes = onodes_;
+  std::vector<double>& v = v_;
+  std::vector<Point>& p = p_;
+  const double isoval = isoval_;
 
-      VMesh::Node::array_type nnodes(onodes.size());
+  piece.clear();
+  mesh_->get_nodes(onodes, idx);
 
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[1];
-      nnodes[2] = inodes[3];
-      clipped->add_elem(nnodes);
+  // Get the values and compute an inside/outside mask.
+  VField::index_type inside = 0;
+  mesh_->get_centers(p, onodes);
+  field_->get_values(v, onodes);
 
-      nnodes[0] = inodes[0];
-      nnodes[1] = inodes[3];
-      nnodes[2] = inodes[2];
-      clipped->add_elem(nnodes);
+  for (size_t i = 0; i < onodes.size(); i++)
+  {
+    inside = inside << 1;
+    if (v[i] > isoval)
+    {
+      inside |= 1;
     }
   }
 
-  VField* ofield = output->vfield();
-  ofield->resize_values();
-  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-   ofield->copy_properties(field);
-  #endif
-
-  // Add the data values from the old field to the new field.
-  node_hash_type::iterator nmitr = nodemap.begin();
-  while (nmitr != nodemap.end())
-  {
-    ofield->copy_value(field,((*nmitr).first),((*nmitr).second));
-    ++nmitr;
-  }
+  // Invert the mask if we are doing less than.
+  if (lte_) { inside = ~inside & 0x7; }
 
-  // Put the isovalue at the edge break points.
-  edge_hash_type::iterator emitr = edgemap.begin();
-  while (emitr != edgemap.end())
+  if (inside == 0)
   {
-    ofield->set_value(isoval, ((*emitr).second));
-    ++emitr;
+    // Discard outside elements.
   }
-
-  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  if(algo->get_bool("build_mapping"))
+  else if (inside == 0x7)
   {
-    // Create the interpolant matrix.
-
-    const size_type nrows = clipped->num_nodes();
-    const size_type ncols = mesh->num_nodes();
-    std::vector<index_type> cctmp(nrows*2);
-    std::vector<double> dtmp(nrows*2);
-    SparseRowMatrix::Builder sparseBuilder;
-    const SparseRowMatrix::Rows& rr = sparseBuilder.allocate_rows(nrows + 1);
-
-    for (index_type i = 0; i < nrows * 2; i++)
+    // Add this element to the new mesh.
+    for (size_t i = 0; i<onodes.size(); i++)
     {
-      cctmp[i] = -1;
+      piece.addNode(onodes[i], p[i]);
     }
 
-    size_type nnz = 0;
+    piece.addCell(0, 1, 2);
+  }
+  else if (inside == 0x1 || inside == 0x2 || inside == 0x4)
+  {
+    // Add the corner containing the inside point to the mesh.
+    const int *perm = tri_permute_table[inside];
+    piece.addNode(onodes[perm[0]], p[perm[0]]);
 
-    // Add the data values from the old field to the new field.
-    nmitr = nodemap.begin();
-    while (nmitr != nodemap.end())
-    {
-      cctmp[(*nmitr).second * 2] = (*nmitr).first;
-      dtmp[(*nmitr).second * 2 + 0] = 1.0;
-      nnz++;
-      ++nmitr;
-    }
+    const double imv = isoval - v[perm[0]];
 
-    // Insert the double hits into cc.
-    // Put the isovalue at the edge break points.
-    emitr = edgemap.begin();
-    while (emitr != edgemap.end())
-    {
-      cctmp[(*emitr).second * 2 + 0] = (*emitr).first.first;
-      cctmp[(*emitr).second * 2 + 1] = (*emitr).first.second;
-      dtmp[(*emitr).second * 2 + 0] = 1.0 - (*emitr).first.dfirst;
-      dtmp[(*emitr).second * 2 + 1] = (*emitr).first.dfirst;
-      nnz+=2;
-      ++emitr;
-    }
+    const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
+    const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
+    const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
+    const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
 
-    const SparseRowMatrix::Columns& cc = sparseBuilder.allocate_columns(nnz);
-    const SparseRowMatrix::Storage& d = sparseBuilder.allocate_data(nnz);
+    piece.addEdgeNode(onodes[perm[0]], onodes[perm[1]], dl1, l1);
+    piece.addEdgeNode(onodes[perm[0]], onodes[perm[2]], dl2, l2);
 
-    index_type j;
-    index_type counter = 0;
-    rr[0] = 0;
-    for (j = 0; j < nrows*2; j++)
-    {
-      if (j%2 == 0) { rr[j/2 + 1] = rr[j/2]; }
-      if (cctmp[j] != -1)
-      {
-        cc[counter] = cctmp[j];
-        d[counter] = dtmp[j];
-        rr[j/2 + 1]++;
-        counter++;
-      }
-    }
-    mapping = new SparseRowMatrix(nrows, ncols, sparseBuilder.build(), nnz);
+    piece.addCell(0, 1, 2);
   }
-  #endif
+  else
+  {
+    // Lop off the one point that is outside of the mesh, then add
+    // the remaining quad to the mesh by dicing it into two
+    // triangles.
+    const int *perm = tri_permute_table[inside];
+    piece.addNode(onodes[perm[1]], p[perm[1]]);
+    piece.addNode(onodes[perm[2]], p[perm[2]]);
+
+    const double imv = isoval - v[perm[0]];
+    const double dl1 = imv / (v[perm[1]] - v[perm[0]]);
+    const Point l1 = Interpolate(p[perm[0]], p[perm[1]], dl1);
+    const double dl2 = imv / (v[perm[2]] - v[perm[0]]);
+    const Point l2 = Interpolate(p[perm[0]], p[perm[2]], dl2);
+
+    piece.addEdgeNode(onodes[perm[0]], onodes[perm[1]], dl1, l1);
+    piece.addEdgeNode(onodes[perm[0]], onodes[perm[2]], dl2, l2);
+
+    piece.addCell(0, 1, 3);
+    piece.addCell(0, 3, 2);
+  }
+}
 
-  return (true);
+bool ClipMeshByIsovalueAlgoTri::run(const AlgorithmBase* algo, FieldHandle input, FieldHandle& output, MatrixHandle* mapping) const
+{
+  detail::ParallelClip<ClipMeshByIsovalueAlgoTri> clip(algo, *this);
+  return clip.run(input, output, mapping, isoval_);
 }
 
 class ClipMeshByIsovalueAlgoHex
 {
   public:
-    bool run(const AlgorithmBase* algo,FieldHandle input, FieldHandle& output, MatrixHandle& mapping) const;
-
-    static bool ud_pair_less(const std::pair<VField::index_type, double> &a,
-                             const std::pair<VField::index_type, double> &b)
-    {
-        return a.first < b.first;
-    };
-
+    bool run(const AlgorithmBase* algo,FieldHandle input, FieldHandle& output, MatrixHandle* mapping) const;
 };
 
-bool ClipMeshByIsovalueAlgoHex::run(const AlgorithmBase* algo, FieldHandle input, FieldHandle& output, MatrixHandle &mapping) const
+bool ClipMeshByIsovalueAlgoHex::run(const AlgorithmBase* algo, FieldHandle input, FieldHandle& output, MatrixHandle* mapping) const
 {
+  using namespace detail;
+
   // Do marching cubes
   FieldHandle tri_field;
 
@@ -972,240 +650,184 @@ bool ClipMeshByIsovalueAlgoHex::run(const AlgorithmBase* algo, FieldHandle input
   VMesh*  mesh  = input->vmesh();
   VMesh*  clipped = output->vmesh();
 
-  // Get a list of the original boundary elements (code from FieldBoundary).
-  std::map<VMesh::DElem::index_type, VMesh::DElem::index_type> original_boundary;
+  // Flag the original boundary faces (code from FieldBoundary). A boundary
+  // face has a single element, so every flag has one writer.
   mesh->synchronize(Mesh::ELEM_NEIGHBORS_E | Mesh::FACES_E);
 
-  // Walk all the cells in the mesh looking for faces on the boundary
+  const VMesh::size_type num_elems = mesh->num_elems();
+  const VMesh::size_type num_nodes = mesh->num_nodes();
+  const int numTasks = Parallel::NumTasks(num_elems);
+  std::vector<char> original_boundary(mesh->num_delems(), 0);
 
-  VMesh::size_type num_elems = mesh->num_elems();
-  VMesh::DElem::array_type delems;
-  VMesh::Elem::index_type nidx;
+  // Find all of the hexes inside the isosurface and flag their nodes.
+  std::vector<char> inside(num_elems, 0);
+  node_flags_type kept(num_nodes);
+  std::vector<VMesh::size_type> elemOffsets(numTasks + 1, 0);
 
-  for (VMesh::Elem::index_type idx=0; idx< num_elems; idx++)
+  Parallel::RunRange(num_elems, numTasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
   {
-    // Get all the faces in the cell.
-    mesh->get_delems(delems, idx);
-
-    for (size_t j=0; j<delems.size(); j++)
+    VMesh::DElem::array_type delems;
+    VMesh::Elem::index_type nidx;
+    VMesh::Node::array_type onodes;
+    std::vector<double> v;
+    VMesh::size_type count = 0;
+    for (VMesh::Elem::index_type idx = begin; idx < end; idx++)
     {
-      if( !mesh->get_neighbor(nidx, idx, delems[j] ) )
+      // Faces with no neighbors are on the boundary.
+      mesh->get_delems(delems, idx);
+      for (size_t j=0; j<delems.size(); j++)
+      {
+        if( !mesh->get_neighbor(nidx, idx, delems[j] ) )
+          original_boundary[delems[j]] = 1;
+      }
+
+      mesh->get_nodes(onodes, idx);
+      field->get_values(v, onodes);
+      bool in = true;
+      for (size_t i = 0; i < onodes.size() && in; i++)
+        in = lte ? !(v[i] > isoval) : !(v[i] < isoval);
+
+      if (in)
       {
-        // Faces with no neighbors are on the boundary.
-        original_boundary[delems[j]] = delems[j];
+        inside[idx] = 1;
+        count++;
+        for (size_t i = 0; i < onodes.size(); i++)
+          kept[onodes[i]].store(1, std::memory_order_relaxed);
       }
     }
-  }
+    elemOffsets[task + 1] = count;
+  });
 
-  // Create a map to help differentiate between new nodes created for
-  // the inserted sheet, and the nodes on the stair stepped boundary.
-  std::map<VMesh::Node::index_type, VMesh::Node::index_type> clipped_to_original_nodemap;
-  typedef std::unordered_map<VField::index_type, VMesh::Node::index_type> hash_type;
+  for (int task = 0; task < numTasks; task++)
+    elemOffsets[task + 1] += elemOffsets[task];
 
-  hash_type nodemap;
+  // Kept nodes are numbered in input order; clipped_to_original_nodemap
+  // differentiates them from the new nodes created for the inserted sheet.
+  std::vector<VMesh::index_type> nodemap, clipped_to_original_nodemap;
+  const VMesh::size_type num_kept = FlaggedNodes::number(kept, nodemap, clipped_to_original_nodemap);
+  const VMesh::size_type num_celems = elemOffsets[numTasks];
 
-  std::vector<VMesh::Elem::index_type> elemmap;
+  clipped->resize_nodes(num_kept);
+  clipped->resize_elems(num_celems);
 
-  // Find all of the hexes inside the isosurface and add them to the
-  // clipped mesh.
-  for (VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
+  Parallel::RunRange(num_elems, numTasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
   {
-    bool inside = false;
-
     VMesh::Node::array_type onodes;
-    mesh->get_nodes(onodes, idx);
-    inside = true;
-
-    for (size_t i = 0; i < onodes.size(); i++)
+    VMesh::index_type cidx = elemOffsets[task];
+    for (VMesh::Elem::index_type idx = begin; idx < end; idx++)
     {
-      double v;
-      field->get_value(v, onodes[i]);
-
-      if( lte )
-      {
-        if( v > isoval )
-        {
-          inside = false;
-          break;
-        }
-      }
-      else
-      {
-        if( v < isoval )
-        {
-          inside = false;
-          break;
-        }
-      }
+      if (!inside[idx]) continue;
+      mesh->get_nodes(onodes, idx);
+      for (size_t i = 0; i < onodes.size(); i++)
+        onodes[i] = nodemap[onodes[i]];
+      clipped->set_nodes(onodes, VMesh::Elem::index_type(cidx++));
     }
+  });
 
-    if (inside)
+  const int numNodeTasks = Parallel::NumTasks(num_kept);
+  Parallel::RunRange(num_kept, numNodeTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    Point np;
+    for (VMesh::index_type idx = begin; idx < end; idx++)
     {
-      VMesh::Node::array_type onodes;
-      mesh->get_nodes(onodes, idx);
-
-      // Add this element to the new mesh.
-      VMesh::Node::array_type nnodes(onodes.size());
-
-      for (size_t i = 0; i<onodes.size(); i++)
-      {
-        if (nodemap.find((VField::index_type)onodes[i]) == nodemap.end())
-        {
-          Point np;
-          mesh->get_center(np, onodes[i]);
-          const VMesh::Node::index_type nodeindex = clipped->add_point(np);
-          clipped_to_original_nodemap[nodeindex] = onodes[i];
-          nodemap[(VField::index_type)onodes[i]] = nodeindex;
-          nnodes[i] = nodeindex;
-        }
-        else
-        {
-          nnodes[i] = nodemap[(VField::index_type)onodes[i]];
-        }
-      }
-
-      clipped->add_elem(nnodes);
-      elemmap.push_back(idx); // Assumes elements always added to end.
+      mesh->get_center(np, VMesh::Node::index_type(clipped_to_original_nodemap[idx]));
+      clipped->set_point(np, VMesh::Node::index_type(idx));
     }
-  }
+  });
 
   // Get the boundary elements of the clipped mesh (code from FieldBoundary)
   // We'll use this list of boundary elements (minus the elements from
   // the original boundary) so we know which nodes to project to the
   // isosurface to create the new sheet of hexes.
-  std::map<VMesh::Node::index_type, VMesh::Node::index_type> vertex_map;
-
-  std::vector<VMesh::Node::index_type> node_list;
-  std::vector<VMesh::DElem::index_type> face_list;
-
   clipped->synchronize( Mesh::ELEM_NEIGHBORS_E | Mesh::FACES_E );
 
-  // Walk all the cells in the clipped mesh to find the boundary faces.
+  const int numClippedTasks = Parallel::NumTasks(num_celems);
+  std::vector<std::vector<VMesh::index_type> > taskFaces(numClippedTasks);
+  node_flags_type on_sheet(num_kept);
 
-  VMesh::size_type num_celems = clipped->num_elems();
-  VMesh::DElem::array_type faces;
-  VMesh::DElem::index_type old_face;
-  VMesh::Node::array_type face_nodes;
-  VMesh::Node::array_type nodes;
-
-  for (VMesh::Elem::index_type idx = 0; idx<num_celems; idx++)
+  Parallel::RunRange(num_celems, numClippedTasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
   {
-    // Get all the faces in the cell.
-    clipped->get_delems( faces, idx );
-
-    // Check each face for neighbors.
-    VMesh::DElem::array_type::iterator fiter = faces.begin();
-
-    while( fiter != faces.end() )
+    VMesh::DElem::array_type faces;
+    VMesh::DElem::index_type old_face;
+    VMesh::Node::array_type face_nodes;
+    VMesh::Node::array_type nodes;
+    std::vector<VMesh::index_type>& face_list = taskFaces[task];
+    for (VMesh::Elem::index_type idx = begin; idx < end; idx++)
     {
-      VMesh::Elem::index_type nci;
-      VMesh::DElem::index_type fi = *fiter;
-      ++fiter;
-
-      if( !clipped->get_neighbor( nci, idx, fi ) )
+      // Check each face of the cell for neighbors.
+      clipped->get_delems( faces, idx );
+      for (size_t f = 0; f < faces.size(); f++)
       {
+        VMesh::Elem::index_type nci;
+        if( clipped->get_neighbor( nci, idx, faces[f] ) ) continue;
+
         // Faces with no neighbors are on the boundary.  Make sure
         // that this face isn't on the original boundary.
-        bool is_old_boundary = false;
-        index_type i;
-
-        clipped->get_nodes( face_nodes, fi );
-        for (size_t j=0;j<4; j++) face_nodes[j] = clipped_to_original_nodemap[face_nodes[j]];
-        if( mesh->get_delem( old_face, face_nodes) )
-        {
-          auto bound_iter = original_boundary.find( old_face );
-          if( bound_iter != original_boundary.end() )
-          {
-            is_old_boundary = true;
-          }
-        }
-
-        // Don't add the nodes from the faces of the original boundary
-        // to the list of nodes that we'll be projecting later to
-        // create the new sheet of hex elements.
-        if( !is_old_boundary )
-        {
-          face_list.push_back( fi );
-
-          clipped->get_nodes( nodes, fi );
-
-          VMesh::Node::array_type::iterator niter = nodes.begin();
-
-          VMesh::size_type size = nodes.size();
-          for( i = 0; i < size; i++ )
-          {
-            auto node_iter = vertex_map.find( *niter );
-            if( node_iter == vertex_map.end() )
-            {
-              node_list.push_back( *niter );
-              vertex_map[*niter] = *niter;
-            }
-            ++niter;
-          }
-        }
+        clipped->get_nodes( nodes, faces[f] );
+        face_nodes = nodes;
+        for (size_t j=0;j<face_nodes.size(); j++) face_nodes[j] = clipped_to_original_nodemap[face_nodes[j]];
+        if( mesh->get_delem( old_face, face_nodes) && original_boundary[old_face] ) continue;
+
+        // Keep the nodes of the remaining faces; they are projected later
+        // to create the new sheet of hex elements.
+        face_list.insert(face_list.end(), nodes.begin(), nodes.end());
+        for (size_t j=0; j<nodes.size(); j++)
+          on_sheet[nodes[j]].store(1, std::memory_order_relaxed);
       }
     }
-  }
+  });
+
+  std::vector<VMesh::index_type> face_list;
+  for (int task = 0; task < numClippedTasks; task++)
+    face_list.insert(face_list.end(), taskFaces[task].begin(), taskFaces[task].end());
 
   // For each new node on the clipped boundary, project a new node to
-  // the isosurface create a map between the clipped boundary nodes
-  // and the new nodes to help us create hexes with the correct
-  // connectivity later.
+  // the isosurface; new_map links the clipped boundary nodes to the new
+  // nodes so the hexes of the sheet get the correct connectivity.
+  std::vector<VMesh::index_type> new_map, node_list;
+  const VMesh::size_type num_sheet = FlaggedNodes::number(on_sheet, new_map, node_list);
+  const VMesh::size_type num_faces = face_list.size() / 4;
+
+  clipped->resize_nodes(num_kept + num_sheet);
+  clipped->resize_elems(num_celems + num_faces);
+
   if (!tri_mesh->is_empty())
     tri_mesh->synchronize( Mesh::FIND_CLOSEST_ELEM_E );
-  std::map<VMesh::Node::index_type, VMesh::Node::index_type> new_map;
 
-  int cnt = 0;
-  for(size_t i = 0; i < node_list.size(); i++ )
+  const int numSheetTasks = Parallel::NumTasks(num_sheet);
+  Parallel::RunRange(num_sheet, numSheetTasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
   {
-    VMesh::Node::index_type this_node = node_list[i];
-    Point n_p;
-    clipped->get_center( n_p, this_node );
-
-    Point new_result;
+    Point n_p, new_result;
     VMesh::Elem::index_type face_id;
     double dist;
-
-    tri_mesh->find_closest_elem(dist, new_result, face_id, n_p );
-
-    // Add the new node to the clipped mesh.
-    Point new_point( new_result );
-    VMesh::Node::index_type this_index = clipped->add_point( new_point );
-
-    // Create a map for the new node to a node on the boundary of the
-    // clipped mesh.
-    new_map[this_node] = this_index;
-    cnt++;
-    if (cnt == 100)
+    int cnt = 0;
+    for (VMesh::index_type i = begin; i < end; i++)
     {
-     cnt = 0;
-     #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-      algo->update_progress(i,(size_type)(1.3*num_celems));
-     #endif
+      clipped->get_center( n_p, VMesh::Node::index_type(node_list[i]) );
+      tri_mesh->find_closest_elem(dist, new_result, face_id, n_p );
+      clipped->set_point( new_result, VMesh::Node::index_type(num_kept + i) );
+      if (task == 0) { cnt++; if (cnt == 100) { cnt = 0; algo->update_progress_max(i, num_sheet); } }
     }
-  }
+  });
 
   // For each quad on the clipped boundary we have a map to the new
   // projected nodes so, create the new sheet of hexes from each quad
   // on the clipped boundary
-  std::vector<VMesh::Elem::index_type> new_elems;
-  for(size_t i = 0; i < face_list.size(); i++ )
+  const int numFaceTasks = Parallel::NumTasks(num_faces);
+  Parallel::RunRange(num_faces, numFaceTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
   {
-    VMesh::Node::array_type nodes;
-    clipped->get_nodes( nodes, face_list[i] );
-
     VMesh::Node::array_type nnodes(8);
-    nnodes[0] = nodes[3];
-    nnodes[1] = nodes[2];
-    nnodes[2] = nodes[1];
-    nnodes[3] = nodes[0];
-    nnodes[4] = new_map[nodes[3]];
-    nnodes[5] = new_map[nodes[2]];
-    nnodes[6] = new_map[nodes[1]];
-    nnodes[7] = new_map[nodes[0]];
-
-    new_elems.push_back( clipped->add_elem( nnodes ) );
-  }
+    for (VMesh::index_type i = begin; i < end; i++)
+    {
+      const VMesh::index_type* nodes = &face_list[4*i];
+      for (int k = 0; k < 4; k++)
+      {
+        nnodes[k] = nodes[3-k];
+        nnodes[4+k] = num_kept + new_map[nodes[3-k]];
+      }
+      clipped->set_nodes( nnodes, VMesh::Elem::index_type(num_celems + i) );
+    }
+  });
 
   // Force all the synch data to be rebuilt on next synch call.
   clipped->clear_synchronization();
@@ -1214,105 +836,71 @@ bool ClipMeshByIsovalueAlgoHex::run(const AlgorithmBase* algo, FieldHandle input
   ofield->resize_values();
   CopyProperties(*input, *output);
 
-  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  const size_type nrows = nodemap.size() + node_list.size();
-  // Create the interpolation matrix for downstream use.
-  hash_type::iterator hitr = nodemap.begin();
-  const size_type ncols = field->num_values();
-  const size_type nnz = nrows+7*node_list.size();
-  SparseRowMatrix::Data sparseData(nrows+1, nnz);
-  const SparseRowMatrix::Rows& rr = sparseData.rows();
-  const SparseRowMatrix::Columns& cc = sparseData.columns();
-  const SparseRowMatrix::Storage& d = sparseData.data();
-
-  // Nodes in the original mesh will have the same field values as
-  // before since we didn't move any of them.
-  while( hitr != nodemap.end() )
+  // Nodes in the original mesh keep their values since we didn't move any
+  // of them; the projected nodes lie on the isosurface.
+  Parallel::RunRange(num_kept, Parallel::NumTasks(num_kept), [&](int, VMesh::index_type begin, VMesh::index_type end)
   {
-    ofield->copy_value(field,((*hitr).first), ((*hitr).second));
-    cc[(*hitr).second] = (*hitr).first;
-    ++hitr;
-  }
-
-  // Nodes in the original mesh have a one-to-one correspondence in
-  // the interp matrix.
-  size_t i;
-  for( i = 0; i < nodemap.size(); i++ )
+    for (VMesh::index_type idx = begin; idx < end; idx++)
+      ofield->copy_value(field, clipped_to_original_nodemap[idx], idx);
+  });
+  Parallel::RunRange(num_sheet, Parallel::NumTasks(num_sheet), [&](int, VMesh::index_type begin, VMesh::index_type end)
   {
-    rr[i] = i;
-    d[i] = 1.0;
-  }
-
-  // Figure out the correspondence for the new nodes with the original mesh.
-  index_type counter = i;
-  index_type rrvalue = i;
+    for (VMesh::index_type idx = begin; idx < end; idx++)
+      ofield->set_value(isoval, num_kept + idx);
+  });
 
-  mesh->synchronize(Mesh::LOCATE_E);
-  for( size_t j = 0; j < node_list.size(); j++ )
+  if (mapping)
   {
-    rr[counter+j] = rrvalue;
-
-    VMesh::Node::index_type ni = new_map[node_list[j]];
-
-    Point p;
-    clipped->get_center(p, ni);
-
-    // Find the cell in the old mesh which the new node is located in and
-    // interpolate values between the nodes in this cell for the new values.
-    VMesh::Elem::index_type el;
-    if( mesh->locate( el, p ) )
+    // Create the interpolation matrix for downstream use. Nodes in the
+    // original mesh have a one-to-one correspondence; the projected nodes
+    // interpolate the cell of the original mesh they are located in, or
+    // take the nearest node when they fall outside of it.
+    const int numWeights = 8;
+    std::vector<VMesh::index_type> columns(num_sheet * numWeights, -1);
+    std::vector<double> weights(num_sheet * numWeights, 0.0);
+
+    mesh->synchronize(Mesh::LOCATE_E);
+    Parallel::RunRange(num_sheet, numSheetTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
     {
       VMesh::ElemInterpolate ei;
-      mesh->get_interpolate_weights(p, ei, 1);
-
-      std::vector<std::pair<VField::index_type, double> > snodes(8);
-      for (int k = 0; k < 8; k++)
-      {
-        snodes[k].first =  ei.node_index[k];
-        snodes[k].second = ei.weights[k];
-      }
-      std::sort(snodes.begin(), snodes.end(), ud_pair_less);
-      double val;
-      double actual_val = 0;
-      for( int k = 0; k < 8; k++ )
+      ei.elem_index = -1;
+      Point p;
+      for (VMesh::index_type j = begin; j < end; j++)
       {
-        field->get_value( val, snodes[k].first );
-        actual_val += snodes[k].first * val;
-        cc[rrvalue+k] = snodes[k].first;
-        d[rrvalue+k] = snodes[k].second;
+        clipped->get_center(p, VMesh::Node::index_type(num_kept + j));
+        mesh->get_interpolate_weights(p, ei, 1);
+        if (ei.elem_index >= 0)
+        {
+          for (size_t k = 0; k < ei.node_index.size() && k < static_cast<size_t>(numWeights); k++)
+          {
+            columns[j*numWeights + k] = ei.node_index[k];
+            weights[j*numWeights + k] = ei.weights[k];
+          }
+        }
+        else
+        {
+          VMesh::Node::index_type oi;
+          mesh->locate( oi, p );
+          columns[j*numWeights] = oi;
+          weights[j*numWeights] = 1.0;
+          ei.elem_index = -1;
+        }
       }
-      ofield->set_value( actual_val, ni );
-    }
-    else
-    {
-      // Just find nearest node in the mesh.
-      VMesh::Node::index_type oi;
-      mesh->locate( oi, p );
-      cc[rrvalue] = oi;
-      d[rrvalue] = 1.0;
-      cc[rrvalue+1] = 0;
-      d[rrvalue+1] = 0.0;
-      cc[rrvalue+2] = 0;
-      d[rrvalue+2] = 0.0;
-      cc[rrvalue+3] = 0;
-      d[rrvalue+3] = 0.0;
-      cc[rrvalue+4] = 0;
-      d[rrvalue+4] = 0.0;
-      cc[rrvalue+5] = 0;
-      d[rrvalue+5] = 0.0;
-      cc[rrvalue+6] = 0;
-      d[rrvalue+6] = 0.0;
-      cc[rrvalue+7] = 0;
-      d[rrvalue+7] = 0.0;
-    }
-
-    rrvalue += 8;
+    });
+
+    typedef SparseRowMatrix::Triplet T;
+    std::vector<T> tripletList;
+    tripletList.reserve(num_kept + num_sheet * numWeights);
+    for (VMesh::index_type idx = 0; idx < num_kept; idx++)
+      tripletList.push_back(T(idx, clipped_to_original_nodemap[idx], 1.0));
+    for (VMesh::index_type j = 0; j < num_sheet * numWeights; j++)
+      if (columns[j] >= 0)
+        tripletList.push_back(T(num_kept + j / numWeights, columns[j], weights[j]));
+
+    SparseRowMatrixHandle mat(new SparseRowMatrix(num_kept + num_sheet, field->num_values()));
+    mat->setFromTriplets(tripletList.begin(), tripletList.end());
+    *mapping = mat;
   }
-  rr[nrows] = rrvalue; // An extra entry goes on the end of rr.
-
-  // Create the interp matrix.
-  mapping = new SparseRowMatrix( nrows, ncols, sparseData, nrows+7*node_list.size() );
-  #endif
 
   return (true);
 }
@@ -1321,26 +909,16 @@ bool ClipMeshByIsovalueAlgoHex::run(const AlgorithmBase* algo, FieldHandle input
 // Version without building mapping matrix
 bool ClipMeshByIsovalueAlgo::run(FieldHandle input, FieldHandle& output) const
 {
-   // Store old setting
-   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-   bool temp = get_bool("build_mapping");
-   set_bool("build_mapping",false);
-   #endif
-   MatrixHandle dummy;
-   // Run full algorithm
-
-   bool ret = run(input,output,dummy);
-   // Reset old setting
-   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-   set_bool("build_mapping",temp);
-   #endif
-   // Return result
-   return (ret);
-
+  return runImpl(input, output, nullptr);
 }
 
 // Version with building mapping matrix
 bool ClipMeshByIsovalueAlgo::run(FieldHandle input, FieldHandle& output, MatrixHandle& mapping) const
+{
+  return runImpl(input, output, &mapping);
+}
+
+bool ClipMeshByIsovalueAlgo::runImpl(FieldHandle input, FieldHandle& output, MatrixHandle* mapping) const
 {
   // Mark that we are starting the algorithm, but do not report progress
   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
@@ -1407,9 +985,12 @@ bool ClipMeshByIsovalueAlgo::run(FieldHandle input, FieldHandle& output, MatrixH
     return (false);
   }
 
+  const double isoval = get(ScalarIsoValue).toDouble();
+  const bool lte = !get(LessThanIsoValue).toBool();
+
   if (fi.is_tet_element())
   {
-    ClipMeshByIsovalueAlgoTet algo;
+    ClipMeshByIsovalueAlgoTet algo(input->vmesh(), input->vfield(), isoval, lte);
     if(!( algo.run(this,input,output,mapping)))
     {
       return (false);
@@ -1417,7 +998,7 @@ bool ClipMeshByIsovalueAlgo::run(FieldHandle input, FieldHandle& output, MatrixH
   }
   else if (fi.is_tri_element())
   {
-    ClipMeshByIsovalueAlgoTri algo;
+    ClipMeshByIsovalueAlgoTri algo(input->vmesh(), input->vfield(), isoval, lte);
     if(!( algo.run(this,input,output,mapping)))
     {
       return (false);
@@ -64,6 +64,10 @@ class SCISHARE ClipMeshByIsovalueAlgo : public AlgorithmBase
     static AlgorithmOutputName OutputField;
     static AlgorithmParameterName LessThanIsoValue;
     static AlgorithmParameterName ScalarIsoValue;
+
+  private:
+    /// Builds the interpolant matrix from input to output nodes only when mapping is given.
+    bool runImpl(FieldHandle input, FieldHandle& output, Datatypes::MatrixHandle* mapping) const;
 };
 
 }}}} // end namespace SCIRunAlgo
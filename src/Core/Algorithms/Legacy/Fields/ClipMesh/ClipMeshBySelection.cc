@@ -27,6 +27,8 @@
 
 
 #include <Core/Algorithms/Legacy/Fields/ClipMesh/ClipMeshBySelection.h>
+#include <Core/Algorithms/Legacy/Fields/MeshData/FlaggedNodes.h>
+#include <Core/Thread/Parallel.h>
 
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
@@ -36,12 +38,11 @@
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
-#include <Core/Datatypes/SparseRowMatrixFromMap.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Logging/Log.h>
 
 #include <algorithm>
-#include <set>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -140,7 +141,13 @@ ClipMeshBySelectionAlgo::runImpl(FieldHandle input,
   // 0, so force it to run through the element method.
   if (imesh->is_pointcloudmesh()) method = "Element Center";
 
-  if (method == "Element Center")
+  const bool elementCenter = (method == "Element Center");
+  int target = 1;
+  if (method == "One Node") target = 1;
+  else if (method == "Most Nodes") target = omesh->num_nodes_per_elem()/2;
+  else if (method == "All Nodes") target = omesh->num_nodes_per_elem();
+
+  if (elementCenter)
   {
     LOG_DEBUG("Num Elems {}; Num Tets {}", imesh->num_elems(), sfield->num_values());
 
@@ -149,117 +156,9 @@ ClipMeshBySelectionAlgo::runImpl(FieldHandle input,
       error("Number of elements in input mesh does not match number of values in selection mesh.");
       return (false);
     }
-
-    std::vector<index_type> node_mapping(imesh->num_nodes(),-1);
-    std::vector<index_type> elem_mapping(imesh->num_elems(),-1);
-    std::vector<index_type> node_mapping2(imesh->num_nodes(),-1);
-    std::vector<index_type> elem_mapping2(imesh->num_elems(),-1);
-
-    VMesh::Node::array_type nodes;
-    VMesh::points_type points;
-
-    int cnt = 0;
-
-    for (VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
-    {
-      char val;
-      sfield->get_value(val,idx);
-      if (val)
-      {
-        imesh->get_nodes(nodes,idx);
-        imesh->get_centers(points,nodes);
-
-        for (size_t j=0; j<nodes.size();j++)
-        {
-          if (node_mapping[nodes[j]] < 0)
-          {
-            node_mapping[nodes[j]] = omesh->add_node(points[j]);
-            node_mapping2[node_mapping[nodes[j]]] = nodes[j];
-          }
-          nodes[j] = node_mapping[nodes[j]];
-        }
-
-        elem_mapping[idx] = omesh->add_elem(nodes);
-        elem_mapping2[elem_mapping[idx]] = idx;
-      }
-      cnt++; if (cnt == 100) { cnt=0; update_progress_max(idx,num_elems);}
-    }
-
-    ofield->resize_values();
-    VMesh::size_type num_oelems = omesh->num_elems();
-    VMesh::size_type num_onodes = omesh->num_nodes();
-
-    if (ofield->basis_order() == 0)
-    {
-      for(VMesh::Elem::index_type idx=0; idx<num_oelems; idx++)
-      {
-        ofield->copy_value(ifield,elem_mapping2[idx],idx);
-      }
-    }
-    else if (ofield->basis_order() == 1)
-    {
-      for(VMesh::Node::index_type idx=0; idx<num_onodes; idx++)
-      {
-        ofield->copy_value(ifield,node_mapping2[idx],idx);
-      }
-    }
-
-    bool build_mapping = get(Parameters::BuildMapping).toBool();
-    if (build_mapping)
-    {
-      size_type m,n;
-
-      if (ofield->basis_order() == 0)
-      {
-        if (num_elems > 0 && num_oelems > 0)
-        {
-          SparseRowMatrixFromMap::Values map;
-
-          n =   num_elems;
-          m =   num_oelems;
-
-          for (index_type idx=0;idx<m;idx++)
-          {
-            map[idx][elem_mapping2[idx]] = 1.0;
-          }
-
-          mapping = SparseRowMatrixFromMap::make(m, n, map);
-        }
-      }
-      else if (ofield->basis_order() == 1)
-      {
-        if (num_nodes > 0 && num_onodes >0)
-        {
-          SparseRowMatrixFromMap::Values map;
-
-          n =   num_nodes;
-          m =   num_onodes;
-
-          for (index_type idx=0;idx<m;idx++)
-          {
-            map[idx][node_mapping2[idx]] = 1.0;
-          }
-
-          mapping = SparseRowMatrixFromMap::make(m, n, map);
-        }
-      }
-      // provide an empty matrix
-      if (!mapping)
-        mapping.reset(new DenseMatrix(0,0));
-    }
   }
   else
   {
-    int target = 1;
-    if (method == "One Node") target = 1;
-    else if (method == "Most Nodes") target = omesh->num_nodes_per_elem()/2;
-    else if (method == "All Nodes") target = omesh->num_nodes_per_elem();
-
-    std::vector<index_type> node_mapping(imesh->num_nodes(),-1);
-    std::vector<index_type> elem_mapping(imesh->num_elems(),-1);
-    std::vector<index_type> node_mapping2(imesh->num_nodes(),-1);
-    std::vector<index_type> elem_mapping2(imesh->num_elems(),-1);
-
     LOG_DEBUG("Num Nodes {}; Num Tets {}", imesh->num_nodes(), sfield->num_values());
 
     if (imesh->num_nodes() != sfield->num_values())
@@ -267,102 +166,132 @@ ClipMeshBySelectionAlgo::runImpl(FieldHandle input,
       error("Number of nodes in input mesh does not match number of values in selection mesh.");
       return (false);
     }
+  }
+
+  // Select the elements in parallel and flag the nodes they use. Kept nodes
+  // and elements are numbered in input order, so every element can be written
+  // straight into its slot of the output mesh.
+  const int numTasks = Parallel::NumTasks(num_elems);
+  std::vector<char> selected(num_elems, 0);
+  FlaggedNodes::Flags used(num_nodes);
+  std::vector<VMesh::size_type> elemOffsets(numTasks + 1, 0);
 
+  Parallel::RunRange(num_elems, numTasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
+  {
     VMesh::Node::array_type nodes;
-    VMesh::points_type points;
     std::vector<char> values;
-
+    VMesh::size_type count = 0;
     int cnt = 0;
-
-    for(VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
+    for (VMesh::Elem::index_type idx = begin; idx < end; idx++)
     {
       imesh->get_nodes(nodes,idx);
-      sfield->get_values(values,nodes);
-      int ctarget = 0;
-      for (size_t j=0; j<values.size(); j++) if (values[j]) ctarget++;
+      bool keep;
+      if (elementCenter)
+      {
+        char val;
+        sfield->get_value(val,idx);
+        keep = (val != 0);
+      }
+      else
+      {
+        sfield->get_values(values,nodes);
+        int ctarget = 0;
+        for (size_t j=0; j<values.size(); j++) if (values[j]) ctarget++;
+        keep = (ctarget >= target);
+      }
 
-      if (ctarget >= target)
+      if (keep)
       {
-        imesh->get_centers(points,nodes);
+        selected[idx] = 1;
+        count++;
         for (size_t j=0; j<nodes.size();j++)
-        {
-          if (node_mapping[nodes[j]] < 0)
-          {
-            node_mapping[nodes[j]] = omesh->add_node(points[j]);
-            // reverse mapping
-            node_mapping2[node_mapping[nodes[j]]] = nodes[j];
-          }
-          nodes[j] = node_mapping[nodes[j]];
-        }
-
-        elem_mapping[idx] = omesh->add_elem(nodes);
-        elem_mapping2[elem_mapping[idx]] = idx;
+          used[nodes[j]].store(1, std::memory_order_relaxed);
       }
-
-      cnt++; if (cnt == 100) { cnt=0; update_progress_max(idx,num_elems);}
+      if (task == 0) { cnt++; if (cnt == 100) { cnt=0; update_progress_max(idx,end);} }
     }
+    elemOffsets[task + 1] = count;
+  });
+
+  for (int task = 0; task < numTasks; task++)
+    elemOffsets[task + 1] += elemOffsets[task];
+
+  std::vector<index_type> node_mapping, node_mapping2;
+  const VMesh::size_type num_onodes = FlaggedNodes::number(used, node_mapping, node_mapping2);
+  const VMesh::size_type num_oelems = elemOffsets[numTasks];
+  std::vector<index_type> elem_mapping2(num_oelems);
 
-    ofield->resize_values();
-    VMesh::size_type num_oelems = omesh->num_elems();
-    VMesh::size_type num_onodes = omesh->num_nodes();
+  // Point clouds have no connectivity: their elements are the nodes.
+  const bool pointcloud = omesh->is_pointcloudmesh();
+  omesh->resize_nodes(num_onodes);
+  if (!pointcloud) omesh->resize_elems(num_oelems);
 
-    if (ofield->basis_order() == 0)
+  Parallel::RunRange(num_elems, numTasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
+  {
+    VMesh::Node::array_type nodes;
+    index_type oidx = elemOffsets[task];
+    for (VMesh::Elem::index_type idx = begin; idx < end; idx++)
     {
-      for(VMesh::Elem::index_type idx=0; idx<num_oelems; idx++)
+      if (!selected[idx]) continue;
+      elem_mapping2[oidx] = idx;
+      if (!pointcloud)
       {
-        ofield->copy_value(ifield,elem_mapping2[idx],idx);
+        imesh->get_nodes(nodes,idx);
+        for (size_t j=0; j<nodes.size();j++) nodes[j] = node_mapping[nodes[j]];
+        omesh->set_nodes(nodes, VMesh::Elem::index_type(oidx));
       }
+      oidx++;
     }
-    else if (ofield->basis_order() == 1)
+  });
+
+  ofield->resize_values();
+  const int basis_order = ofield->basis_order();
+  Parallel::RunRange(num_onodes, Parallel::NumTasks(num_onodes), [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    Point p;
+    for (index_type idx = begin; idx < end; idx++)
     {
-      for(VMesh::Node::index_type idx=0; idx<num_onodes; idx++)
-      {
-        ofield->copy_value(ifield,node_mapping2[idx],idx);
-      }
+      imesh->get_center(p, VMesh::Node::index_type(node_mapping2[idx]));
+      omesh->set_point(p, VMesh::Node::index_type(idx));
+      if (basis_order == 1) ofield->copy_value(ifield,node_mapping2[idx],idx);
     }
-
-    bool build_mapping = get(Parameters::BuildMapping).toBool();
-    if (build_mapping)
+  });
+  if (basis_order == 0)
+  {
+    Parallel::RunRange(num_oelems, Parallel::NumTasks(num_oelems), [&](int, VMesh::index_type begin, VMesh::index_type end)
     {
-      size_type m,n;
-
-      if (ofield->basis_order() == 0)
-      {
-        if (num_elems > 0 && num_oelems > 0)
-        {
-          SparseRowMatrixFromMap::Values map;
-
-          n =   num_elems;
-          m =   num_oelems;
-
-          for (index_type idx=0;idx<m;idx++)
-          {
-            map[idx][elem_mapping2[idx]] = 1.0;
-          }
-
-          mapping = SparseRowMatrixFromMap::make(m, n, map);
-        }
-      }
-      else if (ofield->basis_order() == 1)
-      {
-        if (num_nodes > 0 && num_onodes > 0)
-        {
-          SparseRowMatrixFromMap::Values map;
-
-          n =   num_nodes;
-          m =   num_onodes;
+      for (index_type idx = begin; idx < end; idx++)
+        ofield->copy_value(ifield,elem_mapping2[idx],idx);
+    });
+  }
 
-          for (index_type idx=0;idx<m;idx++)
-          {
-            map[idx][node_mapping2[idx]] = 1.0;
-          }
+  bool build_mapping = get(Parameters::BuildMapping).toBool();
+  if (build_mapping)
+  {
+    const std::vector<index_type>* map = nullptr;
+    size_type m = 0, n = 0;
+    if (basis_order == 0 && num_elems > 0 && num_oelems > 0)
+    {
+      map = &elem_mapping2; m = num_oelems; n = num_elems;
+    }
+    else if (basis_order == 1 && num_nodes > 0 && num_onodes > 0)
+    {
+      map = &node_mapping2; m = num_onodes; n = num_nodes;
+    }
 
-          mapping = SparseRowMatrixFromMap::make(m, n, map);
-        }
-      }
-      // provide an empty matrix
-      if (!mapping) mapping.reset(new DenseMatrix(0,0));
+    if (map)
+    {
+      typedef SparseRowMatrix::Triplet T;
+      std::vector<T> tripletList;
+      tripletList.reserve(m);
+      for (index_type idx=0;idx<m;idx++)
+        tripletList.push_back(T(idx, (*map)[idx], 1.0));
+      SparseRowMatrixHandle mat(new SparseRowMatrix(m, n));
+      mat->setFromTriplets(tripletList.begin(), tripletList.end());
+      mapping = mat;
     }
+    // provide an empty matrix
+    else
+      mapping.reset(new DenseMatrix(0,0));
   }
 
   /// Copy properties of the property manager
@@ -55,6 +55,8 @@ CalculateDistanceFieldAlgo::CalculateDistanceFieldAlgo()
   addParameter(Truncate, false);
   addParameter(TruncateDistance, 1.0);
   addParameter(OutputValueField, false);
+  addParameter(UseFastSweeping, false);
+  addParameter(NarrowBandWidth, 2.0);
   addOption(BasisType, "same as input","same as input|constant|linear");
   addOption(OutputFieldDatatype, "double","char|unsigned char|short|unsigned short|int|unsigned int|float|double");
 }
@@ -404,6 +406,31 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
     return (false);
   }
 
+  if (get(Parameters::UseFastSweeping).toBool())
+  {
+    const int basis = ofield->basis_order();
+    const double max = get(Parameters::Truncate).toBool() ? get(Parameters::TruncateDistance).toDouble() : DBL_MAX;
+    auto exact = [imesh, objmesh, basis, max](VMesh::index_type idx)
+    {
+      Point p, p2;
+      VMesh::Elem::index_type fidx;
+      double val = 0.0;
+      if (basis == 0)
+        imesh->get_center(p, VMesh::Elem::index_type(idx));
+      else
+        imesh->get_center(p, VMesh::Node::index_type(idx));
+      if (!(objmesh->find_closest_elem(val,p2,fidx,p,max))) val = max;
+      return val;
+    };
+
+    std::vector<double> values;
+    if (FastSweepingDistance::computeOnGrid(this, imesh, basis, objmesh, exact, false, max, values))
+    {
+      ofield->set_values(values);
+      return (true);
+    }
+  }
+
   detail::CalculateDistanceFieldP palgo(imesh,objmesh,ofield,this);
   auto task_i = [&palgo](int i) { palgo.parallel(i, Parallel::NumCores()); };
   Parallel::RunTasks(task_i, Parallel::NumCores());
@@ -489,6 +516,9 @@ CalculateDistanceFieldAlgo::runImpl(FieldHandle input, FieldHandle object, Field
     return (false);
   }
 
+  if (get(Parameters::UseFastSweeping).toBool())
+    warning("Fast sweeping does not compute closest values, computing every distance exactly.");
+
   detail::CalculateDistanceFieldP palgo(imesh,objmesh,objfield,dfield,vfield,this);
   auto task_i = [&palgo](int i) { palgo.parallel2(i, Parallel::NumCores()); };
   Parallel::RunTasks(task_i, Parallel::NumCores());
@@ -42,6 +42,87 @@ using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
 
+namespace
+{
+  /// Distance from p to the closest element of the surface objmesh, negative on the side the
+  /// element normals point away from.
+  double signedDistance(VMesh* objmesh, const Point& p, double epsilon)
+  {
+    VMesh::Elem::index_type fidx, fidx_n;
+    VMesh::Node::array_type nodes;
+    VMesh::DElem::array_type delems;
+    Vector n, k;
+    Point n0,n1,n2;
+    Point p1, p2;
+    double val = 0.0;
+
+    objmesh->find_closest_elem(val,p2,fidx,p);
+    objmesh->get_nodes(nodes,fidx);
+    objmesh->get_center(n0,nodes[0]);
+    objmesh->get_center(n1,nodes[1]);
+    objmesh->get_center(n2,nodes[2]);
+
+    n = Cross(Vector(n1-n0),Vector(n2-n1));
+    k = Vector(p-p2); k.normalize();
+
+    double angle = Dot(n,k);
+    if (angle < -epsilon)
+    {
+      val = -val;
+    }
+    else if (angle > epsilon)
+    {
+    }
+    else
+    {
+      // trouble
+      if (val != 0.0)
+      {
+         objmesh->get_delems(delems,fidx);
+         double mindist = DBL_MAX;
+         double dist;
+         int edgeidx = 0;
+         for (size_t r=0; r<delems.size();r++)
+         {
+           objmesh->get_nodes(nodes,delems[r]);
+           objmesh->get_center(p1,nodes[0]);
+           objmesh->get_center(p2,nodes[1]);
+
+          if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
+          {
+            Vector v = Vector(p-p2);
+            dist  = Dot(v,v);
+          }
+          else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
+          {
+            Vector v = Vector(p-p1);
+            dist = Dot(v,v);
+          }
+          else
+          {
+            Vector v1 = Vector(p1-p2);
+            Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
+            dist = Dot(v,v);
+          }
+
+          if (dist < mindist) { mindist = dist; edgeidx = r;}
+        }
+        objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
+        objmesh->get_nodes(nodes,fidx);
+        objmesh->get_center(n0,nodes[0]);
+        objmesh->get_center(n1,nodes[1]);
+        objmesh->get_center(n2,nodes[2]);
+        n = Cross(Vector(n1-n0),Vector(n2-n1));
+        k = Vector(p-p2);
+        k.normalize();
+        angle = Dot(n,k);
+        if (angle < 0) val = -(val);
+      }
+    }
+    return val;
+  }
+}
+
 class CalculateSignedDistanceFieldP : public Interruptible
 {
   public:
@@ -57,259 +138,45 @@ class CalculateSignedDistanceFieldP : public Interruptible
       VMesh::size_type num_values = ofield->num_values();
       VMesh::size_type num_evalues = ofield->num_evalues();
 
-      double val = 0.0;
       double epsilon = objmesh->get_epsilon();
       int cnt = 0;
 
       if (ofield->basis_order() == 0)
       {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-        Vector n, k;
-        Point n0,n1,n2;
         VMesh::index_type start, end;
         range(proc,nproc,start,end,num_values);
 
         for (VMesh::Elem::index_type idx = start; idx < end; idx++)
         {
-
-          Point p, p1, p2;
+          Point p;
           imesh->get_center(p,idx);
-
-          objmesh->find_closest_elem(val,p2,fidx,p);
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2); k.normalize();
-
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0) val = -(val);
-            }
-          }
-
-          ofield->set_value(val,idx);
+          ofield->set_value(signedDistance(objmesh,p,epsilon),idx);
           if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
         }
       }
       else if (ofield->basis_order() == 1)
       {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-
-        Vector n, k;
-        Point n0,n1,n2;
         VMesh::index_type start, end;
         range(proc,nproc,start,end,num_values);
 
         for (VMesh::Node::index_type idx =start; idx <end; idx++)
         {
-
-          Point p, p1, p2;
+          Point p;
           imesh->get_center(p,idx);
-          objmesh->find_closest_elem(val,p2,fidx,p);
-
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2);
-          k.normalize();
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0.0) val = -(val);
-            }
-          }
-
-          ofield->set_value(val,idx);
+          ofield->set_value(signedDistance(objmesh,p,epsilon),idx);
           if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
         }
       }
       else if (ofield->basis_order() > 1)
       {
-        VMesh::Elem::index_type fidx, fidx_n;
-        VMesh::Node::array_type nodes;
-        VMesh::DElem::array_type delems;
-
-        Vector n, k;
-        Point n0,n1,n2;
         VMesh::index_type start, end;
         range(proc,nproc,start,end,num_evalues);
 
         for (VMesh::ENode::index_type idx=start; idx < end; idx++)
         {
-
-          Point p, p1, p2;
+          Point p;
           imesh->get_center(p,idx);
-          objmesh->find_closest_elem(val,p2,fidx,p);
-
-          objmesh->get_nodes(nodes,fidx);
-          objmesh->get_center(n0,nodes[0]);
-          objmesh->get_center(n1,nodes[1]);
-          objmesh->get_center(n2,nodes[2]);
-          n = Cross(Vector(n1-n0),Vector(n2-n1));
-          k = Vector(p-p2);
-          k.normalize();
-          double angle = Dot(n,k);
-          if (angle < -epsilon)
-          {
-            val = -val;
-          }
-          else if (angle > epsilon)
-          {
-          }
-          else
-          {
-            // trouble
-            if (val != 0.0)
-            {
-               objmesh->get_delems(delems,fidx);
-               double mindist = DBL_MAX;
-               double dist;
-               int edgeidx = 0;
-               for (size_t r=0; r<delems.size();r++)
-               {
-                 objmesh->get_nodes(nodes,delems[r]);
-                 objmesh->get_center(p1,nodes[0]);
-                 objmesh->get_center(p2,nodes[1]);
-
-                if (Dot(Vector(p-p2),Vector(p2-p1)) >= 0.0)
-                {
-                  Vector v = Vector(p-p2);
-                  dist  = Dot(v,v);
-                }
-                else if (Dot(Vector(p-p1),Vector(p1-p2)) >= 0.0)
-                {
-                  Vector v = Vector(p-p1);
-                  dist = Dot(v,v);
-                }
-                else
-                {
-                  Vector v1 = Vector(p1-p2);
-                  Vector v = Vector(p-p2)-v1*(Dot(Vector(p-p2),v1)/Dot(v1,v1));
-                  dist = Dot(v,v);
-                }
-
-                if (dist < mindist) { mindist = dist; edgeidx = r;}
-              }
-              objmesh->get_neighbor(fidx_n,fidx,delems[edgeidx]);
-              objmesh->get_nodes(nodes,fidx);
-              objmesh->get_center(n0,nodes[0]);
-              objmesh->get_center(n1,nodes[1]);
-              objmesh->get_center(n2,nodes[2]);
-              n = Cross(Vector(n1-n0),Vector(n2-n1));
-              k = Vector(p-p2);
-              k.normalize();
-              angle = Dot(n,k);
-              if (angle < 0.0) val = -(val);
-            }
-          }
-
-          ofield->set_evalue(val,idx);
+          ofield->set_evalue(signedDistance(objmesh,p,epsilon),idx);
           if (proc == 0) { cnt++; if (cnt == 100) { pr_->update_progress_max(idx,end); cnt = 0; } }
         }
       }
@@ -661,6 +528,8 @@ class CalculateSignedDistanceFieldP : public Interruptible
 CalculateSignedDistanceFieldAlgo::CalculateSignedDistanceFieldAlgo()
 {
   addParameter(OutputValueField, false);
+  addParameter(Parameters::UseFastSweeping, false);
+  addParameter(Parameters::NarrowBandWidth, 2.0);
 }
 
 bool
@@ -719,6 +588,29 @@ CalculateSignedDistanceFieldAlgo::run(FieldHandle input, FieldHandle object, Fie
   }
 
   objmesh->synchronize(Mesh::FIND_CLOSEST_ELEM_E|Mesh::EDGES_E);
+
+  if (get(Parameters::UseFastSweeping).toBool())
+  {
+    const int basis = ofield->basis_order();
+    const double epsilon = objmesh->get_epsilon();
+    auto exact = [imesh, objmesh, epsilon, basis](VMesh::index_type idx)
+    {
+      Point p;
+      if (basis == 0)
+        imesh->get_center(p, VMesh::Elem::index_type(idx));
+      else
+        imesh->get_center(p, VMesh::Node::index_type(idx));
+      return signedDistance(objmesh, p, epsilon);
+    };
+
+    std::vector<double> values;
+    if (FastSweepingDistance::computeOnGrid(this, imesh, basis, objmesh, exact, true, DBL_MAX, values))
+    {
+      ofield->set_values(values);
+      return (true);
+    }
+  }
+
   CalculateSignedDistanceFieldP palgo(imesh, objmesh, ofield, this);
   const int numThreads = Parallel::NumCores();
   auto task_i = [&palgo,numThreads](int i) { palgo.parallel(i, numThreads); };
@@ -808,6 +700,9 @@ CalculateSignedDistanceFieldAlgo::run(FieldHandle input, FieldHandle object, Fie
     return (false);
   }
 
+  if (get(Parameters::UseFastSweeping).toBool())
+    warning("Fast sweeping does not compute closest values, computing every distance exactly.");
+
   CalculateSignedDistanceFieldP palgo(imesh, objmesh, objfield, dfield, vfield, this);
 
   auto task_i = [&palgo](int i) { palgo.parallel2(i, Parallel::NumCores()); };
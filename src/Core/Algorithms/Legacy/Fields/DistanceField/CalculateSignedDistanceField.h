@@ -30,6 +30,7 @@
 #define CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_CALCULATESIGNEDDISTANCEFIELD_H 1
 
 #include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Algorithms/Legacy/Fields/DistanceField/FastSweepingDistance.h>
 #include <Core/Thread/Interruptible.h>
 #include <Core/Algorithms/Legacy/Fields/share.h>
 
@@ -0,0 +1,465 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Legacy/Fields/DistanceField/FastSweepingDistance.h>
+#include <Core/Thread/Barrier.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+ALGORITHM_PARAMETER_DEF(Fields, UseFastSweeping);
+ALGORITHM_PARAMETER_DEF(Fields, NarrowBandWidth);
+
+const int FastSweepingDistance::MaxErrorSamples = 512;
+
+namespace
+{
+  const int maxSweepRounds = 64;
+  const size_t linesPerTask = 64;
+  // Exact distances search the object mesh, so a few of them already make a task worthwhile.
+  const size_t exactPerTask = 16;
+  const double infinity = std::numeric_limits<double>::infinity();
+
+  VMesh::index_type flip(VMesh::index_type x, bool reversed, VMesh::size_type n)
+  {
+    return reversed ? n - 1 - x : x;
+  }
+
+  /// Godunov upwind solution of |grad u| = 1 from the smallest neighbor along each axis,
+  /// with w the inverse squared grid steps.
+  double solveEikonal(double a[3], double w[3])
+  {
+    for (int p = 0; p < 2; ++p)
+      for (int q = 0; q < 2 - p; ++q)
+        if (a[q] > a[q + 1])
+        {
+          std::swap(a[q], a[q + 1]);
+          std::swap(w[q], w[q + 1]);
+        }
+
+    if (a[0] == infinity)
+      return infinity;
+
+    double u = a[0] + 1.0 / std::sqrt(w[0]);
+    double sw = 0.0, swa = 0.0, swa2 = 0.0;
+    for (int n = 0; n < 3; ++n)
+    {
+      if (u <= a[n])
+        break;
+      sw += w[n];
+      swa += w[n] * a[n];
+      swa2 += w[n] * a[n] * a[n];
+      if (n > 0)
+        u = (swa + std::sqrt(std::max(0.0, swa * swa - sw * (swa2 - 1.0)))) / sw;
+    }
+    return u;
+  }
+}
+
+bool FastSweepingDistance::regularGrid(VMesh* mesh, int basisOrder, Grid& grid)
+{
+  if (!mesh->is_latvolmesh() || basisOrder < 0 || basisOrder > 1)
+    return false;
+
+  VMesh::dimension_type dims;
+  if (basisOrder == 1)
+    mesh->get_dimensions(dims);
+  else
+    mesh->get_elem_dimensions(dims);
+  if (dims.size() != 3 || dims[0] < 2 || dims[1] < 2 || dims[2] < 2)
+    return false;
+
+  grid.ni = dims[0];
+  grid.nj = dims[1];
+  grid.nk = dims[2];
+
+  auto at = [&](VMesh::index_type i, VMesh::index_type j, VMesh::index_type k)
+  {
+    Point p;
+    const VMesh::index_type idx = i + grid.ni * (j + grid.nj * k);
+    if (basisOrder == 1)
+      mesh->get_center(p, VMesh::Node::index_type(idx));
+    else
+      mesh->get_center(p, VMesh::Elem::index_type(idx));
+    return p;
+  };
+
+  grid.origin = at(0, 0, 0);
+  grid.di = at(1, 0, 0) - grid.origin;
+  grid.dj = at(0, 1, 0) - grid.origin;
+  grid.dk = at(0, 0, 1) - grid.origin;
+
+  const double li = grid.di.length(), lj = grid.dj.length(), lk = grid.dk.length();
+  if (li == 0.0 || lj == 0.0 || lk == 0.0)
+    return false;
+
+  const double angleTolerance = 1e-6;
+  if (std::fabs(Dot(grid.di, grid.dj)) > angleTolerance * li * lj ||
+      std::fabs(Dot(grid.di, grid.dk)) > angleTolerance * li * lk ||
+      std::fabs(Dot(grid.dj, grid.dk)) > angleTolerance * lj * lk)
+    return false;
+
+  // The mesh transform is affine, so agreement at the far corners confirms the index order.
+  const double tolerance = 1e-6 * (li * grid.ni + lj * grid.nj + lk * grid.nk);
+  const VMesh::index_type ei = grid.ni - 1, ej = grid.nj - 1, ek = grid.nk - 1;
+  auto expected = [&grid](VMesh::index_type i, VMesh::index_type j, VMesh::index_type k)
+  {
+    return grid.origin + grid.di * static_cast<double>(i) + grid.dj * static_cast<double>(j) + grid.dk * static_cast<double>(k);
+  };
+  return (at(ei, 0, 0) - expected(ei, 0, 0)).length() <= tolerance &&
+    (at(0, ej, 0) - expected(0, ej, 0)).length() <= tolerance &&
+    (at(0, 0, ek) - expected(0, 0, ek)).length() <= tolerance &&
+    (at(ei, ej, ek) - expected(ei, ej, ek)).length() <= tolerance;
+}
+
+FastSweepingDistance::FastSweepingDistance(const Grid& grid, double bandWidth) : grid_(grid)
+{
+  const double step = std::max(grid.di.length(), std::max(grid.dj.length(), grid.dk.length()));
+  bandWidth_ = std::max(1.0, bandWidth) * step;
+}
+
+std::vector<char> FastSweepingDistance::markBand(VMesh* objmesh) const
+{
+  struct ElemBounds
+  {
+    Point lo, hi;
+    Vector normal;
+    double offset;
+    bool planar;
+  };
+
+  const VMesh::size_type numElems = objmesh->num_elems();
+  std::vector<ElemBounds> bounds(numElems);
+  Parallel::RunRange(numElems, Parallel::NumTasks(numElems), [&](int, size_t begin, size_t end)
+  {
+    VMesh::Node::array_type nodes;
+    Point p[3], q;
+    for (VMesh::index_type e = begin; e < static_cast<VMesh::index_type>(end); ++e)
+    {
+      auto& b = bounds[e];
+      objmesh->get_nodes(nodes, VMesh::Elem::index_type(e));
+      objmesh->get_center(b.lo, nodes[0]);
+      b.hi = b.lo;
+      for (size_t r = 0; r < nodes.size(); ++r)
+      {
+        objmesh->get_center(q, nodes[r]);
+        b.lo = Min(b.lo, q);
+        b.hi = Max(b.hi, q);
+        if (r < 3)
+          p[r] = q;
+      }
+
+      // Triangles also reject grid locations farther than the band from their plane.
+      b.planar = false;
+      if (nodes.size() == 3)
+      {
+        b.normal = Cross(p[1] - p[0], p[2] - p[0]);
+        const double length = b.normal.length();
+        if (length > 0.0)
+        {
+          b.normal /= length;
+          b.offset = Dot(b.normal, Vector(p[0]));
+          b.planar = true;
+        }
+      }
+    }
+  });
+
+  const Vector axes[3] = { grid_.di, grid_.dj, grid_.dk };
+  const VMesh::size_type counts[3] = { grid_.ni, grid_.nj, grid_.nk };
+  const Vector margin(bandWidth_, bandWidth_, bandWidth_);
+
+  // Each task owns a slab of k so marks never race.
+  std::vector<char> band(grid_.size(), 0);
+  Parallel::RunRange(grid_.nk, Parallel::NumTasks(grid_.nk, 1), [&](int, size_t begin, size_t end)
+  {
+    const VMesh::index_type kBegin = begin, kEnd = end;
+    for (const auto& b : bounds)
+    {
+      const Point lo = b.lo - margin, hi = b.hi + margin;
+      VMesh::index_type first[3], last[3];
+      for (int a = 0; a < 3; ++a)
+      {
+        double tmin = infinity, tmax = -infinity;
+        for (int c = 0; c < 8; ++c)
+        {
+          const Point corner((c & 1) ? hi.x() : lo.x(), (c & 2) ? hi.y() : lo.y(), (c & 4) ? hi.z() : lo.z());
+          const double t = Dot(corner - grid_.origin, axes[a]) / axes[a].length2();
+          tmin = std::min(tmin, t);
+          tmax = std::max(tmax, t);
+        }
+        const double top = static_cast<double>(counts[a] - 1);
+        first[a] = static_cast<VMesh::index_type>(std::ceil(std::max(0.0, tmin)));
+        last[a] = static_cast<VMesh::index_type>(std::floor(std::min(top, tmax)));
+      }
+
+      for (VMesh::index_type k = std::max(first[2], kBegin); k <= last[2] && k < kEnd; ++k)
+        for (VMesh::index_type j = first[1]; j <= last[1]; ++j)
+          for (VMesh::index_type i = first[0]; i <= last[0]; ++i)
+          {
+            if (b.planar)
+            {
+              const Point p = grid_.origin + axes[0] * static_cast<double>(i) +
+                axes[1] * static_cast<double>(j) + axes[2] * static_cast<double>(k);
+              if (std::fabs(Dot(b.normal, Vector(p)) - b.offset) > bandWidth_)
+                continue;
+            }
+            band[i + grid_.ni * (j + grid_.nj * k)] = 1;
+          }
+    }
+  });
+
+  return band;
+}
+
+int FastSweepingDistance::sweep(std::vector<double>& distance, const std::vector<char>& band) const
+{
+  const VMesh::size_type ni = grid_.ni, nj = grid_.nj, nk = grid_.nk;
+  const VMesh::size_type strideK = ni * nj;
+  const double weights[3] = { 1.0 / grid_.di.length2(), 1.0 / grid_.dj.length2(), 1.0 / grid_.dk.length2() };
+  const double tolerance = 1e-9 * bandWidth_;
+
+  // Returns how much the value at (i,j,k) decreased.
+  auto update = [&](VMesh::index_type i, VMesh::index_type j, VMesh::index_type k)
+  {
+    const VMesh::index_type idx = i + ni * (j + nj * k);
+    if (band[idx])
+      return 0.0;
+    double a[3] = {
+      std::min(i > 0 ? distance[idx - 1] : infinity, i + 1 < ni ? distance[idx + 1] : infinity),
+      std::min(j > 0 ? distance[idx - ni] : infinity, j + 1 < nj ? distance[idx + ni] : infinity),
+      std::min(k > 0 ? distance[idx - strideK] : infinity, k + 1 < nk ? distance[idx + strideK] : infinity) };
+    double w[3] = { weights[0], weights[1], weights[2] };
+    const double u = solveEikonal(a, w);
+    if (u >= distance[idx])
+      return 0.0;
+    const double change = distance[idx] - u;
+    distance[idx] = u;
+    return change;
+  };
+
+  // An update reads only the six axis neighbors, and sweeping along the diagonal planes
+  // i+j+k = L visits each of them in the same order relative to the node as the nested loops
+  // do, so the parallel sweep reproduces the serial one exactly.
+  const int numThreads = Parallel::NumCores();
+  int rounds = 0;
+  if (numThreads == 1)
+  {
+    for (double change = infinity; change > tolerance && rounds < maxSweepRounds; ++rounds)
+    {
+      change = 0.0;
+      for (int s = 0; s < 8; ++s)
+        for (VMesh::index_type kk = 0; kk < nk; ++kk)
+          for (VMesh::index_type jj = 0; jj < nj; ++jj)
+            for (VMesh::index_type ii = 0; ii < ni; ++ii)
+              change = std::max(change, update(flip(ii, s & 1, ni), flip(jj, s & 2, nj), flip(kk, s & 4, nk)));
+    }
+    return rounds;
+  }
+
+  Barrier barrier("FastSweepingDistance", numThreads);
+  std::vector<double> changes(numThreads, 0.0);
+  const VMesh::index_type lastPlane = (ni - 1) + (nj - 1) + (nk - 1);
+  Parallel::RunTasks([&](int t)
+  {
+    for (int round = 0; round < maxSweepRounds; ++round)
+    {
+      double change = 0.0;
+      for (int s = 0; s < 8; ++s)
+      {
+        for (VMesh::index_type plane = 0; plane <= lastPlane; ++plane)
+        {
+          const VMesh::index_type kFirst = std::max<VMesh::index_type>(0, plane - (ni - 1) - (nj - 1));
+          const VMesh::index_type kLast = std::min<VMesh::index_type>(nk - 1, plane);
+          for (VMesh::index_type kk = kFirst + t; kk <= kLast; kk += numThreads)
+          {
+            const VMesh::index_type rest = plane - kk;
+            const VMesh::index_type jFirst = std::max<VMesh::index_type>(0, rest - (ni - 1));
+            const VMesh::index_type jLast = std::min<VMesh::index_type>(nj - 1, rest);
+            for (VMesh::index_type jj = jFirst; jj <= jLast; ++jj)
+              change = std::max(change, update(flip(rest - jj, s & 1, ni), flip(jj, s & 2, nj), flip(kk, s & 4, nk)));
+          }
+          barrier.wait();
+        }
+      }
+
+      changes[t] = change;
+      barrier.wait();
+      const double maxChange = *std::max_element(changes.begin(), changes.end());
+      if (t == 0)
+        rounds = round + 1;
+      // Every thread reads the changes before any of them is overwritten by the next round.
+      barrier.wait();
+      if (maxChange <= tolerance)
+        break;
+    }
+  }, numThreads);
+  return rounds;
+}
+
+void FastSweepingDistance::fillSigns(std::vector<signed char>& signs) const
+{
+  const VMesh::size_type ni = grid_.ni, nj = grid_.nj, nk = grid_.nk;
+
+  auto fillLine = [&signs](VMesh::index_type start, VMesh::size_type stride, VMesh::size_type n)
+  {
+    VMesh::index_type first = 0;
+    while (first < n && signs[start + first * stride] == 0)
+      ++first;
+    if (first == n)
+      return;
+    signed char current = signs[start + first * stride];
+    for (VMesh::index_type q = 0; q < n; ++q)
+    {
+      auto& s = signs[start + q * stride];
+      if (s == 0)
+        s = current;
+      else
+        current = s;
+    }
+  };
+
+  // Rows along i are filled from their band values; rows that miss the band entirely are
+  // filled from neighboring rows by the passes along j and then k.
+  Parallel::RunRange(nj * nk, Parallel::NumTasks(nj * nk, linesPerTask), [&](int, size_t begin, size_t end)
+  {
+    for (VMesh::index_type line = begin; line < static_cast<VMesh::index_type>(end); ++line)
+      fillLine(line * ni, 1, ni);
+  });
+  Parallel::RunRange(ni * nk, Parallel::NumTasks(ni * nk, linesPerTask), [&](int, size_t begin, size_t end)
+  {
+    for (VMesh::index_type line = begin; line < static_cast<VMesh::index_type>(end); ++line)
+      fillLine(line % ni + (line / ni) * ni * nj, ni, nj);
+  });
+  Parallel::RunRange(ni * nj, Parallel::NumTasks(ni * nj, linesPerTask), [&](int, size_t begin, size_t end)
+  {
+    for (VMesh::index_type line = begin; line < static_cast<VMesh::index_type>(end); ++line)
+      fillLine(line, ni * nj, nk);
+  });
+}
+
+bool FastSweepingDistance::compute(VMesh* objmesh, const ExactDistance& exact, bool isSigned, double maxDistance,
+  std::vector<double>& values, Report& report) const
+{
+  const VMesh::size_type size = grid_.size();
+  const auto band = markBand(objmesh);
+
+  std::vector<VMesh::index_type> bandIndices;
+  for (VMesh::index_type idx = 0; idx < size; ++idx)
+    if (band[idx])
+      bandIndices.push_back(idx);
+  if (bandIndices.empty())
+    return false;
+
+  const VMesh::size_type numBand = bandIndices.size();
+  values.assign(size, 0.0);
+  Parallel::RunRange(numBand, Parallel::NumTasks(numBand, exactPerTask), [&](int, size_t begin, size_t end)
+  {
+    for (size_t n = begin; n < end; ++n)
+      values[bandIndices[n]] = exact(bandIndices[n]);
+  });
+
+  std::vector<double> distance(size, infinity);
+  for (auto idx : bandIndices)
+    distance[idx] = std::fabs(values[idx]);
+  report.bandValues = numBand;
+  report.sweepRounds = sweep(distance, band);
+
+  std::vector<signed char> signs;
+  if (isSigned)
+  {
+    signs.assign(size, 0);
+    for (auto idx : bandIndices)
+      signs[idx] = values[idx] < 0.0 ? -1 : 1;
+    fillSigns(signs);
+  }
+
+  for (VMesh::index_type idx = 0; idx < size; ++idx)
+    if (!band[idx])
+      values[idx] = isSigned && signs[idx] < 0 ? -distance[idx] : std::min(distance[idx], maxDistance);
+
+  // Sample the swept values evenly against exact distances to report the approximation error.
+  const VMesh::size_type numSwept = size - numBand;
+  const VMesh::size_type stride = std::max<VMesh::size_type>(1, numSwept / MaxErrorSamples);
+  std::vector<VMesh::index_type> samples;
+  for (VMesh::index_type idx = 0, n = 0; idx < size && static_cast<int>(samples.size()) < MaxErrorSamples; ++idx)
+    if (!band[idx] && n++ % stride == 0)
+      samples.push_back(idx);
+
+  std::vector<double> errors(samples.size());
+  const VMesh::size_type numSamples = samples.size();
+  Parallel::RunRange(numSamples, Parallel::NumTasks(numSamples, exactPerTask), [&](int, size_t begin, size_t end)
+  {
+    for (size_t n = begin; n < end; ++n)
+      errors[n] = std::fabs(exact(samples[n]) - values[samples[n]]);
+  });
+
+  report.errorSamples = numSamples;
+  report.maxError = errors.empty() ? 0.0 : *std::max_element(errors.begin(), errors.end());
+  double sum = 0.0;
+  for (auto e : errors)
+    sum += e;
+  report.meanError = errors.empty() ? 0.0 : sum / errors.size();
+  return true;
+}
+
+bool FastSweepingDistance::computeOnGrid(const AlgorithmBase* algo, VMesh* imesh, int basisOrder, VMesh* objmesh,
+  const ExactDistance& exact, bool isSigned, double maxDistance, std::vector<double>& values)
+{
+  Grid grid;
+  if (!regularGrid(imesh, basisOrder, grid))
+  {
+    algo->remark("Fast sweeping needs a LatVol input with orthogonal axes and constant or linear data, computing all distances exactly.");
+    return false;
+  }
+
+  FastSweepingDistance sweeper(grid, algo->get(Parameters::NarrowBandWidth).toDouble());
+  Report report;
+  if (!sweeper.compute(objmesh, exact, isSigned, maxDistance, values, report))
+  {
+    algo->remark("Fast sweeping: no values lie within the narrow band of the object, computing all distances exactly.");
+    return false;
+  }
+
+  std::ostringstream oss;
+  oss << "Fast sweeping: " << report.bandValues << " of " << values.size()
+    << " values are exact within the narrow band; outside it the largest sampled error is "
+    << report.maxError << " (mean " << report.meanError << " over " << report.errorSamples
+    << " samples, " << report.sweepRounds << " sweep rounds).";
+  algo->remark(oss.str());
+  return true;
+}
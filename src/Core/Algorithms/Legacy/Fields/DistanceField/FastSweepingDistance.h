@@ -0,0 +1,107 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_FASTSWEEPINGDISTANCE_H
+#define CORE_ALGORITHMS_FIELDS_DISTANCEFIELD_FASTSWEEPINGDISTANCE_H 1
+
+#include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <functional>
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+        ALGORITHM_PARAMETER_DECL(UseFastSweeping);
+        ALGORITHM_PARAMETER_DECL(NarrowBandWidth);
+
+        /// Distance fields on regular grids. Values within a narrow band around the object are
+        /// computed exactly; the rest of the grid solves the eikonal equation from the band by
+        /// fast sweeping, with the sweeps run in parallel over grid diagonals. For signed
+        /// distances the sign outside the band is carried along grid lines from the band, which
+        /// the surface cannot cross.
+        class SCISHARE FastSweepingDistance
+        {
+        public:
+          /// Data locations origin + i*di + j*dj + k*dk with i running fastest.
+          struct Grid
+          {
+            VMesh::size_type ni = 0, nj = 0, nk = 0;
+            Geometry::Point origin;
+            Geometry::Vector di, dj, dk;
+
+            VMesh::size_type size() const { return ni * nj * nk; }
+          };
+
+          struct Report
+          {
+            VMesh::size_type bandValues = 0;
+            int sweepRounds = 0;
+            VMesh::size_type errorSamples = 0;
+            double maxError = 0.0;
+            double meanError = 0.0;
+          };
+
+          /// Exact distance at a data location, by index into the grid.
+          using ExactDistance = std::function<double(VMesh::index_type)>;
+
+          /// True when the nodes (basisOrder 1) or element centers (basisOrder 0) of mesh form an
+          /// orthogonal regular grid.
+          static bool regularGrid(VMesh* mesh, int basisOrder, Grid& grid);
+
+          /// Runs compute when imesh is a regular grid at basisOrder and reports the outcome
+          /// through algo. Returns false when the caller should compute every value exactly.
+          static bool computeOnGrid(const AlgorithmBase* algo, VMesh* imesh, int basisOrder, VMesh* objmesh,
+            const ExactDistance& exact, bool isSigned, double maxDistance, std::vector<double>& values);
+
+          /// bandWidth is measured in units of the largest grid step and is at least one step.
+          FastSweepingDistance(const Grid& grid, double bandWidth);
+
+          /// Fills values for every grid location, with unsigned distances clamped to maxDistance
+          /// to match a truncated exact distance. Returns false, computing nothing, when no
+          /// location lies within the band around objmesh.
+          bool compute(VMesh* objmesh, const ExactDistance& exact, bool isSigned, double maxDistance,
+            std::vector<double>& values, Report& report) const;
+
+          static const int MaxErrorSamples;
+
+        private:
+          std::vector<char> markBand(VMesh* objmesh) const;
+          int sweep(std::vector<double>& distance, const std::vector<char>& band) const;
+          void fillSigns(std::vector<signed char>& signs) const;
+
+          Grid grid_;
+          double bandWidth_;
+        };
+
+      }}}}
+
+#endif
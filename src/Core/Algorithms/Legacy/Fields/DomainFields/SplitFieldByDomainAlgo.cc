@@ -27,12 +27,14 @@
 
 
 #include <Core/Algorithms/Legacy/Fields/DomainFields/SplitFieldByDomainAlgo.h>
+#include <Core/Algorithms/Legacy/Fields/MeshDerivatives/MeshComponents.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <algorithm>
+#include <map>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms::Fields;
@@ -119,31 +121,46 @@ SplitFieldByDomainAlgo::runImpl(FieldHandle input, FieldList& output) const
     return (false);
   }
 
-  VMesh::Elem::iterator bei, eei;
-  VMesh::Node::iterator bni, eni;
-
   VMesh::size_type num_elems = mesh->num_elems();
   VMesh::size_type num_nodes = mesh->num_nodes();
 
-
-  std::vector<VMesh::Node::index_type> idxarray(num_nodes);
-  std::vector<bool> newidxarray(num_nodes);
-  VMesh::Node::array_type nodes;
-  VMesh::Node::array_type newnodes;
-  VMesh::Node::index_type node;
-
   std::vector<int> labels;
   field->get_values(labels);
 
-  int flabel = 0;
-  if (labels.size()) flabel = labels[0];
-  for (size_t j=0; j<labels.size();j++) { if (labels[j] < flabel) flabel = labels[j]; }
+  // Domains are numbered in ascending label order. Labels come in runs, so
+  // only the first element of a run needs a lookup.
+  std::map<int, VMesh::index_type> domains;
+  for (size_t j=0; j<labels.size(); j++)
+  {
+    if (j == 0 || labels[j] != labels[j-1]) domains[labels[j]] = 0;
+  }
+  // An empty field still gives one empty output field
+  if (domains.empty()) domains[0] = 0;
 
-  index_type k = 0;
+  VMesh::index_type numdomains = 0;
+  for (auto& domain : domains) domain.second = numdomains++;
 
-  int cnt = 0;
-  while (true)
+  std::vector<VMesh::index_type> elemdomain(labels.size());
+  VMesh::index_type current = 0;
+  for (size_t j=0; j<labels.size(); j++)
   {
+    if (j == 0 || labels[j] != labels[j-1]) current = domains[labels[j]];
+    elemdomain[j] = current;
+  }
+
+  std::vector<VMesh::index_type> offsets, elems;
+  MeshComponents::groupMembers(elemdomain, numdomains, offsets, elems);
+
+  // Nodes are numbered in the order the elements of a domain first use them;
+  // numbered[node] records the last domain that did.
+  std::vector<VMesh::index_type> idxarray(num_nodes);
+  std::vector<VMesh::index_type> numbered(num_nodes, -1);
+  std::vector<VMesh::index_type> nodes;
+  VMesh::Node::array_type elemnodes;
+
+  for (auto& domain : domains)
+  {
+    const VMesh::index_type d = domain.second;
     FieldHandle output_field = CreateField(fo);
 
     if (!output_field)
@@ -163,58 +180,31 @@ SplitFieldByDomainAlgo::runImpl(FieldHandle input, FieldList& output) const
       return(false);
     }
 
-    for (size_type p =0; p<num_nodes; p++) newidxarray[p] = true;
-
-    for (VMesh::Elem::index_type idx=0; idx< num_elems; idx++)
+    nodes.clear();
+    for (VMesh::index_type q=offsets[d]; q<offsets[d+1]; q++)
     {
-      if (labels[idx] == flabel)
+      mesh->get_nodes(elemnodes,VMesh::Elem::index_type(elems[q]));
+      for (size_t p=0; p<elemnodes.size(); p++)
       {
-        mesh->get_nodes(nodes,idx);
-        newnodes.resize(nodes.size());
-        for (size_t p=0; p< nodes.size(); p++)
+        VMesh::index_type node = elemnodes[p];
+        if (numbered[node] != d)
         {
-          node = nodes[p];
-          if (newidxarray[node])
-          {
-            Point pt;
-            mesh->get_center(pt,nodes[p]);
-            idxarray[node] = omesh->add_point(pt);
-            newidxarray[node] = false;
-          }
-          newnodes[p] = idxarray[node];
+          numbered[node] = d;
+          idxarray[node] = nodes.size();
+          nodes.push_back(node);
         }
-        omesh->add_elem(newnodes);
-        cnt++;
-        if (cnt == 400)
-        {
-          cnt = 0;
-          update_progress_max(k,num_elems);
-        }
-        k++;
       }
     }
 
+    MeshComponents::copyPiece(mesh, nullptr, nodes.data(), nodes.size(),
+      elems.data() + offsets[d], offsets[d+1] - offsets[d], idxarray, omesh, ofield);
+
     ofield->resize_values();
-    ofield->set_all_values(flabel);
+    ofield->set_all_values(domain.first);
     output.push_back(output_field);
-
-    int elabel = 0;
-    bool found = false;
-
-    for (VMesh::index_type lidx = 0; lidx < num_elems; lidx++)
-    {
-      if (labels[lidx] > flabel)
-      {
-        if (!found) { elabel = labels[lidx]; found = true;}
-        if (labels[lidx] < elabel) elabel = labels[lidx];
-      }
-    }
-    // check whether we are done
-    if (!found) break;
-    flabel = elabel;
+    update_progress_max(offsets[d+1],num_elems);
   }
 
-
   if (get(SortBySize).toBool())
   {
     std::vector<double> sizes(output.size());
@@ -27,6 +27,8 @@
 
 
 #include <Core/Algorithms/Legacy/Fields/FieldData/SmoothVecFieldMedianAlgo.h>
+#include <Core/Algorithms/Legacy/Fields/SmoothMesh/MeshSmoother.h>
+#include <Core/Thread/Parallel.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
@@ -34,6 +36,7 @@
 //#include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/Math/MiscMath.h>
+#include <algorithm>
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
@@ -43,6 +46,7 @@ using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Fields;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
 
 bool SmoothVecFieldMedianAlgo::runImpl(FieldHandle input, FieldHandle& output) const
 {
@@ -87,110 +91,103 @@ bool SmoothVecFieldMedianAlgo::runImpl(FieldHandle input, FieldHandle& output) c
 
   if (ifield->is_vector())
   {
-    Vector v0, v1, v2, v3;
-
-    int myloc = 0;
-    bool not_on_list = false;
     auto num_values = ifield->num_values();
 
+    // The element neighbors are looked up once; every element then gathers
+    // three rings of them on its own.
     imesh->synchronize(Mesh::ELEM_NEIGHBORS_E);
+    std::vector<VMesh::index_type> offsets, neighbors;
+    MeshSmoother::elementNeighbors(imesh, offsets, neighbors);
 
-    int cnt = 0;
-
-    for (VMesh::Elem::index_type idx = 0; idx < num_values; idx++)
+    const int tasks = Parallel::NumTasks(num_values);
+    Parallel::RunRange(num_values, tasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
     {
-      //calculate neighborhoods
-      VMesh::Elem::array_type nci, ncitot, Nlist;
-      VMesh::Elem::array_type nci2;
-      imesh->get_neighbors(nci, idx);
-
-      ncitot.push_back(idx);
+      Vector v0, v1, v2;
+      VMesh::Elem::array_type ncitot, Nlist;
+      std::vector<std::pair<VMesh::index_type, size_t> > firstuse;
+      std::vector<double> angles, original;
 
-      for (size_t t = 0; t < nci.size(); t++)
+      int cnt = 0;
+      for (VMesh::Elem::index_type idx = begin; idx < end; idx++)
       {
-        ncitot.push_back(nci[t]);
-        imesh->get_neighbors(nci2, nci[t]);
+        //calculate neighborhoods
+        ncitot.clear();
+        ncitot.push_back(idx);
 
-        for (size_t L = 0; L < nci2.size(); L++)
+        for (auto t = offsets[idx]; t < offsets[idx + 1]; t++)
         {
-          ncitot.push_back(nci2[L]);
-        }
-
-        for (size_t t2 = 0; t2 < nci2.size(); t2++)
-        {
-          VMesh::Elem::array_type nci3;
+          auto n1 = neighbors[t];
+          ncitot.push_back(n1);
+          ncitot.insert(ncitot.end(), neighbors.begin() + offsets[n1], neighbors.begin() + offsets[n1 + 1]);
 
-          imesh->get_neighbors(nci3, nci2[t2]);
-          for (size_t L = 0; L < nci3.size(); L++)
+          for (auto t2 = offsets[n1]; t2 < offsets[n1 + 1]; t2++)
           {
-            ncitot.push_back(nci3[L]);
+            auto n2 = neighbors[t2];
+            ncitot.insert(ncitot.end(), neighbors.begin() + offsets[n2], neighbors.begin() + offsets[n2 + 1]);
           }
         }
-      }
 
-      not_on_list = false;
-      for (size_t p1 = 0; p1 < ncitot.size(); p1++)
-      {
-        not_on_list = false;
-        for (size_t p2 = 0; p2 < Nlist.size(); p2++)
+        // Keep every element once, in the order it first appears
+        firstuse.clear();
+        for (size_t p1 = 0; p1 < ncitot.size(); p1++)
+          firstuse.push_back(std::make_pair(static_cast<VMesh::index_type>(ncitot[p1]), p1));
+        std::sort(firstuse.begin(), firstuse.end());
+        firstuse.erase(std::unique(firstuse.begin(), firstuse.end(),
+          [](const std::pair<VMesh::index_type, size_t>& a, const std::pair<VMesh::index_type, size_t>& b) { return a.first == b.first; }),
+          firstuse.end());
+        std::sort(firstuse.begin(), firstuse.end(),
+          [](const std::pair<VMesh::index_type, size_t>& a, const std::pair<VMesh::index_type, size_t>& b) { return a.second < b.second; });
+        Nlist.clear();
+        for (size_t q = 0; q < firstuse.size(); q++)
+          Nlist.push_back(firstuse[q].first);
+
+        angles.clear();
+        original.clear();
+        ifield->get_value(v0, idx);
+        for (size_t q = 0; q < Nlist.size(); q++)
         {
-          if (ncitot[p1] == Nlist[p2])
+          auto a = Nlist[q];
+          ifield->get_value(v1, a);
+          if (v0.length()*v1.length() == 0)
           {
-            not_on_list = true;
+            angles.push_back(0);
+            original.push_back(0);
+          }
+          else
+          {
+            auto gdot = Dot(v0, v1);
+            auto m1 = v0.length();
+            auto m2 = v1.length();
+            auto angle = (gdot / (m1*m2));
+            angles.push_back(angle);
+            original.push_back(angle);
           }
-
-        }
-        if (!not_on_list)
-        {
-          Nlist.push_back(ncitot[p1]);
-        }
-      }
-
-      std::vector<double> angles, original;
-      ifield->get_value(v0, idx);
-      for (size_t q = 0; q < Nlist.size(); q++)
-      {
-        auto a = Nlist[q];
-        ifield->get_value(v1, a);
-        if (v0.length()*v1.length() == 0)
-        {
-          angles.push_back(0);
-          original.push_back(0);
-        }
-        else
-        {
-          auto gdot = Dot(v0, v1);
-          auto m1 = v0.length();
-          auto m2 = v1.length();
-          auto angle = (gdot / (m1*m2));
-          angles.push_back(angle);
-          original.push_back(angle);
         }
-      }
 
-      sort(angles.begin(), angles.end());
-      auto middle = (int)((angles.size() + 1) / 2);
-      for (size_t k = 0; k < original.size(); k++)
-      {
-        if (original[k] == angles[middle])
+        sort(angles.begin(), angles.end());
+        auto middle = std::min((angles.size() + 1) / 2, angles.size() - 1);
+        size_t myloc = 0;
+        for (size_t k = 0; k < original.size(); k++)
         {
-          myloc = k;
-          k = original.size();
+          if (original[k] == angles[middle])
+          {
+            myloc = k;
+            break;
+          }
         }
-      }
 
-      auto b = Nlist[myloc];
-      ifield->get_value(v2, b);
+        auto b = Nlist[myloc];
+        ifield->get_value(v2, b);
 
-      ofield->set_value(v2, idx);
+        ofield->set_value(v2, idx);
 
-      cnt++;
-      if (cnt == 200)
-      {
-        cnt = 0;
-        update_progress_max(idx, num_values);
+        if (task == 0 && ++cnt == 200)
+        {
+          cnt = 0;
+          update_progress_max(idx, end);
+        }
       }
-    }
+    });
   }
   return (true);
 }
@@ -0,0 +1,351 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Legacy/Fields/Mapping/RadialBasisInterpolation.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/GeometryPrimitives/BBox.h>
+#include <Eigen/QR>
+#include <cmath>
+#include <limits>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  const double patchCenterSpacing = 2.0;
+  const size_t minPatchSources = 20;
+
+  double thinPlate(double mag)
+  {
+    return (mag == 0) ? 0 : pow(mag, 2.0) * log(mag);
+  }
+
+  double wendland(double r)
+  {
+    const double s = 1.0 - r;
+    return (s <= 0.0) ? 0.0 : s * s * s * s * (4.0 * r + 1.0);
+  }
+
+  double distance(const Point& a, const Point& b)
+  {
+    auto xcomp = a.x() - b.x();
+    auto ycomp = a.y() - b.y();
+    auto zcomp = a.z() - b.z();
+    return sqrt(pow(xcomp, 2.0) + pow(ycomp, 2.0) + pow(zcomp, 2.0));
+  }
+
+  /// Copies the nodes into a point cloud, which can search nodes within a radius
+  /// whatever the type of the source mesh.
+  MeshHandle searchableCopy(VMesh* mesh)
+  {
+    FieldInformation fi("PointCloudMesh", 0, "double");
+    MeshHandle cloud = CreateMesh(fi);
+    VMesh* cmesh = cloud->vmesh();
+    const VMesh::size_type num_nodes = mesh->num_nodes();
+    cmesh->node_reserve(num_nodes);
+    Point p;
+    for (VMesh::Node::index_type idx = 0; idx < num_nodes; idx++)
+    {
+      mesh->get_point(p, idx);
+      cmesh->add_point(p);
+    }
+    cmesh->synchronize(Mesh::NODE_LOCATE_E);
+    return cloud;
+  }
+
+  /// Local thin plate spline with a linear term, in coordinates centered on
+  /// the patch and scaled by its radius.
+  struct Patch
+  {
+    Point center;
+    double radius;
+    std::vector<VMesh::Node::index_type> sources;
+    std::vector<Vector> local;
+    Eigen::VectorXd coefs;
+  };
+
+  Vector local(const Patch& patch, const Point& p)
+  {
+    return (p - patch.center) / patch.radius;
+  }
+
+  void fitPatch(VMesh* cloud, const std::vector<double>& values, Patch& patch)
+  {
+    const size_t n = patch.sources.size();
+    auto& q = patch.local;
+    q.resize(n);
+    Point p;
+    for (size_t i = 0; i < n; i++)
+    {
+      cloud->get_point(p, patch.sources[i]);
+      q[i] = local(patch, p);
+    }
+
+    Eigen::MatrixXd system = Eigen::MatrixXd::Zero(n + 4, n + 4);
+    Eigen::VectorXd rhs = Eigen::VectorXd::Zero(n + 4);
+    for (size_t i = 0; i < n; i++)
+    {
+      for (size_t j = 0; j < i; j++)
+        system(i, j) = system(j, i) = thinPlate((q[i] - q[j]).length());
+      const double poly[4] = { 1.0, q[i].x(), q[i].y(), q[i].z() };
+      for (int k = 0; k < 4; k++)
+        system(i, n + k) = system(n + k, i) = poly[k];
+      rhs[i] = values[patch.sources[i]];
+    }
+
+    // Sources on a plane or a line leave the linear term underdetermined,
+    // which the rank revealing solve tolerates.
+    patch.coefs = system.completeOrthogonalDecomposition().solve(rhs);
+  }
+
+  double evaluatePatch(const Patch& patch, const Point& p)
+  {
+    const size_t n = patch.local.size();
+    const Vector q = local(patch, p);
+    double sum = patch.coefs[n] + patch.coefs[n + 1] * q.x() + patch.coefs[n + 2] * q.y() + patch.coefs[n + 3] * q.z();
+    for (size_t i = 0; i < n; i++)
+      sum += patch.coefs[i] * thinPlate((q - patch.local[i]).length());
+    return sum;
+  }
+
+  double meanNearestSpacing(VMesh* cloud)
+  {
+    const VMesh::size_type num_nodes = cloud->num_nodes();
+    const double start = cloud->get_bounding_box().diagonal().length() / std::cbrt(static_cast<double>(num_nodes));
+    if (!(start > 0.0))
+      return 0.0;
+
+    const int tasks = Parallel::NumTasks(num_nodes);
+    std::vector<double> sums(tasks, 0.0);
+    Parallel::RunRange(num_nodes, tasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
+    {
+      std::vector<double> distances;
+      std::vector<VMesh::Node::index_type> nodes;
+      Point p;
+      for (VMesh::index_type idx = begin; idx < end; idx++)
+      {
+        cloud->get_point(p, VMesh::Node::index_type(idx));
+        double nearest2 = std::numeric_limits<double>::max();
+        for (double radius = start; nearest2 == std::numeric_limits<double>::max(); radius *= 2.0)
+        {
+          cloud->find_closest_nodes(distances, nodes, p, radius);
+          for (size_t k = 0; k < nodes.size(); k++)
+            if (nodes[k] != idx) nearest2 = std::min(nearest2, distances[k]);
+        }
+        sums[task] += std::sqrt(nearest2);
+      }
+    });
+
+    double sum = 0.0;
+    for (auto s : sums) sum += s;
+    return sum / num_nodes;
+  }
+}
+
+void RadialBasisInterpolation::thinPlateSpline(VMesh* cors, const std::vector<double>& values,
+  VMesh* points, double maxDistance, double outsideValue, std::vector<double>& result)
+{
+  const VMesh::size_type num_cors = cors->num_nodes();
+  const VMesh::size_type num_pts = points->num_nodes();
+
+  //create the radial basis function
+  DenseMatrix sigma(num_cors, num_cors);
+  const int corTasks = Parallel::NumTasks(num_cors);
+  Parallel::RunRange(num_cors, corTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    Point Pc, Pp;
+    for (VMesh::index_type i = begin; i < end; i++)
+    {
+      cors->get_point(Pp, VMesh::Node::index_type(i));
+      for (VMesh::index_type j = 0; j < num_cors; j++)
+      {
+        cors->get_point(Pc, VMesh::Node::index_type(j));
+        sigma(i, j) = thinPlate(distance(Pc, Pp));
+      }
+    }
+  });
+
+  //create the right side of the equation
+  DenseMatrix rsideMat(num_cors, 1);
+  for (VMesh::index_type i = 0; i < num_cors; i++)
+    rsideMat(i, 0) = values[i];
+
+  //run SVD
+  Eigen::JacobiSVD<DenseMatrix::EigenBase> svd_mat(sigma, Eigen::ComputeFullU | Eigen::ComputeFullV);
+
+  DenseMatrix Um = svd_mat.matrixU();
+  DenseMatrix Sm = svd_mat.singularValues();
+  DenseMatrix Vm = svd_mat.matrixV();
+
+  DenseMatrix coefs = Vm * (Um.transpose() * rsideMat).cwiseQuotient(Sm);
+
+  result.resize(num_pts);
+  const int ptTasks = Parallel::NumTasks(num_pts);
+  Parallel::RunRange(num_pts, ptTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    Point Pp, Pc;
+    for (VMesh::index_type i = begin; i < end; i++)
+    {
+      points->get_point(Pp, VMesh::Node::index_type(i));
+      double sumer = 0.0;
+      bool max_dist = false;
+      for (VMesh::index_type j = 0; j < num_cors && !max_dist; j++)
+      {
+        cors->get_point(Pc, VMesh::Node::index_type(j));
+        auto mag = distance(Pc, Pp);
+        max_dist = (mag > maxDistance);
+        sumer += coefs(j, 0) * thinPlate(mag);
+      }
+      result[i] = max_dist ? outsideValue : sumer;
+    }
+  });
+}
+
+bool RadialBasisInterpolation::partitionOfUnity(VMesh* cors, const std::vector<double>& values,
+  VMesh* points, double maxDistance, double outsideValue, std::vector<double>& result)
+{
+  const VMesh::size_type num_cors = cors->num_nodes();
+  const VMesh::size_type num_pts = points->num_nodes();
+  if (num_cors == 0)
+    return false;
+
+  MeshHandle cloudHandle = searchableCopy(cors);
+  VMesh* cloud = cloudHandle->vmesh();
+  double spacing = meanNearestSpacing(cloud);
+  if (!(spacing > 0.0))
+    spacing = 1.0;
+  const double centerSpacing = patchCenterSpacing * spacing;
+
+  // Every source lies within centerSpacing of a patch center
+  std::vector<VMesh::Node::index_type> centers;
+  {
+    std::vector<char> covered(num_cors, 0);
+    std::vector<double> distances;
+    std::vector<VMesh::Node::index_type> nodes;
+    Point p;
+    for (VMesh::Node::index_type idx = 0; idx < num_cors; idx++)
+    {
+      if (covered[idx]) continue;
+      centers.push_back(idx);
+      cloud->get_point(p, idx);
+      cloud->find_closest_nodes(distances, nodes, p, centerSpacing);
+      for (auto node : nodes) covered[node] = 1;
+      covered[idx] = 1;
+    }
+  }
+
+  const VMesh::size_type num_patches = centers.size();
+  const size_t minSources = std::min<size_t>(minPatchSources, num_cors);
+  std::vector<Patch> patches(num_patches);
+  const int patchTasks = Parallel::NumTasks(num_patches);
+  Parallel::RunRange(num_patches, patchTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    std::vector<double> distances;
+    for (VMesh::index_type j = begin; j < end; j++)
+    {
+      Patch& patch = patches[j];
+      cloud->get_point(patch.center, centers[j]);
+      patch.radius = 2.0 * centerSpacing;
+      for (;; patch.radius *= 1.25)
+      {
+        cloud->find_closest_nodes(distances, patch.sources, patch.center, patch.radius);
+        if (patch.sources.size() >= minSources) break;
+      }
+      fitPatch(cloud, values, patch);
+    }
+  });
+
+  FieldInformation fi("PointCloudMesh", 0, "double");
+  MeshHandle centerHandle = CreateMesh(fi);
+  VMesh* centerCloud = centerHandle->vmesh();
+  centerCloud->node_reserve(num_patches);
+  double maxRadius = 0.0;
+  for (const auto& patch : patches)
+  {
+    centerCloud->add_point(patch.center);
+    maxRadius = std::max(maxRadius, patch.radius);
+  }
+  centerCloud->synchronize(Mesh::NODE_LOCATE_E);
+
+  result.resize(num_pts);
+  const int ptTasks = Parallel::NumTasks(num_pts);
+  Parallel::RunRange(num_pts, ptTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    std::vector<double> distances;
+    std::vector<VMesh::Node::index_type> nodes;
+    Point p, closest;
+    for (VMesh::index_type i = begin; i < end; i++)
+    {
+      points->get_point(p, VMesh::Node::index_type(i));
+      if (maxDistance < std::numeric_limits<double>::max())
+      {
+        double nearest;
+        VMesh::Node::index_type node(0);
+        cloud->find_closest_node(nearest, closest, node, p);
+        if (nearest > maxDistance)
+        {
+          result[i] = outsideValue;
+          continue;
+        }
+      }
+
+      double sum = 0.0, weights = 0.0;
+      centerCloud->find_closest_nodes(distances, nodes, p, maxRadius);
+      for (size_t k = 0; k < nodes.size(); k++)
+      {
+        const Patch& patch = patches[nodes[k]];
+        double weight = wendland(std::sqrt(distances[k]) / patch.radius);
+        if (weight <= 0.0) continue;
+        sum += weight * evaluatePatch(patch, p);
+        weights += weight;
+      }
+
+      if (weights > 0.0)
+      {
+        result[i] = sum / weights;
+      }
+      else
+      {
+        double nearest;
+        VMesh::Node::index_type node(0);
+        centerCloud->find_closest_node(nearest, closest, node, p);
+        result[i] = evaluatePatch(patches[node], p);
+      }
+    }
+  });
+
+  return true;
+}
@@ -0,0 +1,69 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_FIELDS_MAPPING_RADIALBASISINTERPOLATION_H
+#define CORE_ALGORITHMS_FIELDS_MAPPING_RADIALBASISINTERPOLATION_H 1
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <vector>
+
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+/// Interpolation of values given at the nodes of one mesh onto the nodes of
+/// another with radial basis functions. Evaluation runs in parallel over the
+/// target nodes.
+class SCISHARE RadialBasisInterpolation
+{
+public:
+  /// Thin plate spline r^2 log r through every source node. The dense system
+  /// is solved with an SVD, which limits it to a few thousand sources. A target
+  /// gets outsideValue when any source is farther than maxDistance from it.
+  static void thinPlateSpline(VMesh* sources, const std::vector<double>& values,
+    VMesh* targets, double maxDistance, double outsideValue, std::vector<double>& result);
+
+  /// Blend of local thin plate splines, each fitted with a linear term to
+  /// the sources near one patch center. Patch centers are sources at least
+  /// two mean source spacings apart; each patch takes the sources within
+  /// twice that distance, growing until it holds enough of them. A target
+  /// blends the patches that cover it with Wendland weights, or uses the
+  /// nearest patch when none does, so the cost stays linear in the number of
+  /// sources and targets. A target gets outsideValue when the closest source
+  /// is farther than maxDistance. Returns false if there are no sources.
+  static bool partitionOfUnity(VMesh* sources, const std::vector<double>& values,
+    VMesh* targets, double maxDistance, double outsideValue, std::vector<double>& result);
+};
+
+      }}}}
+
+#endif
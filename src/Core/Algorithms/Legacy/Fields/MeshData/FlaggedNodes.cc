@@ -0,0 +1,71 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Legacy/Fields/MeshData/FlaggedNodes.h>
+#include <Core/Thread/Parallel.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Algorithms::Fields;
+
+VMesh::size_type FlaggedNodes::number(const Flags& flags,
+  std::vector<VMesh::index_type>& newIndex, std::vector<VMesh::index_type>& oldIndex)
+{
+  const VMesh::size_type num_nodes = flags.size();
+  const int tasks = Parallel::NumTasks(num_nodes);
+  std::vector<VMesh::size_type> offsets(tasks + 1, 0);
+  newIndex.assign(num_nodes, -1);
+
+  Parallel::RunRange(num_nodes, tasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
+  {
+    VMesh::size_type count = 0;
+    for (VMesh::index_type idx = begin; idx < end; idx++)
+      if (flags[idx].load(std::memory_order_relaxed)) count++;
+    offsets[task + 1] = count;
+  });
+
+  for (int task = 0; task < tasks; task++)
+    offsets[task + 1] += offsets[task];
+
+  oldIndex.resize(offsets[tasks]);
+  Parallel::RunRange(num_nodes, tasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
+  {
+    VMesh::index_type next = offsets[task];
+    for (VMesh::index_type idx = begin; idx < end; idx++)
+    {
+      if (flags[idx].load(std::memory_order_relaxed))
+      {
+        newIndex[idx] = next;
+        oldIndex[next++] = idx;
+      }
+    }
+  });
+
+  return offsets[tasks];
+}
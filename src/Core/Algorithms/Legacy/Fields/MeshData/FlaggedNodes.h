@@ -0,0 +1,62 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_FIELDS_MESHDATA_FLAGGEDNODES_H
+#define CORE_ALGORITHMS_FIELDS_MESHDATA_FLAGGEDNODES_H 1
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <atomic>
+#include <vector>
+
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+/// Nodes of an input mesh that an algorithm keeps, flagged concurrently by the
+/// tasks that visit their elements and numbered afterwards in input order, so
+/// the numbering does not depend on the number of tasks.
+class SCISHARE FlaggedNodes
+{
+public:
+  /// One flag per input node.
+  typedef std::vector<std::atomic<char> > Flags;
+
+  /// Numbers the flagged nodes in input order; unflagged nodes map to -1 in
+  /// newIndex and oldIndex lists the input node of every new one. Returns the
+  /// number of flagged nodes.
+  static VMesh::size_type number(const Flags& flags,
+    std::vector<VMesh::index_type>& newIndex, std::vector<VMesh::index_type>& oldIndex);
+};
+
+      }}}}
+
+#endif
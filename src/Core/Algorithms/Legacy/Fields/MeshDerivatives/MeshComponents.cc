@@ -0,0 +1,216 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Legacy/Fields/MeshDerivatives/MeshComponents.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <algorithm>
+#include <atomic>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  typedef std::vector<std::atomic<VMesh::index_type> > NodeParents;
+
+  // Parents always point to a lower node, so a value read while another task
+  // links trees is still an ancestor and path halving may skip over it.
+  VMesh::index_type findRoot(NodeParents& parent, VMesh::index_type node)
+  {
+    while (true)
+    {
+      VMesh::index_type up = parent[node].load(std::memory_order_relaxed);
+      if (up == node)
+        return node;
+      VMesh::index_type upup = parent[up].load(std::memory_order_relaxed);
+      if (upup != up)
+        parent[node].compare_exchange_weak(up, upup, std::memory_order_relaxed);
+      node = upup;
+    }
+  }
+
+  void unite(NodeParents& parent, VMesh::index_type a, VMesh::index_type b)
+  {
+    while (true)
+    {
+      a = findRoot(parent, a);
+      b = findRoot(parent, b);
+      if (a == b)
+        return;
+      if (a < b)
+        std::swap(a, b);
+      // Only a root may be linked; if another task got there first, look again.
+      VMesh::index_type expected = a;
+      if (parent[a].compare_exchange_strong(expected, b))
+        return;
+    }
+  }
+}
+
+VMesh::size_type MeshComponents::labelConnectedRegions(VMesh* mesh,
+  std::vector<VMesh::index_type>& elemLabels, std::vector<VMesh::index_type>& nodeLabels)
+{
+  const VMesh::size_type num_nodes = mesh->num_nodes();
+  const VMesh::size_type num_elems = mesh->num_elems();
+  const int nodeTasks = Parallel::NumTasks(num_nodes);
+  const int elemTasks = Parallel::NumTasks(num_elems);
+  const VMesh::index_type unused = num_elems;
+
+  NodeParents parent(num_nodes);
+  std::vector<std::atomic<VMesh::index_type> > firstElem(num_nodes);
+  Parallel::RunRange(num_nodes, nodeTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    for (VMesh::index_type idx = begin; idx < end; idx++)
+    {
+      parent[idx].store(idx, std::memory_order_relaxed);
+      firstElem[idx].store(unused, std::memory_order_relaxed);
+    }
+  });
+
+  // Every element joins the trees of its nodes; elemLabels holds its first node for now.
+  elemLabels.resize(num_elems);
+  Parallel::RunRange(num_elems, elemTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    VMesh::Node::array_type nodes;
+    for (VMesh::Elem::index_type idx = begin; idx < end; idx++)
+    {
+      mesh->get_nodes(nodes, idx);
+      for (size_t j = 1; j < nodes.size(); j++)
+        unite(parent, nodes[0], nodes[j]);
+      elemLabels[idx] = nodes[0];
+    }
+  });
+
+  Parallel::RunRange(num_elems, elemTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    for (VMesh::index_type idx = begin; idx < end; idx++)
+    {
+      VMesh::index_type root = findRoot(parent, elemLabels[idx]);
+      elemLabels[idx] = root;
+      VMesh::index_type first = firstElem[root].load(std::memory_order_relaxed);
+      while (idx < first && !firstElem[root].compare_exchange_weak(first, idx, std::memory_order_relaxed)) {}
+    }
+  });
+
+  std::vector<VMesh::index_type> roots;
+  for (VMesh::index_type idx = 0; idx < num_nodes; idx++)
+    if (firstElem[idx].load(std::memory_order_relaxed) != unused)
+      roots.push_back(idx);
+
+  std::sort(roots.begin(), roots.end(), [&](VMesh::index_type r1, VMesh::index_type r2)
+  {
+    return firstElem[r1].load(std::memory_order_relaxed) < firstElem[r2].load(std::memory_order_relaxed);
+  });
+
+  // From here on firstElem holds the label of every root.
+  for (size_t j = 0; j < roots.size(); j++)
+    firstElem[roots[j]].store(j, std::memory_order_relaxed);
+
+  nodeLabels.resize(num_nodes);
+  Parallel::RunRange(num_nodes, nodeTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    for (VMesh::index_type idx = begin; idx < end; idx++)
+    {
+      VMesh::index_type label = firstElem[findRoot(parent, idx)].load(std::memory_order_relaxed);
+      nodeLabels[idx] = (label == unused) ? -1 : label;
+    }
+  });
+
+  Parallel::RunRange(num_elems, elemTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    for (VMesh::index_type idx = begin; idx < end; idx++)
+      elemLabels[idx] = firstElem[elemLabels[idx]].load(std::memory_order_relaxed);
+  });
+
+  return roots.size();
+}
+
+void MeshComponents::groupMembers(const std::vector<VMesh::index_type>& labels, VMesh::size_type numGroups,
+  std::vector<VMesh::index_type>& offsets, std::vector<VMesh::index_type>& members)
+{
+  offsets.assign(numGroups + 1, 0);
+  for (size_t idx = 0; idx < labels.size(); idx++)
+    if (labels[idx] >= 0) offsets[labels[idx] + 1]++;
+
+  for (VMesh::index_type g = 0; g < numGroups; g++)
+    offsets[g + 1] += offsets[g];
+
+  members.resize(offsets[numGroups]);
+  std::vector<VMesh::index_type> next(offsets.begin(), offsets.end() - 1);
+  for (size_t idx = 0; idx < labels.size(); idx++)
+    if (labels[idx] >= 0) members[next[labels[idx]]++] = idx;
+}
+
+void MeshComponents::copyPiece(VMesh* imesh, VField* ifield,
+  const VMesh::index_type* nodes, VMesh::size_type numNodes,
+  const VMesh::index_type* elems, VMesh::size_type numElems,
+  const std::vector<VMesh::index_type>& renumber, VMesh* omesh, VField* ofield)
+{
+  omesh->resize_nodes(numNodes);
+  omesh->resize_elems(numElems);
+  if (ofield) ofield->resize_fdata();
+
+  const bool nodeValues = ifield && ofield && ifield->basis_order() == 1;
+  const bool elemValues = ifield && ofield && ifield->basis_order() == 0;
+
+  const int nodeTasks = Parallel::NumTasks(numNodes);
+  Parallel::RunRange(numNodes, nodeTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    Point point;
+    for (VMesh::index_type q = begin; q < end; q++)
+    {
+      imesh->get_center(point, VMesh::Node::index_type(nodes[q]));
+      omesh->set_point(point, VMesh::Node::index_type(q));
+      if (nodeValues) ofield->copy_value(ifield, nodes[q], q);
+    }
+  });
+
+  // The elements of a point cloud are its nodes, which are already in place.
+  const bool setNodes = !omesh->is_pointcloudmesh();
+  const int elemTasks = Parallel::NumTasks(numElems);
+  Parallel::RunRange(numElems, elemTasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    VMesh::Node::array_type elemnodes;
+    for (VMesh::index_type q = begin; q < end; q++)
+    {
+      if (setNodes)
+      {
+        imesh->get_nodes(elemnodes, VMesh::Elem::index_type(elems[q]));
+        for (size_t r = 0; r < elemnodes.size(); r++)
+          elemnodes[r] = VMesh::Node::index_type(renumber[elemnodes[r]]);
+        omesh->set_nodes(elemnodes, VMesh::Elem::index_type(q));
+      }
+      if (elemValues) ofield->copy_value(ifield, elems[q], q);
+    }
+  });
+}
@@ -0,0 +1,73 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_FIELDS_MESHDERIVATIVES_MESHCOMPONENTS_H
+#define CORE_ALGORITHMS_FIELDS_MESHDERIVATIVES_MESHCOMPONENTS_H 1
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldFwd.h>
+#include <vector>
+
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+/// Splitting of a mesh into groups of elements, shared by the algorithms that
+/// break a field into pieces. Every step runs in contiguous element or node
+/// ranges, so the pieces do not depend on the number of tasks.
+class SCISHARE MeshComponents
+{
+public:
+  /// Labels the elements and nodes by the region of elements connected to them
+  /// through shared nodes. Regions are numbered from 0 in the order of their
+  /// lowest element, which is the order a walk over the elements finds them in.
+  /// Nodes not used by any element get label -1. Returns the number of regions.
+  static VMesh::size_type labelConnectedRegions(VMesh* mesh,
+    std::vector<VMesh::index_type>& elemLabels, std::vector<VMesh::index_type>& nodeLabels);
+
+  /// Lists the members of every group in input order: group g owns
+  /// members[offsets[g]] up to members[offsets[g+1]]. Negative labels are skipped.
+  static void groupMembers(const std::vector<VMesh::index_type>& labels, VMesh::size_type numGroups,
+    std::vector<VMesh::index_type>& offsets, std::vector<VMesh::index_type>& members);
+
+  /// Fills an empty mesh with the given input nodes and elements. renumber maps
+  /// every node of these elements to its index in the output. When ifield is
+  /// given, its node or element values are copied into ofield as well.
+  static void copyPiece(VMesh* imesh, VField* ifield,
+    const VMesh::index_type* nodes, VMesh::size_type numNodes,
+    const VMesh::index_type* elems, VMesh::size_type numElems,
+    const std::vector<VMesh::index_type>& renumber, VMesh* omesh, VField* ofield);
+};
+
+      }}}}
+
+#endif
@@ -28,6 +28,7 @@
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Legacy/Fields/MeshDerivatives/SplitByConnectedRegion.h>
+#include <Core/Algorithms/Legacy/Fields/MeshDerivatives/MeshComponents.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
@@ -113,6 +114,7 @@ std::vector<FieldHandle> SplitFieldByConnectedRegionAlgo::run(FieldHandle input)
   {
     output.push_back(input);
     remark("Structured meshes consist always of one piece. Hence there is no algorithm to perform.");
+    return output;
   }
 
   if (fi.is_pointcloudmesh())
@@ -123,154 +125,45 @@ std::vector<FieldHandle> SplitFieldByConnectedRegionAlgo::run(FieldHandle input)
   VField* ifield = input->vfield();
   VMesh*  imesh  = input->vmesh();
 
-  VField::index_type k = 0;
-
   VMesh::size_type num_nodes = imesh->num_nodes();
-  VMesh::size_type num_elems = imesh->num_elems();
-
-  VField::size_type surfsize = static_cast<VField::size_type>(pow(num_elems, 2.0 / 3.0));
-  std::vector<VMesh::Elem::index_type> buffer;
-  buffer.reserve(surfsize);
 
-  imesh->synchronize(Mesh::NODE_NEIGHBORS_E|Mesh::ELEM_NEIGHBORS_E|Mesh::DELEMS_E);
+  std::vector<VMesh::index_type> elemmap;
+  std::vector<VMesh::index_type> nodemap;
+  VMesh::size_type k = MeshComponents::labelConnectedRegions(imesh, elemmap, nodemap);
 
-  std::vector<index_type> elemmap(num_elems, 0);
-  std::vector<index_type> nodemap(num_nodes, 0);
-  std::vector<index_type> renumber(num_nodes,0);
-  std::vector<short> visited(num_elems, 0);
+  std::vector<VMesh::index_type> nodeoffsets, nodes;
+  std::vector<VMesh::index_type> elemoffsets, elems;
+  MeshComponents::groupMembers(nodemap, k, nodeoffsets, nodes);
+  MeshComponents::groupMembers(elemmap, k, elemoffsets, elems);
 
-  VMesh::Node::array_type nnodes;
-  VMesh::Elem::array_type neighbors;
+  // Every node belongs to one region, where it keeps its input order
+  std::vector<VMesh::index_type> renumber(num_nodes, 0);
+  for (size_t q = 0; q < nodes.size(); q++)
+    renumber[nodes[q]] = q - nodeoffsets[nodemap[nodes[q]]];
 
-  for (VMesh::Elem::index_type idx=0; idx<num_elems; idx++)
+  output.resize(k);
+  for (VMesh::index_type p=0; p<k; p++)
   {
-    // if list of elements to process is empty ad the next one
-    if (buffer.size() == 0)
-    {
-      if(visited[idx] == 0) { buffer.push_back(idx); k++; }
-    }
-
-    if (buffer.size() > 0)
-    {
-      for (size_t i=0; i< buffer.size(); i++)
-      {
-        VField::index_type j = buffer[i];
-        if (visited[j] > 0) { continue; }
-        visited[j] = 1;
-
-        imesh->get_nodes(nnodes,buffer[i]);
-        for (size_t q=0; q<nnodes.size(); q++)
-        {
-          imesh->get_elems(neighbors,nnodes[q]);
-          for (size_t p=0; p<neighbors.size(); p++)
-          {
-            if(visited[neighbors[p]] == 0)
-            {
-              buffer.push_back(neighbors[p]);
-              visited[neighbors[p]] = -1;
-            }
-          }
-        }
-
-        if (j >= static_cast<index_type>(elemmap.size())) elemmap.resize(j+1);
-
-        elemmap[j] = k;
-        for (size_t p=0;p<nnodes.size();p++)
-        {
-          if (static_cast<size_t>(nnodes[p]) >= nodemap.size())
-            nodemap.resize(nnodes[p]+1);
-          nodemap[nnodes[p]] = k;
-        }
-      }
-      buffer.clear();
-    }
-  }
-
- output.resize(k);
-  for (size_type p=0; p<k; p++)
-  {
-    VField* ofield;
-    VMesh* omesh;
-    MeshHandle mesh;
-    FieldHandle field;
-
-    VField::size_type nn = 0;
-    VField::size_type ne = 0;
-
-    for (VField::index_type q=0;q<num_nodes;q++) if (nodemap[q] == p+1) nn++;
-    for (VField::index_type q=0;q<num_elems;q++) if (elemmap[q] == p+1) ne++;
-
-    mesh = CreateMesh(fi);
+    MeshHandle mesh = CreateMesh(fi);
     if (!mesh)
     {
       THROW_ALGORITHM_INPUT_ERROR("Could not create output field.");
     }
-    omesh = mesh->vmesh();
 
-    omesh->node_reserve(nn);
-    omesh->elem_reserve(ne);
-
-    field = CreateField(fi,mesh);
+    FieldHandle field = CreateField(fi,mesh);
     if (field == nullptr)
     {
       THROW_ALGORITHM_INPUT_ERROR("Could not create output field");
     }
-
-    ofield = field->vfield();
     output[p] = field;
 
-    Point point;
-    for (index_type q=0;q<num_nodes;q++)
-    {
-      if (nodemap[q] == p+1)
-      {
-        imesh->get_center(point,VMesh::Node::index_type(q));
-        renumber[q] = omesh->add_point(point);
-      }
-    }
-
-    VMesh::Node::array_type elemnodes;
-    for (index_type q=0;q<num_elems;q++)
-    {
-      if (elemmap[q] == p+1)
-      {
-        imesh->get_nodes(elemnodes,VMesh::Elem::index_type(q));
-        for (size_t r=0; r< elemnodes.size(); r++)
-        {
-          elemnodes[r] = VMesh::Node::index_type(renumber[elemnodes[r]]);
-        }
-        omesh->add_elem(elemnodes);
-      }
-    }
-
-    ofield->resize_fdata();
-
-    if (ifield->basis_order() == 1)
-    {
-      VField::index_type qq = 0;
-      for (VField::index_type q=0;q<num_nodes;q++)
-      {
-        if (nodemap[q] == p+1)
-        {
-          ofield->copy_value(ifield,q,qq); qq++;
-        }
-      }
-    }
-
-    if (ifield->basis_order() == 0)
-    {
-      VField::index_type qq = 0;
-      for (VField::index_type q=0;q<num_elems;q++)
-      {
-        if (elemmap[q] == p+1)
-        {
-          ofield->copy_value(ifield,q,qq); qq++;
-        }
-      }
-    }
+    MeshComponents::copyPiece(imesh, ifield,
+      nodes.data() + nodeoffsets[p], nodeoffsets[p+1] - nodeoffsets[p],
+      elems.data() + elemoffsets[p], elemoffsets[p+1] - elemoffsets[p],
+      renumber, field->vmesh(), field->vfield());
 
    #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-    ofield->copy_properties(ifield);
+    field->vfield()->copy_properties(ifield);
    #endif
   }
 
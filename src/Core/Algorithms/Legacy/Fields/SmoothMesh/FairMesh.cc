@@ -29,6 +29,9 @@
 #include <Core/Algorithms/Legacy/Fields/SmoothMesh/FairMesh.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Algorithms/Legacy/Fields/SmoothMesh/MeshSmoother.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 
 using namespace SCIRun;
@@ -37,11 +40,13 @@ using namespace SCIRun::Core::Algorithms::Fields;
 using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::Core::Utility;
 using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Thread;
 
 ALGORITHM_PARAMETER_DEF(Fields, FairMeshMethod);
 ALGORITHM_PARAMETER_DEF(Fields, NumIterations);
 ALGORITHM_PARAMETER_DEF(Fields, Lambda);
 ALGORITHM_PARAMETER_DEF(Fields, FilterCutoff);
+ALGORITHM_PARAMETER_DEF(Fields, ImplicitFairing);
 
 FairMeshAlgo::FairMeshAlgo()
 {
@@ -49,6 +54,96 @@ FairMeshAlgo::FairMeshAlgo()
   addParameter(Parameters::NumIterations,50);
   addParameter(Parameters::Lambda,0.6307);
   addParameter(Parameters::FilterCutoff,0.1);
+  addParameter(Parameters::ImplicitFairing,false);
+}
+
+namespace {
+
+const double implicitTolerance = 1e-10;
+const int implicitMaxIterations = 1000;
+
+// An edge opposite to a node, with the entries of its two nodes in the row of that node
+struct OppositeEdge
+{
+  VMesh::index_type first, second;
+  index_type firstEntry, secondEntry;
+};
+
+typedef std::vector<std::vector<OppositeEdge> > OppositeEdges;
+
+// Desbrun weights follow the current geometry: for every edge (p1,p2) opposite
+// to node p0, p2 gets A/B and p1 gets C/B, where B is the distance from p0 to
+// the edge and A and C split the edge at the foot of that perpendicular. Rows
+// are normalized by their total weight; nodes without weight stay in place.
+void setDesbrunWeights(SparseRowMatrix& laplacian,
+  const OppositeEdges& neighborhoods,
+  const Point* point, double epsilon)
+{
+  const VMesh::size_type num_nodes = neighborhoods.size();
+  const auto outer = laplacian.outerIndexPtr();
+  const auto inner = laplacian.innerIndexPtr();
+  auto values = laplacian.valuePtr();
+
+  const int tasks = Parallel::NumTasks(num_nodes);
+  Parallel::RunRange(num_nodes, tasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    for (VMesh::index_type idx=begin; idx<end; idx++)
+    {
+      std::fill(values + outer[idx], values + outer[idx+1], 0.0);
+
+      // Center location of this node
+      const Point& p0 = point[idx];
+      const std::vector<OppositeEdge> &neighborhood = neighborhoods[idx];
+
+      // total weight
+      double totw = 0.0;
+
+      for (size_t j = 0; j < neighborhood.size(); j++)
+      {
+        const Point& p1 = point[neighborhood[j].first];
+        const Point& p2 = point[neighborhood[j].second];
+
+        // Get vector between neighbors
+        Vector p12 = p1-p2;
+
+        // Squared distance between neighbors
+        double e = Dot(p12,p12);
+
+        if (e > 0.0)
+        {
+          double dot = Dot(p1-p0,p12)/e;
+          Point p3 = p1 - dot*p12;
+
+          double A = (p1-p3).length();
+          double B = (p0-p3).length();
+          double C = (p2-p3).length();
+
+          // if B approaches zero, we have a flat
+          // triangle, hence we need to bounce back the node
+          // towards the other side. Hence ignoring these
+          // directions
+          if (B >= 10*epsilon)
+          {
+            if (dot < 0.0) A = -A;
+            if (dot > 1.0) C = -C;
+            totw += (A+C)/B;
+
+            values[neighborhood[j].secondEntry] += A/B;
+            values[neighborhood[j].firstEntry] += C/B;
+          }
+        }
+      }
+
+      if (totw != 0.0)
+      {
+        for (index_type k = outer[idx]; k < outer[idx+1]; k++)
+          values[k] /= totw;
+        values[std::lower_bound(inner + outer[idx], inner + outer[idx+1], idx) - inner] = -1.0;
+      }
+    }
+  });
+}
+
 }
 
 bool FairMeshAlgo::runImpl(FieldHandle input,FieldHandle& output) const
@@ -76,7 +171,8 @@ bool FairMeshAlgo::runImpl(FieldHandle input,FieldHandle& output) const
   }
 
   std::string method = getOption(Parameters::FairMeshMethod);
-  int num_iter = 2*get(Parameters::NumIterations).toInt();
+  bool implicit = get(Parameters::ImplicitFairing).toBool();
+  int num_iter = (implicit ? 1 : 2)*get(Parameters::NumIterations).toInt();
   double lambda = get(Parameters::Lambda).toDouble();
   double filter_cutoff = get(Parameters::FilterCutoff).toDouble();
 
@@ -88,161 +184,82 @@ bool FairMeshAlgo::runImpl(FieldHandle input,FieldHandle& output) const
   VMesh::size_type num_nodes = mesh->num_nodes();
   mesh->unsynchronize(Mesh::NORMALS_E);
 
+  OppositeEdges neighborhoods;
+  double epsilon = 0.0;
+  SparseRowMatrixHandle laplacian;
+
   if (method == "fast")
   {
-    // Fast neighborhoods
-    std::vector<VMesh::Node::array_type > neighborhoods(num_nodes);
-    mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
-
-    for (VMesh::Node::index_type idx=0; idx<num_nodes; idx++)
-    {
-      mesh->get_neighbors(neighborhoods[idx],idx);
-    }
-
-    std::vector<Vector> disp(num_nodes);
-    Point*  point = mesh->get_points_pointer();
-    Point p0;
-    for (int it = 0; it<num_iter; it++)
-    {
-      for (VMesh::index_type idx=0; idx<num_nodes;idx++)
-      {
-        p0 = point[idx];
-        Vector d(0.0,0.0,0.0);
-        VMesh::Node::array_type &neighbors = neighborhoods[idx];
-        double w = 1.0/(neighbors.size());
-        for (size_t j=0; j<neighbors.size(); j++)
-        {
-          d += w* (point[neighbors[j]]-p0);
-        }
-        disp[idx] = d;
-      }
-
-      if (it % 2 == 0)
-      {
-        for (VMesh::Node::index_type idx=0; idx<num_nodes;idx++)
-          point[idx] = point[idx]+ lambda*disp[idx];
-      }
-      else
-      {
-        for (VMesh::Node::index_type idx=0; idx<num_nodes;idx++)
-          point[idx] = point[idx]+  mu*disp[idx];
-      }
-      update_progress_max(it,num_iter);
-    }
+    // Equal weights do not change with the geometry, so the operator is final
+    laplacian = MeshSmoother::uniformLaplacian(mesh);
   }
   else
   {
     // desbrun method
-    std::vector<std::vector<std::pair<VMesh::index_type,VMesh::index_type> > > neighborhoods(num_nodes);
+    laplacian = MeshSmoother::elementStencil(mesh);
+    neighborhoods.resize(num_nodes);
     mesh->synchronize(Mesh::NODE_NEIGHBORS_E|Mesh::EPSILON_E);
+    epsilon = mesh->get_epsilon();
 
-    VMesh::Elem::array_type elems;
-    VMesh::Node::array_type nodes;
-
-    for (VMesh::Node::index_type idx=0; idx<num_nodes; idx++)
+    const auto outer = laplacian->outerIndexPtr();
+    const auto inner = laplacian->innerIndexPtr();
+    auto entry = [&](VMesh::index_type row, VMesh::index_type col)
     {
-      std::vector<std::pair<VMesh::index_type,VMesh::index_type> > &neighborhood = neighborhoods[idx];
-      mesh->get_elems(elems,idx);
-      for (size_t j = 0; j<elems.size(); j++)
-      {
-        mesh->get_nodes(nodes,elems[j]);
-        // make it circular
-        nodes.push_back(nodes[0]);
+      return std::lower_bound(inner + outer[row], inner + outer[row+1], col) - inner;
+    };
 
-        for (size_t k=1;k < nodes.size();k++)
-        {
-          // get all edges that are not connected to the node itself
-          if(nodes[k-1] != idx && nodes[k] != idx)
-          {
-            neighborhood.push_back(std::pair<VMesh::index_type,VMesh::index_type>(nodes[k-1],nodes[k]));
-          }
-        }
-      }
-    }
-
-    std::vector<Vector> disp(num_nodes);
-    Point*  point = mesh->get_points_pointer();
-    Point p0;
-
-    double epsilon = mesh->get_epsilon();
-
-    for (int it = 0; it<num_iter; it++)
+    const int tasks = Parallel::NumTasks(num_nodes);
+    Parallel::RunRange(num_nodes, tasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
     {
+      VMesh::Elem::array_type elems;
+      VMesh::Node::array_type nodes;
 
-      for (VMesh::index_type idx=0; idx<num_nodes;idx++)
+      for (VMesh::Node::index_type idx=begin; idx<end; idx++)
       {
-        // Center location of this node
-        p0 = point[idx];
-        Vector d(0.0,0.0,0.0);
-
-        // neighborhood points
-        Point p1, p2, p3;
-        Vector p12;
-
-        // get local neighborhood pairs
-        const std::vector<std::pair<VMesh::index_type,VMesh::index_type> > &neighborhood = neighborhoods[idx];
-
-        // if no neighborhood continue
-        if (neighborhood.empty()) continue;
-
-        // total weight
-        double totw = 0.0;
-
-        for (size_t j = 0; j < neighborhood.size(); j++)
+        std::vector<OppositeEdge> &neighborhood = neighborhoods[idx];
+        mesh->get_elems(elems,idx);
+        for (size_t j = 0; j<elems.size(); j++)
         {
-          p1 = point[neighborhood[j].first];
-          p2 = point[neighborhood[j].second];
-
-          // vectors pointing to the two neighbor nodes
-          Vector e1 = p2-p0;
-          Vector e2 = p1-p0;
+          mesh->get_nodes(nodes,elems[j]);
+          // make it circular
+          nodes.push_back(nodes[0]);
 
-          // Get vector between neighbors
-          p12 = p1-p2;
-
-          // Squared distance between neighbors
-          double e = Dot(p12,p12);
-
-          if (e > 0.0)
+          for (size_t k=1;k < nodes.size();k++)
           {
-            double dot = Dot(p1-p0,p12)/e;
-            p3 = p1 - dot*p12;
-
-            double A = (p1-p3).length();
-            double B = (p0-p3).length();
-            double C = (p2-p3).length();
-
-            // if B approaches zero, we have a flat
-            // triangle, hence we need to bounce back the node
-            // towards the other side. Hence ignoring these
-            // directions
-            if (B >= 10*epsilon)
+            // get all edges that are not connected to the node itself
+            if(nodes[k-1] != idx && nodes[k] != idx)
             {
-              if (dot < 0.0) A = -A;
-              if (dot > 1.0) C = -C;
-              totw += (A+C)/B;
-
-              d += (A/B)*e1 + (C/B)*e2;
+              OppositeEdge edge = { nodes[k-1], nodes[k], entry(idx,nodes[k-1]), entry(idx,nodes[k]) };
+              neighborhood.push_back(edge);
             }
           }
         }
-
-        /// set the displacement vector for this node.
-        if (totw != 0.0) disp[idx] = d * (1.0 / totw);
       }
+    });
+  }
 
-      if (it % 2 == 0)
-      {
-        for (VMesh::Node::index_type idx=0; idx<num_nodes;idx++)
-          point[idx] = point[idx]+ lambda*disp[idx];
-      }
-      else
+  std::vector<Vector> disp(num_nodes);
+  Point*  point = mesh->get_points_pointer();
+
+  for (int it = 0; it<num_iter; it++)
+  {
+    if (!neighborhoods.empty())
+      setDesbrunWeights(*laplacian, neighborhoods, point, epsilon);
+
+    if (implicit)
+    {
+      if (!MeshSmoother::implicitStep(*laplacian, point, lambda, implicitTolerance, implicitMaxIterations))
       {
-        for (VMesh::Node::index_type idx=0; idx<num_nodes;idx++)
-          point[idx] = point[idx]+  mu*disp[idx];
+        error("The implicit fairing step did not converge");
+        return (false);
       }
-      update_progress_max(it,num_iter);
     }
+    else
+    {
+      MeshSmoother::displacements(*laplacian, point, disp);
+      MeshSmoother::move(point, disp, (it % 2 == 0) ? lambda : mu);
+    }
+    update_progress_max(it,num_iter);
   }
 
   return (true);
@@ -41,6 +41,7 @@ namespace SCIRun {
         ALGORITHM_PARAMETER_DECL(NumIterations);
         ALGORITHM_PARAMETER_DECL(Lambda);
         ALGORITHM_PARAMETER_DECL(FilterCutoff);
+        ALGORITHM_PARAMETER_DECL(ImplicitFairing);
 
         class SCISHARE FairMeshAlgo : public AlgorithmBase
         {
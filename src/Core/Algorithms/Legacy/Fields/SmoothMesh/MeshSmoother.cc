@@ -0,0 +1,226 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Legacy/Fields/SmoothMesh/MeshSmoother.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Algorithms/Math/SolveLinearSystemWithEigen.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <algorithm>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  /// Builds the compressed rows of a square matrix directly, one task per
+  /// row range, from the sorted column lists the row function gives.
+  template <class ROW>
+  SparseRowMatrixHandle buildRows(VMesh::size_type num_rows, ROW row)
+  {
+    const int tasks = Parallel::NumTasks(num_rows);
+    std::vector<std::vector<index_type> > taskColumns(tasks);
+    std::vector<std::vector<index_type> > taskSizes(tasks);
+
+    Parallel::RunRange(num_rows, tasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
+    {
+      std::vector<index_type> columns;
+      for (VMesh::index_type idx = begin; idx < end; idx++)
+      {
+        columns.clear();
+        row(idx, columns);
+        std::sort(columns.begin(), columns.end());
+        columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+        taskColumns[task].insert(taskColumns[task].end(), columns.begin(), columns.end());
+        taskSizes[task].push_back(columns.size());
+      }
+    });
+
+    std::vector<index_type> taskStart(tasks + 1, 0);
+    for (int task = 0; task < tasks; task++)
+      taskStart[task + 1] = taskStart[task] + taskColumns[task].size();
+
+    auto matrix = boost::make_shared<SparseRowMatrix>(num_rows, num_rows);
+    matrix->resizeNonZeros(taskStart[tasks]);
+    auto outer = matrix->outerIndexPtr();
+    auto inner = matrix->innerIndexPtr();
+    auto values = matrix->valuePtr();
+    outer[0] = 0;
+
+    Parallel::RunRange(num_rows, tasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
+    {
+      index_type next = taskStart[task];
+      VMesh::index_type idx = begin;
+      for (size_t j = 0; j < taskSizes[task].size(); j++)
+        outer[++idx] = (next += taskSizes[task][j]);
+      std::copy(taskColumns[task].begin(), taskColumns[task].end(), inner + taskStart[task]);
+      std::fill(values + taskStart[task], values + taskStart[task + 1], 0.0);
+    });
+
+    return matrix;
+  }
+}
+
+SparseRowMatrixHandle MeshSmoother::uniformLaplacian(VMesh* mesh)
+{
+  mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+
+  auto laplacian = buildRows(mesh->num_nodes(), [mesh](VMesh::index_type idx, std::vector<index_type>& columns)
+  {
+    VMesh::Node::array_type neighbors;
+    mesh->get_neighbors(neighbors, VMesh::Node::index_type(idx));
+    if (neighbors.empty()) return;
+    columns.assign(neighbors.begin(), neighbors.end());
+    columns.push_back(idx);
+  });
+
+  const VMesh::size_type num_nodes = mesh->num_nodes();
+  const int tasks = Parallel::NumTasks(num_nodes);
+  Parallel::RunRange(num_nodes, tasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    for (VMesh::index_type idx = begin; idx < end; idx++)
+    {
+      const double w = 1.0 / (laplacian->outerIndexPtr()[idx + 1] - laplacian->outerIndexPtr()[idx] - 1);
+      for (SparseRowMatrix::InnerIterator it(*laplacian, idx); it; ++it)
+        it.valueRef() = (it.index() == idx) ? -1.0 : w;
+    }
+  });
+
+  return laplacian;
+}
+
+SparseRowMatrixHandle MeshSmoother::elementStencil(VMesh* mesh)
+{
+  mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+
+  return buildRows(mesh->num_nodes(), [mesh](VMesh::index_type idx, std::vector<index_type>& columns)
+  {
+    VMesh::Elem::array_type elems;
+    VMesh::Node::array_type nodes;
+    mesh->get_elems(elems, VMesh::Node::index_type(idx));
+    for (size_t j = 0; j < elems.size(); j++)
+    {
+      mesh->get_nodes(nodes, elems[j]);
+      columns.insert(columns.end(), nodes.begin(), nodes.end());
+    }
+    columns.push_back(idx);
+  });
+}
+
+void MeshSmoother::displacements(const SparseRowMatrix& laplacian, const Point* points, std::vector<Vector>& disp)
+{
+  const VMesh::size_type num_nodes = laplacian.rows();
+  const int tasks = Parallel::NumTasks(num_nodes);
+  disp.resize(num_nodes);
+  Parallel::RunRange(num_nodes, tasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    for (VMesh::index_type idx = begin; idx < end; idx++)
+    {
+      Vector d(0.0, 0.0, 0.0);
+      for (SparseRowMatrix::InnerIterator it(laplacian, idx); it; ++it)
+        d += it.value() * Vector(points[it.index()]);
+      disp[idx] = d;
+    }
+  });
+}
+
+void MeshSmoother::move(Point* points, const std::vector<Vector>& disp, double factor)
+{
+  const VMesh::size_type num_nodes = disp.size();
+  const int tasks = Parallel::NumTasks(num_nodes);
+  Parallel::RunRange(num_nodes, tasks, [&](int, VMesh::index_type begin, VMesh::index_type end)
+  {
+    for (VMesh::index_type idx = begin; idx < end; idx++)
+      points[idx] = points[idx] + factor * disp[idx];
+  });
+}
+
+bool MeshSmoother::implicitStep(const SparseRowMatrix& laplacian, Point* points,
+  double factor, double tolerance, int maxIterations)
+{
+  const VMesh::size_type num_nodes = laplacian.rows();
+  SparseRowMatrix identity(num_nodes, num_nodes);
+  identity.setIdentity();
+  auto system = boost::make_shared<SparseRowMatrix>(identity - factor * laplacian);
+
+  SolveLinearSystemAlgorithm solver;
+  for (int c = 0; c < 3; c++)
+  {
+    auto rhs = boost::make_shared<DenseColumnMatrix>(num_nodes);
+    for (VMesh::index_type idx = 0; idx < num_nodes; idx++)
+      (*rhs)[idx] = points[idx][c];
+
+    auto result = solver.run(SolveLinearSystemAlgorithm::Inputs(system, rhs),
+      SolveLinearSystemAlgorithm::Parameters(tolerance, maxIterations, "bicg"));
+    if (std::get<1>(result) > tolerance)
+      return false;
+
+    const DenseColumnMatrix& x = *std::get<0>(result);
+    for (VMesh::index_type idx = 0; idx < num_nodes; idx++)
+      points[idx][c] = x[idx];
+  }
+  return true;
+}
+
+void MeshSmoother::elementNeighbors(VMesh* mesh,
+  std::vector<VMesh::index_type>& offsets, std::vector<VMesh::index_type>& neighbors)
+{
+  const VMesh::size_type num_elems = mesh->num_elems();
+  const int tasks = Parallel::NumTasks(num_elems);
+  std::vector<std::vector<VMesh::index_type> > taskNeighbors(tasks);
+  offsets.resize(num_elems + 1);
+  offsets[0] = 0;
+
+  // offsets first holds the neighbor count of every element
+  Parallel::RunRange(num_elems, tasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
+  {
+    VMesh::Elem::array_type nci;
+    for (VMesh::Elem::index_type idx = begin; idx < end; idx++)
+    {
+      mesh->get_neighbors(nci, idx);
+      taskNeighbors[task].insert(taskNeighbors[task].end(), nci.begin(), nci.end());
+      offsets[idx + 1] = nci.size();
+    }
+  });
+
+  for (VMesh::index_type idx = 0; idx < num_elems; idx++)
+    offsets[idx + 1] += offsets[idx];
+
+  neighbors.resize(offsets[num_elems]);
+  Parallel::RunRange(num_elems, tasks, [&](int task, VMesh::index_type begin, VMesh::index_type end)
+  {
+    std::copy(taskNeighbors[task].begin(), taskNeighbors[task].end(),
+      neighbors.begin() + offsets[begin]);
+  });
+}
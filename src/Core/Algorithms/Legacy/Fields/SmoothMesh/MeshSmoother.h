@@ -0,0 +1,81 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_FIELDS_SMOOTHMESH_MESHSMOOTHER_H
+#define CORE_ALGORITHMS_FIELDS_SMOOTHMESH_MESHSMOOTHER_H 1
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/MatrixFwd.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <vector>
+
+#include <Core/Algorithms/Legacy/Fields/share.h>
+
+namespace SCIRun {
+  namespace Core {
+    namespace Algorithms {
+      namespace Fields {
+
+/// Smoothing operators over the nodes or elements of a mesh. The operator is
+/// built once as a sparse matrix whose row i gives the displacement of node i:
+/// the weights of its neighbors and minus their sum on the diagonal. Every
+/// smoothing iteration is then one matrix product over parallel row ranges.
+class SCISHARE MeshSmoother
+{
+public:
+  /// Equal weights over the edge neighbors of every node. Nodes without
+  /// neighbors get an empty row and stay where they are.
+  static Datatypes::SparseRowMatrixHandle uniformLaplacian(VMesh* mesh);
+
+  /// Every node with all the nodes it shares an element with, and zero
+  /// values, for weights that follow the geometry and are set per iteration.
+  static Datatypes::SparseRowMatrixHandle elementStencil(VMesh* mesh);
+
+  /// disp = laplacian * points.
+  static void displacements(const Datatypes::SparseRowMatrix& laplacian,
+    const Geometry::Point* points, std::vector<Geometry::Vector>& disp);
+
+  /// points += factor * disp.
+  static void move(Geometry::Point* points, const std::vector<Geometry::Vector>& disp, double factor);
+
+  /// Backward Euler step: solves (I - factor * laplacian) x = points for
+  /// every coordinate with BiCGSTAB. Returns false if a solve failed.
+  static bool implicitStep(const Datatypes::SparseRowMatrix& laplacian,
+    Geometry::Point* points, double factor, double tolerance, int maxIterations);
+
+  /// Neighbors of every element, in the order VMesh::get_neighbors lists them:
+  /// element e has neighbors[offsets[e]] up to neighbors[offsets[e+1]].
+  /// The mesh needs to be synchronized with ELEM_NEIGHBORS_E.
+  static void elementNeighbors(VMesh* mesh,
+    std::vector<VMesh::index_type>& offsets, std::vector<VMesh::index_type>& neighbors);
+};
+
+      }}}}
+
+#endif
@@ -0,0 +1,285 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Legacy/FiniteElements/LeadField/BuildLeadField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <numeric>
+#include <sstream>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::FiniteElements;
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+ALGORITHM_PARAMETER_DEF(FiniteElements, ReferenceNode);
+ALGORITHM_PARAMETER_DEF(FiniteElements, AverageReference);
+
+const AlgorithmInputName BuildLeadFieldAlgo::FEM_Stiffness_Matrix("FEM_Stiffness_Matrix");
+const AlgorithmInputName BuildLeadFieldAlgo::FEM_Mesh("FEM_Mesh");
+const AlgorithmInputName BuildLeadFieldAlgo::Electrode_Nodes("Electrode_Nodes");
+const AlgorithmInputName BuildLeadFieldAlgo::Dipole_Positions("Dipole_Positions");
+const AlgorithmOutputName BuildLeadFieldAlgo::LeadField("LeadField");
+
+namespace
+{
+  // Electrodes solved together: a block shares one pass over the factors.
+  const int electrodesPerBlock = 16;
+
+  // Jacobi preconditioned conjugate gradients. The inverse diagonal is shared by
+  // all solves; everything else is local, so solves may run concurrently.
+  bool preconditionedCG(const SparseRowMatrix& A, const Eigen::VectorXd& inverseDiagonal,
+    const Eigen::VectorXd& b, Eigen::VectorXd& x, double targetError, int maxIterations)
+  {
+    x.setZero(b.size());
+    const double bnorm = b.norm();
+    if (bnorm == 0)
+      return true;
+
+    Eigen::VectorXd r = b;
+    Eigen::VectorXd z = inverseDiagonal.cwiseProduct(r);
+    Eigen::VectorXd p = z;
+    Eigen::VectorXd Ap(b.size());
+    double rz = r.dot(z);
+    for (int iteration = 0; iteration < maxIterations; ++iteration)
+    {
+      Ap.noalias() = A * p;
+      const double alpha = rz / p.dot(Ap);
+      x += alpha * p;
+      r -= alpha * Ap;
+      if (r.norm() <= targetError * bnorm)
+        return true;
+      z = inverseDiagonal.cwiseProduct(r);
+      const double rzNext = r.dot(z);
+      p = z + (rzNext / rz) * p;
+      rz = rzNext;
+    }
+    return false;
+  }
+}
+
+BuildLeadFieldAlgo::BuildLeadFieldAlgo() : groundedReference_(-1)
+{
+  addParameter(Parameters::ReferenceNode, 0);
+  addParameter(Parameters::AverageReference, false);
+  addOption(Variables::Method, "ldlt", "ldlt|cg");
+  addParameter(Variables::TargetError, 1e-10);
+  addParameter(Variables::MaxIterations, 5000);
+}
+
+SparseRowMatrixHandle BuildLeadFieldAlgo::dipoleSources(FieldHandle mesh, FieldHandle sources) const
+{
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(mesh, "No mesh");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(sources, "No dipole positions");
+
+  VMesh* vmesh = mesh->vmesh();
+  VMesh* smesh = sources->vmesh();
+  vmesh->synchronize(Mesh::ELEM_LOCATE_E);
+
+  const index_type numSources = smesh->num_nodes();
+  const int dim = vmesh->dimensionality();
+  VMesh::Elem::index_type elem;
+  VMesh::coords_type coords;
+  VMesh::Node::array_type nodes;
+  std::vector<double> dweights;
+  double Ji[9];
+  std::vector<SparseRowMatrix::Triplet> entries;
+
+  // A dipole d at a point of element e drives node i with grad(phi_i) . d, the
+  // same right-hand side ApplyFEMCurrentSource builds for a single dipole.
+  for (index_type k = 0; k < numSources; ++k)
+  {
+    Point pos;
+    smesh->get_center(pos, VMesh::Node::index_type(k));
+    if (!vmesh->locate(elem, coords, pos))
+    {
+      std::ostringstream ostr;
+      ostr << "Dipole position " << k << " is outside the mesh";
+      THROW_ALGORITHM_PROCESSING_ERROR(ostr.str());
+    }
+
+    vmesh->inverse_jacobian(coords, elem, Ji);
+    vmesh->get_derivate_weights(coords, dweights, 1);
+    vmesh->get_nodes(nodes, elem);
+    const int numNodes = static_cast<int>(nodes.size());
+
+    for (int i = 0; i < numNodes; ++i)
+    {
+      for (int d = 0; d < 3; ++d)
+      {
+        double grad = 0;
+        for (int m = 0; m < dim; ++m)
+          grad += dweights[i + m * numNodes] * Ji[3 * d + m];
+        entries.emplace_back(nodes[i], 3 * k + d, grad);
+      }
+    }
+  }
+
+  auto rhs = boost::make_shared<SparseRowMatrix>(vmesh->num_nodes(), 3 * numSources);
+  rhs->setFromTriplets(entries.begin(), entries.end());
+  return rhs;
+}
+
+DenseMatrixHandle BuildLeadFieldAlgo::run(SparseRowMatrixHandle stiffness, FieldHandle mesh,
+  DenseMatrixHandle electrodes, FieldHandle sources) const
+{
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(stiffness, "No stiffness matrix");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(mesh, "No mesh");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(electrodes, "No electrode nodes");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(sources, "No dipole positions");
+
+  const index_type numNodes = stiffness->nrows();
+  if (stiffness->ncols() != numNodes)
+    THROW_ALGORITHM_INPUT_ERROR("Stiffness matrix is not square");
+  if (mesh->vmesh()->num_nodes() != numNodes)
+    THROW_ALGORITHM_INPUT_ERROR("Stiffness matrix and mesh have different numbers of nodes");
+
+  const index_type reference = get(Parameters::ReferenceNode).toInt();
+  if (reference < 0 || reference >= numNodes)
+    THROW_ALGORITHM_INPUT_ERROR("Reference node is not a node of the mesh");
+
+  // Electrode nodes may come as a row or a column.
+  const int numElectrodes = static_cast<int>(electrodes->size());
+  std::vector<index_type> electrodeNodes(numElectrodes);
+  for (int e = 0; e < numElectrodes; ++e)
+  {
+    electrodeNodes[e] = static_cast<index_type>(electrodes->data()[e]);
+    if (electrodeNodes[e] < 0 || electrodeNodes[e] >= numNodes)
+      THROW_ALGORITHM_INPUT_ERROR("Electrode node is not a node of the mesh");
+  }
+
+  auto sourceRHS = dipoleSources(mesh, sources);
+
+  // Grounding the reference node removes the constant null space of the pure
+  // Neumann problem: its row and column are cleared and its diagonal set to one.
+  if (stiffness_.lock() != stiffness || groundedReference_ != reference)
+  {
+    grounded_ = boost::make_shared<SparseRowMatrix>(*stiffness);
+    grounded_->prune([reference](index_type row, index_type col, double)
+      { return row == col || (row != reference && col != reference); });
+    grounded_->coeffRef(reference, reference) = 1;
+    grounded_->makeCompressed();
+    stiffness_ = stiffness;
+    groundedReference_ = reference;
+  }
+  const SparseRowMatrix& A = *grounded_;
+
+  const std::string method = getOption(Variables::Method);
+  Eigen::VectorXd inverseDiagonal;
+  if (method == "ldlt")
+  {
+    auto reuse = directSolver_.factor(grounded_);
+    std::ostringstream ostr;
+    if (reuse == SparseDirectSolver::Reuse::FACTORS)
+      ostr << "Reused LDLT factorization";
+    else
+      ostr << (reuse == SparseDirectSolver::Reuse::SYMBOLIC ? "Refactored LDLT with the cached ordering" : "Computed LDLT factorization");
+    ostr << ": " << directSolver_.factorNonZeros() << " nonzeros in L, "
+      << directSolver_.factorBytes() / (1024.0 * 1024.0) << " MB";
+    remark(ostr.str());
+  }
+  else if (method == "cg")
+    inverseDiagonal = A.diagonal().cwiseInverse();
+  else
+    THROW_ALGORITHM_PROCESSING_ERROR("Unknown solver method");
+
+  const double targetError = get(Variables::TargetError).toDouble();
+  const int maxIterations = get(Variables::MaxIterations).toInt();
+
+  // By reciprocity the potential at electrode e due to source b equals
+  // phi_e . b, where phi_e solves A phi_e = unit current at e, sunk at the reference.
+  auto leadField = boost::make_shared<DenseMatrix>(numElectrodes, sourceRHS->ncols());
+  const int numBlocks = (numElectrodes + electrodesPerBlock - 1) / electrodesPerBlock;
+  const int tasks = Parallel::NumTasks(numBlocks, 1);
+  std::vector<int> unconverged(tasks, 0);
+  Parallel::RunRange(numBlocks, tasks, [&](int task, size_t begin, size_t end)
+  {
+    DenseMatrix currents, potentials;
+    Eigen::VectorXd x;
+    for (int block = static_cast<int>(begin); block < static_cast<int>(end); ++block)
+    {
+      const int first = block * electrodesPerBlock;
+      const int width = std::min(electrodesPerBlock, numElectrodes - first);
+      currents = DenseMatrix::Zero(numNodes, width);
+      for (int e = 0; e < width; ++e)
+        if (electrodeNodes[first + e] != reference)
+          currents(electrodeNodes[first + e], e) = 1;
+
+      if (method == "ldlt")
+        directSolver_.solve(currents, potentials);
+      else
+      {
+        potentials.resize(numNodes, width);
+        for (int e = 0; e < width; ++e)
+        {
+          if (!preconditionedCG(A, inverseDiagonal, currents.col(e), x, targetError, maxIterations))
+            ++unconverged[task];
+          potentials.col(e) = x;
+        }
+      }
+      leadField->middleRows(first, width).noalias() = potentials.transpose() * *sourceRHS;
+    }
+  });
+
+  const int failed = std::accumulate(unconverged.begin(), unconverged.end(), 0);
+  if (failed > 0)
+  {
+    std::ostringstream ostr;
+    ostr << failed << " electrode solves did not reach the target error";
+    warning(ostr.str());
+  }
+
+  if (get(Parameters::AverageReference).toBool())
+    leadField->rowwise() -= leadField->colwise().mean();
+
+  return leadField;
+}
+
+AlgorithmOutput BuildLeadFieldAlgo::run(const AlgorithmInput& input) const
+{
+  auto stiffness = input.get<SparseRowMatrix>(FEM_Stiffness_Matrix);
+  auto mesh = input.get<Field>(FEM_Mesh);
+  auto electrodes = input.get<DenseMatrix>(Electrode_Nodes);
+  auto sources = input.get<Field>(Dipole_Positions);
+
+  AlgorithmOutput output;
+  output[LeadField] = run(stiffness, mesh, electrodes, sources);
+  return output;
+}
@@ -0,0 +1,88 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_FINITEELEMENTS_BUILDLEADFIELD_H
+#define CORE_ALGORITHMS_FINITEELEMENTS_BUILDLEADFIELD_H 1
+
+#include <Core/Datatypes/MatrixFwd.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Algorithms/Math/LinearSystem/SparseDirectSolver.h>
+#include <boost/weak_ptr.hpp>
+#include <Core/Algorithms/Legacy/FiniteElements/share.h>
+
+namespace SCIRun {
+	namespace Core {
+		namespace Algorithms {
+			namespace FiniteElements {
+
+  ALGORITHM_PARAMETER_DECL(ReferenceNode);
+  ALGORITHM_PARAMETER_DECL(AverageReference);
+
+/// Builds the EEG lead field of a set of electrodes with the reciprocity principle.
+/// Instead of one forward solve per dipole, a unit current is injected at each
+/// electrode and sunk at the reference node; the potential of that solve, paired
+/// with the dipole right-hand sides, gives one row of the lead field. The cost
+/// scales with the number of electrodes rather than the number of sources.
+/// Row i is also the gradient of the tDCS potential of electrode i at the dipole
+/// positions, so the same output serves as a stimulation field matrix.
+///
+/// The output has one row per electrode and three columns (x, y, z) per source
+/// node. Potentials are relative to the reference node, or to the electrode
+/// average when AverageReference is set.
+class SCISHARE BuildLeadFieldAlgo : public AlgorithmBase
+{
+  public:
+    static const AlgorithmInputName FEM_Stiffness_Matrix;
+    static const AlgorithmInputName FEM_Mesh;
+    static const AlgorithmInputName Electrode_Nodes;
+    static const AlgorithmInputName Dipole_Positions;
+    static const AlgorithmOutputName LeadField;
+
+    BuildLeadFieldAlgo();
+
+    Datatypes::DenseMatrixHandle run(Datatypes::SparseRowMatrixHandle stiffness, FieldHandle mesh,
+      Datatypes::DenseMatrixHandle electrodes, FieldHandle sources) const;
+    AlgorithmOutput run(const AlgorithmInput &) const override;
+
+    /// Right-hand sides of unit dipoles at the nodes of sources: column 3k+d is the
+    /// dipole at node k pointing along axis d.
+    Datatypes::SparseRowMatrixHandle dipoleSources(FieldHandle mesh, FieldHandle sources) const;
+
+  private:
+    // The grounded stiffness matrix is kept with the factorization, so running
+    // again with the same stiffness matrix reuses the factors.
+    mutable boost::weak_ptr<Datatypes::SparseRowMatrix> stiffness_;
+    mutable index_type groundedReference_;
+    mutable Datatypes::SparseRowMatrixHandle grounded_;
+    mutable Math::SparseDirectSolver directSolver_;
+};
+
+			}}}}
+#endif
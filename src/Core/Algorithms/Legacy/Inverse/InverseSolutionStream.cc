@@ -0,0 +1,96 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Legacy/Inverse/InverseSolutionStream.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Utils/Exception.h>
+#include <algorithm>
+#include <future>
+
+using namespace SCIRun;
+using namespace SCIRun::Core;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Inverse;
+
+void DenseMatrixSolutionSink::write( index_type firstColumn, const DenseMatrix& columns )
+{
+	solution_.middleCols(firstColumn, columns.ncols()) = columns;
+}
+
+RawFileSolutionSink::RawFileSolutionSink( const std::string& filename ) : filename_(filename), file_(filename, std::ios::binary), columnsWritten_(0)
+{
+	if (!file_)
+		BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Could not open file for writing: " + filename_));
+}
+
+void RawFileSolutionSink::write( index_type firstColumn, const DenseMatrix& columns )
+{
+	if (firstColumn != columnsWritten_)
+		BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Inverse solution blocks must be written in order to " + filename_));
+
+	// DenseMatrix is row-major: the block is transposed into time-sample order before writing.
+	const Eigen::MatrixXd samples = columns;
+	file_.write(reinterpret_cast<const char*>(samples.data()), samples.size() * sizeof(double));
+	file_.flush();
+	if (!file_)
+		BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Failed writing the inverse solution to " + filename_));
+	columnsWritten_ += columns.ncols();
+}
+
+InverseSolutionStream::InverseSolutionStream( DenseMatrixHandle inverseOperator, index_type chunkColumns ) :
+	inverseOperator_(inverseOperator), chunkColumns_(chunkColumns)
+{
+	if (!inverseOperator_ || chunkColumns_ <= 0)
+		BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Streaming the inverse solution needs an inverse operator and a positive chunk size."));
+}
+
+void InverseSolutionStream::apply( const DenseMatrix& measuredData, InverseSolutionSink& sink ) const
+{
+	if (inverseOperator_->ncols() != measuredData.nrows())
+		BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Inverse operator and measured data dimensions do not agree."));
+
+	const index_type numColumns = measuredData.ncols();
+	DenseMatrix blocks[2];
+	std::future<void> pendingWrite;
+	int current = 0;
+	for (index_type first = 0; first < numColumns; first += chunkColumns_, current = 1 - current)
+	{
+		const index_type width = std::min(chunkColumns_, numColumns - first);
+		auto& block = blocks[current];
+		block.noalias() = *inverseOperator_ * measuredData.middleCols(first, width);
+
+		// the previous block has to leave the sink before the next pass computes into its buffer
+		if (pendingWrite.valid())
+			pendingWrite.get();
+		pendingWrite = std::async(std::launch::async, [&sink, &block, first]() { sink.write(first, block); });
+	}
+	if (pendingWrite.valid())
+		pendingWrite.get();
+}
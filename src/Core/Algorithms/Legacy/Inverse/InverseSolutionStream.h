@@ -0,0 +1,89 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef BioPSE_InverseSolutionStream_H__
+#define BioPSE_InverseSolutionStream_H__
+
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Algorithms/Legacy/Inverse/share.h>
+#include <fstream>
+#include <string>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Inverse {
+
+	// Receives the inverse solution a block of time samples at a time, in increasing column order.
+	class SCISHARE InverseSolutionSink
+	{
+	public:
+		virtual ~InverseSolutionSink() {}
+		virtual void write( index_type firstColumn, const Datatypes::DenseMatrix& columns ) = 0;
+	};
+
+	// Copies every block into a preallocated sources x time samples matrix.
+	class SCISHARE DenseMatrixSolutionSink : public InverseSolutionSink
+	{
+	public:
+		explicit DenseMatrixSolutionSink( Datatypes::DenseMatrix& solution ) : solution_(solution) {}
+		void write( index_type firstColumn, const Datatypes::DenseMatrix& columns ) override;
+	private:
+		Datatypes::DenseMatrix& solution_;
+	};
+
+	// Appends every block to a raw binary file of doubles in column-major order, with no header:
+	// each time sample is one contiguous run of source values, so the file grows sample by sample.
+	class SCISHARE RawFileSolutionSink : public InverseSolutionSink
+	{
+	public:
+		explicit RawFileSolutionSink( const std::string& filename );
+		void write( index_type firstColumn, const Datatypes::DenseMatrix& columns ) override;
+	private:
+		std::string filename_;
+		std::ofstream file_;
+		index_type columnsWritten_;
+	};
+
+	// Applies an inverse operator to the measured data in blocks of time samples. At most two solution
+	// blocks exist at once: the next block is computed while the sink writes the previous one.
+	class SCISHARE InverseSolutionStream
+	{
+	public:
+		InverseSolutionStream( Datatypes::DenseMatrixHandle inverseOperator, index_type chunkColumns );
+		void apply( const Datatypes::DenseMatrix& measuredData, InverseSolutionSink& sink ) const;
+	private:
+		Datatypes::DenseMatrixHandle inverseOperator_;
+		index_type chunkColumns_;
+	};
+
+}}}}
+
+#endif
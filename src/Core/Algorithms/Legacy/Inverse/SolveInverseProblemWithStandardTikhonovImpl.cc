@@ -90,6 +90,18 @@ using namespace SCIRun::Core::Algorithms::Inverse;
 //////// fi compute inverse solution
 ////////////////////////
 
+/////////////////////////
+///////// compute Inverse operator
+    DenseMatrix SolveInverseProblemWithStandardTikhonovImpl::computeInverseOperator( double lambda ) const
+    {
+        //      A^-1 = M3 * G^-1 * M4, applied to the measured data (y = M4 * measuredData above)
+        DenseMatrix G = M1 + lambda * lambda * M2;
+        DenseMatrix inverseOperator = M3 * G.lu().solve(M4);
+        return inverseOperator;
+    }
+//////// fi compute inverse operator
+////////////////////////
+
 /////// precomputeInverseMatrices
 ///////////////
     void SolveInverseProblemWithStandardTikhonovImpl::preAlocateInverseMatrices(const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix_, const SCIRun::Core::Datatypes::DenseMatrix& measuredData_ , const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting_, const int regularizationChoice_, const int regularizationSolutionSubcase_, const int regularizationResidualSubcase_)
@@ -212,7 +224,7 @@ using namespace SCIRun::Core::Algorithms::Inverse;
             M3 = RAtr;
 
             // DEFINE M4 = identity (size of number of measurements)
-            M4 = DenseMatrix::Identity(M, N);
+            M4 = DenseMatrix::Identity(M, M);
 
             // DEFINE measurement vector
             y = measuredData_;
@@ -83,8 +83,9 @@ void SolveInverseProblemWithTSVD_impl::preAlocateInverseMatrices(const SCIRun::C
 void SolveInverseProblemWithTSVD_impl::preAlocateInverseMatrices(const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix_, const SCIRun::Core::Datatypes::DenseMatrix& measuredData_ , const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting_)
 {
 
-	    // Compute the SVD of the forward matrix
-	        Eigen::JacobiSVD<SCIRun::Core::Datatypes::DenseMatrix::EigenBase> SVDdecomposition( forwardMatrix_, Eigen::ComputeFullU | Eigen::ComputeFullV);
+	    // Compute the SVD of the forward matrix. Only the first min(M,N) singular vectors take part
+	    // in the solution, so the thin factors suffice; the full V alone would be N x N.
+	        Eigen::JacobiSVD<SCIRun::Core::Datatypes::DenseMatrix::EigenBase> SVDdecomposition( forwardMatrix_, Eigen::ComputeThinU | Eigen::ComputeThinV);
 
 		// alocate the left and right singular vectors and the singular values
 			svd_MatrixU = SVDdecomposition.matrixU();
@@ -105,7 +106,7 @@ SCIRun::Core::Datatypes::DenseMatrix SolveInverseProblemWithTSVD_impl::computeIn
 {
 
     // prealocate matrices
-        const int N = svd_MatrixV.cols();
+        const int N = svd_MatrixV.rows();
         const int M = svd_MatrixU.rows();
         const int numTimeSamples = Uy.ncols();
         DenseMatrix solution(DenseMatrix::Zero(N,numTimeSamples));
@@ -135,6 +136,35 @@ SCIRun::Core::Datatypes::DenseMatrix SolveInverseProblemWithTSVD_impl::computeIn
         return solution;
 }
 
+//////////////////////////////////////////////////////////////////////
+// TSVD filter factors: 1/s up to the truncation point, zero after it
+//////////////////////////////////////////////////////////////////////
+void SolveInverseProblemWithTSVD_impl::computeFilterFactors( double truncationPoint, DenseColumnMatrix& filterFactors ) const
+{
+    const int truncation = Min( int(truncationPoint), rank, int(9999999999999) );
+    for (int rr=0; rr<rank ; rr++)
+        filterFactors[rr] = rr < truncation ? 1 / svd_SingularValues[rr] : 0;
+}
+
+//////////////////////////////////////////////////////////////////////
+// L-curve norms from the filter factors, without forming the solutions
+//////////////////////////////////////////////////////////////////////
+void SolveInverseProblemWithTSVD_impl::computeLcurveNorms( const std::vector<double>& lambdaArray, const DenseMatrix& forwardMatrix, const DenseMatrix& measuredData,
+    DenseMatrixHandle sourceWeighting, DenseMatrixHandle sensorWeighting, std::vector<double>& rho, std::vector<double>& eta ) const
+{
+    auto filter = [this]( double lambda, DenseColumnMatrix& filterFactors ) { computeFilterFactors( lambda, filterFactors ); };
+    computeFilteredLcurveNorms( lambdaArray, rank, filter, svd_MatrixV, Uy, forwardMatrix, measuredData, sourceWeighting, sensorWeighting, rho, eta );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Inverse operator from the filter factors
+//////////////////////////////////////////////////////////////////////
+DenseMatrix SolveInverseProblemWithTSVD_impl::computeInverseOperator( double truncationPoint ) const
+{
+    auto filter = [this]( double lambda, DenseColumnMatrix& filterFactors ) { computeFilterFactors( lambda, filterFactors ); };
+    return computeFilteredInverseOperator( truncationPoint, rank, filter, svd_MatrixU, svd_MatrixV );
+}
+
 //////////////////////////////////////////////////////////////////////
 // THIS FUNCTION returns a string of lambdas from which the L-curve is computed
 //////////////////////////////////////////////////////////////////////
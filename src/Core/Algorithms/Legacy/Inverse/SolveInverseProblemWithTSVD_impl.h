@@ -83,6 +83,11 @@ namespace Inverse {
 
                         SCIRun::Core::Datatypes::DenseMatrix computeInverseSolution( double truncationPoint, bool inverseCalculation) const override;
 				std::vector<double> computeLambdaArray( double lambdaMin, double lambdaMax, int nLambda ) const override;
+				void computeLcurveNorms( const std::vector<double>& lambdaArray, const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix,
+					const SCIRun::Core::Datatypes::DenseMatrix& measuredData, SCIRun::Core::Datatypes::DenseMatrixHandle sourceWeighting,
+					SCIRun::Core::Datatypes::DenseMatrixHandle sensorWeighting, std::vector<double>& rho, std::vector<double>& eta ) const override;
+				SCIRun::Core::Datatypes::DenseMatrix computeInverseOperator( double truncationPoint ) const override;
+				void computeFilterFactors( double truncationPoint, SCIRun::Core::Datatypes::DenseColumnMatrix& filterFactors ) const;
 		        //      bool checkInputMatrixSizes(); // DEFINED IN PARENT, MIGHT WANT TO OVERRIDE SOME OTHER TIME
 
 
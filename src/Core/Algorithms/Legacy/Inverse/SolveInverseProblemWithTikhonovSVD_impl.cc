@@ -80,8 +80,9 @@ void SolveInverseProblemWithTikhonovSVD_impl::preAlocateInverseMatrices(const SC
 void SolveInverseProblemWithTikhonovSVD_impl::preAlocateInverseMatrices(const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix_, const SCIRun::Core::Datatypes::DenseMatrix& measuredData_ , const SCIRun::Core::Datatypes::DenseMatrix& sourceWeighting_, const SCIRun::Core::Datatypes::DenseMatrix& sensorWeighting_)
 {
 
-	    // Compute the SVD of the forward matrix
-	        Eigen::JacobiSVD<SCIRun::Core::Datatypes::DenseMatrix::EigenBase> SVDdecomposition( forwardMatrix_, Eigen::ComputeFullU | Eigen::ComputeFullV);
+	    // Compute the SVD of the forward matrix. Only the first min(M,N) singular vectors take part
+	    // in the solution, so the thin factors suffice; the full V alone would be N x N.
+	        Eigen::JacobiSVD<SCIRun::Core::Datatypes::DenseMatrix::EigenBase> SVDdecomposition( forwardMatrix_, Eigen::ComputeThinU | Eigen::ComputeThinV);
 
 		// alocate the left and right singular vectors and the singular values
 			svd_MatrixU = SVDdecomposition.matrixU();
@@ -102,7 +103,7 @@ SCIRun::Core::Datatypes::DenseMatrix SolveInverseProblemWithTikhonovSVD_impl::co
 {
 
     // prealocate matrices
-        const int N = svd_MatrixV.cols();
+        const int N = svd_MatrixV.rows();
         const int M = svd_MatrixU.rows();
         const int numTimeSamples = Uy.ncols();
         DenseMatrix solution(DenseMatrix::Zero(N,numTimeSamples));
@@ -129,3 +130,34 @@ SCIRun::Core::Datatypes::DenseMatrix SolveInverseProblemWithTikhonovSVD_impl::co
 
         return solution;
 }
+
+//////////////////////////////////////////////////////////////////////
+// Tikhonov filter factors s / (lambda^2 + s^2)
+//////////////////////////////////////////////////////////////////////
+void SolveInverseProblemWithTikhonovSVD_impl::computeFilterFactors( double lambda, DenseColumnMatrix& filterFactors ) const
+{
+    for (int rr=0; rr<rank ; rr++)
+    {
+        double singVal = svd_SingularValues[rr];
+        filterFactors[rr] = singVal / ( lambda * lambda + singVal * singVal );
+    }
+}
+
+//////////////////////////////////////////////////////////////////////
+// L-curve norms from the filter factors, without forming the solutions
+//////////////////////////////////////////////////////////////////////
+void SolveInverseProblemWithTikhonovSVD_impl::computeLcurveNorms( const std::vector<double>& lambdaArray, const DenseMatrix& forwardMatrix, const DenseMatrix& measuredData,
+    DenseMatrixHandle sourceWeighting, DenseMatrixHandle sensorWeighting, std::vector<double>& rho, std::vector<double>& eta ) const
+{
+    auto filter = [this]( double lambda, DenseColumnMatrix& filterFactors ) { computeFilterFactors( lambda, filterFactors ); };
+    computeFilteredLcurveNorms( lambdaArray, rank, filter, svd_MatrixV, Uy, forwardMatrix, measuredData, sourceWeighting, sensorWeighting, rho, eta );
+}
+
+//////////////////////////////////////////////////////////////////////
+// Inverse operator from the filter factors
+//////////////////////////////////////////////////////////////////////
+DenseMatrix SolveInverseProblemWithTikhonovSVD_impl::computeInverseOperator( double lambda ) const
+{
+    auto filter = [this]( double lambda, DenseColumnMatrix& filterFactors ) { computeFilterFactors( lambda, filterFactors ); };
+    return computeFilteredInverseOperator( lambda, rank, filter, svd_MatrixU, svd_MatrixV );
+}
@@ -92,6 +92,12 @@ namespace Core {
 
         SCIRun::Core::Datatypes::DenseMatrix computeInverseSolution(
             double lambda, bool inverseCalculation) const override;
+        void computeLcurveNorms(const std::vector<double>& lambdaArray,
+            const Datatypes::DenseMatrix& forwardMatrix, const Datatypes::DenseMatrix& measuredData,
+            Datatypes::DenseMatrixHandle sourceWeighting, Datatypes::DenseMatrixHandle sensorWeighting,
+            std::vector<double>& rho, std::vector<double>& eta) const override;
+        SCIRun::Core::Datatypes::DenseMatrix computeInverseOperator(double lambda) const override;
+        void computeFilterFactors(double lambda, Datatypes::DenseColumnMatrix& filterFactors) const;
         //      bool checkInputMatrixSizes(); // DEFINED IN PARENT, MIGHT WANT TO OVERRIDE SOME
         //      OTHER TIME
       };
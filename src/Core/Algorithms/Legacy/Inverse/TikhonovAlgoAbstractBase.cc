@@ -35,6 +35,8 @@
 #include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithStandardTikhonovImpl.h>
 #include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithTikhonovSVD_impl.h>
 #include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithTSVD_impl.h>
+#include <Core/Algorithms/Legacy/Inverse/InverseSolutionStream.h>
+#include <Core/Algorithms/Math/RandomizedSVD.h>
 
 // Datatypes
 #include <Core/Datatypes/Matrix.h>
@@ -84,6 +86,8 @@ ALGORITHM_PARAMETER_DEF( Inverse, LambdaMax);
 ALGORITHM_PARAMETER_DEF( Inverse, LambdaNum);
 ALGORITHM_PARAMETER_DEF( Inverse, LambdaResolution);
 ALGORITHM_PARAMETER_DEF( Inverse, LambdaSliderValue);
+ALGORITHM_PARAMETER_DEF( Inverse, StreamingChunkSize);
+ALGORITHM_PARAMETER_DEF( Inverse, StreamingOutputFile);
 //ALGORITHM_PARAMETER_DEF( Inverse, LambdaCorner);
 //ALGORITHM_PARAMETER_DEF( Inverse, LCurveText);
 ALGORITHM_PARAMETER_DEF( Inverse, regularizationSolutionSubcase);
@@ -100,8 +104,14 @@ TikhonovAlgoAbstractBase::TikhonovAlgoAbstractBase()
 	addParameter(Parameters::LambdaNum,200);
 	addParameter(Parameters::LambdaResolution,1e-6);
 	addParameter(Parameters::LambdaSliderValue,0);
+	addParameter(Parameters::StreamingChunkSize,0);
+	addParameter(Parameters::StreamingOutputFile,std::string(""));
 	addParameter(Parameters::regularizationSolutionSubcase,solution_constrained);
 	addParameter(Parameters::regularizationResidualSubcase,residual_constrained);
+	addOption(Math::Parameters::SVDMethod, "full", "full|randomized");
+	addParameter(Math::Parameters::SVDRank, 100);
+	addParameter(Math::Parameters::SVDOversampling, 10);
+	addParameter(Math::Parameters::SVDPowerIterations, 2);
 }
 
 ////// CHECK IF INPUT MATRICES HAVE THE CORRECT SIZE
@@ -174,10 +184,11 @@ bool TikhonovAlgoAbstractBase::checkInputMatrixSizes( const AlgorithmInput & inp
 
 AlgorithmOutput TikhonovAlgoAbstractBase::run(const AlgorithmInput & input) const
 {
-	auto forwardMatrix = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::ForwardMatrix));
+	// The implementations factor dense matrices, so sparse and LinearOperator inputs are assembled here.
+	auto forwardMatrix = convertMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::ForwardMatrix));
 	auto measuredData = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::MeasuredPotentials));
-	auto sourceWeighting = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::WeightingInSourceSpace));
-	auto sensorWeighting = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::WeightingInSensorSpace));
+	auto sourceWeighting = convertMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::WeightingInSourceSpace));
+	auto sensorWeighting = convertMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::WeightingInSensorSpace));
 
 	auto RegularizationMethod_gotten = getOption(Parameters::RegularizationMethod);
 	auto implOption = get(Parameters::TikhonovImplementation).toString();
@@ -204,7 +215,13 @@ AlgorithmOutput TikhonovAlgoAbstractBase::run(const AlgorithmInput & input) cons
 		auto matrixV = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::matrixV));
 
 		// If there is a missing matrix from the precomputed SVD input
-		if (!matrixU || !singularValues || !matrixV)
+		if ((!matrixU || !singularValues || !matrixV) && Math::RandomizedSVD::selected(*this))
+		{
+			auto svd = Math::RandomizedSVD::fromParameters(*this);
+			svd.compute(*forwardMatrix);
+			algoImpl = std::make_shared<SolveInverseProblemWithTikhonovSVD_impl>(*forwardMatrix, *measuredData, *sourceWeighting, *sensorWeighting, svd.matrixU(), DenseMatrix(svd.singularValues()), svd.matrixV());
+		}
+		else if (!matrixU || !singularValues || !matrixV)
 			algoImpl = std::make_shared<SolveInverseProblemWithTikhonovSVD_impl>(*forwardMatrix, *measuredData, *sourceWeighting, *sensorWeighting);
 		else
 			algoImpl = std::make_shared<SolveInverseProblemWithTikhonovSVD_impl>(*forwardMatrix, *measuredData, *sourceWeighting, *sensorWeighting, *matrixU, *singularValues, *matrixV);
@@ -217,7 +234,13 @@ AlgorithmOutput TikhonovAlgoAbstractBase::run(const AlgorithmInput & input) cons
 		auto matrixV = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::matrixV));
 
 		// If there is a missing matrix from the precomputed SVD input
-		if (!matrixU || !singularValues || !matrixV)
+		if ((!matrixU || !singularValues || !matrixV) && Math::RandomizedSVD::selected(*this))
+		{
+			auto svd = Math::RandomizedSVD::fromParameters(*this);
+			svd.compute(*forwardMatrix);
+			algoImpl = std::make_shared<SolveInverseProblemWithTSVD_impl>(*forwardMatrix, *measuredData, *sourceWeighting, *sensorWeighting, svd.matrixU(), DenseMatrix(svd.singularValues()), svd.matrixV());
+		}
+		else if (!matrixU || !singularValues || !matrixV)
 			algoImpl = std::make_shared<SolveInverseProblemWithTSVD_impl>(*forwardMatrix, *measuredData, *sourceWeighting, *sensorWeighting);
 		else
 			algoImpl = std::make_shared<SolveInverseProblemWithTSVD_impl>(*forwardMatrix, *measuredData, *sourceWeighting, *sensorWeighting, *matrixU, *singularValues, *matrixV);
@@ -256,11 +279,34 @@ AlgorithmOutput TikhonovAlgoAbstractBase::run(const AlgorithmInput & input) cons
 	}
 
   // compute final inverse solution
-	auto solution = algoImpl->computeInverseSolution(lambda, true);
+  const int chunkSize = get(Parameters::StreamingChunkSize).toInt();
+  if (chunkSize > 0)
+  {
+    // streaming: the inverse operator is formed once and applied to blocks of time samples
+    auto inverseOperator = boost::make_shared<DenseMatrix>(algoImpl->computeInverseOperator(lambda));
+    InverseSolutionStream stream(inverseOperator, chunkSize);
+    auto filename = get(Parameters::StreamingOutputFile).toString();
+    if (filename.empty())
+    {
+      auto solution = boost::make_shared<DenseMatrix>(inverseOperator->nrows(), measuredData->ncols());
+      DenseMatrixSolutionSink sink(*solution);
+      stream.apply(*measuredData, sink);
+      output[InverseSolution] = solution;
+    }
+    else
+    {
+      // the solution only goes to the file, so nothing is sent on the solution port
+      RawFileSolutionSink sink(filename);
+      stream.apply(*measuredData, sink);
+      remark("Inverse solution of " + std::to_string(inverseOperator->nrows()) + " x " + std::to_string(measuredData->ncols()) + " written to " + filename);
+    }
+    output[RegInverse] = inverseOperator;
+  }
+  else
+    output[InverseSolution] = boost::make_shared<DenseMatrix>(algoImpl->computeInverseSolution(lambda, true));
 
 	// Set outputs
 
-	output[InverseSolution] = boost::make_shared<DenseMatrix>(solution);
 	output[RegularizationParameter] = boost::make_shared<DenseMatrix>(1, 1, lambda);
   output[LambdaArray] = lambdamatrix;
   output[Lambda_Index]= boost::make_shared<DenseMatrix>(1, 1, lambda_index);
@@ -270,17 +316,23 @@ AlgorithmOutput TikhonovAlgoAbstractBase::run(const AlgorithmInput & input) cons
 
 double TikhonovAlgoAbstractBase::computeLcurve( const SCIRun::Core::Algorithms::Inverse::TikhonovImpl& algoImpl, const AlgorithmInput & input , DenseMatrixHandle& lambdamatrix, int& lambda_index) const
 {
-	// get inputs
-	auto forwardMatrix = input.get<Matrix>(TikhonovAlgoAbstractBase::ForwardMatrix);
-	auto measuredData = input.get<Matrix>(TikhonovAlgoAbstractBase::MeasuredPotentials);
-	auto sourceWeighting = input.get<Matrix>(TikhonovAlgoAbstractBase::WeightingInSourceSpace);
-	auto sensorWeighting = input.get<Matrix>(TikhonovAlgoAbstractBase::WeightingInSensorSpace);
+	// get inputs, assembled as in run()
+	auto forwardMatrix = convertMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::ForwardMatrix));
+	auto measuredData = castMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::MeasuredPotentials));
+	auto sourceWeighting = convertMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::WeightingInSourceSpace));
+	auto sensorWeighting = convertMatrix::toDense(input.get<Matrix>(TikhonovAlgoAbstractBase::WeightingInSensorSpace));
   // define the step size of the lambda vector to be computed  (distance between min and max divided by number of desired lambdas in log scale)
   const int nLambda = get(Parameters::LambdaNum).toInt();
 	const double lambdaMin = get(Parameters::LambdaMin).toDouble();
 	const double lambdaMax = get(Parameters::LambdaMax).toDouble();
 	double lambda = 0;
 
+  // check that the weighting matrices fit the solution and the residual before the sweep starts
+  if (sourceWeighting && sourceWeighting->ncols() != forwardMatrix->ncols())
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage(" Solution weighting matrix unexpectedly does not fit to compute the weighted solution norm. "));
+  if (sensorWeighting && sensorWeighting->ncols() != forwardMatrix->nrows())
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage(" Data residual weighting matrix unexpectedly does not fit to compute the weighted residual norm. "));
+
 	// prealocate vector of lambdas and eta and rho
   std::vector<double> rho(nLambda, 0.0);
   std::vector<double> eta(nLambda, 0.0);
@@ -289,50 +341,15 @@ double TikhonovAlgoAbstractBase::computeLcurve( const SCIRun::Core::Algorithms::
 
   auto lambdaArray = algoImpl.computeLambdaArray( lambdaMin, lambdaMax, nLambda );
 
-  DenseMatrix CAx, Rx;
-  DenseMatrix solution;
-
   lambdaArray[0] = lambdaMin;
 
-  // for all lambdas
+  // compute rho and eta for all lambdas in parallel. Using Frobenious norm when using matrices.
+  // Only the norms are kept: run() computes the solution for the selected lambda.
+  algoImpl.computeLcurveNorms( lambdaArray, *forwardMatrix, *measuredData, sourceWeighting, sensorWeighting, rho, eta );
+
   for (int j = 0; j < nLambda; j++)
   {
-    solution = algoImpl.computeInverseSolution( lambdaArray[j], false);
     lambdamatrix->put(j,0,lambdaArray[j]);
-
-    // if using source regularization matrix, apply it to compute Rx (for the eta computations)
-    if (sourceWeighting)
-    {
-      if (solution.nrows() == sourceWeighting->ncols()) // check that regularization matrix and solution match sizes
-      {
-        auto sw = castMatrix::toDense(sourceWeighting);
-        Rx = (*sw) * solution;
-      }
-      else
-      {
-        BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage(" Solution weighting matrix unexpectedly does not fit to compute the weighted solution norm. "));
-      }
-    }
-    else
-      Rx = solution;
-
-    auto forward = castMatrix::toDense(forwardMatrix);
-    auto Ax = (*forward) * solution;
-    auto measured = castMatrix::toDense(measuredData);
-    auto residualSolution = Ax - (*measured);
-
-    // if using source regularization matrix, apply it to compute Rx (for the eta computations)
-    if (sensorWeighting)
-    {
-      auto sw = castMatrix::toDense(sensorWeighting);
-      CAx = (*sw) * residualSolution;
-    }
-    else
-      CAx = residualSolution;
-
-    // compute rho and eta. Using Frobenious norm when using matrices
-    rho[j] = CAx.norm();
-    eta[j] = Rx.norm();
     lambdamatrix->put(j,1,rho[j]);
     lambdamatrix->put(j,2,eta[j]);
   }
@@ -54,6 +54,8 @@ namespace Inverse {
 	ALGORITHM_PARAMETER_DECL(LambdaNum);
 	ALGORITHM_PARAMETER_DECL(LambdaResolution);
 	ALGORITHM_PARAMETER_DECL(LambdaSliderValue);
+	ALGORITHM_PARAMETER_DECL(StreamingChunkSize);
+	ALGORITHM_PARAMETER_DECL(StreamingOutputFile);
 	//ALGORITHM_PARAMETER_DECL(LambdaCorner);
 	//ALGORITHM_PARAMETER_DECL(LCurveText);
 
@@ -30,6 +30,25 @@
 
 
 #include <Core/Algorithms/Legacy/Inverse/TikhonovImpl.h>
+#include <Core/Thread/Parallel.h>
+#include <Eigen/QR>
+#include <cmath>
+
+using namespace SCIRun::Core::Algorithms::Inverse;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+	// Orthonormal basis Q and triangular factor T of the thin QR of B, so that B = Q T.
+	void thinQR( const Eigen::MatrixXd& B, Eigen::MatrixXd& Q, Eigen::MatrixXd& T )
+	{
+		const auto k = std::min(B.rows(), B.cols());
+		Eigen::HouseholderQR<Eigen::MatrixXd> qr(B);
+		Q = qr.householderQ() * Eigen::MatrixXd::Identity(B.rows(), k);
+		T = qr.matrixQR().topRows(k).triangularView<Eigen::Upper>();
+	}
+}
 
 
 	// default lambda step. Can ve overriden if necessary (see TSVD as reference)
@@ -46,3 +65,87 @@
 
 		return lambdaArray;
 	}
+
+	void TikhonovImpl::computeLcurveNorms( const std::vector<double>& lambdaArray, const DenseMatrix& forwardMatrix, const DenseMatrix& measuredData,
+		DenseMatrixHandle sourceWeighting, DenseMatrixHandle sensorWeighting, std::vector<double>& rho, std::vector<double>& eta ) const
+	{
+		const int nLambda = static_cast<int>(lambdaArray.size());
+		rho.assign(nLambda, 0.0);
+		eta.assign(nLambda, 0.0);
+
+		Parallel::RunRange(nLambda, Parallel::NumTasks(nLambda, 1), [&](int, size_t begin, size_t end)
+		{
+			DenseMatrix::EigenBase residual, weighted;
+			for (size_t j = begin; j < end; j++)
+			{
+				auto solution = computeInverseSolution(lambdaArray[j], false);
+
+				residual.noalias() = forwardMatrix * solution;
+				residual -= measuredData;
+				if (sensorWeighting)
+				{
+					weighted.noalias() = *sensorWeighting * residual;
+					rho[j] = weighted.norm();
+				}
+				else
+					rho[j] = residual.norm();
+
+				if (sourceWeighting)
+				{
+					weighted.noalias() = *sourceWeighting * solution;
+					eta[j] = weighted.norm();
+				}
+				else
+					eta[j] = solution.norm();
+			}
+		});
+	}
+
+	void TikhonovImpl::computeFilteredLcurveNorms( const std::vector<double>& lambdaArray, int rank, const FilterFunction& filter,
+		const DenseMatrix& matrixV, const DenseMatrix& Uy, const DenseMatrix& forwardMatrix, const DenseMatrix& measuredData,
+		DenseMatrixHandle sourceWeighting, DenseMatrixHandle sensorWeighting, std::vector<double>& rho, std::vector<double>& eta )
+	{
+		typedef Eigen::MatrixXd Dense;
+		const int nLambda = static_cast<int>(lambdaArray.size());
+		rho.assign(nLambda, 0.0);
+		eta.assign(nLambda, 0.0);
+
+		// With CAV = Q T, the weighted residual splits into Q (T diag(f) Uy - Q^T Cy), which depends
+		// on lambda, and the part of Cy outside the range of Q, whose norm is computed once.
+		Dense AV = forwardMatrix * matrixV.leftCols(rank);
+		Dense Cy = sensorWeighting ? Dense(*sensorWeighting * measuredData) : Dense(measuredData);
+		Dense Q, residualFactor, solutionFactor, unused;
+		thinQR(sensorWeighting ? Dense(*sensorWeighting * AV) : AV, Q, residualFactor);
+		Dense projectedData = Q.transpose() * Cy;
+		const double outsideRange = (Cy - Q * projectedData).squaredNorm();
+
+		// Likewise ||R V diag(f) Uy|| = ||T diag(f) Uy|| with R V = Q T.
+		thinQR(sourceWeighting ? Dense(*sourceWeighting * matrixV.leftCols(rank)) : Dense(matrixV.leftCols(rank)), unused, solutionFactor);
+
+		Parallel::RunRange(nLambda, Parallel::NumTasks(nLambda, 1), [&](int, size_t begin, size_t end)
+		{
+			DenseColumnMatrix filterFactors(rank);
+			Dense filtered, weighted;
+			for (size_t j = begin; j < end; j++)
+			{
+				filter(lambdaArray[j], filterFactors);
+				filtered.noalias() = filterFactors.asDiagonal() * Uy.topRows(rank);
+
+				weighted.noalias() = residualFactor * filtered;
+				weighted -= projectedData;
+				rho[j] = std::sqrt(weighted.squaredNorm() + outsideRange);
+
+				weighted.noalias() = solutionFactor * filtered;
+				eta[j] = weighted.norm();
+			}
+		});
+	}
+
+	DenseMatrix TikhonovImpl::computeFilteredInverseOperator( double lambda, int rank, const FilterFunction& filter,
+		const DenseMatrix& matrixU, const DenseMatrix& matrixV )
+	{
+		DenseColumnMatrix filterFactors(rank);
+		filter(lambda, filterFactors);
+		DenseMatrix inverseOperator = matrixV.leftCols(rank) * filterFactors.asDiagonal() * matrixU.leftCols(rank).transpose();
+		return inverseOperator;
+	}
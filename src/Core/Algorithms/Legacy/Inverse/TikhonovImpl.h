@@ -33,7 +33,9 @@
 #define BioPSE_TikhonovImpl_H__
 
 #include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Algorithms/Legacy/Inverse/share.h>
+#include <functional>
 #include <vector>
 
 
@@ -54,9 +56,39 @@ namespace Inverse {
 
 		virtual SCIRun::Core::Datatypes::DenseMatrix computeInverseSolution( double lambda_sq, bool inverseCalculation) const = 0;
 
+		// regularized inverse operator G of one lambda, so that the solution for any block of measured
+		// data columns y is G y. Its size is sources x measurements, independent of the time samples.
+		virtual SCIRun::Core::Datatypes::DenseMatrix computeInverseOperator( double lambda ) const = 0;
+
 		// default lambda step. Can ve overriden if necessary (see TSVD as reference)
 		virtual std::vector<double> computeLambdaArray( double lambdaMin, double lambdaMax, int nLambda ) const;
 
+		// L-curve points for every lambda: rho = ||C(Ax - y)|| and eta = ||Rx|| (Frobenius norms over
+		// all time samples), where a null weighting C or R is the identity. The lambdas are split
+		// across threads and each thread reuses its own workspace; only the norms are kept.
+		// The default solves for every lambda; SVD-based implementations override it.
+		virtual void computeLcurveNorms( const std::vector<double>& lambdaArray, const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix,
+			const SCIRun::Core::Datatypes::DenseMatrix& measuredData, SCIRun::Core::Datatypes::DenseMatrixHandle sourceWeighting,
+			SCIRun::Core::Datatypes::DenseMatrixHandle sensorWeighting, std::vector<double>& rho, std::vector<double>& eta ) const;
+
+	protected:
+		// Writes the filter factors f of one lambda, so that x = V diag(f) U^T y.
+		typedef std::function<void(double lambda, SCIRun::Core::Datatypes::DenseColumnMatrix& filterFactors)> FilterFunction;
+
+		// L-curve norms of filtered SVD solutions x = V diag(f) Uy, with Uy = U^T y and the first rank
+		// singular vectors taking part. The weighted residual is projected once onto an orthonormal
+		// basis of the range of CAV; after that each lambda costs two rank x rank by rank x numTimeSamples
+		// products, however large A is.
+		static void computeFilteredLcurveNorms( const std::vector<double>& lambdaArray, int rank, const FilterFunction& filter,
+			const SCIRun::Core::Datatypes::DenseMatrix& matrixV, const SCIRun::Core::Datatypes::DenseMatrix& Uy,
+			const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix, const SCIRun::Core::Datatypes::DenseMatrix& measuredData,
+			SCIRun::Core::Datatypes::DenseMatrixHandle sourceWeighting, SCIRun::Core::Datatypes::DenseMatrixHandle sensorWeighting,
+			std::vector<double>& rho, std::vector<double>& eta );
+
+		// Inverse operator V diag(f) U^T of filtered SVD solutions, using the first rank singular vectors.
+		static SCIRun::Core::Datatypes::DenseMatrix computeFilteredInverseOperator( double lambda, int rank, const FilterFunction& filter,
+			const SCIRun::Core::Datatypes::DenseMatrix& matrixU, const SCIRun::Core::Datatypes::DenseMatrix& matrixV );
+
 	};
 
 	}}}}
@@ -30,6 +30,7 @@
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Math/ComputePCA.h>
+#include <Core/Algorithms/Math/RandomizedSVD.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
@@ -41,6 +42,14 @@ using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Algorithms::Math;
 
+ComputePCAAlgo::ComputePCAAlgo()
+{
+    addOption(Parameters::SVDMethod, "full", "full|randomized");
+    addParameter(Parameters::SVDRank, 10);
+    addParameter(Parameters::SVDOversampling, 10);
+    addParameter(Parameters::SVDPowerIterations, 2);
+}
+
 //Let's do some math.
 //Algorithm:
 void ComputePCAAlgo::run(MatrixHandle input, DenseMatrixHandle& LeftPrinMat, DenseMatrixHandle& PrinVals, DenseMatrixHandle& RightPrinMat) const{
@@ -57,6 +66,17 @@ void ComputePCAAlgo::run(MatrixHandle input, DenseMatrixHandle& LeftPrinMat, Den
         //First, we have to center the data.
         auto denseInputCentered = centerData(input);
 
+        //The randomized method keeps only the leading components: U is nxk, V is mxk.
+        if (RandomizedSVD::selected(*this))
+        {
+            auto svd = RandomizedSVD::fromParameters(*this);
+            svd.compute(denseInputCentered);
+            LeftPrinMat = boost::make_shared<DenseMatrix>(svd.matrixU());
+            PrinVals = boost::make_shared<DenseMatrix>(svd.singularValues());
+            RightPrinMat = boost::make_shared<DenseMatrix>(svd.matrixV());
+            return;
+        }
+
         //After the data is centered, then we compute SVD on the centered matrix.
         //Centered Matrix = U*S*Vt, Vt = V transpose
         Eigen::JacobiSVD<DenseMatrix::EigenBase> svd_mat(denseInputCentered, Eigen::ComputeFullU | Eigen::ComputeFullV);
@@ -87,12 +107,9 @@ DenseMatrix ComputePCAAlgo::centerData(MatrixHandle input_matrix)
     //Counts the number of rows in the input matrix.
     auto rows = denseInput->rows();
 
-    //Calulates the centering matrix (C).
-    // C = Identity(nxn) - 1/n * matrix of ones(nxn)
-    auto centerMatrix = Eigen::MatrixXd::Identity(rows,rows) - (1.0/rows)*Eigen::MatrixXd::Constant(rows,rows,1);
-
-    //Multiplying the input matrix by the centering matrix.
-    auto denseInputCentered = centerMatrix * *denseInput;
+    //Subtracts the column means, which is what multiplying by the centering matrix
+    // C = Identity(nxn) - 1/n * matrix of ones(nxn) does, without forming the nxn matrix.
+    DenseMatrix denseInputCentered = denseInput->rowwise() - denseInput->colwise().sum() / static_cast<double>(rows);
 
     return denseInputCentered;
 }
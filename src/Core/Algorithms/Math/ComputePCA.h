@@ -42,7 +42,7 @@ namespace SCIRun {
                 class SCISHARE ComputePCAAlgo : public AlgorithmBase
                 {
                 public:
-                    ComputePCAAlgo() {}
+                    ComputePCAAlgo();
 
                     static AlgorithmOutputName LeftPrincipalMatrix;
                     static AlgorithmOutputName PrincipalValues;
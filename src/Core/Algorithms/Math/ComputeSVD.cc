@@ -28,6 +28,7 @@
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Math/ComputeSVD.h>
+#include <Core/Algorithms/Math/RandomizedSVD.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
@@ -40,6 +41,14 @@ using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Algorithms::Math;
 
+ComputeSVDAlgo::ComputeSVDAlgo()
+{
+  addOption(Parameters::SVDMethod, "full", "full|randomized");
+  addParameter(Parameters::SVDRank, 10);
+  addParameter(Parameters::SVDOversampling, 10);
+  addParameter(Parameters::SVDPowerIterations, 2);
+}
+
 void ComputeSVDAlgo::run(MatrixHandle input, DenseMatrixHandle& LeftSingMat, DenseMatrixHandle& SingVals, DenseMatrixHandle& RightSingMat) const
 {
   if (input->nrows() == 0 || input->ncols() == 0){
@@ -50,6 +59,16 @@ void ComputeSVDAlgo::run(MatrixHandle input, DenseMatrixHandle& LeftSingMat, Den
   {
     auto denseInput = castMatrix::toDense(input);
 
+    if (RandomizedSVD::selected(*this))
+    {
+      auto svd = RandomizedSVD::fromParameters(*this);
+      svd.compute(*denseInput);
+      LeftSingMat = boost::make_shared<DenseMatrix>(svd.matrixU());
+      SingVals = boost::make_shared<DenseMatrix>(svd.singularValues());
+      RightSingMat = boost::make_shared<DenseMatrix>(svd.matrixV());
+      return;
+    }
+
     Eigen::JacobiSVD<DenseMatrix::EigenBase> svd_mat(*denseInput, Eigen::ComputeFullU | Eigen::ComputeFullV);
 
     LeftSingMat = boost::make_shared<DenseMatrix>(svd_mat.matrixU());
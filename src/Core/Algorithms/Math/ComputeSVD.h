@@ -38,7 +38,7 @@ namespace SCIRun {
 			class SCISHARE ComputeSVDAlgo : public AlgorithmBase
 			{
 				public:
-					ComputeSVDAlgo() {}
+					ComputeSVDAlgo();
 
 					static AlgorithmOutputName LeftSingularMatrix;
 					static AlgorithmOutputName SingularValues;
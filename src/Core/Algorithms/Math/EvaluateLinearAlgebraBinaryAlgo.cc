@@ -30,10 +30,12 @@
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Math/EvaluateLinearAlgebraBinaryAlgo.h>
 #include <Core/Algorithms/Math/EvaluateLinearAlgebraUnaryAlgo.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/BlockedMatrixKernels.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Parser/ArrayMathEngine.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Core/Datatypes/MatrixMathVisitors.h>
+#include <Core/Datatypes/LinearOperator.h>
 
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Datatypes;
@@ -45,6 +47,69 @@ EvaluateLinearAlgebraBinaryAlgorithm::EvaluateLinearAlgebraBinaryAlgorithm()
 {
   addParameter(Variables::Operator, 0);
   addParameter(Variables::FunctionString, std::string("x+y"));
+  addParameter(Math::Parameters::LazyEvaluation, false);
+}
+
+namespace
+{
+  bool isAssembledDense(const MatrixHandle& m)
+  {
+    return matrixIs::dense(m) || matrixIs::column(m);
+  }
+
+  DenseMatrix::EigenBase denseEntries(const MatrixHandle& m)
+  {
+    auto column = castMatrix::toColumn(m);
+    if (column)
+      return *column;
+    return *castMatrix::toDense(m);
+  }
+
+  // Applies a LinearOperator operand to a dense or column operand. Returns null
+  // unless the product has exactly one of each.
+  MatrixHandle applyOperator(const MatrixHandle& lhs, const MatrixHandle& rhs)
+  {
+    if (matrixIs::linearOperator(lhs) && isAssembledDense(rhs))
+    {
+      DenseMatrix::EigenBase product = LinearOperator::apply(*lhs, denseEntries(rhs));
+      if (matrixIs::column(rhs))
+        return boost::make_shared<DenseColumnMatrix>(product.col(0));
+      return boost::make_shared<DenseMatrix>(product);
+    }
+    if (isAssembledDense(lhs) && matrixIs::linearOperator(rhs))
+    {
+      // x^T A = (A^T x)^T
+      DenseMatrix::EigenBase product = LinearOperator::apply(*rhs, denseEntries(lhs).transpose(), true);
+      return boost::make_shared<DenseMatrix>(product.transpose());
+    }
+    return nullptr;
+  }
+
+  // Operand pairs with a multithreaded kernel; other pairs return null and keep the
+  // visitors. Result types match what the visitors produce.
+  MatrixHandle blockedSum(const MatrixHandle& lhs, const MatrixHandle& rhs, double scale)
+  {
+    if (matrixIs::sparse(lhs) && matrixIs::sparse(rhs))
+      return BlockedMatrixKernels::add(*castMatrix::toSparse(lhs), *castMatrix::toSparse(rhs), scale);
+    if (matrixIs::dense(lhs) && matrixIs::dense(rhs))
+      return boost::make_shared<DenseMatrix>(BlockedMatrixKernels::add(*castMatrix::toDense(lhs), *castMatrix::toDense(rhs), scale));
+    return nullptr;
+  }
+
+  MatrixHandle blockedProduct(const MatrixHandle& lhs, const MatrixHandle& rhs)
+  {
+    if (matrixIs::sparse(lhs) && matrixIs::sparse(rhs))
+      return BlockedMatrixKernels::multiply(*castMatrix::toSparse(lhs), *castMatrix::toSparse(rhs));
+    // A sparse factor makes the product sparse, but it is computed against the dense
+    // entries rather than a sparse copy of the dense factor.
+    if (matrixIs::sparse(lhs) && matrixIs::dense(rhs))
+      return boost::make_shared<SparseRowMatrix>(BlockedMatrixKernels::multiply(*castMatrix::toSparse(lhs), *castMatrix::toDense(rhs)).sparseView());
+    if (matrixIs::dense(lhs) && matrixIs::sparse(rhs))
+      return boost::make_shared<SparseRowMatrix>(BlockedMatrixKernels::multiply(*castMatrix::toDense(lhs), *castMatrix::toSparse(rhs)).sparseView());
+    if (matrixIs::dense(lhs) && isAssembledDense(rhs))
+      return boost::make_shared<DenseMatrix>(BlockedMatrixKernels::multiply(*castMatrix::toDense(lhs), denseEntries(rhs)));
+    return nullptr;
+  }
 }
 
 EvaluateLinearAlgebraBinaryAlgorithm::Outputs EvaluateLinearAlgebraBinaryAlgorithm::run(const EvaluateLinearAlgebraBinaryAlgorithm::Inputs& inputs, const EvaluateLinearAlgebraBinaryAlgorithm::Parameters& params) const
@@ -56,12 +121,18 @@ EvaluateLinearAlgebraBinaryAlgorithm::Outputs EvaluateLinearAlgebraBinaryAlgorit
   ENSURE_ALGORITHM_INPUT_NOT_NULL(rhs, "rhs");
 
   auto oper = params.op;
+  const bool lazy = params.lazy || matrixIs::linearOperator(lhs) || matrixIs::linearOperator(rhs);
   switch (oper)
   {
   case ADD:
   {
     if (lhs->nrows() != rhs->nrows() || lhs->ncols() != rhs->ncols())
       THROW_ALGORITHM_INPUT_ERROR("Invalid dimensions to add matrices.");
+    if (lazy)
+      return LinearOperator::sum(lhs, rhs);
+    auto sum = blockedSum(lhs, rhs, 1);
+    if (sum)
+      return sum;
     AddMatrices add(lhs);
     rhs->accept(add);
     return add.sum_;
@@ -70,6 +141,11 @@ EvaluateLinearAlgebraBinaryAlgorithm::Outputs EvaluateLinearAlgebraBinaryAlgorit
   {
     if (lhs->nrows() != rhs->nrows() || lhs->ncols() != rhs->ncols())
       THROW_ALGORITHM_INPUT_ERROR("Invalid dimensions to subtract matrices.");
+    if (lazy)
+      return LinearOperator::sum(lhs, LinearOperator::scale(-1, rhs));
+    auto difference = blockedSum(lhs, rhs, -1);
+    if (difference)
+      return difference;
     result.reset(rhs->clone());
     NegateMatrix neg;
     result->accept(neg);
@@ -81,12 +157,28 @@ EvaluateLinearAlgebraBinaryAlgorithm::Outputs EvaluateLinearAlgebraBinaryAlgorit
   {
     if (lhs->ncols() != rhs->nrows())
       THROW_ALGORITHM_INPUT_ERROR("Invalid dimensions to multiply matrices.");
+    if (lazy)
+    {
+      auto applied = applyOperator(lhs, rhs);
+      if (applied)
+        return applied;
+      if (!isAssembledDense(lhs) && !isAssembledDense(rhs))
+        return LinearOperator::product(lhs, rhs);
+    }
+    auto product = blockedProduct(lhs, rhs);
+    if (product)
+      return product;
     MultiplyMatrices mult(lhs);
     rhs->accept(mult);
     return mult.getProduct();
   }
   case FUNCTION:
   {
+    if (matrixIs::linearOperator(lhs) || matrixIs::linearOperator(rhs))
+    {
+      warning("Function evaluation needs matrix entries, so linear operators are assembled");
+      return run(boost::make_tuple(convertMatrix::toDense(lhs), convertMatrix::toDense(rhs)), params);
+    }
     // BUG FIX: the ArrayMathEngine is not well designed for use with sparse matrices, especially allocating proper space for the result.
     // There's no way to know ahead of time, so I'll just throw an error here and require the user to do this type of math elsewhere.
     if (matrixIs::sparse(lhs) || matrixIs::sparse(rhs))
@@ -140,7 +232,9 @@ AlgorithmOutput EvaluateLinearAlgebraBinaryAlgorithm::run(const AlgorithmInput&
   auto RHS = input.get<Matrix>(Variables::RHS);
   auto func = get(Variables::FunctionString).toString();
 
-  auto result = run(boost::make_tuple(LHS, RHS), { Operator(get(Variables::Operator).toInt()), func });
+  auto lazy = get(Math::Parameters::LazyEvaluation).toBool();
+
+  auto result = run(boost::make_tuple(LHS, RHS), { Operator(get(Variables::Operator).toInt()), func, lazy });
 
   AlgorithmOutput output;
   output[Variables::Result] = result;
@@ -55,7 +55,9 @@ namespace Math {
 
     EvaluateLinearAlgebraBinaryAlgorithm();
     typedef boost::tuple<SCIRun::Core::Datatypes::MatrixHandle, SCIRun::Core::Datatypes::MatrixHandle> Inputs;
-    struct Parameters { Operator op; std::string func; };
+    /// Operations with a LinearOperator operand are always lazy; lazy makes them lazy for every input.
+    /// Products with a dense or column operand are applied rather than deferred.
+    struct Parameters { Operator op; std::string func; bool lazy; };
     typedef SCIRun::Core::Datatypes::MatrixHandle Outputs;
 
     Outputs run(const Inputs& inputs, const Parameters& params) const;
@@ -27,10 +27,12 @@
  
 
 #include <Core/Algorithms/Math/EvaluateLinearAlgebraUnaryAlgo.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/BlockedMatrixKernels.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/MatrixMathVisitors.h>
+#include <Core/Datatypes/LinearOperator.h>
 #include <stdexcept>
 
 #include <Core/Parser/ArrayMathEngine.h>
@@ -41,11 +43,14 @@ using namespace SCIRun::Core::Algorithms::Math;
 using namespace SCIRun::Core::Datatypes::MatrixMath;
 using namespace SCIRun::Core::Algorithms;
 
+ALGORITHM_PARAMETER_DEF(Math, LazyEvaluation);
+
 EvaluateLinearAlgebraUnaryAlgorithm::EvaluateLinearAlgebraUnaryAlgorithm()
 {
   addParameter(Variables::Operator, 0);
   addParameter(Variables::ScalarValue, 0);
 	addParameter(Variables::FunctionString, std::string("x+10"));
+  addParameter(Math::Parameters::LazyEvaluation, false);
 }
 
 namespace impl
@@ -66,6 +71,26 @@ namespace impl
       column = column.transpose();
     }
   };
+
+  // Dense and sparse inputs are written straight into a new result by the
+  // multithreaded kernels; other types return null and are cloned and visited.
+  MatrixHandle blockedScale(double scalar, const MatrixHandle& matrix)
+  {
+    if (matrixIs::dense(matrix))
+      return boost::make_shared<DenseMatrix>(BlockedMatrixKernels::scale(scalar, *castMatrix::toDense(matrix)));
+    if (matrixIs::sparse(matrix))
+      return BlockedMatrixKernels::scale(scalar, *castMatrix::toSparse(matrix));
+    return nullptr;
+  }
+
+  MatrixHandle blockedTranspose(const MatrixHandle& matrix)
+  {
+    if (matrixIs::dense(matrix))
+      return boost::make_shared<DenseMatrix>(BlockedMatrixKernels::transpose(*castMatrix::toDense(matrix)));
+    if (matrixIs::sparse(matrix))
+      return BlockedMatrixKernels::transpose(*castMatrix::toSparse(matrix));
+    return nullptr;
+  }
 }
 
 EvaluateLinearAlgebraUnaryAlgorithm::Outputs EvaluateLinearAlgebraUnaryAlgorithm::run(const EvaluateLinearAlgebraUnaryAlgorithm::Inputs& matrix, const EvaluateLinearAlgebraUnaryAlgorithm::Parameters& params) const
@@ -74,12 +99,18 @@ EvaluateLinearAlgebraUnaryAlgorithm::Outputs EvaluateLinearAlgebraUnaryAlgorithm
   MatrixHandle result;
 
   Operator oper = params.op;
+  const bool lazy = params.lazy || matrixIs::linearOperator(matrix);
 
   /// @todo: absolutely need matrix move semantics here!!!!!!!
   switch (oper)
   {
   case NEGATE:
   {
+    if (lazy)
+      return LinearOperator::scale(-1, matrix);
+    result = impl::blockedScale(-1, matrix);
+    if (result)
+      break;
     result.reset(matrix->clone());
     NegateMatrix negate;
     result->accept(negate);
@@ -87,6 +118,11 @@ EvaluateLinearAlgebraUnaryAlgorithm::Outputs EvaluateLinearAlgebraUnaryAlgorithm
   }
   case TRANSPOSE:
   {
+    if (lazy)
+      return LinearOperator::transpose(matrix);
+    result = impl::blockedTranspose(matrix);
+    if (result)
+      break;
     result.reset(matrix->clone());
     impl::TransposeMatrix tr;
     result->accept(tr);
@@ -95,6 +131,11 @@ EvaluateLinearAlgebraUnaryAlgorithm::Outputs EvaluateLinearAlgebraUnaryAlgorithm
   case SCALAR_MULTIPLY:
   {
     auto scalar = params.scalar;
+    if (lazy)
+      return LinearOperator::scale(scalar, matrix);
+    result = impl::blockedScale(scalar, matrix);
+    if (result)
+      break;
     result.reset(matrix->clone());
     ScalarMultiplyMatrix mult(scalar);
     result->accept(mult);
@@ -108,6 +149,11 @@ EvaluateLinearAlgebraUnaryAlgorithm::Outputs EvaluateLinearAlgebraUnaryAlgorithm
     {
       THROW_ALGORITHM_INPUT_ERROR("ArrayMathEngine needs overhaul to be used with large sparse inputs. See https://github.com/SCIInstitute/SCIRun/issues/482");
     }
+    if (matrixIs::linearOperator(matrix))
+    {
+      warning("Function evaluation needs matrix entries, so the linear operator is assembled");
+      return run(convertMatrix::toDense(matrix), params);
+    }
     NewArrayMathEngine engine;
     result.reset(matrix->clone());
 
@@ -142,7 +188,9 @@ AlgorithmOutput EvaluateLinearAlgebraUnaryAlgorithm::run(const AlgorithmInput& i
   auto scalar = get(Variables::ScalarValue).toDouble();
 	auto function = get(Variables::FunctionString).toString();
 
-  auto result = run(matrix, { Operator(get(Variables::Operator).toInt()), scalar, function });
+  auto lazy = get(Math::Parameters::LazyEvaluation).toBool();
+
+  auto result = run(matrix, { Operator(get(Variables::Operator).toInt()), scalar, function, lazy });
 
   AlgorithmOutput output;
   output[Variables::Result] = result;
@@ -42,6 +42,10 @@ namespace Core {
 namespace Algorithms {
 namespace Math {
 
+  /// Shared with EvaluateLinearAlgebraBinaryAlgorithm: return a LinearOperator
+  /// instead of evaluating sums, products, transposes and scalings.
+  ALGORITHM_PARAMETER_DECL(LazyEvaluation);
+
 ///
 /// \class EvaluateLinearAlgebraUnaryAlgorithm
 ///
@@ -89,7 +93,8 @@ namespace Math {
     };
 
     typedef SCIRun::Core::Datatypes::MatrixHandle Inputs;
-    struct Parameters { Operator op; double scalar; std::string func; };
+    /// Operations on a LinearOperator input are always lazy; lazy makes them lazy for every input.
+    struct Parameters { Operator op; double scalar; std::string func; bool lazy; };
     typedef SCIRun::Core::Datatypes::MatrixHandle Outputs;
 
     EvaluateLinearAlgebraUnaryAlgorithm();
@@ -0,0 +1,149 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Math/LinearSystem/MatrixFreeSolver.h>
+#include <Core/Datatypes/LinearOperator.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Utils/Exception.h>
+#include <Eigen/IterativeLinearSolvers>
+
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Datatypes;
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+namespace detail {
+  class MatrixFreeOperator;
+}}}}}
+
+using SCIRun::Core::Algorithms::Math::detail::MatrixFreeOperator;
+
+namespace Eigen {
+namespace internal {
+
+  template <>
+  struct traits<MatrixFreeOperator> : public traits<SparseMatrix<double>>
+  {};
+
+}}
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+namespace detail {
+
+  /// Presents a Matrix to Eigen's iterative solvers as an expression that only
+  /// supports products with dense vectors.
+  class MatrixFreeOperator : public Eigen::EigenBase<MatrixFreeOperator>
+  {
+  public:
+    typedef double Scalar;
+    typedef double RealScalar;
+    typedef int StorageIndex;
+    enum
+    {
+      ColsAtCompileTime = Eigen::Dynamic,
+      MaxColsAtCompileTime = Eigen::Dynamic,
+      IsRowMajor = false
+    };
+
+    explicit MatrixFreeOperator(const Matrix& A) : A_(&A) {}
+
+    Eigen::Index rows() const { return A_->nrows(); }
+    Eigen::Index cols() const { return A_->ncols(); }
+
+    template <typename Rhs>
+    Eigen::Product<MatrixFreeOperator, Rhs, Eigen::AliasFreeProduct> operator*(const Eigen::MatrixBase<Rhs>& x) const
+    {
+      return Eigen::Product<MatrixFreeOperator, Rhs, Eigen::AliasFreeProduct>(*this, x.derived());
+    }
+
+    const Matrix& matrix() const { return *A_; }
+
+  private:
+    const Matrix* A_;
+  };
+
+}}}}}
+
+namespace Eigen {
+namespace internal {
+
+  template <typename Rhs>
+  struct generic_product_impl<MatrixFreeOperator, Rhs, SparseShape, DenseShape, GemvProduct>
+    : generic_product_impl_base<MatrixFreeOperator, Rhs, generic_product_impl<MatrixFreeOperator, Rhs>>
+  {
+    typedef typename Product<MatrixFreeOperator, Rhs>::Scalar Scalar;
+
+    template <typename Dest>
+    static void scaleAndAddTo(Dest& dst, const MatrixFreeOperator& lhs, const Rhs& rhs, const Scalar& alpha)
+    {
+      dst += alpha * LinearOperator::apply(lhs.matrix(), DenseMatrix::EigenBase(rhs));
+    }
+  };
+
+}}
+
+namespace
+{
+  template <class Solver>
+  bool solveWith(Solver& solver, const MatrixFreeOperator& A, const DenseColumnMatrix& b, DenseColumnMatrix& x,
+    double tolerance, int maxIterations, double& error, int& iterations)
+  {
+    solver.setTolerance(tolerance);
+    solver.setMaxIterations(maxIterations);
+    solver.compute(A);
+    x = solver.solveWithGuess(b, x);
+    error = solver.error();
+    iterations = static_cast<int>(solver.iterations());
+    return solver.info() == Eigen::Success;
+  }
+}
+
+MatrixFreeSolver::MatrixFreeSolver(const std::string& method, double tolerance, int maxIterations)
+  : method_(method), tolerance_(tolerance), maxIterations_(maxIterations), error_(0), iterations_(0)
+{
+  if (!supports(method))
+    THROW_INVALID_ARGUMENT("Matrix-free solves support the cg and bicg methods, not " + method);
+}
+
+bool MatrixFreeSolver::solve(const Matrix& A, const DenseColumnMatrix& b, DenseColumnMatrix& x)
+{
+  MatrixFreeOperator op(A);
+  if (method_ == "cg")
+  {
+    Eigen::ConjugateGradient<MatrixFreeOperator, Eigen::Lower | Eigen::Upper, Eigen::IdentityPreconditioner> solver;
+    return solveWith(solver, op, b, x, tolerance_, maxIterations_, error_, iterations_);
+  }
+  Eigen::BiCGSTAB<MatrixFreeOperator, Eigen::IdentityPreconditioner> solver;
+  return solveWith(solver, op, b, x, tolerance_, maxIterations_, error_, iterations_);
+}
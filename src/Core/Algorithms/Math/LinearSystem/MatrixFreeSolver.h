@@ -0,0 +1,73 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_MATH_LINEARSYSTEM_MATRIXFREESOLVER_H
+#define CORE_ALGORITHMS_MATH_LINEARSYSTEM_MATRIXFREESOLVER_H
+
+#include <Core/Datatypes/MatrixFwd.h>
+#include <string>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Solves A*x = b with Eigen's Krylov solvers, touching A only through
+  /// products, so a LinearOperator is never assembled. Without entries there
+  /// is no diagonal to precondition with, and the iterations are
+  /// unpreconditioned.
+  class SCISHARE MatrixFreeSolver
+  {
+  public:
+    /// method is "cg" or "bicg".
+    MatrixFreeSolver(const std::string& method, double tolerance, int maxIterations);
+
+    /// A may be any matrix type LinearOperator::apply accepts. x holds the
+    /// initial guess on entry and the solution on exit. Returns whether the
+    /// relative residual reached the tolerance.
+    bool solve(const Datatypes::Matrix& A, const Datatypes::DenseColumnMatrix& b, Datatypes::DenseColumnMatrix& x);
+
+    /// Relative residual |b - A*x| / |b| of the returned solution.
+    double error() const { return error_; }
+    int iterations() const { return iterations_; }
+
+    static bool supports(const std::string& method) { return method == "cg" || method == "bicg"; }
+
+  private:
+    std::string method_;
+    double tolerance_;
+    int maxIterations_;
+    double error_;
+    int iterations_;
+  };
+
+}}}}
+
+#endif
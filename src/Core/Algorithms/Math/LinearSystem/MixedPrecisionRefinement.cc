@@ -0,0 +1,162 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Math/LinearSystem/MixedPrecisionRefinement.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/CompactSparseRowMatrix.h>
+#include <Eigen/Sparse>
+#include <complex>
+
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  template <typename T>
+  struct LowerPrecision;
+
+  template <>
+  struct LowerPrecision<double> { typedef float type; };
+
+  template <>
+  struct LowerPrecision<std::complex<double>> { typedef std::complex<float> type; };
+
+  // Relative residual reduction asked of each single precision solve. Single precision
+  // Krylov iterations stall a little below this, so a tighter value only costs iterations.
+  const double innerTolerance = 1e-5;
+  // A correction that does not reduce the residual ends the refinement, so this bound
+  // is only reached when every correction gains very little.
+  const int maxCorrections = 20;
+}
+
+template <typename T>
+MixedPrecisionRefinement<T>::MixedPrecisionRefinement(const std::string& method, bool jacobi, double tolerance, int maxIterations)
+  : method_(method), jacobi_(jacobi), tolerance_(tolerance), maxIterations_(maxIterations),
+  error_(0), iterations_(0), corrections_(0)
+{
+}
+
+template <typename T>
+bool MixedPrecisionRefinement<T>::solve(const SparseRowMatrixGeneric<T>& A, const DenseColumnMatrixGeneric<T>& b,
+  DenseColumnMatrixGeneric<T>& x)
+{
+  typedef typename LowerPrecision<T>::type Low;
+
+  if (CompactSparseRowMatrixGeneric<Low>::fits(A.nrows(), A.ncols(), A.nonZeros()))
+  {
+    typename CompactSparseRowMatrixGeneric<Low>::EigenBase lowA = A.template cast<Low>();
+    return refineWith(A, lowA, b, x);
+  }
+  Eigen::SparseMatrix<Low, Eigen::RowMajor, index_type> lowA = A.template cast<Low>();
+  return refineWith(A, lowA, b, x);
+}
+
+template <typename T>
+template <class LowMatrix>
+bool MixedPrecisionRefinement<T>::refineWith(const SparseRowMatrixGeneric<T>& A, const LowMatrix& lowA,
+  const DenseColumnMatrixGeneric<T>& b, DenseColumnMatrixGeneric<T>& x)
+{
+  // Both triangles are stored, so the inner products do not go through a self-adjoint view.
+  const int UpLo = Eigen::Lower | Eigen::Upper;
+  typedef Eigen::DiagonalPreconditioner<typename LowMatrix::Scalar> Jacobi;
+  typedef Eigen::IdentityPreconditioner Identity;
+
+  if (method_ == "cg")
+    return jacobi_ ? refine<Eigen::ConjugateGradient<LowMatrix, UpLo, Jacobi>>(A, lowA, b, x)
+      : refine<Eigen::ConjugateGradient<LowMatrix, UpLo, Identity>>(A, lowA, b, x);
+  if (method_ == "bicg")
+    return jacobi_ ? refine<Eigen::BiCGSTAB<LowMatrix, Jacobi>>(A, lowA, b, x)
+      : refine<Eigen::BiCGSTAB<LowMatrix, Identity>>(A, lowA, b, x);
+  return false;
+}
+
+template <typename T>
+template <class Solver, class LowMatrix>
+bool MixedPrecisionRefinement<T>::refine(const SparseRowMatrixGeneric<T>& A, const LowMatrix& lowA,
+  const DenseColumnMatrixGeneric<T>& b, DenseColumnMatrixGeneric<T>& x)
+{
+  typedef typename LowMatrix::Scalar Low;
+  typedef Eigen::Matrix<Low, Eigen::Dynamic, 1> LowVector;
+
+  iterations_ = 0;
+  corrections_ = 0;
+
+  const double bnorm = b.norm();
+  if (bnorm == 0.0)
+  {
+    x.setZero();
+    error_ = 0.0;
+    return true;
+  }
+
+  DenseColumnMatrixGeneric<T> r = b - A * x;
+  double rnorm = r.norm();
+  error_ = rnorm / bnorm;
+
+  Solver solver;
+  solver.compute(lowA);
+  if (solver.info() != Eigen::Success)
+    return false;
+
+  while (error_ > tolerance_ && iterations_ < maxIterations_ && corrections_ < maxCorrections)
+  {
+    // Ask only for the reduction still missing, with some margin, so the last correction
+    // does not overshoot the target by orders of magnitude.
+    const double needed = 0.5 * tolerance_ / error_;
+    solver.setTolerance(static_cast<typename Eigen::NumTraits<Low>::Real>(std::max(innerTolerance, needed)));
+    // The residual is scaled to unit norm so small corrections do not underflow in single precision.
+    LowVector lowR = (r / rnorm).template cast<Low>();
+    solver.setMaxIterations(maxIterations_ - iterations_);
+    LowVector d = solver.solve(lowR);
+    iterations_ += static_cast<int>(solver.iterations());
+    ++corrections_;
+
+    DenseColumnMatrixGeneric<T> corrected = x + rnorm * d.template cast<T>();
+    DenseColumnMatrixGeneric<T> correctedR = b - A * corrected;
+    const double correctedNorm = correctedR.norm();
+    if (!(correctedNorm < rnorm))
+      break;
+
+    x.swap(corrected);
+    r.swap(correctedR);
+    rnorm = correctedNorm;
+    error_ = rnorm / bnorm;
+  }
+
+  return error_ <= tolerance_;
+}
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+  template class MixedPrecisionRefinement<double>;
+  template class MixedPrecisionRefinement<std::complex<double>>;
+}}}}
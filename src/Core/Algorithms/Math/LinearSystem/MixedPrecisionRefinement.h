@@ -0,0 +1,85 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_MATH_LINEARSYSTEM_MIXEDPRECISIONREFINEMENT_H
+#define CORE_ALGORITHMS_MATH_LINEARSYSTEM_MIXEDPRECISIONREFINEMENT_H
+
+#include <Core/Datatypes/MatrixFwd.h>
+#include <string>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Solves A*x = b by iterative refinement: the Krylov iterations run on a
+  /// single precision copy of A, and the residual b - A*x and the solution
+  /// updates stay in double precision. Each correction cuts the residual by
+  /// about the inner tolerance, so the final residual matches a double solve
+  /// while the iterations read half as many bytes of matrix values.
+  template <typename T>
+  class SCISHARE MixedPrecisionRefinement
+  {
+  public:
+    /// method is "cg" or "bicg"; the inner solver uses a Jacobi preconditioner unless jacobi is false.
+    MixedPrecisionRefinement(const std::string& method, bool jacobi, double tolerance, int maxIterations);
+
+    /// x holds the initial guess on entry and the solution on exit. Returns
+    /// whether the relative residual reached the tolerance.
+    bool solve(const Datatypes::SparseRowMatrixGeneric<T>& A, const Datatypes::DenseColumnMatrixGeneric<T>& b,
+      Datatypes::DenseColumnMatrixGeneric<T>& x);
+
+    /// Relative residual |b - A*x| / |b| of the returned solution.
+    double error() const { return error_; }
+    /// Total inner Krylov iterations.
+    int iterations() const { return iterations_; }
+    /// Number of double precision residual corrections.
+    int corrections() const { return corrections_; }
+
+  private:
+    template <class Solver, class LowMatrix>
+    bool refine(const Datatypes::SparseRowMatrixGeneric<T>& A, const LowMatrix& lowA,
+      const Datatypes::DenseColumnMatrixGeneric<T>& b, Datatypes::DenseColumnMatrixGeneric<T>& x);
+    template <class LowMatrix>
+    bool refineWith(const Datatypes::SparseRowMatrixGeneric<T>& A, const LowMatrix& lowA,
+      const Datatypes::DenseColumnMatrixGeneric<T>& b, Datatypes::DenseColumnMatrixGeneric<T>& x);
+
+    std::string method_;
+    bool jacobi_;
+    double tolerance_;
+    int maxIterations_;
+    double error_;
+    int iterations_;
+    int corrections_;
+  };
+
+}}}}
+
+#endif
@@ -32,12 +32,15 @@
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Math/LinearSystem/MixedPrecisionRefinement.h>
+#include <Core/Algorithms/Math/LinearSystem/MatrixFreeSolver.h>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/LinearOperator.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 
 using namespace SCIRun::Core::Algorithms;
@@ -47,7 +50,7 @@ using namespace SCIRun::Core::Datatypes;
 SolveLinearSystemAlgo::SolveLinearSystemAlgo()
 {
   // For solver
-  addOption(Variables::Method,"cg","jacobi|cg|bicg|minres");
+  addOption(Variables::Method,"cg","jacobi|cg|bicg|minres|cg-mixed|bicg-mixed|ldlt");
   addOption(Variables::Preconditioner,"Jacobi","None|Jacobi");
 
   addParameter(Variables::TargetError, 1e-5);
@@ -228,6 +231,7 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
   }
 
   double bkden = 0.0;
+  double bknum = PLA.mult_dot(R,DIAG,Z,R);
 
   int cnt = 0;
   double log_target = log(tolerance);
@@ -256,9 +260,6 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       return true;
     }
 
-    PLA.mult(R,DIAG,Z);
-    double bknum = PLA.dot(Z,R);
-
     if (niter == 0)
     {
       PLA.copy(Z,P);
@@ -268,16 +269,16 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       double bk = bknum/bkden;
       PLA.scale_add(bk,P,Z,P);
     }
-    PLA.mult(A,P,Z);
     bkden = bknum;
 
-    double akden = PLA.dot(Z,P);
+    double akden = PLA.mult_dot(A,P,Z,P);
     double ak=bknum/akden;
 
     PLA.scale_add(ak,P,X,X);
-    PLA.scale_add(-ak,Z,R,R);
 
-    error = PLA.norm(R)/bnorm;
+    // Updates the residual, its norm and the preconditioned residual of the
+    // next iteration in one pass
+    error = PLA.scale_add_norm(-ak,Z,R,R,DIAG,Z,bknum)/bnorm;
     if (error < xmin)
     {
       PLA.copy(X,XMIN);
@@ -460,11 +461,9 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
       return (true);
     }
 
-    PLA.mult(R,DIAG,Z);
+    double bknum = PLA.mult_dot(R,DIAG,Z,R1);
     PLA.mult(R1,DIAG,Z1);
 
-    double bknum = PLA.dot(Z,R1);
-
     if (bknum == 0.0)
     {
       if (PLA.first())
@@ -491,18 +490,16 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
       PLA.scale_add(bk,P1,Z1,P1);
     }
 
-    PLA.mult(A,P,Z);
+    double akden = PLA.mult_dot(A,P,Z,P1);
     PLA.mult_trans(A,P1,Z1);
     bkden = bknum;
 
-    double akden = PLA.dot(Z,P1);
     double ak=bknum/akden;
 
     PLA.scale_add(ak,P,X,X);
-    PLA.scale_add(-ak,Z,R,R);
+    error = PLA.scale_add_norm(-ak,Z,R,R)/bnorm;
 
     PLA.scale_add(-ak,Z1,R1,R1);
-    error = PLA.norm(R)/bnorm;
 
     if (error < xmin) { PLA.copy(X,XMIN); xmin = error; }
     if (PLA.first()) (*convergence_)[niter] = xmin;
@@ -1180,6 +1177,39 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
       BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("MINRES method failed"));
     }
   }
+  else if (method == "cg-mixed" || method == "bicg-mixed")
+  {
+    MixedPrecisionRefinement<double> algo(method.substr(0, method.find('-')),
+      getOption(Variables::Preconditioner) == "Jacobi",
+      get(Variables::TargetError).toDouble(), get(Variables::MaxIterations).toInt());
+    auto solution = boost::make_shared<DenseColumnMatrix>(*x0);
+    bool converged = algo.solve(*A, *b, *solution);
+    x = solution;
+
+    std::ostringstream ostr;
+    ostr << "Mixed precision solver " << (converged ? "converged" : "stopped") << " after " << algo.iterations()
+      << " single precision iterations and " << algo.corrections() << " corrections with error " << algo.error();
+    if (converged)
+      remark(ostr.str());
+    else
+      warning(ostr.str());
+  }
+  else if (method == "ldlt")
+  {
+    auto reuse = directSolver_.factor(A);
+    auto solution = boost::make_shared<DenseColumnMatrix>(b->nrows());
+    directSolver_.solve(*b, *solution);
+    x = solution;
+
+    std::ostringstream ostr;
+    if (reuse == SparseDirectSolver::Reuse::FACTORS)
+      ostr << "Reused LDLT factorization";
+    else
+      ostr << (reuse == SparseDirectSolver::Reuse::SYMBOLIC ? "Refactored LDLT with the cached ordering" : "Computed LDLT factorization");
+    ostr << ": " << directSolver_.factorNonZeros() << " nonzeros in L, "
+      << directSolver_.factorBytes() / (1024.0 * 1024.0) << " MB";
+    remark(ostr.str());
+  }
   else
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Unknown solver method"));
 
@@ -1200,15 +1230,50 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   return true;
 }
 
+DenseColumnMatrixHandle SolveLinearSystemAlgo::solveOperator(LinearOperatorHandle A, DenseColumnMatrixHandle b) const
+{
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(b, "No matrix b is given");
+  if (A->nrows() != A->ncols())
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A is not square");
+  if (A->nrows() != b->nrows())
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A and b do not have the same number of rows");
+
+  auto method = getOption(Variables::Method);
+  if (!MatrixFreeSolver::supports(method))
+  {
+    warning("The " + method + " method needs matrix entries, so the linear operator is assembled");
+    DenseColumnMatrixHandle solution;
+    run(convertMatrix::toSparse(A), b, DenseColumnMatrixHandle(), solution);
+    return solution;
+  }
+
+  ScopedAlgorithmStatusReporter ssr(this, "SolveLinearSystem");
+  MatrixFreeSolver solver(method, get(Variables::TargetError).toDouble(), get(Variables::MaxIterations).toInt());
+  auto solution = boost::make_shared<DenseColumnMatrix>(b->nrows());
+  solution->setZero();
+  bool converged = solver.solve(*A, *b, *solution);
+
+  std::ostringstream ostr;
+  ostr << "Matrix-free " << method << " solver " << (converged ? "converged" : "stopped") << " after "
+    << solver.iterations() << " unpreconditioned iterations with error " << solver.error();
+  if (converged)
+    remark(ostr.str());
+  else
+    warning(ostr.str());
+  return solution;
+}
+
 AlgorithmOutput SolveLinearSystemAlgo::run(const AlgorithmInput& input) const
 {
-  auto lhs = input.get<SparseRowMatrix>(Variables::LHS);
+  auto lhs = input.get<Matrix>(Variables::LHS);
   auto rhs = input.get<DenseColumnMatrix>(Variables::RHS);
 
   DenseColumnMatrixHandle solution;
 
-  bool success = run(lhs, rhs, DenseColumnMatrixHandle(), solution);
-  if (!success)
+  auto op = castMatrix::to<LinearOperator>(lhs);
+  if (op)
+    solution = solveOperator(op, rhs);
+  else if (!run(castMatrix::toSparse(lhs), rhs, DenseColumnMatrixHandle(), solution))
   {
     BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("SolveLinearSystem Algo returned false--need to improve error conditions so it throws before returning."));
   }
@@ -35,6 +35,7 @@
 
 #include <Core/Algorithms/Base/AlgorithmBase.h>
 #include <Core/Datatypes/MatrixFwd.h>
+#include <Core/Algorithms/Math/LinearSystem/SparseDirectSolver.h>
 #include <Core/Algorithms/Math/share.h>
 
 namespace SCIRun {
@@ -62,6 +63,14 @@ class SCISHARE SolveLinearSystemAlgo : public AlgorithmBase
              Datatypes::DenseColumnMatrixHandle& x) const;
 
     AlgorithmOutput run(const AlgorithmInput& input) const override;
+
+  private:
+    /// Solves with a LinearOperator through products only for cg and bicg; the
+    /// other methods need entries, so the operator is assembled for them.
+    Datatypes::DenseColumnMatrixHandle solveOperator(Datatypes::LinearOperatorHandle A, Datatypes::DenseColumnMatrixHandle b) const;
+
+    /// Factors of the last matrix solved with the "ldlt" method, kept across executions.
+    mutable SparseDirectSolver directSolver_;
 };
 
 
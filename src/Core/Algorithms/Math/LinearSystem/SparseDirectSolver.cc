@@ -0,0 +1,162 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Math/LinearSystem/SparseDirectSolver.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Eigen/SparseCholesky>
+#include <boost/weak_ptr.hpp>
+#include <algorithm>
+#include <cmath>
+
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core;
+
+class SparseDirectSolver::Impl
+{
+public:
+  typedef Eigen::SparseMatrix<double, Eigen::ColMajor, index_type> ColumnMatrix;
+  typedef Eigen::SimplicialLDLT<ColumnMatrix, Eigen::Lower, Eigen::AMDOrdering<index_type>> Factorization;
+
+  Factorization ldlt;
+  boost::weak_ptr<SparseRowMatrix> matrix;
+  std::vector<index_type> outer, inner;
+  bool analyzed = false;
+
+  bool samePattern(const ColumnMatrix& A) const
+  {
+    return analyzed && outer.size() == static_cast<size_t>(A.outerSize() + 1)
+      && inner.size() == static_cast<size_t>(A.nonZeros())
+      && std::equal(outer.begin(), outer.end(), A.outerIndexPtr())
+      && std::equal(inner.begin(), inner.end(), A.innerIndexPtr());
+  }
+
+  // The factorization reads only the lower triangle, so an unsymmetric A would be
+  // solved silently as a different matrix.
+  static bool symmetric(const ColumnMatrix& A)
+  {
+    ColumnMatrix transposed = A.transpose();
+    ColumnMatrix difference = A - transposed;
+    double largest = 0, asymmetry = 0;
+    for (index_type k = 0; k < A.nonZeros(); ++k)
+      largest = std::max(largest, std::fabs(A.valuePtr()[k]));
+    for (index_type k = 0; k < difference.nonZeros(); ++k)
+      asymmetry = std::max(asymmetry, std::fabs(difference.valuePtr()[k]));
+    return asymmetry <= 1e-12 * largest;
+  }
+};
+
+SparseDirectSolver::SparseDirectSolver() : impl_(new Impl)
+{
+}
+
+SparseDirectSolver::~SparseDirectSolver()
+{
+}
+
+SparseDirectSolver::Reuse SparseDirectSolver::factor(SparseRowMatrixHandle A)
+{
+  if (!A)
+    BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Null input matrix"));
+  if (A->nrows() != A->ncols())
+    BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Matrix A is not square"));
+
+  if (impl_->matrix.lock() == A)
+    return Reuse::FACTORS;
+
+  // A is converted rather than compressed in place, so the caller's matrix is left as it was.
+  Impl::ColumnMatrix columns = *A;
+  columns.makeCompressed();
+  if (!Impl::symmetric(columns))
+    BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Matrix A is not symmetric"));
+
+  auto reuse = Reuse::SYMBOLIC;
+  if (!impl_->samePattern(columns))
+  {
+    reuse = Reuse::NONE;
+    impl_->matrix.reset();
+    impl_->analyzed = false;
+    impl_->ldlt.analyzePattern(columns);
+    if (impl_->ldlt.info() != Eigen::Success)
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Symbolic factorization failed"));
+    impl_->outer.assign(columns.outerIndexPtr(), columns.outerIndexPtr() + columns.outerSize() + 1);
+    impl_->inner.assign(columns.innerIndexPtr(), columns.innerIndexPtr() + columns.nonZeros());
+    impl_->analyzed = true;
+  }
+
+  impl_->ldlt.factorize(columns);
+  if (impl_->ldlt.info() != Eigen::Success)
+  {
+    impl_->matrix.reset();
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("LDLT factorization failed: matrix A is singular"));
+  }
+  impl_->matrix = A;
+  return reuse;
+}
+
+void SparseDirectSolver::solve(const DenseColumnMatrix& b, DenseColumnMatrix& x) const
+{
+  if (!impl_->matrix.lock())
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("No factorization available"));
+  x = impl_->ldlt.solve(b);
+}
+
+void SparseDirectSolver::solve(const DenseMatrix& B, DenseMatrix& X) const
+{
+  if (!impl_->matrix.lock())
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("No factorization available"));
+  // the triangular solves run down columns, so the row-major block is solved in column-major form
+  Eigen::MatrixXd columns = impl_->ldlt.solve(Eigen::MatrixXd(B));
+  X = columns;
+}
+
+size_t SparseDirectSolver::factorNonZeros() const
+{
+  return impl_->analyzed ? static_cast<size_t>(impl_->ldlt.matrixL().nestedExpression().nonZeros()) : 0;
+}
+
+size_t SparseDirectSolver::factorBytes() const
+{
+  if (!impl_->analyzed)
+    return 0;
+  const size_t n = impl_->ldlt.rows();
+  return factorNonZeros() * (sizeof(double) + sizeof(index_type))
+    + (n + 1) * sizeof(index_type)
+    + n * sizeof(double)
+    + 2 * n * sizeof(index_type);
+}
+
+void SparseDirectSolver::clear()
+{
+  impl_.reset(new Impl);
+}
@@ -0,0 +1,78 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_MATH_LINEARSYSTEM_SPARSEDIRECTSOLVER_H
+#define CORE_ALGORITHMS_MATH_LINEARSYSTEM_SPARSEDIRECTSOLVER_H
+
+#include <Core/Datatypes/MatrixFwd.h>
+#include <boost/noncopyable.hpp>
+#include <memory>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Sparse LDL^T factorization of a symmetric matrix, with a fill-reducing
+  /// AMD ordering. The factors of the last matrix are kept, so solving again
+  /// with the same matrix object costs only the triangular solves. A new
+  /// matrix with the same sparsity pattern reuses the ordering and the
+  /// symbolic analysis and is refactored numerically.
+  class SCISHARE SparseDirectSolver : boost::noncopyable
+  {
+  public:
+    SparseDirectSolver();
+    ~SparseDirectSolver();
+
+    enum class Reuse { NONE, SYMBOLIC, FACTORS };
+
+    /// Factors A unless its factors are already cached; returns what could be
+    /// reused. A itself is not modified. Throws when A is not square or not
+    /// symmetric, or when the factorization fails.
+    Reuse factor(Datatypes::SparseRowMatrixHandle A);
+    void solve(const Datatypes::DenseColumnMatrix& b, Datatypes::DenseColumnMatrix& x) const;
+    /// Solves for every column of B at once. Solving only reads the factors, so
+    /// several threads may solve with the same factorization.
+    void solve(const Datatypes::DenseMatrix& B, Datatypes::DenseMatrix& X) const;
+
+    /// Nonzeros of the strictly lower factor L, and the bytes held by L, D and the ordering.
+    size_t factorNonZeros() const;
+    size_t factorBytes() const;
+
+    void clear();
+
+  private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+  };
+
+}}}}
+
+#endif
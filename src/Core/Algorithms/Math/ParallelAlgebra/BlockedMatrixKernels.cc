@@ -0,0 +1,423 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Algorithms/Math/ParallelAlgebra/BlockedMatrixKernels.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Utils/Exception.h>
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun;
+
+namespace
+{
+  // Multiply-adds (or nonzeros touched) that pay for starting a thread.
+  const double workPerTask = 1 << 18;
+  const Eigen::Index transposeTile = 32;
+
+  int forcedTasks = 0;
+
+  int numTasks(double work, Eigen::Index maxTasks)
+  {
+    if (forcedTasks > 0)
+      return static_cast<int>(std::max<Eigen::Index>(1, std::min<Eigen::Index>(forcedTasks, maxTasks)));
+    auto byWork = static_cast<Eigen::Index>(work / workPerTask);
+    return static_cast<int>(std::max<Eigen::Index>(1, std::min<Eigen::Index>({ static_cast<Eigen::Index>(Parallel::NumCores()), byWork, maxTasks })));
+  }
+
+  // Row boundaries giving every task about the same share of work, from the
+  // cumulative work before each row (rows + 1 entries).
+  std::vector<index_type> balancedRows(const index_type* cumulativeWork, index_type rows, int tasks)
+  {
+    std::vector<index_type> bounds(tasks + 1, rows);
+    bounds[0] = 0;
+    const double total = static_cast<double>(cumulativeWork[rows]);
+    for (int task = 1; task < tasks; ++task)
+    {
+      auto target = static_cast<index_type>(total * task / tasks);
+      bounds[task] = std::lower_bound(cumulativeWork, cumulativeWork + rows + 1, target) - cumulativeWork;
+    }
+    return bounds;
+  }
+
+  // Runs task(index, begin, end) on the rows between consecutive bounds, one task per range.
+  void runRows(const std::vector<index_type>& bounds, const std::function<void(int, index_type, index_type)>& task)
+  {
+    const int tasks = static_cast<int>(bounds.size()) - 1;
+    Parallel::RunRange(tasks, tasks, [&](int index, size_t, size_t)
+    {
+      task(index, bounds[index], bounds[index + 1]);
+    });
+  }
+
+  // Allocates a compressed matrix whose row i holds offsets[i + 1] entries;
+  // offsets is turned into the row pointer.
+  SparseRowMatrixHandle allocateRows(index_type rows, index_type cols, std::vector<index_type>& offsets)
+  {
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    auto C = boost::make_shared<SparseRowMatrix>(static_cast<int>(rows), static_cast<int>(cols));
+    C->resizeNonZeros(offsets[rows]);
+    std::copy(offsets.begin(), offsets.end(), C->outerIndexPtr());
+    return C;
+  }
+
+  SparseRowMatrix compressedCopy(const SparseRowMatrix& A)
+  {
+    SparseRowMatrix copy(A);
+    copy.makeCompressed();
+    return copy;
+  }
+}
+
+void BlockedMatrixKernels::forceTaskCount(int tasks)
+{
+  forcedTasks = tasks;
+}
+
+SparseRowMatrixHandle BlockedMatrixKernels::multiply(const SparseRowMatrix& A, const SparseRowMatrix& B)
+{
+  ENSURE_DIMENSIONS_MATCH(A.cols(), B.rows(), "Inner dimensions of the sparse product do not match");
+  if (!A.isCompressed())
+    return multiply(compressedCopy(A), B);
+  if (!B.isCompressed())
+    return multiply(A, compressedCopy(B));
+
+  const index_type m = A.rows(), n = B.cols();
+  const auto *aRows = A.outerIndexPtr(), *aCols = A.innerIndexPtr(), *bRows = B.outerIndexPtr(), *bCols = B.innerIndexPtr();
+  const auto *aValues = A.valuePtr(), *bValues = B.valuePtr();
+
+  // The work of a row is the number of products it accumulates.
+  std::vector<index_type> work(m + 1, 0);
+  for (index_type i = 0; i < m; ++i)
+  {
+    work[i + 1] = work[i];
+    for (auto p = aRows[i]; p < aRows[i + 1]; ++p)
+      work[i + 1] += bRows[aCols[p] + 1] - bRows[aCols[p]];
+  }
+  const int tasks = numTasks(static_cast<double>(work[m]), m);
+  auto bounds = balancedRows(&work[0], m, tasks);
+
+  std::vector<index_type> offsets(m + 1, 0);
+  runRows(bounds, [&](int, index_type begin, index_type end)
+  {
+    std::vector<index_type> marker(n, -1);
+    for (auto i = begin; i < end; ++i)
+    {
+      index_type count = 0;
+      for (auto p = aRows[i]; p < aRows[i + 1]; ++p)
+        for (auto q = bRows[aCols[p]]; q < bRows[aCols[p] + 1]; ++q)
+          if (marker[bCols[q]] != i)
+          {
+            marker[bCols[q]] = i;
+            ++count;
+          }
+      offsets[i + 1] = count;
+    }
+  });
+
+  auto C = allocateRows(m, n, offsets);
+  auto* cCols = C->innerIndexPtr();
+  auto* cValues = C->valuePtr();
+  runRows(bounds, [&](int, index_type begin, index_type end)
+  {
+    std::vector<index_type> marker(n, -1);
+    std::vector<double> accumulator(n);
+    for (auto i = begin; i < end; ++i)
+    {
+      auto last = offsets[i];
+      for (auto p = aRows[i]; p < aRows[i + 1]; ++p)
+        for (auto q = bRows[aCols[p]]; q < bRows[aCols[p] + 1]; ++q)
+        {
+          auto j = bCols[q];
+          if (marker[j] != i)
+          {
+            marker[j] = i;
+            accumulator[j] = aValues[p] * bValues[q];
+            cCols[last++] = j;
+          }
+          else
+            accumulator[j] += aValues[p] * bValues[q];
+        }
+      std::sort(cCols + offsets[i], cCols + last);
+      for (auto k = offsets[i]; k < last; ++k)
+        cValues[k] = accumulator[cCols[k]];
+    }
+  });
+  return C;
+}
+
+BlockedMatrixKernels::Dense BlockedMatrixKernels::multiply(const SparseRowMatrix& A, const Dense& X)
+{
+  ENSURE_DIMENSIONS_MATCH(A.cols(), X.rows(), "Inner dimensions of the sparse-dense product do not match");
+  if (!A.isCompressed())
+    return multiply(compressedCopy(A), X);
+
+  const index_type m = A.rows();
+  std::vector<index_type> work(A.outerIndexPtr(), A.outerIndexPtr() + m + 1);
+  const int tasks = numTasks(static_cast<double>(A.nonZeros()) * X.cols(), m);
+  auto bounds = balancedRows(&work[0], m, tasks);
+
+  Dense C(m, X.cols());
+  runRows(bounds, [&](int, index_type begin, index_type end)
+  {
+    C.middleRows(begin, end - begin).noalias() = A.middleRows(begin, end - begin) * X;
+  });
+  return C;
+}
+
+BlockedMatrixKernels::Dense BlockedMatrixKernels::multiply(const Dense& X, const SparseRowMatrix& A)
+{
+  ENSURE_DIMENSIONS_MATCH(X.cols(), A.rows(), "Inner dimensions of the dense-sparse product do not match");
+  const int tasks = numTasks(static_cast<double>(A.nonZeros()) * X.rows(), X.rows());
+
+  Dense C(X.rows(), A.cols());
+  Parallel::RunRange(X.rows(), tasks, [&](int, size_t begin, size_t end)
+  {
+    C.middleRows(begin, end - begin).noalias() = X.middleRows(begin, end - begin) * A;
+  });
+  return C;
+}
+
+BlockedMatrixKernels::Dense BlockedMatrixKernels::multiply(const Dense& A, const Dense& B)
+{
+  ENSURE_DIMENSIONS_MATCH(A.cols(), B.rows(), "Inner dimensions of the dense product do not match");
+  const double flops = static_cast<double>(A.rows()) * A.cols() * B.cols();
+  Dense C(A.rows(), B.cols());
+
+  // Column blocks of B when there are enough of them, otherwise row blocks of A;
+  // each block goes through Eigen's cache-blocked GEMM.
+  const bool byColumns = B.cols() >= static_cast<Eigen::Index>(Parallel::NumCores());
+  const int tasks = numTasks(flops, byColumns ? B.cols() : A.rows());
+  if (byColumns)
+    Parallel::RunRange(B.cols(), tasks, [&](int, size_t begin, size_t end)
+    {
+      C.middleCols(begin, end - begin).noalias() = A * B.middleCols(begin, end - begin);
+    });
+  else
+    Parallel::RunRange(A.rows(), tasks, [&](int, size_t begin, size_t end)
+    {
+      C.middleRows(begin, end - begin).noalias() = A.middleRows(begin, end - begin) * B;
+    });
+  return C;
+}
+
+SparseRowMatrixHandle BlockedMatrixKernels::add(const SparseRowMatrix& A, const SparseRowMatrix& B, double scale)
+{
+  ENSURE_DIMENSIONS_MATCH(A.rows(), B.rows(), "Sparse summands need the same number of rows");
+  ENSURE_DIMENSIONS_MATCH(A.cols(), B.cols(), "Sparse summands need the same number of columns");
+  if (!A.isCompressed())
+    return add(compressedCopy(A), B, scale);
+  if (!B.isCompressed())
+    return add(A, compressedCopy(B), scale);
+
+  const index_type m = A.rows();
+  const auto *aRows = A.outerIndexPtr(), *aCols = A.innerIndexPtr(), *bRows = B.outerIndexPtr(), *bCols = B.innerIndexPtr();
+  const auto *aValues = A.valuePtr(), *bValues = B.valuePtr();
+
+  std::vector<index_type> work(m + 1);
+  for (index_type i = 0; i <= m; ++i)
+    work[i] = aRows[i] + bRows[i];
+  const int tasks = numTasks(static_cast<double>(work[m]), m);
+  // A single task is better served by Eigen's one-pass merge.
+  if (tasks == 1)
+    return boost::make_shared<SparseRowMatrix>(A + scale * B);
+  auto bounds = balancedRows(&work[0], m, tasks);
+
+  // Both passes merge the sorted column indices of a row of A and a row of B.
+  std::vector<index_type> offsets(m + 1, 0);
+  runRows(bounds, [&](int, index_type begin, index_type end)
+  {
+    for (auto i = begin; i < end; ++i)
+    {
+      auto p = aRows[i], q = bRows[i];
+      index_type count = 0;
+      while (p < aRows[i + 1] || q < bRows[i + 1])
+      {
+        if (q == bRows[i + 1] || (p < aRows[i + 1] && aCols[p] < bCols[q]))
+          ++p;
+        else if (p == aRows[i + 1] || bCols[q] < aCols[p])
+          ++q;
+        else
+        {
+          ++p;
+          ++q;
+        }
+        ++count;
+      }
+      offsets[i + 1] = count;
+    }
+  });
+
+  auto C = allocateRows(m, A.cols(), offsets);
+  auto* cCols = C->innerIndexPtr();
+  auto* cValues = C->valuePtr();
+  runRows(bounds, [&](int, index_type begin, index_type end)
+  {
+    for (auto i = begin; i < end; ++i)
+    {
+      auto p = aRows[i], q = bRows[i], k = offsets[i];
+      while (p < aRows[i + 1] || q < bRows[i + 1])
+      {
+        if (q == bRows[i + 1] || (p < aRows[i + 1] && aCols[p] < bCols[q]))
+        {
+          cCols[k] = aCols[p];
+          cValues[k] = aValues[p++];
+        }
+        else if (p == aRows[i + 1] || bCols[q] < aCols[p])
+        {
+          cCols[k] = bCols[q];
+          cValues[k] = scale * bValues[q++];
+        }
+        else
+        {
+          cCols[k] = aCols[p];
+          cValues[k] = aValues[p++] + scale * bValues[q++];
+        }
+        ++k;
+      }
+    }
+  });
+  return C;
+}
+
+BlockedMatrixKernels::Dense BlockedMatrixKernels::add(const Dense& A, const Dense& B, double scale)
+{
+  ENSURE_DIMENSIONS_MATCH(A.rows(), B.rows(), "Summands need the same number of rows");
+  ENSURE_DIMENSIONS_MATCH(A.cols(), B.cols(), "Summands need the same number of columns");
+  Dense C(A.rows(), A.cols());
+  const int tasks = numTasks(static_cast<double>(A.size()), A.cols());
+  Parallel::RunRange(A.cols(), tasks, [&](int, size_t begin, size_t end)
+  {
+    C.middleCols(begin, end - begin) = A.middleCols(begin, end - begin) + scale * B.middleCols(begin, end - begin);
+  });
+  return C;
+}
+
+SparseRowMatrixHandle BlockedMatrixKernels::transpose(const SparseRowMatrix& A)
+{
+  if (!A.isCompressed())
+    return transpose(compressedCopy(A));
+
+  const index_type m = A.rows(), n = A.cols();
+  const auto *aRows = A.outerIndexPtr(), *aCols = A.innerIndexPtr();
+  const auto* aValues = A.valuePtr();
+  const int tasks = numTasks(static_cast<double>(A.nonZeros()), m);
+  auto bounds = balancedRows(aRows, m, tasks);
+
+  // Counts per (task, column) turn into scatter positions laid out column-major,
+  // task-minor, so the rows of each transposed row stay in increasing order.
+  std::vector<index_type> next(static_cast<size_t>(tasks) * n, 0);
+  runRows(bounds, [&](int task, index_type begin, index_type end)
+  {
+    auto* count = &next[task * n];
+    for (auto p = aRows[begin]; p < aRows[end]; ++p)
+      ++count[aCols[p]];
+  });
+
+  std::vector<index_type> offsets(n + 1, 0);
+  index_type sum = 0;
+  for (index_type j = 0; j < n; ++j)
+  {
+    for (int task = 0; task < tasks; ++task)
+    {
+      auto& slot = next[task * n + j];
+      auto count = slot;
+      slot = sum;
+      sum += count;
+    }
+    offsets[j + 1] = sum;
+  }
+
+  auto C = boost::make_shared<SparseRowMatrix>(static_cast<int>(n), static_cast<int>(m));
+  C->resizeNonZeros(sum);
+  std::copy(offsets.begin(), offsets.end(), C->outerIndexPtr());
+  auto* cCols = C->innerIndexPtr();
+  auto* cValues = C->valuePtr();
+  runRows(bounds, [&](int task, index_type begin, index_type end)
+  {
+    auto* position = &next[task * n];
+    for (auto i = begin; i < end; ++i)
+      for (auto p = aRows[i]; p < aRows[i + 1]; ++p)
+      {
+        auto k = position[aCols[p]]++;
+        cCols[k] = i;
+        cValues[k] = aValues[p];
+      }
+  });
+  return C;
+}
+
+BlockedMatrixKernels::Dense BlockedMatrixKernels::transpose(const Dense& A)
+{
+  Dense C(A.cols(), A.rows());
+  const int tasks = numTasks(static_cast<double>(A.size()), A.cols());
+  Parallel::RunRange(A.cols(), tasks, [&](int, size_t first, size_t last)
+  {
+    // Square tiles keep both the reads and the writes within a few cache lines.
+    const Eigen::Index begin = first, end = last;
+    for (auto j = begin; j < end; j += transposeTile)
+    {
+      auto width = std::min(transposeTile, end - j);
+      for (Eigen::Index i = 0; i < A.rows(); i += transposeTile)
+      {
+        auto height = std::min(transposeTile, A.rows() - i);
+        C.block(j, i, width, height) = A.block(i, j, height, width).transpose();
+      }
+    }
+  });
+  return C;
+}
+
+SparseRowMatrixHandle BlockedMatrixKernels::scale(double s, const SparseRowMatrix& A)
+{
+  auto C = boost::make_shared<SparseRowMatrix>(compressedCopy(A));
+  auto* values = C->valuePtr();
+  const auto nnz = C->nonZeros();
+  const int tasks = numTasks(static_cast<double>(nnz), nnz);
+  Parallel::RunRange(nnz, tasks, [&](int, size_t begin, size_t end)
+  {
+    for (auto k = begin; k < end; ++k)
+      values[k] *= s;
+  });
+  return C;
+}
+
+BlockedMatrixKernels::Dense BlockedMatrixKernels::scale(double s, const Dense& A)
+{
+  Dense C(A.rows(), A.cols());
+  const int tasks = numTasks(static_cast<double>(A.size()), A.cols());
+  Parallel::RunRange(A.cols(), tasks, [&](int, size_t begin, size_t end)
+  {
+    C.middleCols(begin, end - begin) = s * A.middleCols(begin, end - begin);
+  });
+  return C;
+}
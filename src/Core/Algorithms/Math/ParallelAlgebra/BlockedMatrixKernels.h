@@ -0,0 +1,76 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_PARALLELALGEBRA_BLOCKEDMATRIXKERNELS_H
+#define CORE_ALGORITHMS_MATH_PARALLELALGEBRA_BLOCKEDMATRIXKERNELS_H
+
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Multithreaded kernels behind EvaluateLinearAlgebraUnary/Binary. Work is split
+  /// into row or column blocks sized by nonzeros or flops, one task per core;
+  /// inputs too small to fill a block run on the calling thread. Dense products
+  /// keep Eigen's cache-blocked GEMM on each block. Results are built directly,
+  /// without cloning an operand first.
+  class SCISHARE BlockedMatrixKernels
+  {
+  public:
+    typedef Datatypes::DenseMatrix::EigenBase Dense;
+
+    /// Row-by-row (Gustavson) product: a symbolic pass sizes every row of the
+    /// result, a numeric pass fills it. Column indices are sorted in each row.
+    static Datatypes::SparseRowMatrixHandle multiply(const Datatypes::SparseRowMatrix& A, const Datatypes::SparseRowMatrix& B);
+    static Dense multiply(const Datatypes::SparseRowMatrix& A, const Dense& X);
+    static Dense multiply(const Dense& X, const Datatypes::SparseRowMatrix& A);
+    static Dense multiply(const Dense& A, const Dense& B);
+
+    /// A + scale * B, merging the rows of both patterns.
+    static Datatypes::SparseRowMatrixHandle add(const Datatypes::SparseRowMatrix& A, const Datatypes::SparseRowMatrix& B, double scale = 1);
+    static Dense add(const Dense& A, const Dense& B, double scale = 1);
+
+    static Datatypes::SparseRowMatrixHandle transpose(const Datatypes::SparseRowMatrix& A);
+    static Dense transpose(const Dense& A);
+
+    static Datatypes::SparseRowMatrixHandle scale(double s, const Datatypes::SparseRowMatrix& A);
+    static Dense scale(double s, const Dense& A);
+
+    /// Splits every kernel into this many tasks, capped by the rows or columns
+    /// to split, whatever the core count and input size; 0 restores the
+    /// automatic split. Lets tests run the multi-task paths on any machine.
+    static void forceTaskCount(int tasks);
+  };
+
+}}}}
+
+#endif
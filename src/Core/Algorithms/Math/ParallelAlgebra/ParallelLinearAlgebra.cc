@@ -38,6 +38,7 @@
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/CompactSparseRowMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
@@ -48,6 +49,67 @@ using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Thread;
 
+namespace
+{
+  // Matrix kernels over rows [start,end), shared by the index_type and 32-bit layouts.
+
+  template <typename Index>
+  double multRows(const double* data, const Index* rows, const Index* columns,
+    const double* idata, double* odata, const double* cdata, size_t start, size_t end)
+  {
+    double val = 0.0;
+    for (size_t i = start; i < end; i++)
+    {
+      double sum = 0.0;
+      Index row_idx = rows[i];
+      Index next_idx = rows[i + 1];
+      for (Index j = row_idx; j < next_idx; j++)
+      {
+        sum += data[j] * idata[columns[j]];
+      }
+      odata[i] = sum;
+      if (cdata) val += sum * cdata[i];
+    }
+    return val;
+  }
+
+  template <typename Index>
+  void multTransRows(const double* data, const Index* rows, const Index* columns, size_t m,
+    const double* idata, double* odata, size_t start, size_t end)
+  {
+    for (size_t i = start; i < end; i++) odata[i] = 0.0;
+    for (size_t j = 0; j < m; j++)
+    {
+      if (idata[j] == 0.0) continue;
+      double xj = idata[j];
+      auto row_idx = rows[j];
+      auto next_idx = rows[j + 1];
+      auto i = row_idx;
+      for (; i < next_idx && static_cast<size_t>(columns[i]) < start; i++);
+      for (; i < next_idx && static_cast<size_t>(columns[i]) < end; i++)
+        odata[columns[i]] += data[i] * xj;
+    }
+  }
+
+  template <typename Index>
+  void diagRows(const double* data, const Index* rows, const Index* columns,
+    double* odata, size_t start, size_t end, bool absolute)
+  {
+    for (size_t i = start; i < end; i++)
+    {
+      double val = 0.0;
+      size_t row_idx = rows[i];
+      size_t next_idx = rows[i + 1];
+
+      for (size_t j = row_idx; j < next_idx; j++)
+      {
+        if (static_cast<size_t>(columns[j]) == i) val = data[j];
+      }
+      odata[i] = absolute ? std::abs(val) : val;
+    }
+  }
+}
+
 ParallelLinearAlgebraBase::ParallelLinearAlgebraBase()
 {}
 
@@ -59,15 +121,11 @@ ParallelLinearAlgebra::ParallelLinearAlgebra(ParallelLinearAlgebraSharedData& da
   proc_(proc),
   nproc_(data.numProcs())
 {
-  // Compute local size
-  size_ = data.getSize();
-  local_size_ = size_/nproc_;
-
   // Compute start and end index for this thread
-  start_ = proc*local_size_;
-  end_   = (proc+1)*local_size_;
-  if (proc == nproc_-1) end_ = size_;
-  if (proc == nproc_-1) local_size_ = end_ - start_;
+  size_ = data.getSize();
+  start_ = data.rowBegin(proc);
+  end_   = data.rowBegin(proc+1);
+  local_size_ = end_ - start_;
   local_size16_ = (local_size_&(~0xf));
 
   // Set reduction buffers
@@ -133,9 +191,19 @@ bool ParallelLinearAlgebra::add_matrix(SparseRowMatrixHandle mat, ParallelMatrix
 
   if (first())
     mat->makeCompressed(); /// @todo: this should be an invariant of our SparseRowMatrix type.
+  wait();
   M.data_ = mat->valuePtr();
   M.rows_ = mat->outerIndexPtr();
   M.columns_ = mat->innerIndexPtr();
+  M.compactRows_ = nullptr;
+  M.compactColumns_ = nullptr;
+
+  auto compact = data_.compactIndices(mat);
+  if (compact)
+  {
+    M.compactRows_ = compact->rows();
+    M.compactColumns_ = compact->columns();
+  }
 
   M.m_ = mat->nrows();
   M.n_ = mat->ncols();
@@ -630,95 +698,107 @@ void ParallelLinearAlgebra::mult(const ParallelMatrix& a, const ParallelVector&
 {
   wait();
 
-  double* idata = b.data_;
-  double* odata = r.data_;
-
-  double* data = a.data_;
-  auto rows = a.rows_;
-  auto columns = a.columns_;
-
-  for(size_t i=start_;i<end_;i++)
-  {
-    double sum = 0.0;
-    index_type row_idx = rows[i];
-    index_type next_idx = rows[i+1];
-    for(index_type j=row_idx;j<next_idx;j++)
-    {
-	    sum+=data[j]*idata[columns[j]];
-    }
-    odata[i]=sum;
-  }
+  if (a.compactRows_)
+    multRows(a.data_, a.compactRows_, a.compactColumns_, b.data_, r.data_, nullptr, start_, end_);
+  else
+    multRows(a.data_, a.rows_, a.columns_, b.data_, r.data_, nullptr, start_, end_);
 }
 
-void ParallelLinearAlgebra::mult_trans(ParallelMatrix& a, ParallelVector& b, ParallelVector& r)
+double ParallelLinearAlgebra::mult_dot(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r, const ParallelVector& c)
 {
   wait();
 
-  double* idata = b.data_;
-  double* odata = r.data_;
+  double val = a.compactRows_ ?
+    multRows(a.data_, a.compactRows_, a.compactColumns_, b.data_, r.data_, c.data_, start_, end_) :
+    multRows(a.data_, a.rows_, a.columns_, b.data_, r.data_, c.data_, start_, end_);
 
-  double* data = a.data_;
-  auto rows = a.rows_;
-  auto columns = a.columns_;
-  size_t m = a.m_;
+  return(reduce_sum(val));
+}
 
-  for (size_t i=start_; i<end_; i++) odata[i] = 0.0;
-  for (size_t j=0; j<m; j++)
+double ParallelLinearAlgebra::mult_dot(const ParallelVector& a, const ParallelVector& b, ParallelVector& r, const ParallelVector& c)
+{
+  double* a_ptr = a.data_+start_;
+  double* b_ptr = b.data_+start_;
+  double* r_ptr = r.data_+start_;
+  double* c_ptr = c.data_+start_;
+
+  double val = 0.0;
+  for (size_t j=0; j<local_size_; j++)
   {
-    if (idata[j] == 0.0) continue;
-    double xj = idata[j];
-    auto row_idx = rows[j];
-    auto next_idx = rows[j+1];
-    auto i=row_idx;
-    for (; i<next_idx && columns[i] < start_; i++);
-    for (; i<next_idx && columns[i] < end_; i++)
-      odata[columns[i]] += data[i]*xj;
+    double v = a_ptr[j]*b_ptr[j];
+    r_ptr[j] = v;
+    val += v*c_ptr[j];
   }
+
+  return(reduce_sum(val));
 }
 
-void ParallelLinearAlgebra::diag(ParallelMatrix& a, ParallelVector& r)
+double ParallelLinearAlgebra::scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
 {
-  double* odata = r.data_;
-
-  double* data = a.data_;
-  auto rows = a.rows_;
-  auto columns = a.columns_;
+  double* a_ptr = a.data_+start_;
+  double* b_ptr = b.data_+start_;
+  double* r_ptr = r.data_+start_;
 
-  for(size_t i=start_;i<end_;i++)
+  double val = 0.0;
+  for (size_t j=0; j<local_size_; j++)
   {
-    double val = 0.0;
-    size_t row_idx=rows[i];
-    size_t next_idx=rows[i+1];
+    double v = s*a_ptr[j]+b_ptr[j];
+    r_ptr[j] = v;
+    val += v*v;
+  }
 
-    for(size_t j=row_idx;j<next_idx;j++)
-    {
-      if (columns[j] == i) val = data[j];
-    }
-    odata[i]=val;
+  return(sqrt(reduce_sum(val)));
+}
+
+double ParallelLinearAlgebra::scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r,
+  const ParallelVector& d, ParallelVector& z, double& zdot)
+{
+  double* a_ptr = a.data_+start_;
+  double* b_ptr = b.data_+start_;
+  double* r_ptr = r.data_+start_;
+  double* d_ptr = d.data_+start_;
+  double* z_ptr = z.data_+start_;
+
+  double val = 0.0;
+  zdot = 0.0;
+  for (size_t j=0; j<local_size_; j++)
+  {
+    double v = s*a_ptr[j]+b_ptr[j];
+    r_ptr[j] = v;
+    val += v*v;
+    double w = v*d_ptr[j];
+    z_ptr[j] = w;
+    zdot += w*v;
   }
+
+  reduce_sum(val, zdot);
+  return(sqrt(val));
 }
 
-void ParallelLinearAlgebra::absdiag(const ParallelMatrix& a, ParallelVector& r)
+void ParallelLinearAlgebra::mult_trans(ParallelMatrix& a, ParallelVector& b, ParallelVector& r)
 {
-  double* odata = r.data_;
+  wait();
 
-  double* data = a.data_;
-  auto rows = a.rows_;
-  auto columns = a.columns_;
+  if (a.compactRows_)
+    multTransRows(a.data_, a.compactRows_, a.compactColumns_, a.m_, b.data_, r.data_, start_, end_);
+  else
+    multTransRows(a.data_, a.rows_, a.columns_, a.m_, b.data_, r.data_, start_, end_);
+}
 
-  for(size_t i=start_;i<end_;i++)
-  {
-    double val = 0.0;
-    size_t row_idx=rows[i];
-    size_t next_idx=rows[i+1];
+void ParallelLinearAlgebra::diag(ParallelMatrix& a, ParallelVector& r)
+{
+  if (a.compactRows_)
+    diagRows(a.data_, a.compactRows_, a.compactColumns_, r.data_, start_, end_, false);
+  else
+    diagRows(a.data_, a.rows_, a.columns_, r.data_, start_, end_, false);
+}
 
-    for(size_t j=row_idx;j<next_idx;j++)
-    {
-      if (columns[j] == i)
-        val = data[j];
-    }
-    odata[i]=std::abs(val);
-  }
+void ParallelLinearAlgebra::absdiag(const ParallelMatrix& a, ParallelVector& r)
+{
+  if (a.compactRows_)
+    diagRows(a.data_, a.compactRows_, a.compactColumns_, r.data_, start_, end_, true);
+  else
+    diagRows(a.data_, a.rows_, a.columns_, r.data_, start_, end_, true);
 }
 
 double ParallelLinearAlgebra::reduce_sum(double val)
@@ -735,6 +815,21 @@ double ParallelLinearAlgebra::reduce_sum(double val)
   return (ret);
 }
 
+void ParallelLinearAlgebra::reduce_sum(double& val1, double& val2)
+{
+  int buffer = reduce_buffer_;
+  reduce_[buffer][2*proc_] = val1;
+  reduce_[buffer][2*proc_+1] = val2;
+  if (reduce_buffer_)
+    reduce_buffer_ = 0;
+  else
+    reduce_buffer_ = 1;
+  wait();
+
+  val1 = 0.0; val2 = 0.0;
+  for (int j=0; j<nproc_;j++) { val1 += reduce_[buffer][2*j]; val2 += reduce_[buffer][2*j+1]; }
+}
+
 /// @todo: std::max_element
 double ParallelLinearAlgebra::reduce_max(double val)
 {
@@ -804,13 +899,39 @@ ParallelLinearAlgebraSharedData::ParallelLinearAlgebraSharedData(const SolverInp
   size_(inputs.A->nrows()),
   success_(numProcs),
   imatrices_(inputs),
+  partition_(numProcs + 1),
   barrier_("Parallel Linear Algebra", numProcs),
   numProcs_(numProcs),
-  reduce1_(numProcs),
-  reduce2_(numProcs)
+  reduce1_(2*numProcs),
+  reduce2_(2*numProcs)
 {
   if (inputs.b->nrows() != size_
     || inputs.x->nrows() != size_
     || inputs.x0->nrows() != size_)
     BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Dimension mismatch")); /// @todo: use new DimensionMismatch exception type
+
+  // A row costs its nonzeros in a matrix product and about this many entries
+  // in the vector updates of a solver iteration.
+  const size_t vectorWorkPerRow = 4;
+
+  inputs.A->makeCompressed();
+  if (sizeof(index_type) > sizeof(int))
+    compactA_ = convertMatrix::toCompactIndices(inputs.A);
+
+  auto rows = inputs.A->outerIndexPtr();
+  auto work = [rows, vectorWorkPerRow](size_t i) { return static_cast<size_t>(rows[i]) + vectorWorkPerRow*i; };
+  const size_t total = work(size_);
+  size_t row = 0;
+  for (int proc = 0; proc < numProcs; ++proc)
+  {
+    const size_t target = total*proc/numProcs;
+    size_t hi = size_;
+    while (row < hi)
+    {
+      size_t mid = (row + hi)/2;
+      if (work(mid) < target) row = mid + 1; else hi = mid;
+    }
+    partition_[proc] = row;
+  }
+  partition_[numProcs] = size_;
 }
@@ -69,6 +69,9 @@ namespace Math {
   public:
     explicit ParallelLinearAlgebraSharedData(const SolverInputs& inputs, int numProcs);
     size_t getSize() const { return size_; }
+    /// First row owned by a thread. Rows are split so every thread gets about
+    /// the same number of nonzeros plus vector entries, not the same number of rows.
+    size_t rowBegin(int proc) const { return partition_[proc]; }
     Datatypes::DenseColumnMatrixHandle getCurrentMatrix() const { return current_matrix_; }
     void setCurrentMatrix(Datatypes::DenseColumnMatrixHandle mat) { current_matrix_ = mat; }
     void addVector(Datatypes::DenseColumnMatrixHandle mat) { vectors_.push_back(mat); }
@@ -92,6 +95,12 @@ namespace Math {
     }
 
     SolverInputs& inputs() { return imatrices_; }
+    /// 32-bit indices of the system matrix, or null when mat is not the system
+    /// matrix or is too large to be indexed that way. Values stay in mat.
+    Datatypes::CompactSparseIndicesHandle compactIndices(Datatypes::SparseRowMatrixHandle mat) const
+    {
+      return mat == imatrices_.A ? compactA_ : nullptr;
+    }
 
     double* reduceBuffer1() { return &reduce1_[0]; }
     double* reduceBuffer2() { return &reduce2_[0]; }
@@ -102,6 +111,8 @@ namespace Math {
     std::list<Datatypes::DenseColumnMatrixHandle> vectors_;
     std::vector<bool> success_;
     SolverInputs imatrices_;
+    Datatypes::CompactSparseIndicesHandle compactA_;
+    std::vector<size_t> partition_;
     SCIRun::Core::Thread::Barrier barrier_;
     int numProcs_;
     /// classes for communication
@@ -141,6 +152,10 @@ public:
       index_type* rows_;
       index_type* columns_;
       double* data_;
+      /// Set instead of rows_ and columns_ when the matrix has 32-bit copies of
+      /// its indices, which move a quarter less data per product. data_ is shared.
+      const int* compactRows_ = nullptr;
+      const int* compactColumns_ = nullptr;
 
       size_t   m_;
       size_t   n_;
@@ -185,6 +200,18 @@ public:
 
   void mult(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r);
 
+  // Fused kernels: one pass over the vectors and one reduction instead of two of each.
+
+  // r = a*b; returns dot(r,c)
+  double mult_dot(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r, const ParallelVector& c);
+  // r = a.*b; returns dot(r,c)
+  double mult_dot(const ParallelVector& a, const ParallelVector& b, ParallelVector& r, const ParallelVector& c);
+  // r = s*a + b; returns norm(r)
+  double scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
+  // r = s*a + b; z = d.*r; zdot = dot(z,r); returns norm(r)
+  double scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r,
+    const ParallelVector& d, ParallelVector& z, double& zdot);
+
   void absdiag(const ParallelMatrix& a, ParallelVector& r);
 
   void ones(ParallelVector& r);
@@ -197,6 +224,7 @@ public:
 
 private:
   double reduce_sum(double val);
+  void reduce_sum(double& val1, double& val2);
   double reduce_min(double val);
   double reduce_max(double val);
 
@@ -0,0 +1,137 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Math/RandomizedSVD.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Thread/Parallel.h>
+#include <Eigen/QR>
+#include <Eigen/SVD>
+#include <random>
+
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+
+ALGORITHM_PARAMETER_DEF(Math, SVDMethod);
+ALGORITHM_PARAMETER_DEF(Math, SVDRank);
+ALGORITHM_PARAMETER_DEF(Math, SVDOversampling);
+ALGORITHM_PARAMETER_DEF(Math, SVDPowerIterations);
+
+namespace
+{
+  const size_t columnsPerTask = 2048;
+
+  // A*X, summing the products of column blocks of A with row blocks of X.
+  Eigen::MatrixXd multiply(const Eigen::MatrixXd& A, const Eigen::MatrixXd& X)
+  {
+    const int tasks = Parallel::NumTasks(A.cols(), columnsPerTask);
+    std::vector<Eigen::MatrixXd> partial(tasks);
+    Parallel::RunRange(A.cols(), tasks, [&](int task, size_t begin, size_t end)
+    {
+      partial[task].noalias() = A.middleCols(begin, end - begin) * X.middleRows(begin, end - begin);
+    });
+    for (int task = 1; task < tasks; ++task)
+      partial[0] += partial[task];
+    return partial[0];
+  }
+
+  // A^T*X, one row block of the result per column block of A.
+  Eigen::MatrixXd multiplyTransposed(const Eigen::MatrixXd& A, const Eigen::MatrixXd& X)
+  {
+    Eigen::MatrixXd result(A.cols(), X.cols());
+    Parallel::RunRange(A.cols(), Parallel::NumTasks(A.cols(), columnsPerTask), [&](int, size_t begin, size_t end)
+    {
+      result.middleRows(begin, end - begin).noalias() = A.middleCols(begin, end - begin).transpose() * X;
+    });
+    return result;
+  }
+
+  Eigen::MatrixXd orthonormalBasis(const Eigen::MatrixXd& Y)
+  {
+    Eigen::HouseholderQR<Eigen::MatrixXd> qr(Y);
+    return qr.householderQ() * Eigen::MatrixXd::Identity(Y.rows(), Y.cols());
+  }
+}
+
+RandomizedSVD::RandomizedSVD(int rank, int oversampling, int powerIterations)
+  : rank_(rank), oversampling_(std::max(0, oversampling)), powerIterations_(std::max(0, powerIterations))
+{
+}
+
+void RandomizedSVD::compute(const DenseMatrix::EigenBase& A)
+{
+  if (rank_ < 1)
+    BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Randomized SVD rank must be positive."));
+
+  const Eigen::Index m = A.rows(), n = A.cols();
+  const Eigen::Index k = std::min<Eigen::Index>(rank_, std::min(m, n));
+  const Eigen::Index l = std::min<Eigen::Index>(k + oversampling_, std::min(m, n));
+
+  // A fixed seed keeps repeated executions on the same input identical.
+  std::mt19937 generator(5489u);
+  std::normal_distribution<double> gaussian;
+  Eigen::MatrixXd omega(n, l);
+  for (Eigen::Index j = 0; j < l; ++j)
+    for (Eigen::Index i = 0; i < n; ++i)
+      omega(i, j) = gaussian(generator);
+
+  // Each power iteration sharpens the decay of the sampled spectrum; the basis is
+  // reorthonormalized between products so the small directions are not lost to rounding.
+  Eigen::MatrixXd Q = orthonormalBasis(multiply(A, omega));
+  for (int q = 0; q < powerIterations_; ++q)
+  {
+    Eigen::MatrixXd Z = orthonormalBasis(multiplyTransposed(A, Q));
+    Q = orthonormalBasis(multiply(A, Z));
+  }
+
+  // B = Q^T A is l x n; its SVD comes from the QR of B^T = Z, so only an l x l SVD is dense.
+  Eigen::MatrixXd Z = multiplyTransposed(A, Q);
+  Eigen::HouseholderQR<Eigen::MatrixXd> qr(Z);
+  Eigen::MatrixXd R = qr.matrixQR().topRows(l).triangularView<Eigen::Upper>();
+  Eigen::JacobiSVD<Eigen::MatrixXd> svd(R, Eigen::ComputeFullU | Eigen::ComputeFullV);
+
+  // Z = Qz R = (Qz Ur) S Vr^T, so A ~ Q B = (Q Vr) S (Qz Ur)^T.
+  U_ = Q * svd.matrixV().leftCols(k);
+  S_ = svd.singularValues().head(k);
+  Eigen::MatrixXd Ur = Eigen::MatrixXd::Zero(n, k);
+  Ur.topRows(l) = svd.matrixU().leftCols(k);
+  V_ = qr.householderQ() * Ur;
+}
+
+bool RandomizedSVD::selected(const AlgorithmBase& algo)
+{
+  return algo.getOption(Parameters::SVDMethod) == "randomized";
+}
+
+RandomizedSVD RandomizedSVD::fromParameters(const AlgorithmBase& algo)
+{
+  return RandomizedSVD(algo.get(Parameters::SVDRank).toInt(), algo.get(Parameters::SVDOversampling).toInt(),
+    algo.get(Parameters::SVDPowerIterations).toInt());
+}
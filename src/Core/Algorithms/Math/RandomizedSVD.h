@@ -0,0 +1,84 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_MATH_RANDOMIZEDSVD_H
+#define CORE_ALGORITHMS_MATH_RANDOMIZEDSVD_H
+
+#include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Shared by the algorithms that decompose a dense matrix: SVDMethod is
+  /// "full" or "randomized"; the other three configure the randomized method.
+  ALGORITHM_PARAMETER_DECL(SVDMethod);
+  ALGORITHM_PARAMETER_DECL(SVDRank);
+  ALGORITHM_PARAMETER_DECL(SVDOversampling);
+  ALGORITHM_PARAMETER_DECL(SVDPowerIterations);
+
+  /// Truncated SVD by a randomized range finder (Halko, Martinsson and Tropp):
+  /// A is sampled with rank + oversampling Gaussian vectors, the sample is
+  /// refined by power iterations, and the SVD of A projected onto that basis
+  /// gives the leading singular triplets. It costs O(mn(rank + oversampling))
+  /// instead of the O(mn min(m,n)) of a full SVD, and the products with A run
+  /// in parallel over column blocks.
+  class SCISHARE RandomizedSVD
+  {
+  public:
+    RandomizedSVD(int rank, int oversampling = 10, int powerIterations = 2);
+
+    void compute(const Datatypes::DenseMatrix::EigenBase& A);
+
+    /// m x k, k x 1 and n x k, where k is the rank clamped to min(m,n).
+    const Datatypes::DenseMatrix& matrixU() const { return U_; }
+    const Datatypes::DenseColumnMatrix& singularValues() const { return S_; }
+    const Datatypes::DenseMatrix& matrixV() const { return V_; }
+
+    /// Whether the algorithm is set to the randomized method.
+    static bool selected(const AlgorithmBase& algo);
+    /// A solver configured from the algorithm's parameters.
+    static RandomizedSVD fromParameters(const AlgorithmBase& algo);
+
+  private:
+    int rank_;
+    int oversampling_;
+    int powerIterations_;
+    Datatypes::DenseMatrix U_;
+    Datatypes::DenseColumnMatrix S_;
+    Datatypes::DenseMatrix V_;
+  };
+
+}}}}
+
+#endif
@@ -56,6 +56,8 @@ namespace Math {
     Out runImpl(const In& input, const Parameters& params) const;
     template <typename SolverType, typename In, typename Out>
     Out solve(const In& input, const Parameters& params) const;
+    template <typename In, typename Out>
+    Out solveMixed(const In& input, const Parameters& params) const;
   };
 
 
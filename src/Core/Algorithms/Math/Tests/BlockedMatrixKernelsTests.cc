@@ -0,0 +1,206 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/BlockedMatrixKernels.h>
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::Math;
+
+namespace
+{
+  typedef BlockedMatrixKernels::Dense Dense;
+
+  SparseRowMatrix randomSparse(int rows, int cols, double density, unsigned seed)
+  {
+    std::mt19937 generator(seed);
+    std::uniform_int_distribution<int> row(0, rows - 1), col(0, cols - 1);
+    std::uniform_real_distribution<double> value(-1, 1);
+    std::vector<SparseRowMatrix::Triplet> entries;
+    const auto count = static_cast<size_t>(density * rows * cols);
+    for (size_t k = 0; k < count; ++k)
+      entries.push_back(SparseRowMatrix::Triplet(row(generator), col(generator), value(generator)));
+    SparseRowMatrix A(rows, cols);
+    A.setFromTriplets(entries.begin(), entries.end());
+    return A;
+  }
+
+  Dense dense(const SparseRowMatrix& A)
+  {
+    return Dense(A);
+  }
+
+  template <class Op>
+  double milliseconds(Op op)
+  {
+    auto start = std::chrono::steady_clock::now();
+    op();
+    return 1000 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  // Same entries, same pattern, and sorted column indices in every row.
+  void expectSameSparse(const SparseRowMatrix& expected, const SparseRowMatrix& actual, int tasks)
+  {
+    ASSERT_TRUE(actual.isCompressed()) << tasks << " tasks";
+    EXPECT_EQ(expected.nonZeros(), actual.nonZeros()) << tasks << " tasks";
+    EXPECT_TRUE(dense(actual).isApprox(dense(expected))) << tasks << " tasks";
+    for (int i = 0; i < actual.outerSize(); ++i)
+      EXPECT_TRUE(std::is_sorted(actual.innerIndexPtr() + actual.outerIndexPtr()[i], actual.innerIndexPtr() + actual.outerIndexPtr()[i + 1]));
+  }
+}
+
+TEST(BlockedMatrixKernelsTests, SparseKernelsMatchEigen)
+{
+  auto A = randomSparse(300, 200, 0.02, 1);
+  auto B = randomSparse(200, 250, 0.02, 2);
+  auto C = randomSparse(300, 200, 0.02, 3);
+
+  auto product = BlockedMatrixKernels::multiply(A, B);
+  EXPECT_TRUE(dense(*product).isApprox(dense(A) * dense(B)));
+  EXPECT_EQ(SparseRowMatrix(A * B).nonZeros(), product->nonZeros());
+
+  auto difference = BlockedMatrixKernels::add(A, C, -1);
+  EXPECT_TRUE(dense(*difference).isApprox(dense(A) - dense(C)));
+
+  auto transposed = BlockedMatrixKernels::transpose(A);
+  EXPECT_EQ(200, transposed->rows());
+  EXPECT_TRUE(dense(*transposed).isApprox(dense(A).transpose()));
+
+  auto scaled = BlockedMatrixKernels::scale(-2, A);
+  EXPECT_TRUE(dense(*scaled).isApprox(-2 * dense(A)));
+
+  for (auto m : { product, difference, transposed, scaled })
+  {
+    EXPECT_TRUE(m->isCompressed());
+    for (int i = 0; i < m->outerSize(); ++i)
+      EXPECT_TRUE(std::is_sorted(m->innerIndexPtr() + m->outerIndexPtr()[i], m->innerIndexPtr() + m->outerIndexPtr()[i + 1]));
+  }
+}
+
+TEST(BlockedMatrixKernelsTests, AcceptsUncompressedInput)
+{
+  auto A = randomSparse(50, 40, 0.1, 4);
+  SparseRowMatrix uncompressed(A);
+  uncompressed.coeffRef(3, 7) += 1;
+  uncompressed.insert(49, 0) = 2;
+  ASSERT_FALSE(uncompressed.isCompressed());
+
+  EXPECT_TRUE(dense(*BlockedMatrixKernels::transpose(uncompressed)).isApprox(dense(uncompressed).transpose()));
+  EXPECT_TRUE(dense(*BlockedMatrixKernels::multiply(uncompressed, *BlockedMatrixKernels::transpose(A))).isApprox(dense(uncompressed) * dense(A).transpose()));
+}
+
+TEST(BlockedMatrixKernelsTests, DenseKernelsMatchEigen)
+{
+  Dense A = Dense::Random(70, 90), B = Dense::Random(90, 50), C = Dense::Random(70, 90);
+  auto S = randomSparse(90, 60, 0.05, 5);
+
+  EXPECT_TRUE(BlockedMatrixKernels::multiply(A, B).isApprox(A * B));
+  EXPECT_TRUE(BlockedMatrixKernels::multiply(A, Dense(B.col(0))).isApprox(A * B.col(0)));
+  EXPECT_TRUE(BlockedMatrixKernels::multiply(A, S).isApprox(A * dense(S)));
+  Dense X = Dense::Random(60, 7);
+  EXPECT_TRUE(BlockedMatrixKernels::multiply(S, X).isApprox(dense(S) * X));
+  EXPECT_TRUE(BlockedMatrixKernels::add(A, C, 0.5).isApprox(A + 0.5 * C));
+  EXPECT_TRUE(BlockedMatrixKernels::transpose(A).isApprox(A.transpose()));
+  EXPECT_TRUE(BlockedMatrixKernels::scale(3, A).isApprox(3 * A));
+  EXPECT_THROW(BlockedMatrixKernels::multiply(A, A), SCIRun::Core::DimensionMismatch);
+}
+
+TEST(BlockedMatrixKernelsTests, MultiTaskSplitsMatchEigen)
+{
+  auto A = randomSparse(400, 300, 0.03, 6);
+  auto B = randomSparse(300, 350, 0.03, 7);
+  auto C = randomSparse(400, 300, 0.03, 8);
+  // Empty leading rows make the balanced splits produce empty ranges too.
+  A.prune([](SCIRun::index_type row, SCIRun::index_type, double) { return row >= 100; });
+  Dense X = Dense::Random(300, 9), Y = Dense::Random(11, 400), D = Dense::Random(80, 60), E = Dense::Random(60, 3);
+
+  for (int tasks : { 2, 3, 7, 500 })
+  {
+    BlockedMatrixKernels::forceTaskCount(tasks);
+    expectSameSparse(A * B, *BlockedMatrixKernels::multiply(A, B), tasks);
+    expectSameSparse(A - C, *BlockedMatrixKernels::add(A, C, -1), tasks);
+    expectSameSparse(A.transpose(), *BlockedMatrixKernels::transpose(A), tasks);
+    expectSameSparse(2 * A, *BlockedMatrixKernels::scale(2, A), tasks);
+
+    EXPECT_TRUE(BlockedMatrixKernels::multiply(A, X).isApprox(dense(A) * X)) << tasks;
+    EXPECT_TRUE(BlockedMatrixKernels::multiply(Y, A).isApprox(Y * dense(A))) << tasks;
+    EXPECT_TRUE(BlockedMatrixKernels::multiply(D, E).isApprox(D * E)) << tasks;
+    EXPECT_TRUE(BlockedMatrixKernels::multiply(D, Dense(D.transpose())).isApprox(D * D.transpose())) << tasks;
+    EXPECT_TRUE(BlockedMatrixKernels::add(D, D, -0.5).isApprox(0.5 * D)) << tasks;
+    EXPECT_TRUE(BlockedMatrixKernels::transpose(D).isApprox(D.transpose())) << tasks;
+    EXPECT_TRUE(BlockedMatrixKernels::scale(3, D).isApprox(3 * D)) << tasks;
+  }
+  BlockedMatrixKernels::forceTaskCount(0);
+}
+
+// Prints serial and blocked times for each operation, size and sparsity. Run it
+// by hand with --gtest_also_run_disabled_tests.
+TEST(BlockedMatrixKernelsTests, DISABLED_OperationSizeSparsityTime)
+{
+  // Reference columns are the serial expressions the EvaluateLinearAlgebra visitors evaluate.
+  for (int n : { 4000, 16000 })
+    for (double perRow : { 4.0, 32.0 })
+    {
+      auto A = randomSparse(n, n, perRow / n, 6);
+      auto B = randomSparse(n, n, perRow / n, 7);
+      Dense X = Dense::Random(n, 32);
+      SparseRowMatrixHandle product, sum, transposed;
+      Dense applied;
+
+      auto spgemmSerial = milliseconds([&] { SparseRowMatrix reference(A * B); });
+      auto spgemm = milliseconds([&] { product = BlockedMatrixKernels::multiply(A, B); });
+      auto addSerial = milliseconds([&] { SparseRowMatrix reference(A + B); });
+      auto add = milliseconds([&] { sum = BlockedMatrixKernels::add(A, B); });
+      auto transposeSerial = milliseconds([&] { SparseRowMatrix reference(A.transpose()); });
+      auto transpose = milliseconds([&] { transposed = BlockedMatrixKernels::transpose(A); });
+      auto spmmSerial = milliseconds([&] { SparseRowMatrix reference(A * *convertMatrix::fromDenseToSparse(DenseMatrix(X))); });
+      auto spmm = milliseconds([&] { applied = BlockedMatrixKernels::multiply(A, X); });
+      EXPECT_EQ(SparseRowMatrix(A * B).nonZeros(), product->nonZeros());
+
+      std::cout << "sparse n=" << n << ", " << perRow << " per row (serial / blocked ms): A*B "
+        << spgemmSerial << " / " << spgemm << ", A+B " << addSerial << " / " << add
+        << ", A^T " << transposeSerial << " / " << transpose << ", A*X(32 cols) " << spmmSerial << " / " << spmm << std::endl;
+    }
+
+  for (int n : { 500, 1500 })
+  {
+    Dense A = Dense::Random(n, n), B = Dense::Random(n, n), C;
+    auto gemmSerial = milliseconds([&] { C.noalias() = A * B; });
+    auto gemm = milliseconds([&] { C = BlockedMatrixKernels::multiply(A, B); });
+    auto transposeSerial = milliseconds([&] { DenseMatrix reference(A); reference.transposeInPlace(); });
+    auto transpose = milliseconds([&] { C = BlockedMatrixKernels::transpose(A); });
+    std::cout << "dense n=" << n << " (serial / blocked ms): A*B " << gemmSerial << " / " << gemm
+      << ", A^T " << transposeSerial << " / " << transpose << std::endl;
+  }
+}
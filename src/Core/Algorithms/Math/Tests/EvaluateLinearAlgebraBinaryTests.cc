@@ -34,6 +34,7 @@
 #include <Core/Datatypes/MatrixComparison.h>
 #include <Core/Datatypes/MatrixIO.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Datatypes/LinearOperator.h>
 #include <Core/Datatypes/Tests/MatrixTestCases.h>
 
 using namespace SCIRun::Core::Datatypes;
@@ -181,3 +182,40 @@ TEST(EvaluateLinearAlgebraBinaryAlgorithmTests, CanUseFunctionSparseDense)
   auto result = castMatrix::toSparse(EvalOperator<SPARSE_ROW, DENSE>({ EvaluateLinearAlgebraBinaryAlgorithm::FUNCTION, functionArg }));
   EXPECT_SPARSE_EQ(*matrix1sparse() + *matrix1sparse(), *result);
 }
+
+TEST(EvaluateLinearAlgebraBinaryAlgorithmTests, LazyOperationsReturnLinearOperators)
+{
+  for (auto op : { EvaluateLinearAlgebraBinaryAlgorithm::ADD, EvaluateLinearAlgebraBinaryAlgorithm::SUBTRACT, EvaluateLinearAlgebraBinaryAlgorithm::MULTIPLY })
+  {
+    auto lazy = EvalOperator<SPARSE_ROW, SPARSE_ROW>({ op, "", true });
+    ASSERT_TRUE(matrixIs::linearOperator(lazy)) << op;
+    auto eager = EvalOperator<SPARSE_ROW, SPARSE_ROW>({ op });
+    EXPECT_TRUE(convertMatrix::toDense(eager)->isApprox(*convertMatrix::toDense(lazy))) << op;
+  }
+}
+
+TEST(EvaluateLinearAlgebraBinaryAlgorithmTests, LinearOperatorOperandsStayLazy)
+{
+  auto normal = LinearOperator::product(LinearOperator::transpose(matrix1sparse()), matrix1sparse());
+  auto sum = EvalBinaryOperator(normal, matrix1sparse(), { EvaluateLinearAlgebraBinaryAlgorithm::ADD });
+  ASSERT_TRUE(matrixIs::linearOperator(sum));
+  DenseMatrix expected = matrix1().transpose() * matrix1() + matrix1();
+  EXPECT_TRUE(convertMatrix::toDense(sum)->isApprox(expected));
+}
+
+TEST(EvaluateLinearAlgebraBinaryAlgorithmTests, LinearOperatorIsAppliedToDenseOperands)
+{
+  auto normal = LinearOperator::product(LinearOperator::transpose(matrix1sparse()), matrix1sparse());
+  DenseColumnMatrixHandle x(boost::make_shared<DenseColumnMatrix>(3));
+  *x << 1, 2, 3;
+
+  auto ax = castMatrix::toColumn(EvalBinaryOperator(normal, x, { EvaluateLinearAlgebraBinaryAlgorithm::MULTIPLY }));
+  ASSERT_NE(nullptr, ax);
+  DenseColumnMatrix expected = matrix1().transpose() * matrix1() * *x;
+  EXPECT_TRUE(ax->isApprox(expected));
+
+  auto xa = castMatrix::toDense(EvalBinaryOperator(matrix1H(), normal, { EvaluateLinearAlgebraBinaryAlgorithm::MULTIPLY }));
+  ASSERT_NE(nullptr, xa);
+  DenseMatrix expectedLeft = matrix1() * matrix1().transpose() * matrix1();
+  EXPECT_TRUE(xa->isApprox(expectedLeft));
+}
@@ -34,6 +34,7 @@
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/MatrixComparison.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Datatypes/LinearOperator.h>
 
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Algorithms::Math;
@@ -162,3 +163,33 @@ TEST(EvaluateLinearAlgebraUnaryAlgorithmTests, CanUseFunctionColumn)
   DenseColumnMatrixHandle result = castMatrix::toColumn(algo.run(m, { EvaluateLinearAlgebraUnaryAlgorithm::FUNCTION, 0.0, functionArg }));
   EXPECT_EQ((m->array() + 5).matrix(), *result);
 }
+
+TEST(EvaluateLinearAlgebraUnaryAlgorithmTests, LinearOperatorInputStaysLazy)
+{
+  EvaluateLinearAlgebraUnaryAlgorithm algo;
+  MatrixHandle twice = LinearOperator::sum(matrix1sparse(), matrix1sparse());
+
+  auto negated = algo.run(twice, { EvaluateLinearAlgebraUnaryAlgorithm::NEGATE });
+  ASSERT_TRUE(matrixIs::linearOperator(negated));
+  EXPECT_EQ(DenseMatrix(-2 * matrix1()), *convertMatrix::toDense(negated));
+
+  auto transposed = algo.run(twice, { EvaluateLinearAlgebraUnaryAlgorithm::TRANSPOSE });
+  ASSERT_TRUE(matrixIs::linearOperator(transposed));
+  EXPECT_EQ(DenseMatrix(2 * matrix1().transpose()), *convertMatrix::toDense(transposed));
+
+  auto scaled = algo.run(twice, { EvaluateLinearAlgebraUnaryAlgorithm::SCALAR_MULTIPLY, 2.5 });
+  ASSERT_TRUE(matrixIs::linearOperator(scaled));
+  EXPECT_EQ(DenseMatrix(5 * matrix1()), *convertMatrix::toDense(scaled));
+
+  auto function = castMatrix::toDense(algo.run(twice, { EvaluateLinearAlgebraUnaryAlgorithm::FUNCTION, 0.0, "x+5" }));
+  ASSERT_NE(nullptr, function);
+  EXPECT_EQ(DenseMatrix(((2 * matrix1()).array() + 5).matrix()), *function);
+}
+
+TEST(EvaluateLinearAlgebraUnaryAlgorithmTests, LazyParameterDefersTranspose)
+{
+  EvaluateLinearAlgebraUnaryAlgorithm algo;
+  auto result = algo.run(matrix1sparse(), { EvaluateLinearAlgebraUnaryAlgorithm::TRANSPOSE, 0.0, "", true });
+  ASSERT_TRUE(matrixIs::linearOperator(result));
+  EXPECT_EQ(DenseMatrix(matrix1().transpose()), *convertMatrix::toDense(result));
+}
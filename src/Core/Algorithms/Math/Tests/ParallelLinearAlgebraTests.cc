@@ -29,6 +29,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <algorithm>
 #include <fstream>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
 #include <Core/Datatypes/DenseMatrix.h>
@@ -976,3 +977,145 @@ TEST(ParallelArithmeticTests, CanComputeDotProductMulti)
   EXPECT_EQ(-9 , v23);
   EXPECT_EQ(9 , v13);
 }
+
+namespace
+{
+  // Rows in the first tenth couple to 40 neighbors, the rest only to themselves,
+  // like a mesh refined at one end.
+  SparseRowMatrixHandle refinedMatrix()
+  {
+    std::vector<SparseRowMatrix::Triplet> entries;
+    for (int i = 0; i < size; ++i)
+    {
+      entries.push_back(SparseRowMatrix::Triplet(i, i, 50.0 + i % 7));
+      if (i < size / 10)
+        for (int k = 1; k <= 20; ++k)
+        {
+          entries.push_back(SparseRowMatrix::Triplet(i, (i + k) % size, -1.0));
+          entries.push_back(SparseRowMatrix::Triplet(i, (i + size - k) % size, -0.5));
+        }
+    }
+    SparseRowMatrixHandle m(boost::make_shared<SparseRowMatrix>(size, size));
+    m->setFromTriplets(entries.begin(), entries.end());
+    return m;
+  }
+
+  DenseColumnMatrixHandle rampVector(double scale)
+  {
+    DenseColumnMatrixHandle v(boost::make_shared<DenseColumnMatrix>(size));
+    for (int i = 0; i < size; ++i)
+      (*v)[i] = scale * ((i % 13) - 6);
+    return v;
+  }
+
+  SolverInputs refinedSystem()
+  {
+    SolverInputs system;
+    system.A = refinedMatrix();
+    system.b = rampVector(1);
+    system.x = rampVector(2);
+    system.x0 = rampVector(3);
+    return system;
+  }
+}
+
+TEST(ParallelLinearAlgebraTests, RowsAreSplitByNonzeros)
+{
+  auto system = refinedSystem();
+  ParallelLinearAlgebraSharedData data(system, 4);
+  auto rows = system.A->outerIndexPtr();
+
+  EXPECT_EQ(0, data.rowBegin(0));
+  EXPECT_EQ(size, data.rowBegin(4));
+  std::vector<size_t> work;
+  for (int proc = 0; proc < 4; ++proc)
+  {
+    auto begin = data.rowBegin(proc), end = data.rowBegin(proc + 1);
+    EXPECT_LE(begin, end);
+    work.push_back(rows[end] - rows[begin] + 4 * (end - begin));
+  }
+  // The refined tenth of the rows holds most of the nonzeros
+  EXPECT_LT(data.rowBegin(1), static_cast<size_t>(size / 10));
+  auto minmax = std::minmax_element(work.begin(), work.end());
+  EXPECT_LE(*minmax.second - *minmax.first, 2 * (41 + 4));
+}
+
+namespace
+{
+  struct FusedResults
+  {
+    double matrixDot, vectorDot, norm, fusedNorm, fusedDot;
+    std::vector<double> product, residual, preconditioned;
+  };
+
+  FusedResults runFusedKernels(int numProcs, bool fused)
+  {
+    auto system = refinedSystem();
+    ParallelLinearAlgebraSharedData data(system, numProcs);
+    auto p = rampVector(0.5), z = rampVector(0), r = rampVector(1), d = rampVector(0.1), w = rampVector(0);
+    FusedResults results;
+
+    Parallel::RunTasks([&](int proc)
+    {
+      ParallelLinearAlgebra pla(data, proc);
+      ParallelLinearAlgebra::ParallelMatrix A;
+      ParallelLinearAlgebra::ParallelVector P, Z, R, D, W;
+      pla.add_matrix(system.A, A);
+      pla.add_vector(p, P); pla.add_vector(z, Z); pla.add_vector(r, R);
+      pla.add_vector(d, D); pla.add_vector(w, W);
+
+      double matrixDot, vectorDot, norm, fusedNorm, fusedDot;
+      if (fused)
+      {
+        matrixDot = pla.mult_dot(A, P, Z, P);
+        vectorDot = pla.mult_dot(R, D, W, R);
+        norm = pla.scale_add_norm(-0.25, Z, R, R);
+        fusedNorm = pla.scale_add_norm(0.5, P, R, R, D, W, fusedDot);
+      }
+      else
+      {
+        pla.mult(A, P, Z);
+        matrixDot = pla.dot(Z, P);
+        pla.mult(R, D, W);
+        vectorDot = pla.dot(W, R);
+        pla.scale_add(-0.25, Z, R, R);
+        norm = pla.norm(R);
+        pla.scale_add(0.5, P, R, R);
+        fusedNorm = pla.norm(R);
+        pla.mult(R, D, W);
+        fusedDot = pla.dot(W, R);
+      }
+      if (pla.first())
+      {
+        results.matrixDot = matrixDot;
+        results.vectorDot = vectorDot;
+        results.norm = norm;
+        results.fusedNorm = fusedNorm;
+        results.fusedDot = fusedDot;
+      }
+    }, numProcs);
+
+    results.product.assign(z->data(), z->data() + size);
+    results.residual.assign(r->data(), r->data() + size);
+    results.preconditioned.assign(w->data(), w->data() + size);
+    return results;
+  }
+}
+
+TEST(ParallelArithmeticTests, FusedKernelsMatchSeparateKernels)
+{
+  for (int numProcs : { 1, 3, 8 })
+  {
+    auto separate = runFusedKernels(numProcs, false);
+    auto fused = runFusedKernels(numProcs, true);
+
+    EXPECT_NEAR(separate.matrixDot, fused.matrixDot, 1e-9 * std::abs(separate.matrixDot));
+    EXPECT_NEAR(separate.vectorDot, fused.vectorDot, 1e-9 * std::abs(separate.vectorDot));
+    EXPECT_NEAR(separate.norm, fused.norm, 1e-9 * separate.norm);
+    EXPECT_NEAR(separate.fusedNorm, fused.fusedNorm, 1e-9 * separate.fusedNorm);
+    EXPECT_NEAR(separate.fusedDot, fused.fusedDot, 1e-9 * std::abs(separate.fusedDot));
+    EXPECT_EQ(separate.product, fused.product);
+    EXPECT_EQ(separate.residual, fused.residual);
+    EXPECT_EQ(separate.preconditioned, fused.preconditioned);
+  }
+}
@@ -0,0 +1,150 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Algorithms/Math/ComputeSVD.h>
+#include <Core/Algorithms/Math/RandomizedSVD.h>
+#include <Eigen/QR>
+#include <Eigen/SVD>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::Math;
+
+namespace
+{
+  // m x n matrix with singular values decay^i and random singular vectors.
+  DenseMatrix::EigenBase decayingMatrix(int m, int n, double decay)
+  {
+    const int k = std::min(m, n);
+    DenseMatrix::EigenBase P = DenseMatrix::EigenBase::Random(m, k);
+    DenseMatrix::EigenBase Q = DenseMatrix::EigenBase::Random(n, k);
+    DenseMatrix::EigenBase U = Eigen::HouseholderQR<DenseMatrix::EigenBase>(P).householderQ() * DenseMatrix::EigenBase::Identity(m, k);
+    DenseMatrix::EigenBase V = Eigen::HouseholderQR<DenseMatrix::EigenBase>(Q).householderQ() * DenseMatrix::EigenBase::Identity(n, k);
+    Eigen::VectorXd s(k);
+    for (int i = 0; i < k; ++i)
+      s[i] = std::pow(decay, i);
+    return U * s.asDiagonal() * V.transpose();
+  }
+
+  double reconstructionError(const DenseMatrix::EigenBase& A, const RandomizedSVD& svd)
+  {
+    DenseMatrix::EigenBase R = svd.matrixU() * svd.singularValues().asDiagonal() * svd.matrixV().transpose();
+    return (A - R).norm() / A.norm();
+  }
+}
+
+TEST(RandomizedSVDTests, RecoversExactlyLowRankMatrix)
+{
+  DenseMatrix::EigenBase A = DenseMatrix::EigenBase::Random(120, 8) * DenseMatrix::EigenBase::Random(8, 300);
+
+  RandomizedSVD svd(8, 5, 0);
+  svd.compute(A);
+
+  EXPECT_EQ(120, svd.matrixU().rows());
+  EXPECT_EQ(8, svd.matrixU().cols());
+  EXPECT_EQ(8, svd.singularValues().rows());
+  EXPECT_EQ(300, svd.matrixV().rows());
+  EXPECT_EQ(8, svd.matrixV().cols());
+  EXPECT_LT(reconstructionError(A, svd), 1e-12);
+
+  DenseMatrix::EigenBase I = DenseMatrix::EigenBase::Identity(8, 8);
+  EXPECT_TRUE((svd.matrixU().transpose() * svd.matrixU()).isApprox(I, 1e-12));
+  EXPECT_TRUE((svd.matrixV().transpose() * svd.matrixV()).isApprox(I, 1e-12));
+}
+
+TEST(RandomizedSVDTests, MatchesLeadingSingularValuesOfFullSVD)
+{
+  DenseMatrix::EigenBase A = decayingMatrix(150, 400, 0.8);
+  const int rank = 15;
+
+  Eigen::JacobiSVD<DenseMatrix::EigenBase> exact(A);
+  RandomizedSVD svd(rank);
+  svd.compute(A);
+
+  const auto& s = svd.singularValues();
+  double worst = 0;
+  for (int i = 0; i < rank; ++i)
+    worst = std::max(worst, std::abs(s[i] - exact.singularValues()[i]) / exact.singularValues()[i]);
+  EXPECT_LT(worst, 1e-6);
+
+  // The best possible rank-k error is the first discarded singular value.
+  const double optimal = exact.singularValues().tail(exact.singularValues().size() - rank).norm() / A.norm();
+  const double error = reconstructionError(A, svd);
+  EXPECT_LT(error, 1.01 * optimal);
+}
+
+TEST(RandomizedSVDTests, RankIsClampedToMatrixSize)
+{
+  DenseMatrix::EigenBase A = DenseMatrix::EigenBase::Random(6, 40);
+  RandomizedSVD svd(50);
+  svd.compute(A);
+  EXPECT_EQ(6, svd.singularValues().rows());
+  EXPECT_LT(reconstructionError(A, svd), 1e-12);
+}
+
+TEST(RandomizedSVDTests, ComputeSVDAlgoRandomizedOption)
+{
+  ComputeSVDAlgo algo;
+  algo.setOption(Parameters::SVDMethod, "randomized");
+  algo.set(Parameters::SVDRank, 4);
+
+  auto input = boost::make_shared<DenseMatrix>(decayingMatrix(30, 20, 0.5));
+  DenseMatrixHandle U, S, V;
+  algo.run(input, U, S, V);
+
+  ASSERT_NE(nullptr, U);
+  ASSERT_NE(nullptr, S);
+  ASSERT_NE(nullptr, V);
+  EXPECT_EQ(30, U->rows());
+  EXPECT_EQ(4, U->cols());
+  EXPECT_EQ(4, S->rows());
+  EXPECT_EQ(1, S->cols());
+  EXPECT_EQ(20, V->rows());
+  EXPECT_EQ(4, V->cols());
+  EXPECT_NEAR(1.0, (*S)(0, 0), 1e-10);
+  EXPECT_NEAR(0.125, (*S)(3, 0), 1e-10);
+}
+
+TEST(RandomizedSVDTests, WideMatrixSpanningSeveralColumnBlocks)
+{
+  // Wide enough that the products with A are split over column blocks.
+  DenseMatrix::EigenBase A = decayingMatrix(30, 5000, 0.7);
+  const int rank = 10;
+
+  Eigen::JacobiSVD<DenseMatrix::EigenBase> exact(A);
+  RandomizedSVD svd(rank);
+  svd.compute(A);
+
+  EXPECT_EQ(5000, svd.matrixV().rows());
+  for (int i = 0; i < rank; ++i)
+    EXPECT_NEAR(exact.singularValues()[i], svd.singularValues()[i], 1e-8 * exact.singularValues()[i]) << i;
+  const double optimal = exact.singularValues().tail(exact.singularValues().size() - rank).norm() / A.norm();
+  EXPECT_LT(reconstructionError(A, svd), 1.01 * optimal);
+}
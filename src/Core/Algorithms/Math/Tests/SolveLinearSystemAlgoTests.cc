@@ -31,15 +31,18 @@
 #include <fstream>
 #include <boost/filesystem.hpp>
 #include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Math/LinearSystem/SparseDirectSolver.h>
 #include <Core/Algorithms/DataIO/ReadMatrix.h>
 #include <Core/Algorithms/DataIO/WriteMatrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/LinearOperator.h>
 #include <Core/Datatypes/MatrixComparison.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Core/Datatypes/MatrixIO.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 
 using namespace SCIRun::Core::Datatypes;
@@ -114,6 +117,183 @@ void CanSolveDarrellWithMethod(const std::string& method, double solutionError)
   std::cout << "max diff is: " << maxDiff << std::endl;
 }
 
+namespace
+{
+  /// Graph Laplacian of an n^3 grid plus a small shift. Nodes in the first
+  /// eighth couple to all 26 neighbors, the rest to their 6 face neighbors,
+  /// like a mesh refined at one end.
+  SparseRowMatrixHandle refinedGridMatrix(int n)
+  {
+    const int size = n * n * n;
+    std::vector<SparseRowMatrix::Triplet> entries;
+    std::vector<double> diagonal(size, 0.1);
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+          const int row = (k * n + j) * n + i;
+          const bool refined = row < size / 8;
+          for (int dk = -1; dk <= 1; ++dk)
+            for (int dj = -1; dj <= 1; ++dj)
+              for (int di = -1; di <= 1; ++di)
+              {
+                const int offsets = std::abs(di) + std::abs(dj) + std::abs(dk);
+                const int ii = i + di, jj = j + dj, kk = k + dk;
+                if (offsets == 0 || (!refined && offsets > 1)
+                  || ii < 0 || jj < 0 || kk < 0 || ii >= n || jj >= n || kk >= n)
+                  continue;
+                const int col = (kk * n + jj) * n + ii;
+                entries.push_back(SparseRowMatrix::Triplet(row, col, -1));
+                entries.push_back(SparseRowMatrix::Triplet(col, row, -1));
+                diagonal[row] += 1;
+                diagonal[col] += 1;
+              }
+        }
+    for (int row = 0; row < size; ++row)
+      entries.push_back(SparseRowMatrix::Triplet(row, row, diagonal[row]));
+    SparseRowMatrixHandle A(boost::make_shared<SparseRowMatrix>(size, size));
+    A->setFromTriplets(entries.begin(), entries.end());
+    return A;
+  }
+
+  DenseColumnMatrixHandle onesVector(int size)
+  {
+    DenseColumnMatrixHandle v(boost::make_shared<DenseColumnMatrix>(size));
+    v->setOnes();
+    return v;
+  }
+}
+
+TEST(SolveLinearSystemTests, CanSolveRefinedGrid)
+{
+  auto A = refinedGridMatrix(12);
+  auto b = onesVector(A->nrows());
+
+  for (const std::string method : { "cg", "bicg", "cg-mixed", "bicg-mixed", "ldlt" })
+  {
+    SolveLinearSystemAlgo algo;
+    algo.set(Variables::MaxIterations, 1000);
+    algo.set(Variables::TargetError, 1e-10);
+    algo.setOption(Variables::Method, method);
+    algo.setUpdaterFunc([](double x) {});
+
+    DenseColumnMatrixHandle x0, solution;
+    ASSERT_TRUE(algo.run(A, b, x0, solution));
+    DenseColumnMatrix residual = *A * *solution - *b;
+    EXPECT_LT(residual.norm() / b->norm(), 1e-9) << method;
+  }
+}
+
+TEST(SolveLinearSystemTests, DirectSolverCachesFactorization)
+{
+  auto A = refinedGridMatrix(8);
+  SparseDirectSolver solver;
+  EXPECT_EQ(SparseDirectSolver::Reuse::NONE, solver.factor(A));
+  EXPECT_EQ(SparseDirectSolver::Reuse::FACTORS, solver.factor(A));
+  EXPECT_GT(solver.factorNonZeros(), 0u);
+  EXPECT_GT(solver.factorBytes(), solver.factorNonZeros() * sizeof(double));
+
+  SparseRowMatrixHandle scaled(boost::make_shared<SparseRowMatrix>(*A * 2.0));
+  EXPECT_EQ(SparseDirectSolver::Reuse::SYMBOLIC, solver.factor(scaled));
+
+  auto b = onesVector(A->nrows());
+  DenseColumnMatrix x(A->nrows());
+  solver.solve(*b, x);
+  EXPECT_LT((*scaled * x - *b).norm() / b->norm(), 1e-12);
+
+  SparseRowMatrixHandle other = refinedGridMatrix(6);
+  EXPECT_EQ(SparseDirectSolver::Reuse::NONE, solver.factor(other));
+}
+
+TEST(SolveLinearSystemTests, DirectSolverRejectsUnsymmetricMatrix)
+{
+  auto A = refinedGridMatrix(4);
+  SparseRowMatrixHandle unsymmetric(boost::make_shared<SparseRowMatrix>(*A));
+  unsymmetric->coeffRef(0, 1) -= 1;
+  SparseDirectSolver solver;
+  EXPECT_THROW(solver.factor(unsymmetric), AlgorithmInputException);
+
+  // Inserting an entry leaves the matrix uncompressed; factoring must not compress it.
+  SparseRowMatrixHandle uncompressed(boost::make_shared<SparseRowMatrix>(*A));
+  uncompressed->coeffRef(0, A->ncols() - 1) = -0.5;
+  uncompressed->coeffRef(A->nrows() - 1, 0) = -0.5;
+  ASSERT_FALSE(uncompressed->isCompressed());
+  EXPECT_EQ(SparseDirectSolver::Reuse::NONE, solver.factor(uncompressed));
+  EXPECT_FALSE(uncompressed->isCompressed());
+
+  auto b = onesVector(A->nrows());
+  DenseColumnMatrix x(A->nrows());
+  solver.solve(*b, x);
+  EXPECT_LT((*uncompressed * x - *b).norm() / b->norm(), 1e-12);
+}
+
+TEST(SolveLinearSystemTests, DirectSolverMatchesIterativeSolutions)
+{
+  auto A = refinedGridMatrix(10);
+  SolveLinearSystemAlgo algo;
+  algo.set(Variables::MaxIterations, 5000);
+  algo.set(Variables::TargetError, 1e-10);
+  algo.setUpdaterFunc([](double x) {});
+
+  // The second and third right-hand sides reuse the cached factorization.
+  for (const std::string method : { "cg", "ldlt" })
+  {
+    algo.setOption(Variables::Method, method);
+    for (int rhs = 0; rhs < 3; ++rhs)
+    {
+      DenseColumnMatrixHandle b(boost::make_shared<DenseColumnMatrix>(DenseColumnMatrix::Zero(A->nrows())));
+      (*b)[rhs * A->nrows() / 3] = 1;
+      (*b)[A->nrows() - 1 - rhs] = -1;
+
+      DenseColumnMatrixHandle x0, solution;
+      ASSERT_TRUE(algo.run(A, b, x0, solution));
+      EXPECT_LT((*A * *solution - *b).norm() / b->norm(), 1e-9) << method;
+    }
+  }
+}
+
+namespace
+{
+  // A^T A + A for the SPD grid matrix A, left unassembled.
+  LinearOperatorHandle normalOperator(SparseRowMatrixHandle A)
+  {
+    return LinearOperator::sum(LinearOperator::product(LinearOperator::transpose(A), A), A);
+  }
+
+  DenseColumnMatrixHandle solveThroughInput(const SolveLinearSystemAlgo& algo, MatrixHandle A, DenseColumnMatrixHandle b)
+  {
+    AlgorithmInput input;
+    input[Variables::LHS] = A;
+    input[Variables::RHS] = b;
+    auto output = algo.run(input);
+    return convertMatrix::toColumn(output.get<DenseMatrix>(Variables::Solution));
+  }
+}
+
+TEST(SolveLinearSystemTests, CanSolveLinearOperator)
+{
+  auto A = refinedGridMatrix(8);
+  auto op = normalOperator(A);
+  // The grid rows sum to a constant, so a ones vector would be an eigenvector; vary the right-hand side.
+  DenseColumnMatrixHandle b(boost::make_shared<DenseColumnMatrix>(DenseColumnMatrix::LinSpaced(A->nrows(), -1, 1)));
+  SparseRowMatrix assembled = SparseRowMatrix(A->transpose()) * *A;
+  assembled += *A;
+
+  for (const std::string method : { "cg", "bicg", "ldlt" })
+  {
+    SolveLinearSystemAlgo algo;
+    algo.set(Variables::MaxIterations, 2000);
+    algo.set(Variables::TargetError, 1e-10);
+    algo.setOption(Variables::Method, method);
+    algo.setUpdaterFunc([](double x) {});
+
+    auto solution = solveThroughInput(algo, op, b);
+    ASSERT_NE(nullptr, solution);
+    DenseColumnMatrix residual = assembled * *solution - *b;
+    EXPECT_LT(residual.norm() / b->norm(), 1e-9) << method;
+  }
+}
+
 /// todo: switch these disabled tests to nightly mode. They are overly long for normal continuous builds.
 
 TEST(SolveLinearSystemTests, DISABLED_CanSolveDarrell_CG)
@@ -303,6 +303,57 @@ TEST(EigenSparseSolverTest, CanSolveTinySystem)
   std::cout << "estimated error: " << cg.error()      << std::endl;
 }
 
+namespace
+{
+  template <typename T>
+  SharedPointer<SparseRowMatrixGeneric<T>> gridLaplacian(int n, T shift)
+  {
+    std::vector<Eigen::Triplet<T>> entries;
+    for (int j = 0; j < n; ++j)
+      for (int i = 0; i < n; ++i)
+      {
+        const int row = i + n * j;
+        entries.emplace_back(row, row, T(4) + shift);
+        if (i > 0) entries.emplace_back(row, row - 1, T(-1));
+        if (i < n - 1) entries.emplace_back(row, row + 1, T(-1));
+        if (j > 0) entries.emplace_back(row, row - n, T(-1));
+        if (j < n - 1) entries.emplace_back(row, row + n, T(-1));
+      }
+    auto A = boost::make_shared<SparseRowMatrixGeneric<T>>(n * n, n * n);
+    A->setFromTriplets(entries.begin(), entries.end());
+    return A;
+  }
+}
+
+TEST(SolveLinearSystemWithEigenAlgorithmTests, MixedPrecisionReachesDoubleResidual)
+{
+  auto A = gridLaplacian<double>(100, 1e-3);
+  auto rhs = boost::make_shared<DenseColumnMatrix>(DenseColumnMatrix::Ones(A->nrows()));
+  SolveLinearSystemAlgorithm algo;
+
+  for (const std::string method : { "cg", "cg-mixed", "bicg", "bicg-mixed" })
+  {
+    auto x = algo.run(std::make_tuple(MatrixHandle(A), rhs), std::make_tuple(1e-10, 5000, method));
+    auto solution = std::get<0>(x);
+    ASSERT_TRUE(solution != nullptr);
+    const double residual = (*A * *solution - *rhs).norm() / rhs->norm();
+    EXPECT_LT(residual, 1e-9) << method;
+  }
+}
+
+TEST(SolveLinearSystemWithEigenAlgorithmTests, MixedPrecisionSolvesComplexSystem)
+{
+  typedef std::complex<double> complex;
+  auto A = gridLaplacian<complex>(40, complex(0, 0.5));
+  auto rhs = boost::make_shared<ComplexDenseColumnMatrix>(ComplexDenseColumnMatrix::Constant(A->nrows(), complex(1, -1)));
+  SolveLinearSystemAlgorithm algo;
+
+  auto x = algo.run(std::make_tuple(ComplexMatrixHandle(A), rhs), std::make_tuple(1e-10, 5000, std::string("bicg-mixed")));
+  auto solution = std::get<0>(x);
+  ASSERT_TRUE(solution != nullptr);
+  EXPECT_LT((*A * *solution - *rhs).norm() / rhs->norm(), 1e-9);
+}
+
 TEST(SparseMatrixReadTest, DISABLED_CanReadInBigMatrix)
 {
   auto file = TestResources::rootDir() / "CGDarrell" / "A_txt.mat ";
@@ -0,0 +1,198 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Algorithms/Visualization/VolumeBoundaryFaces.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Thread/Parallel.h>
+#include <boost/make_shared.hpp>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Visualization;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  struct BoundaryFace
+  {
+    VMesh::Face::index_type face;
+    VMesh::Elem::index_type inside, outside;
+    VMesh::Node::index_type nodes[4];
+  };
+
+  Vector faceNormal(const Point* points, int numPoints)
+  {
+    // Newell's method, also valid for non-planar quads
+    Vector normal(0, 0, 0);
+    for (int i = 0; i < numPoints; ++i)
+    {
+      const auto& a = points[i];
+      const auto& b = points[(i + 1) % numPoints];
+      normal += Vector((a.y() - b.y()) * (a.z() + b.z()),
+                       (a.z() - b.z()) * (a.x() + b.x()),
+                       (a.x() - b.x()) * (a.y() + b.y()));
+    }
+    return normal;
+  }
+
+  const char* cacheKey(bool splitByDomain)
+  {
+    return splitByDomain ? "VolumeBoundaryFacesByDomain" : "VolumeBoundaryFaces";
+  }
+}
+
+VolumeBoundaryFacesHandle SCIRun::Core::Algorithms::Visualization::computeVolumeBoundaryFaces(VMesh* mesh, VField* labels)
+{
+  auto boundary = boost::make_shared<VolumeBoundaryFaces>();
+  if (!mesh || mesh->dimensionality() != 3)
+    return boundary;
+
+  mesh->synchronize(Mesh::FACES_E);
+  boundary->nodesPerFace = mesh->num_nodes_per_face();
+  boundary->meshNodes = mesh->num_nodes();
+
+  VMesh::Face::size_type numFaces;
+  mesh->size(numFaces);
+  const int nodesPerFace = boundary->nodesPerFace;
+  if (numFaces == 0 || nodesPerFace < 3 || nodesPerFace > 4)
+    return boundary;
+
+  const bool useLabels = labels && labels->basis_order() == 0 && labels->is_scalar();
+
+  // Each task scans a contiguous range of faces, so concatenating the task
+  // results in order gives the same face order for any number of threads.
+  const int numTasks = Parallel::NumTasks(numFaces);
+  std::vector<std::vector<BoundaryFace>> found(numTasks);
+
+  Parallel::RunRange(numFaces, numTasks, [&](int task, size_t begin, size_t end)
+  {
+    auto& local = found[task];
+    VMesh::Elem::array_type cells;
+    VMesh::Node::array_type nodes;
+    Point points[4], cellCenter, faceCenter;
+
+    for (size_t f = begin; f < end; ++f)
+    {
+      const VMesh::Face::index_type face(f);
+      mesh->get_elems(cells, face);
+      if (cells.empty())
+        continue;
+
+      bool visible = cells.size() == 1;
+      if (!visible && useLabels)
+      {
+        double a, b;
+        labels->get_value(a, cells[0]);
+        labels->get_value(b, cells[1]);
+        visible = a != b;
+      }
+      if (!visible)
+        continue;
+
+      mesh->get_nodes(nodes, face);
+      for (int i = 0; i < nodesPerFace; ++i)
+        mesh->get_point(points[i], nodes[i]);
+      mesh->get_center(cellCenter, cells[0]);
+      mesh->get_center(faceCenter, face);
+
+      BoundaryFace bf;
+      bf.face = face;
+      bf.inside = cells[0];
+      bf.outside = cells.size() > 1 ? cells[1] : cells[0];
+      const bool flip = Dot(faceNormal(points, nodesPerFace), faceCenter - cellCenter) < 0;
+      bf.nodes[0] = nodes[0];
+      for (int i = 1; i < nodesPerFace; ++i)
+        bf.nodes[i] = nodes[flip ? nodesPerFace - i : i];
+      local.push_back(bf);
+    }
+  });
+
+  size_t total = 0;
+  for (const auto& local : found)
+    total += local.size();
+
+  boundary->faces.reserve(total);
+  boundary->cells.reserve(total);
+  boundary->faceNodes.reserve(total * nodesPerFace);
+  boundary->triangles.reserve(total * (nodesPerFace - 2) * 3);
+
+  std::vector<int64_t> localIndex(boundary->meshNodes, -1);
+  std::vector<uint32_t> corner(nodesPerFace);
+  for (const auto& local : found)
+  {
+    for (const auto& bf : local)
+    {
+      boundary->faces.push_back(bf.face);
+      boundary->cells.emplace_back(bf.inside, bf.outside);
+      for (int i = 0; i < nodesPerFace; ++i)
+      {
+        const auto node = bf.nodes[i];
+        boundary->faceNodes.push_back(node);
+        if (localIndex[node] < 0)
+        {
+          localIndex[node] = static_cast<int64_t>(boundary->nodes.size());
+          boundary->nodes.push_back(node);
+        }
+        corner[i] = static_cast<uint32_t>(localIndex[node]);
+      }
+
+      boundary->triangles.insert(boundary->triangles.end(), { corner[0], corner[1], corner[2] });
+      if (nodesPerFace == 4)
+        boundary->triangles.insert(boundary->triangles.end(), { corner[2], corner[3], corner[0] });
+    }
+  }
+
+  return boundary;
+}
+
+VolumeBoundaryFacesHandle SCIRun::Core::Algorithms::Visualization::getVolumeBoundaryFaces(FieldHandle field, bool splitByDomain)
+{
+  if (!field)
+    return nullptr;
+
+  auto mesh = field->mesh();
+  auto vmesh = field->vmesh();
+  auto labels = splitByDomain ? field->vfield() : nullptr;
+  const int labelFieldId = splitByDomain ? field->id() : -1;
+  const auto key = cacheKey(splitByDomain);
+
+  auto cached = boost::static_pointer_cast<const VolumeBoundaryFaces>(mesh->topologyCache(key));
+  if (cached && cached->labelFieldId == labelFieldId)
+  {
+    return cached;
+  }
+
+  auto boundary = boost::const_pointer_cast<VolumeBoundaryFaces>(computeVolumeBoundaryFaces(vmesh, labels));
+  boundary->labelFieldId = labelFieldId;
+  mesh->setTopologyCache(key, boost::const_pointer_cast<VolumeBoundaryFaces>(boundary));
+  return boundary;
+}
@@ -0,0 +1,79 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_VISUALIZATION_VOLUME_BOUNDARY_FACES_H
+#define CORE_ALGORITHMS_VISUALIZATION_VOLUME_BOUNDARY_FACES_H
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldFwd.h>
+#include <Core/Algorithms/Visualization/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Visualization {
+
+  /// Faces of a volume mesh that can be seen from outside: faces with a single
+  /// adjacent cell and, when splitting by domain, faces between two cells with
+  /// different labels. Face nodes are ordered so the face normal points away
+  /// from the first cell. The triangle list indexes into the unique boundary
+  /// nodes, so vertex attributes can be shared between faces.
+  struct SCISHARE VolumeBoundaryFaces
+  {
+    int nodesPerFace = 0;
+    std::vector<VMesh::Face::index_type> faces;
+    /// nodesPerFace entries per face, oriented.
+    std::vector<VMesh::Node::index_type> faceNodes;
+    /// Cell on each side of the face; both are the same for outer faces.
+    std::vector<std::pair<VMesh::Elem::index_type, VMesh::Elem::index_type>> cells;
+    /// Unique boundary nodes in order of first use.
+    std::vector<VMesh::Node::index_type> nodes;
+    /// Three entries per triangle, indices into nodes.
+    std::vector<uint32_t> triangles;
+
+    /// Number of nodes in the mesh the faces were computed for.
+    size_type meshNodes = 0;
+    int labelFieldId = -1;
+
+    size_t numTrianglesPerFace() const { return nodesPerFace - 2; }
+  };
+
+  typedef boost::shared_ptr<const VolumeBoundaryFaces> VolumeBoundaryFacesHandle;
+
+  /// Computes the boundary faces in parallel. If labels is given, interfaces
+  /// between cells with different values of this cell-centered field are
+  /// included as well.
+  SCISHARE VolumeBoundaryFacesHandle computeVolumeBoundaryFaces(VMesh* mesh, VField* labels = nullptr);
+
+  /// Same as computeVolumeBoundaryFaces, but the result is cached on the mesh of
+  /// the field and reused until the mesh is edited (see Mesh::markModified).
+  SCISHARE VolumeBoundaryFacesHandle getVolumeBoundaryFaces(FieldHandle field, bool splitByDomain);
+
+}}}}
+
+#endif
@@ -46,6 +46,7 @@
 #include <Core/Python/PythonInterpreter.h>
 #include <Core/Application/Preferences/Preferences.h>
 #include <Dataflow/Serialization/Network/XMLSerializer.h>
+#include <Dataflow/Serialization/Network/BinarySerializer.h>
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
 #include <boost/algorithm/string.hpp>
 #include <Core/Thread/Parallel.h>
@@ -340,12 +341,19 @@ bool Application::get_user_name( std::string& user_name ) const
 
 std::string SaveFileCommandHelper::saveImpl(const std::string& filename)
 {
+  auto file = Application::Instance().controller()->saveNetwork();
+
+  if (boost::algorithm::ends_with(filename, BinarySerializer::fileExtension))
+  {
+    if (!BinarySerializer::save_binary(*file, filename))
+      return "";
+    return filename;
+  }
+
   auto fileNameWithExtension = filename;
   if (!boost::algorithm::ends_with(fileNameWithExtension, ".srn5"))
     fileNameWithExtension += ".srn5";
 
-  auto file = Application::Instance().controller()->saveNetwork();
-
   if (!XMLSerializer::save_xml(*file, fileNameWithExtension, "networkFile"))
     return "";
 
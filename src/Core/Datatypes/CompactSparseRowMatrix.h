@@ -0,0 +1,114 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_DATATYPES_COMPACT_SPARSE_ROW_MATRIX_H
+#define CORE_DATATYPES_COMPACT_SPARSE_ROW_MATRIX_H
+
+#include <Core/Datatypes/MatrixFwd.h>
+#include <Eigen/SparseCore>
+#include <limits>
+#include <vector>
+
+namespace SCIRun {
+namespace Core {
+namespace Datatypes {
+
+  /// Row-major sparse storage with 32-bit indices, so a nonzero costs 12
+  /// bytes with double values and 8 with float values instead of 16. It is
+  /// not a dataflow datatype: solvers build one from a SparseRowMatrix through
+  /// convertMatrix::toCompactSparse when the dimensions allow.
+  template <typename T>
+  class CompactSparseRowMatrixGeneric : public Eigen::SparseMatrix<T, Eigen::RowMajor, int>
+  {
+  public:
+    typedef T value_type;
+    typedef int index_type;
+    typedef Eigen::SparseMatrix<T, Eigen::RowMajor, int> EigenBase;
+
+    CompactSparseRowMatrixGeneric() : EigenBase() {}
+    CompactSparseRowMatrixGeneric(int nrows, int ncols) : EigenBase(nrows, ncols) {}
+
+    template<typename OtherDerived>
+    CompactSparseRowMatrixGeneric(const Eigen::SparseMatrixBase<OtherDerived>& other)
+      : EigenBase(other)
+    { }
+
+    template<typename OtherDerived>
+    CompactSparseRowMatrixGeneric& operator=(const Eigen::SparseMatrixBase<OtherDerived>& other)
+    {
+      this->EigenBase::operator=(other);
+      return *this;
+    }
+
+    size_t nrows() const { return this->rows(); }
+    size_t ncols() const { return this->cols(); }
+
+    /// Whether a matrix with these dimensions and nonzeros can be indexed with 32 bits.
+    static bool fits(size_t nrows, size_t ncols, size_t nnz)
+    {
+      const size_t limit = static_cast<size_t>(std::numeric_limits<int>::max());
+      return nrows < limit && ncols < limit && nnz < limit;
+    }
+  };
+
+  /// 32-bit copies of the row offsets and column indices of a compressed
+  /// row-major matrix. The values stay in the source matrix, so the extra
+  /// memory is 4 bytes per nonzero rather than a second full copy. Built with
+  /// convertMatrix::toCompactIndices; the source must outlive any view().
+  class CompactSparseIndices
+  {
+  public:
+    template <class SparseType>
+    explicit CompactSparseIndices(const SparseType& sparse) :
+      rows_(sparse.outerIndexPtr(), sparse.outerIndexPtr() + sparse.outerSize() + 1),
+      columns_(sparse.innerIndexPtr(), sparse.innerIndexPtr() + sparse.nonZeros()),
+      nrows_(static_cast<int>(sparse.rows())), ncols_(static_cast<int>(sparse.cols()))
+    {}
+
+    const int* rows() const { return &rows_[0]; }
+    const int* columns() const { return columns_.empty() ? nullptr : &columns_[0]; }
+    int nonZeros() const { return static_cast<int>(columns_.size()); }
+
+    /// Read-only matrix over these indices and the source's values.
+    template <typename T>
+    Eigen::Map<const typename CompactSparseRowMatrixGeneric<T>::EigenBase> view(const T* values) const
+    {
+      return Eigen::Map<const typename CompactSparseRowMatrixGeneric<T>::EigenBase>(
+        nrows_, ncols_, nonZeros(), rows(), columns(), values);
+    }
+
+  private:
+    std::vector<int> rows_;
+    std::vector<int> columns_;
+    int nrows_, ncols_;
+  };
+
+}}}
+
+#endif
@@ -713,7 +713,7 @@ public:
   void get_point(Core::Geometry::Point &result, typename Node::index_type index) const
   { result = points_[index]; }
   void set_point(const Core::Geometry::Point &point, typename Node::index_type index)
-  { points_[index] = point; }
+  { points_[index] = point; this->markModified(); }
   void get_random_point(Core::Geometry::Point &p, typename Elem::index_type i, FieldRNG &r) const;
 
   /// Normals for visualizations
@@ -773,8 +773,8 @@ public:
   /// nodes/elements one needs, prereserving memory is often possible.
   void node_reserve(size_type s) { points_.reserve(static_cast<std::vector<Core::Geometry::Point>::size_type>(s)); }
   void elem_reserve(size_type s) { cells_.reserve(static_cast<std::vector<index_type>::size_type>(s*8)); }
-  void resize_nodes(size_type s) { points_.resize(static_cast<std::vector<Core::Geometry::Point>::size_type>(s)); }
-  void resize_elems(size_type s) { cells_.resize(static_cast<std::vector<index_type>::size_type>(s*8)); }
+  void resize_nodes(size_type s) { points_.resize(static_cast<std::vector<Core::Geometry::Point>::size_type>(s)); this->markModified(); }
+  void resize_elems(size_type s) { cells_.resize(static_cast<std::vector<index_type>::size_type>(s*8)); this->markModified(); }
 
   /// Get the local coordinates for a certain point within an element
   /// This function uses a couple of newton iterations to find the local
@@ -2013,6 +2013,7 @@ protected:
   template <class ARRAY, class INDEX>
   inline void set_nodes_by_elem(ARRAY &array, INDEX idx)
   {
+    this->markModified();
     for (index_type n = 0; n < 8; ++n)
       cells_[idx * 8 + n] = static_cast<index_type>(array[n]);
   }
@@ -3173,6 +3174,7 @@ template <class Basis>
 void
 HexVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 {
+  this->markModified();
   synchronize_lock_.lock();
 
   std::vector<Core::Geometry::Point>::iterator itr = points_.begin();
@@ -3865,6 +3867,7 @@ HexVolMesh<Basis>::add_find_point(const Core::Geometry::Point &p, double err)
   }
   else
   {
+    this->markModified();
     points_.push_back(p);
     return static_cast<typename Node::index_type>(points_.size() - 1);
   }
@@ -3881,6 +3884,7 @@ HexVolMesh<Basis>::add_hex(typename Node::index_type a,
                            typename Node::index_type g,
                            typename Node::index_type h)
 {
+  this->markModified();
   const index_type hex = static_cast<index_type>(cells_.size()) / 8;
   cells_.push_back(a);
   cells_.push_back(b);
@@ -3897,6 +3901,7 @@ template <class Basis>
 typename HexVolMesh<Basis>::Node::index_type
 HexVolMesh<Basis>::add_point(const Core::Geometry::Point &p)
 {
+  this->markModified();
   points_.push_back(p);
   return static_cast<typename Node::index_type>(points_.size() - 1);
 }
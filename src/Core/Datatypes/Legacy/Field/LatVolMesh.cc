@@ -3510,6 +3510,7 @@ void
 VStructHexVolMesh<MESH>::set_point(const Point &point, VMesh::Node::index_type idx)
 {
   points_[idx] = point;
+  this->mesh_->markModified();
 }
 
 template <class MESH>
@@ -1100,6 +1100,7 @@ std::string dynamic_type_name() const override { return latvol_typeid.type; }
     transform_ = trans;
     transform_.compute_imat();
     compute_jacobian();
+    this->markModified();
     return transform_;
   }
 
@@ -1333,6 +1334,7 @@ template <class Basis>
 void
 LatVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 {
+  this->markModified();
   transform_.pre_trans(t);
   transform_.compute_imat();
   compute_jacobian();
@@ -1392,6 +1394,7 @@ template <class Basis>
 void
 LatVolMesh<Basis>::set_dim(const std::vector<index_type>& dim)
 {
+  this->markModified();
   ni_ = dim[0];
   nj_ = dim[1];
   nk_ = dim[2];
@@ -41,6 +41,8 @@
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/GeometryPrimitives/Transform.h>
 #include <Core/Thread/Mutex.h>
+#include <boost/make_shared.hpp>
+#include <atomic>
 #include <sci_debug.h>
 
 using namespace SCIRun;
@@ -50,9 +52,29 @@ using namespace SCIRun::Core::Thread;
 // initialize the static member type_id
 PersistentTypeID Mesh::type_id("Mesh", "Datatype", nullptr);
 
-Mesh::Mesh(const Mesh& copy) : Core::Datatypes::Datatype(copy)
+struct Mesh::TopologyCache
+{
+  TopologyCache() : lock("Mesh topology cache"), modified(false) {}
+  Mutex lock;
+  std::map<std::string, boost::shared_ptr<void>> entries;
+  std::atomic<bool> modified;
+};
+
+Mesh::Mesh(const Mesh& copy) : Core::Datatypes::Datatype(copy),
+  topologyCache_(boost::make_shared<TopologyCache>())
 { DEBUG_CONSTRUCTOR("Mesh");  }
 
+Mesh&
+Mesh::operator=(const Mesh& copy)
+{
+  if (this != &copy)
+  {
+    Core::Datatypes::Datatype::operator=(copy);
+    topologyCache_ = boost::make_shared<TopologyCache>();
+  }
+  return *this;
+}
+
 namespace
 {
 // A list to keep a record of all the different Field types that
@@ -366,7 +388,7 @@ MeshTypeID::MeshTypeID(const std::string& type,
 }
 
 
-Mesh::Mesh()
+Mesh::Mesh() : topologyCache_(boost::make_shared<TopologyCache>())
 {
   DEBUG_CONSTRUCTOR("Mesh")
 }
@@ -416,6 +438,35 @@ Mesh::vmesh()
   return (nullptr);
 }
 
+boost::shared_ptr<void>
+Mesh::topologyCache(const std::string& key) const
+{
+  Guard g(topologyCache_->lock.get());
+  if (topologyCache_->modified.exchange(false))
+    topologyCache_->entries.clear();
+  auto entry = topologyCache_->entries.find(key);
+  return entry != topologyCache_->entries.end() ? entry->second : nullptr;
+}
+
+void
+Mesh::setTopologyCache(const std::string& key, boost::shared_ptr<void> data) const
+{
+  Guard g(topologyCache_->lock.get());
+  if (data)
+    topologyCache_->entries[key] = data;
+  else
+    topologyCache_->entries.erase(key);
+}
+
+void
+Mesh::markModified()
+{
+  // Only read the flag once it is set, so that edits running in parallel do
+  // not keep writing to the same cache line.
+  if (!topologyCache_->modified.load(std::memory_order_relaxed))
+    topologyCache_->modified.store(true, std::memory_order_relaxed);
+}
+
 
 
 MeshHandle
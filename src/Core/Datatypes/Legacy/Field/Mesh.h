@@ -30,6 +30,7 @@
 #define CORE_DATATYPES_LEGACY_MESH_H 1
 
 #include <Core/Datatypes/Legacy/Base/Types.h>
+#include <boost/shared_ptr.hpp>
 #include <Core/GeometryPrimitives/GeomFwd.h>
 #include <Core/Datatypes/Datatype.h>
 #include <Core/Datatypes/Mesh/MeshTraits.h>
@@ -43,6 +44,7 @@ class SCISHARE Mesh : public Core::Datatypes::Datatype, public Core::Datatypes::
 public:
   Mesh();
   Mesh(const Mesh& copy);
+  Mesh& operator=(const Mesh& copy);
 
   virtual ~Mesh();
   Mesh *clone() const override = 0;
@@ -100,6 +102,21 @@ public:
   /// object that has all the virtual functions. This object will be destroyed
   /// when the mesh is destroyed. The user does not need to destroy the VMesh.
   virtual VMesh* vmesh();
+
+  /// Derived data that only depends on the mesh topology and is expensive to
+  /// compute (e.g. the boundary faces used when rendering a volume mesh) can
+  /// be cached with the mesh. The cache is not copied with the mesh.
+  boost::shared_ptr<void> topologyCache(const std::string& key) const;
+  void setTopologyCache(const std::string& key, boost::shared_ptr<void> data) const;
+
+  /// Drops the cached derived data before its next use. The mesh classes call
+  /// this when nodes or elements are edited in place; code that writes
+  /// through the raw point or element arrays has to call it as well.
+  void markModified();
+
+private:
+  struct TopologyCache;
+  boost::shared_ptr<TopologyCache> topologyCache_;
 };
 
 class SCISHARE MeshTypeID {
@@ -223,6 +223,7 @@ public:
     LatVolMesh<Basis>::nk_ = dims[2];
 
     points_.resize(dims[2], dims[1], dims[0]);
+    this->markModified();
 
     /// Create a new virtual interface for this copy
     /// all pointers have changed hence create a new
@@ -1185,6 +1186,7 @@ template <class Basis>
 void
 StructHexVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 {
+  this->markModified();
   typename LatVolMesh<Basis>::Node::iterator i, ie;
   this->begin(i);
   this->end(ie);
@@ -1587,6 +1589,7 @@ StructHexVolMesh<Basis>::set_point(const Core::Geometry::Point &p,
 				   const typename LatVolMesh<Basis>::Node::index_type &idx)
 {
   points_(idx.k_, idx.j_, idx.i_) = p;
+  this->markModified();
 }
 
 template<class Basis>
@@ -646,7 +646,7 @@ public:
   void get_point(Core::Geometry::Point &result, typename Node::index_type index) const
   { result = points_[index]; }
   void set_point(const Core::Geometry::Point &point, typename Node::index_type index)
-  { points_[index] = point; }
+  { points_[index] = point; this->markModified(); }
   void get_random_point(Core::Geometry::Point &p, typename Elem::index_type i, FieldRNG &r) const;
 
   /// Normals for visualizations
@@ -700,8 +700,8 @@ public:
   /// nodes/elements one needs, prereserving memory is often possible.
   void node_reserve(size_type s) { points_.reserve(static_cast<std::vector<Core::Geometry::Point>::size_type>(s)); }
   void elem_reserve(size_type s) { cells_.reserve(static_cast<std::vector<index_type>::size_type>(s*4)); }
-  void resize_nodes(size_type s) { points_.resize(static_cast<std::vector<Core::Geometry::Point>::size_type>(s)); }
-  void resize_elems(size_type s) { cells_.resize(static_cast<std::vector<index_type>::size_type>(s*4)); }
+  void resize_nodes(size_type s) { points_.resize(static_cast<std::vector<Core::Geometry::Point>::size_type>(s)); this->markModified(); }
+  void resize_elems(size_type s) { cells_.resize(static_cast<std::vector<index_type>::size_type>(s*4)); this->markModified(); }
 
   /// Get the local coordinates for a certain point within an element
   /// This function uses a couple of newton iterations to find the local
@@ -1858,6 +1858,7 @@ protected:
   template <class ARRAY, class INDEX>
   inline void set_nodes_by_elem(ARRAY &array, INDEX idx)
   {
+    this->markModified();
     for (index_type n = 0; n < 4; ++n)
       cells_[idx * 4 + n] = static_cast<index_type>(array[n]);
   }
@@ -2865,6 +2866,7 @@ template <class Basis>
 void
 TetVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 {
+  this->markModified();
   synchronize_lock_.lock();
 
   std::vector<Core::Geometry::Point>::iterator itr = points_.begin();
@@ -3656,6 +3658,7 @@ void
 TetVolMesh<Basis>::set_nodes(typename Node::array_type &array,
                              typename Cell::index_type idx)
 {
+  this->markModified();
   ASSERT(array.size() == 4);
 
   delete_cell_syncinfo(idx);
@@ -3884,6 +3887,7 @@ TetVolMesh<Basis>::add_find_point(const Core::Geometry::Point &p, double /*err*/
   }
   else
   {
+    this->markModified();
     points_.push_back(p);
     if (synchronized_ & Mesh::NODE_NEIGHBORS_E)
     {
@@ -3902,6 +3906,7 @@ TetVolMesh<Basis>::add_tet(typename Node::index_type a,
 			   typename Node::index_type c,
 			   typename Node::index_type d)
 {
+  this->markModified();
   const index_type tet = static_cast<index_type>(cells_.size()) / 4;
   cells_.push_back(a);
   cells_.push_back(b);
@@ -3914,6 +3919,7 @@ template <class Basis>
 typename TetVolMesh<Basis>::Node::index_type
 TetVolMesh<Basis>::add_point(const Core::Geometry::Point &p)
 {
+  this->markModified();
   points_.push_back(p);
   return static_cast<typename Node::index_type>(points_.size() - 1);
 }
@@ -3935,6 +3941,7 @@ TetVolMesh<Basis>::add_tet_pos(typename Node::index_type a,
                                typename Node::index_type c,
                                typename Node::index_type d)
 {
+  this->markModified();
   const index_type tet = static_cast<index_type>(cells_.size()) / 4;
   const Core::Geometry::Point &p0 = point(a);
   const Core::Geometry::Point &p1 = point(b);
@@ -3964,6 +3971,7 @@ TetVolMesh<Basis>::mod_tet_pos(typename TetVolMesh<Basis>::Elem::index_type ci,
                                typename Node::index_type c,
                                typename Node::index_type d)
 {
+  this->markModified();
   const Core::Geometry::Point &p0 = point(a);
   const Core::Geometry::Point &p1 = point(b);
   const Core::Geometry::Point &p2 = point(c);
@@ -3987,6 +3995,7 @@ template <class Basis>
 void
 TetVolMesh<Basis>::delete_cells(std::set<index_type> &to_delete)
 {
+  this->markModified();
   synchronize_lock_.lock();
   std::set<index_type>::reverse_iterator iter = to_delete.rbegin();
   while (iter != to_delete.rend())
@@ -4019,6 +4028,7 @@ template <class Basis>
 void
 TetVolMesh<Basis>::delete_nodes(std::set<index_type> &to_delete)
 {
+  this->markModified();
   synchronize_lock_.lock();
   std::set<index_type>::reverse_iterator iter = to_delete.rbegin();
   while (iter != to_delete.rend())
@@ -4357,6 +4367,7 @@ template <class Basis>
 void
 TetVolMesh<Basis>::orient(typename Cell::index_type ci)
 {
+  this->markModified();
   const Core::Geometry::Point &p0 = point(cells_[ci*4+0]);
   const Core::Geometry::Point &p1 = point(cells_[ci*4+1]);
   const Core::Geometry::Point &p2 = point(cells_[ci*4+2]);
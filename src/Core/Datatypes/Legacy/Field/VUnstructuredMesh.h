@@ -701,6 +701,7 @@ VUnstructuredMesh<MESH>::
 set_point(const Core::Geometry::Point &point, VMesh::Node::index_type i)
 {
   this->mesh_->points_[i] = point;
+  this->mesh_->markModified();
 }
 
 template <class MESH>
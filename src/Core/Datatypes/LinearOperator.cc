@@ -0,0 +1,198 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Datatypes/LinearOperator.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Utils/Exception.h>
+#include <sstream>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun;
+
+PersistentTypeID LinearOperator::type_id("LinearOperator", "MatrixBase", nullptr);
+
+namespace
+{
+  // Columns of the identity applied per pass when assembling an operator.
+  const size_t assemblyBlockSize = 256;
+
+  std::string operandExpression(const MatrixHandle& m)
+  {
+    auto op = boost::dynamic_pointer_cast<LinearOperator>(m);
+    if (op)
+      return op->kind() == LinearOperator::Kind::TRANSPOSE ? op->expression() : "(" + op->expression() + ")";
+    std::ostringstream ostr;
+    ostr << m->dynamic_type_name() << "[" << m->nrows() << "x" << m->ncols() << "]";
+    return ostr.str();
+  }
+}
+
+LinearOperator::LinearOperator(Kind kind, MatrixHandle a, MatrixHandle b, double scalar, size_t nrows, size_t ncols)
+  : kind_(kind), a_(a), b_(b), scalar_(scalar), nrows_(nrows), ncols_(ncols)
+{
+}
+
+LinearOperatorHandle LinearOperator::sum(MatrixHandle a, MatrixHandle b)
+{
+  ENSURE_NOT_NULL(a, "Operator summand");
+  ENSURE_NOT_NULL(b, "Operator summand");
+  ENSURE_DIMENSIONS_MATCH(a->nrows(), b->nrows(), "Summands need the same number of rows");
+  ENSURE_DIMENSIONS_MATCH(a->ncols(), b->ncols(), "Summands need the same number of columns");
+  return LinearOperatorHandle(new LinearOperator(Kind::SUM, a, b, 1, a->nrows(), a->ncols()));
+}
+
+LinearOperatorHandle LinearOperator::product(MatrixHandle a, MatrixHandle b)
+{
+  ENSURE_NOT_NULL(a, "Operator factor");
+  ENSURE_NOT_NULL(b, "Operator factor");
+  ENSURE_DIMENSIONS_MATCH(a->ncols(), b->nrows(), "Inner dimensions of the product need to match");
+  return LinearOperatorHandle(new LinearOperator(Kind::PRODUCT, a, b, 1, a->nrows(), b->ncols()));
+}
+
+LinearOperatorHandle LinearOperator::transpose(MatrixHandle a)
+{
+  ENSURE_NOT_NULL(a, "Transposed operand");
+  return LinearOperatorHandle(new LinearOperator(Kind::TRANSPOSE, a, nullptr, 1, a->ncols(), a->nrows()));
+}
+
+LinearOperatorHandle LinearOperator::scale(double scalar, MatrixHandle a)
+{
+  ENSURE_NOT_NULL(a, "Scaled operand");
+  return LinearOperatorHandle(new LinearOperator(Kind::SCALE, a, nullptr, scalar, a->nrows(), a->ncols()));
+}
+
+DenseMatrix::EigenBase LinearOperator::apply(const DenseMatrix::EigenBase& X, bool transposed) const
+{
+  const size_t operandRows = transposed ? nrows_ : ncols_;
+  ENSURE_DIMENSIONS_MATCH(static_cast<size_t>(X.rows()), operandRows, "Operator and operand dimensions do not match");
+  switch (kind_)
+  {
+  case Kind::SUM:
+    return apply(*a_, X, transposed) + apply(*b_, X, transposed);
+  case Kind::PRODUCT:
+    return transposed ? apply(*b_, apply(*a_, X, true), true) : apply(*a_, apply(*b_, X, false), false);
+  case Kind::TRANSPOSE:
+    return apply(*a_, X, !transposed);
+  case Kind::SCALE:
+    return scalar_ * apply(*a_, X, transposed);
+  }
+  return DenseMatrix::EigenBase();
+}
+
+DenseMatrix::EigenBase LinearOperator::apply(const Matrix& A, const DenseMatrix::EigenBase& X, bool transposed)
+{
+  if (auto op = dynamic_cast<const LinearOperator*>(&A))
+    return op->apply(X, transposed);
+  if (auto sparse = dynamic_cast<const SparseRowMatrix*>(&A))
+    return transposed ? DenseMatrix::EigenBase(sparse->transpose() * X) : DenseMatrix::EigenBase(*sparse * X);
+  if (auto dense = dynamic_cast<const DenseMatrix*>(&A))
+    return transposed ? DenseMatrix::EigenBase(dense->transpose() * X) : DenseMatrix::EigenBase(*dense * X);
+  if (auto column = dynamic_cast<const DenseColumnMatrix*>(&A))
+    return transposed ? DenseMatrix::EigenBase(column->transpose() * X) : DenseMatrix::EigenBase(*column * X);
+  THROW_INVALID_ARGUMENT("LinearOperator cannot apply a matrix of type " + A.dynamic_type_name());
+}
+
+DenseMatrixHandle LinearOperator::toDense() const
+{
+  auto dense = boost::make_shared<DenseMatrix>(nrows_, ncols_);
+  for (size_t begin = 0; begin < ncols_; begin += assemblyBlockSize)
+  {
+    const size_t width = std::min(assemblyBlockSize, ncols_ - begin);
+    DenseMatrix::EigenBase identity = DenseMatrix::EigenBase::Zero(ncols_, width);
+    for (size_t j = 0; j < width; ++j)
+      identity(begin + j, j) = 1;
+    dense->middleCols(begin, width) = apply(identity);
+  }
+  return dense;
+}
+
+SparseRowMatrixHandle LinearOperator::toSparse() const
+{
+  NonZero<double> nonZero;
+  std::vector<SparseRowMatrix::Triplet> entries;
+  for (size_t begin = 0; begin < ncols_; begin += assemblyBlockSize)
+  {
+    const size_t width = std::min(assemblyBlockSize, ncols_ - begin);
+    DenseMatrix::EigenBase identity = DenseMatrix::EigenBase::Zero(ncols_, width);
+    for (size_t j = 0; j < width; ++j)
+      identity(begin + j, j) = 1;
+    DenseMatrix::EigenBase block = apply(identity);
+    for (size_t j = 0; j < width; ++j)
+      for (size_t i = 0; i < nrows_; ++i)
+        if (nonZero(block(i, j)))
+          entries.emplace_back(i, begin + j, block(i, j));
+  }
+  auto sparse = boost::make_shared<SparseRowMatrix>(nrows_, ncols_);
+  sparse->setFromTriplets(entries.begin(), entries.end());
+  return sparse;
+}
+
+std::string LinearOperator::expression() const
+{
+  switch (kind_)
+  {
+  case Kind::SUM:
+    return operandExpression(a_) + " + " + operandExpression(b_);
+  case Kind::PRODUCT:
+    return operandExpression(a_) + " * " + operandExpression(b_);
+  case Kind::TRANSPOSE:
+    return operandExpression(a_) + "^T";
+  case Kind::SCALE:
+  {
+    std::ostringstream ostr;
+    ostr << scalar_ << " * " << operandExpression(a_);
+    return ostr.str();
+  }
+  }
+  return "";
+}
+
+double LinearOperator::get(int i, int j) const
+{
+  DenseMatrix::EigenBase unit = DenseMatrix::EigenBase::Zero(ncols_, 1);
+  unit(j, 0) = 1;
+  return apply(unit)(i, 0);
+}
+
+void LinearOperator::put(int, int, const double&)
+{
+  THROW_INVALID_STATE("LinearOperator entries cannot be assigned; assemble it first");
+}
+
+void LinearOperator::accept(Visitor&)
+{
+  THROW_INVALID_STATE("LinearOperator has no stored entries to visit; assemble it first");
+}
+
+void LinearOperator::print(std::ostream& o) const
+{
+  o << "LinearOperator " << nrows_ << "x" << ncols_ << ": " << expression() << std::endl;
+}
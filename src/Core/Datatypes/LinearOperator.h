@@ -0,0 +1,99 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_DATATYPES_LINEAR_OPERATOR_H
+#define CORE_DATATYPES_LINEAR_OPERATOR_H
+
+#include <Core/Datatypes/Matrix.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Datatypes {
+
+  /// A matrix known only through its action: an unevaluated expression of sums,
+  /// products, transposes and scalings of other matrices. Operands are shared,
+  /// never copied, and an expression such as A^T A + lambda L is applied as
+  /// A^T (A x) + lambda (L x) without forming the product. Operands may be any
+  /// Matrix, including other operators.
+  ///
+  /// Entries are not stored: get() costs one application, put() and accept()
+  /// throw, and convertMatrix::toDense or toSparse assemble the operator for
+  /// code that needs entries.
+  class SCISHARE LinearOperator : public Matrix
+  {
+  public:
+    enum class Kind { SUM, PRODUCT, TRANSPOSE, SCALE };
+
+    static LinearOperatorHandle sum(MatrixHandle a, MatrixHandle b);
+    static LinearOperatorHandle product(MatrixHandle a, MatrixHandle b);
+    static LinearOperatorHandle transpose(MatrixHandle a);
+    static LinearOperatorHandle scale(double scalar, MatrixHandle a);
+
+    size_t nrows() const override { return nrows_; }
+    size_t ncols() const override { return ncols_; }
+
+    /// Y = A X, or A^T X when transposed; X holds one vector per column.
+    DenseMatrix::EigenBase apply(const DenseMatrix::EigenBase& X, bool transposed = false) const;
+    /// Same for any matrix, so callers need not distinguish operators from assembled matrices.
+    static DenseMatrix::EigenBase apply(const Matrix& A, const DenseMatrix::EigenBase& X, bool transposed = false);
+
+    /// The assembled matrix, computed one block of columns at a time.
+    DenseMatrixHandle toDense() const;
+    /// Same, keeping only the nonzeros of each block, so a sparse operator is
+    /// never held densely.
+    SparseRowMatrixHandle toSparse() const;
+
+    /// Human-readable form of the expression, e.g. "(A^T * A) + 0.1 * L".
+    std::string expression() const;
+
+    Kind kind() const { return kind_; }
+
+    double get(int i, int j) const override;
+    void put(int i, int j, const double& val) override;
+    void accept(Visitor& visitor) override;
+
+    LinearOperator* clone() const override { return new LinearOperator(*this); }
+    std::string dynamic_type_name() const override { return type_id.type; }
+    static PersistentTypeID type_id;
+
+  private:
+    LinearOperator(Kind kind, MatrixHandle a, MatrixHandle b, double scalar, size_t nrows, size_t ncols);
+    void print(std::ostream& o) const override;
+
+    Kind kind_;
+    MatrixHandle a_, b_;
+    double scalar_;
+    size_t nrows_, ncols_;
+  };
+
+}}}
+
+#endif
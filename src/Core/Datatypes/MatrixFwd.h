@@ -91,6 +91,24 @@ namespace Datatypes {
 
   typedef SharedPointer<ComplexSparseRowMatrix> ComplexSparseRowMatrixHandle;
 
+  template <typename T>
+  class CompactSparseRowMatrixGeneric;
+  template <typename T>
+  using CompactSparseRowMatrixHandleGeneric = SharedPointer<CompactSparseRowMatrixGeneric<T>>;
+
+  typedef CompactSparseRowMatrixGeneric<double> CompactSparseRowMatrix;
+  typedef CompactSparseRowMatrixGeneric<float> FloatCompactSparseRowMatrix;
+
+  typedef SharedPointer<CompactSparseRowMatrix> CompactSparseRowMatrixHandle;
+  typedef SharedPointer<FloatCompactSparseRowMatrix> FloatCompactSparseRowMatrixHandle;
+
+  class CompactSparseIndices;
+  typedef SharedPointer<const CompactSparseIndices> CompactSparseIndicesHandle;
+
+  class LinearOperator;
+  typedef SharedPointer<LinearOperator> LinearOperatorHandle;
+  typedef SharedPointer<const LinearOperator> LinearOperatorConstHandle;
+
 }}}
 
 
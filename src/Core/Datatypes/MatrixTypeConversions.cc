@@ -28,6 +28,7 @@
 
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Core/Datatypes/SparseRowMatrixFromMap.h>
+#include <Core/Datatypes/LinearOperator.h>
 
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun;
@@ -37,6 +38,11 @@ bool matrixIs::column(const MatrixHandle& mh)
   return castMatrix::toColumn(mh) != nullptr;
 }
 
+bool matrixIs::linearOperator(const MatrixHandle& mh)
+{
+  return castMatrix::to<LinearOperator>(mh) != nullptr;
+}
+
 std::string matrixIs::whatType(const MatrixHandle& mh)
 {
   if (!mh)
@@ -100,6 +106,10 @@ DenseMatrixHandle convertMatrix::toDense(const MatrixHandle& mh)
     return dense_matrix;
   }
 
+  auto op = castMatrix::to<LinearOperator>(mh);
+  if (op)
+    return op->toDense();
+
   return DenseMatrixHandle();
 }
 
@@ -126,5 +136,9 @@ SparseRowMatrixHandle convertMatrix::toSparse(const MatrixHandle& mh)
     return fromDenseToSparse(*dense);
   }
 
+  auto op = castMatrix::to<LinearOperator>(mh);
+  if (op)
+    return op->toSparse();
+
   return SparseRowMatrixHandle();
 }
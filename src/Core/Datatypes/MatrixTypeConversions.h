@@ -34,6 +34,7 @@
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/CompactSparseRowMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/SparseRowMatrixFromMap.h>
 #include <boost/type_traits.hpp>
@@ -93,6 +94,7 @@ namespace Core {
       }
 
       static bool column(const MatrixHandle& mh);
+      static bool linearOperator(const MatrixHandle& mh);
       static std::string whatType(const MatrixHandle& mh);
       static std::string whatType(const ComplexMatrixHandle& mh);
       static MatrixTypeCode typeCode(const MatrixHandle& mh);
@@ -149,6 +151,7 @@ namespace Core {
 
       return nullptr;
     }
+    /// LinearOperator inputs are assembled, which costs one application per column.
     static DenseMatrixHandle toDense(const MatrixHandle& mh);
     static SparseRowMatrixHandle toSparse(const MatrixHandle& mh);
 
@@ -165,6 +168,34 @@ namespace Core {
       return SparseRowMatrixFromMapGeneric<T>::make(dense.nrows(), dense.ncols(), data);
     }
 
+    /// Copy with 32-bit indices and values converted to To, or nullptr when the
+    /// matrix is too large for 32-bit indices.
+    template <typename To, typename T>
+    static SharedPointer<CompactSparseRowMatrixGeneric<To>> toCompactSparse(const SharedPointer<SparseRowMatrixGeneric<T>>& sparse)
+    {
+      if (!sparse || !CompactSparseRowMatrixGeneric<To>::fits(sparse->nrows(), sparse->ncols(), sparse->nonZeros()))
+        return nullptr;
+      return boost::make_shared<CompactSparseRowMatrixGeneric<To>>(sparse->template cast<To>());
+    }
+
+    /// 32-bit indices for a compressed matrix whose values are read in place,
+    /// or nullptr when the matrix is not compressed or too large.
+    template <typename T>
+    static CompactSparseIndicesHandle toCompactIndices(const SharedPointer<SparseRowMatrixGeneric<T>>& sparse)
+    {
+      if (!sparse || !sparse->isCompressed() || !CompactSparseRowMatrixGeneric<T>::fits(sparse->nrows(), sparse->ncols(), sparse->nonZeros()))
+        return nullptr;
+      return boost::make_shared<CompactSparseIndices>(*sparse);
+    }
+
+    template <typename To, typename T>
+    static SharedPointer<SparseRowMatrixGeneric<To>> fromCompactSparse(const SharedPointer<CompactSparseRowMatrixGeneric<T>>& compact)
+    {
+      if (!compact)
+        return nullptr;
+      return boost::make_shared<SparseRowMatrixGeneric<To>>(compact->template cast<To>());
+    }
+
     convertMatrix() = delete;
   };
 
@@ -0,0 +1,148 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/CompactSparseRowMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  // 3D seven-point Laplacian on an n^3 grid.
+  SparseRowMatrixHandle laplacian(int n)
+  {
+    const int size = n * n * n;
+    std::vector<SparseRowMatrix::Triplet> entries;
+    entries.reserve(7 * size);
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+          const int row = i + n * (j + n * k);
+          entries.emplace_back(row, row, 6.0);
+          if (i > 0) entries.emplace_back(row, row - 1, -1.0);
+          if (i < n - 1) entries.emplace_back(row, row + 1, -1.0);
+          if (j > 0) entries.emplace_back(row, row - n, -1.0);
+          if (j < n - 1) entries.emplace_back(row, row + n, -1.0);
+          if (k > 0) entries.emplace_back(row, row - n * n, -1.0);
+          if (k < n - 1) entries.emplace_back(row, row + n * n, -1.0);
+        }
+    auto m = boost::make_shared<SparseRowMatrix>(size, size);
+    m->setFromTriplets(entries.begin(), entries.end());
+    m->makeCompressed();
+    return m;
+  }
+
+  // Bytes moved by one product: values, column indices, row offsets and the two vectors.
+  template <class Matrix>
+  double productBytes(const Matrix& m)
+  {
+    using Index = typename Matrix::StorageIndex;
+    using Value = typename Matrix::Scalar;
+    return static_cast<double>(m.nonZeros()) * (sizeof(Value) + sizeof(Index))
+      + static_cast<double>(m.rows() + 1) * sizeof(Index)
+      + static_cast<double>(m.rows() + m.cols()) * sizeof(Value);
+  }
+}
+
+TEST(CompactSparseRowMatrixTest, ConvertsWithSameEntries)
+{
+  auto sparse = laplacian(6);
+  auto compact = convertMatrix::toCompactSparse<double>(sparse);
+  ASSERT_TRUE(compact != nullptr);
+  EXPECT_EQ(sparse->nrows(), compact->nrows());
+  EXPECT_EQ(sparse->ncols(), compact->ncols());
+  EXPECT_EQ(sparse->nonZeros(), compact->nonZeros());
+
+  auto back = convertMatrix::fromCompactSparse<double>(compact);
+  ASSERT_TRUE(back != nullptr);
+  EXPECT_EQ(0.0, (*back - *sparse).norm());
+}
+
+TEST(CompactSparseRowMatrixTest, ProductMatchesWideIndices)
+{
+  auto sparse = laplacian(8);
+  auto compact = convertMatrix::toCompactSparse<double>(sparse);
+  auto single = convertMatrix::toCompactSparse<float>(sparse);
+  ASSERT_TRUE(compact && single);
+
+  Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(sparse->ncols(), -1.0, 1.0);
+  Eigen::VectorXd expected = *sparse * x;
+  Eigen::VectorXd y = *compact * x;
+  EXPECT_EQ(0.0, (y - expected).norm());
+
+  Eigen::VectorXf ySingle = *single * x.cast<float>();
+  EXPECT_NEAR(0.0, (ySingle.cast<double>() - expected).norm() / expected.norm(), 1e-6);
+}
+
+TEST(CompactSparseRowMatrixTest, OnlyFitsThirtyTwoBitRange)
+{
+  EXPECT_TRUE(CompactSparseRowMatrix::fits(1000, 1000, 7000));
+  EXPECT_FALSE(CompactSparseRowMatrix::fits(size_t(1) << 32, 10, 10));
+  EXPECT_FALSE(CompactSparseRowMatrix::fits(10, 10, size_t(1) << 32));
+  EXPECT_TRUE(convertMatrix::toCompactSparse<double>(SparseRowMatrixHandle()) == nullptr);
+}
+
+TEST(CompactSparseRowMatrixTest, NarrowIndicesReduceProductTraffic)
+{
+  auto sparse = laplacian(8);
+  auto compact = convertMatrix::toCompactSparse<double>(sparse);
+  auto single = convertMatrix::toCompactSparse<float>(sparse);
+  ASSERT_TRUE(compact && single);
+
+  const double wide = productBytes(static_cast<const SparseRowMatrix::EigenBase&>(*sparse));
+  const double narrow = productBytes(static_cast<const CompactSparseRowMatrix::EigenBase&>(*compact));
+  const double narrowSingle = productBytes(static_cast<const FloatCompactSparseRowMatrix::EigenBase&>(*single));
+  EXPECT_LT(narrow, 0.85 * wide);
+  EXPECT_LT(narrowSingle, 0.6 * wide);
+}
+
+TEST(CompactSparseRowMatrixTest, IndicesShareValuesWithSource)
+{
+  auto sparse = laplacian(8);
+  auto indices = convertMatrix::toCompactIndices(sparse);
+  ASSERT_TRUE(indices != nullptr);
+  EXPECT_EQ(sparse->nonZeros(), indices->nonZeros());
+
+  auto view = indices->view(sparse->valuePtr());
+  EXPECT_EQ(sparse->valuePtr(), view.valuePtr());
+
+  Eigen::VectorXd x = Eigen::VectorXd::LinSpaced(sparse->ncols(), -1.0, 1.0);
+  Eigen::VectorXd expected = *sparse * x;
+  Eigen::VectorXd y = view * x;
+  EXPECT_EQ(0.0, (y - expected).norm());
+
+  sparse->coeffRef(0, 0) = 10.0;
+  EXPECT_EQ(10.0, indices->view(sparse->valuePtr()).coeff(0, 0));
+  EXPECT_TRUE(convertMatrix::toCompactIndices(SparseRowMatrixHandle()) == nullptr);
+}
@@ -0,0 +1,138 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/LinearOperator.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Utils/Exception.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core;
+using namespace SCIRun::Core::Datatypes;
+
+namespace
+{
+  // Forward differences along a line of n nodes: (n-1) x n.
+  SparseRowMatrixHandle gradient(int n)
+  {
+    std::vector<SparseRowMatrix::Triplet> entries;
+    for (int i = 0; i < n - 1; ++i)
+    {
+      entries.emplace_back(i, i, -1.0);
+      entries.emplace_back(i, i + 1, 1.0);
+    }
+    auto G = boost::make_shared<SparseRowMatrix>(n - 1, n);
+    G->setFromTriplets(entries.begin(), entries.end());
+    return G;
+  }
+
+  DenseMatrixHandle randomDense(int rows, int cols)
+  {
+    return boost::make_shared<DenseMatrix>(DenseMatrix::Random(rows, cols));
+  }
+}
+
+TEST(LinearOperatorTest, AppliesExpressionWithoutFormingIt)
+{
+  auto G = gradient(6);
+  auto L = randomDense(6, 6);
+  // G^T G + 0.5 L
+  auto op = LinearOperator::sum(LinearOperator::product(LinearOperator::transpose(G), G), LinearOperator::scale(0.5, L));
+  EXPECT_EQ(6u, op->nrows());
+  EXPECT_EQ(6u, op->ncols());
+
+  DenseMatrix::EigenBase expected = SparseRowMatrix(G->transpose()) * *G;
+  expected += 0.5 * *L;
+  DenseMatrix::EigenBase X = DenseMatrix::EigenBase::Random(6, 3);
+
+  EXPECT_TRUE(op->apply(X).isApprox(expected * X));
+  EXPECT_TRUE(op->apply(X, true).isApprox(expected.transpose() * X));
+  EXPECT_TRUE(op->toDense()->isApprox(expected));
+  EXPECT_NEAR(expected(2, 3), op->get(2, 3), 1e-14);
+}
+
+TEST(LinearOperatorTest, RectangularProductsKeepShape)
+{
+  auto G = gradient(5);
+  auto column = boost::make_shared<DenseColumnMatrix>(DenseColumnMatrix::Ones(4));
+  // G^T * column is 5 x 1, and its transpose is a row
+  auto op = LinearOperator::transpose(LinearOperator::product(LinearOperator::transpose(G), column));
+  EXPECT_EQ(1u, op->nrows());
+  EXPECT_EQ(5u, op->ncols());
+  DenseMatrix::EigenBase expected = (SparseRowMatrix(G->transpose()) * *column).transpose();
+  EXPECT_TRUE(op->toDense()->isApprox(expected));
+}
+
+TEST(LinearOperatorTest, ChecksDimensions)
+{
+  auto G = gradient(5);
+  EXPECT_THROW(LinearOperator::product(G, G), DimensionMismatch);
+  EXPECT_THROW(LinearOperator::sum(G, LinearOperator::transpose(G)), DimensionMismatch);
+  EXPECT_THROW(LinearOperator::scale(2, nullptr), NullPointerException);
+}
+
+TEST(LinearOperatorTest, ConversionsAssemble)
+{
+  auto G = gradient(5);
+  MatrixHandle op = LinearOperator::scale(2, G);
+  EXPECT_TRUE(matrixIs::linearOperator(op));
+  EXPECT_FALSE(matrixIs::linearOperator(G));
+  EXPECT_EQ("LinearOperator", matrixIs::whatType(op));
+  EXPECT_EQ(UNKNOWN, matrixIs::typeCode(op));
+
+  DenseMatrix expected = 2 * *convertMatrix::toDense(G);
+  EXPECT_EQ(expected, *convertMatrix::toDense(op));
+  EXPECT_EQ(expected, *convertMatrix::toDense(convertMatrix::toSparse(op)));
+  EXPECT_THROW(op->put(0, 0, 1.0), InvalidStateException);
+}
+
+TEST(LinearOperatorTest, DescribesExpression)
+{
+  auto G = gradient(4);
+  auto op = LinearOperator::sum(LinearOperator::product(LinearOperator::transpose(G), G), LinearOperator::scale(0.5, randomDense(4, 4)));
+  EXPECT_EQ("(SparseRowMatrix[3x4]^T * SparseRowMatrix[3x4]) + (0.5 * DenseMatrix[4x4])", op->expression());
+}
+
+TEST(LinearOperatorTest, SparseAssemblyKeepsOnlyNonzeros)
+{
+  // G^T G is tridiagonal; n spans several assembly blocks.
+  const int n = 600;
+  auto G = gradient(n);
+  auto op = LinearOperator::product(LinearOperator::transpose(G), G);
+  SparseRowMatrix expected = SparseRowMatrix(G->transpose()) * *G;
+
+  auto sparse = convertMatrix::toSparse(op);
+  ASSERT_TRUE(sparse != nullptr);
+  EXPECT_EQ(3 * n - 2, sparse->nonZeros());
+  EXPECT_EQ(expected.nonZeros(), sparse->nonZeros());
+  EXPECT_NEAR(0, SparseRowMatrix(*sparse - expected).norm(), 1e-12);
+}
@@ -1519,29 +1519,18 @@ NewArrayMathEngine::run()
   // Link everything together
   std::string full_expression = pre_expression_+";"+expression_+";"+post_expression_;
 
-  // Parse the full expression
-  if(!(parse(pprogram_,full_expression,error_str)))
-  {
-    pr_->error(error_str);
-    return (false);
-  }
-
   // Get the catalog with all possible functions
   ParserFunctionCatalogHandle catalog = ArrayMathFunctionCatalog::get_catalog();
 
-  // Validate the expressions
-  if (!(validate(pprogram_,catalog,error_str)))
-  {
-    pr_->error(error_str);
-    return (false);
-  }
-
-  // Optimize the expressions
-  if (!(optimize(pprogram_,error_str)))
+  // Parse, validate and optimize the full expression. If the same expression
+  // was run before on inputs of the same type, the program is reused.
+  ParserProgramHandle program;
+  if (!(compile(pprogram_,program,full_expression,catalog,error_str)))
   {
     pr_->error(error_str);
     return (false);
   }
+  pprogram_ = program;
 
   // DEBUG CALL
 #ifdef DEBUG
@@ -1797,18 +1786,26 @@ NewArrayMathEngine::run()
       }
     }
   }
-  // Translate the code
-  if (!(translate(pprogram_,mprogram_,error_str)))
+  if (!(create_program(mprogram_,error_str)))
   {
     pr_->error(error_str);
     return (false);
   }
-  // Set the final array size
+  mprogram_->set_kernel_fusion(kernel_fusion_);
+
+  // Set the final array size, the buffer size is derived from it when
+  // translating
   if(!(set_array_size(mprogram_,array_size_)))
   {
     pr_->error("Could not set array size.");
     return (false);
   }
+  // Translate the code
+  if (!(translate(pprogram_,mprogram_,error_str)))
+  {
+    pr_->error(error_str);
+    return (false);
+  }
   // Run the program
   if (!(ArrayMathInterpreter::run(mprogram_,error_str)))
   {
@@ -92,10 +92,14 @@ class SCISHARE NewArrayMathEngine : public Parser, public ArrayMathInterpreter
     // THAT THE FUNCTIONS ARE GIVEN HERE
 
     // Make sure it starts with a clean definition file
-    NewArrayMathEngine() { clear(); pr_ = &def_pr_; }
+    NewArrayMathEngine() : kernel_fusion_(true) { clear(); pr_ = &def_pr_; }
 
     void setLogger(Core::Logging::LegacyLoggerInterface* logger) { pr_ = logger; }
 
+    // Fuse chains of element-wise operations into single loops (default on),
+    // turning it off runs every function call separately
+    void set_kernel_fusion(bool kernel_fusion) { kernel_fusion_ = kernel_fusion; }
+
     // Generate inputs for field data and field data properties
     bool add_input_fielddata(const std::string& name,
                              FieldHandle field);
@@ -215,6 +219,9 @@ class SCISHARE NewArrayMathEngine : public Parser, public ArrayMathInterpreter
     // Any subsequent array that does not match the size will cause an error
     size_type array_size_;
 
+    // Whether the translated program uses fused kernels
+    bool kernel_fusion_;
+
     // Data that needs to be stored as it is needed before and after the parser is
     // done. An output needs to be set before the parser, otherwise it is optimized
     // away, but the type is only know when the parser has validated and optimized
@@ -28,6 +28,7 @@
 
 #include <Core/Parser/ArrayMathInterpreter.h>
 #include <Core/Parser/ArrayMathFunctionCatalog.h>
+#include <Core/Parser/ArrayMathKernelFusion.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
@@ -145,6 +146,18 @@ ArrayMathInterpreter::translate(ParserProgramHandle& pprogram,
   }
 
   // Determine how many space we need to reserve for sequential variables
+  size_t doubles_per_entry = 0;
+  for (size_t j=0; j<num_sequential_variables; j++)
+  {
+    pprogram->get_sequential_variable(j,vhandle);
+    std::string type = vhandle->get_type();
+
+    if (type == "S") { doubles_per_entry += 1; }
+    else if (type == "V") { doubles_per_entry += 3; }
+    else if (type == "T") { doubles_per_entry += 6; }
+  }
+  mprogram->tune_buffer_size(doubles_per_entry);
+
   auto buffer_size = mprogram->get_buffer_size();
   int num_proc    = mprogram->get_num_proc();
 
@@ -1187,6 +1200,10 @@ ArrayMathInterpreter::translate(ParserProgramHandle& pprogram,
     }
   }
 
+  // Merge chains of element-wise functions into single code segments
+  if (mprogram->get_kernel_fusion())
+    fuse_sequential_kernels(pprogram,mprogram);
+
   return (true);
 }
 
@@ -1555,7 +1572,7 @@ ArrayMathProgram::run_parallel(int proc)
     {
       if(!(sequential_functions_[proc][j]->run()))
       {
-        error_line_[proc] = j;
+        error_line_[proc] = sequential_lines_.empty() ? j : sequential_lines_[proc][j];
         success_[proc] = false;
       }
     }
@@ -1566,6 +1583,49 @@ ArrayMathProgram::run_parallel(int proc)
 }
 
 
+void
+ArrayMathProgram::set_sequential_program(size_t np,
+                                         const std::vector<ArrayMathProgramCodePtr>& codes,
+                                         const std::vector<size_t>& lines)
+{
+  if (sequential_lines_.empty())
+  {
+    // Start from the one to one mapping for every thread
+    sequential_lines_.resize(num_proc_);
+    for (int p=0; p<num_proc_; p++)
+    {
+      sequential_lines_[p].resize(sequential_functions_[p].size());
+      for (size_t j=0; j<sequential_lines_[p].size(); j++) sequential_lines_[p][j] = j;
+    }
+  }
+
+  sequential_functions_[np] = codes;
+  sequential_lines_[np] = lines;
+}
+
+void
+ArrayMathProgram::tune_buffer_size(size_t doubles_per_entry)
+{
+  if (!auto_buffer_size_ || doubles_per_entry == 0) return;
+
+  // Use half of the L2 cache for the buffers of one thread, the other half
+  // is left for the sources, sinks and the program itself
+  const size_t cache_size = Parallel::DataCacheSize(2);
+  size_t entries = cache_size/(2*sizeof(double)*doubles_per_entry);
+
+  const size_t min_size = 128;
+  const size_t max_size = 16384;
+  entries = std::max(min_size,std::min(max_size,entries));
+  entries -= entries % 64;
+
+  // No use in allocating buffers larger than the part a thread processes
+  size_type per_thread = array_size_/num_proc_ + 1;
+  if (per_thread < static_cast<size_type>(entries))
+    entries = std::max(min_size,static_cast<size_t>(per_thread));
+
+  buffer_size_ = static_cast<size_type>(entries);
+}
+
 void
 ArrayMathProgramCode::print() const
 {
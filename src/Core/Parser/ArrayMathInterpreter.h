@@ -316,7 +316,11 @@ class SCISHARE ArrayMathProgramSource {
     {
       // Buffer size describes how many values of a sequential variable are
       // grouped together for vectorized execution
+      // The default is adjusted to the cache size when the program is
+      // translated, see tune_buffer_size()
       buffer_size_ = 128;
+      auto_buffer_size_ = true;
+      kernel_fusion_ = true;
       array_size_ = 1;
     }
 
@@ -329,6 +333,8 @@ class SCISHARE ArrayMathProgramSource {
       // Buffer size describes how many values of a sequential variable are
       // grouped together for vectorized execution
       buffer_size_ = buffer_size;
+      auto_buffer_size_ = false;
+      kernel_fusion_ = true;
       array_size_ = array_size;
     }
 
@@ -340,6 +346,17 @@ class SCISHARE ArrayMathProgramSource {
     // Get the number of processors
     int get_num_proc() const { return (num_proc_); }
 
+    // Pick a buffer size so that the sequential buffers of one thread, each
+    // holding doubles_per_entry values per entry, stay in the L2 cache. Only
+    // applies when the buffer size was not given explicitly and has to be
+    // called before the buffers are allocated.
+    void tune_buffer_size(size_t doubles_per_entry);
+
+    // Whether chains of element-wise functions are fused into a single
+    // program code when the program is translated
+    bool get_kernel_fusion() const { return (kernel_fusion_); }
+    void set_kernel_fusion(bool kernel_fusion) { kernel_fusion_ = kernel_fusion; }
+
     // Set the size of the array to process
     size_type get_array_size() const { return (array_size_); }
     void set_array_size(size_type array_size) { array_size_ = array_size; }
@@ -378,6 +395,7 @@ class SCISHARE ArrayMathProgramSource {
         sequential_functions_.resize(num_proc_);
         for (int np=0; np < num_proc_; np++)
           sequential_functions_[np].resize(sz);
+        sequential_lines_.clear();
       }
 
     // Central buffer for all parameters
@@ -407,6 +425,16 @@ class SCISHARE ArrayMathProgramSource {
       { single_functions_[j] = pc; }
     void set_sequential_program_code(size_t j, size_t np, ArrayMathProgramCodePtr pc)
       { sequential_functions_[np][j] = pc; }
+    ArrayMathProgramCodePtr get_sequential_program_code(size_t j, size_t np) const
+      { return (sequential_functions_[np][j]); }
+
+    // Replace the sequential code of one thread, lines maps every new code
+    // segment onto the index of the (first) parser function it evaluates
+    void set_sequential_program(size_t np,
+                                const std::vector<ArrayMathProgramCodePtr>& codes,
+                                const std::vector<size_t>& lines);
+    size_t num_sequential_program_codes(size_t np) const
+      { return (sequential_functions_[np].size()); }
 
     // Code to find the pointers that are given for sources and sinks
     bool find_source(const std::string& name,  ArrayMathProgramSource& ps);
@@ -424,8 +452,12 @@ class SCISHARE ArrayMathProgramSource {
     // General parameters that determine how many values are computed at
     // the same time and how many processors to use
     size_type buffer_size_;
+    bool auto_buffer_size_;
     int num_proc_;
 
+    // Fuse element-wise functions when translating
+    bool kernel_fusion_;
+
     // The size of the array we are using
     size_type array_size_;
 
@@ -445,6 +477,9 @@ class SCISHARE ArrayMathProgramSource {
     std::vector<ArrayMathProgramCodePtr> const_functions_;
     std::vector<ArrayMathProgramCodePtr> single_functions_;
     std::vector<std::vector<ArrayMathProgramCodePtr> > sequential_functions_;
+    // Parser function index of each sequential code segment, empty if the
+    // code segments map one to one onto the parser functions
+    std::vector<std::vector<size_t> > sequential_lines_;
 
     ParserProgramHandle pprogram_;
 
@@ -0,0 +1,419 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Parser/ArrayMathKernelFusion.h>
+#include <cmath>
+#include <map>
+#include <set>
+
+using namespace SCIRun;
+
+double*
+ArrayMathFusedKernel::create_scratch(size_t size)
+{
+  scratch_.push_back(std::vector<double>(size));
+  return (scratch_.back().empty() ? nullptr : &(scratch_.back()[0]));
+}
+
+bool
+ArrayMathFusedKernel::operator()(ArrayMathProgramCode& pc) const
+{
+  const size_t size = pc.get_size();
+
+  for (const Operation& op : operations_)
+  {
+    double* data0 = op.output;
+    const double* data1 = op.input[0];
+    const double* data2 = op.input[1];
+    const double* data3 = op.input[2];
+
+    // Number of values processed by element-wise operators, the operators
+    // that combine with a scalar loop over elements and components instead
+    const size_t c = static_cast<size_t>(op.components);
+    const size_t n = size*c;
+
+    switch (op.code)
+    {
+      case ADD_E:
+        for (size_t i=0; i<n; i++) data0[i] = data1[i] + data2[i];
+        break;
+      case SUB_E:
+        for (size_t i=0; i<n; i++) data0[i] = data1[i] - data2[i];
+        break;
+      case MULT_E:
+        for (size_t i=0; i<n; i++) data0[i] = data1[i] * data2[i];
+        break;
+      case DIV_E:
+        for (size_t i=0; i<n; i++) data0[i] = data1[i] / data2[i];
+        break;
+      case ADD_SCALAR_E:
+        for (size_t i=0; i<size; i++)
+          for (size_t k=0; k<c; k++) data0[i*c+k] = data1[i*c+k] + data2[i];
+        break;
+      case SUB_SCALAR_E:
+        for (size_t i=0; i<size; i++)
+          for (size_t k=0; k<c; k++) data0[i*c+k] = data1[i*c+k] - data2[i];
+        break;
+      case MULT_SCALAR_E:
+        for (size_t i=0; i<size; i++)
+          for (size_t k=0; k<c; k++) data0[i*c+k] = data1[i*c+k] * data2[i];
+        break;
+      case DIV_SCALAR_E:
+        // Same as the interpreted version: multiply with the reciprocal
+        for (size_t i=0; i<size; i++)
+        {
+          double val = 1.0/data2[i];
+          for (size_t k=0; k<c; k++) data0[i*c+k] = data1[i*c+k] * val;
+        }
+        break;
+      case SCALAR_SUB_E:
+        for (size_t i=0; i<size; i++)
+          for (size_t k=0; k<c; k++) data0[i*c+k] = data1[i] - data2[i*c+k];
+        break;
+      case NEG_E:
+        for (size_t i=0; i<n; i++) data0[i] = -data1[i];
+        break;
+      case MULT_ADD_E:
+        for (size_t i=0; i<n; i++)
+        {
+          double val = data1[i] * data2[i];
+          data0[i] = val + data3[i];
+        }
+        break;
+      case ABS_E:
+        for (size_t i=0; i<n; i++) data0[i] = (data1[i] < 0) ? -data1[i] : data1[i];
+        break;
+      case SQRT_E:
+        for (size_t i=0; i<n; i++) data0[i] = ::sqrt(data1[i]);
+        break;
+      case EXP_E:
+        for (size_t i=0; i<n; i++) data0[i] = ::exp(data1[i]);
+        break;
+      case LOG_E:
+        for (size_t i=0; i<n; i++) data0[i] = ::log(data1[i]);
+        break;
+      case SIN_E:
+        for (size_t i=0; i<n; i++) data0[i] = ::sin(data1[i]);
+        break;
+      case COS_E:
+        for (size_t i=0; i<n; i++) data0[i] = ::cos(data1[i]);
+        break;
+      case POW_E:
+        for (size_t i=0; i<n; i++) data0[i] = ::pow(data1[i],data2[i]);
+        break;
+      default:
+        return (false);
+    }
+  }
+
+  return (true);
+}
+
+namespace {
+
+struct FusableFunction
+{
+  ArrayMathFusedKernel::OpCode code;
+  int components;
+};
+
+typedef std::map<std::string,FusableFunction> FusableFunctionTable;
+
+// Function IDs of the interpreted functions that have an equivalent
+// operator in the fused kernel
+const FusableFunctionTable&
+fusable_functions()
+{
+  typedef ArrayMathFusedKernel K;
+  static const FusableFunctionTable table = {
+    { "add$S:S",  { K::ADD_E, 1 } },
+    { "add$V:V",  { K::ADD_E, 3 } },
+    { "add$T:T",  { K::ADD_E, 6 } },
+    { "add$V:S",  { K::ADD_SCALAR_E, 3 } },
+    { "add$T:S",  { K::ADD_SCALAR_E, 6 } },
+    { "sub$S:S",  { K::SUB_E, 1 } },
+    { "sub$V:V",  { K::SUB_E, 3 } },
+    { "sub$T:T",  { K::SUB_E, 6 } },
+    { "sub$V:S",  { K::SUB_SCALAR_E, 3 } },
+    { "sub$T:S",  { K::SUB_SCALAR_E, 6 } },
+    { "sub$S:V",  { K::SCALAR_SUB_E, 3 } },
+    { "sub$S:T",  { K::SCALAR_SUB_E, 6 } },
+    { "mult$S:S", { K::MULT_E, 1 } },
+    { "mult$V:V", { K::MULT_E, 3 } },
+    { "mult$V:S", { K::MULT_SCALAR_E, 3 } },
+    { "mult$T:S", { K::MULT_SCALAR_E, 6 } },
+    { "div$S:S",  { K::DIV_E, 1 } },
+    { "div$V:S",  { K::DIV_SCALAR_E, 3 } },
+    { "div$T:S",  { K::DIV_SCALAR_E, 6 } },
+    { "neg$S",    { K::NEG_E, 1 } },
+    { "neg$V",    { K::NEG_E, 3 } },
+    { "neg$T",    { K::NEG_E, 6 } },
+    { "abs$S",    { K::ABS_E, 1 } },
+    { "sqrt$S",   { K::SQRT_E, 1 } },
+    { "exp$S",    { K::EXP_E, 1 } },
+    { "log$S",    { K::LOG_E, 1 } },
+    { "ln$S",     { K::LOG_E, 1 } },
+    { "sin$S",    { K::SIN_E, 1 } },
+    { "cos$S",    { K::COS_E, 1 } },
+    { "pow$S:S",  { K::POW_E, 1 } }
+  };
+  return (table);
+}
+
+int
+type_components(const std::string& type)
+{
+  if (type == "S") return (1);
+  if (type == "V") return (3);
+  if (type == "T") return (6);
+  return (0);
+}
+
+bool
+is_buffered_sequential(const ParserScriptVariableHandle& vhandle)
+{
+  return (vhandle && type_components(vhandle->get_type()) > 0 &&
+          (vhandle->get_flags() & SCRIPT_SEQUENTIAL_VAR_E));
+}
+
+// Builds the fused kernel for functions [begin,end) of one thread, returns
+// an empty pointer if the chain cannot be fused.
+ArrayMathProgramCodePtr
+build_fused_code(const std::vector<ParserScriptFunctionHandle>& functions,
+                 const std::vector<FusableFunction>& ops,
+                 const std::vector<size_t>& uses,
+                 size_t begin, size_t end, size_t np,
+                 ArrayMathProgramHandle& mprogram)
+{
+  typedef ArrayMathFusedKernel K;
+  boost::shared_ptr<K> kernel(new K);
+
+  // Variables that are produced and consumed inside this chain only
+  std::map<int,size_t> produced;
+  std::map<int,size_t> inside_uses;
+  std::map<int,size_t> last_use;
+  for (size_t j=begin; j<end; j++)
+  {
+    for (size_t i=0; i<functions[j]->num_input_vars(); i++)
+    {
+      int num = functions[j]->get_input_var(i)->get_var_number();
+      inside_uses[num]++;
+      last_use[num] = j;
+    }
+    produced[functions[j]->get_output_var()->get_var_number()] = j;
+  }
+
+  auto is_temporary = [&](int num)
+  {
+    return (produced.count(num) > 0 && inside_uses[num] == uses[num]);
+  };
+
+  std::map<int,double*> assigned;
+  std::map<int,std::vector<double*> > free_scratch;
+  const size_t buffer_size = mprogram->get_buffer_size();
+
+  auto resolve = [&](const ParserScriptVariableHandle& vhandle) -> double*
+  {
+    int num = vhandle->get_var_number();
+    if (is_temporary(num)) return (assigned[num]);
+    return (mprogram->get_sequential_variable(num,np)->get_data());
+  };
+
+  size_t j = begin;
+  while (j < end)
+  {
+    const ParserScriptFunctionHandle& fhandle = functions[j];
+    ParserScriptVariableHandle ohandle = fhandle->get_output_var();
+
+    K::Operation op;
+    op.code = ops[j].code;
+    op.components = ops[j].components;
+    op.input[0] = op.input[1] = op.input[2] = nullptr;
+
+    for (size_t i=0; i<fhandle->num_input_vars(); i++)
+      op.input[i] = resolve(fhandle->get_input_var(i));
+
+    // A scalar product that only feeds the next addition is evaluated in
+    // the same loop as that addition
+    size_t last = j;
+    if (op.code == K::MULT_E && op.components == 1 && j+1 < end &&
+        ops[j+1].code == K::ADD_E && ops[j+1].components == 1 &&
+        uses[ohandle->get_var_number()] == 1)
+    {
+      const ParserScriptFunctionHandle& next = functions[j+1];
+      int product = ohandle->get_var_number();
+      int other = -1;
+      if (next->get_input_var(0)->get_var_number() == product) other = 1;
+      else if (next->get_input_var(1)->get_var_number() == product) other = 0;
+
+      if (other >= 0)
+      {
+        op.code = K::MULT_ADD_E;
+        op.input[2] = resolve(next->get_input_var(other));
+        ohandle = next->get_output_var();
+        last = j+1;
+      }
+    }
+
+    // Allocate the output before releasing the inputs, so the output of
+    // an operation never aliases one of its inputs
+    int onum = ohandle->get_var_number();
+    if (is_temporary(onum))
+    {
+      std::vector<double*>& pool = free_scratch[op.components];
+      if (pool.empty())
+      {
+        op.output = kernel->create_scratch(buffer_size*op.components);
+      }
+      else
+      {
+        op.output = pool.back();
+        pool.pop_back();
+      }
+      assigned[onum] = op.output;
+    }
+    else
+    {
+      op.output = mprogram->get_sequential_variable(onum,np)->get_data();
+    }
+
+    if (!op.output || !op.input[0]) return (ArrayMathProgramCodePtr());
+
+    std::set<int> released;
+    for (size_t k=j; k<=last; k++)
+    {
+      for (size_t i=0; i<functions[k]->num_input_vars(); i++)
+      {
+        ParserScriptVariableHandle ihandle = functions[k]->get_input_var(i);
+        int num = ihandle->get_var_number();
+        if (!is_temporary(num) || last_use[num] > last) continue;
+        if (assigned.count(num) == 0 || !released.insert(num).second) continue;
+        free_scratch[type_components(ihandle->get_type())].push_back(assigned[num]);
+      }
+    }
+
+    kernel->add_operation(op);
+    j = last+1;
+  }
+
+  return (ArrayMathProgramCodePtr(new ArrayMathProgramCode(
+    [kernel](ArrayMathProgramCode& pc) { return ((*kernel)(pc)); })));
+}
+
+}
+
+size_t
+SCIRun::fuse_sequential_kernels(ParserProgramHandle& pprogram,
+                                ArrayMathProgramHandle& mprogram)
+{
+  const size_t num_functions = pprogram->num_sequential_functions();
+  const size_t num_variables = pprogram->num_sequential_variables();
+  const int num_proc = mprogram->get_num_proc();
+  const FusableFunctionTable& table = fusable_functions();
+
+  std::vector<ParserScriptFunctionHandle> functions(num_functions);
+  std::vector<FusableFunction> ops(num_functions);
+  std::vector<bool> fusable(num_functions,false);
+  std::vector<size_t> uses(num_variables,0);
+
+  for (size_t j=0; j<num_functions; j++)
+  {
+    pprogram->get_sequential_function(j,functions[j]);
+    const ParserScriptFunctionHandle& fhandle = functions[j];
+
+    bool inputs_buffered = true;
+    for (size_t i=0; i<fhandle->num_input_vars(); i++)
+    {
+      ParserScriptVariableHandle ihandle = fhandle->get_input_var(i);
+      if (is_buffered_sequential(ihandle))
+        uses[ihandle->get_var_number()]++;
+      else
+        inputs_buffered = false;
+    }
+
+    FusableFunctionTable::const_iterator it =
+      table.find(fhandle->get_function()->get_function_id());
+    if (it == table.end() || !inputs_buffered) continue;
+
+    // Constant sequential variables are shared between threads and are
+    // filled by the const part of the program, never write into those
+    ParserScriptVariableHandle ohandle = fhandle->get_output_var();
+    if (!is_buffered_sequential(ohandle) ||
+        (ohandle->get_flags() & SCRIPT_CONST_VAR_E)) continue;
+
+    ops[j] = it->second;
+    fusable[j] = true;
+  }
+
+  // Collect the chains that are worth fusing
+  std::vector<std::pair<size_t,size_t> > chains;
+  for (size_t j=0; j<num_functions;)
+  {
+    size_t k = j;
+    while (k < num_functions && fusable[k]) k++;
+    if (k-j > 1) chains.push_back(std::make_pair(j,k));
+    j = (k == j) ? j+1 : k;
+  }
+
+  if (chains.empty()) return (0);
+
+  size_t removed = 0;
+  for (int np=0; np<num_proc; np++)
+  {
+    std::vector<ArrayMathProgramCodePtr> codes;
+    std::vector<size_t> lines;
+
+    size_t c = 0;
+    for (size_t j=0; j<num_functions;)
+    {
+      if (c < chains.size() && chains[c].first == j)
+      {
+        ArrayMathProgramCodePtr pc = build_fused_code(functions,ops,uses,
+          chains[c].first,chains[c].second,np,mprogram);
+        if (pc)
+        {
+          codes.push_back(pc);
+          lines.push_back(j);
+          j = chains[c].second;
+          c++;
+          continue;
+        }
+        c++;
+      }
+      codes.push_back(mprogram->get_sequential_program_code(j,np));
+      lines.push_back(j);
+      j++;
+    }
+
+    if (np == 0) removed = num_functions - codes.size();
+    mprogram->set_sequential_program(np,codes,lines);
+  }
+
+  return (removed);
+}
@@ -0,0 +1,90 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_PARSER_ARRAYMATHKERNELFUSION_H
+#define CORE_PARSER_ARRAYMATHKERNELFUSION_H 1
+
+#include <Core/Parser/ArrayMathInterpreter.h>
+#include <Core/Parser/share.h>
+
+namespace SCIRun {
+
+//-----------------------------------------------------------------------------
+// Kernel fusion for the sequential part of an ArrayMathProgram.
+//
+// Consecutive element-wise scalar/vector/tensor operators (add, sub, mult,
+// div, neg and the common scalar math functions) are collected into a single
+// program code. Operand pointers are resolved once at translation time, so
+// running a fused chain does not go through boost::function or the variant
+// lookup per operator. Temporaries that are produced and consumed inside the
+// chain are kept in a small tile-local scratch area instead of the program
+// buffer, and a multiplication that only feeds the next addition is evaluated
+// in the same loop.
+
+class SCISHARE ArrayMathFusedKernel
+{
+  public:
+    enum OpCode
+    {
+      ADD_E, SUB_E, MULT_E, DIV_E,
+      ADD_SCALAR_E, SUB_SCALAR_E, MULT_SCALAR_E, DIV_SCALAR_E,
+      SCALAR_SUB_E, NEG_E, MULT_ADD_E,
+      ABS_E, SQRT_E, EXP_E, LOG_E, SIN_E, COS_E, POW_E
+    };
+
+    struct Operation
+    {
+      OpCode code;
+      // Number of doubles per element of the output (1, 3 or 6)
+      int components;
+      double* output;
+      double* input[3];
+    };
+
+    void add_operation(const Operation& op) { operations_.push_back(op); }
+    size_t num_operations() const { return (operations_.size()); }
+
+    // Scratch space for temporaries that never leave the kernel
+    double* create_scratch(size_t size);
+
+    // Signature matches ArrayMathFunctionPtr
+    bool operator()(ArrayMathProgramCode& pc) const;
+
+  private:
+    std::vector<Operation> operations_;
+    std::vector<std::vector<double> > scratch_;
+};
+
+// Replaces fusable runs in the sequential program of every thread, returns
+// the number of program codes that were removed.
+SCISHARE size_t fuse_sequential_kernels(ParserProgramHandle& pprogram,
+                                        ArrayMathProgramHandle& mprogram);
+
+}
+
+#endif
@@ -135,29 +135,18 @@ NewLinAlgEngine::run()
   // Link everything together
   std::string full_expression = pre_expression_+";"+expression_+";"+post_expression_;
 
-  // Parse the full expression
-  if(!(parse(pprogram_,full_expression,error_str)))
-  {
-    pr_->error(error_str);
-    return (false);
-  }
-
   // Get the catalog with all possible functions
   ParserFunctionCatalogHandle catalog = LinAlgFunctionCatalog::get_catalog();
 
-  // Validate the expressions
-  if (!(validate(pprogram_,catalog,error_str)))
-  {
-    pr_->error(error_str);
-    return (false);
-  }
-
-  // Optimize the expressions
-  if (!(optimize(pprogram_,error_str)))
+  // Parse, validate and optimize the full expression. If the same expression
+  // was run before on inputs of the same type, the program is reused.
+  ParserProgramHandle program;
+  if (!(compile(pprogram_,program,full_expression,catalog,error_str)))
   {
     pr_->error(error_str);
     return (false);
   }
+  pprogram_ = program;
 
   // DEBUG CALL
 #ifdef DEBUG
@@ -27,6 +27,7 @@
 
 
 #include <Core/Parser/Parser.h>
+#include <Core/Parser/ParserProgramCache.h>
 #include <Core/Datatypes/Legacy/Base/Types.h>
 #include <iostream>
 #include <sci_debug.h>
@@ -2233,6 +2234,41 @@ Parser::recursive_validate(ParserNodeHandle handle,
 }
 
 
+bool
+Parser::compile(ParserProgramHandle declarations,
+                ParserProgramHandle& program,
+                const std::string& expressions,
+                ParserFunctionCatalogHandle catalog,
+                std::string& error)
+{
+  ParserProgramCache& cache = ParserProgramCache::instance();
+  std::string key = ParserProgramCache::make_key(catalog,expressions,declarations);
+  if (cache.find(key,program)) return (true);
+
+  // Start from a clean program, so the declarations can be reused
+  program.reset(new ParserProgram());
+  if (declarations)
+  {
+    ParserVariableList var_list;
+    declarations->get_input_variables(var_list);
+    for (auto& var : var_list)
+      program->add_input_variable(var.first,var.second->get_type(),var.second->get_flags());
+
+    declarations->get_output_variables(var_list);
+    for (auto& var : var_list)
+      program->add_output_variable(var.first,var.second->get_type(),var.second->get_flags());
+  }
+
+  // Parsing removes the expressions from the string
+  std::string script = expressions;
+  if (!(parse(program,script,error))) return (false);
+  if (!(validate(program,catalog,error))) return (false);
+  if (!(optimize(program,error))) return (false);
+
+  cache.insert(key,program);
+  return (true);
+}
+
 bool
 Parser::optimize(ParserProgramHandle program,
                  std::string& error)
@@ -738,6 +738,16 @@ class SCISHARE Parser {
     bool optimize(ParserProgramHandle program,
                   std::string& error);
 
+    // Parse, validate and optimize in one step. The variables declared on
+    // declarations are copied into a new program, unless an identical
+    // program was compiled before, in which case the cached one is returned.
+    // The returned program can be shared and should not be modified.
+    bool compile(ParserProgramHandle declarations,
+                 ParserProgramHandle& program,
+                 const std::string& expressions,
+                 ParserFunctionCatalogHandle catalog,
+                 std::string& error);
+
     //--------------------------------------------------------------------------
     // Setup of parser
 
@@ -0,0 +1,177 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Parser/ParserProgramCache.h>
+#include <sstream>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Thread;
+
+ParserProgramCache::ParserProgramCache() :
+  enabled_(true),
+  max_entries_(256),
+  hits_(0),
+  misses_(0),
+  evictions_(0),
+  lock_("ParserProgramCache")
+{
+}
+
+ParserProgramCache&
+ParserProgramCache::instance()
+{
+  static ParserProgramCache cache;
+  return (cache);
+}
+
+std::string
+ParserProgramCache::make_key(ParserFunctionCatalogHandle catalog,
+                             const std::string& expressions,
+                             ParserProgramHandle declarations)
+{
+  std::ostringstream key;
+  key << catalog.get() << "\n" << expressions << "\n";
+
+  if (declarations)
+  {
+    ParserVariableList var_list;
+    declarations->get_input_variables(var_list);
+    for (auto& var : var_list)
+    {
+      key << "I:" << var.first << ":" << var.second->get_type() << ":"
+          << var.second->get_flags() << "\n";
+    }
+
+    declarations->get_output_variables(var_list);
+    for (auto& var : var_list)
+    {
+      key << "O:" << var.first << ":" << var.second->get_type() << ":"
+          << var.second->get_flags() << "\n";
+    }
+  }
+
+  return (key.str());
+}
+
+bool
+ParserProgramCache::find(const std::string& key, ParserProgramHandle& program)
+{
+  Guard g(lock_.get());
+  if (!enabled_) return (false);
+
+  auto it = index_.find(key);
+  if (it == index_.end())
+  {
+    misses_++;
+    return (false);
+  }
+
+  // Move to the front of the list
+  entries_.splice(entries_.begin(),entries_,it->second);
+  program = it->second->second;
+  hits_++;
+  return (true);
+}
+
+void
+ParserProgramCache::insert(const std::string& key, ParserProgramHandle program)
+{
+  Guard g(lock_.get());
+  if (!enabled_ || max_entries_ == 0) return;
+
+  auto it = index_.find(key);
+  if (it != index_.end())
+  {
+    it->second->second = program;
+    entries_.splice(entries_.begin(),entries_,it->second);
+    return;
+  }
+
+  entries_.push_front(entry_type(key,program));
+  index_[key] = entries_.begin();
+  trim();
+}
+
+void
+ParserProgramCache::trim()
+{
+  while (entries_.size() > max_entries_)
+  {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+    evictions_++;
+  }
+}
+
+void
+ParserProgramCache::set_enabled(bool enabled)
+{
+  Guard g(lock_.get());
+  enabled_ = enabled;
+  if (!enabled_)
+  {
+    entries_.clear();
+    index_.clear();
+  }
+}
+
+void
+ParserProgramCache::set_max_entries(size_t max_entries)
+{
+  Guard g(lock_.get());
+  max_entries_ = max_entries;
+  trim();
+}
+
+ParserProgramCache::Statistics
+ParserProgramCache::statistics() const
+{
+  Guard g(lock_.get());
+  Statistics stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.evictions = evictions_;
+  stats.entries = entries_.size();
+  return (stats);
+}
+
+void
+ParserProgramCache::reset_statistics()
+{
+  Guard g(lock_.get());
+  hits_ = misses_ = evictions_ = 0;
+}
+
+void
+ParserProgramCache::clear()
+{
+  Guard g(lock_.get());
+  entries_.clear();
+  index_.clear();
+}
@@ -0,0 +1,107 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_PARSER_PARSERPROGRAMCACHE_H
+#define CORE_PARSER_PARSERPROGRAMCACHE_H 1
+
+#include <Core/Parser/Parser.h>
+#include <list>
+
+#include <Core/Parser/share.h>
+
+namespace SCIRun {
+
+// Process wide cache of parsed, validated and optimized parser programs.
+// A program only depends on the expression, the function catalog and the
+// names, types and flags of the declared input and output variables, not
+// on the data that is bound to it by the interpreters. Hence an engine that
+// runs the same expression on new data of the same type can skip the parser
+// and go straight to translating the cached program.
+//
+// Cached programs are shared and must be treated as read only.
+
+class SCISHARE ParserProgramCache : boost::noncopyable
+{
+  public:
+    struct Statistics
+    {
+      size_t hits;
+      size_t misses;
+      size_t evictions;
+      size_t entries;
+    };
+
+    static ParserProgramCache& instance();
+
+    // Key that identifies a program: catalog, expression and the variables
+    // declared on the (not yet parsed) program
+    static std::string make_key(ParserFunctionCatalogHandle catalog,
+                                const std::string& expressions,
+                                ParserProgramHandle declarations);
+
+    bool find(const std::string& key, ParserProgramHandle& program);
+    void insert(const std::string& key, ParserProgramHandle program);
+
+    // Turning the cache off also clears it
+    void set_enabled(bool enabled);
+    bool is_enabled() const { return (enabled_); }
+
+    // Number of programs that are kept, least recently used ones are dropped
+    void set_max_entries(size_t max_entries);
+    size_t get_max_entries() const { return (max_entries_); }
+
+    Statistics statistics() const;
+    void reset_statistics();
+    void clear();
+
+  private:
+    ParserProgramCache();
+
+    typedef std::pair<std::string,ParserProgramHandle> entry_type;
+    typedef std::list<entry_type> entry_list;
+
+    void trim();
+
+    // Most recently used programs are at the front
+    entry_list entries_;
+    std::map<std::string,entry_list::iterator> index_;
+
+    bool enabled_;
+    size_t max_entries_;
+
+    size_t hits_;
+    size_t misses_;
+    size_t evictions_;
+
+    mutable Core::Thread::Mutex lock_;
+};
+
+}
+
+#endif
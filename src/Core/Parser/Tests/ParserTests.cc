@@ -33,6 +33,7 @@
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Parser/ArrayMathEngine.h>
+#include <Core/Parser/ParserProgramCache.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Geometry;
@@ -91,6 +92,27 @@ protected:
     EXPECT_EQ(expectedMin, min);
     EXPECT_EQ(expectedMax, max);
   }
+  std::vector<double> evaluate(FieldHandle field, const std::string& function, bool kernelFusion)
+  {
+    NewArrayMathEngine engine;
+    engine.set_kernel_fusion(kernelFusion);
+    setupEngine(engine, field);
+
+    std::vector<double> values;
+    EXPECT_TRUE(engine.add_expressions("RESULT = " + function));
+    EXPECT_TRUE(engine.run());
+
+    FieldHandle ofield;
+    engine.get_field("RESULT",ofield);
+    if (!ofield)
+      return values;
+
+    auto ovfield = ofield->vfield();
+    values.resize(ovfield->num_values());
+    for (VMesh::index_type i = 0; i < static_cast<VMesh::index_type>(values.size()); ++i)
+      ovfield->get_value(values[i], i);
+    return values;
+  }
   void testBadParseFunction(const std::string& function)
   {
     FieldHandle field(CreateEmptyLatVol(3,3,3));
@@ -1577,6 +1599,157 @@ TEST_F(BasicParserTests, CreateFieldData_fracanisotropy)
 
 */
 
+namespace
+{
+  const char* fusedExpressions[] =
+  {
+    "X + Y + Z;",
+    "X*Y + Z;",
+    "2*X*X - 3*Y/(Z+4) + 1;",
+    "sqrt(abs(X*Y + Z*Z)) + exp(-X*X) - cos(Y)*sin(Z);",
+    "pow(X+2,Y) - log(Z+3);",
+    "length(POS*2 + vector(X,Y,Z)/3 - 1);",
+    "dot(POS - vector(1,0,0), -POS*Z) + X;",
+    "length(POS*POS) / (1 + X*X);"
+  };
+}
+
+TEST_F(BasicParserTests, FusedKernelsMatchFunctionCalls)
+{
+  FieldHandle field(CreateEmptyLatVol(23,19,17));
+
+  for (auto expr : fusedExpressions)
+  {
+    auto fused = evaluate(field, expr, true);
+    auto unfused = evaluate(field, expr, false);
+    ASSERT_EQ(23*19*17, fused.size()) << expr;
+    ASSERT_EQ(unfused.size(), fused.size()) << expr;
+    for (size_t i = 0; i < fused.size(); ++i)
+      ASSERT_DOUBLE_EQ(unfused[i], fused[i]) << expr << " at " << i;
+  }
+}
+
+// The program cache is process wide. Every test starts from an empty, enabled
+// cache with a known size, and the previous settings come back afterwards, so
+// the counts do not depend on which tests ran before.
+class ProgramCacheTests : public BasicParserTests
+{
+protected:
+  void SetUp() override
+  {
+    auto& cache = ParserProgramCache::instance();
+    enabled_ = cache.is_enabled();
+    maxEntries_ = cache.get_max_entries();
+    cache.set_enabled(true);
+    cache.set_max_entries(16);
+    cache.clear();
+    cache.reset_statistics();
+  }
+
+  void TearDown() override
+  {
+    auto& cache = ParserProgramCache::instance();
+    cache.clear();
+    cache.set_enabled(enabled_);
+    cache.set_max_entries(maxEntries_);
+  }
+
+private:
+  bool enabled_ = true;
+  size_t maxEntries_ = 0;
+};
+
+TEST_F(ProgramCacheTests, ReusesParsedExpressions)
+{
+  auto& cache = ParserProgramCache::instance();
+
+  FieldHandle field(CreateEmptyLatVol(4,4,4));
+  const std::string expr = "X*Y - Z/(2+X*X);";
+
+  auto first = evaluate(field, expr, true);
+  auto stats = cache.statistics();
+  EXPECT_EQ(0u, stats.hits);
+  EXPECT_EQ(1u, stats.misses);
+  EXPECT_EQ(1u, stats.entries);
+
+  // same expression and input types on new data
+  FieldHandle other(CreateEmptyLatVol(4,4,4));
+  auto second = evaluate(other, expr, true);
+  stats = cache.statistics();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(1u, stats.entries);
+  EXPECT_EQ(first, second);
+
+  // a different expression is parsed again
+  evaluate(field, "X + 1;", true);
+  stats = cache.statistics();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(2u, stats.misses);
+  EXPECT_EQ(2u, stats.entries);
+
+  cache.set_max_entries(1);
+  stats = cache.statistics();
+  EXPECT_EQ(1u, stats.entries);
+  EXPECT_EQ(1u, stats.evictions);
+}
+
+TEST_F(ProgramCacheTests, DoesNotMixInputTypes)
+{
+  auto& cache = ParserProgramCache::instance();
+
+  FieldHandle field(CreateEmptyLatVol(3,3,3));
+  for (int i = 0; i < 2; ++i)
+  {
+    NewArrayMathEngine engine;
+    setupEngine(engine, field);
+    ASSERT_TRUE(engine.add_input_fielddata("DATA", field));
+    ASSERT_TRUE(engine.add_expressions("RESULT = DATA + X;"));
+    ASSERT_TRUE(engine.run());
+  }
+
+  FieldInformation vfi("LatVolMesh", 1, "Vector");
+  FieldHandle vfield = CreateField(vfi, field->mesh());
+  {
+    NewArrayMathEngine engine;
+    setupEngine(engine, field);
+    ASSERT_TRUE(engine.add_input_fielddata("DATA", vfield));
+    ASSERT_TRUE(engine.add_expressions("RESULT = length(DATA) + X;"));
+    ASSERT_TRUE(engine.run());
+  }
+  {
+    // the expression cached for scalar data is parsed again for vector data
+    NewArrayMathEngine engine;
+    setupEngine(engine, field);
+    ASSERT_TRUE(engine.add_input_fielddata("DATA", vfield));
+    ASSERT_TRUE(engine.add_expressions("RESULT = DATA + X;"));
+    EXPECT_TRUE(engine.run());
+  }
+
+  auto stats = cache.statistics();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(3u, stats.misses);
+  EXPECT_EQ(3u, stats.entries);
+}
+
+TEST_F(ProgramCacheTests, HitsRepeatedSmallFieldEvaluations)
+{
+  auto& cache = ParserProgramCache::instance();
+  FieldHandle field(CreateEmptyLatVol(5,5,5));
+  const std::string expr = "sqrt(X*X + Y*Y + Z*Z) * sin(X) + cos(Y)/(1 + Z*Z) - 2*abs(X-Y);";
+  const int runs = 20;
+
+  for (bool enabled : { false, true })
+  {
+    cache.set_enabled(enabled);
+    cache.clear();
+    cache.reset_statistics();
+    for (int i = 0; i < runs; ++i)
+      evaluate(field, expr, true);
+    auto stats = cache.statistics();
+    EXPECT_EQ(enabled ? static_cast<size_t>(runs - 1) : 0u, stats.hits);
+  }
+}
+
 TEST(FieldHashTests, TestShiftingZero)
 {
   // copied from TetVolMesh.h, failing compilation on GCC 6.2.
@@ -0,0 +1,411 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifdef BUILD_WITH_PYTHON
+
+#include <Core/Python/PythonBufferExchange.h>
+#include <Core/Python/PythonDatatypeConverter.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <cstring>
+#include <numeric>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Python;
+
+namespace py = boost::python;
+
+namespace
+{
+  struct BufferStorage
+  {
+    DatatypeHandle owner;
+    const void* data;
+    std::string format;
+    Py_ssize_t itemSize;
+    std::vector<Py_ssize_t> shape;
+    std::vector<Py_ssize_t> strides;
+  };
+
+  struct BufferExporter
+  {
+    PyObject_HEAD
+    BufferStorage* storage;
+  };
+
+  int exporterGetBuffer(PyObject* self, Py_buffer* view, int flags)
+  {
+    if (flags & PyBUF_WRITABLE)
+    {
+      PyErr_SetString(PyExc_BufferError, "SCIRun datatype buffers are read-only; copy the array before modifying it.");
+      view->obj = nullptr;
+      return -1;
+    }
+    // Storage-less views have a zero extent (see makeBufferView), so len is zero and
+    // the placeholder is never read.
+    static double empty = 0;
+    auto storage = reinterpret_cast<BufferExporter*>(self)->storage;
+    const auto count = std::accumulate(storage->shape.begin(), storage->shape.end(), Py_ssize_t(1), std::multiplies<Py_ssize_t>());
+
+    view->obj = self;
+    Py_INCREF(self);
+    view->buf = const_cast<void*>(storage->data ? storage->data : &empty);
+    view->len = count * storage->itemSize;
+    view->readonly = 1;
+    view->itemsize = storage->itemSize;
+    view->format = (flags & PyBUF_FORMAT) ? const_cast<char*>(storage->format.c_str()) : nullptr;
+    view->ndim = static_cast<int>(storage->shape.size());
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? &storage->shape[0] : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &storage->strides[0] : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+  }
+
+  void exporterDealloc(PyObject* self)
+  {
+    delete reinterpret_cast<BufferExporter*>(self)->storage;
+    Py_TYPE(self)->tp_free(self);
+  }
+
+  PyTypeObject* exporterType()
+  {
+    static PyBufferProcs bufferProcs = { exporterGetBuffer, nullptr };
+    static PyTypeObject type = { PyVarObject_HEAD_INIT(nullptr, 0) };
+    static bool ready = false;
+    if (!ready)
+    {
+      type.tp_name = "scirun.DatatypeBuffer";
+      type.tp_doc = "Read-only buffer over the storage of a SCIRun datatype";
+      type.tp_basicsize = sizeof(BufferExporter);
+      type.tp_flags = Py_TPFLAGS_DEFAULT;
+      type.tp_dealloc = exporterDealloc;
+      type.tp_as_buffer = &bufferProcs;
+      if (PyType_Ready(&type) < 0)
+        py::throw_error_already_set();
+      ready = true;
+    }
+    return &type;
+  }
+
+  const BufferStorage* findExporter(py::object object)
+  {
+    // memoryview -> exporter, or numpy array -> .base -> memoryview -> exporter
+    for (int depth = 0; depth < 4 && !object.is_none(); ++depth)
+    {
+      if (Py_TYPE(object.ptr()) == exporterType())
+        return reinterpret_cast<BufferExporter*>(object.ptr())->storage;
+      if (PyMemoryView_Check(object.ptr()))
+      {
+        auto base = PyMemoryView_GET_BUFFER(object.ptr())->obj;
+        if (!base)
+          return nullptr;
+        object = py::object(py::handle<>(py::borrowed(base)));
+      }
+      else if (PyObject_HasAttrString(object.ptr(), "base"))
+        object = object.attr("base");
+      else
+        return nullptr;
+    }
+    return nullptr;
+  }
+
+  class ScopedBuffer
+  {
+  public:
+    ScopedBuffer(const py::object& object, int flags)
+    {
+      valid_ = !PyBytes_Check(object.ptr()) && !PyByteArray_Check(object.ptr())
+        && PyObject_CheckBuffer(object.ptr()) && 0 == PyObject_GetBuffer(object.ptr(), &view_, flags);
+      if (!valid_)
+        PyErr_Clear();
+    }
+    ~ScopedBuffer()
+    {
+      if (valid_)
+        PyBuffer_Release(&view_);
+    }
+    ScopedBuffer(const ScopedBuffer&) = delete;
+    ScopedBuffer& operator=(const ScopedBuffer&) = delete;
+
+    bool valid() const { return valid_; }
+    const Py_buffer& view() const { return view_; }
+
+    // Native-order type code, or 0 if the format is not a plain number.
+    char typeCode() const
+    {
+      const char* f = view_.format ? view_.format : "B";
+      if (*f == '@' || *f == '=' || *f == '<')
+        ++f;
+      if (f[0] == '\0' || f[1] != '\0')
+        return 0;
+      return std::strchr("bBhHiIlLqQfd?", f[0]) ? f[0] : 0;
+    }
+
+    Py_ssize_t size() const
+    {
+      Py_ssize_t n = 1;
+      for (int i = 0; i < view_.ndim; ++i)
+        n *= view_.shape[i];
+      return n;
+    }
+
+    // Copies the elements in C order, converting to Out. A single memcpy when possible.
+    template <typename Out>
+    bool copyTo(Out* out) const
+    {
+      switch (typeCode())
+      {
+      case 'b': return copyAs<signed char>(out);
+      case 'B': return copyAs<unsigned char>(out);
+      case '?': return copyAs<bool>(out);
+      case 'h': return copyAs<short>(out);
+      case 'H': return copyAs<unsigned short>(out);
+      case 'i': return copyAs<int>(out);
+      case 'I': return copyAs<unsigned int>(out);
+      case 'l': return copyAs<long>(out);
+      case 'L': return copyAs<unsigned long>(out);
+      case 'q': return copyAs<long long>(out);
+      case 'Q': return copyAs<unsigned long long>(out);
+      case 'f': return copyAs<float>(out);
+      case 'd': return copyAs<double>(out);
+      default: return false;
+      }
+    }
+
+  private:
+    template <typename In, typename Out>
+    bool copyAs(Out* out) const
+    {
+      if (sizeof(In) != view_.itemsize)
+        return false;
+      if (std::is_same<In, Out>::value && PyBuffer_IsContiguous(&view_, 'C'))
+      {
+        std::memcpy(out, view_.buf, view_.len);
+        return true;
+      }
+      const auto n = size();
+      std::vector<Py_ssize_t> index(view_.ndim, 0);
+      for (Py_ssize_t k = 0; k < n; ++k)
+      {
+        auto ptr = static_cast<const char*>(view_.buf);
+        for (int d = 0; d < view_.ndim; ++d)
+          ptr += index[d] * view_.strides[d];
+        In value;
+        std::memcpy(&value, ptr, sizeof(In));
+        out[k] = static_cast<Out>(value);
+        for (int d = view_.ndim - 1; d >= 0; --d)
+        {
+          if (++index[d] < view_.shape[d])
+            break;
+          index[d] = 0;
+        }
+      }
+      return true;
+    }
+
+    Py_buffer view_;
+    bool valid_;
+  };
+
+  const char* formatOf(VField* vfield)
+  {
+    if (vfield->is_double() || vfield->is_vector()) return "d";
+    if (vfield->is_float()) return "f";
+    if (vfield->is_int()) return "i";
+    if (vfield->is_unsigned_int()) return "I";
+    if (vfield->is_short()) return "h";
+    if (vfield->is_unsigned_short()) return "H";
+    if (vfield->is_char()) return "b";
+    if (vfield->is_unsigned_char()) return "B";
+    if (vfield->is_longlong()) return "q";
+    if (vfield->is_unsigned_longlong()) return "Q";
+    return nullptr;
+  }
+
+  size_t formatSize(char code)
+  {
+    switch (code)
+    {
+    case 'b': case 'B': return 1;
+    case 'h': case 'H': return 2;
+    case 'i': case 'I': case 'f': return 4;
+    default: return 8;
+    }
+  }
+}
+
+py::object SCIRun::Core::Python::makeBufferView(DatatypeHandle owner, const void* data,
+  const char* format, size_t itemSize, const std::vector<Py_ssize_t>& shape)
+{
+  auto storage = new BufferStorage { owner, data, format, static_cast<Py_ssize_t>(itemSize), shape, std::vector<Py_ssize_t>(shape.size()) };
+  if (!data && !shape.empty())
+    storage->shape[0] = 0;
+  Py_ssize_t stride = storage->itemSize;
+  for (int d = static_cast<int>(shape.size()) - 1; d >= 0; --d)
+  {
+    storage->strides[d] = stride;
+    stride *= shape[d];
+  }
+
+  auto exporter = PyObject_New(BufferExporter, exporterType());
+  if (!exporter)
+  {
+    delete storage;
+    py::throw_error_already_set();
+  }
+  exporter->storage = storage;
+  py::object holder(py::handle<>(reinterpret_cast<PyObject*>(exporter)));
+  return py::object(py::handle<>(PyMemoryView_FromObject(holder.ptr())));
+}
+
+py::object SCIRun::Core::Python::convertMatrixToPythonBuffer(DenseMatrixHandle matrix)
+{
+  if (!matrix)
+    return {};
+  return makeBufferView(matrix, matrix->data(), "d", sizeof(double), { static_cast<Py_ssize_t>(matrix->nrows()), static_cast<Py_ssize_t>(matrix->ncols()) });
+}
+
+py::dict SCIRun::Core::Python::convertMatrixToPythonBuffer(SparseRowMatrixHandle matrix)
+{
+  if (!matrix)
+    return {};
+  if (!matrix->isCompressed())
+    return convertMatrixToPython(matrix);
+
+  const auto nnz = static_cast<Py_ssize_t>(matrix->nonZeros());
+  py::dict dict;
+  dict["nrows"] = matrix->nrows();
+  dict["ncols"] = matrix->ncols();
+  dict["rows"] = makeBufferView(matrix, matrix->outerIndexPtr(), "q", sizeof(index_type), { static_cast<Py_ssize_t>(matrix->outerSize()) + 1 });
+  dict["columns"] = makeBufferView(matrix, matrix->innerIndexPtr(), "q", sizeof(index_type), { nnz });
+  dict["values"] = makeBufferView(matrix, matrix->valuePtr(), "d", sizeof(double), { nnz });
+  return dict;
+}
+
+py::dict SCIRun::Core::Python::convertFieldToPythonBuffer(FieldHandle field)
+{
+  py::dict dict;
+  if (!field)
+    return dict;
+
+  // Regular and structured meshes do not store their nodes and elements explicitly;
+  // use convertFieldToPython for those.
+  auto vmesh = field->vmesh();
+  auto vfield = field->vfield();
+  if (!vmesh->is_unstructuredmesh())
+    return dict;
+
+  dict["node"] = makeBufferView(field, vmesh->get_points_pointer(), "d", sizeof(double),
+    { static_cast<Py_ssize_t>(vmesh->num_nodes()), 3 });
+  // Point clouds have no element storage.
+  if (auto elems = vmesh->get_elems_pointer())
+    dict["element"] = makeBufferView(field, elems, "q", sizeof(VMesh::index_type),
+      { static_cast<Py_ssize_t>(vmesh->num_elems()), static_cast<Py_ssize_t>(vmesh->num_nodes_per_elem()) });
+
+  auto format = formatOf(vfield);
+  if (!vfield->is_nodata() && format && (vfield->is_scalar() || vfield->is_vector()))
+  {
+    std::vector<Py_ssize_t> shape { static_cast<Py_ssize_t>(vfield->num_values()) };
+    size_t itemSize = formatSize(format[0]);
+    if (vfield->is_vector())
+      shape.push_back(3);
+    dict["field"] = makeBufferView(field, vfield->fdata_pointer(), format, itemSize, shape);
+  }
+  return dict;
+}
+
+bool SCIRun::Core::Python::hasNumericBuffer(const py::object& object, int ndim)
+{
+  ScopedBuffer buffer(object, PyBUF_RECORDS_RO);
+  return buffer.valid() && buffer.typeCode() != 0 && (ndim < 0 || buffer.view().ndim == ndim);
+}
+
+DatatypeHandle SCIRun::Core::Python::bufferViewOwner(const py::object& object)
+{
+  auto storage = findExporter(object);
+  if (!storage)
+    return nullptr;
+
+  ScopedBuffer buffer(object, PyBUF_RECORDS_RO);
+  if (!buffer.valid() || buffer.view().buf != storage->data || buffer.view().ndim != static_cast<int>(storage->shape.size()))
+    return nullptr;
+  for (int d = 0; d < buffer.view().ndim; ++d)
+  {
+    if (buffer.view().shape[d] != storage->shape[d] || buffer.view().strides[d] != storage->strides[d])
+      return nullptr;
+  }
+  return buffer.typeCode() == storage->format[0] ? storage->owner : nullptr;
+}
+
+DenseMatrixHandle SCIRun::Core::Python::denseMatrixFromBuffer(const py::object& object)
+{
+  if (auto owner = boost::dynamic_pointer_cast<DenseMatrix>(bufferViewOwner(object)))
+    return owner;
+
+  ScopedBuffer buffer(object, PyBUF_RECORDS_RO);
+  if (!buffer.valid() || buffer.view().ndim < 1 || buffer.view().ndim > 2)
+    return nullptr;
+
+  const auto rows = buffer.view().shape[0];
+  const auto cols = 2 == buffer.view().ndim ? buffer.view().shape[1] : 1;
+  auto dense = boost::make_shared<DenseMatrix>(rows, cols);
+  if (!buffer.copyTo(dense->data()))
+    return nullptr;
+  return dense;
+}
+
+std::vector<double> SCIRun::Core::Python::doubleVectorFromBuffer(const py::object& object, std::vector<Py_ssize_t>* shape)
+{
+  ScopedBuffer buffer(object, PyBUF_RECORDS_RO);
+  if (!buffer.valid())
+    return {};
+  std::vector<double> values(buffer.size());
+  if (!values.empty() && !buffer.copyTo(&values[0]))
+    return {};
+  if (shape)
+    shape->assign(buffer.view().shape, buffer.view().shape + buffer.view().ndim);
+  return values;
+}
+
+std::vector<index_type> SCIRun::Core::Python::indexVectorFromBuffer(const py::object& object)
+{
+  ScopedBuffer buffer(object, PyBUF_RECORDS_RO);
+  if (!buffer.valid())
+    return {};
+  std::vector<index_type> values(buffer.size());
+  if (!values.empty() && !buffer.copyTo(&values[0]))
+    return {};
+  return values;
+}
+
+#endif
@@ -0,0 +1,74 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifdef BUILD_WITH_PYTHON
+#ifndef CORE_PYTHON_PYTHONBUFFEREXCHANGE_H
+#define CORE_PYTHON_PYTHONBUFFEREXCHANGE_H
+
+#include <Core/Datatypes/DatatypeFwd.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <boost/python.hpp>
+#include <vector>
+#include <Core/Python/share.h>
+
+namespace SCIRun
+{
+  namespace Core
+  {
+    namespace Python
+    {
+      /// Zero-copy exchange of datatype storage with Python through the buffer protocol.
+      /// Exported views are read-only memoryviews over the Eigen/field arrays that keep the
+      /// owning datatype alive; numpy.asarray(view) wraps them without copying.
+
+      SCISHARE boost::python::object makeBufferView(Datatypes::DatatypeHandle owner, const void* data,
+        const char* format, size_t itemSize, const std::vector<Py_ssize_t>& shape);
+
+      SCISHARE boost::python::object convertMatrixToPythonBuffer(Datatypes::DenseMatrixHandle matrix);
+      SCISHARE boost::python::dict convertMatrixToPythonBuffer(Datatypes::SparseRowMatrixHandle matrix);
+      SCISHARE boost::python::dict convertFieldToPythonBuffer(FieldHandle field);
+
+      /// True if the object exports a numeric buffer (numpy array, memoryview, array.array, ...).
+      SCISHARE bool hasNumericBuffer(const boost::python::object& object, int ndim = -1);
+
+      /// Returns the datatype that owns the buffer if the object is an unmodified, whole view
+      /// previously created by makeBufferView, so round trips do not copy at all.
+      SCISHARE Datatypes::DatatypeHandle bufferViewOwner(const boost::python::object& object);
+
+      /// Fills a dense matrix from a 1-D or 2-D numeric buffer with a single pass over the data
+      /// (a block copy when the buffer is C-contiguous double).
+      SCISHARE Datatypes::DenseMatrixHandle denseMatrixFromBuffer(const boost::python::object& object);
+
+      SCISHARE std::vector<double> doubleVectorFromBuffer(const boost::python::object& object, std::vector<Py_ssize_t>* shape = nullptr);
+      SCISHARE std::vector<index_type> indexVectorFromBuffer(const boost::python::object& object);
+    }
+  }
+}
+
+#endif
+#endif
@@ -41,6 +41,7 @@
 #include <Core/Matlab/matlabarray.h>
 #include <Core/Matlab/matlabconverter.h>
 #include <Core/Python/PythonDatatypeConverter.h>
+#include <Core/Python/PythonBufferExchange.h>
 #include <boost/variant/apply_visitor.hpp>
 
 using namespace SCIRun;
@@ -322,6 +323,9 @@ py::object SCIRun::Core::Python::convertStringToPython(StringHandle str)
 
 bool DenseMatrixExtractor::check() const
 {
+  if (hasNumericBuffer(object_, 2))
+    return true;
+
   py::extract<py::list> e(object_);
   if (!e.check()) return false;
 
@@ -337,6 +341,13 @@ bool DenseMatrixExtractor::check() const
 
 DatatypeHandle DenseMatrixExtractor::operator()() const
 {
+  if (hasNumericBuffer(object_))
+  {
+    if (!hasNumericBuffer(object_, 1) && !hasNumericBuffer(object_, 2))
+      throw std::invalid_argument("Attempted to convert into dense matrix but the array is not one or two dimensional.");
+    return denseMatrixFromBuffer(object_);
+  }
+
   DenseMatrixHandle dense;
   py::extract<py::list> e(object_);
   if (e.check())
@@ -404,7 +415,7 @@ bool SparseRowMatrixExtractor::check() const
 
     py::extract<py::list> value_i_list(values[i]);
     py::extract<size_t> value_i_int(values[i]);
-    if (!value_i_int.check() && !value_i_list.check()) return false;
+    if (!value_i_int.check() && !value_i_list.check() && !hasNumericBuffer(values[i], 1)) return false;
   }
 
   return true;
@@ -425,16 +436,31 @@ DatatypeHandle SparseRowMatrixExtractor::operator()() const
   auto values = pyMatlabDict.values();
   size_t nrows, ncols;
 
+  {
+    // unmodified views handed out by convertMatrixToPythonBuffer go straight back
+    auto rowsOwner = bufferViewOwner(pyMatlabDict.get("rows"));
+    if (rowsOwner && rowsOwner == bufferViewOwner(pyMatlabDict.get("columns"))
+      && rowsOwner == bufferViewOwner(pyMatlabDict.get("values")))
+    {
+      if (auto owner = boost::dynamic_pointer_cast<SparseRowMatrix>(rowsOwner))
+        return owner;
+    }
+  }
+
   for (int i = 0; i < length; ++i)
   {
     py::extract<std::string> key_i(keys[i]);
 
     py::extract<py::list> value_i_list(values[i]);
+    const bool isBuffer = hasNumericBuffer(values[i], 1);
     auto fieldName = key_i();
-    if (fieldName == "rows") { rows = to_std_vector<index_type>(value_i_list()); }
+    if (fieldName == "rows")
+    {
+      rows = isBuffer ? indexVectorFromBuffer(values[i]) : to_std_vector<index_type>(value_i_list());
+    }
     else if (fieldName == "columns")
     {
-      columns = to_std_vector<index_type>(value_i_list());
+      columns = isBuffer ? indexVectorFromBuffer(values[i]) : to_std_vector<index_type>(value_i_list());
     }
     else if (fieldName == "nrows")
     {
@@ -448,7 +474,7 @@ DatatypeHandle SparseRowMatrixExtractor::operator()() const
     }
     else if (fieldName == "values")
     {
-      matrixValues = to_std_vector<double>(value_i_list());
+      matrixValues = isBuffer ? doubleVectorFromBuffer(values[i]) : to_std_vector<double>(value_i_list());
     }
   }
 
@@ -481,18 +507,30 @@ bool FieldExtractor::check() const
 
     py::extract<std::string> value_i_string(values[i]);
     py::extract<py::list> value_i_list(values[i]);
-    if (!value_i_string.check() && !value_i_list.check()) return false;
+    if (!value_i_string.check() && !value_i_list.check() && !hasNumericBuffer(values[i])) return false;
   }
 
   return true;
 }
 
 namespace {
-matlabarray getPythonFieldDictionaryValue(
+matlabarray getPythonFieldDictionaryValue(const py::object& object,
     const py::extract<std::string>& strExtract, const py::extract<py::list>& listExtract)
 {
   matlabarray value;
-  if (strExtract.check())
+  std::vector<Py_ssize_t> shape;
+  auto bufferValues = doubleVectorFromBuffer(object, &shape);
+  if (!bufferValues.empty())
+  {
+    // same layout as the list-of-lists branch below: C-order rows become Matlab columns
+    if (1 == bufferValues.size())
+      value.createdoublescalar(bufferValues[0]);
+    else if (2 == shape.size())
+      value.createdoublematrix(static_cast<int>(shape[1]), static_cast<int>(shape[0]), &bufferValues[0]);
+    else
+      value.createdoublevector(bufferValues);
+  }
+  else if (strExtract.check())
   {
     value.createstringarray();
     auto strData = strExtract();
@@ -558,7 +596,7 @@ DatatypeHandle FieldExtractor::operator()() const
     py::extract<py::list> value_i_list(values[i]);
     auto fieldName = key_i();
     // std::cout << "setting field " << fieldName << std::endl;
-    ma.setfield(0, fieldName, getPythonFieldDictionaryValue(value_i_string, value_i_list));
+    ma.setfield(0, fieldName, getPythonFieldDictionaryValue(values[i], value_i_string, value_i_list));
   }
 
   FieldHandle field;
@@ -601,6 +639,11 @@ Variable SCIRun::Core::Python::convertPythonObjectToVariable(const py::object& o
     if (e.check())
       return makeVariable("bool", e());
   }
+  {
+    DenseMatrixExtractor e(object);
+    if (hasNumericBuffer(object, 2) && e.check())
+      return makeDatatypeVariable(e);
+  }
   {
     py::extract<py::list> e(object);
     if (e.check())
@@ -32,9 +32,13 @@
 #include <gtest/gtest.h>
 #include <Testing/ModuleTestBase/ModuleTestBase.h>
 #include <Core/Python/PythonDatatypeConverter.h>
+#include <Core/Python/PythonBufferExchange.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Matlab/matlabconverter.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 #include <Testing/Utils/SCIRunUnitTests.h>
 #include <Testing/Utils/SCIRunFieldSamples.h>
@@ -47,6 +51,7 @@
 using namespace SCIRun;
 using namespace SCIRun::Core;
 using namespace Core::Python;
+using namespace Core::Datatypes;
 using namespace Testing;
 using namespace TestUtils;
 
@@ -430,3 +435,127 @@ TEST_F(FieldConversionTests, RejectsIncompatibleDictionary)
 
   ASSERT_FALSE(converter.check());
 }
+
+class BufferConversionTests : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+  #ifdef WIN32
+  #ifndef DEBUG
+    PythonInterpreter::Instance().initialize(false, "Core_Python_Tests", boost::filesystem::current_path().string());
+    PythonInterpreter::Instance().importSCIRunLibrary();
+  #endif
+  #else
+    Py_Initialize();
+  #endif
+  }
+};
+
+TEST_F(BufferConversionTests, DenseMatrixViewSharesStorage)
+{
+  auto m = boost::make_shared<DenseMatrix>(3, 4);
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 4; ++j)
+      (*m)(i, j) = 10 * i + j;
+
+  auto view = convertMatrixToPythonBuffer(m);
+  EXPECT_EQ(2, boost::python::extract<int>(view.attr("ndim"))());
+  EXPECT_TRUE(boost::python::extract<bool>(view.attr("readonly"))());
+  EXPECT_EQ(12.0, boost::python::extract<double>(view[boost::python::make_tuple(1, 2)])());
+
+  (*m)(1, 2) = -1;
+  EXPECT_EQ(-1.0, boost::python::extract<double>(view[boost::python::make_tuple(1, 2)])());
+
+  DenseMatrixExtractor converter(view);
+  ASSERT_TRUE(converter.check());
+  auto roundTrip = boost::dynamic_pointer_cast<DenseMatrix>(converter());
+  EXPECT_EQ(m, roundTrip);
+}
+
+TEST_F(BufferConversionTests, DenseMatrixFromForeignBuffer)
+{
+  boost::python::dict ns;
+  boost::python::exec("import array\n"
+    "m = memoryview(array.array('d', [1, 2, 3, 4, 5, 6])).cast('B').cast('d', [2, 3])\n"
+    "t = memoryview(array.array('i', [1, 2, 3, 4, 5, 6])).cast('B').cast('i', [3, 2])\n", ns);
+
+  DenseMatrixExtractor converter(ns["m"]);
+  ASSERT_TRUE(converter.check());
+  auto dense = boost::dynamic_pointer_cast<DenseMatrix>(converter());
+  ASSERT_TRUE(dense != nullptr);
+  DenseMatrix expected(2, 3);
+  expected << 1, 2, 3, 4, 5, 6;
+  EXPECT_EQ(expected, *dense);
+
+  auto fromInts = denseMatrixFromBuffer(ns["t"]);
+  ASSERT_TRUE(fromInts != nullptr);
+  EXPECT_EQ(3, fromInts->nrows());
+  EXPECT_EQ(2, fromInts->ncols());
+  EXPECT_EQ(4.0, (*fromInts)(1, 1));
+}
+
+TEST_F(BufferConversionTests, SparseMatrixViewsRoundTrip)
+{
+  DenseMatrix dense(3, 3);
+  dense << 1, 0, 2,
+           0, 3, 0,
+           4, 0, 5;
+  auto sparse = toSparseHandle(dense);
+
+  auto dict = convertMatrixToPythonBuffer(sparse);
+  SparseRowMatrixExtractor converter(dict);
+  ASSERT_TRUE(converter.check());
+  EXPECT_EQ(sparse, boost::dynamic_pointer_cast<SparseRowMatrix>(converter()));
+
+  boost::python::dict ns;
+  ns["d"] = dict;
+  boost::python::exec("import array\n"
+    "d['values'] = array.array('d', d['values'].tolist())\n", ns);
+  auto copied = boost::dynamic_pointer_cast<SparseRowMatrix>(SparseRowMatrixExtractor(dict)());
+  ASSERT_TRUE(copied != nullptr);
+  EXPECT_NE(sparse, copied);
+  EXPECT_TRUE(compare_with_tolerance_readable(*sparse, *copied, 1e-15));
+}
+
+TEST_F(BufferConversionTests, UnstructuredFieldViews)
+{
+  auto field = loadFieldFromFile(TestResources::rootDir() / "Fields/tet_mesh/data_defined_on_node/scalar/tet_scalar_on_node.fld");
+  auto buffers = convertFieldToPythonBuffer(field);
+
+  auto shapeOf = [&buffers](const char* key)
+  {
+    return to_std_vector<int>(boost::python::object(buffers[key].attr("shape")));
+  };
+  EXPECT_EQ(std::vector<int>({ static_cast<int>(field->vmesh()->num_nodes()), 3 }), shapeOf("node"));
+  EXPECT_EQ(std::vector<int>({ static_cast<int>(field->vmesh()->num_elems()), 4 }), shapeOf("element"));
+  EXPECT_EQ(std::vector<int>({ static_cast<int>(field->vfield()->num_values()) }), shapeOf("field"));
+
+  EXPECT_EQ(0, len(convertFieldToPythonBuffer(CreateEmptyLatVol())));
+}
+
+TEST_F(BufferConversionTests, MissingStorageExportsEmptyView)
+{
+  FieldInformation fi("PointCloudMesh", 0, "double");
+  auto cloud = CreateField(fi);
+  cloud->vmesh()->add_point(Geometry::Point(1, 2, 3));
+  cloud->vmesh()->add_point(Geometry::Point(4, 5, 6));
+  auto buffers = convertFieldToPythonBuffer(cloud);
+  EXPECT_TRUE(buffers.has_key("node"));
+  EXPECT_FALSE(buffers.has_key("element"));
+
+  auto view = makeBufferView(cloud, nullptr, "q", sizeof(index_type), { 2, 1 });
+  EXPECT_EQ(0, boost::python::extract<int>(view.attr("nbytes"))());
+  EXPECT_EQ(std::vector<int>({ 0, 1 }), to_std_vector<int>(boost::python::object(view.attr("shape"))));
+}
+
+TEST_F(BufferConversionTests, DenseMatrixRejectsHigherDimensionalBuffers)
+{
+  boost::python::dict ns;
+  boost::python::exec("import array\n"
+    "c = memoryview(array.array('d', [1, 2, 3, 4, 5, 6, 7, 8])).cast('B').cast('d', [2, 2, 2])\n", ns);
+
+  DenseMatrixExtractor converter(ns["c"]);
+  EXPECT_FALSE(converter.check());
+  EXPECT_THROW(converter(), std::invalid_argument);
+}
@@ -30,6 +30,12 @@
 #include <Core/Logging/Log.h>
 #include <vector>
 #include <iostream>
+#include <algorithm>
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
 
 using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Logging;
@@ -54,6 +60,38 @@ void Parallel::RunTasks(IndexedTask task, int numProcs)
   //}
 }
 
+void Parallel::RunRange(std::size_t count, int numTasks, RangeTask task)
+{
+  if (numTasks <= 1)
+  {
+    task(0, 0, count);
+    return;
+  }
+
+  ThreadGroup threads;
+  for (int i = 0; i < numTasks; ++i)
+    threads.create_thread(task, i, RangeBegin(count, i, numTasks), RangeBegin(count, i + 1, numTasks));
+  threads.join_all();
+}
+
+int Parallel::NumTasks(std::size_t count, std::size_t minItemsPerTask)
+{
+  if (forcedTaskCount_ > 0)
+    return forcedTaskCount_;
+  const std::size_t byWork = count / std::max<std::size_t>(1, minItemsPerTask);
+  return static_cast<int>(std::max<std::size_t>(1, std::min<std::size_t>(NumCores(), byWork)));
+}
+
+void Parallel::ForceTaskCount(int tasks)
+{
+  forcedTaskCount_ = tasks;
+}
+
+std::size_t Parallel::RangeBegin(std::size_t count, int task, int numTasks)
+{
+  return count * task / numTasks;
+}
+
 unsigned int Parallel::NumCores()
 {
   return capByUserCoreCount(std::thread::hardware_concurrency());
@@ -73,12 +111,27 @@ void Parallel::SetMaximumCores(unsigned int max)
   maximumCoresSetByUser_ = max;
 }
 
+std::size_t Parallel::DataCacheSize(int level)
+{
+  const std::size_t fallback = level <= 1 ? 32 * 1024 : 256 * 1024;
+  long size = 0;
+#if defined(__APPLE__)
+  std::size_t len = sizeof(size);
+  if (0 != sysctlbyname(level <= 1 ? "hw.l1dcachesize" : "hw.l2cachesize", &size, &len, nullptr, 0))
+    size = 0;
+#elif defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+  size = sysconf(level <= 1 ? _SC_LEVEL1_DCACHE_SIZE : _SC_LEVEL2_CACHE_SIZE);
+#endif
+  return size > 0 ? static_cast<std::size_t>(size) : fallback;
+}
+
 unsigned int Parallel::capByUserCoreCount(unsigned int numProcs)
 {
   return std::min(numProcs, maximumCoresSetByUser_);
 }
 
 unsigned int Parallel::maximumCoresSetByUser_(std::numeric_limits<unsigned int>::max());
+int Parallel::forcedTaskCount_(0);
 
  void ThreadGroup::join_all()
  {
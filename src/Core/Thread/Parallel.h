@@ -46,10 +46,31 @@ namespace Thread
   public:
     typedef std::function<void(int)> IndexedTask;
     static void RunTasks(IndexedTask task, int numProcs);
+
+    /// Runs task(index, begin, end) on numTasks contiguous ranges that split [0, count).
+    /// The ranges only depend on count and numTasks, so passes of an algorithm that use
+    /// the same split see the same ranges and can merge per-task results in task order.
+    /// A single task runs on the calling thread. Unlike RunTasks, every range runs even
+    /// if numTasks is larger than NumCores().
+    typedef std::function<void(int, std::size_t, std::size_t)> RangeTask;
+    static void RunRange(std::size_t count, int numTasks, RangeTask task);
+    /// Number of ranges for count items: at most NumCores(), at least one, and with at
+    /// least minItemsPerTask items in each range when there is more than one.
+    static int NumTasks(std::size_t count, std::size_t minItemsPerTask = 4096);
+    /// Makes NumTasks return tasks whatever the count and core limit, so tests can run
+    /// the multi-task paths of an algorithm on any machine. Zero restores the default.
+    static void ForceTaskCount(int tasks);
+    /// First item of range task in RunRange.
+    static std::size_t RangeBegin(std::size_t count, int task, int numTasks);
+
     static unsigned int NumCores();
     static void SetMaximumCores(unsigned int max);
+    /// Size in bytes of the per-core data cache at the given level (1 or 2); a conservative
+    /// default is returned when the platform does not report it.
+    static std::size_t DataCacheSize(int level);
   private:
     static unsigned int maximumCoresSetByUser_;
+    static int forcedTaskCount_;
     static unsigned int capByUserCoreCount(unsigned int numProcs);
   };
 
@@ -52,6 +52,48 @@ TEST(ParallelTests, CanDoubleNumberInParallel)
   EXPECT_EQ(expectedSum * 2, std::accumulate(nums.begin(), nums.end(), 0, std::plus<int>()));
 }
 
+TEST(ParallelTests, RunRangeCoversEveryItemOnce)
+{
+  const size_t count = 1001;
+  for (int tasks : { 1, 3, 64 })
+  {
+    std::vector<int> hits(count, 0);
+    std::vector<size_t> begins(tasks), ends(tasks);
+    Parallel::RunRange(count, tasks, [&](int task, size_t begin, size_t end)
+    {
+      begins[task] = begin;
+      ends[task] = end;
+      for (size_t i = begin; i < end; ++i)
+        ++hits[i];
+    });
+
+    EXPECT_EQ(std::vector<int>(count, 1), hits);
+    for (int task = 0; task < tasks; ++task)
+    {
+      EXPECT_EQ(Parallel::RangeBegin(count, task, tasks), begins[task]);
+      EXPECT_EQ(Parallel::RangeBegin(count, task + 1, tasks), ends[task]);
+    }
+  }
+}
+
+TEST(ParallelTests, NumTasksIsBoundedByWorkAndCores)
+{
+  const int cores = static_cast<int>(Parallel::NumCores());
+  EXPECT_EQ(1, Parallel::NumTasks(0, 16));
+  EXPECT_EQ(1, Parallel::NumTasks(31, 16));
+  EXPECT_EQ(std::min(2, cores), Parallel::NumTasks(32, 16));
+  EXPECT_EQ(cores, Parallel::NumTasks(size_t(1) << 30, 16));
+}
+
+TEST(ParallelTests, ForcedTaskCountIgnoresWorkAndCores)
+{
+  Parallel::ForceTaskCount(7);
+  EXPECT_EQ(7, Parallel::NumTasks(0, 16));
+  EXPECT_EQ(7, Parallel::NumTasks(size_t(1) << 30, 16));
+  Parallel::ForceTaskCount(0);
+  EXPECT_EQ(1, Parallel::NumTasks(31, 16));
+}
+
 /// @todo
 #if 0
 TEST(ParallelTests, CanDoubleNumberWithParallelForEach)
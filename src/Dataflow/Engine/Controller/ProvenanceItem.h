@@ -47,6 +47,8 @@ namespace Engine {
     virtual ~ProvenanceItem() {}
     virtual Memento memento() const = 0;
     virtual std::string name() const = 0;
+    // Called once the manager has stored the memento; items may drop their copy.
+    virtual void releaseMemento() {}
   };
 
 }
@@ -45,6 +45,11 @@ NetworkFileHandle ProvenanceItemBase::memento() const
   return state_;
 }
 
+void ProvenanceItemBase::releaseMemento()
+{
+  state_.reset();
+}
+
 ModuleAddedProvenanceItem::ModuleAddedProvenanceItem(const std::string& moduleName, NetworkFileHandle state)
   : ProvenanceItemBase(state), moduleName_(moduleName)
 {
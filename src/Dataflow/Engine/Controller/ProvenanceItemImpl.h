@@ -45,6 +45,7 @@ namespace Engine {
   public:
     explicit ProvenanceItemBase(Networks::NetworkFileHandle state);
     Networks::NetworkFileHandle memento() const override;
+    void releaseMemento() override;
   protected:
     Networks::NetworkFileHandle state_;
   };
@@ -29,8 +29,24 @@
 /// @todo Documentation Dataflow/Engine/Controller/ProvenanceManager.cc
 
 #include <Dataflow/Engine/Controller/ProvenanceManager.h>
-#include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
+#include <Dataflow/Serialization/Network/NetworkFileDelta.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Dataflow::Engine;
 using namespace SCIRun::Dataflow::Networks;
+
+ProvenanceMementoStorage<NetworkFileHandle>::Delta ProvenanceMementoStorage<NetworkFileHandle>::diff(const NetworkFileHandle& from, const NetworkFileHandle& to)
+{
+  return boost::make_shared<NetworkFileDelta>(diffNetworkFiles(*from, *to));
+}
+
+NetworkFileHandle ProvenanceMementoStorage<NetworkFileHandle>::clone(const NetworkFileHandle& memento)
+{
+  return memento ? boost::make_shared<NetworkFile>(*memento) : memento;
+}
+
+void ProvenanceMementoStorage<NetworkFileHandle>::apply(NetworkFileHandle& memento, const Delta& delta)
+{
+  if (memento && delta)
+    applyNetworkFileDelta(*memento, *delta);
+}
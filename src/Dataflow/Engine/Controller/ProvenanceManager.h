@@ -31,7 +31,9 @@
 #ifndef ENGINE_NETWORK_PROVENANCEMANAGER_H
 #define ENGINE_NETWORK_PROVENANCEMANAGER_H
 
+#include <algorithm>
 #include <stack>
+#include <vector>
 #include <boost/noncopyable.hpp>
 #include <Dataflow/Engine/Controller/ProvenanceItem.h>
 #include <Dataflow/Engine/Controller/NetworkEditorController.h>
@@ -41,6 +43,31 @@ namespace SCIRun {
 namespace Dataflow {
 namespace Engine {
 
+  // Controls how ProvenanceManager stores history. By default every memento
+  // is kept whole. Specializations store the difference to the previous
+  // memento, with a full checkpoint every few items to bound replay cost.
+  template <class Memento>
+  struct ProvenanceMementoStorage
+  {
+    using Delta = Memento;
+    static const bool storesDeltas = false;
+    static bool canDiff(const Memento&, const Memento&) { return false; }
+    static Delta diff(const Memento&, const Memento& to) { return to; }
+    static Memento clone(const Memento& memento) { return memento; }
+    static void apply(Memento& memento, const Delta& delta) { memento = delta; }
+  };
+
+  template <>
+  struct SCISHARE ProvenanceMementoStorage<Networks::NetworkFileHandle>
+  {
+    using Delta = boost::shared_ptr<Networks::NetworkFileDelta>;
+    static const bool storesDeltas = true;
+    static bool canDiff(const Networks::NetworkFileHandle& from, const Networks::NetworkFileHandle& to) { return from && to; }
+    static Delta diff(const Networks::NetworkFileHandle& from, const Networks::NetworkFileHandle& to);
+    static Networks::NetworkFileHandle clone(const Networks::NetworkFileHandle& memento);
+    static void apply(Networks::NetworkFileHandle& memento, const Delta& delta);
+  };
+
   template <class Memento>
   class ProvenanceManager : boost::noncopyable
   {
@@ -50,8 +77,9 @@ namespace Engine {
     using Stack = std::stack<ItemHandle>;
     using List = typename Stack::container_type;
     using IOType = Engine::NetworkIOInterface<Memento>;
+    using Storage = ProvenanceMementoStorage<Memento>;
 
-    explicit ProvenanceManager(IOType* networkIO);
+    explicit ProvenanceManager(IOType* networkIO, size_t checkpointInterval = 32);
     void setInitialState(const Memento& initialState);
     void addItem(ItemHandle item);
     ItemHandle undo();
@@ -67,18 +95,36 @@ namespace Engine {
 
     const IOType* networkIO() const;
 
+    // Network state after the given item was applied, rebuilt from history.
+    boost::optional<Memento> memento(ItemHandle item) const;
+    size_t checkpointCount() const;
+
   private:
+    struct HistoryEntry
+    {
+      ItemHandle item;
+      boost::optional<Memento> checkpoint;
+      typename Storage::Delta delta;
+    };
+
     ItemHandle undo(bool restore);
     ItemHandle redo(bool restore);
+    Memento stateAt(size_t index) const;
+    void restoreState(size_t appliedItems);
     IOType* networkIO_;
     Stack undo_, redo_;
     boost::optional<Memento> initialState_;
+    // undo_ bottom to top followed by redo_ top to bottom
+    std::vector<HistoryEntry> history_;
+    size_t checkpointInterval_;
+    mutable boost::optional<std::pair<size_t, Memento>> lastState_;
   };
 
 
 
   template <class Memento>
-  ProvenanceManager<Memento>::ProvenanceManager(IOType* networkIO) : networkIO_(networkIO) {}
+  ProvenanceManager<Memento>::ProvenanceManager(IOType* networkIO, size_t checkpointInterval) :
+    networkIO_(networkIO), checkpointInterval_(std::max<size_t>(checkpointInterval, 1)) {}
 
   template <class Memento>
   void ProvenanceManager<Memento>::setInitialState(const Memento& initialState)
@@ -101,6 +147,28 @@ namespace Engine {
   template <class Memento>
   void ProvenanceManager<Memento>::addItem(typename ProvenanceManager<Memento>::ItemHandle item)
   {
+    const auto index = undo_.size();
+    history_.resize(index);
+    if (lastState_ && lastState_->first >= index)
+      lastState_.reset();
+
+    HistoryEntry entry;
+    entry.item = item;
+    auto state = item->memento();
+    if (!Storage::storesDeltas || index % checkpointInterval_ == 0)
+      entry.checkpoint = state;
+    else
+    {
+      auto previous = stateAt(index - 1);
+      if (Storage::canDiff(previous, state))
+        entry.delta = Storage::diff(previous, state);
+      else
+        entry.checkpoint = state;
+    }
+    history_.push_back(entry);
+    lastState_ = std::make_pair(index, state);
+    item->releaseMemento();
+
     undo_.push(item);
     Stack().swap(redo_);
   }
@@ -110,6 +178,53 @@ namespace Engine {
   {
     Stack().swap(undo_);
     Stack().swap(redo_);
+    history_.clear();
+    lastState_.reset();
+  }
+
+  template <class Memento>
+  Memento ProvenanceManager<Memento>::stateAt(size_t index) const
+  {
+    if (lastState_ && lastState_->first == index)
+      return lastState_->second;
+
+    auto start = index;
+    while (!history_[start].checkpoint)
+      --start;
+
+    // replay onto a copy, checkpoints are shared with previously returned states
+    auto state = Storage::clone(history_[start].checkpoint.get());
+    for (auto i = start + 1; i <= index; ++i)
+      Storage::apply(state, history_[i].delta);
+    lastState_ = std::make_pair(index, state);
+    return state;
+  }
+
+  template <class Memento>
+  void ProvenanceManager<Memento>::restoreState(size_t appliedItems)
+  {
+    networkIO_->clear();
+    if (appliedItems > 0)
+      networkIO_->loadNetwork(stateAt(appliedItems - 1));
+    else if (initialState_)
+      networkIO_->loadNetwork(initialState_.get());
+  }
+
+  template <class Memento>
+  boost::optional<Memento> ProvenanceManager<Memento>::memento(ItemHandle item) const
+  {
+    for (auto i = history_.size(); i > 0; --i)
+    {
+      if (history_[i - 1].item == item)
+        return stateAt(i - 1);
+    }
+    return boost::none;
+  }
+
+  template <class Memento>
+  size_t ProvenanceManager<Memento>::checkpointCount() const
+  {
+    return std::count_if(history_.begin(), history_.end(), [](const HistoryEntry& e) { return static_cast<bool>(e.checkpoint); });
   }
 
   template <class Memento>
@@ -129,13 +244,7 @@ namespace Engine {
 
       //clear and load previous memento
       if (restore)
-      {
-        networkIO_->clear();
-        if (!undo_.empty())
-          networkIO_->loadNetwork(undo_.top()->memento());
-        else if (initialState_)
-          networkIO_->loadNetwork(initialState_.get());
-      }
+        restoreState(undo_.size());
 
       return undone;
     }
@@ -159,10 +268,7 @@ namespace Engine {
 
       //clear and load redone memento
       if (restore)
-      {
-        networkIO_->clear();
-        networkIO_->loadNetwork(redone->memento());
-      }
+        restoreState(undo_.size());
 
       return redone;
     }
@@ -175,9 +281,7 @@ namespace Engine {
     List undone;
     while (0 != undoSize())
       undone.push_back(undo(false));
-    networkIO_->clear();
-    if (initialState_)
-      networkIO_->loadNetwork(initialState_.get());
+    restoreState(0);
     return undone;
   }
 
@@ -187,8 +291,7 @@ namespace Engine {
     List redone;
     while (0 != redoSize())
       redone.push_back(redo(false));
-    networkIO_->clear();
-    networkIO_->loadNetwork(undo_.top()->memento());
+    restoreState(undo_.size());
     return redone;
   }
 
@@ -50,6 +50,7 @@
 #include <boost/range/adaptors.hpp>
 #include <boost/range/algorithm/copy.hpp>
 #include <Core/Python/PythonDatatypeConverter.h>
+#include <Core/Python/PythonBufferExchange.h>
 #include <Core/Python/PythonInterpreter.h>
 
 using namespace SCIRun;
@@ -83,6 +84,11 @@ namespace
       return str_;
     }
 
+    py::object buffer() const override
+    {
+      return str_;
+    }
+
   private:
     StringHandle underlying_;
     py::object str_;
@@ -91,7 +97,7 @@ namespace
   class PyDatatypeDenseMatrix : public PyDatatype
   {
   public:
-    explicit PyDatatypeDenseMatrix(DenseMatrixHandle underlying) : underlying_(underlying), pyMat_(convertMatrixToPython(underlying))
+    explicit PyDatatypeDenseMatrix(DenseMatrixHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -102,18 +108,25 @@ namespace
 
     py::object value() const override
     {
-      return pyMat_;
+      if (!pyMat_)
+        pyMat_ = convertMatrixToPython(underlying_);
+      return *pyMat_;
+    }
+
+    py::object buffer() const override
+    {
+      return convertMatrixToPythonBuffer(underlying_);
     }
 
   private:
     DenseMatrixHandle underlying_;
-    py::list pyMat_;
+    mutable boost::optional<py::list> pyMat_;
   };
 
   class PyDatatypeSparseRowMatrix : public PyDatatype
   {
   public:
-    explicit PyDatatypeSparseRowMatrix(SparseRowMatrixHandle underlying) : underlying_(underlying), pyMat_(convertMatrixToPython(underlying))
+    explicit PyDatatypeSparseRowMatrix(SparseRowMatrixHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -124,18 +137,25 @@ namespace
 
     py::object value() const override
     {
-      return pyMat_;
+      if (!pyMat_)
+        pyMat_ = convertMatrixToPython(underlying_);
+      return *pyMat_;
+    }
+
+    py::object buffer() const override
+    {
+      return convertMatrixToPythonBuffer(underlying_);
     }
 
   private:
     SparseRowMatrixHandle underlying_;
-    py::dict pyMat_;
+    mutable boost::optional<py::dict> pyMat_;
   };
 
   class PyDatatypeField : public PyDatatype
   {
   public:
-    explicit PyDatatypeField(FieldHandle underlying) : underlying_(underlying), matlabStructure_(convertFieldToPython(underlying))
+    explicit PyDatatypeField(FieldHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -146,12 +166,22 @@ namespace
 
     py::object value() const override
     {
-      return matlabStructure_;
+      if (!matlabStructure_)
+        matlabStructure_ = convertFieldToPython(underlying_);
+      return *matlabStructure_;
+    }
+
+    py::object buffer() const override
+    {
+      auto buffers = convertFieldToPythonBuffer(underlying_);
+      if (0 == len(buffers))
+        return value();
+      return buffers;
     }
 
   private:
     FieldHandle underlying_;
-    py::dict matlabStructure_;
+    mutable boost::optional<py::dict> matlabStructure_;
   };
 
   class PyDatatypeFactory
@@ -30,6 +30,9 @@
 #include <gmock/gmock.h>
 #include <Dataflow/Engine/Controller/ProvenanceItem.h>
 #include <Dataflow/Engine/Controller/ProvenanceManager.h>
+#include <Dataflow/Engine/Controller/ProvenanceItemImpl.h>
+#include <Dataflow/Serialization/Network/NetworkFileDelta.h>
+#include <Dataflow/Serialization/Network/BinarySerializer.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Dataflow::Engine;
@@ -39,6 +42,7 @@ using ::testing::Eq;
 using ::testing::NiceMock;
 using ::testing::DefaultValue;
 using ::testing::Return;
+using namespace SCIRun::Core::Algorithms;
 
 
 class MockNetworkIO : public NetworkIOInterface<std::string>
@@ -269,3 +273,204 @@ TEST_F(ProvenanceManagerTests, LoadFileSetsInitialState)
   EXPECT_CALL(*controller_, loadNetwork("initial")).Times(1);
   manager.undo();
 }
+
+namespace
+{
+  class NetworkFileIO : public NetworkIOInterface<NetworkFileHandle>
+  {
+  public:
+    NetworkFileHandle saveNetwork() const override { return current_; }
+    void loadNetwork(const NetworkFileHandle& file) override { current_ = file; }
+    void clear() override { current_.reset(); }
+  private:
+    NetworkFileHandle current_;
+  };
+
+  std::string binaryText(const NetworkFile& file)
+  {
+    std::ostringstream ostr;
+    BinarySerializer::save_binary(file, ostr);
+    return ostr.str();
+  }
+
+  std::string moduleName(int i)
+  {
+    return ModuleId("CreateLatVol", i).id_;
+  }
+
+  NetworkFileHandle makeLargeNetwork(int modules, int parametersPerModule)
+  {
+    auto file = boost::make_shared<NetworkFile>();
+    for (int i = 0; i < modules; ++i)
+    {
+      ModuleWithState mod(ModuleLookupInfoXML(ModuleLookupInfo("CreateLatVol", "NewField", "SCIRun")));
+      for (int p = 0; p < parametersPerModule; ++p)
+        mod.state.setValue(Name("Parameter" + std::to_string(p)), p * 0.5 + i);
+      file->network.modules[moduleName(i)] = mod;
+      file->modulePositions.modulePositions[moduleName(i)] = std::make_pair(10.0 * i, 20.0 * i);
+      if (i > 0)
+      {
+        file->network.connections.push_back(ConnectionDescriptionXML(ConnectionDescription(
+          OutgoingConnectionDescription(ModuleId(moduleName(i - 1)), PortId(0, "OutputField")),
+          IncomingConnectionDescription(ModuleId(moduleName(i)), PortId(0, "InputField")))));
+      }
+    }
+    return file;
+  }
+
+  // Each edit touches one module: move it, change a parameter, add or remove a connection.
+  ProvenanceItemHandle makeEdit(const NetworkFile& previous, int edit, int modules)
+  {
+    auto next = boost::make_shared<NetworkFile>(previous);
+    const int m = (edit * 7) % modules;
+    const auto id = moduleName(m);
+    switch (edit % 4)
+    {
+    case 0:
+      next->modulePositions.modulePositions[id] = std::make_pair(edit * 1.0, -edit * 1.0);
+      return boost::make_shared<ModuleMovedProvenanceItem>(ModuleId(id), edit * 1.0, -edit * 1.0, next);
+    case 1:
+      next->network.modules[id].state.setValue(Name("Parameter0"), edit * 3.0);
+      return boost::make_shared<ModuleAddedProvenanceItem>(id, next);
+    case 2:
+    {
+      ConnectionDescription cd(OutgoingConnectionDescription(ModuleId(id), PortId(1, "OutputMatrix")),
+        IncomingConnectionDescription(ModuleId(moduleName((m + 3) % modules)), PortId(1, "InputMatrix")));
+      next->network.connections.push_back(ConnectionDescriptionXML(cd));
+      return boost::make_shared<ConnectionAddedProvenanceItem>(cd, next);
+    }
+    default:
+    {
+      auto& connections = next->network.connections;
+      auto removed = connections[connections.size() / 2];
+      connections.erase(connections.begin() + connections.size() / 2);
+      return boost::make_shared<ConnectionRemovedProvenanceItem>(ConnectionId::create(removed), next);
+    }
+    }
+  }
+}
+
+TEST(NetworkFileDeltaTests, ApplyingDeltaReproducesNewerFile)
+{
+  auto from = makeLargeNetwork(20, 5);
+  auto to = boost::make_shared<NetworkFile>(*from);
+  to->network.modules.erase(moduleName(3));
+  to->network.modules[moduleName(4)].state.setValue(Name("Parameter2"), std::string("changed"));
+  to->network.modules[moduleName(50)] = ModuleWithState(ModuleLookupInfoXML(ModuleLookupInfo("ShowField", "Visualization", "SCIRun")));
+  to->network.connections.erase(to->network.connections.begin() + 2);
+  to->network.connections.insert(to->network.connections.begin() + 5, to->network.connections.back());
+  to->network.connections.pop_back();
+  to->modulePositions.modulePositions[moduleName(7)] = std::make_pair(-1.0, -2.0);
+  to->moduleNotes.notes[moduleName(8)] = NoteXML("<b>note</b>", 1, "note", 14);
+  to->moduleTags.tags[moduleName(9)] = 3;
+  to->disabledComponents.disabledModules.push_back(moduleName(10));
+  to->subnetworks.subnets["Subnet:0"] = { moduleName(11) };
+
+  auto delta = diffNetworkFiles(*from, *to);
+  EXPECT_FALSE(delta.empty());
+  EXPECT_EQ(1, delta.removedModules.size());
+  EXPECT_EQ(2, delta.changedModules.size());
+
+  NetworkFile rebuilt(*from);
+  applyNetworkFileDelta(rebuilt, delta);
+  EXPECT_EQ(binaryText(*to), binaryText(rebuilt));
+
+  EXPECT_TRUE(diffNetworkFiles(*to, rebuilt).empty());
+}
+
+TEST(ProvenanceManagerDeltaTests, UndoAndRedoRestoreExactSnapshots)
+{
+  const int modules = 30, edits = 100;
+  NetworkFileIO io;
+  ProvenanceManager<NetworkFileHandle> manager(&io, 8);
+  auto initial = makeLargeNetwork(modules, 4);
+  manager.setInitialState(initial);
+
+  std::vector<std::string> expected;
+  auto current = initial;
+  for (int i = 0; i < edits; ++i)
+  {
+    auto item = makeEdit(*current, i, modules);
+    current = item->memento();
+    expected.push_back(binaryText(*current));
+    manager.addItem(item);
+    EXPECT_FALSE(item->memento());
+  }
+  EXPECT_EQ((edits + 7) / 8, manager.checkpointCount());
+
+  for (int i = edits - 1; i > 0; --i)
+  {
+    manager.undo();
+    ASSERT_TRUE(io.saveNetwork());
+    ASSERT_EQ(expected[i - 1], binaryText(*io.saveNetwork())) << "after undoing to item " << i - 1;
+  }
+  manager.undo();
+  EXPECT_EQ(binaryText(*initial), binaryText(*io.saveNetwork()));
+
+  for (int i = 0; i < edits; ++i)
+  {
+    manager.redo();
+    ASSERT_EQ(expected[i], binaryText(*io.saveNetwork())) << "after redoing item " << i;
+  }
+
+  manager.undoAll();
+  EXPECT_EQ(binaryText(*initial), binaryText(*io.saveNetwork()));
+  manager.redoAll();
+  EXPECT_EQ(expected.back(), binaryText(*io.saveNetwork()));
+}
+
+TEST(ProvenanceManagerDeltaTests, NewItemAfterUndoReplacesRedoHistory)
+{
+  const int modules = 10;
+  NetworkFileIO io;
+  ProvenanceManager<NetworkFileHandle> manager(&io, 4);
+  auto current = makeLargeNetwork(modules, 2);
+  manager.setInitialState(current);
+
+  for (int i = 0; i < 6; ++i)
+  {
+    auto item = makeEdit(*current, i, modules);
+    current = item->memento();
+    manager.addItem(item);
+  }
+  manager.undo();
+  manager.undo();
+
+  auto branch = boost::make_shared<NetworkFile>(*io.saveNetwork());
+  branch->modulePositions.modulePositions[moduleName(1)] = std::make_pair(123.0, 456.0);
+  auto expected = binaryText(*branch);
+  auto item = boost::make_shared<ModuleMovedProvenanceItem>(ModuleId(moduleName(1)), 123.0, 456.0, branch);
+  manager.addItem(item);
+  EXPECT_EQ(0, manager.redoSize());
+
+  manager.undo();
+  manager.redo();
+  EXPECT_EQ(expected, binaryText(*io.saveNetwork()));
+  EXPECT_EQ(expected, binaryText(*manager.memento(item).get()));
+}
+
+TEST(ProvenanceManagerDeltaTests, DeltaHistoryIsMuchSmallerThanSnapshots)
+{
+  const int modules = 50, edits = 100;
+  NetworkFileIO io;
+  ProvenanceManager<NetworkFileHandle> manager(&io);
+  auto current = makeLargeNetwork(modules, 20);
+  manager.setInitialState(current);
+
+  size_t snapshotBytes = 0, deltaBytes = 0;
+  for (int i = 0; i < edits; ++i)
+  {
+    auto item = makeEdit(*current, i, modules);
+    auto previous = current;
+    current = item->memento();
+    snapshotBytes += binaryText(*current).size();
+    {
+      std::ostringstream ostr;
+      BinarySerializer::save_binary(diffNetworkFiles(*previous, *current), ostr);
+      deltaBytes += ostr.str().size();
+    }
+    manager.addItem(item);
+  }
+  const auto checkpointBytes = manager.checkpointCount() * binaryText(*current).size();
+  EXPECT_LT(checkpointBytes + deltaBytes, snapshotBytes / 8);
+}
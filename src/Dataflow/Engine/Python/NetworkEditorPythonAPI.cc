@@ -432,6 +432,24 @@ boost::python::object NetworkEditorPythonAPI::scirun_get_module_input_value(cons
   return {};
 }
 
+boost::python::object NetworkEditorPythonAPI::scirun_get_module_input_buffer_index(const std::string& moduleId, int portIndex)
+{
+  auto pyData = scirun_get_module_input_object_index(moduleId, portIndex);
+  Guard g(pythonLock_.get());
+  if (pyData)
+    return pyData->buffer();
+  return {};
+}
+
+boost::python::object NetworkEditorPythonAPI::scirun_get_module_input_buffer(const std::string& moduleId, const std::string& portName)
+{
+  auto pyData = scirun_get_module_input_object(moduleId, portName);
+  Guard g(pythonLock_.get());
+  if (pyData)
+    return pyData->buffer();
+  return {};
+}
+
 boost::python::object SimplePythonAPI::scirun_module_ids()
 {
   auto mods = NetworkEditorPythonAPI::modules();
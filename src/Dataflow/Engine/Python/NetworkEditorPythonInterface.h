@@ -78,6 +78,8 @@ namespace SCIRun
     virtual ~PyDatatype() {}
     virtual std::string type() const = 0;
     virtual boost::python::object value() const = 0;
+    /// Zero-copy, read-only buffer views of the underlying storage (falls back to value()).
+    virtual boost::python::object buffer() const = 0;
   };
 
   class SCISHARE PyPort : public boost::enable_shared_from_this<PyPort>
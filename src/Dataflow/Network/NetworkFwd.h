@@ -72,6 +72,7 @@ struct DisabledComponents;
 struct Subnetworks;
 /// @todo: rename this
 struct NetworkFile;
+struct NetworkFileDelta;
 struct ToolkitFile;
 class NetworkGlobalSettings;
 class NetworkEditorSerializationManager;
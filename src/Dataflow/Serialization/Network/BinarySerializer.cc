@@ -0,0 +1,85 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Serialization/Network/BinarySerializer.h>
+#include <cstring>
+
+using namespace SCIRun::Dataflow::Networks;
+
+namespace
+{
+  const char fileTag[8] = { 'S', 'C', 'I', 'R', 'U', 'N', 'B', 'N' };
+}
+
+const char* const BinarySerializer::fileExtension = ".srn5b";
+const unsigned int BinarySerializer::formatVersion = 1;
+
+bool BinarySerializer::write_header(std::ostream& ostr)
+{
+  ostr.write(fileTag, sizeof(fileTag));
+  // Version is stored little endian, independent of the platform
+  char version[4];
+  for (int i = 0; i < 4; ++i)
+    version[i] = static_cast<char>((formatVersion >> (8 * i)) & 0xff);
+  ostr.write(version, sizeof(version));
+  return ostr.good();
+}
+
+bool BinarySerializer::read_header(std::istream& istr, unsigned int& version)
+{
+  char tag[sizeof(fileTag)];
+  char bytes[4];
+  if (!istr.read(tag, sizeof(tag)) || std::memcmp(tag, fileTag, sizeof(tag)) != 0)
+    return false;
+  if (!istr.read(bytes, sizeof(bytes)))
+    return false;
+
+  version = 0;
+  for (int i = 0; i < 4; ++i)
+    version |= static_cast<unsigned int>(static_cast<unsigned char>(bytes[i])) << (8 * i);
+  return version > 0 && version <= formatVersion;
+}
+
+bool BinarySerializer::is_binary(std::istream& istr)
+{
+  if (!istr.good())
+    return false;
+  auto pos = istr.tellg();
+  char tag[sizeof(fileTag)];
+  bool binary = istr.read(tag, sizeof(tag)) && std::memcmp(tag, fileTag, sizeof(tag)) == 0;
+  istr.clear();
+  istr.seekg(pos);
+  return binary;
+}
+
+bool BinarySerializer::is_binary(const std::string& filename)
+{
+  std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
+  return is_binary(ifs);
+}
@@ -0,0 +1,130 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_SERIALIZATION_NETWORK_BINARY_SERIALIZER_H
+#define CORE_SERIALIZATION_NETWORK_BINARY_SERIALIZER_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <Dataflow/Serialization/Network/XMLSerializer.h>
+#include <fstream>
+
+#include <Dataflow/Serialization/Network/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Networks {
+
+  // Compact alternative to the XML network files. The same boost serialization
+  // code is used for both formats, so anything that can be stored as XML can
+  // be stored in binary and converted back without loss. A binary file starts
+  // with a fixed tag and a format version, followed by a boost binary archive.
+  // The archive stores the native representation of numbers, so binary files
+  // are meant for autosave, provenance snapshots and caching on the same
+  // platform; XML remains the exchange format.
+  namespace BinarySerializer
+  {
+    SCISHARE extern const char* const fileExtension;
+    SCISHARE extern const unsigned int formatVersion;
+
+    SCISHARE bool write_header(std::ostream& ostr);
+    // Reads the header, returns false if this is not a binary network file
+    // or if it was written by a newer version.
+    SCISHARE bool read_header(std::istream& istr, unsigned int& version);
+
+    // Check the header without consuming it
+    SCISHARE bool is_binary(std::istream& istr);
+    SCISHARE bool is_binary(const std::string& filename);
+
+    template <class Serializable>
+    bool save_binary(const Serializable& data, std::ostream& ostr)
+    {
+      if (!ostr.good() || !write_header(ostr))
+        return false;
+      boost::archive::binary_oarchive oa(ostr);
+      oa << data;
+      return ostr.good();
+    }
+
+    template <class Serializable>
+    bool save_binary(const Serializable& data, const std::string& filename)
+    {
+      std::ofstream ofs(filename.c_str(), std::ios::out | std::ios::binary);
+      if (!ofs)
+        return false;
+      return save_binary(data, ofs);
+    }
+
+    template <class Serializable>
+    boost::shared_ptr<Serializable> load_binary(std::istream& istr)
+    {
+      unsigned int version;
+      if (!istr.good() || !read_header(istr, version))
+        return nullptr;
+      boost::archive::binary_iarchive ia(istr);
+      boost::shared_ptr<Serializable> nh(new Serializable);
+      ia >> *nh;
+      return nh;
+    }
+
+    template <class Serializable>
+    boost::shared_ptr<Serializable> load_binary(const std::string& filename)
+    {
+      std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
+      return load_binary<Serializable>(ifs);
+    }
+
+    // Loads either format, based on the file header
+    template <class Serializable>
+    boost::shared_ptr<Serializable> load_any(const std::string& filename)
+    {
+      if (is_binary(filename))
+        return load_binary<Serializable>(filename);
+      return XMLSerializer::load_xml<Serializable>(filename);
+    }
+
+    template <class Serializable>
+    bool xml_to_binary(std::istream& xml, std::ostream& binary)
+    {
+      auto data = XMLSerializer::load_xml<Serializable>(xml);
+      return data && save_binary(*data, binary);
+    }
+
+    template <class Serializable>
+    bool binary_to_xml(std::istream& binary, std::ostream& xml, const std::string& rootName)
+    {
+      auto data = load_binary<Serializable>(binary);
+      return data && XMLSerializer::save_xml(*data, xml, rootName);
+    }
+  }
+}}}
+
+#endif
@@ -0,0 +1,240 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Dataflow/Serialization/Network/NetworkFileDelta.h>
+#include <algorithm>
+#include <sstream>
+#include <unordered_set>
+
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Dataflow::State;
+
+namespace
+{
+  bool sameState(const SimpleMapModuleState& lhs, const SimpleMapModuleState& rhs)
+  {
+    auto keys = lhs.getKeys();
+    if (keys != rhs.getKeys())
+      return false;
+    for (const auto& key : keys)
+    {
+      if (!(lhs.getValue(key) == rhs.getValue(key)))
+        return false;
+    }
+    return true;
+  }
+
+  bool sameValue(const ModuleWithState& lhs, const ModuleWithState& rhs)
+  {
+    return lhs.module == rhs.module && sameState(lhs.state, rhs.state);
+  }
+
+  bool sameValue(const NoteXML& lhs, const NoteXML& rhs)
+  {
+    return lhs.noteHTML == rhs.noteHTML && lhs.noteText == rhs.noteText
+      && lhs.position == rhs.position && lhs.fontSize == rhs.fontSize;
+  }
+
+  template <class Value>
+  bool sameValue(const Value& lhs, const Value& rhs)
+  {
+    return lhs == rhs;
+  }
+
+  template <class Map>
+  void diffMaps(const Map& from, const Map& to, Map& changed, NetworkFileDelta::KeyList& removed)
+  {
+    // both maps are sorted by key, so a single merge pass finds all differences
+    auto f = from.begin();
+    auto t = to.begin();
+    while (f != from.end() || t != to.end())
+    {
+      if (t == to.end() || (f != from.end() && f->first < t->first))
+      {
+        removed.push_back(f->first);
+        ++f;
+      }
+      else if (f == from.end() || t->first < f->first)
+      {
+        changed.insert(changed.end(), *t);
+        ++t;
+      }
+      else
+      {
+        if (!sameValue(f->second, t->second))
+          changed.insert(changed.end(), *t);
+        ++f;
+        ++t;
+      }
+    }
+  }
+
+  template <class Map>
+  void applyMap(Map& map, const Map& changed, const NetworkFileDelta::KeyList& removed)
+  {
+    for (const auto& key : removed)
+      map.erase(key);
+    for (const auto& entry : changed)
+      map[entry.first] = entry.second;
+  }
+
+  std::string connectionKey(const ConnectionDescription& cd)
+  {
+    std::ostringstream ostr;
+    ostr << cd.out_.moduleId_.id_ << '\n' << cd.out_.portId_.name << '\n' << cd.out_.portId_.id << '\n'
+      << cd.in_.moduleId_.id_ << '\n' << cd.in_.portId_.name << '\n' << cd.in_.portId_.id;
+    return ostr.str();
+  }
+
+  void diffConnections(const ConnectionsXML& from, const ConnectionsXML& to, NetworkFileDelta& delta)
+  {
+    std::vector<std::string> fromKeys, toKeys;
+    fromKeys.reserve(from.size());
+    toKeys.reserve(to.size());
+    for (const auto& c : from)
+      fromKeys.push_back(connectionKey(c));
+    for (const auto& c : to)
+      toKeys.push_back(connectionKey(c));
+
+    if (fromKeys == toKeys)
+      return;
+
+    std::unordered_set<std::string> inFrom(fromKeys.begin(), fromKeys.end());
+    std::unordered_set<std::string> inTo(toKeys.begin(), toKeys.end());
+
+    // duplicate connections cannot be matched by key, store the whole list
+    if (inFrom.size() != from.size() || inTo.size() != to.size())
+    {
+      delta.connections = to;
+      return;
+    }
+
+    std::vector<size_t> keptFrom, keptTo;
+    for (size_t i = 0; i < from.size(); ++i)
+    {
+      if (inTo.count(fromKeys[i]))
+        keptFrom.push_back(i);
+      else
+        delta.removedConnections.push_back(from[i]);
+    }
+    for (size_t i = 0; i < to.size(); ++i)
+    {
+      if (inFrom.count(toKeys[i]))
+        keptTo.push_back(i);
+      else
+        delta.addedConnections.emplace_back(i, to[i]);
+    }
+
+    for (size_t i = 0; i < keptFrom.size(); ++i)
+    {
+      if (fromKeys[keptFrom[i]] != toKeys[keptTo[i]])
+      {
+        delta.removedConnections.clear();
+        delta.addedConnections.clear();
+        delta.connections = to;
+        return;
+      }
+    }
+  }
+
+  void applyConnections(ConnectionsXML& connections, const NetworkFileDelta& delta)
+  {
+    if (delta.connections)
+    {
+      connections = *delta.connections;
+      return;
+    }
+
+    if (!delta.removedConnections.empty())
+    {
+      std::unordered_set<std::string> removed;
+      for (const auto& c : delta.removedConnections)
+        removed.insert(connectionKey(c));
+      connections.erase(std::remove_if(connections.begin(), connections.end(),
+        [&removed](const ConnectionDescriptionXML& c) { return removed.count(connectionKey(c)) != 0; }),
+        connections.end());
+    }
+
+    // indices are ascending positions in the final list
+    for (const auto& added : delta.addedConnections)
+      connections.insert(connections.begin() + std::min(added.first, connections.size()), added.second);
+  }
+}
+
+bool NetworkFileDelta::empty() const
+{
+  return changedModules.empty() && removedModules.empty()
+    && removedConnections.empty() && addedConnections.empty() && !connections
+    && changedPositions.empty() && removedPositions.empty()
+    && changedModuleNotes.empty() && removedModuleNotes.empty()
+    && changedConnectionNotes.empty() && removedConnectionNotes.empty()
+    && changedTags.empty() && removedTags.empty()
+    && !tagLabels && !showTagGroupsOnLoad && !disabledComponents && !subnetworks;
+}
+
+NetworkFileDelta SCIRun::Dataflow::Networks::diffNetworkFiles(const NetworkFile& from, const NetworkFile& to)
+{
+  NetworkFileDelta delta;
+  diffMaps(from.network.modules, to.network.modules, delta.changedModules, delta.removedModules);
+  diffConnections(from.network.connections, to.network.connections, delta);
+  diffMaps(from.modulePositions.modulePositions, to.modulePositions.modulePositions, delta.changedPositions, delta.removedPositions);
+  diffMaps(from.moduleNotes.notes, to.moduleNotes.notes, delta.changedModuleNotes, delta.removedModuleNotes);
+  diffMaps(from.connectionNotes.notes, to.connectionNotes.notes, delta.changedConnectionNotes, delta.removedConnectionNotes);
+  diffMaps(from.moduleTags.tags, to.moduleTags.tags, delta.changedTags, delta.removedTags);
+
+  if (from.moduleTags.labels != to.moduleTags.labels)
+    delta.tagLabels = to.moduleTags.labels;
+  if (from.moduleTags.showTagGroupsOnLoad != to.moduleTags.showTagGroupsOnLoad)
+    delta.showTagGroupsOnLoad = to.moduleTags.showTagGroupsOnLoad;
+  if (from.disabledComponents.disabledModules != to.disabledComponents.disabledModules
+    || from.disabledComponents.disabledConnections != to.disabledComponents.disabledConnections)
+    delta.disabledComponents = to.disabledComponents;
+  if (from.subnetworks.subnets != to.subnetworks.subnets)
+    delta.subnetworks = to.subnetworks.subnets;
+
+  return delta;
+}
+
+void SCIRun::Dataflow::Networks::applyNetworkFileDelta(NetworkFile& file, const NetworkFileDelta& delta)
+{
+  applyMap(file.network.modules, delta.changedModules, delta.removedModules);
+  applyConnections(file.network.connections, delta);
+  applyMap(file.modulePositions.modulePositions, delta.changedPositions, delta.removedPositions);
+  applyMap(file.moduleNotes.notes, delta.changedModuleNotes, delta.removedModuleNotes);
+  applyMap(file.connectionNotes.notes, delta.changedConnectionNotes, delta.removedConnectionNotes);
+  applyMap(file.moduleTags.tags, delta.changedTags, delta.removedTags);
+
+  if (delta.tagLabels)
+    file.moduleTags.labels = *delta.tagLabels;
+  if (delta.showTagGroupsOnLoad)
+    file.moduleTags.showTagGroupsOnLoad = *delta.showTagGroupsOnLoad;
+  if (delta.disabledComponents)
+    file.disabledComponents = *delta.disabledComponents;
+  if (delta.subnetworks)
+    file.subnetworks.subnets = *delta.subnetworks;
+}
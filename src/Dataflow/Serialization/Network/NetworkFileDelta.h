@@ -0,0 +1,116 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_SERIALIZATION_NETWORK_NETWORK_FILE_DELTA_H
+#define CORE_SERIALIZATION_NETWORK_NETWORK_FILE_DELTA_H
+
+#include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
+#include <boost/serialization/optional.hpp>
+#include <boost/serialization/utility.hpp>
+#include <Dataflow/Serialization/Network/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Networks {
+
+  // Structural difference between two network files: entries that were added
+  // or changed are stored by value, removed entries by key. Applying the delta
+  // to the older file reproduces the newer one exactly, so provenance history
+  // can keep one full snapshot every few edits and deltas in between.
+  struct SCISHARE NetworkFileDelta
+  {
+    using KeyList = std::vector<std::string>;
+
+    ModuleMapXML changedModules;
+    KeyList removedModules;
+
+    // Connections are usually appended or removed one at a time; those edits
+    // are stored with their final index. Any other reordering replaces the list.
+    ConnectionsXML removedConnections;
+    std::vector<std::pair<size_t, ConnectionDescriptionXML>> addedConnections;
+    boost::optional<ConnectionsXML> connections;
+
+    ModulePositions::Data changedPositions;
+    KeyList removedPositions;
+    NotesMapXML changedModuleNotes;
+    KeyList removedModuleNotes;
+    NotesMapXML changedConnectionNotes;
+    KeyList removedConnectionNotes;
+    ModuleTagsMapXML changedTags;
+    KeyList removedTags;
+
+    // Small and rarely edited, stored whole when they change.
+    boost::optional<ModuleTagLabelOverridesMapXML> tagLabels;
+    boost::optional<bool> showTagGroupsOnLoad;
+    boost::optional<DisabledComponents> disabledComponents;
+    boost::optional<SubnetworkMap> subnetworks;
+
+    bool empty() const;
+  private:
+    friend class boost::serialization::access;
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int version)
+    {
+      ar & BOOST_SERIALIZATION_NVP(changedModules);
+      ar & BOOST_SERIALIZATION_NVP(removedModules);
+      ar & BOOST_SERIALIZATION_NVP(removedConnections);
+      ar & BOOST_SERIALIZATION_NVP(addedConnections);
+      ar & BOOST_SERIALIZATION_NVP(connections);
+      ar & BOOST_SERIALIZATION_NVP(changedPositions);
+      ar & BOOST_SERIALIZATION_NVP(removedPositions);
+      ar & BOOST_SERIALIZATION_NVP(changedModuleNotes);
+      ar & BOOST_SERIALIZATION_NVP(removedModuleNotes);
+      ar & BOOST_SERIALIZATION_NVP(changedConnectionNotes);
+      ar & BOOST_SERIALIZATION_NVP(removedConnectionNotes);
+      ar & BOOST_SERIALIZATION_NVP(changedTags);
+      ar & BOOST_SERIALIZATION_NVP(removedTags);
+      ar & BOOST_SERIALIZATION_NVP(tagLabels);
+      ar & BOOST_SERIALIZATION_NVP(showTagGroupsOnLoad);
+      ar & BOOST_SERIALIZATION_NVP(disabledComponents);
+      ar & BOOST_SERIALIZATION_NVP(subnetworks);
+    }
+  };
+
+  SCISHARE NetworkFileDelta diffNetworkFiles(const NetworkFile& from, const NetworkFile& to);
+  SCISHARE void applyNetworkFileDelta(NetworkFile& file, const NetworkFileDelta& delta);
+
+}}}
+
+namespace boost {
+  namespace serialization {
+
+    template<class Archive>
+    void serialize(Archive& ar, SCIRun::Dataflow::Networks::DisabledComponents& dc, const unsigned int)
+    {
+      ar & boost::serialization::make_nvp("disabledModules", dc.disabledModules);
+      ar & boost::serialization::make_nvp("disabledConnections", dc.disabledConnections);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,75 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <iostream>
+#include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
+#include <Dataflow/Serialization/Network/BinarySerializer.h>
+#include <boost/algorithm/string/predicate.hpp>
+
+using namespace SCIRun::Dataflow::Networks;
+
+int printHelp()
+{
+  std::cout << "Usage: convert_network INPUT_FILE OUTPUT_FILE\n"
+    "Converts between XML (.srn5) and binary (.srn5b) network files. The input format is detected\n"
+    "from the file contents, the output format from the extension of OUTPUT_FILE." << std::endl;
+  return 0;
+}
+
+int main(int argc, const char* argv[])
+{
+  if (argc < 3)
+  {
+    return printHelp();
+  }
+
+  std::string input(argv[1]), output(argv[2]);
+
+  auto file = BinarySerializer::load_any<NetworkFile>(input);
+  if (!file)
+  {
+    std::cerr << "Could not read network file: " << input << std::endl;
+    return 1;
+  }
+
+  bool saved;
+  if (boost::algorithm::ends_with(output, BinarySerializer::fileExtension))
+    saved = BinarySerializer::save_binary(*file, output);
+  else
+    saved = XMLSerializer::save_xml(*file, output, "networkFile");
+
+  if (!saved)
+  {
+    std::cerr << "Could not write network file: " << output << std::endl;
+    return 1;
+  }
+
+  std::cout << "Converted " << input << " to " << output << std::endl;
+  return 0;
+}
@@ -56,6 +56,10 @@ public:
   // Writes numBytes of bytes.
   void writeBytes(const char* bytes, size_t numBytes);
 
+  // Appends numBytes of unset bytes and returns a pointer to them, so callers
+  // can fill them in place. The pointer is valid until the next write.
+  char* reserveBytes(size_t numBytes);
+
   /// Writes a null terminated string.
   void writeNullTermString(const char* str);
 
@@ -27,6 +27,7 @@
 
 
 #include <Graphics/Datatypes/GeometryImpl.h>
+#include <limits>
 
 using namespace SCIRun::Core;
 using namespace SCIRun::Core::Datatypes;
@@ -81,3 +82,118 @@ void SpireSubPass::addUniform(const Uniform& uniform)
 {
   mUniforms.push_back(uniform);
 }
+
+namespace
+{
+  size_t attributeOffset(const std::vector<SpireVBO::AttributeData>& attributes, const std::string& name, size_t& stride)
+  {
+    size_t offset = std::numeric_limits<size_t>::max();
+    stride = 0;
+    for (const auto& attribute : attributes)
+    {
+      if (attribute.name == name)
+        offset = stride;
+      stride += attribute.sizeInBytes;
+    }
+    return offset;
+  }
+
+  glm::vec3 readVec3(const char* bytes)
+  {
+    const float* f = reinterpret_cast<const float*>(bytes);
+    return glm::vec3(f[0], f[1], f[2]);
+  }
+}
+
+SpireSubPass SCIRun::Graphics::Datatypes::expandInstances(const SpireSubPass& pass)
+{
+  if (pass.instances.count == 0 || !pass.instances.data || !pass.vbo.data || !pass.ibo.data)
+    return pass;
+
+  size_t templateStride, instanceStride, unused;
+  const size_t posOffset = attributeOffset(pass.vbo.attributes, "aPos", templateStride);
+  const size_t normalOffset = attributeOffset(pass.vbo.attributes, "aNormal", unused);
+  const size_t rowOffset = attributeOffset(pass.instances.attributes, "aInstanceRow0", instanceStride);
+  const size_t colorOffset = attributeOffset(pass.instances.attributes, "aInstanceColor", unused);
+  const size_t texCoordOffset = attributeOffset(pass.instances.attributes, "aInstanceTexCoords", unused);
+  const bool hasNormals = normalOffset != std::numeric_limits<size_t>::max();
+  const bool hasColor = colorOffset != std::numeric_limits<size_t>::max();
+  const bool hasTexCoords = texCoordOffset != std::numeric_limits<size_t>::max();
+  if (posOffset == std::numeric_limits<size_t>::max() || rowOffset == std::numeric_limits<size_t>::max())
+    return pass;
+
+  const char* templateVerts = pass.vbo.data->getBuffer();
+  const size_t numTemplateVerts = pass.vbo.data->getBufferSize() / templateStride;
+  const uint32_t* templateIndices = reinterpret_cast<const uint32_t*>(pass.ibo.data->getBuffer());
+  const size_t numTemplateIndices = pass.ibo.data->getBufferSize() / sizeof(uint32_t);
+  const char* instances = pass.instances.data->getBuffer();
+  const size_t numInstances = pass.instances.count;
+
+  std::vector<SpireVBO::AttributeData> attributes;
+  attributes.push_back(SpireVBO::AttributeData("aPos", 3 * sizeof(float)));
+  if (hasNormals) attributes.push_back(SpireVBO::AttributeData("aNormal", 3 * sizeof(float)));
+  if (hasColor) attributes.push_back(SpireVBO::AttributeData("aColor", 4 * sizeof(float)));
+  else if (hasTexCoords) attributes.push_back(SpireVBO::AttributeData("aTexCoords", 2 * sizeof(float)));
+  const size_t floatsPerVertex = 3 + (hasNormals ? 3 : 0) + (hasColor ? 4 : hasTexCoords ? 2 : 0);
+
+  std::vector<float> vertices(numInstances * numTemplateVerts * floatsPerVertex);
+  std::vector<uint32_t> indices(numInstances * numTemplateIndices);
+  float* out = vertices.data();
+  for (size_t k = 0; k < numInstances; ++k)
+  {
+    const char* instance = instances + k * instanceStride;
+    const float* rows = reinterpret_cast<const float*>(instance + rowOffset);
+    const glm::vec3 c0(rows[0], rows[4], rows[8]), c1(rows[1], rows[5], rows[9]), c2(rows[2], rows[6], rows[10]);
+    const glm::vec3 translation(rows[3], rows[7], rows[11]);
+    // Normals transform with the cofactor matrix, i.e. det(M) * inverse-transpose(M).
+    const float handedness = glm::dot(c0, glm::cross(c1, c2)) < 0.0f ? -1.0f : 1.0f;
+    const glm::vec3 n0 = glm::cross(c1, c2) * handedness, n1 = glm::cross(c2, c0) * handedness, n2 = glm::cross(c0, c1) * handedness;
+
+    for (size_t v = 0; v < numTemplateVerts; ++v)
+    {
+      const char* vertex = templateVerts + v * templateStride;
+      const glm::vec3 p = readVec3(vertex + posOffset);
+      const glm::vec3 pos = c0 * p.x + c1 * p.y + c2 * p.z + translation;
+      *out++ = pos.x; *out++ = pos.y; *out++ = pos.z;
+      if (hasNormals)
+      {
+        const glm::vec3 n = readVec3(vertex + normalOffset);
+        glm::vec3 normal = n0 * n.x + n1 * n.y + n2 * n.z;
+        const float length = glm::length(normal);
+        if (length > 0.0f) normal /= length;
+        *out++ = normal.x; *out++ = normal.y; *out++ = normal.z;
+      }
+      if (hasColor)
+      {
+        const float* color = reinterpret_cast<const float*>(instance + colorOffset);
+        for (int i = 0; i < 4; ++i) *out++ = color[i];
+      }
+      else if (hasTexCoords)
+      {
+        const float* texCoords = reinterpret_cast<const float*>(instance + texCoordOffset);
+        *out++ = texCoords[0]; *out++ = texCoords[1];
+      }
+    }
+
+    const uint32_t first = static_cast<uint32_t>(k * numTemplateVerts);
+    for (size_t i = 0; i < numTemplateIndices; ++i)
+      indices[k * numTemplateIndices + i] = first + templateIndices[i];
+  }
+
+  std::shared_ptr<spire::VarBuffer> vboData(new spire::VarBuffer(vertices.size() * sizeof(float)));
+  vboData->writeBytes(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(float));
+  std::shared_ptr<spire::VarBuffer> iboData(new spire::VarBuffer(indices.size() * sizeof(uint32_t)));
+  iboData->writeBytes(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t));
+
+  SpireSubPass expanded(pass);
+  expanded.vbo = SpireVBO(pass.vbo.name, attributes, vboData, vertices.size() / floatsPerVertex,
+    pass.vbo.boundingBox, pass.vbo.onGPU);
+  expanded.ibo = SpireIBO(pass.ibo.name, pass.ibo.prim, sizeof(uint32_t), iboData);
+  expanded.instances = SpireInstances();
+
+  const auto& program = pass.programName;
+  if (program.size() > InstancedProgramSuffix.size() &&
+      program.compare(program.size() - InstancedProgramSuffix.size(), InstancedProgramSuffix.size(), InstancedProgramSuffix) == 0)
+    expanded.programName = program.substr(0, program.size() - InstancedProgramSuffix.size());
+  return expanded;
+}
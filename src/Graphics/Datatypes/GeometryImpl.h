@@ -165,6 +165,20 @@ namespace SCIRun {
       };
 
 
+      /// Per-instance data for a pass whose VBO and IBO hold a single template glyph in unit
+      /// space. Each instance is the three rows of an affine 3x4 transform (aInstanceRow0-2)
+      /// followed by an RGBA colour (aInstanceColor) or colour map coordinates
+      /// (aInstanceTexCoords). A count of zero means the pass is not instanced.
+      struct SpireInstances
+      {
+        SpireInstances() : count(0) {}
+
+        std::string                           name;
+        std::vector<SpireVBO::AttributeData>  attributes;
+        std::shared_ptr<spire::VarBuffer>     data;
+        size_t                                count;
+      };
+
       /// Defines a Spire object 'pass'.
       struct SCISHARE SpireSubPass
       {
@@ -206,6 +220,7 @@ namespace SCIRun {
         SpireIBO			ibo;
         SpireText     text;//draw a string (usually single character) on geometry
         SpireTexture2D texture;
+        SpireInstances instances;
         double        scalar;
 
 
@@ -244,6 +259,14 @@ namespace SCIRun {
         void addUniform(const Uniform& uniform);
       };
 
+      /// Program suffix of passes drawn with instancing; the fallback program drops it.
+      static const std::string InstancedProgramSuffix = "_Instanced";
+
+      /// Expands an instanced pass on the CPU for renderers that cannot draw instances: the
+      /// template is transformed once per instance into an ordinary VBO/IBO pair that keeps
+      /// the pass's buffer names and uses the non-instanced program.
+      SCISHARE SpireSubPass expandInstances(const SpireSubPass& pass);
+
       using VBOList = std::list<SpireVBO>;
       using IBOList = std::list<SpireIBO>;
       using PassList = std::list<SpireSubPass>;
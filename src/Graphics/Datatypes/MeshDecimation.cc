@@ -0,0 +1,795 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Graphics/Datatypes/MeshDecimation.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+
+using namespace SCIRun::Graphics::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  const size_t itemsPerTask = 8192;
+
+  // Float layout of a VBO vertex. Decimation space holds the position followed by every other
+  // attribute in buffer order.
+  struct VertexLayout
+  {
+    struct Attribute
+    {
+      size_t offset, floats;
+      bool isNormal;
+    };
+
+    size_t stride {0}, posOffset {0}, attributeFloats {0};
+    std::vector<Attribute> attributes;
+    bool valid {false};
+
+    explicit VertexLayout(const SpireVBO& vbo)
+    {
+      bool hasPos = false;
+      for (const auto& a : vbo.attributes)
+      {
+        if (a.sizeInBytes % sizeof(float) != 0)
+          return;
+        size_t floats = a.sizeInBytes / sizeof(float);
+        if (a.name == "aPos")
+        {
+          if (floats != 3)
+            return;
+          posOffset = stride;
+          hasPos = true;
+        }
+        else
+        {
+          attributes.push_back({ stride, floats, a.name == "aNormal" && floats == 3 });
+          attributeFloats += floats;
+        }
+        stride += floats;
+      }
+      valid = hasPos;
+    }
+
+    size_t dim() const { return 3 + attributeFloats; }
+  };
+
+  // Symmetric quadric v^T A v + 2 b^T v + c over R^dim, stored as the upper triangle of A,
+  // then b, then c.
+  class QuadricSpace
+  {
+  public:
+    explicit QuadricSpace(size_t dim) : dim_(dim), tri_(dim * (dim + 1) / 2) {}
+
+    size_t size() const { return tri_ + dim_ + 1; }
+
+    void add(double* q, const double* other) const
+    {
+      for (size_t i = 0; i < size(); ++i)
+        q[i] += other[i];
+    }
+
+    // Squared distance to the plane through p0, p1, p2 within R^dim.
+    void addTriangle(double* q, const double* p0, const double* p1, const double* p2, double weight) const
+    {
+      std::vector<double> e1(dim_), e2(dim_);
+      double len1 = 0, dot12 = 0;
+      for (size_t i = 0; i < dim_; ++i)
+      {
+        e1[i] = p1[i] - p0[i];
+        len1 += e1[i] * e1[i];
+      }
+      len1 = std::sqrt(len1);
+      if (len1 <= std::numeric_limits<double>::min())
+        return;
+      for (size_t i = 0; i < dim_; ++i)
+      {
+        e1[i] /= len1;
+        e2[i] = p2[i] - p0[i];
+        dot12 += e2[i] * e1[i];
+      }
+      double len2 = 0;
+      for (size_t i = 0; i < dim_; ++i)
+      {
+        e2[i] -= dot12 * e1[i];
+        len2 += e2[i] * e2[i];
+      }
+      len2 = std::sqrt(len2);
+      if (len2 <= std::numeric_limits<double>::min())
+        return;
+
+      double pe1 = 0, pe2 = 0, pp = 0;
+      for (size_t i = 0; i < dim_; ++i)
+      {
+        e2[i] /= len2;
+        pe1 += p0[i] * e1[i];
+        pe2 += p0[i] * e2[i];
+        pp += p0[i] * p0[i];
+      }
+
+      for (size_t i = 0, k = 0; i < dim_; ++i)
+        for (size_t j = i; j < dim_; ++j, ++k)
+          q[k] += weight * ((i == j ? 1.0 : 0.0) - e1[i] * e1[j] - e2[i] * e2[j]);
+      for (size_t i = 0; i < dim_; ++i)
+        q[tri_ + i] += weight * (pe1 * e1[i] + pe2 * e2[i] - p0[i]);
+      q[tri_ + dim_] += weight * (pp - pe1 * pe1 - pe2 * pe2);
+    }
+
+    // Squared distance to the plane n.x + d = 0 in the position coordinates only.
+    void addPlane(double* q, const Vector& n, double d, double weight) const
+    {
+      for (size_t i = 0; i < 3; ++i)
+        for (size_t j = i; j < 3; ++j)
+          q[index(i, j)] += weight * n[i] * n[j];
+      for (size_t i = 0; i < 3; ++i)
+        q[tri_ + i] += weight * d * n[i];
+      q[tri_ + dim_] += weight * d * d;
+    }
+
+    double evaluate(const double* q, const double* v) const
+    {
+      double result = q[tri_ + dim_];
+      for (size_t i = 0, k = 0; i < dim_; ++i)
+      {
+        result += q[k++] * v[i] * v[i];
+        for (size_t j = i + 1; j < dim_; ++j)
+          result += 2.0 * q[k++] * v[i] * v[j];
+        result += 2.0 * q[tri_ + i] * v[i];
+      }
+      return result;
+    }
+
+    // Solves A v = -b by Gaussian elimination with partial pivoting; false if A is singular.
+    bool minimize(const double* q, double* v) const
+    {
+      const size_t n = dim_;
+      std::vector<double> m(n * (n + 1));
+      double scale = 0;
+      for (size_t i = 0; i < n; ++i)
+      {
+        for (size_t j = 0; j < n; ++j)
+          m[i * (n + 1) + j] = q[index(std::min(i, j), std::max(i, j))];
+        m[i * (n + 1) + n] = -q[tri_ + i];
+        scale = std::max(scale, std::fabs(m[i * (n + 1) + i]));
+      }
+      const double tolerance = 1e-10 * scale;
+      if (scale <= 0)
+        return false;
+
+      for (size_t col = 0; col < n; ++col)
+      {
+        size_t pivot = col;
+        for (size_t r = col + 1; r < n; ++r)
+          if (std::fabs(m[r * (n + 1) + col]) > std::fabs(m[pivot * (n + 1) + col]))
+            pivot = r;
+        if (std::fabs(m[pivot * (n + 1) + col]) <= tolerance)
+          return false;
+        if (pivot != col)
+          for (size_t j = 0; j <= n; ++j)
+            std::swap(m[pivot * (n + 1) + j], m[col * (n + 1) + j]);
+        for (size_t r = col + 1; r < n; ++r)
+        {
+          double factor = m[r * (n + 1) + col] / m[col * (n + 1) + col];
+          for (size_t j = col; j <= n; ++j)
+            m[r * (n + 1) + j] -= factor * m[col * (n + 1) + j];
+        }
+      }
+      for (size_t i = n; i-- > 0;)
+      {
+        double sum = m[i * (n + 1) + n];
+        for (size_t j = i + 1; j < n; ++j)
+          sum -= m[i * (n + 1) + j] * v[j];
+        v[i] = sum / m[i * (n + 1) + i];
+      }
+      return true;
+    }
+
+  private:
+    size_t index(size_t i, size_t j) const { return i * dim_ - i * (i - 1) / 2 + (j - i); }
+
+    size_t dim_, tri_;
+  };
+
+  struct Candidate
+  {
+    double cost;
+    uint32_t u, w;
+    uint32_t stampU, stampW;
+
+    bool operator>(const Candidate& other) const { return cost > other.cost; }
+  };
+
+  struct PositionKey
+  {
+    uint32_t bits[3];
+    bool operator==(const PositionKey& other) const { return std::memcmp(bits, other.bits, sizeof(bits)) == 0; }
+  };
+
+  struct PositionKeyHash
+  {
+    size_t operator()(const PositionKey& key) const
+    {
+      return (static_cast<size_t>(key.bits[0]) * 73856093u) ^ (static_cast<size_t>(key.bits[1]) * 19349663u)
+        ^ (static_cast<size_t>(key.bits[2]) * 83492791u);
+    }
+  };
+
+  class QuadricDecimation
+  {
+  public:
+    QuadricDecimation(const SpireVBO& vbo, const SpireIBO& ibo, const DecimationOptions& options);
+    LevelsOfDetail run();
+
+  private:
+    void weldVertices();
+    void buildQuadrics();
+    void buildCandidates();
+    // scratch holds space_.size() + dim_ doubles.
+    double collapseCost(uint32_t u, uint32_t w, double* target, double* scratch) const;
+    bool collapse(uint32_t u, uint32_t w, const double* target);
+    void pushCandidates(uint32_t u);
+    DecimatedMesh snapshot(size_t level) const;
+
+    Vector position(uint32_t v) const { return Vector(coords_[v * dim_], coords_[v * dim_ + 1], coords_[v * dim_ + 2]); }
+    double* quadric(uint32_t v) { return &quadrics_[v * space_.size()]; }
+    const double* quadric(uint32_t v) const { return &quadrics_[v * space_.size()]; }
+
+    const SpireVBO& vbo_;
+    const SpireIBO& ibo_;
+    const DecimationOptions& options_;
+    VertexLayout layout_;
+    size_t dim_;
+    QuadricSpace space_;
+    double attributeScale_ {1.0};
+
+    std::vector<uint32_t> welded_;        // source vertex -> welded vertex
+    std::vector<double> coords_;          // dim_ per welded vertex
+    std::vector<double> quadrics_;
+    std::vector<uint32_t> faces_;         // welded vertex triples
+    std::vector<uint32_t> corners_;       // source vertex triples, for corner attributes
+    std::vector<char> faceAlive_;
+    std::vector<uint32_t> stamps_;
+    std::vector<std::vector<uint32_t>> vertexFaces_;
+    size_t aliveFaces_ {0};
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> heap_;
+  };
+
+  QuadricDecimation::QuadricDecimation(const SpireVBO& vbo, const SpireIBO& ibo, const DecimationOptions& options)
+    : vbo_(vbo), ibo_(ibo), options_(options), layout_(vbo), dim_(layout_.dim()), space_(dim_)
+  {
+  }
+
+  void QuadricDecimation::weldVertices()
+  {
+    const auto* src = reinterpret_cast<const float*>(vbo_.data->getBuffer());
+    const size_t numSource = vbo_.data->getBufferSize() / (layout_.stride * sizeof(float));
+
+    // ShowField writes every face with its own vertices; weld them so collapses see the surface.
+    std::unordered_map<PositionKey, uint32_t, PositionKeyHash> lookup;
+    lookup.reserve(numSource);
+    welded_.resize(numSource);
+    std::vector<uint32_t> wedgeCount;
+    BBox bounds;
+    for (size_t s = 0; s < numSource; ++s)
+    {
+      const float* pos = src + s * layout_.stride + layout_.posOffset;
+      PositionKey key;
+      std::memcpy(key.bits, pos, sizeof(key.bits));
+      auto inserted = lookup.insert(std::make_pair(key, static_cast<uint32_t>(wedgeCount.size())));
+      uint32_t v = inserted.first->second;
+      welded_[s] = v;
+      if (inserted.second)
+      {
+        wedgeCount.push_back(0);
+        coords_.resize(coords_.size() + dim_, 0.0);
+        for (int i = 0; i < 3; ++i)
+          coords_[v * dim_ + i] = pos[i];
+        bounds.extend(Point(pos[0], pos[1], pos[2]));
+      }
+      ++wedgeCount[v];
+      size_t d = 3;
+      for (const auto& a : layout_.attributes)
+        for (size_t i = 0; i < a.floats; ++i, ++d)
+          coords_[v * dim_ + d] += src[s * layout_.stride + a.offset + i];
+    }
+
+    const double diagonal = bounds.valid() ? bounds.diagonal().length() : 0.0;
+    attributeScale_ = diagonal > 0 ? options_.attributeWeight * diagonal : options_.attributeWeight;
+
+    const size_t numVertices = wedgeCount.size();
+    for (size_t v = 0; v < numVertices; ++v)
+    {
+      size_t d = 3;
+      for (const auto& a : layout_.attributes)
+      {
+        double* values = &coords_[v * dim_ + d];
+        double length = 0;
+        for (size_t i = 0; i < a.floats; ++i)
+        {
+          values[i] /= wedgeCount[v];
+          length += values[i] * values[i];
+        }
+        length = std::sqrt(length);
+        for (size_t i = 0; i < a.floats; ++i)
+          values[i] *= (a.isNormal && length > 0 ? 1.0 / length : 1.0) * attributeScale_;
+        d += a.floats;
+      }
+    }
+
+    const auto* indices = reinterpret_cast<const uint32_t*>(ibo_.data->getBuffer());
+    const size_t numSourceFaces = ibo_.data->getBufferSize() / (3 * sizeof(uint32_t));
+    faces_.reserve(numSourceFaces * 3);
+    corners_.reserve(numSourceFaces * 3);
+    for (size_t f = 0; f < numSourceFaces; ++f)
+    {
+      const uint32_t* tri = indices + 3 * f;
+      if (tri[0] >= numSource || tri[1] >= numSource || tri[2] >= numSource)
+        continue;
+      uint32_t a = welded_[tri[0]], b = welded_[tri[1]], c = welded_[tri[2]];
+      if (a == b || b == c || a == c)
+        continue;
+      faces_.insert(faces_.end(), { a, b, c });
+      corners_.insert(corners_.end(), tri, tri + 3);
+    }
+    aliveFaces_ = faces_.size() / 3;
+    faceAlive_.assign(aliveFaces_, 1);
+    stamps_.assign(numVertices, 0);
+
+    vertexFaces_.resize(numVertices);
+    for (uint32_t f = 0; f < aliveFaces_; ++f)
+      for (int k = 0; k < 3; ++k)
+        vertexFaces_[faces_[3 * f + k]].push_back(f);
+  }
+
+  void QuadricDecimation::buildQuadrics()
+  {
+    const auto* src = reinterpret_cast<const float*>(vbo_.data->getBuffer());
+    const size_t numVertices = vertexFaces_.size();
+    quadrics_.assign(numVertices * space_.size(), 0.0);
+
+    // Each vertex sums the quadrics of its own faces, so tasks never write to shared vertices.
+    const int numTasks = Parallel::NumTasks(numVertices, itemsPerTask);
+    Parallel::RunRange(numVertices, numTasks, [&](int, size_t begin, size_t end)
+    {
+      std::vector<double> corners(3 * dim_);
+      for (size_t v = begin; v < end; ++v)
+      {
+        double* q = quadric(static_cast<uint32_t>(v));
+        for (auto f : vertexFaces_[v])
+        {
+          // Corners carry the face's own attributes, so attribute seams cost more to collapse.
+          for (int k = 0; k < 3; ++k)
+          {
+            double* corner = &corners[k * dim_];
+            const uint32_t wv = faces_[3 * f + k];
+            const float* s = src + corners_[3 * f + k] * layout_.stride;
+            for (int i = 0; i < 3; ++i)
+              corner[i] = coords_[wv * dim_ + i];
+            size_t d = 3;
+            for (const auto& a : layout_.attributes)
+            {
+              double length = 0;
+              for (size_t i = 0; i < a.floats; ++i)
+                length += s[a.offset + i] * s[a.offset + i];
+              length = a.isNormal && length > 0 ? std::sqrt(length) : 1.0;
+              for (size_t i = 0; i < a.floats; ++i, ++d)
+                corner[d] = s[a.offset + i] / length * attributeScale_;
+            }
+          }
+
+          Vector p0 = position(faces_[3 * f]), p1 = position(faces_[3 * f + 1]), p2 = position(faces_[3 * f + 2]);
+          Vector normal = Cross(p1 - p0, p2 - p0);
+          double area = 0.5 * normal.length();
+          space_.addTriangle(q, &corners[0], &corners[dim_], &corners[2 * dim_], area);
+          if (area <= 0)
+            continue;
+          normal /= 2.0 * area;
+
+          // Edges used by one face lie on an open boundary; a perpendicular plane keeps them in place.
+          for (int k = 0; k < 3; ++k)
+          {
+            uint32_t other = faces_[3 * f + k];
+            if (other == v)
+              continue;
+            size_t shared = 0;
+            for (auto g : vertexFaces_[v])
+              if (faces_[3 * g] == other || faces_[3 * g + 1] == other || faces_[3 * g + 2] == other)
+                ++shared;
+            if (shared != 1)
+              continue;
+            Vector edge = position(other) - position(static_cast<uint32_t>(v));
+            Vector planeNormal = Cross(edge, normal);
+            if (planeNormal.length() <= 0)
+              continue;
+            planeNormal.safe_normalize();
+            double d = -Dot(planeNormal, position(static_cast<uint32_t>(v)));
+            space_.addPlane(q, planeNormal, d, options_.boundaryWeight * edge.length2());
+          }
+        }
+      }
+    });
+  }
+
+  double QuadricDecimation::collapseCost(uint32_t u, uint32_t w, double* target, double* scratch) const
+  {
+    std::copy(quadric(u), quadric(u) + space_.size(), scratch);
+    space_.add(scratch, quadric(w));
+
+    const double* cu = &coords_[u * dim_];
+    const double* cw = &coords_[w * dim_];
+    Vector midpoint = 0.5 * (position(u) + position(w));
+    double edgeLength = (position(u) - position(w)).length();
+
+    double best = std::numeric_limits<double>::max();
+    if (space_.minimize(scratch, target)
+      && (Vector(target[0], target[1], target[2]) - midpoint).length() <= 2.0 * edgeLength)
+    {
+      best = space_.evaluate(scratch, target);
+    }
+
+    // Fall back to (or improve on) the endpoints and the midpoint.
+    double* option = scratch + space_.size();
+    for (int choice = 0; choice < 3; ++choice)
+    {
+      for (size_t i = 0; i < dim_; ++i)
+        option[i] = choice == 0 ? cu[i] : choice == 1 ? cw[i] : 0.5 * (cu[i] + cw[i]);
+      double cost = space_.evaluate(scratch, option);
+      if (cost < best)
+      {
+        best = cost;
+        std::copy(option, option + dim_, target);
+      }
+    }
+    return std::max(0.0, best);
+  }
+
+  void QuadricDecimation::buildCandidates()
+  {
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    edges.reserve(faces_.size());
+    for (size_t f = 0; f < faces_.size() / 3; ++f)
+      for (int k = 0; k < 3; ++k)
+      {
+        uint32_t a = faces_[3 * f + k], b = faces_[3 * f + (k + 1) % 3];
+        edges.emplace_back(std::min(a, b), std::max(a, b));
+      }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    std::vector<Candidate> candidates(edges.size());
+    const int numTasks = Parallel::NumTasks(edges.size(), itemsPerTask);
+    Parallel::RunRange(edges.size(), numTasks, [&](int, size_t begin, size_t end)
+    {
+      std::vector<double> target(dim_), scratch(space_.size() + dim_);
+      for (size_t e = begin; e < end; ++e)
+      {
+        auto u = edges[e].first, w = edges[e].second;
+        candidates[e] = { collapseCost(u, w, &target[0], &scratch[0]), u, w, 0, 0 };
+      }
+    });
+    heap_ = decltype(heap_)(std::greater<Candidate>(), std::move(candidates));
+  }
+
+  bool QuadricDecimation::collapse(uint32_t u, uint32_t w, const double* target)
+  {
+    // Reject collapses that would fold a surviving face over.
+    const Vector newPosition(target[0], target[1], target[2]);
+    for (auto v : { u, w })
+    {
+      for (auto f : vertexFaces_[v])
+      {
+        if (!faceAlive_[f])
+          continue;
+        const uint32_t* tri = &faces_[3 * f];
+        bool hasU = tri[0] == u || tri[1] == u || tri[2] == u;
+        bool hasW = tri[0] == w || tri[1] == w || tri[2] == w;
+        if (hasU && hasW)
+          continue;
+        Vector before[3], after[3];
+        for (int k = 0; k < 3; ++k)
+        {
+          before[k] = position(tri[k]);
+          after[k] = tri[k] == v ? newPosition : before[k];
+        }
+        Vector oldNormal = Cross(before[1] - before[0], before[2] - before[0]);
+        Vector newNormal = Cross(after[1] - after[0], after[2] - after[0]);
+        if (Dot(oldNormal, newNormal) <= 0)
+          return false;
+      }
+    }
+
+    std::copy(target, target + dim_, &coords_[u * dim_]);
+    space_.add(quadric(u), quadric(w));
+
+    for (auto f : vertexFaces_[w])
+    {
+      if (!faceAlive_[f])
+        continue;
+      uint32_t* tri = &faces_[3 * f];
+      if (tri[0] == u || tri[1] == u || tri[2] == u)
+      {
+        faceAlive_[f] = 0;
+        --aliveFaces_;
+      }
+      else
+      {
+        for (int k = 0; k < 3; ++k)
+          if (tri[k] == w)
+            tri[k] = u;
+        vertexFaces_[u].push_back(f);
+      }
+    }
+    std::vector<uint32_t>().swap(vertexFaces_[w]);
+    auto& faces = vertexFaces_[u];
+    faces.erase(std::remove_if(faces.begin(), faces.end(), [this](uint32_t f) { return !faceAlive_[f]; }), faces.end());
+    ++stamps_[u];
+    ++stamps_[w];
+    return true;
+  }
+
+  void QuadricDecimation::pushCandidates(uint32_t u)
+  {
+    std::vector<uint32_t> neighbors;
+    for (auto f : vertexFaces_[u])
+      for (int k = 0; k < 3; ++k)
+        if (faces_[3 * f + k] != u)
+          neighbors.push_back(faces_[3 * f + k]);
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+
+    std::vector<double> target(dim_), scratch(space_.size() + dim_);
+    for (auto w : neighbors)
+      heap_.push({ collapseCost(u, w, &target[0], &scratch[0]), u, w, stamps_[u], stamps_[w] });
+  }
+
+  DecimatedMesh QuadricDecimation::snapshot(size_t level) const
+  {
+    std::vector<uint32_t> remap(vertexFaces_.size(), std::numeric_limits<uint32_t>::max());
+    std::vector<uint32_t> used, indices;
+    indices.reserve(aliveFaces_ * 3);
+    for (size_t f = 0; f < faceAlive_.size(); ++f)
+    {
+      if (!faceAlive_[f])
+        continue;
+      for (int k = 0; k < 3; ++k)
+      {
+        auto v = faces_[3 * f + k];
+        if (remap[v] == std::numeric_limits<uint32_t>::max())
+        {
+          remap[v] = static_cast<uint32_t>(used.size());
+          used.push_back(v);
+        }
+        indices.push_back(remap[v]);
+      }
+    }
+
+    std::vector<float> vertices(used.size() * layout_.stride);
+    const int numTasks = Parallel::NumTasks(used.size(), itemsPerTask);
+    std::vector<BBox> taskBounds(numTasks);
+    Parallel::RunRange(used.size(), numTasks, [&](int task, size_t begin, size_t end)
+    {
+      for (size_t n = begin; n < end; ++n)
+      {
+        const double* c = &coords_[used[n] * dim_];
+        float* out = &vertices[n * layout_.stride];
+        for (int i = 0; i < 3; ++i)
+          out[layout_.posOffset + i] = static_cast<float>(c[i]);
+        taskBounds[task].extend(Point(c[0], c[1], c[2]));
+        size_t d = 3;
+        for (const auto& a : layout_.attributes)
+        {
+          double length = 0;
+          for (size_t i = 0; i < a.floats; ++i)
+            length += c[d + i] * c[d + i];
+          double scale = a.isNormal && length > 0 ? 1.0 / std::sqrt(length) : 1.0 / attributeScale_;
+          for (size_t i = 0; i < a.floats; ++i, ++d)
+            out[a.offset + i] = static_cast<float>(c[d] * scale);
+        }
+      }
+    });
+
+    BBox bounds;
+    for (const auto& b : taskBounds)
+      if (b.valid())
+        bounds.extend(b);
+
+    auto vboData = std::make_shared<spire::VarBuffer>(vertices.size() * sizeof(float));
+    vboData->writeBytes(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(float));
+    auto iboData = std::make_shared<spire::VarBuffer>(indices.size() * sizeof(uint32_t));
+    iboData->writeBytes(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t));
+
+    const std::string suffix = "_LOD" + std::to_string(level + 1);
+    DecimatedMesh mesh;
+    mesh.vbo = SpireVBO(vbo_.name + suffix, vbo_.attributes, vboData, used.size(), bounds, true);
+    mesh.ibo = SpireIBO(ibo_.name + suffix, SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), iboData);
+    mesh.numTriangles = indices.size() / 3;
+    return mesh;
+  }
+
+  LevelsOfDetail QuadricDecimation::run()
+  {
+    weldVertices();
+    buildQuadrics();
+    buildCandidates();
+
+    LevelsOfDetail levels;
+    const size_t initialFaces = aliveFaces_;
+    size_t previousFaces = initialFaces;
+    std::vector<double> target(dim_), scratch(space_.size() + dim_);
+    for (auto ratio : options_.ratios)
+    {
+      const size_t targetFaces = static_cast<size_t>(ratio * initialFaces);
+      while (aliveFaces_ > targetFaces && !heap_.empty())
+      {
+        Candidate top = heap_.top();
+        heap_.pop();
+        if (top.stampU != stamps_[top.u] || top.stampW != stamps_[top.w]
+          || vertexFaces_[top.u].empty() || vertexFaces_[top.w].empty())
+          continue;
+        collapseCost(top.u, top.w, &target[0], &scratch[0]);
+        if (collapse(top.u, top.w, &target[0]))
+          pushCandidates(top.u);
+      }
+      if (aliveFaces_ < previousFaces)
+      {
+        levels.push_back(snapshot(levels.size()));
+        previousFaces = aliveFaces_;
+      }
+    }
+    return levels;
+  }
+}
+
+bool MeshDecimator::canDecimate(const SpireVBO& vbo, const SpireIBO& ibo, const DecimationOptions& options)
+{
+  if (!vbo.data || !ibo.data || ibo.indexSize != sizeof(uint32_t) || ibo.prim != SpireIBO::PRIMITIVE::TRIANGLES)
+    return false;
+  if (!VertexLayout(vbo).valid)
+    return false;
+  return ibo.data->getBufferSize() / (3 * sizeof(uint32_t)) >= options.minTriangles;
+}
+
+LevelsOfDetail MeshDecimator::decimate(const SpireVBO& vbo, const SpireIBO& ibo, const DecimationOptions& options)
+{
+  if (!vbo.data || !ibo.data || ibo.indexSize != sizeof(uint32_t) || ibo.prim != SpireIBO::PRIMITIVE::TRIANGLES
+    || !VertexLayout(vbo).valid)
+    return LevelsOfDetail();
+  QuadricDecimation decimation(vbo, ibo, options);
+  return decimation.run();
+}
+
+LevelOfDetailCache::LevelOfDetailCache(const DecimationOptions& options) : options_(options)
+{
+}
+
+LevelOfDetailCache::~LevelOfDetailCache()
+{
+  {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    stopping_ = true;
+    queue_.clear();
+  }
+  queueChanged_.notify_all();
+  if (worker_.joinable())
+    worker_.join();
+}
+
+void LevelOfDetailCache::runWorker()
+{
+  for (;;)
+  {
+    std::packaged_task<LevelsOfDetailHandle()> task;
+    {
+      std::unique_lock<std::mutex> lock(queueMutex_);
+      queueChanged_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+      if (stopping_)
+        return;
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    task();
+  }
+}
+
+bool LevelOfDetailCache::request(const std::string& geometryID, const SpireVBO& vbo, const SpireIBO& ibo)
+{
+  purgeExpired();
+  if (!MeshDecimator::canDecimate(vbo, ibo, options_))
+    return false;
+
+  auto it = entries_.find(geometryID);
+  if (it != entries_.end() && it->second.iboData.lock() == ibo.data && it->second.vboData.lock() == vbo.data)
+    return true;
+
+  // The task only holds weak references, so an object that is replaced before its turn does
+  // not keep its buffers alive and is skipped instead of decimated.
+  auto options = options_;
+  std::weak_ptr<spire::VarBuffer> vboData = vbo.data, iboData = ibo.data;
+  SpireVBO vboLayout = vbo;
+  SpireIBO iboLayout = ibo;
+  vboLayout.data.reset();
+  iboLayout.data.reset();
+  std::packaged_task<LevelsOfDetailHandle()> task([vboLayout, iboLayout, vboData, iboData, options]()
+  {
+    SpireVBO source = vboLayout;
+    SpireIBO indices = iboLayout;
+    source.data = vboData.lock();
+    indices.data = iboData.lock();
+    if (!source.data || !indices.data)
+      return std::make_shared<const LevelsOfDetail>();
+    return std::make_shared<const LevelsOfDetail>(MeshDecimator::decimate(source, indices, options));
+  });
+  Entry entry;
+  entry.vboData = vbo.data;
+  entry.iboData = ibo.data;
+  entry.result = task.get_future().share();
+  entries_[geometryID] = entry;
+
+  {
+    std::lock_guard<std::mutex> lock(queueMutex_);
+    queue_.push_back(std::move(task));
+  }
+  if (!worker_.joinable())
+    worker_ = std::thread(&LevelOfDetailCache::runWorker, this);
+  queueChanged_.notify_one();
+  return true;
+}
+
+bool LevelOfDetailCache::ready(const std::string& geometryID) const
+{
+  auto it = entries_.find(geometryID);
+  return it != entries_.end() && it->second.result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+LevelsOfDetailHandle LevelOfDetailCache::levels(const std::string& geometryID, const SpireIBO& ibo) const
+{
+  if (!ready(geometryID))
+    return nullptr;
+  const auto& entry = entries_.find(geometryID)->second;
+  return entry.iboData.lock() == ibo.data ? entry.result.get() : nullptr;
+}
+
+void LevelOfDetailCache::purgeExpired()
+{
+  for (auto it = entries_.begin(); it != entries_.end();)
+  {
+    if (it->second.iboData.expired() || it->second.vboData.expired())
+      it = entries_.erase(it);
+    else
+      ++it;
+  }
+}
@@ -0,0 +1,126 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef GRAPHICS_DATATYPES_MESHDECIMATION_H
+#define GRAPHICS_DATATYPES_MESHDECIMATION_H
+
+#include <Graphics/Datatypes/GeometryImpl.h>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Graphics/Datatypes/share.h>
+
+namespace SCIRun {
+  namespace Graphics {
+    namespace Datatypes {
+
+      struct SCISHARE DecimationOptions
+      {
+        /// Fraction of the input triangles kept by each level, finest first.
+        std::vector<double> ratios {0.5, 0.25, 0.1};
+        /// Weight of vertex attributes (normals, texture coordinates, colors) in the error
+        /// metric, relative to the diagonal of the mesh bounding box.
+        double attributeWeight {0.1};
+        /// Weight of the planes that pin open boundaries in place.
+        double boundaryWeight {100.0};
+        /// Surfaces with fewer triangles are drawn at full resolution only.
+        size_t minTriangles {20000};
+      };
+
+      /// One decimated version of a surface pass. The buffers use the source VBO's attribute
+      /// layout, so the pass's shader draws them unchanged.
+      struct SCISHARE DecimatedMesh
+      {
+        SpireVBO vbo;
+        SpireIBO ibo;
+        size_t numTriangles {0};
+      };
+
+      using LevelsOfDetail = std::vector<DecimatedMesh>;
+      using LevelsOfDetailHandle = std::shared_ptr<const LevelsOfDetail>;
+
+      /// Quadric error metric edge-collapse decimation (Garland & Heckbert) for ShowField-style
+      /// triangle VBO/IBO pairs. Vertices are welded by position, and normals, texture
+      /// coordinates and colors are carried in generalized quadrics so they are preserved
+      /// along with the shape. All levels come from a single collapse sequence.
+      class SCISHARE MeshDecimator
+      {
+      public:
+        static bool canDecimate(const SpireVBO& vbo, const SpireIBO& ibo, const DecimationOptions& options);
+        static LevelsOfDetail decimate(const SpireVBO& vbo, const SpireIBO& ibo, const DecimationOptions& options);
+      };
+
+      /// Builds levels of detail on a worker thread owned by the cache and keeps them per
+      /// geometry ID for as long as the source buffers are alive, so re-showing an object does
+      /// not decimate it again. Requests run in order; the destructor finishes the one in
+      /// progress, drops the rest and joins the worker.
+      class SCISHARE LevelOfDetailCache
+      {
+      public:
+        explicit LevelOfDetailCache(const DecimationOptions& options = DecimationOptions());
+        ~LevelOfDetailCache();
+
+        /// Starts decimating unless levels for these buffers are cached or already being built.
+        /// Returns false if the pass cannot be decimated.
+        bool request(const std::string& geometryID, const SpireVBO& vbo, const SpireIBO& ibo);
+        bool ready(const std::string& geometryID) const;
+        /// Finished levels for geometryID built from ibo, or null.
+        LevelsOfDetailHandle levels(const std::string& geometryID, const SpireIBO& ibo) const;
+        size_t size() const { return entries_.size(); }
+
+      private:
+        struct Entry
+        {
+          std::weak_ptr<spire::VarBuffer> vboData, iboData;
+          std::shared_future<LevelsOfDetailHandle> result;
+        };
+
+        void purgeExpired();
+        void runWorker();
+
+        DecimationOptions options_;
+        std::map<std::string, Entry> entries_;
+
+        std::mutex queueMutex_;
+        std::condition_variable queueChanged_;
+        std::deque<std::packaged_task<LevelsOfDetailHandle()>> queue_;
+        bool stopping_ {false};
+        std::thread worker_;
+      };
+
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,261 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Graphics/Datatypes/MeshDecimation.h>
+#include <Core/Thread/Parallel.h>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+using namespace SCIRun::Graphics::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  struct Surface
+  {
+    SpireVBO vbo;
+    SpireIBO ibo;
+  };
+
+  std::vector<SpireVBO::AttributeData> attributes(bool texCoords)
+  {
+    std::vector<SpireVBO::AttributeData> attribs { {"aPos", 3 * sizeof(float)}, {"aNormal", 3 * sizeof(float)} };
+    if (texCoords)
+      attribs.emplace_back("aTexCoords", 2 * sizeof(float));
+    return attribs;
+  }
+
+  Surface makeSurface(const std::vector<float>& vertices, const std::vector<uint32_t>& indices, bool texCoords)
+  {
+    auto vboData = std::make_shared<spire::VarBuffer>(vertices.size() * sizeof(float));
+    vboData->writeBytes(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(float));
+    auto iboData = std::make_shared<spire::VarBuffer>(indices.size() * sizeof(uint32_t));
+    iboData->writeBytes(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t));
+    Surface s;
+    s.vbo = SpireVBO("surfaceVBO", attributes(texCoords), vboData, vertices.size() / (texCoords ? 8 : 6), BBox(), true);
+    s.ibo = SpireIBO("surfaceIBO", SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), iboData);
+    return s;
+  }
+
+  // Unit square in z = 0 written the way ShowField writes face data: three vertices per
+  // triangle. Texture coordinate u is 0 left of x = 0.5 and 1 to the right of it.
+  Surface makeSquare(int n)
+  {
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    auto corner = [&](int i, int j, float u)
+    {
+      indices.push_back(static_cast<uint32_t>(vertices.size() / 8));
+      vertices.insert(vertices.end(), { float(i) / n, float(j) / n, 0.0f, 0.0f, 0.0f, 1.0f, u, 0.0f });
+    };
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j)
+      {
+        float u = 2 * i < n ? 0.0f : 1.0f;
+        corner(i, j, u); corner(i + 1, j, u); corner(i + 1, j + 1, u);
+        corner(i, j, u); corner(i + 1, j + 1, u); corner(i, j + 1, u);
+      }
+    return makeSurface(vertices, indices, true);
+  }
+
+  // Unit sphere with shared vertices and smooth normals.
+  Surface makeSphere(int rings, int segments)
+  {
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    for (int r = 0; r <= rings; ++r)
+      for (int s = 0; s <= segments; ++s)
+      {
+        double theta = M_PI * r / rings, phi = 2 * M_PI * s / segments;
+        float x = static_cast<float>(std::sin(theta) * std::cos(phi));
+        float y = static_cast<float>(std::sin(theta) * std::sin(phi));
+        float z = static_cast<float>(std::cos(theta));
+        vertices.insert(vertices.end(), { x, y, z, x, y, z });
+      }
+    for (int r = 0; r < rings; ++r)
+      for (int s = 0; s < segments; ++s)
+      {
+        uint32_t a = r * (segments + 1) + s, b = a + segments + 1;
+        indices.insert(indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+      }
+    return makeSurface(vertices, indices, false);
+  }
+
+  DecimationOptions smallMeshOptions()
+  {
+    DecimationOptions options;
+    options.minTriangles = 0;
+    return options;
+  }
+
+  template <class Check>
+  void forEachVertex(const DecimatedMesh& mesh, size_t stride, Check check)
+  {
+    const auto* v = reinterpret_cast<const float*>(mesh.vbo.data->getBuffer());
+    for (size_t i = 0; i < mesh.vbo.numElements; ++i)
+      check(v + i * stride);
+  }
+}
+
+TEST(MeshDecimationTests, LevelsShrinkTowardTheirRatios)
+{
+  auto sphere = makeSphere(60, 120);
+  auto options = smallMeshOptions();
+  auto levels = MeshDecimator::decimate(sphere.vbo, sphere.ibo, options);
+  const size_t input = sphere.ibo.data->getBufferSize() / 12;
+
+  ASSERT_EQ(options.ratios.size(), levels.size());
+  for (size_t k = 0; k < levels.size(); ++k)
+  {
+    EXPECT_LE(levels[k].numTriangles, static_cast<size_t>(options.ratios[k] * input) + 2);
+    EXPECT_GE(levels[k].numTriangles, static_cast<size_t>(0.9 * options.ratios[k] * input));
+    EXPECT_EQ(levels[k].numTriangles * 3 * sizeof(uint32_t), levels[k].ibo.data->getBufferSize());
+    EXPECT_EQ(sphere.vbo.attributes.size(), levels[k].vbo.attributes.size());
+    EXPECT_EQ("surfaceIBO_LOD" + std::to_string(k + 1), levels[k].ibo.name);
+  }
+}
+
+TEST(MeshDecimationTests, SphereKeepsItsShapeAndNormals)
+{
+  auto sphere = makeSphere(60, 120);
+  auto levels = MeshDecimator::decimate(sphere.vbo, sphere.ibo, smallMeshOptions());
+  ASSERT_FALSE(levels.empty());
+  for (const auto& level : levels)
+  {
+    forEachVertex(level, 6, [](const float* v)
+    {
+      Vector p(v[0], v[1], v[2]), n(v[3], v[4], v[5]);
+      EXPECT_NEAR(1.0, p.length(), 0.03);
+      EXPECT_NEAR(1.0, n.length(), 1e-4);
+      EXPECT_GT(Dot(p.safe_normal(), n), 0.98);
+    });
+  }
+}
+
+TEST(MeshDecimationTests, FlatSquareKeepsBoundaryAndTextureSeam)
+{
+  auto square = makeSquare(64);
+  auto levels = MeshDecimator::decimate(square.vbo, square.ibo, smallMeshOptions());
+  ASSERT_FALSE(levels.empty());
+  for (const auto& level : levels)
+  {
+    EXPECT_NEAR(0.0, level.vbo.boundingBox.get_min().x(), 1e-6);
+    EXPECT_NEAR(1.0, level.vbo.boundingBox.get_max().y(), 1e-6);
+    forEachVertex(level, 8, [](const float* v)
+    {
+      EXPECT_NEAR(0.0, v[2], 1e-6);
+      EXPECT_NEAR(1.0, v[5], 1e-6);
+    });
+
+    // No triangle may straddle the seam between the two texture regions.
+    const auto* v = reinterpret_cast<const float*>(level.vbo.data->getBuffer());
+    const auto* tri = reinterpret_cast<const uint32_t*>(level.ibo.data->getBuffer());
+    for (size_t f = 0; f < level.numTriangles; ++f)
+    {
+      float lo = 1, hi = 0;
+      for (int k = 0; k < 3; ++k)
+      {
+        lo = std::min(lo, v[tri[3 * f + k] * 8]);
+        hi = std::max(hi, v[tri[3 * f + k] * 8]);
+      }
+      EXPECT_TRUE(hi <= 0.5f + 1e-5f || lo >= 0.5f - 1e-5f) << lo << " " << hi;
+    }
+  }
+}
+
+TEST(MeshDecimationTests, OnlyLargeTriangleSurfacesAreDecimated)
+{
+  auto sphere = makeSphere(10, 20);
+  DecimationOptions options;
+  EXPECT_FALSE(MeshDecimator::canDecimate(sphere.vbo, sphere.ibo, options));
+  options.minTriangles = 100;
+  EXPECT_TRUE(MeshDecimator::canDecimate(sphere.vbo, sphere.ibo, options));
+  sphere.ibo.prim = SpireIBO::PRIMITIVE::LINES;
+  EXPECT_FALSE(MeshDecimator::canDecimate(sphere.vbo, sphere.ibo, options));
+}
+
+TEST(MeshDecimationTests, CacheBuildsOncePerGeometry)
+{
+  LevelOfDetailCache cache(smallMeshOptions());
+  auto sphere = makeSphere(20, 40);
+  ASSERT_TRUE(cache.request("sphere", sphere.vbo, sphere.ibo));
+  while (!cache.ready("sphere"))
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+  auto levels = cache.levels("sphere", sphere.ibo);
+  ASSERT_TRUE(levels != nullptr);
+  EXPECT_FALSE(levels->empty());
+  EXPECT_TRUE(cache.request("sphere", sphere.vbo, sphere.ibo));
+  EXPECT_TRUE(cache.ready("sphere"));
+  EXPECT_EQ(levels, cache.levels("sphere", sphere.ibo));
+
+  auto other = makeSphere(20, 40);
+  EXPECT_TRUE(cache.levels("sphere", other.ibo) == nullptr);
+
+  sphere = Surface();
+  EXPECT_TRUE(cache.request("other", other.vbo, other.ibo));
+  EXPECT_EQ(1u, cache.size());
+}
+
+TEST(MeshDecimationTests, CacheJoinsItsWorkerWhenDestroyed)
+{
+  auto sphere = makeSphere(20, 40), other = makeSphere(20, 40);
+  {
+    LevelOfDetailCache cache(smallMeshOptions());
+    ASSERT_TRUE(cache.request("sphere", sphere.vbo, sphere.ibo));
+    ASSERT_TRUE(cache.request("other", other.vbo, other.ibo));
+  }
+  // The worker is joined and queued requests only held weak references, so the buffers
+  // are owned by this test alone.
+  EXPECT_EQ(1, sphere.vbo.data.use_count());
+  EXPECT_EQ(1, sphere.ibo.data.use_count());
+  EXPECT_EQ(1, other.vbo.data.use_count());
+}
+
+TEST(MeshDecimationTests, SplittingWorkAcrossTasksGivesTheSameLevels)
+{
+  // Large enough that every pass is split into several ranges when cores are available.
+  auto sphere = makeSphere(120, 240);
+  Parallel::SetMaximumCores(1);
+  auto serial = MeshDecimator::decimate(sphere.vbo, sphere.ibo, DecimationOptions());
+  Parallel::SetMaximumCores(0);
+  auto parallel = MeshDecimator::decimate(sphere.vbo, sphere.ibo, DecimationOptions());
+
+  ASSERT_EQ(serial.size(), parallel.size());
+  ASSERT_FALSE(serial.empty());
+  for (size_t k = 0; k < serial.size(); ++k)
+  {
+    EXPECT_EQ(serial[k].numTriangles, parallel[k].numTriangles);
+    EXPECT_EQ(serial[k].vbo.numElements, parallel[k].vbo.numElements);
+    if (k > 0)
+      EXPECT_LT(serial[k].numTriangles, serial[k - 1].numTriangles);
+  }
+}
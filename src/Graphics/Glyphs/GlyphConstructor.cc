@@ -26,12 +26,21 @@
 */
 
 #include<Graphics/Glyphs/GlyphConstructor.h>
+#include <Core/Thread/Parallel.h>
+#include <numeric>
 
 using namespace SCIRun;
 using namespace Graphics;
 using namespace Core::Geometry;
 using namespace Core::Datatypes;
 using namespace Graphics::Datatypes;
+using namespace Core::Thread;
+
+namespace
+{
+  // Below this many points or indices per thread the copy is cheaper than spawning threads.
+  const size_t minBufferItemsPerTask = 1 << 14;
+}
 
 GlyphConstructor::GlyphConstructor()
 {}
@@ -74,20 +83,7 @@ void GlyphConstructor::buildObject(GeometryObjectSpire& geom, const std::string&
       numAttributes += 2;
       shader += "_ColorMap";
       attribs.push_back(SpireVBO::AttributeData("aTexCoords", 2 * sizeof(float)));
-
-      const static int colorMapResolution = 256;
-      for(int i = 0; i < colorMapResolution; ++i)
-      {
-        ColorRGB color = colorMap->valueToColor(static_cast<float>(i)/colorMapResolution * 2.0f - 1.0f);
-        texture.bitmap.push_back(color.r()*255.99f);
-        texture.bitmap.push_back(color.g()*255.99f);
-        texture.bitmap.push_back(color.b()*255.99f);
-        texture.bitmap.push_back(color.a()*255.99f);
-      }
-
-      texture.name = "ColorMap";
-      texture.height = 1;
-      texture.width = colorMapResolution;
+      texture = colorMapTexture(colorMap);
     }
     else
     {
@@ -126,42 +122,79 @@ void GlyphConstructor::buildObject(GeometryObjectSpire& geom, const std::string&
     auto iboBuffer = iboBufferSPtr.get();
     auto vboBuffer = vboBufferSPtr.get();
 
-    for (auto a : indices_) if(a >= startOfPass && a < endOfPass)
-      iboBuffer->write(static_cast<uint32_t>(a - startOfPass));
-
-    BBox newBBox;
-    for (size_t i = startOfPass; i < endOfPass; ++i)
+    // Indices that fall in this pass: count per task, prefix-sum, then fill in place so the
+    // order matches a serial scan.
+    const int numIndexTasks = Parallel::NumTasks(indices_.size(), minBufferItemsPerTask);
+    std::vector<size_t> indexOffsets(numIndexTasks + 1, 0);
+    Parallel::RunRange(indices_.size(), numIndexTasks, [&](int task, size_t begin, size_t end)
     {
-      Vector point = points_.at(i);
-      newBBox.extend(Point(point.x(), point.y(), point.z()));
-      vboBuffer->write(static_cast<float>(point.x()));
-      vboBuffer->write(static_cast<float>(point.y()));
-      vboBuffer->write(static_cast<float>(point.z()));
-
-      if (useNormals)
+      size_t count = 0;
+      for (size_t i = begin; i < end; ++i)
+        if (indices_[i] >= startOfPass && indices_[i] < endOfPass) ++count;
+      indexOffsets[task + 1] = count;
+    });
+    std::partial_sum(indexOffsets.begin(), indexOffsets.end(), indexOffsets.begin());
+
+    std::vector<uint32_t> passIndices(indexOffsets.back());
+    Parallel::RunRange(indices_.size(), numIndexTasks, [&](int task, size_t begin, size_t end)
+    {
+      uint32_t* out = passIndices.data() + indexOffsets[task];
+      for (size_t i = begin; i < end; ++i)
+        if (indices_[i] >= startOfPass && indices_[i] < endOfPass)
+          *out++ = static_cast<uint32_t>(indices_[i] - startOfPass);
+    });
+    iboBuffer->writeBytes(reinterpret_cast<const char*>(passIndices.data()), passIndices.size() * sizeof(uint32_t));
+
+    // Every point has the same stride, so each task writes its own slice of the VBO.
+    std::vector<float> vertices(static_cast<size_t>(pointsInThisPass) * numAttributes);
+    const int numPointTasks = Parallel::NumTasks(pointsInThisPass, minBufferItemsPerTask);
+    std::vector<BBox> taskBBoxes(numPointTasks);
+    Parallel::RunRange(pointsInThisPass, numPointTasks, [&](int task, size_t begin, size_t end)
+    {
+      float* out = vertices.data() + begin * numAttributes;
+      BBox& taskBBox = taskBBoxes[task];
+      for (size_t i = startOfPass + begin; i < startOfPass + end; ++i)
       {
-        Vector normal = normals_.at(i);
-        vboBuffer->write(static_cast<float>(normal.x()));
-        vboBuffer->write(static_cast<float>(normal.y()));
-        vboBuffer->write(static_cast<float>(normal.z()));
-      }
+        const Vector& point = points_[i];
+        taskBBox.extend(Point(point.x(), point.y(), point.z()));
+        *out++ = static_cast<float>(point.x());
+        *out++ = static_cast<float>(point.y());
+        *out++ = static_cast<float>(point.z());
 
-      if (useColor)
-      {
-        ColorRGB color = colors_.at(i);
-        if(!colorMap)
+        if (useNormals)
         {
-          vboBuffer->write(static_cast<float>(color.r()));
-          vboBuffer->write(static_cast<float>(color.g()));
-          vboBuffer->write(static_cast<float>(color.b()));
-          vboBuffer->write(static_cast<float>(color.a()));
+          const Vector& normal = normals_[i];
+          *out++ = static_cast<float>(normal.x());
+          *out++ = static_cast<float>(normal.y());
+          *out++ = static_cast<float>(normal.z());
         }
-        else
+
+        if (useColor)
         {
-          vboBuffer->write(static_cast<float>(color.r()));
-          vboBuffer->write(static_cast<float>(color.r()));
+          const ColorRGB& color = colors_[i];
+          if(!colorMap)
+          {
+            *out++ = static_cast<float>(color.r());
+            *out++ = static_cast<float>(color.g());
+            *out++ = static_cast<float>(color.b());
+            *out++ = static_cast<float>(color.a());
+          }
+          else
+          {
+            *out++ = static_cast<float>(color.r());
+            *out++ = static_cast<float>(color.r());
+          }
         }
       }
+    });
+    vboBuffer->writeBytes(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(float));
+
+    BBox newBBox;
+    for (const auto& taskBBox : taskBBoxes)
+    {
+      if (!taskBBox.valid()) continue;
+      newBBox.extend(taskBBox.get_min());
+      newBBox.extend(taskBBox.get_max());
     }
     if(!bbox.valid()) newBBox.reset();
 
@@ -182,6 +215,25 @@ void GlyphConstructor::buildObject(GeometryObjectSpire& geom, const std::string&
   }
 }
 
+SpireTexture2D GlyphConstructor::colorMapTexture(const Core::Datatypes::ColorMapHandle colorMap)
+{
+  SpireTexture2D texture;
+  const static int colorMapResolution = 256;
+  for(int i = 0; i < colorMapResolution; ++i)
+  {
+    ColorRGB color = colorMap->valueToColor(static_cast<float>(i)/colorMapResolution * 2.0f - 1.0f);
+    texture.bitmap.push_back(color.r()*255.99f);
+    texture.bitmap.push_back(color.g()*255.99f);
+    texture.bitmap.push_back(color.b()*255.99f);
+    texture.bitmap.push_back(color.a()*255.99f);
+  }
+
+  texture.name = "ColorMap";
+  texture.height = 1;
+  texture.width = colorMapResolution;
+  return texture;
+}
+
 uint32_t GlyphConstructor::setOffset()
 {
   offset_ = numVBOElements_;
@@ -268,3 +320,45 @@ void GlyphConstructor::popIndicesNTimes(int n)
   for (int i = 0; i < n; ++i)
     indices_.pop_back();
 }
+
+void GlyphConstructor::append(const std::vector<const GlyphConstructor*>& parts)
+{
+  const size_t numParts = parts.size();
+  std::vector<size_t> pointOffsets(numParts + 1, points_.size());
+  std::vector<size_t> normalOffsets(numParts + 1, normals_.size());
+  std::vector<size_t> indexOffsets(numParts + 1, indices_.size());
+  for (size_t p = 0; p < numParts; ++p)
+  {
+    pointOffsets[p + 1] = pointOffsets[p] + parts[p]->points_.size();
+    normalOffsets[p + 1] = normalOffsets[p] + parts[p]->normals_.size();
+    indexOffsets[p + 1] = indexOffsets[p] + parts[p]->indices_.size();
+  }
+
+  points_.resize(pointOffsets.back());
+  colors_.resize(pointOffsets.back());
+  normals_.resize(normalOffsets.back());
+  indices_.resize(indexOffsets.back());
+
+  // Indices of a part are relative to its own first point, which now sits at pointOffsets[p].
+  Parallel::RunRange(numParts, Parallel::NumTasks(numParts, 1), [&](int, size_t begin, size_t end)
+  {
+    for (size_t p = begin; p < end; ++p)
+    {
+      const auto& part = *parts[p];
+      std::copy(part.points_.begin(), part.points_.end(), points_.begin() + pointOffsets[p]);
+      std::copy(part.colors_.begin(), part.colors_.end(), colors_.begin() + pointOffsets[p]);
+      std::copy(part.normals_.begin(), part.normals_.end(), normals_.begin() + normalOffsets[p]);
+      const size_t shift = pointOffsets[p];
+      auto out = indices_.begin() + indexOffsets[p];
+      for (auto index : part.indices_)
+        *out++ = index + shift;
+    }
+  });
+
+  for (const auto part : parts)
+  {
+    numVBOElements_ += part->numVBOElements_;
+    lineIndex_ += part->lineIndex_;
+  }
+  offset_ = static_cast<uint32_t>(numVBOElements_);
+}
@@ -41,6 +41,7 @@ namespace SCIRun {
 namespace Graphics {
 class SCISHARE GlyphConstructor
 {
+  friend class InstancedGlyphGeom;
 public:
   GlyphConstructor();
   void buildObject(Graphics::Datatypes::GeometryObjectSpire& geom, const std::string& uniqueNodeID,
@@ -67,6 +68,13 @@ public:
   size_t getCurrentIndex() const;
   void popIndicesNTimes(int n);
 
+  /// Appends the geometry of each part, in order, exactly as if it had been added to this
+  /// constructor directly. Sizes are prefix-summed so the parts are copied in parallel.
+  void append(const std::vector<const GlyphConstructor*>& parts);
+
+  /// 1D texture sampled by the _ColorMap shaders.
+  static Graphics::Datatypes::SpireTexture2D colorMapTexture(const Core::Datatypes::ColorMapHandle colorMap);
+
 private:
   std::vector<SinCosTable> tables_;
   std::vector<Core::Geometry::Vector> points_;
@@ -31,6 +31,7 @@
 #include <Graphics/Glyphs/TensorGlyphBuilder.h>
 #include <Core/Datatypes/ColorMap.h>
 #include <Core/Math/MiscMath.h>
+#include <Core/Thread/Parallel.h>
 
 using namespace SCIRun;
 using namespace Graphics;
@@ -266,3 +267,35 @@ void GlyphGeom::generatePlane(const Point& p1, const Point& p2,
   constructor_.addIndicesToOffset(0, 1, 2);
   constructor_.addIndicesToOffset(2, 3, 0);
 }
+
+void GlyphGeom::append(const std::vector<GlyphGeom>& parts)
+{
+  std::vector<const GlyphConstructor*> constructors;
+  constructors.reserve(parts.size());
+  for (const auto& part : parts)
+    constructors.push_back(&part.constructor_);
+  constructor_.append(constructors);
+}
+
+int GlyphGeom::numParallelTasks(size_t count)
+{
+  // a glyph is tens to thousands of vertices, so fairly small ranges already pay off
+  return Core::Thread::Parallel::NumTasks(count, 256);
+}
+
+void GlyphGeom::addInParallel(size_t count, const std::function<void(GlyphGeom&, size_t, size_t)>& fill)
+{
+  const int numTasks = numParallelTasks(count);
+  if (numTasks == 1)
+  {
+    fill(*this, 0, count);
+    return;
+  }
+
+  std::vector<GlyphGeom> parts(numTasks);
+  Core::Thread::Parallel::RunRange(count, numTasks, [&](int task, size_t begin, size_t end)
+  {
+    fill(parts[task], begin, end);
+  });
+  append(parts);
+}
@@ -36,6 +36,7 @@
 #include <Graphics/Datatypes/GeometryImpl.h>
 #include <Core/Datatypes/Color.h>
 #include <Graphics/Glyphs/GlyphConstructor.h>
+#include <functional>
 
 #include <Graphics/Glyphs/share.h>
 
@@ -43,6 +44,7 @@ namespace SCIRun {
 namespace Graphics {
 class SCISHARE GlyphGeom
 {
+  friend class InstancedGlyphGeom;
 private:
   GlyphConstructor constructor_;
 
@@ -109,6 +111,15 @@ public:
   void generatePlane(const Core::Geometry::Point& p1, const Core::Geometry::Point& p2,
                      const Core::Geometry::Point& p3, const Core::Geometry::Point& p4,
                      const Core::Datatypes::ColorRGB& color);
+
+  /// Appends the glyphs of each part, in order.
+  void append(const std::vector<GlyphGeom>& parts);
+  /// Splits [0, count) into contiguous ranges, lets fill(glyphs, begin, end) add each range to
+  /// its own GlyphGeom on a worker thread, then appends the ranges in order. The result is the
+  /// same as a serial loop over [0, count) whatever the number of threads.
+  void addInParallel(size_t count, const std::function<void(GlyphGeom&, size_t, size_t)>& fill);
+  /// Number of ranges addInParallel splits count items into.
+  static int numParallelTasks(size_t count);
 };
 }}
 
@@ -0,0 +1,345 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Graphics/Glyphs/InstancedGlyphGeom.h>
+#include <Graphics/Glyphs/GlyphGeom.h>
+#include <Graphics/Glyphs/TensorGlyphBuilder.h>
+#include <Core/GeometryPrimitives/BBox.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Thread/Mutex.h>
+#include <Core/Thread/Parallel.h>
+#include <map>
+#include <sstream>
+
+using namespace SCIRun;
+using namespace Graphics;
+using namespace Graphics::Datatypes;
+using namespace Core::Geometry;
+using namespace Core::Datatypes;
+using namespace Core::Thread;
+
+namespace
+{
+  const size_t floatsPerTransform = 12;
+}
+
+InstancedGlyphGeom::TemplateHandle InstancedGlyphGeom::makeTemplate(Shape shape, int resolution,
+  double arrowHeadRatio, bool renderBase1, bool renderBase2)
+{
+  static const Point origin(0, 0, 0), tip(0, 0, 1);
+  ColorRGB white(1.0, 1.0, 1.0);
+  Tensor unit;
+  unit.set_outside_eigens(Vector(1, 0, 0), Vector(0, 1, 0), Vector(0, 0, 1), 1.0, 1.0, 1.0);
+
+  GlyphGeom glyph;
+  switch (shape)
+  {
+    case Shape::SPHERE:
+      glyph.addSphere(origin, 1.0, resolution, white);
+      break;
+    case Shape::ARROW:
+      glyph.addArrow(origin, tip, 1.0, arrowHeadRatio, resolution, white, white, renderBase1, renderBase2);
+      break;
+    case Shape::CONE:
+      glyph.addCone(origin, tip, 1.0, resolution, renderBase1, white, white);
+      break;
+    case Shape::DISK:
+      glyph.addDisk(origin, tip, 1.0, resolution, white, white);
+      break;
+    case Shape::ELLIPSOID:
+      glyph.addEllipsoid(origin, unit, 1.0, resolution, white, false);
+      break;
+    case Shape::BOX:
+      glyph.addBox(origin, unit, 1.0, white, false);
+      break;
+  }
+
+  auto result = std::make_shared<Template>();
+  const auto& constructor = glyph.constructor_;
+  result->vertices.reserve(constructor.points_.size() * 6);
+  for (size_t i = 0; i < constructor.points_.size(); ++i)
+  {
+    const Vector& p = constructor.points_[i];
+    const Vector& n = constructor.normals_[i];
+    result->bounds.extend(Point(p));
+    for (double x : {p.x(), p.y(), p.z(), n.x(), n.y(), n.z()})
+      result->vertices.push_back(static_cast<float>(x));
+  }
+  result->indices.assign(constructor.indices_.begin(), constructor.indices_.end());
+  return result;
+}
+
+InstancedGlyphGeom::InstancedGlyphGeom(Shape shape, int resolution, double arrowHeadRatio,
+  bool renderBase1, bool renderBase2) :
+  template_(getTemplate(shape, resolution, arrowHeadRatio, renderBase1, renderBase2))
+{
+}
+
+InstancedGlyphGeom::InstancedGlyphGeom(TemplateHandle templateMesh) :
+  template_(templateMesh)
+{
+}
+
+InstancedGlyphGeom::TemplateHandle InstancedGlyphGeom::getTemplate(Shape shape, int resolution,
+  double arrowHeadRatio, bool renderBase1, bool renderBase2)
+{
+  static Mutex lock("InstancedGlyphGeom templates");
+  static std::map<std::string, TemplateHandle> templates;
+
+  std::ostringstream key;
+  key << static_cast<int>(shape) << ':' << resolution << ':' << arrowHeadRatio << ':'
+      << renderBase1 << ':' << renderBase2;
+
+  Guard g(lock.get());
+  auto& cached = templates[key.str()];
+  if (!cached)
+    cached = makeTemplate(shape, resolution, arrowHeadRatio, renderBase1, renderBase2);
+  return cached;
+}
+
+void InstancedGlyphGeom::addInstance(const Vector& c0, const Vector& c1, const Vector& c2,
+  const Point& origin, const ColorRGB& color)
+{
+  for (int row = 0; row < 3; ++row)
+  {
+    transforms_.push_back(static_cast<float>(c0[row]));
+    transforms_.push_back(static_cast<float>(c1[row]));
+    transforms_.push_back(static_cast<float>(c2[row]));
+    transforms_.push_back(static_cast<float>(origin(row)));
+  }
+  colors_.push_back(color);
+}
+
+void InstancedGlyphGeom::addSphere(const Point& center, double radius, const ColorRGB& color)
+{
+  if (radius < 0) radius = 1.0;
+  addInstance(Vector(radius, 0, 0), Vector(0, radius, 0), Vector(0, 0, radius), center, color);
+}
+
+void InstancedGlyphGeom::addAxial(const Point& p1, const Point& p2, double radius, const ColorRGB& color)
+{
+  if (radius < 0) radius = 1.0;
+  Vector axis = p2 - p1;
+  const double length = axis.length();
+  Vector w = length > 0 ? axis / length : Vector(0, 0, 1);
+  Vector u = w.getArbitraryTangent().normal();
+  Vector v = Cross(w, u);
+  addInstance(u * radius, v * radius, w * length, p1, color);
+}
+
+void InstancedGlyphGeom::addTensor(const Point& center, const Tensor& t, double scale, bool normalize,
+  const ColorRGB& color)
+{
+  TensorGlyphBuilder builder(t, center);
+  if (normalize)
+    builder.normalizeTensor();
+  builder.scaleTensor(scale);
+  builder.makeTensorPositive();
+  auto axes = builder.getInstanceAxes();
+  addInstance(axes[0], axes[1], axes[2], center, color);
+}
+
+void InstancedGlyphGeom::append(const std::vector<InstancedGlyphGeom>& parts)
+{
+  size_t numTransforms = transforms_.size(), numColors = colors_.size();
+  for (const auto& part : parts)
+  {
+    numTransforms += part.transforms_.size();
+    numColors += part.colors_.size();
+  }
+  transforms_.reserve(numTransforms);
+  colors_.reserve(numColors);
+  for (const auto& part : parts)
+  {
+    transforms_.insert(transforms_.end(), part.transforms_.begin(), part.transforms_.end());
+    colors_.insert(colors_.end(), part.colors_.begin(), part.colors_.end());
+  }
+}
+
+void InstancedGlyphGeom::addInParallel(size_t count,
+  const std::function<void(InstancedGlyphGeom&, size_t, size_t)>& fill)
+{
+  const int numTasks = GlyphGeom::numParallelTasks(count);
+  if (numTasks <= 1)
+  {
+    fill(*this, 0, count);
+    return;
+  }
+
+  std::vector<InstancedGlyphGeom> parts;
+  parts.reserve(numTasks);
+  for (int task = 0; task < numTasks; ++task)
+    parts.push_back(InstancedGlyphGeom(template_));
+  Parallel::RunRange(count, numTasks, [&](int task, size_t begin, size_t end)
+  {
+    fill(parts[task], begin, end);
+  });
+  append(parts);
+}
+
+size_t InstancedGlyphGeom::bufferSizeInBytes(bool useColorMap) const
+{
+  const size_t floatsPerInstance = floatsPerTransform + (useColorMap ? 2 : 4);
+  return (template_->vertices.size() + numInstances() * floatsPerInstance) * sizeof(float)
+    + template_->indices.size() * sizeof(uint32_t);
+}
+
+void InstancedGlyphGeom::buildObject(GeometryObjectSpire& geom, const std::string& uniqueNodeID,
+  const bool isTransparent, const double transparencyValue, const ColorScheme& colorScheme,
+  RenderState state, const BBox& bbox, const bool isClippable, const ColorMapHandle colorMap)
+{
+  if (colors_.empty())
+    return;
+
+  const bool useColorMap = colorScheme == ColorScheme::COLOR_MAP && colorMap;
+  const bool useInSitu = colorScheme == ColorScheme::COLOR_IN_SITU || (colorScheme == ColorScheme::COLOR_MAP && !colorMap);
+  const ColorRGB dft = state.defaultColor;
+
+  // Uniformly coloured glyphs carry the default colour per instance so the same program serves
+  // all schemes.
+  std::string shader = useColorMap ? "Shaders/Phong_ColorMap" : "Shaders/Phong_Color";
+  shader += InstancedProgramSuffix;
+
+  std::vector<SpireSubPass::Uniform> uniforms;
+  uniforms.push_back(SpireSubPass::Uniform("uUseClippingPlanes", isClippable));
+  uniforms.push_back(SpireSubPass::Uniform("uUseFog", true));
+  uniforms.push_back(SpireSubPass::Uniform("uAmbientColor", glm::vec4(0.1f, 0.1f, 0.1f, 1.0f)));
+  uniforms.push_back(SpireSubPass::Uniform("uSpecularColor", glm::vec4(0.1f, 0.1f, 0.1f, 0.1f)));
+  uniforms.push_back(SpireSubPass::Uniform("uSpecularPower", 32.0f));
+  if (isTransparent) uniforms.push_back(SpireSubPass::Uniform("uTransparency", static_cast<float>(transparencyValue)));
+
+  SpireText text;
+  SpireTexture2D texture;
+  if (useColorMap)
+    texture = GlyphConstructor::colorMapTexture(colorMap);
+
+  const std::string passID = uniqueNodeID + "_0";
+  const std::string vboName = passID + "VBO";
+  const std::string iboName = passID + "IBO";
+  const std::string passName = passID + "Pass";
+
+  std::vector<SpireVBO::AttributeData> attribs;
+  attribs.push_back(SpireVBO::AttributeData("aPos", 3 * sizeof(float)));
+  attribs.push_back(SpireVBO::AttributeData("aNormal", 3 * sizeof(float)));
+
+  const auto& vertices = template_->vertices;
+  const auto& indices = template_->indices;
+  std::shared_ptr<spire::VarBuffer> vboBuffer(new spire::VarBuffer(vertices.size() * sizeof(float)));
+  vboBuffer->writeBytes(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(float));
+  std::shared_ptr<spire::VarBuffer> iboBuffer(new spire::VarBuffer(indices.size() * sizeof(uint32_t)));
+  iboBuffer->writeBytes(reinterpret_cast<const char*>(indices.data()), indices.size() * sizeof(uint32_t));
+
+  // Instance data and bounds: the template box is carried through each transform as a centre
+  // and a half extent, so no template vertex is visited per instance.
+  SpireInstances instances;
+  instances.name = passID + "Instances";
+  instances.count = colors_.size();
+  for (int row = 0; row < 3; ++row)
+    instances.attributes.push_back(SpireVBO::AttributeData("aInstanceRow" + std::to_string(row), 4 * sizeof(float)));
+  if (useColorMap)
+    instances.attributes.push_back(SpireVBO::AttributeData("aInstanceTexCoords", 2 * sizeof(float)));
+  else
+    instances.attributes.push_back(SpireVBO::AttributeData("aInstanceColor", 4 * sizeof(float)));
+
+  const size_t floatsPerInstance = floatsPerTransform + (useColorMap ? 2 : 4);
+  std::vector<float> instanceData(instances.count * floatsPerInstance);
+  const Vector templateCenter(template_->bounds.center());
+  const Vector templateExtent = template_->bounds.diagonal() * 0.5;
+  const int numTasks = GlyphGeom::numParallelTasks(instances.count);
+  std::vector<BBox> taskBBoxes(numTasks);
+  Parallel::RunRange(instances.count, numTasks, [&](int task, size_t begin, size_t end)
+  {
+    BBox& taskBBox = taskBBoxes[task];
+    for (size_t k = begin; k < end; ++k)
+    {
+      const float* m = &transforms_[k * floatsPerTransform];
+      float* out = &instanceData[k * floatsPerInstance];
+      std::copy(m, m + floatsPerTransform, out);
+      out += floatsPerTransform;
+
+      const ColorRGB& color = colors_[k];
+      if (useColorMap)
+      {
+        *out++ = static_cast<float>(color.r());
+        *out++ = static_cast<float>(color.r());
+      }
+      else if (useInSitu)
+      {
+        *out++ = static_cast<float>(color.r());
+        *out++ = static_cast<float>(color.g());
+        *out++ = static_cast<float>(color.b());
+        *out++ = static_cast<float>(color.a());
+      }
+      else
+      {
+        *out++ = static_cast<float>(dft.r());
+        *out++ = static_cast<float>(dft.g());
+        *out++ = static_cast<float>(dft.b());
+        *out++ = static_cast<float>(transparencyValue);
+      }
+
+      Point center, extent;
+      for (int row = 0; row < 3; ++row)
+      {
+        const float* r = m + 4 * row;
+        center(row) = r[0] * templateCenter.x() + r[1] * templateCenter.y() + r[2] * templateCenter.z() + r[3];
+        extent(row) = std::abs(r[0]) * templateExtent.x() + std::abs(r[1]) * templateExtent.y()
+          + std::abs(r[2]) * templateExtent.z();
+      }
+      taskBBox.extend(center - Vector(extent));
+      taskBBox.extend(center + Vector(extent));
+    }
+  });
+
+  instances.data.reset(new spire::VarBuffer(instanceData.size() * sizeof(float)));
+  instances.data->writeBytes(reinterpret_cast<const char*>(instanceData.data()), instanceData.size() * sizeof(float));
+
+  BBox newBBox;
+  for (const auto& taskBBox : taskBBoxes)
+  {
+    if (!taskBBox.valid()) continue;
+    newBBox.extend(taskBBox.get_min());
+    newBBox.extend(taskBBox.get_max());
+  }
+  if (!bbox.valid()) newBBox.reset();
+
+  SpireVBO geomVBO(vboName, attribs, vboBuffer, vertices.size() / 6, newBBox, true);
+  SpireIBO geomIBO(iboName, SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), iboBuffer);
+
+  state.set(RenderState::IS_ON, true);
+  state.set(RenderState::HAS_DATA, true);
+  SpireSubPass pass(passName, vboName, iboName, shader, colorScheme, state, RenderType::RENDER_VBO_IBO,
+                    geomVBO, geomIBO, text, texture);
+  pass.instances = instances;
+  for (const auto& uniform : uniforms) pass.addUniform(uniform);
+
+  geom.vbos().push_back(geomVBO);
+  geom.ibos().push_back(geomIBO);
+  geom.passes().push_back(pass);
+}
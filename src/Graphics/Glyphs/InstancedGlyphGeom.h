@@ -0,0 +1,117 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef Graphics_Glyphs_InstancedGlyphGeom_H
+#define Graphics_Glyphs_InstancedGlyphGeom_H
+
+#include <Core/Algorithms/Visualization/RenderFieldState.h>
+#include <Core/GeometryPrimitives/GeomFwd.h>
+#include <Core/GeometryPrimitives/Tensor.h>
+#include <Core/Datatypes/Color.h>
+#include <Core/Datatypes/ColorMap.h>
+#include <Graphics/Datatypes/GeometryImpl.h>
+#include <functional>
+
+#include <Graphics/Glyphs/share.h>
+
+namespace SCIRun {
+namespace Graphics {
+
+/// Glyphs drawn as instances of one template mesh. The template is tessellated once per glyph
+/// type and resolution (and cached across calls); each glyph only stores an affine transform
+/// that takes the template to its place, size and orientation, plus its colour. The pass built
+/// by buildObject is expanded on the CPU by the renderer when it cannot draw instances.
+class SCISHARE InstancedGlyphGeom
+{
+public:
+  enum class Shape
+  {
+    SPHERE,     ///< Unit sphere at the origin.
+    ARROW,      ///< Arrow from the origin to +z, head radius 1.
+    CONE,       ///< Cone from the origin to +z, base radius 1.
+    DISK,       ///< Capped cylinder from the origin to +z, radius 1.
+    ELLIPSOID,  ///< Unit sphere tessellated as a tensor ellipsoid.
+    BOX         ///< Cube [-1, 1]^3.
+  };
+
+  /// \param arrowHeadRatio, renderBase1, renderBase2 only apply to the shapes that use them.
+  InstancedGlyphGeom(Shape shape, int resolution, double arrowHeadRatio = 0.0,
+                     bool renderBase1 = false, bool renderBase2 = false);
+
+  void addSphere(const Core::Geometry::Point& center, double radius,
+                 const Core::Datatypes::ColorRGB& color);
+  /// Arrow, cone or disk along p1 -> p2.
+  void addAxial(const Core::Geometry::Point& p1, const Core::Geometry::Point& p2, double radius,
+                const Core::Datatypes::ColorRGB& color);
+  /// Ellipsoid or box scaled and rotated into the tensor's eigen frame, prepared exactly as
+  /// GlyphGeom::addEllipsoid and GlyphGeom::addBox prepare the tensor.
+  void addTensor(const Core::Geometry::Point& center, const Core::Geometry::Tensor& t, double scale,
+                 bool normalize, const Core::Datatypes::ColorRGB& color);
+
+  /// Appends the instances of each part, in order. Parts must share this template.
+  void append(const std::vector<InstancedGlyphGeom>& parts);
+  /// Same contract as GlyphGeom::addInParallel.
+  void addInParallel(size_t count,
+                     const std::function<void(InstancedGlyphGeom&, size_t, size_t)>& fill);
+
+  size_t numInstances() const { return colors_.size(); }
+  /// Bytes of the template and per-instance buffers buildObject uploads.
+  size_t bufferSizeInBytes(bool useColorMap) const;
+
+  void buildObject(Datatypes::GeometryObjectSpire& geom, const std::string& uniqueNodeID,
+                   const bool isTransparent, const double transparencyValue,
+                   const Datatypes::ColorScheme& colorScheme, RenderState state,
+                   const Core::Geometry::BBox& bbox, const bool isClippable = true,
+                   const Core::Datatypes::ColorMapHandle colorMap = nullptr);
+
+  struct Template
+  {
+    std::vector<float> vertices;  ///< Position and normal per vertex.
+    std::vector<uint32_t> indices;
+    Core::Geometry::BBox bounds;
+  };
+  using TemplateHandle = std::shared_ptr<const Template>;
+
+private:
+  explicit InstancedGlyphGeom(TemplateHandle templateMesh);
+  static TemplateHandle getTemplate(Shape shape, int resolution, double arrowHeadRatio,
+                                    bool renderBase1, bool renderBase2);
+  static TemplateHandle makeTemplate(Shape shape, int resolution, double arrowHeadRatio,
+                                     bool renderBase1, bool renderBase2);
+  void addInstance(const Core::Geometry::Vector& c0, const Core::Geometry::Vector& c1,
+                   const Core::Geometry::Vector& c2, const Core::Geometry::Point& origin,
+                   const Core::Datatypes::ColorRGB& color);
+
+  TemplateHandle template_;
+  std::vector<float> transforms_;  ///< Three rows of a 3x4 affine transform per instance.
+  std::vector<Core::Datatypes::ColorRGB> colors_;
+};
+
+}}
+
+#endif
@@ -210,6 +210,15 @@ void TensorGlyphBuilder::generateEllipsoid(GlyphConstructor& constructor, bool h
   }
 }
 
+std::vector<Vector> TensorGlyphBuilder::getInstanceAxes()
+{
+  auto eigvecs = getEigenVectors();
+  auto eigvals = getEigenValues();
+  for (int d = 0; d < DIMENSIONS_; ++d)
+    eigvecs[d] = eigvecs[d].safe_normal() * eigvals[d];
+  return eigvecs;
+}
+
 Point TensorGlyphBuilder::evaluateEllipsoidPoint(double sinPhi, double cosPhi,
                                                  double sinTheta, double cosTheta)
 {
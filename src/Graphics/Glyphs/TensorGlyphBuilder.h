@@ -54,6 +54,9 @@ public:
   void generateSuperquadricSurface(GlyphConstructor& constructor, double A, double B);
   void generateEllipsoid(GlyphConstructor& constructor, bool half);
   void generateBox(GlyphConstructor& constructor);
+  /// Eigenvectors scaled by their eigenvalues: the columns of the linear part of the transform
+  /// that takes a unit glyph to this tensor's glyph.
+  std::vector<Core::Geometry::Vector> getInstanceAxes();
 
 private:
   void generateSuperquadricSurfacePrivate(GlyphConstructor& constructor, double A, double B);
@@ -0,0 +1,212 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <Graphics/Glyphs/GlyphGeom.h>
+#include <Graphics/Glyphs/InstancedGlyphGeom.h>
+#include <Core/GeometryPrimitives/BBox.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Tensor.h>
+#include <Core/Datatypes/Color.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Graphics;
+using namespace SCIRun::Graphics::Datatypes;
+
+namespace
+{
+  class StubGeometryIDGenerator : public GeometryIDGenerator
+  {
+  public:
+    std::string generateGeometryID(const std::string& tag) const override
+    {
+      return "<dummyGeomId>" + tag;
+    }
+  };
+
+  const BBox bounds(Point(-100, -100, -100), Point(100, 100, 100));
+
+  RenderState glyphState()
+  {
+    RenderState state;
+    state.defaultColor = ColorRGB(0.5, 0.5, 0.5);
+    return state;
+  }
+
+  std::vector<float> floats(const std::shared_ptr<spire::VarBuffer>& buffer)
+  {
+    const float* f = reinterpret_cast<const float*>(buffer->getBuffer());
+    return std::vector<float>(f, f + buffer->getBufferSize() / sizeof(float));
+  }
+
+  size_t bufferBytes(const GeometryObjectSpire& geom)
+  {
+    size_t bytes = 0;
+    for (const auto& vbo : geom.vbos()) bytes += vbo.data->getBufferSize();
+    for (const auto& ibo : geom.ibos()) bytes += ibo.data->getBufferSize();
+    for (const auto& pass : geom.passes())
+      if (pass.instances.data) bytes += pass.instances.data->getBufferSize();
+    return bytes;
+  }
+
+  void expectExpansionMatches(const GeometryObjectSpire& tessellated, const GeometryObjectSpire& instanced)
+  {
+    ASSERT_EQ(1u, tessellated.passes().size());
+    ASSERT_EQ(1u, instanced.passes().size());
+    const auto& pass = instanced.passes().front();
+    EXPECT_EQ("Shaders/Phong_Color_Instanced", pass.programName);
+
+    auto expanded = expandInstances(pass);
+    EXPECT_EQ("Shaders/Phong_Color", expanded.programName);
+    EXPECT_EQ(0u, expanded.instances.count);
+    EXPECT_EQ(tessellated.passes().front().vbo.attributes.size(), expanded.vbo.attributes.size());
+
+    auto expected = floats(tessellated.vbos().front().data);
+    auto actual = floats(expanded.vbo.data);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+      ASSERT_NEAR(expected[i], actual[i], 1e-4f * (1.0f + std::abs(expected[i]))) << "float " << i;
+
+    auto& expectedIndices = *tessellated.ibos().front().data;
+    auto& actualIndices = *expanded.ibo.data;
+    ASSERT_EQ(expectedIndices.getBufferSize(), actualIndices.getBufferSize());
+    EXPECT_EQ(0, memcmp(expectedIndices.getBuffer(), actualIndices.getBuffer(), expectedIndices.getBufferSize()));
+  }
+}
+
+TEST(InstancedGlyphGeomTest, ExpandedSpheresMatchTessellatedSpheres)
+{
+  StubGeometryIDGenerator idgen;
+  GlyphGeom glyphs;
+  InstancedGlyphGeom instanced(InstancedGlyphGeom::Shape::SPHERE, 8);
+  for (int i = 0; i < 20; ++i)
+  {
+    Point center(i, 2.0 * i - 5, 0.5 * i);
+    double radius = 0.1 + 0.05 * i;
+    ColorRGB color(i / 20.0, 0.5, 1.0 - i / 20.0);
+    glyphs.addSphere(center, radius, 8, color);
+    instanced.addSphere(center, radius, color);
+  }
+
+  GeometryObjectSpire tessellatedGeom(idgen, "tessellated", true), instancedGeom(idgen, "instanced", true);
+  glyphs.buildObject(tessellatedGeom, "spheres", false, 1.0, ColorScheme::COLOR_IN_SITU, glyphState(),
+                     SpireIBO::PRIMITIVE::TRIANGLES, bounds);
+  instanced.buildObject(instancedGeom, "spheres", false, 1.0, ColorScheme::COLOR_IN_SITU, glyphState(), bounds);
+
+  EXPECT_EQ(20u, instancedGeom.passes().front().instances.count);
+  expectExpansionMatches(tessellatedGeom, instancedGeom);
+}
+
+TEST(InstancedGlyphGeomTest, ExpandedEllipsoidsMatchTessellatedEllipsoids)
+{
+  StubGeometryIDGenerator idgen;
+  GlyphGeom glyphs;
+  InstancedGlyphGeom instanced(InstancedGlyphGeom::Shape::ELLIPSOID, 10);
+  for (int i = 0; i < 10; ++i)
+  {
+    Tensor t(3.0 + i, 0.5, 0.1 * i, 2.0, 0.2, 1.0);
+    Point center(i, -i, 0);
+    ColorRGB color(0.2, 0.1 * i, 0.7);
+    glyphs.addEllipsoid(center, t, 0.5, 10, color, false);
+    instanced.addTensor(center, t, 0.5, false, color);
+  }
+
+  GeometryObjectSpire tessellatedGeom(idgen, "tessellated", true), instancedGeom(idgen, "instanced", true);
+  glyphs.buildObject(tessellatedGeom, "ellipsoids", false, 1.0, ColorScheme::COLOR_IN_SITU, glyphState(),
+                     SpireIBO::PRIMITIVE::TRIANGLES, bounds);
+  instanced.buildObject(instancedGeom, "ellipsoids", false, 1.0, ColorScheme::COLOR_IN_SITU, glyphState(), bounds);
+
+  expectExpansionMatches(tessellatedGeom, instancedGeom);
+}
+
+TEST(InstancedGlyphGeomTest, BoundingBoxCoversEveryInstance)
+{
+  StubGeometryIDGenerator idgen;
+  InstancedGlyphGeom arrows(InstancedGlyphGeom::Shape::ARROW, 6, 0.7, true, true);
+  arrows.addAxial(Point(0, 0, 0), Point(3, 0, 0), 0.5, ColorRGB(1, 0, 0));
+  arrows.addAxial(Point(1, 1, 1), Point(1, 1, -4), 0.25, ColorRGB(0, 1, 0));
+
+  GeometryObjectSpire geom(idgen, "arrows", true);
+  arrows.buildObject(geom, "arrows", false, 1.0, ColorScheme::COLOR_UNIFORM, glyphState(), bounds);
+  const auto& box = geom.vbos().front().boundingBox;
+  auto expanded = expandInstances(geom.passes().front());
+  auto vertices = floats(expanded.vbo.data);
+  const size_t stride = 10;
+  for (size_t v = 0; v < vertices.size(); v += stride)
+    EXPECT_TRUE(box.inside(Point(vertices[v], vertices[v + 1], vertices[v + 2]))) << "vertex " << v / stride;
+}
+
+TEST(InstancedGlyphGeomTest, BuffersAreMuchSmallerThanTessellatedGlyphs)
+{
+  StubGeometryIDGenerator idgen;
+  const int n = 2000;
+  const int resolution = 10;
+
+  for (bool arrows : { false, true })
+  {
+    GlyphGeom glyphs;
+    glyphs.addInParallel(n, [&](GlyphGeom& part, size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        Point p(i % 100, (i / 100) % 100, i / 10000);
+        if (arrows)
+          part.addArrow(p, p + Vector(0.3, 0.4, 0.5), 0.1, 0.7, resolution, ColorRGB(1, 0, 0), ColorRGB(1, 0, 0), true, true);
+        else
+          part.addSphere(p, 0.3, resolution, ColorRGB(1, 0, 0));
+      }
+    });
+    GeometryObjectSpire tessellatedGeom(idgen, "tessellated", true);
+    glyphs.buildObject(tessellatedGeom, "glyphs", false, 1.0, ColorScheme::COLOR_IN_SITU, glyphState(),
+                       SpireIBO::PRIMITIVE::TRIANGLES, bounds);
+
+    InstancedGlyphGeom instanced(arrows ? InstancedGlyphGeom::Shape::ARROW : InstancedGlyphGeom::Shape::SPHERE,
+                                 resolution, 0.7, true, true);
+    instanced.addInParallel(n, [&](InstancedGlyphGeom& part, size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        Point p(i % 100, (i / 100) % 100, i / 10000);
+        if (arrows)
+          part.addAxial(p, p + Vector(0.3, 0.4, 0.5), 0.1, ColorRGB(1, 0, 0));
+        else
+          part.addSphere(p, 0.3, ColorRGB(1, 0, 0));
+      }
+    });
+    GeometryObjectSpire instancedGeom(idgen, "instanced", true);
+    instanced.buildObject(instancedGeom, "glyphs", false, 1.0, ColorScheme::COLOR_IN_SITU, glyphState(), bounds);
+
+    const size_t tessellatedBytes = bufferBytes(tessellatedGeom);
+    const size_t instancedBytes = bufferBytes(instancedGeom);
+    EXPECT_EQ(instanced.bufferSizeInBytes(false), instancedBytes);
+    EXPECT_LT(instancedBytes * 4, tessellatedBytes);
+  }
+}
@@ -37,6 +37,7 @@
 // ReSharper disable once CppUnusedIncludeDirective
 #include <Interface/Application/NetworkEditorControllerGuiProxy.h>
 #include <Dataflow/Serialization/Network/XMLSerializer.h>
+#include <Dataflow/Serialization/Network/BinarySerializer.h>
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
 #include <Dataflow/Serialization/Network/Importer/NetworkIO.h>
 #include <Dataflow/Engine/Controller/NetworkEditorController.h>
@@ -273,7 +274,7 @@ FileOpenCommand::FileOpenCommand()
 
 NetworkFileHandle FileOpenCommand::processXmlFile(const std::string& filename)
 {
-  return XMLSerializer::load_xml<NetworkFile>(filename);
+  return BinarySerializer::load_any<NetworkFile>(filename);
 }
 
 FileImportCommand::FileImportCommand()
@@ -80,19 +80,10 @@ Key thing: when undoing/redoing, since we're loading from scratch, need to scope
 class ProvenanceWindowListItem : public QListWidgetItem
 {
 public:
-  explicit ProvenanceWindowListItem(ProvenanceItemHandle info, QListWidget* parent = nullptr) :
+  ProvenanceWindowListItem(ProvenanceItemHandle info, ProvenanceManagerHandle manager, QListWidget* parent = nullptr) :
     QListWidgetItem(QString::fromStdString(info->name()), parent),
-    info_(info)
+    info_(info), manager_(manager)
   {
-    auto xml = info_->memento();
-    if (xml)
-    {
-      std::ostringstream ostr;
-      XMLSerializer::save_xml(*xml, ostr, "networkFile");
-      xmlText_ = QString::fromStdString(ostr.str());
-    }
-    else
-      xmlText_ = "<Unknown state for this item>";
   }
   void setAsUndo()
   {
@@ -108,9 +99,17 @@ public:
     setFont(f);
     setBackground(Qt::lightGray);
   }
+  // The manager only keeps deltas for most items, so the text is built on demand.
   QString xmlText() const
   {
-    return xmlText_;
+    auto xml = manager_->memento(info_);
+    if (xml && *xml)
+    {
+      std::ostringstream ostr;
+      XMLSerializer::save_xml(**xml, ostr, "networkFile");
+      return QString::fromStdString(ostr.str());
+    }
+    return "<Unknown state for this item>";
   }
   std::string name() const
   {
@@ -118,7 +117,7 @@ public:
   }
 private:
   ProvenanceItemHandle info_;
-  QString xmlText_;
+  ProvenanceManagerHandle manager_;
 };
 
 void ProvenanceWindow::addProvenanceItem(ProvenanceItemHandle item)
@@ -135,7 +134,7 @@ void ProvenanceWindow::addProvenanceItem(ProvenanceItemHandle item)
     lastUndoRow_++;
   }
 
-  new ProvenanceWindowListItem(item, provenanceListWidget_);
+  new ProvenanceWindowListItem(item, provenanceManager_, provenanceListWidget_);
   setRedoEnabled(false);
   setUndoEnabled(true);
 
@@ -45,4 +45,6 @@ CalculateDistanceToFieldDialog::CalculateDistanceToFieldDialog(const std::string
   addDoubleSpinBoxManager(truncateDoubleSpinBox_, Parameters::TruncateDistance);
   addComboBoxManager(basisTypeComboBox_, Parameters::BasisType);
   addComboBoxManager(dataTypeComboBox_, Parameters::OutputFieldDatatype);
+  addCheckBoxManager(fastSweepingCheckBox_, Parameters::UseFastSweeping);
+  addDoubleSpinBoxManager(narrowBandDoubleSpinBox_, Parameters::NarrowBandWidth);
 }
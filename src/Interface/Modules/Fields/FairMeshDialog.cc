@@ -49,6 +49,7 @@ FairMeshDialog::FairMeshDialog(const std::string& name, ModuleStateHandle state,
   addSpinBoxManager(iterationsSpinBox_, NumIterations);
   addDoubleSpinBoxManager(spatialCutOffDoubleSpinBox_, FilterCutoff);
   addDoubleSpinBoxManager(relaxationParameterDoubleSpinBox_, Lambda);
+  addCheckBoxManager(implicitFairingCheckBox_, ImplicitFairing);
 }
 
 void FairMeshDialog::push()
@@ -59,6 +59,8 @@ SolveInverseProblemWithTikhonovDialog::SolveInverseProblemWithTikhonovDialog(con
   WidgetStyleMixin::tabStyle(inputTabWidget_);
 
   addSpinBoxManager(lambdaNumberSpinBox_, Parameters::LambdaNum);
+  addSpinBoxManager(streamingChunkSizeSpinBox_, Parameters::StreamingChunkSize);
+  addLineEditManager(streamingOutputFileLineEdit_, Parameters::StreamingOutputFile);
   addDoubleSpinBoxManager(lambdaDoubleSpinBox_, Parameters::LambdaFromDirectEntry);
   addDoubleSpinBoxManager(lambdaMinDoubleSpinBox_, Parameters::LambdaMin);
   addDoubleSpinBoxManager(lambdaMaxDoubleSpinBox_, Parameters::LambdaMax);
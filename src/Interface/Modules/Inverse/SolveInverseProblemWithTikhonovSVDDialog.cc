@@ -50,6 +50,8 @@ SolveInverseProblemWithTikhonovSVDDialog::SolveInverseProblemWithTikhonovSVDDial
   lambdaMethod_.insert(StringPair("L-curve", "lcurve"));
 
   addSpinBoxManager(lambdaNumberSpinBox_, Parameters::LambdaNum);
+  addSpinBoxManager(streamingChunkSizeSpinBox_, Parameters::StreamingChunkSize);
+  addLineEditManager(streamingOutputFileLineEdit_, Parameters::StreamingOutputFile);
   addDoubleSpinBoxManager(lambdaDoubleSpinBox_, Parameters::LambdaFromDirectEntry);
   addDoubleSpinBoxManager(lambdaMinDoubleSpinBox_, Parameters::LambdaMin);
   addDoubleSpinBoxManager(lambdaMaxDoubleSpinBox_, Parameters::LambdaMax);
@@ -28,10 +28,12 @@
 
 #include <Interface/Modules/Math/EvaluateLinearAlgebraBinaryDialog.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Math/EvaluateLinearAlgebraUnaryAlgo.h>
 
 using namespace SCIRun::Gui;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Math;
 
 EvaluateLinearAlgebraBinaryDialog::EvaluateLinearAlgebraBinaryDialog(const std::string& name, ModuleStateHandle state,
   QWidget* parent /* = 0 */)
@@ -43,4 +45,5 @@ EvaluateLinearAlgebraBinaryDialog::EvaluateLinearAlgebraBinaryDialog(const std::
 
 	addLineEditManager(functionLineEdit_, Variables::FunctionString);
   addRadioButtonGroupManager({ addRadioButton_, subtractRadioButton_, multiplyRadioButton_, functionRadioButton_ }, Variables::Operator);
+  addCheckBoxManager(lazyCheckBox_, Parameters::LazyEvaluation);
 }
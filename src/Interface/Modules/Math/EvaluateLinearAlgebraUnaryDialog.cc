@@ -28,10 +28,12 @@
 
 #include <Interface/Modules/Math/EvaluateLinearAlgebraUnaryDialog.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Math/EvaluateLinearAlgebraUnaryAlgo.h>
 
 using namespace SCIRun::Gui;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Math;
 
 EvaluateLinearAlgebraUnaryDialog::EvaluateLinearAlgebraUnaryDialog(const std::string& name, ModuleStateHandle state,
   QWidget* parent /* = 0 */)
@@ -44,4 +46,5 @@ EvaluateLinearAlgebraUnaryDialog::EvaluateLinearAlgebraUnaryDialog(const std::st
   addDoubleLineEditManager(scalarLineEdit_, Variables::ScalarValue);
   addLineEditManager(functionLineEdit_, Variables::FunctionString);
   addRadioButtonGroupManager({ negateRadioButton_, transposeRadioButton_, scalarMultiplyRadioButton_, functionRadioButton_ }, Variables::Operator);
+  addCheckBoxManager(lazyCheckBox_, Parameters::LazyEvaluation);
 }
@@ -48,6 +48,8 @@ SolveComplexLinearSystemDialog::SolveComplexLinearSystemDialog(const std::string
   GuiStringTranslationMap solverNameLookup;
   solverNameLookup.insert(StringPair("Conjugate Gradient (Eigen)", "cg"));
   solverNameLookup.insert(StringPair("BiConjugate Gradient (Eigen)", "bicg"));
+  solverNameLookup.insert(StringPair("Conjugate Gradient, mixed precision (Eigen)", "cg-mixed"));
+  solverNameLookup.insert(StringPair("BiConjugate Gradient, mixed precision (Eigen)", "bicg-mixed"));
   solverNameLookup.insert(StringPair("Least Squares Conjugate Gradient (Eigen)", "lscg"));
   addComboBoxManager(methodComboBox_, Variables::Method, solverNameLookup);
 }
@@ -53,6 +53,9 @@ namespace SCIRun {
         solverNameLookup_.insert(StringPair("BiConjugate Gradient (SCI)", "bicg"));
         solverNameLookup_.insert(StringPair("Jacobi (SCI)", "jacobi"));
         solverNameLookup_.insert(StringPair("MINRES (SCI)", "minres"));
+        solverNameLookup_.insert(StringPair("Conjugate Gradient, mixed precision (SCI)", "cg-mixed"));
+        solverNameLookup_.insert(StringPair("BiConjugate Gradient, mixed precision (SCI)", "bicg-mixed"));
+        solverNameLookup_.insert(StringPair("Sparse LDLT, cached factorization (Eigen)", "ldlt"));
       }
       GuiStringTranslationMap solverNameLookup_;
     };
@@ -56,6 +56,7 @@
 #include "comp/RenderBasicGeom.h"
 #include "comp/StaticWorldLight.h"
 #include "comp/StaticClippingPlanes.h"
+#include "comp/RenderLevelOfDetail.h"
 #include "systems/RenderBasicSys.h"
 #include "systems/RenderTransBasicSys.h"
 #include "systems/RenderTransText.h"
@@ -194,6 +195,11 @@ public:
     core.addStaticComponent(clippingPlanes);
     core.addExemptComponent<StaticClippingPlanes>();
 
+    // Full resolution until the camera starts moving.
+    StaticLevelOfDetail levelOfDetail;
+    core.addStaticComponent(levelOfDetail);
+    core.addExemptComponent<StaticLevelOfDetail>();
+
     // Setup default ortho camera projection
     gen::StaticOrthoCamera orthoCam;
     float orthoZNear  = -1000.0f;
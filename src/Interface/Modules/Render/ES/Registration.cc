@@ -34,6 +34,8 @@
 #include "comp/RenderBasicGeom.h"
 #include "comp/SRRenderState.h"
 #include "comp/RenderList.h"
+#include "comp/RenderInstances.h"
+#include "comp/RenderLevelOfDetail.h"
 #include "comp/StaticWorldLight.h"
 #include "comp/StaticClippingPlanes.h"
 #include "comp/LightingUniforms.h"
@@ -62,6 +64,9 @@ void rendererRegisterAll(spire::Acorn& core)
   core.registerComponent<RenderBasicGeom>();
   core.registerComponent<SRRenderState>();
   core.registerComponent<RenderList>();
+  core.registerComponent<RenderInstances>();
+  core.registerComponent<RenderLevelOfDetail>();
+  core.registerComponent<StaticLevelOfDetail>();
   core.registerComponent<Graphics::Datatypes::SpireSubPass>();
 }
 
@@ -69,6 +69,8 @@
 #include "comp/RenderBasicGeom.h"
 #include "comp/SRRenderState.h"
 #include "comp/RenderList.h"
+#include "comp/RenderInstances.h"
+#include "comp/RenderLevelOfDetail.h"
 #include "comp/StaticWorldLight.h"
 #include "comp/LightingUniforms.h"
 #include "comp/ClippingPlaneUniforms.h"
@@ -215,6 +217,7 @@ void SRInterface::runGCOnNextExecution()
       autoRotateVector = glm::vec2(0.0, 0.0);
       tryAutoRotate = false;
       mCamera->mouseDownEvent(btn, glm::vec2{x,y});
+      setInteracting(true);
     }
 
     //----------------------------------------------------------------------------------------------
@@ -228,6 +231,7 @@ void SRInterface::runGCOnNextExecution()
     void SRInterface::inputMouseUp()
     {
       tryAutoRotate = Preferences::Instance().autoRotateViewerOnMouseRelease;
+      setInteracting(false);
     }
 
     //----------------------------------------------------------------------------------------------
@@ -903,16 +907,21 @@ glm::vec2 ScreenParams::positionFromClick(int x, int y) const
             iboMan->runGCCycle(mCore);
 
             RENDERER_LOG("Remove the object from the entity system.");
+            dropPendingLevelsOfDetail(objectName);
             mSRObjects.erase(foundObject);
           }
 
           DEBUG_LOG_LINE_INFO
+          RENDERER_LOG("Expand instanced passes that cannot be drawn as instances.");
+          VBOList vbos = obj->vbos();
+          IBOList ibos = obj->ibos();
+          PassList passes = obj->passes();
+          expandUndrawableInstances(vbos, ibos, passes);
+
           RENDERER_LOG("Add vertex buffer objects.");
-          std::vector<char*> vbo_buffer;
-          std::vector<size_t> stride_vbo;
 
           int nameIndex = 0;
-          for (auto it = obj->vbos().cbegin(); it != obj->vbos().cend(); ++it, ++nameIndex)
+          for (auto it = vbos.cbegin(); it != vbos.cend(); ++it, ++nameIndex)
           {
             const auto& vbo = *it;
 
@@ -928,19 +937,13 @@ glm::vec2 ScreenParams::positionFromClick(int x, int y) const
               vboMan->addInMemoryVBO(vbo.data->getBuffer(), vbo.data->getBufferSize(), attributeData, vbo.name);
             }
 
-            vbo_buffer.push_back(reinterpret_cast<char*>(vbo.data->getBuffer()));
-            size_t stride = 0;
-            for (auto a : vbo.attributes)
-              stride += a.sizeInBytes;
-            stride_vbo.push_back(stride);
-
             bbox.extend(vbo.boundingBox);
           }
 
           DEBUG_LOG_LINE_INFO
           RENDERER_LOG("Add index buffer objects.");
           nameIndex = 0;
-          for (auto it = obj->ibos().cbegin(); it != obj->ibos().cend(); ++it, ++nameIndex)
+          for (auto it = ibos.cbegin(); it != ibos.cend(); ++it, ++nameIndex)
           {
             const auto& ibo = *it;
             GLenum primType = GL_UNSIGNED_SHORT;
@@ -984,96 +987,8 @@ glm::vec2 ScreenParams::positionFromClick(int x, int y) const
                 break;
             }
 
-            if (mRenderSortType == RenderState::TransparencySortType::LISTS_SORT)
-            {
-              RENDERER_LOG("Create sorted lists of Buffers for transparency in each direction of the axis.");
-              uint32_t* ibo_buffer = reinterpret_cast<uint32_t*>(ibo.data->getBuffer());
-              size_t num_triangles = ibo.data->getBufferSize() / (sizeof(uint32_t) * 3);
-              Vector dir(0.0, 0.0, 0.0);
-
-              std::vector<DepthIndex> rel_depth(num_triangles);
-              for (int i = 0; i <= 6; ++i)
-              {
-                std::string name = ibo.name;
-                if (i == 0)
-                {
-                  int numPrimitives = ibo.data->getBufferSize() / ibo.indexSize;
-                  iboMan->addInMemoryIBO(ibo.data->getBuffer(),
-                    ibo.data->getBufferSize(), primitive, primType,
-                    numPrimitives, ibo.name);
-                }
-                if (i == 1)
-                {
-                  dir = Vector(1.0, 0.0, 0.0);
-                  name += "X";
-                }
-                if (i == 2)
-                {
-                  dir = Vector(0.0, 1.0, 0.0);
-                  name += "Y";
-                }
-                if (i == 3)
-                {
-                  dir = Vector(0.0, 0.0, 1.0);
-                  name += "Z";
-                }
-                if (i == 4)
-                {
-                  dir = Vector(-1.0, 0.0, 0.0);
-                  name += "NegX";
-                }
-                if (i == 5)
-                {
-                  dir = Vector(0.0, -1.0, 0.0);
-                  name += "NegY";
-                }
-                if (i == 6)
-                {
-                  dir = Vector(0.0, 0.0, -1.0);
-                  name += "NegZ";
-                }
-                if (i > 0)
-                {
-                  for (size_t j = 0; j < num_triangles; j++)
-                  {
-                    float* vertex1 = reinterpret_cast<float*>(vbo_buffer[nameIndex] + stride_vbo[nameIndex] * (ibo_buffer[j * 3]));
-                    Point node1(vertex1[0], vertex1[1], vertex1[2]);
-
-                    float* vertex2 = reinterpret_cast<float*>(vbo_buffer[nameIndex] + stride_vbo[nameIndex] * (ibo_buffer[j * 3 + 1]));
-                    Point node2(vertex2[0], vertex2[1], vertex2[2]);
-
-                    float* vertex3 = reinterpret_cast<float*>(vbo_buffer[nameIndex] + stride_vbo[nameIndex] * (ibo_buffer[j * 3 + 2]));
-                    Point node3(vertex3[0], vertex3[1], vertex3[2]);
-
-                    rel_depth[j].mDepth = Dot(dir, node1) + Dot(dir, node2) + Dot(dir, node3);
-                    rel_depth[j].mIndex = j;
-                  }
-
-                  std::sort(rel_depth.begin(), rel_depth.end());
-
-                  int numPrimitives = ibo.data->getBufferSize() / ibo.indexSize;
-
-                  std::vector<char> sorted_buffer(ibo.data->getBufferSize());
-                  char* ibuffer = reinterpret_cast<char*>(ibo.data->getBuffer());
-                  char* sbuffer = !sorted_buffer.empty() ? reinterpret_cast<char*>(&sorted_buffer[0]) : nullptr;
-
-                  if (sbuffer && num_triangles > 0)
-                  {
-                    size_t tri_size = ibo.data->getBufferSize() / num_triangles;
-                    for (size_t j = 0; j < num_triangles; j++)
-                    {
-                      memcpy(sbuffer + j * tri_size, ibuffer + rel_depth[j].mIndex * tri_size, tri_size);
-                    }
-                    iboMan->addInMemoryIBO(sbuffer, ibo.data->getBufferSize(), primitive, primType, numPrimitives, name);
-                  }
-                }
-              }
-            }
-            else
-            {
-              int numPrimitives = ibo.data->getBufferSize() / ibo.indexSize;
-              iboMan->addInMemoryIBO(ibo.data->getBuffer(), ibo.data->getBufferSize(), primitive, primType, numPrimitives, ibo.name);
-            }
+            int numPrimitives = ibo.data->getBufferSize() / ibo.indexSize;
+            iboMan->addInMemoryIBO(ibo.data->getBuffer(), ibo.data->getBufferSize(), primitive, primType, numPrimitives, ibo.name);
           }
 
           RENDERER_LOG("Add default identity transform to the object globally (instead of per-pass)");
@@ -1095,38 +1010,15 @@ glm::vec2 ScreenParams::positionFromClick(int x, int y) const
             }
 
             RENDERER_LOG("Add passes");
-            for (auto& pass : obj->passes())
+            for (auto& pass : passes)
             {
               uint64_t entityID = getEntityIDForName(pass.passName, port);
 
               if (pass.renderType == RenderType::RENDER_VBO_IBO)
               {
                 addVBOToEntity(entityID, pass.vboName);
-                if (mRenderSortType == RenderState::TransparencySortType::LISTS_SORT)
-                {
-                  for (int i = 0; i <= 6; ++i)
-                  {
-                    std::string name = pass.iboName;
-                    if (i == 1)
-                      name += "X";
-                    if (i == 2)
-                      name += "Y";
-                    if (i == 3)
-                      name += "Z";
-                    if (i == 4)
-                      name += "NegX";
-                    if (i == 5)
-                      name += "NegY";
-                    if (i == 6)
-                      name += "NegZ";
-
-                    addIBOToEntity(entityID, name);
-                  }
-                }
-                else
-                {
-                  addIBOToEntity(entityID, pass.iboName);
-                }
+                addInstancesToEntity(entityID, pass.instances);
+                addIBOToEntity(entityID, pass.iboName);
                 RENDERER_LOG("add texture");
                 addTextToEntity(entityID, pass.text);
                 addTextureToEntity(entityID, pass.texture);
@@ -1190,6 +1082,7 @@ glm::vec2 ScreenParams::positionFromClick(int x, int y) const
               elem.mPasses.emplace_back(pass.passName, pass.renderType);
               pass.renderState.mSortType = mRenderSortType;
               mCore.addComponent(entityID, pass);
+              requestLevelsOfDetail(objectName, entityID, pass);
             }
           }
           mCamera->setSceneBoundingBox(sceneBBox_);
@@ -1212,6 +1105,7 @@ glm::vec2 ScreenParams::positionFromClick(int x, int y) const
         }
       }
       mEntityIdMap.clear();
+      pendingLevelsOfDetail_.clear();
 
       mCore.renormalize(true);
       mSRObjects.clear();
@@ -1230,6 +1124,7 @@ glm::vec2 ScreenParams::positionFromClick(int x, int y) const
             uint64_t entityID = getEntityIDForName(pass.passName, it->mPort);
             mCore.removeEntity(entityID);
           }
+          dropPendingLevelsOfDetail(it->mName);
           it = mSRObjects.erase(it);
         }
         else
@@ -1256,6 +1151,140 @@ glm::vec2 ScreenParams::positionFromClick(int x, int y) const
       return false;
     }
 
+    //----------------------------------------------------------------------------------------------
+    bool SRInterface::instancedDrawingSupported()
+    {
+#ifdef USE_OPENGL_ES
+      return false;
+#else
+      if (!instancingSupported_)
+      {
+        instancingSupported_ = mContext && mContext->hasExtension("GL_ARB_instanced_arrays")
+          && mContext->hasExtension("GL_ARB_draw_instanced");
+      }
+      return *instancingSupported_;
+#endif
+    }
+
+    //----------------------------------------------------------------------------------------------
+    void SRInterface::expandUndrawableInstances(VBOList& vbos, IBOList& ibos, PassList& passes)
+    {
+      for (auto& pass : passes)
+      {
+        if (pass.instances.count == 0)
+          continue;
+
+        // Transparent passes are depth sorted per triangle, which needs every instance's triangles.
+        bool transparent = pass.renderState.get(RenderState::USE_TRANSPARENCY) ||
+          pass.renderState.get(RenderState::USE_TRANSPARENT_EDGES) ||
+          pass.renderState.get(RenderState::USE_TRANSPARENT_NODES);
+        if (!transparent && instancedDrawingSupported())
+          continue;
+
+        pass = expandInstances(pass);
+        for (auto& vbo : vbos)
+          if (vbo.name == pass.vboName) vbo = pass.vbo;
+        for (auto& ibo : ibos)
+          if (ibo.name == pass.iboName) ibo = pass.ibo;
+      }
+    }
+
+    //----------------------------------------------------------------------------------------------
+    void SRInterface::addInstancesToEntity(uint64_t entityID, const SpireInstances& instances)
+    {
+      if (instances.count == 0) return;
+      std::weak_ptr<ren::VBOMan> vm = mCore.getStaticComponent<ren::StaticVBOMan>()->instance_;
+      if (std::shared_ptr<ren::VBOMan> vboMan = vm.lock()) {
+        std::vector<std::tuple<std::string, size_t, bool>> attributeData;
+        for (const auto& attribData : instances.attributes)
+          attributeData.push_back(std::make_tuple(attribData.name, attribData.sizeInBytes, attribData.normalize));
+
+        RenderInstances inst;
+        inst.glid = vboMan->addInMemoryVBO(instances.data->getBuffer(), instances.data->getBufferSize(),
+          attributeData, instances.name);
+        inst.count = static_cast<int64_t>(instances.count);
+
+        // Also referenced as a VBO so garbage collection keeps the buffer alive; the template
+        // VBO was added first and stays the entity's primary VBO.
+        addVBOToEntity(entityID, instances.name);
+        mCore.addComponent(entityID, inst);
+      }
+    }
+
+    //----------------------------------------------------------------------------------------------
+    void SRInterface::requestLevelsOfDetail(const std::string& objectName, uint64_t entityID, const SpireSubPass& pass)
+    {
+      if (pass.renderType != RenderType::RENDER_VBO_IBO || pass.instances.count > 0
+        || pass.renderState.get(RenderState::USE_TRANSPARENCY))
+        return;
+
+      std::string geometryID = objectName + "/" + pass.passName;
+      if (lodCache_.request(geometryID, pass.vbo, pass.ibo))
+        pendingLevelsOfDetail_.push_back({ objectName, entityID, geometryID, pass.ibo });
+    }
+
+    //----------------------------------------------------------------------------------------------
+    void SRInterface::attachLevelsOfDetail()
+    {
+      if (pendingLevelsOfDetail_.empty()) return;
+      std::weak_ptr<ren::VBOMan> vm = mCore.getStaticComponent<ren::StaticVBOMan>()->instance_;
+      std::weak_ptr<ren::IBOMan> im = mCore.getStaticComponent<ren::StaticIBOMan>()->instance_;
+      auto vboMan = vm.lock();
+      auto iboMan = im.lock();
+      if (!vboMan || !iboMan) return;
+
+      for (auto it = pendingLevelsOfDetail_.begin(); it != pendingLevelsOfDetail_.end();)
+      {
+        if (!lodCache_.ready(it->geometryID))
+        {
+          ++it;
+          continue;
+        }
+
+        if (auto levels = lodCache_.levels(it->geometryID, it->ibo))
+        {
+          RenderLevelOfDetail lod;
+          for (const auto& level : *levels)
+          {
+            if (lod.numLevels == RenderLevelOfDetail::MaxLevels) break;
+
+            std::vector<std::tuple<std::string, size_t, bool>> attributeData;
+            for (const auto& attribData : level.vbo.attributes)
+              attributeData.push_back(std::make_tuple(attribData.name, attribData.sizeInBytes, attribData.normalize));
+            GLuint vboID = vboMan->addInMemoryVBO(level.vbo.data->getBuffer(), level.vbo.data->getBufferSize(),
+              attributeData, level.vbo.name);
+
+            GLsizei numPrims = static_cast<GLsizei>(level.ibo.data->getBufferSize() / level.ibo.indexSize);
+            GLuint iboID = iboMan->addInMemoryIBO(level.ibo.data->getBuffer(), level.ibo.data->getBufferSize(),
+              GL_TRIANGLES, GL_UNSIGNED_INT, numPrims, level.ibo.name);
+
+            // Referenced after the full-resolution buffers, which stay the entity's primary ones.
+            addVBOToEntity(it->entityID, level.vbo.name);
+            addIBOToEntity(it->entityID, level.ibo.name);
+            lod.levels[lod.numLevels++] = { vboID, iboID, numPrims };
+          }
+          if (lod.numLevels > 0)
+            mCore.addComponent(it->entityID, lod);
+        }
+        it = pendingLevelsOfDetail_.erase(it);
+      }
+    }
+
+    //----------------------------------------------------------------------------------------------
+    void SRInterface::dropPendingLevelsOfDetail(const std::string& objectName)
+    {
+      pendingLevelsOfDetail_.erase(std::remove_if(pendingLevelsOfDetail_.begin(), pendingLevelsOfDetail_.end(),
+        [&objectName](const PendingLevelOfDetail& p) { return p.objectName == objectName; }),
+        pendingLevelsOfDetail_.end());
+    }
+
+    //----------------------------------------------------------------------------------------------
+    void SRInterface::setInteracting(bool interacting)
+    {
+      if (auto* lod = mCore.getStaticComponent<StaticLevelOfDetail>())
+        lod->interacting = interacting;
+    }
+
     //----------------------------------------------------------------------------------------------
     void SRInterface::addVBOToEntity(uint64_t entityID, const std::string& vboName)
     {
@@ -1426,6 +1455,7 @@ glm::vec2 ScreenParams::positionFromClick(int x, int y) const
       applyAutoRotation();
       updateCamera();
       updateWorldLight();
+      attachLevelsOfDetail();
 
       mCore.execute(constantDeltaTime);
 
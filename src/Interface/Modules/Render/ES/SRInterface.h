@@ -42,6 +42,7 @@
 #include <es-render/comp/CommonUniforms.hpp>
 #include <Interface/Modules/Render/ES/comp/StaticClippingPlanes.h>
 #include <Graphics/Datatypes/GeometryImpl.h>
+#include <Graphics/Datatypes/MeshDecimation.h>
 #include <glm/gtc/quaternion.hpp>
 #include <QOpenGLContext>
 #include <Interface/Modules/Render/ES/RendererInterface.h>
@@ -202,6 +203,22 @@ namespace SCIRun
       void addVBOToEntity(uint64_t entityID, const std::string& vboName);
       // Adds an IBO to the given entityID.
       void addIBOToEntity(uint64_t entityID, const std::string& iboName);
+      // Uploads the per-instance buffer of an instanced pass and adds it to the given entityID.
+      void addInstancesToEntity(uint64_t entityID, const Graphics::Datatypes::SpireInstances& instances);
+      // Whether the context can draw instanced passes directly.
+      bool instancedDrawingSupported();
+      // Replaces instanced passes this renderer cannot draw as instances (no extension support,
+      // or transparent) with their CPU expansion, along with their VBO and IBO.
+      void expandUndrawableInstances(Graphics::Datatypes::VBOList& vbos, Graphics::Datatypes::IBOList& ibos,
+        Graphics::Datatypes::PassList& passes);
+      // Starts building levels of detail for a large opaque surface pass.
+      void requestLevelsOfDetail(const std::string& objectName, uint64_t entityID,
+        const Graphics::Datatypes::SpireSubPass& pass);
+      // Uploads finished levels of detail and attaches them to their entities.
+      void attachLevelsOfDetail();
+      void dropPendingLevelsOfDetail(const std::string& objectName);
+      // Large surfaces draw a decimated level while the camera is being moved.
+      void setInteracting(bool interacting);
       //add a texture to the given entityID.
       void addTextToEntity(uint64_t entityID, const Graphics::Datatypes::SpireText& text);
       void addTextureToEntity(uint64_t entityID, const Graphics::Datatypes::SpireTexture2D& texture);
@@ -236,6 +253,17 @@ namespace SCIRun
 
       GLuint                              mFontTexture        {0};       // 2D texture for fonts
       boost::optional<GLuint> widgetSelectFboId_ {};
+      boost::optional<bool> instancingSupported_ {};
+
+      struct PendingLevelOfDetail
+      {
+        std::string objectName;
+        uint64_t entityID;
+        std::string geometryID;
+        Graphics::Datatypes::SpireIBO ibo;
+      };
+      Graphics::Datatypes::LevelOfDetailCache lodCache_ {};
+      std::vector<PendingLevelOfDetail>   pendingLevelsOfDetail_ {};
 
       int                                 axesFailCount_      {0};
       std::vector<SRObject>               mSRObjects          {};       // All SCIRun objects.
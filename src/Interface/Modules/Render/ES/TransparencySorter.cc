@@ -0,0 +1,297 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Interface/Modules/Render/ES/TransparencySorter.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+using namespace SCIRun::Render;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Graphics::Datatypes;
+
+const size_t TransparencySorter::DefaultCacheBytes = 64 * 1024 * 1024;
+
+namespace
+{
+  const size_t trianglesPerTask = 16384;
+  const int radixBits = 8;
+  const int radixBuckets = 1 << radixBits;
+}
+
+TransparencySorter::TransparencySorter(size_t maxCachedBytes) : maxCachedBytes_(maxCachedBytes)
+{
+}
+
+TransparencySorter::~TransparencySorter()
+{
+  for (auto& p : pending_)
+    if (p.second.result.valid())
+      p.second.result.wait();
+}
+
+bool TransparencySorter::isSortable(const SpireIBO& ibo)
+{
+  return ibo.data && ibo.indexSize == sizeof(uint32_t) && ibo.prim == SpireIBO::PRIMITIVE::TRIANGLES;
+}
+
+void TransparencySorter::radixSort(std::vector<uint32_t>& keys, TriangleOrder& order)
+{
+  const size_t count = keys.size();
+  order.resize(count);
+  std::iota(order.begin(), order.end(), 0);
+  if (count < 2)
+    return;
+
+  const int numTasks = Parallel::NumTasks(count, trianglesPerTask);
+  std::vector<uint32_t> keysOut(count), orderOut(count);
+  std::vector<size_t> offsets(static_cast<size_t>(numTasks) * radixBuckets);
+
+  for (int shift = 0; shift < 32; shift += radixBits)
+  {
+    std::fill(offsets.begin(), offsets.end(), 0);
+    Parallel::RunRange(count, numTasks, [&](int task, size_t begin, size_t end)
+    {
+      auto* histogram = &offsets[task * radixBuckets];
+      for (size_t i = begin; i < end; ++i)
+        ++histogram[(keys[i] >> shift) & (radixBuckets - 1)];
+    });
+
+    // Offsets are laid out digit-major, task-minor so each task scatters its contiguous range
+    // after every earlier task: that keeps the sort stable.
+    // A digit shared by every key leaves the order unchanged, so the pass is skipped.
+    bool singleDigit = false;
+    size_t sum = 0;
+    for (int digit = 0; digit < radixBuckets; ++digit)
+    {
+      const size_t digitBegin = sum;
+      for (int task = 0; task < numTasks; ++task)
+      {
+        auto& slot = offsets[task * radixBuckets + digit];
+        auto n = slot;
+        slot = sum;
+        sum += n;
+      }
+      if (sum - digitBegin == count)
+        singleDigit = true;
+    }
+    if (singleDigit)
+      continue;
+
+    Parallel::RunRange(count, numTasks, [&](int task, size_t begin, size_t end)
+    {
+      auto* next = &offsets[task * radixBuckets];
+      for (size_t i = begin; i < end; ++i)
+      {
+        auto pos = next[(keys[i] >> shift) & (radixBuckets - 1)]++;
+        keysOut[pos] = keys[i];
+        orderOut[pos] = order[i];
+      }
+    });
+    keys.swap(keysOut);
+    order.swap(orderOut);
+  }
+}
+
+TransparencySorter::TriangleOrder TransparencySorter::sortTriangles(const SpireVBO& vbo, const SpireIBO& ibo, const Vector& dir)
+{
+  TriangleOrder order;
+  if (!isSortable(ibo) || !vbo.data)
+    return order;
+
+  size_t stride = 0, posOffset = 0;
+  for (const auto& attribute : vbo.attributes)
+  {
+    if (attribute.name == "aPos")
+      posOffset = stride;
+    stride += attribute.sizeInBytes;
+  }
+
+  const auto* vertices = reinterpret_cast<const char*>(vbo.data->getBuffer()) + posOffset;
+  const auto* indices = reinterpret_cast<const uint32_t*>(ibo.data->getBuffer());
+  const size_t numTriangles = ibo.data->getBufferSize() / (sizeof(uint32_t) * 3);
+  const int numTasks = Parallel::NumTasks(numTriangles, trianglesPerTask);
+
+  // Triangle depth is the sum of its vertex depths; the factor of three does not change the order.
+  std::vector<double> depths(numTriangles);
+  std::vector<double> taskMin(numTasks, std::numeric_limits<double>::max());
+  std::vector<double> taskMax(numTasks, std::numeric_limits<double>::lowest());
+  Parallel::RunRange(numTriangles, numTasks, [&](int task, size_t begin, size_t end)
+  {
+    double lo = taskMin[task], hi = taskMax[task];
+    for (size_t j = begin; j < end; ++j)
+    {
+      double depth = 0;
+      for (int v = 0; v < 3; ++v)
+      {
+        const auto* p = reinterpret_cast<const float*>(vertices + stride * indices[j * 3 + v]);
+        depth += dir.x() * p[0] + dir.y() * p[1] + dir.z() * p[2];
+      }
+      depths[j] = depth;
+      lo = std::min(lo, depth);
+      hi = std::max(hi, depth);
+    }
+    taskMin[task] = lo;
+    taskMax[task] = hi;
+  });
+
+  const double minDepth = *std::min_element(taskMin.begin(), taskMin.end());
+  const double maxDepth = *std::max_element(taskMax.begin(), taskMax.end());
+  const double keyRange = static_cast<double>(std::numeric_limits<uint32_t>::max());
+  const double scale = maxDepth > minDepth ? keyRange / (maxDepth - minDepth) : 0.0;
+
+  std::vector<uint32_t> keys(numTriangles);
+  Parallel::RunRange(numTriangles, numTasks, [&](int, size_t begin, size_t end)
+  {
+    for (size_t j = begin; j < end; ++j)
+      keys[j] = static_cast<uint32_t>(std::min(keyRange, (depths[j] - minDepth) * scale));
+  });
+
+  radixSort(keys, order);
+  return order;
+}
+
+void TransparencySorter::applyOrder(const SpireIBO& ibo, const TriangleOrder& order, std::vector<uint32_t>& sortedIndices)
+{
+  const auto* indices = reinterpret_cast<const uint32_t*>(ibo.data->getBuffer());
+  const size_t numTriangles = order.size();
+  sortedIndices.resize(numTriangles * 3);
+  const int numTasks = Parallel::NumTasks(numTriangles, trianglesPerTask);
+  Parallel::RunRange(numTriangles, numTasks, [&](int, size_t begin, size_t end)
+  {
+    for (size_t j = begin; j < end; ++j)
+      std::copy(indices + order[j] * 3, indices + order[j] * 3 + 3, sortedIndices.begin() + j * 3);
+  });
+}
+
+TransparencySorter::Axis TransparencySorter::nearestAxis(const Vector& dir)
+{
+  const double ax = std::fabs(dir.x()), ay = std::fabs(dir.y()), az = std::fabs(dir.z());
+  if (az >= ax && az >= ay)
+    return dir.z() < 0 ? Axis::NEG_Z : Axis::Z;
+  if (ay >= ax)
+    return dir.y() < 0 ? Axis::NEG_Y : Axis::Y;
+  return dir.x() < 0 ? Axis::NEG_X : Axis::X;
+}
+
+Vector TransparencySorter::axisDirection(Axis axis)
+{
+  switch (axis)
+  {
+  case Axis::X: return Vector(1, 0, 0);
+  case Axis::Y: return Vector(0, 1, 0);
+  case Axis::Z: return Vector(0, 0, 1);
+  case Axis::NEG_X: return Vector(-1, 0, 0);
+  case Axis::NEG_Y: return Vector(0, -1, 0);
+  case Axis::NEG_Z: return Vector(0, 0, -1);
+  }
+  return Vector(0, 0, 1);
+}
+
+TransparencySorter::TriangleOrderHandle TransparencySorter::axisOrder(const SpireVBO& vbo, const SpireIBO& ibo, Axis axis)
+{
+  purgeExpired();
+  for (auto it = cache_.begin(); it != cache_.end(); ++it)
+  {
+    if (it->axis == axis && it->iboData.lock() == ibo.data && it->vboData.lock() == vbo.data)
+    {
+      cache_.splice(cache_.begin(), cache_, it);
+      return cache_.front().order;
+    }
+  }
+
+  auto order = std::make_shared<const TriangleOrder>(sortTriangles(vbo, ibo, axisDirection(axis)));
+  cache_.push_front({ vbo.data, ibo.data, axis, order });
+  cachedBytes_ += order->size() * sizeof(uint32_t);
+  evictToBudget();
+  return order;
+}
+
+void TransparencySorter::purgeExpired()
+{
+  for (auto it = cache_.begin(); it != cache_.end();)
+  {
+    if (it->iboData.expired() || it->vboData.expired())
+    {
+      cachedBytes_ -= it->order->size() * sizeof(uint32_t);
+      it = cache_.erase(it);
+    }
+    else
+      ++it;
+  }
+}
+
+void TransparencySorter::evictToBudget()
+{
+  // The newest entry always stays so a single oversized object still renders.
+  while (cachedBytes_ > maxCachedBytes_ && cache_.size() > 1)
+  {
+    cachedBytes_ -= cache_.back().order->size() * sizeof(uint32_t);
+    cache_.pop_back();
+  }
+}
+
+void TransparencySorter::requestSort(const std::string& key, const SpireVBO& vbo, const SpireIBO& ibo, const Vector& dir)
+{
+  if (sortPending(key))
+    return;
+
+  // The worker holds its own references, so the buffers outlive a replaced or removed object.
+  auto& pending = pending_[key];
+  pending.iboData = ibo.data;
+  pending.result = std::async(std::launch::async, [vbo, ibo, dir]() { return sortTriangles(vbo, ibo, dir); });
+}
+
+bool TransparencySorter::sortPending(const std::string& key) const
+{
+  auto it = pending_.find(key);
+  return it != pending_.end() && it->second.result.valid();
+}
+
+TransparencySorter::TriangleOrderHandle TransparencySorter::takeResult(const std::string& key, const SpireIBO& ibo)
+{
+  auto it = pending_.find(key);
+  if (it == pending_.end() || !it->second.result.valid()
+    || it->second.result.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    return nullptr;
+
+  auto order = std::make_shared<const TriangleOrder>(it->second.result.get());
+  const bool current = it->second.iboData.lock() == ibo.data;
+  pending_.erase(it);
+  return current ? order : nullptr;
+}
+
+void TransparencySorter::clear()
+{
+  cache_.clear();
+  cachedBytes_ = 0;
+}
@@ -0,0 +1,122 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef INTERFACE_MODULES_RENDER_ES_TRANSPARENCYSORTER_H
+#define INTERFACE_MODULES_RENDER_ES_TRANSPARENCYSORTER_H
+
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Graphics/Datatypes/GeometryImpl.h>
+#include <boost/noncopyable.hpp>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <Interface/Modules/Render/share.h>
+
+namespace SCIRun {
+namespace Render {
+
+  /// Orders the triangles of a VBO/IBO pair back to front along a view direction so transparent
+  /// passes blend correctly. Triangle depths are quantized to 32-bit keys and ordered with a
+  /// stable, parallel LSD radix sort. Only the triangle permutation is stored; callers expand it
+  /// into an index buffer when they upload it. No GL calls are made here.
+  class SCISHARE TransparencySorter : boost::noncopyable
+  {
+  public:
+    using TriangleOrder = std::vector<uint32_t>;
+    using TriangleOrderHandle = std::shared_ptr<const TriangleOrder>;
+
+    enum class Axis { X, Y, Z, NEG_X, NEG_Y, NEG_Z };
+
+    /// Cached axis orders are evicted least-recently-used once they exceed maxCachedBytes.
+    explicit TransparencySorter(size_t maxCachedBytes = DefaultCacheBytes);
+    ~TransparencySorter();
+
+    static const size_t DefaultCacheBytes;
+
+    /// Triangle indices sorted by ascending depth along dir. Only 32-bit triangle IBOs can be
+    /// sorted; any other buffer yields an empty order.
+    static TriangleOrder sortTriangles(const Graphics::Datatypes::SpireVBO& vbo,
+      const Graphics::Datatypes::SpireIBO& ibo, const Core::Geometry::Vector& dir);
+
+    /// Stable radix sort of keys; order receives the permutation that sorts them.
+    static void radixSort(std::vector<uint32_t>& keys, TriangleOrder& order);
+
+    /// Writes the triangles of ibo into sortedIndices following order.
+    static void applyOrder(const Graphics::Datatypes::SpireIBO& ibo, const TriangleOrder& order,
+      std::vector<uint32_t>& sortedIndices);
+
+    static bool isSortable(const Graphics::Datatypes::SpireIBO& ibo);
+    static Axis nearestAxis(const Core::Geometry::Vector& dir);
+    static Core::Geometry::Vector axisDirection(Axis axis);
+
+    /// Order along one of the six axis directions. Computed on first request and cached until
+    /// the buffers are released or the entry is evicted.
+    TriangleOrderHandle axisOrder(const Graphics::Datatypes::SpireVBO& vbo,
+      const Graphics::Datatypes::SpireIBO& ibo, Axis axis);
+
+    /// Starts sorting along dir on a worker thread. Ignored while a sort for key is pending.
+    void requestSort(const std::string& key, const Graphics::Datatypes::SpireVBO& vbo,
+      const Graphics::Datatypes::SpireIBO& ibo, const Core::Geometry::Vector& dir);
+    bool sortPending(const std::string& key) const;
+    /// Finished background order for key, or null if it is still running or its buffers changed.
+    TriangleOrderHandle takeResult(const std::string& key, const Graphics::Datatypes::SpireIBO& ibo);
+
+    size_t cachedBytes() const { return cachedBytes_; }
+    size_t maxCachedBytes() const { return maxCachedBytes_; }
+    void clear();
+
+  private:
+    struct CacheEntry
+    {
+      std::weak_ptr<spire::VarBuffer> vboData, iboData;
+      Axis axis;
+      TriangleOrderHandle order;
+    };
+
+    struct PendingSort
+    {
+      std::weak_ptr<spire::VarBuffer> iboData;
+      std::future<TriangleOrder> result;
+    };
+
+    void purgeExpired();
+    void evictToBudget();
+
+    size_t maxCachedBytes_;
+    size_t cachedBytes_ {0};
+    std::list<CacheEntry> cache_;  // most recently used first
+    std::map<std::string, PendingSort> pending_;
+  };
+
+}}
+
+#endif
@@ -0,0 +1,86 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef INTERFACE_MODULES_RENDER_ES_COMP_RENDER_INSTANCES_H
+#define INTERFACE_MODULES_RENDER_ES_COMP_RENDER_INSTANCES_H
+
+#include <gl-platform/GLPlatform.hpp>
+#include <es-cereal/ComponentSerialize.hpp>
+#include <es-render/util/Shader.hpp>
+#include <es-render/comp/StaticVBOMan.hpp>
+#include <vector>
+
+namespace SCIRun {
+namespace Render {
+
+/// Per-instance vertex buffer of an instanced pass (see SpireInstances). The entity's own VBO
+/// and IBO hold the template mesh, which is drawn once per instance.
+struct RenderInstances
+{
+  // -- Data --
+  static const int MaxNumAttributes = 4;
+  ren::ShaderVBOAttribs<MaxNumAttributes> attribs;
+  std::vector<GLint> attribLocations;  ///< Shader locations that advance once per instance.
+  GLuint glid;
+  int64_t count;
+
+  // -- Functions --
+  RenderInstances() : glid(0), count(0) {}
+
+  static const char* getName() {return "RenderInstances";}
+
+  void setup(GLuint shaderID, const ren::StaticVBOMan& vboMan)
+  {
+    attribs.setup(glid, shaderID, vboMan);
+    attribLocations.clear();
+    for (const char* name : {"aInstanceRow0", "aInstanceRow1", "aInstanceRow2", "aInstanceColor", "aInstanceTexCoords"})
+    {
+      GLint location = glGetAttribLocation(shaderID, name);
+      if (location >= 0) attribLocations.push_back(location);
+    }
+  }
+
+#ifndef USE_OPENGL_ES
+  void setDivisor(GLuint divisor) const
+  {
+    for (GLint location : attribLocations)
+      GL(glVertexAttribDivisorARB(static_cast<GLuint>(location), divisor));
+  }
+#endif
+
+  bool serialize(spire::ComponentSerialize& /* s */, uint64_t /* entityID */)
+  {
+    // Context specific, like RenderBasicGeom.
+    return true;
+  }
+};
+
+} // namespace Render
+} // namespace SCIRun
+
+#endif
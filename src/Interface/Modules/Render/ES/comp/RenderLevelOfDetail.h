@@ -0,0 +1,101 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef INTERFACE_MODULES_RENDER_ES_COMP_RENDER_LEVEL_OF_DETAIL_H
+#define INTERFACE_MODULES_RENDER_ES_COMP_RENDER_LEVEL_OF_DETAIL_H
+
+#include <gl-platform/GLPlatform.hpp>
+#include <es-cereal/ComponentSerialize.hpp>
+#include <cstdint>
+
+namespace SCIRun {
+namespace Render {
+
+/// Decimated versions of an entity's surface, finest first (see MeshDecimator). Their buffers
+/// are also attached as ren::VBO and ren::IBO components so garbage collection keeps them.
+struct RenderLevelOfDetail
+{
+  struct Level
+  {
+    GLuint vboID;
+    GLuint iboID;
+    GLsizei numPrims;
+  };
+
+  // -- Data --
+  static const int MaxLevels = 4;
+  Level levels[MaxLevels];
+  int numLevels;
+
+  // -- Functions --
+  RenderLevelOfDetail() : numLevels(0) {}
+
+  static const char* getName() {return "RenderLevelOfDetail";}
+
+  /// Level to draw within a budget of maxPrims indices. Null when the full-resolution
+  /// buffers (fullPrims indices) fit, since those are drawn as is; otherwise the finest
+  /// level that fits, or the coarsest one.
+  const Level* select(int64_t fullPrims, int64_t maxPrims) const
+  {
+    if (fullPrims <= maxPrims)
+      return nullptr;
+    for (int i = 0; i < numLevels; ++i)
+      if (levels[i].numPrims <= maxPrims)
+        return &levels[i];
+    return numLevels > 0 ? &levels[numLevels - 1] : nullptr;
+  }
+
+  bool serialize(spire::ComponentSerialize& /* s */, uint64_t /* entityID */)
+  {
+    // Context specific, like RenderBasicGeom.
+    return true;
+  }
+};
+
+/// Whether the camera is being moved. Large surfaces draw a decimated level meanwhile.
+struct StaticLevelOfDetail
+{
+  // -- Data --
+  bool interacting;
+  int64_t maxInteractivePrims;  ///< Index budget per surface while interacting.
+
+  // -- Functions --
+  StaticLevelOfDetail() : interacting(false), maxInteractivePrims(1500000) {}
+
+  static const char* getName() {return "StaticLevelOfDetail";}
+
+  bool serialize(spire::ComponentSerialize& /* s */, uint64_t /* entityID */)
+  {
+    return true;
+  }
+};
+
+} // namespace Render
+} // namespace SCIRun
+
+#endif
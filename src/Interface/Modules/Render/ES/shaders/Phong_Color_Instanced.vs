@@ -0,0 +1,72 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+// Phong_Color drawn as instances of one template mesh. Each instance supplies the rows of
+// an affine transform that takes the template into place.
+
+// Uniforms
+uniform mat4    uModelViewProjection;
+uniform mat4    uModel;
+uniform mat4    uView;
+
+// Attributes
+attribute vec3  aPos;
+attribute vec3  aNormal;
+
+// Per-instance attributes
+attribute vec4  aInstanceRow0;
+attribute vec4  aInstanceRow1;
+attribute vec4  aInstanceRow2;
+attribute vec4  aInstanceColor;
+
+// Outputs to the fragment shader.
+varying vec3    vNormal;
+varying vec4    vPosWorld;
+varying vec4    vPosView;
+varying vec4    vColor;
+
+void main( void )
+{
+  vec4 pos = vec4(dot(aInstanceRow0, vec4(aPos, 1.0)),
+                  dot(aInstanceRow1, vec4(aPos, 1.0)),
+                  dot(aInstanceRow2, vec4(aPos, 1.0)), 1.0);
+
+  // Normals go through the cofactor matrix so non-uniform scales keep them perpendicular.
+  vec3 c0 = vec3(aInstanceRow0.x, aInstanceRow1.x, aInstanceRow2.x);
+  vec3 c1 = vec3(aInstanceRow0.y, aInstanceRow1.y, aInstanceRow2.y);
+  vec3 c2 = vec3(aInstanceRow0.z, aInstanceRow1.z, aInstanceRow2.z);
+  float handedness = dot(c0, cross(c1, c2)) < 0.0 ? -1.0 : 1.0;
+  vec3 normal = handedness * (cross(c1, c2) * aNormal.x + cross(c2, c0) * aNormal.y + cross(c0, c1) * aNormal.z);
+
+  vPosWorld = uModel * pos;
+  vPosView = uView * vPosWorld;
+  vNormal = normalize((uView * uModel * vec4(normal, 0.0)).xyz);
+  vColor = aInstanceColor;
+
+  gl_Position = uModelViewProjection * pos;
+}
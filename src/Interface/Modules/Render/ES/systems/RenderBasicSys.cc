@@ -57,6 +57,8 @@
 #include "../comp/RenderBasicGeom.h"
 #include "../comp/SRRenderState.h"
 #include "../comp/RenderList.h"
+#include "../comp/RenderInstances.h"
+#include "../comp/RenderLevelOfDetail.h"
 #include "../comp/StaticWorldLight.h"
 #include "../comp/StaticClippingPlanes.h"
 #include "../comp/LightingUniforms.h"
@@ -73,6 +75,8 @@ class RenderBasicSys :
                              RenderBasicGeom,   // TAG class
                              SRRenderState,
                              RenderList,
+                             RenderInstances,
+                             RenderLevelOfDetail,
                              LightingUniforms,
                              ClippingPlaneUniforms,
                              gen::Transform,
@@ -87,6 +91,7 @@ class RenderBasicSys :
                              ren::GLState,
                              StaticWorldLight,
                              StaticClippingPlanes,
+                             StaticLevelOfDetail,
                              gen::StaticCamera,
                              ren::StaticGLState,
                              ren::StaticVBOMan,
@@ -99,6 +104,9 @@ public:
   bool isComponentOptional(uint64_t type) override
   {
     return spire::OptionalComponents<RenderList,
+                                  RenderInstances,
+                                  RenderLevelOfDetail,
+                                  StaticLevelOfDetail,
                                   ren::GLState,
                                   ren::StaticGLState,
                                   ren::CommonUniforms,
@@ -115,6 +123,8 @@ public:
       const spire::ComponentGroup<RenderBasicGeom>& geom,
       const spire::ComponentGroup<SRRenderState>& srstate,
       const spire::ComponentGroup<RenderList>& rlist,
+      const spire::ComponentGroup<RenderInstances>& instances,
+      const spire::ComponentGroup<RenderLevelOfDetail>& lod,
       const spire::ComponentGroup<LightingUniforms>& lightUniforms,
       const spire::ComponentGroup<ClippingPlaneUniforms>& clippingPlaneUniforms,
       const spire::ComponentGroup<gen::Transform>& trafo,
@@ -129,6 +139,7 @@ public:
       const spire::ComponentGroup<ren::GLState>& state,
       const spire::ComponentGroup<StaticWorldLight>& worldLight,
       const spire::ComponentGroup<StaticClippingPlanes>& clippingPlanes,
+      const spire::ComponentGroup<StaticLevelOfDetail>& lodState,
       const spire::ComponentGroup<gen::StaticCamera>& camera,
       const spire::ComponentGroup<ren::StaticGLState>& defaultGLState,
       const spire::ComponentGroup<ren::StaticVBOMan>& vboMan,
@@ -148,7 +159,20 @@ public:
       return;
     }
 
+    GLuint vboID = vbo.front().glid;
     GLuint iboID = ibo.front().glid;
+    GLsizei numPrims = ibo.front().numPrims;
+
+    // While the camera moves, surfaces over the budget draw a decimated level with the same layout.
+    if (lod.size() > 0 && lodState.size() > 0 && lodState.front().interacting)
+    {
+      if (const auto* level = lod.front().select(numPrims, lodState.front().maxInteractivePrims))
+      {
+        vboID = level->vboID;
+        iboID = level->iboID;
+        numPrims = level->numPrims;
+      }
+    }
 
     // Setup *everything*. We don't want to enter multiple conditional
     // statements if we can avoid it. So we assume everything has not been
@@ -191,6 +215,9 @@ public:
 
       if (clippingPlaneUniforms.size() > 0)
         const_cast<ClippingPlaneUniforms&>(clippingPlaneUniforms.front()).checkUniformArray(shader.front().glid);
+
+      if (instances.size() > 0)
+        const_cast<RenderInstances&>(instances.front()).setup(shader.front().glid, vboMan.front());
     }
 
     // Check to see if we have GLState. If so, apply it relative to the
@@ -208,7 +235,7 @@ public:
     GL(glUseProgram(shader.front().glid));
 
     // Bind VBO and IBO
-    GL(glBindBuffer(GL_ARRAY_BUFFER, vbo.front().glid));
+    GL(glBindBuffer(GL_ARRAY_BUFFER, vboID));
     GL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, iboID));
 
     bool depthMask = glIsEnabled(GL_DEPTH_WRITEMASK);
@@ -255,7 +282,26 @@ public:
 
     geom.front().attribs.bind();
 
-    GL(glDrawElements(ibo.front().primMode, ibo.front().numPrims, ibo.front().primType, nullptr));
+#ifndef USE_OPENGL_ES
+    if (instances.size() > 0)
+    {
+      // The template mesh is drawn once per instance; instance attributes come from their own
+      // buffer and advance once per instance.
+      const RenderInstances& inst = instances.front();
+      GL(glBindBuffer(GL_ARRAY_BUFFER, inst.glid));
+      inst.attribs.bind();
+      inst.setDivisor(1);
+      GL(glDrawElementsInstancedARB(ibo.front().primMode, ibo.front().numPrims, ibo.front().primType,
+                                    nullptr, static_cast<GLsizei>(inst.count)));
+      inst.setDivisor(0);
+      inst.attribs.unbind();
+      GL(glBindBuffer(GL_ARRAY_BUFFER, vbo.front().glid));
+    }
+    else
+#endif
+    {
+      GL(glDrawElements(ibo.front().primMode, numPrims, ibo.front().primType, nullptr));
+    }
 
     if (!depthMask)
     {
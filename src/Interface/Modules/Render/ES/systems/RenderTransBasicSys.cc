@@ -62,6 +62,7 @@
 #include "../comp/StaticClippingPlanes.h"
 #include "../comp/LightingUniforms.h"
 #include "../comp/ClippingPlaneUniforms.h"
+#include "../TransparencySorter.h"
 
 namespace es = spire;
 namespace shaders = spire;
@@ -118,114 +119,115 @@ public:
   }
 
 private:
-  class SortedObject
+  // One sorted index buffer per transparent IBO, refilled in place whenever its order changes.
+  struct SortedObject
   {
-  public:
-    std::string mName;
-    GLuint mSortedID;
+    GLuint mSortedID = 0;
+    size_t mBytes = 0;
+    std::weak_ptr<spire::VarBuffer> mSource;
     Core::Geometry::Vector prevDir = Core::Geometry::Vector(0.0);
-
-    SortedObject() :
-      mSortedID(0)
-    {}
-
-    SortedObject(const std::string& name, GLuint ID, Core::Geometry::Vector& dir) :
-      mName(name),
-      mSortedID(ID),
-      prevDir(dir)
-    {}
+    int mAxis = -1;
   };
 
-  std::vector<SortedObject> sortedObjects;
-
-  class DepthIndex {
-  public:
-    size_t mIndex;
-    double mDepth;
+  std::map<std::string, SortedObject> sortedObjects;
+  TransparencySorter sorter;
+  std::vector<uint32_t> sortedIndices;
 
-    DepthIndex() :
-      mIndex(0),
-      mDepth(0.0)
-    {}
-
-    DepthIndex(size_t index, double depth) :
-      mIndex(index),
-      mDepth(depth)
-    {}
+  void uploadOrder(SortedObject& sorted, const SpireIBO& ibo, const TransparencySorter::TriangleOrder& order)
+  {
+    TransparencySorter::applyOrder(ibo, order, sortedIndices);
+    size_t bytes = sortedIndices.size() * sizeof(uint32_t);
 
-    bool operator<(const DepthIndex& di) const
+    if (sorted.mSortedID == 0)
+      GL(glGenBuffers(1, &sorted.mSortedID));
+    GL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sorted.mSortedID));
+    if (bytes == sorted.mBytes)
     {
-      return this->mDepth < di.mDepth;
+      GL(glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(bytes), sortedIndices.data()));
+    }
+    else
+    {
+      GL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), sortedIndices.data(), GL_DYNAMIC_DRAW));
+      sorted.mBytes = bytes;
     }
-  };
-
-  GLuint addIBO(void* iboData, size_t iboDataSize)
-  {
-    GLuint glid;
-
-    GL(glGenBuffers(1, &glid));
-    GL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, glid));
-    GL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, static_cast<GLsizeiptr>(iboDataSize), iboData, GL_STATIC_DRAW));
-
-    return glid;
   }
 
-  void removeIBO(GLuint glid)
+  void removeSorted(SortedObject& sorted)
   {
-    GL(glDeleteBuffers(1, &glid));
+    if (sorted.mSortedID != 0)
+      GL(glDeleteBuffers(1, &sorted.mSortedID));
+    sorted = SortedObject();
   }
 
-  GLuint sortObjects(const Core::Geometry::Vector& dir,
-    const spire::ComponentGroup<ren::IBO>& ibo,
-    const spire::ComponentGroup<SpireSubPass>& pass,
-    const spire::ComponentGroup<ren::StaticIBOMan>& iboMan)
+  GLuint sortedIBO(const Core::Geometry::Vector& dir, const SpireSubPass& pass, GLuint unsortedID)
   {
-    char* vbo_buffer = reinterpret_cast<char*>(pass.front().vbo.data->getBuffer());
-    uint32_t* ibo_buffer = reinterpret_cast<uint32_t*>(pass.front().ibo.data->getBuffer());
-    size_t num_triangles = pass.front().ibo.data->getBufferSize() / (sizeof(uint32_t) * 3);
-
-    size_t stride_vbo = 0;
-    for (auto a : pass.front().vbo.attributes)
-      stride_vbo += a.sizeInBytes;
-
-    std::vector<DepthIndex> rel_depth(num_triangles);
+    const auto& ibo = pass.ibo;
+    if (!TransparencySorter::isSortable(ibo))
+      return unsortedID;
 
-
-    for (size_t j = 0; j < num_triangles; j++)
+    auto& sorted = sortedObjects[ibo.name];
+    if (sorted.mSource.lock() != ibo.data)
     {
-      float* vertex1 = reinterpret_cast<float*>(vbo_buffer + stride_vbo * (ibo_buffer[j * 3]));
-      Core::Geometry::Point node1(vertex1[0], vertex1[1], vertex1[2]);
-
-      float* vertex2 = reinterpret_cast<float*>(vbo_buffer + stride_vbo * (ibo_buffer[j * 3 + 1]));
-      Core::Geometry::Point node2(vertex2[0], vertex2[1], vertex2[2]);
-
-      float* vertex3 = reinterpret_cast<float*>(vbo_buffer + stride_vbo * (ibo_buffer[j * 3 + 2]));
-      Core::Geometry::Point node3(vertex3[0], vertex3[1], vertex3[2]);
-
-      rel_depth[j].mDepth = Core::Geometry::Dot(dir, node1) + Core::Geometry::Dot(dir, node2) + Core::Geometry::Dot(dir, node3);
-      rel_depth[j].mIndex = j;
+      removeSorted(sorted);
+      sorted.mSource = ibo.data;
     }
 
-    std::sort(rel_depth.begin(), rel_depth.end());
-
-    std::vector<char> sorted_buffer(pass.front().ibo.data->getBufferSize());
-    char* ibuffer = reinterpret_cast<char*>(pass.front().ibo.data->getBuffer());
-    char* sbuffer = !sorted_buffer.empty() ? reinterpret_cast<char*>(&sorted_buffer[0]) : nullptr;
-    GLuint result = ibo.front().glid;
-    if (sbuffer && num_triangles > 0)
+    switch (pass.renderState.mSortType)
     {
-      size_t tri_size = pass.front().ibo.data->getBufferSize() / num_triangles;
-
-      for (size_t j = 0; j < num_triangles; j++)
+      case RenderState::TransparencySortType::CONTINUOUS_SORT:
       {
-        memcpy(sbuffer + j * tri_size, ibuffer + rel_depth[j].mIndex * tri_size, tri_size);
+        uploadOrder(sorted, ibo, TransparencySorter::sortTriangles(pass.vbo, ibo, dir));
+        break;
       }
+      case RenderState::TransparencySortType::UPDATE_SORT:
+      {
+        // The first order is computed here so the object never draws unsorted; later view
+        // changes are re-sorted on a worker thread while the previous order stays on screen.
+        if (sorted.mSortedID == 0)
+        {
+          uploadOrder(sorted, ibo, TransparencySorter::sortTriangles(pass.vbo, ibo, dir));
+          sorted.prevDir = dir;
+        }
+        else
+        {
+          if (auto order = sorter.takeResult(ibo.name, ibo))
+            uploadOrder(sorted, ibo, *order);
 
-      std::string transIBOName = pass.front().ibo.name + "trans";
-      result = addIBO(sbuffer, pass.front().ibo.data->getBufferSize());
+          Core::Geometry::Vector diff = sorted.prevDir - dir;
+          if (diff.length() >= 1.23 && !sorter.sortPending(ibo.name))
+          {
+            sorted.prevDir = dir;
+            sorter.requestSort(ibo.name, pass.vbo, ibo, dir);
+          }
+        }
+        break;
+      }
+      case RenderState::TransparencySortType::LISTS_SORT:
+      {
+        int axis = static_cast<int>(TransparencySorter::nearestAxis(dir));
+        if (axis != sorted.mAxis)
+        {
+          uploadOrder(sorted, ibo, *sorter.axisOrder(pass.vbo, ibo, static_cast<TransparencySorter::Axis>(axis)));
+          sorted.mAxis = axis;
+        }
+        break;
+      }
     }
+    return sorted.mSortedID;
+  }
 
-    return result;
+  void postWalkComponents(spire::ESCoreBase&) override
+  {
+    for (auto it = sortedObjects.begin(); it != sortedObjects.end();)
+    {
+      if (it->second.mSource.expired())
+      {
+        removeSorted(it->second);
+        it = sortedObjects.erase(it);
+      }
+      else
+        ++it;
+    }
   }
 
   void groupExecute(
@@ -283,93 +285,7 @@ private:
 
     if (!drawLines)
     {
-      switch (pass.front().renderState.mSortType)
-      {
-        case RenderState::TransparencySortType::CONTINUOUS_SORT:
-        {
-          iboID = sortObjects(dir, ibo, pass, iboMan);
-          break;
-        }
-        case RenderState::TransparencySortType::UPDATE_SORT:
-        {
-          unsigned int index = 0;
-          bool indexed = false;
-          for (int i = 0; i < sortedObjects.size(); ++i)
-          {
-            if (sortedObjects[i].mName == pass.front().ibo.name)
-            {
-              indexed = true;
-              index = i;
-            }
-          }
-          if (!indexed)
-          {
-            index = sortedObjects.size();
-            sortedObjects.push_back(SortedObject(pass.front().ibo.name, 0, dir));
-          }
-
-          Core::Geometry::Vector diff = sortedObjects[index].prevDir - dir;
-          double distance = sqrtf(Dot(diff, diff));
-          if (distance >= 1.23 || sortedObjects[index].mSortedID == 0)
-          {
-            if (sortedObjects[index].mSortedID != 0)
-            {
-              removeIBO(sortedObjects[index].mSortedID);
-            }
-            sortedObjects[index].prevDir = dir;
-            sortedObjects[index].mSortedID = sortObjects(dir, ibo, pass, iboMan);
-          }
-          iboID = sortedObjects[index].mSortedID;
-          break;
-        }
-        case RenderState::TransparencySortType::LISTS_SORT:
-        {
-          GLuint iboXID = ibo.front().glid;
-          GLuint iboYID = ibo.front().glid;
-          GLuint iboZID = ibo.front().glid;
-          GLuint iboNegXID = ibo.front().glid;
-          GLuint iboNegYID = ibo.front().glid;
-          GLuint iboNegZID = ibo.front().glid;
-
-          int index = 0;
-          for (auto it = ibo.begin(); it != ibo.end(); ++it, ++index)
-          {
-            if (index == 1)
-              iboXID = it->glid;
-            if (index == 2)
-              iboYID = it->glid;
-            if (index == 3)
-              iboZID = it->glid;
-            if (index == 4)
-              iboNegXID = it->glid;
-            if (index == 5)
-              iboNegYID = it->glid;
-            if (index == 6)
-              iboNegZID = it->glid;
-          }
-
-          Core::Geometry::Vector absDir(fabs(camera.front().data.view[0][2]),
-                                        fabs(camera.front().data.view[1][2]),
-                                        fabs(camera.front().data.view[2][2]));
-
-          double xORy = absDir.x() > absDir.y() ? absDir.x() : absDir.y();
-          double orZ = absDir.z() > xORy ? absDir.z() : xORy;
-
-          if (orZ == absDir.x())
-          {
-            iboID = dir.x() < orZ ? iboNegXID : iboXID;
-          }
-          if (orZ == absDir.y())
-          {
-            iboID = dir.y() < orZ ? iboNegYID : iboYID;
-          }
-          if (orZ == absDir.z())
-          {
-            iboID = dir.z() < orZ ? iboNegZID : iboZID;
-          }
-          break;
-        }
-      }
+      iboID = sortedIBO(dir, pass.front(), iboID);
     }
 
     // Setup *everything*. We don't want to enter multiple conditional
@@ -594,15 +510,6 @@ private:
       }
     }
 
-
-    if (!drawLines)
-    {
-      if (pass.front().renderState.mSortType == RenderState::TransparencySortType::CONTINUOUS_SORT)
-      {
-        removeIBO(iboID);
-      }
-    }
-
     if (depthMask)
     {
       GL(glDepthMask(GL_TRUE));
@@ -0,0 +1,66 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Interface/Modules/Render/ES/comp/RenderLevelOfDetail.h>
+#include <gtest/gtest.h>
+
+using namespace SCIRun::Render;
+
+namespace
+{
+  RenderLevelOfDetail threeLevels()
+  {
+    RenderLevelOfDetail lod;
+    lod.levels[lod.numLevels++] = { 1, 2, 600 };
+    lod.levels[lod.numLevels++] = { 3, 4, 300 };
+    lod.levels[lod.numLevels++] = { 5, 6, 120 };
+    return lod;
+  }
+}
+
+TEST(RenderLevelOfDetailTest, FullResolutionIsDrawnWhenItFits)
+{
+  auto lod = threeLevels();
+  EXPECT_EQ(nullptr, lod.select(1200, 1200));
+  EXPECT_EQ(nullptr, lod.select(1200, 5000));
+}
+
+TEST(RenderLevelOfDetailTest, FinestLevelWithinBudgetIsSelected)
+{
+  auto lod = threeLevels();
+  EXPECT_EQ(&lod.levels[0], lod.select(1200, 1000));
+  EXPECT_EQ(&lod.levels[1], lod.select(1200, 599));
+  EXPECT_EQ(&lod.levels[2], lod.select(1200, 120));
+}
+
+TEST(RenderLevelOfDetailTest, CoarsestLevelIsUsedOverBudget)
+{
+  auto lod = threeLevels();
+  EXPECT_EQ(&lod.levels[2], lod.select(1200, 10));
+  EXPECT_EQ(nullptr, RenderLevelOfDetail().select(1200, 10));
+}
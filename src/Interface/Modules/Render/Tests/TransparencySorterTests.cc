@@ -0,0 +1,213 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Interface/Modules/Render/ES/TransparencySorter.h>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <thread>
+
+using namespace SCIRun::Render;
+using namespace SCIRun::Graphics::Datatypes;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  // Triangle soup with interleaved aPos/aNormal attributes, like ShowField's face passes.
+  struct Soup
+  {
+    SpireVBO vbo;
+    SpireIBO ibo;
+  };
+
+  Soup makeSoup(size_t numTriangles, unsigned seed = 7)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+    auto vboData = std::make_shared<spire::VarBuffer>(numTriangles * 3 * 6 * sizeof(float));
+    auto iboData = std::make_shared<spire::VarBuffer>(numTriangles * 3 * sizeof(uint32_t));
+    for (size_t v = 0; v < numTriangles * 3; ++v)
+    {
+      for (int c = 0; c < 3; ++c)
+        vboData->write(coord(gen));
+      for (int c = 0; c < 3; ++c)
+        vboData->write(0.0f);
+    }
+    // Reverse the vertex order so the index buffer is not trivially sorted.
+    for (size_t v = numTriangles * 3; v > 0; --v)
+      iboData->write(static_cast<uint32_t>(v - 1));
+
+    std::vector<SpireVBO::AttributeData> attribs { {"aPos", 3 * sizeof(float)}, {"aNormal", 3 * sizeof(float)} };
+    Soup soup;
+    soup.vbo = SpireVBO("soupVBO", attribs, vboData, numTriangles * 3, BBox(), true);
+    soup.ibo = SpireIBO("soupIBO", SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), iboData);
+    return soup;
+  }
+
+  std::vector<double> triangleDepths(const Soup& soup, const Vector& dir)
+  {
+    const auto* verts = reinterpret_cast<const float*>(soup.vbo.data->getBuffer());
+    const auto* indices = reinterpret_cast<const uint32_t*>(soup.ibo.data->getBuffer());
+    size_t numTriangles = soup.ibo.data->getBufferSize() / (3 * sizeof(uint32_t));
+    std::vector<double> depths(numTriangles);
+    for (size_t j = 0; j < numTriangles; ++j)
+      for (int v = 0; v < 3; ++v)
+      {
+        const float* p = verts + 6 * indices[3 * j + v];
+        depths[j] += Dot(dir, Vector(p[0], p[1], p[2]));
+      }
+    return depths;
+  }
+
+  void expectBackToFront(const Soup& soup, const Vector& dir, const TransparencySorter::TriangleOrder& order)
+  {
+    auto depths = triangleDepths(soup, dir);
+    ASSERT_EQ(depths.size(), order.size());
+
+    std::vector<uint32_t> seen(order);
+    std::sort(seen.begin(), seen.end());
+    for (size_t j = 0; j < seen.size(); ++j)
+      ASSERT_EQ(j, seen[j]);
+
+    auto range = *std::max_element(depths.begin(), depths.end()) - *std::min_element(depths.begin(), depths.end());
+    for (size_t j = 1; j < order.size(); ++j)
+      ASSERT_LE(depths[order[j - 1]], depths[order[j]] + 1e-6 * range) << j;
+  }
+}
+
+TEST(TransparencySorterTest, RadixSortIsStable)
+{
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<uint32_t> key(0, 1000);
+  for (size_t n : { size_t(0), size_t(1), size_t(17), size_t(200000) })
+  {
+    std::vector<uint32_t> keys(n);
+    for (auto& k : keys)
+      k = key(gen) * 4099u;
+
+    std::vector<uint32_t> expected(n);
+    std::iota(expected.begin(), expected.end(), 0);
+    std::stable_sort(expected.begin(), expected.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+    auto sortedKeys = keys;
+    TransparencySorter::TriangleOrder order;
+    TransparencySorter::radixSort(sortedKeys, order);
+    EXPECT_EQ(expected, order);
+    EXPECT_TRUE(std::is_sorted(sortedKeys.begin(), sortedKeys.end()));
+  }
+}
+
+TEST(TransparencySorterTest, SortsTrianglesBackToFront)
+{
+  auto soup = makeSoup(50000);
+  for (const auto& dir : { Vector(0, 0, 1), Vector(-1, 0, 0), Vector(0.3, -0.5, 0.81) })
+    expectBackToFront(soup, dir, TransparencySorter::sortTriangles(soup.vbo, soup.ibo, dir));
+
+  std::vector<uint32_t> indices;
+  auto order = TransparencySorter::sortTriangles(soup.vbo, soup.ibo, Vector(0, 1, 0));
+  TransparencySorter::applyOrder(soup.ibo, order, indices);
+  const auto* original = reinterpret_cast<const uint32_t*>(soup.ibo.data->getBuffer());
+  ASSERT_EQ(order.size() * 3, indices.size());
+  for (size_t j = 0; j < order.size(); ++j)
+    for (int v = 0; v < 3; ++v)
+      ASSERT_EQ(original[3 * order[j] + v], indices[3 * j + v]);
+}
+
+TEST(TransparencySorterTest, UnsortableBuffersAreLeftAlone)
+{
+  auto soup = makeSoup(10);
+  soup.ibo.prim = SpireIBO::PRIMITIVE::LINES;
+  EXPECT_FALSE(TransparencySorter::isSortable(soup.ibo));
+  EXPECT_TRUE(TransparencySorter::sortTriangles(soup.vbo, soup.ibo, Vector(0, 0, 1)).empty());
+}
+
+TEST(TransparencySorterTest, NearestAxisFollowsDominantComponent)
+{
+  EXPECT_EQ(TransparencySorter::Axis::NEG_X, TransparencySorter::nearestAxis(Vector(-0.9, 0.1, 0.3)));
+  EXPECT_EQ(TransparencySorter::Axis::Y, TransparencySorter::nearestAxis(Vector(0.2, 0.7, -0.3)));
+  EXPECT_EQ(TransparencySorter::Axis::NEG_Z, TransparencySorter::nearestAxis(Vector(0.1, 0.1, -0.5)));
+}
+
+TEST(TransparencySorterTest, AxisOrdersAreCachedWithinBudget)
+{
+  auto soup = makeSoup(1000);
+  const size_t orderBytes = 1000 * sizeof(uint32_t);
+  TransparencySorter sorter(2 * orderBytes);
+
+  auto x = sorter.axisOrder(soup.vbo, soup.ibo, TransparencySorter::Axis::X);
+  expectBackToFront(soup, Vector(1, 0, 0), *x);
+  EXPECT_EQ(x, sorter.axisOrder(soup.vbo, soup.ibo, TransparencySorter::Axis::X));
+  EXPECT_EQ(orderBytes, sorter.cachedBytes());
+
+  for (int axis = 0; axis < 6; ++axis)
+    expectBackToFront(soup, TransparencySorter::axisDirection(static_cast<TransparencySorter::Axis>(axis)),
+      *sorter.axisOrder(soup.vbo, soup.ibo, static_cast<TransparencySorter::Axis>(axis)));
+  EXPECT_EQ(2 * orderBytes, sorter.cachedBytes());
+
+  // Replacing the object's buffers drops its cached orders.
+  auto other = makeSoup(10, 11);
+  soup = Soup();
+  sorter.axisOrder(other.vbo, other.ibo, TransparencySorter::Axis::Z);
+  EXPECT_EQ(10 * sizeof(uint32_t), sorter.cachedBytes());
+}
+
+TEST(TransparencySorterTest, BackgroundSortMatchesForegroundSort)
+{
+  auto soup = makeSoup(40000);
+  Vector dir(0.5, 0.5, -0.7);
+  TransparencySorter sorter;
+  sorter.requestSort("soup", soup.vbo, soup.ibo, dir);
+  EXPECT_TRUE(sorter.sortPending("soup"));
+
+  TransparencySorter::TriangleOrderHandle order;
+  while (!(order = sorter.takeResult("soup", soup.ibo)))
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_FALSE(sorter.sortPending("soup"));
+  EXPECT_EQ(TransparencySorter::sortTriangles(soup.vbo, soup.ibo, dir), *order);
+
+  // A result computed for buffers that have since been replaced is discarded.
+  sorter.requestSort("soup", soup.vbo, soup.ibo, dir);
+  auto replaced = makeSoup(100, 5);
+  while (sorter.sortPending("soup") && !sorter.takeResult("soup", replaced.ibo))
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  EXPECT_FALSE(sorter.sortPending("soup"));
+}
+
+TEST(TransparencySorterTest, SortsSoupSplitAcrossTasks)
+{
+  // Large enough for the depth and radix passes to run as several tasks.
+  const size_t n = 100000;
+  auto soup = makeSoup(n);
+  Vector dir(0.3, -0.5, 0.81);
+
+  auto order = TransparencySorter::sortTriangles(soup.vbo, soup.ibo, dir);
+  ASSERT_EQ(n, order.size());
+  expectBackToFront(soup, dir, order);
+}
@@ -65,6 +65,8 @@ ShowFieldDialog::ShowFieldDialog(const std::string& name, ModuleStateHandle stat
   addCheckBoxManager(textAlwaysVisibleCheckBox_, Parameters::TextAlwaysVisible);
   addCheckBoxManager(renderIndicesLocationsCheckBox_, Parameters::RenderAsLocation);
   addCheckBoxManager(useFaceNormalsCheckBox_, Parameters::UseFaceNormals);
+  addCheckBoxManager(boundaryFacesOnlyCheckBox_, Parameters::BoundaryFacesOnly);
+  addCheckBoxManager(boundaryFacesByDomainCheckBox_, Parameters::BoundaryFacesByDomain);
   addDoubleSpinBoxManager(transparencyDoubleSpinBox_, Parameters::FaceTransparencyValue);
   addDoubleSpinBoxManager(nodeTransparencyDoubleSpinBox_, Parameters::NodeTransparencyValue);
   addDoubleSpinBoxManager(edgeTransparencyDoubleSpinBox_, Parameters::EdgeTransparencyValue);
@@ -92,7 +94,8 @@ ShowFieldDialog::ShowFieldDialog(const std::string& name, ModuleStateHandle stat
     defaultFaceColoringButton_, colormapLookupFaceColoringButton_, /*conversionRGBFaceColoringButton_*/
     defaultMeshColorButton_, textColorPushButton_ });
 
-  connectButtonToExecuteSignal(useFaceNormalsCheckBox_);
+  connectButtonsToExecuteSignal({ useFaceNormalsCheckBox_, boundaryFacesOnlyCheckBox_, boundaryFacesByDomainCheckBox_ });
+  connect(boundaryFacesOnlyCheckBox_, SIGNAL(toggled(bool)), boundaryFacesByDomainCheckBox_, SLOT(setEnabled(bool)));
 
   createExecuteInteractivelyToggleAction();
 
@@ -49,12 +49,14 @@ ShowFieldGlyphsDialog::ShowFieldGlyphsDialog(const std::string& name, ModuleStat
   setupTensorsTab();
 
   addLineEditManager(lineEdit, ShowFieldGlyphs::FieldName);
+  addCheckBoxManager(glyphInstancingCheckBox_, ShowFieldGlyphs::GlyphInstancing);
   WidgetStyleMixin::tabStyle(this->displayOptionsTabs_);
 
   createExecuteInteractivelyToggleAction();
 
   connect(defaultMeshColorButton_, SIGNAL(clicked()), this, SLOT(assignDefaultMeshColor()));
   connectButtonToExecuteSignal(defaultMeshColorButton_);
+  connectButtonToExecuteSignal(glyphInstancingCheckBox_);
 }
 
 void ShowFieldGlyphsDialog::push()
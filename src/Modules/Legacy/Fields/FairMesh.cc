@@ -56,6 +56,7 @@ void FairMesh::setStateDefaults()
   setStateIntFromAlgo(Parameters::NumIterations);
   setStateDoubleFromAlgo(Parameters::Lambda);
   setStateDoubleFromAlgo(Parameters::FilterCutoff);
+  setStateBoolFromAlgo(Parameters::ImplicitFairing);
 }
 
 void FairMesh::execute()
@@ -68,6 +69,7 @@ void FairMesh::execute()
     setAlgoIntFromState(Parameters::NumIterations);
     setAlgoDoubleFromState(Parameters::Lambda);
     setAlgoDoubleFromState(Parameters::FilterCutoff);
+    setAlgoBoolFromState(Parameters::ImplicitFairing);
     setAlgoOptionFromState(Parameters::FairMeshMethod);
 
     auto output = algo().run(withInputData((Input_Mesh, input)));
@@ -0,0 +1,84 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Modules/Legacy/FiniteElements/BuildLeadField.h>
+#include <Core/Algorithms/Legacy/FiniteElements/LeadField/BuildLeadField.h>
+
+using namespace SCIRun::Modules::FiniteElements;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::FiniteElements;
+using namespace SCIRun;
+
+MODULE_INFO_DEF(BuildLeadField, FiniteElements, SCIRun)
+
+BuildLeadField::BuildLeadField()
+  : Module(staticInfo_, HasUI<BuildLeadField>::value)
+{
+  INITIALIZE_PORT(FEM_Stiffness_Matrix);
+  INITIALIZE_PORT(FEM_Mesh);
+  INITIALIZE_PORT(Electrode_Nodes);
+  INITIALIZE_PORT(Dipole_Positions);
+  INITIALIZE_PORT(LeadField);
+}
+
+void BuildLeadField::setStateDefaults()
+{
+  setStateIntFromAlgo(Parameters::ReferenceNode);
+  setStateBoolFromAlgo(Parameters::AverageReference);
+  setStateStringFromAlgoOption(Variables::Method);
+  setStateDoubleFromAlgo(Variables::TargetError);
+  setStateIntFromAlgo(Variables::MaxIterations);
+}
+
+void BuildLeadField::execute()
+{
+  auto stiffness = getRequiredInput(FEM_Stiffness_Matrix);
+  auto mesh = getRequiredInput(FEM_Mesh);
+  auto electrodes = getRequiredInput(Electrode_Nodes);
+  auto sources = getRequiredInput(Dipole_Positions);
+
+  if (needToExecute())
+  {
+    setAlgoIntFromState(Parameters::ReferenceNode);
+    setAlgoBoolFromState(Parameters::AverageReference);
+    setAlgoOptionFromState(Variables::Method);
+    setAlgoDoubleFromState(Variables::TargetError);
+    setAlgoIntFromState(Variables::MaxIterations);
+
+    auto output = algo().run(withInputData((FEM_Stiffness_Matrix, stiffness)(FEM_Mesh, mesh)(Electrode_Nodes, electrodes)(Dipole_Positions, sources)));
+
+    sendOutputFromAlgorithm(LeadField, output);
+  }
+}
@@ -37,6 +37,7 @@
 #include <Modules/Legacy/Inverse/LCurvePlot.h>
 #include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithTSVD_impl.h>
 #include <Core/Algorithms/Legacy/Inverse/TikhonovAlgoAbstractBase.h>
+#include <Core/Algorithms/Math/RandomizedSVD.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 
@@ -47,6 +48,7 @@ using namespace SCIRun::Modules::Inverse;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Inverse;
+namespace SVDParameters = SCIRun::Core::Algorithms::Math::Parameters;
 
 // Module definitions. Sets the info into the staticInfo_
 MODULE_INFO_DEF(SolveInverseProblemWithTSVD, Inverse, SCIRun)
@@ -82,6 +84,12 @@ void SolveInverseProblemWithTSVD::setStateDefaults()
   setStateStringFromAlgoOption(Parameters::RegularizationMethod);
   setStateDoubleFromAlgo(Parameters::LambdaFromDirectEntry);
   setStateDoubleFromAlgo(Parameters::LambdaSliderValue);
+  setStateStringFromAlgoOption(SVDParameters::SVDMethod);
+  setStateIntFromAlgo(SVDParameters::SVDRank);
+  setStateIntFromAlgo(SVDParameters::SVDOversampling);
+  setStateIntFromAlgo(SVDParameters::SVDPowerIterations);
+  setStateIntFromAlgo(Parameters::StreamingChunkSize);
+  setStateStringFromAlgo(Parameters::StreamingOutputFile);
 }
 
 void SolveInverseProblemWithTSVD::execute()
@@ -102,21 +110,32 @@ void SolveInverseProblemWithTSVD::execute()
 
 	if (needToExecute())
 	{
+		// set parameters
+		auto state = get_state();
+
 		// Obtain rank of forward matrix
 		int rank;
 		if ( hSingularValues ) {
 			rank = (*hSingularValues)->nrows();
 		}
+		else if (state->getValue(SVDParameters::SVDMethod).toString() == "randomized") {
+			// the truncated factorization never holds more than the requested rank
+			rank = std::min(state->getValue(SVDParameters::SVDRank).toInt(),
+				static_cast<int>(std::min(forward_matrix_h->nrows(), forward_matrix_h->ncols())));
+		}
 		else{
 			Eigen::FullPivLU<SCIRun::Core::Datatypes::DenseMatrix::EigenBase> lu_decomp(*forward_matrix_h);
 			rank = lu_decomp.rank();
 		}
 
-		// set parameters
-		auto state = get_state();
-
 		state->setValue( Parameters::TikhonovImplementation, std::string("TSVD") );
 		setAlgoStringFromState(Parameters::TikhonovImplementation);
+		setAlgoOptionFromState(SVDParameters::SVDMethod);
+		setAlgoIntFromState(SVDParameters::SVDRank);
+		setAlgoIntFromState(SVDParameters::SVDOversampling);
+		setAlgoIntFromState(SVDParameters::SVDPowerIterations);
+		setAlgoIntFromState(Parameters::StreamingChunkSize);
+		setAlgoStringFromState(Parameters::StreamingOutputFile);
 		setAlgoOptionFromState(Parameters::RegularizationMethod);
 		setAlgoDoubleFromState(Parameters::LambdaFromDirectEntry);
 
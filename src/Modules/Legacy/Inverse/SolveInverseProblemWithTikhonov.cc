@@ -77,6 +77,8 @@ void SolveInverseProblemWithTikhonov::setStateDefaults()
 	setStateDoubleFromAlgo(Parameters::LambdaSliderValue);
 	setStateIntFromAlgo(Parameters::regularizationSolutionSubcase);
 	setStateIntFromAlgo(Parameters::regularizationResidualSubcase);
+	setStateIntFromAlgo(Parameters::StreamingChunkSize);
+	setStateStringFromAlgo(Parameters::StreamingOutputFile);
 }
 // execute function
 void SolveInverseProblemWithTikhonov::execute()
@@ -108,6 +110,8 @@ void SolveInverseProblemWithTikhonov::execute()
     setAlgoDoubleFromState(Parameters::LambdaSliderValue);
     setAlgoIntFromState(Parameters::regularizationSolutionSubcase);
     setAlgoIntFromState(Parameters::regularizationResidualSubcase);
+    setAlgoIntFromState(Parameters::StreamingChunkSize);
+    setAlgoStringFromState(Parameters::StreamingOutputFile);
 
 		// run
 		auto output = algo().run( withInputData((ForwardMatrix, forward_matrix_h)(MeasuredPotentials,hMatrixMeasDat)(MeasuredPotentials,hMatrixMeasDat)(WeightingInSourceSpace,optionalAlgoInput(hMatrixRegMat))(WeightingInSensorSpace,optionalAlgoInput(hMatrixNoiseCov))) );
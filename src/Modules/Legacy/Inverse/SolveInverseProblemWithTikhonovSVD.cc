@@ -37,6 +37,7 @@
 #include <Modules/Legacy/Inverse/LCurvePlot.h>
 #include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithTikhonovSVD_impl.h>
 #include <Core/Algorithms/Legacy/Inverse/TikhonovAlgoAbstractBase.h>
+#include <Core/Algorithms/Math/RandomizedSVD.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 
@@ -47,6 +48,7 @@ using namespace SCIRun::Modules::Inverse;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Inverse;
+namespace SVDParameters = SCIRun::Core::Algorithms::Math::Parameters;
 
 // Module definitions. Sets the info into the staticInfo_
 MODULE_INFO_DEF(SolveInverseProblemWithTikhonovSVD, Inverse, SCIRun)
@@ -79,6 +81,12 @@ void SolveInverseProblemWithTikhonovSVD::setStateDefaults()
 	setStateIntFromAlgo(Parameters::LambdaNum);
 	setStateDoubleFromAlgo(Parameters::LambdaResolution);
 	setStateDoubleFromAlgo(Parameters::LambdaSliderValue);
+	setStateStringFromAlgoOption(SVDParameters::SVDMethod);
+	setStateIntFromAlgo(SVDParameters::SVDRank);
+	setStateIntFromAlgo(SVDParameters::SVDOversampling);
+	setStateIntFromAlgo(SVDParameters::SVDPowerIterations);
+	setStateIntFromAlgo(Parameters::StreamingChunkSize);
+	setStateStringFromAlgo(Parameters::StreamingOutputFile);
 }
 
 // execute function
@@ -112,6 +120,12 @@ void SolveInverseProblemWithTikhonovSVD::execute()
 		setAlgoIntFromState(Parameters::LambdaNum);
 		setAlgoDoubleFromState(Parameters::LambdaResolution);
 		setAlgoDoubleFromState(Parameters::LambdaSliderValue);
+		setAlgoOptionFromState(SVDParameters::SVDMethod);
+		setAlgoIntFromState(SVDParameters::SVDRank);
+		setAlgoIntFromState(SVDParameters::SVDOversampling);
+		setAlgoIntFromState(SVDParameters::SVDPowerIterations);
+		setAlgoIntFromState(Parameters::StreamingChunkSize);
+		setAlgoStringFromState(Parameters::StreamingOutputFile);
 
 		// run
 		auto output = algo().run(
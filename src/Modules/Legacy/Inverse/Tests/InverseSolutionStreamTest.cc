@@ -0,0 +1,164 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Algorithms/Legacy/Inverse/TikhonovAlgoAbstractBase.h>
+#include <Core/Algorithms/Legacy/Inverse/InverseSolutionStream.h>
+#include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithStandardTikhonovImpl.h>
+#include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithTikhonovSVD_impl.h>
+#include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithTSVD_impl.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Inverse;
+
+namespace
+{
+  DenseMatrix readRawSolution(const std::string& filename, index_type rows, index_type cols)
+  {
+    Eigen::MatrixXd samples(rows, cols);
+    std::ifstream file(filename, std::ios::binary);
+    file.read(reinterpret_cast<char*>(samples.data()), samples.size() * sizeof(double));
+    EXPECT_TRUE(file.good());
+    EXPECT_EQ(EOF, file.peek());
+    return DenseMatrix(samples);
+  }
+
+  std::string tempFile(const std::string& name)
+  {
+    return (boost::filesystem::temp_directory_path() / name).string();
+  }
+}
+
+TEST(InverseSolutionStreamTest, InverseOperatorReproducesSolutions)
+{
+  const int M = 25, N = 40, T = 9;
+  const double lambda = 0.05;
+  DenseMatrix A = DenseMatrix::Random(M, N);
+  DenseMatrix y = DenseMatrix::Random(M, T);
+  DenseMatrix I = DenseMatrix::Identity(N, N), J = DenseMatrix::Identity(M, M);
+
+  SolveInverseProblemWithStandardTikhonovImpl underdetermined(A, y, I, J, TikhonovAlgoAbstractBase::underdetermined,
+    TikhonovAlgoAbstractBase::solution_constrained, TikhonovAlgoAbstractBase::residual_constrained);
+  SolveInverseProblemWithStandardTikhonovImpl overdetermined(A, y, I, J, TikhonovAlgoAbstractBase::overdetermined,
+    TikhonovAlgoAbstractBase::solution_constrained, TikhonovAlgoAbstractBase::residual_constrained);
+  SolveInverseProblemWithTikhonovSVD_impl tikhonovSVD(A, y, DenseMatrix(), DenseMatrix());
+  SolveInverseProblemWithTSVD_impl tsvd(A, y, DenseMatrix(), DenseMatrix());
+
+  for (const TikhonovImpl* impl : { static_cast<const TikhonovImpl*>(&underdetermined), static_cast<const TikhonovImpl*>(&overdetermined),
+    static_cast<const TikhonovImpl*>(&tikhonovSVD) })
+  {
+    auto G = impl->computeInverseOperator(lambda);
+    ASSERT_EQ(N, G.nrows());
+    ASSERT_EQ(M, G.ncols());
+    auto x = impl->computeInverseSolution(lambda, false);
+    EXPECT_LT((G * y - x).norm(), 1e-9 * x.norm());
+  }
+
+  const TikhonovImpl& truncated = tsvd;
+  auto G = truncated.computeInverseOperator(12);
+  auto x = truncated.computeInverseSolution(12, false);
+  EXPECT_LT((G * y - x).norm(), 1e-9 * x.norm());
+}
+
+TEST(InverseSolutionStreamTest, StreamedBlocksMatchFullProduct)
+{
+  const int M = 12, N = 30, T = 50;
+  DenseMatrixHandle G(new DenseMatrix(DenseMatrix::Random(N, M)));
+  DenseMatrix y = DenseMatrix::Random(M, T);
+  DenseMatrix expected = *G * y;
+
+  // chunk sizes that divide T, leave a partial last block, and exceed T
+  for (int chunk : { 10, 7, 1, 64 })
+  {
+    DenseMatrix solution(N, T);
+    DenseMatrixSolutionSink sink(solution);
+    InverseSolutionStream(G, chunk).apply(y, sink);
+    EXPECT_LT((solution - expected).norm(), 1e-12 * expected.norm()) << "chunk " << chunk;
+  }
+
+  auto filename = tempFile("InverseSolutionStreamTest.bin");
+  {
+    RawFileSolutionSink sink(filename);
+    InverseSolutionStream(G, 7).apply(y, sink);
+  }
+  auto fromFile = readRawSolution(filename, N, T);
+  boost::filesystem::remove(filename);
+  EXPECT_LT((fromFile - expected).norm(), 1e-12 * expected.norm());
+}
+
+TEST(InverseSolutionStreamTest, RejectsMismatchedData)
+{
+  DenseMatrixHandle G(new DenseMatrix(DenseMatrix::Random(30, 12)));
+  DenseMatrix y = DenseMatrix::Random(13, 4), solution(30, 4);
+  DenseMatrixSolutionSink sink(solution);
+  EXPECT_THROW(InverseSolutionStream(G, 2).apply(y, sink), AlgorithmProcessingException);
+  EXPECT_THROW(InverseSolutionStream(G, 0), AlgorithmProcessingException);
+}
+
+TEST(InverseSolutionStreamTest, AlgorithmStreamsToMatrixAndFile)
+{
+  const int M = 20, N = 45, T = 33;
+  MatrixHandle A(new DenseMatrix(DenseMatrix::Random(M, N)));
+  MatrixHandle y(new DenseMatrix(DenseMatrix::Random(M, T)));
+  MatrixHandle R(new DenseMatrix(DenseMatrix::Identity(N, N)));
+  MatrixHandle C(new DenseMatrix(DenseMatrix::Identity(M, M)));
+
+  TikhonovAlgoAbstractBase algo;
+  algo.set(Parameters::TikhonovImplementation, std::string("TikhonovSVD"));
+  algo.setOption(Parameters::RegularizationMethod, "single");
+  algo.set(Parameters::LambdaFromDirectEntry, 0.1);
+  AlgorithmInput input;
+  input[TikhonovAlgoAbstractBase::ForwardMatrix] = A;
+  input[TikhonovAlgoAbstractBase::MeasuredPotentials] = y;
+  input[TikhonovAlgoAbstractBase::WeightingInSourceSpace] = R;
+  input[TikhonovAlgoAbstractBase::WeightingInSensorSpace] = C;
+
+  auto expected = algo.run(input).get<DenseMatrix>(TikhonovAlgoAbstractBase::InverseSolution);
+
+  algo.set(Parameters::StreamingChunkSize, 8);
+  auto streamed = algo.run(input);
+  auto solution = streamed.get<DenseMatrix>(TikhonovAlgoAbstractBase::InverseSolution);
+  ASSERT_TRUE(solution != nullptr);
+  EXPECT_LT((*solution - *expected).norm(), 1e-9 * expected->norm());
+  ASSERT_TRUE(streamed.get<DenseMatrix>(TikhonovAlgoAbstractBase::RegInverse) != nullptr);
+
+  auto filename = tempFile("InverseSolutionStreamAlgorithm.bin");
+  algo.set(Parameters::StreamingOutputFile, filename);
+  auto toFile = algo.run(input);
+  EXPECT_FALSE(toFile.get<DenseMatrix>(TikhonovAlgoAbstractBase::InverseSolution));
+  auto fromFile = readRawSolution(filename, N, T);
+  boost::filesystem::remove(filename);
+  EXPECT_LT((fromFile - *expected).norm(), 1e-9 * expected->norm());
+}
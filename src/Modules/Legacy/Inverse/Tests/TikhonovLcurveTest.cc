@@ -0,0 +1,200 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Algorithms/Legacy/Inverse/TikhonovAlgoAbstractBase.h>
+#include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithStandardTikhonovImpl.h>
+#include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithTikhonovSVD_impl.h>
+#include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithTSVD_impl.h>
+#include <Core/Algorithms/Math/RandomizedSVD.h>
+#include <Core/Thread/Parallel.h>
+#include <Eigen/SVD>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Inverse;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  // Residuals close to zero cancel in either formula, so the tolerance has a floor scaled by the data.
+  double tolerance(double expected, const DenseMatrix& y)
+  {
+    return 1e-9 * expected + 1e-12 * y.norm();
+  }
+
+  // The default sweep solves for every lambda, so it is the reference for the SVD shortcuts.
+  void expectSameLcurve(const TikhonovImpl& impl, const std::vector<double>& lambdas, const DenseMatrix& A, const DenseMatrix& y,
+    DenseMatrixHandle R, DenseMatrixHandle C)
+  {
+    std::vector<double> rho, eta, rhoExpected, etaExpected;
+    impl.computeLcurveNorms(lambdas, A, y, R, C, rho, eta);
+    impl.TikhonovImpl::computeLcurveNorms(lambdas, A, y, R, C, rhoExpected, etaExpected);
+    ASSERT_EQ(lambdas.size(), rho.size());
+    for (size_t j = 0; j < lambdas.size(); ++j)
+    {
+      EXPECT_NEAR(rhoExpected[j], rho[j], tolerance(rhoExpected[j], y)) << "lambda " << lambdas[j];
+      EXPECT_NEAR(etaExpected[j], eta[j], tolerance(etaExpected[j], y)) << "lambda " << lambdas[j];
+    }
+  }
+}
+
+TEST(TikhonovLcurveTest, SVDNormsMatchExplicitSolutions)
+{
+  const int M = 30, N = 80, T = 25;
+  DenseMatrix A = DenseMatrix::Random(M, N);
+  DenseMatrix y = DenseMatrix::Random(M, T);
+  DenseMatrixHandle R(new DenseMatrix(DenseMatrix::Random(N + 5, N)));
+  DenseMatrixHandle C(new DenseMatrix(DenseMatrix::Random(M, M)));
+
+  SolveInverseProblemWithTikhonovSVD_impl tikhonovSVDImpl(A, y, DenseMatrix(), DenseMatrix());
+  SolveInverseProblemWithTSVD_impl tsvdImpl(A, y, DenseMatrix(), DenseMatrix());
+  const TikhonovImpl& tikhonovSVD = tikhonovSVDImpl;
+  const TikhonovImpl& tsvd = tsvdImpl;
+  auto lambdas = tikhonovSVD.computeLambdaArray(1e-4, 10, 40);
+  auto truncations = tsvd.computeLambdaArray(1, 0, M);
+
+  for (auto R_ : { DenseMatrixHandle(), R })
+    for (auto C_ : { DenseMatrixHandle(), C })
+    {
+      expectSameLcurve(tikhonovSVD, lambdas, A, y, R_, C_);
+      expectSameLcurve(tsvd, truncations, A, y, R_, C_);
+    }
+}
+
+TEST(TikhonovLcurveTest, TruncatedSVDInputKeepsExactResidual)
+{
+  // A rank-10 factorization of a full-rank A: the residual has to use A, not U S V^T.
+  const int M = 40, N = 60, T = 7;
+  DenseMatrix A = DenseMatrix::Random(M, N);
+  DenseMatrix y = DenseMatrix::Random(M, T);
+  Eigen::JacobiSVD<DenseMatrix::EigenBase> svd(A, Eigen::ComputeThinU | Eigen::ComputeThinV);
+  DenseMatrix U = svd.matrixU().leftCols(10), V = svd.matrixV().leftCols(10);
+  DenseMatrix S = svd.singularValues().head(10);
+
+  SolveInverseProblemWithTikhonovSVD_impl tikhonovSVD(A, y, DenseMatrix(), DenseMatrix(), U, S, V);
+  expectSameLcurve(tikhonovSVD, tikhonovSVD.computeLambdaArray(1e-3, 1, 20), A, y, nullptr, nullptr);
+}
+
+TEST(TikhonovLcurveTest, StandardTikhonovSweepMatchesSingleSolves)
+{
+  const int M = 20, N = 35, T = 6;
+  DenseMatrix A = DenseMatrix::Random(M, N);
+  DenseMatrix y = DenseMatrix::Random(M, T);
+  DenseMatrix I = DenseMatrix::Identity(N, N), J = DenseMatrix::Identity(M, M);
+  SolveInverseProblemWithStandardTikhonovImpl standardImpl(A, y, I, J, TikhonovAlgoAbstractBase::automatic,
+    TikhonovAlgoAbstractBase::solution_constrained, TikhonovAlgoAbstractBase::residual_constrained);
+  const TikhonovImpl& standard = standardImpl;
+
+  auto lambdas = standard.computeLambdaArray(1e-3, 1, 9);
+  std::vector<double> rho, eta;
+  standard.computeLcurveNorms(lambdas, A, y, nullptr, nullptr, rho, eta);
+  for (size_t j = 0; j < lambdas.size(); ++j)
+  {
+    auto x = standard.computeInverseSolution(lambdas[j], false);
+    EXPECT_NEAR((A * x - y).norm(), rho[j], tolerance(rho[j], y));
+    EXPECT_NEAR(x.norm(), eta[j], tolerance(eta[j], y));
+  }
+}
+
+TEST(TikhonovLcurveTest, WideForwardMatrixThroughFullAndRandomizedSVD)
+{
+  // More sources than sensors, so the thin V has N rows but only M columns.
+  const int M = 20, N = 45, T = 6;
+  DenseMatrix A = DenseMatrix::Random(M, N);
+  DenseMatrix y = DenseMatrix::Random(M, T);
+  AlgorithmInput input;
+  input[TikhonovAlgoAbstractBase::ForwardMatrix] = MatrixHandle(new DenseMatrix(A));
+  input[TikhonovAlgoAbstractBase::MeasuredPotentials] = MatrixHandle(new DenseMatrix(y));
+  input[TikhonovAlgoAbstractBase::WeightingInSourceSpace] = MatrixHandle(new DenseMatrix(DenseMatrix::Identity(N, N)));
+  input[TikhonovAlgoAbstractBase::WeightingInSensorSpace] = MatrixHandle(new DenseMatrix(DenseMatrix::Identity(M, M)));
+
+  TikhonovAlgoAbstractBase algo;
+  algo.setOption(Parameters::RegularizationMethod, "lcurve");
+  algo.set(Parameters::LambdaMax, 1.0);
+  algo.set(Math::Parameters::SVDRank, M);
+
+  // TSVD sweeps the truncation points 1..M, TikhonovSVD a log range of lambdas.
+  for (auto impl : { "TikhonovSVD", "TSVD" })
+  {
+    const bool truncated = std::string(impl) == "TSVD";
+    algo.set(Parameters::TikhonovImplementation, std::string(impl));
+    algo.set(Parameters::LambdaMin, truncated ? 1.0 : 1e-4);
+    algo.set(Parameters::LambdaNum, truncated ? M : 30);
+    algo.setOption(Math::Parameters::SVDMethod, "full");
+    auto full = algo.run(input);
+    algo.setOption(Math::Parameters::SVDMethod, "randomized");
+    auto randomized = algo.run(input);
+
+    auto x = full.get<DenseMatrix>(TikhonovAlgoAbstractBase::InverseSolution);
+    auto xRandomized = randomized.get<DenseMatrix>(TikhonovAlgoAbstractBase::InverseSolution);
+    ASSERT_EQ(N, x->nrows()) << impl;
+    ASSERT_EQ(T, x->ncols()) << impl;
+    ASSERT_EQ(N, xRandomized->nrows()) << impl;
+    EXPECT_GT(x->norm(), 0) << impl;
+    EXPECT_EQ((*full.get<DenseMatrix>(TikhonovAlgoAbstractBase::RegularizationParameter))(0, 0),
+      (*randomized.get<DenseMatrix>(TikhonovAlgoAbstractBase::RegularizationParameter))(0, 0)) << impl;
+    EXPECT_LT((*xRandomized - *x).norm(), 1e-8 * x->norm()) << impl;
+  }
+
+  // The Tikhonov solution for the selected lambda in closed form, A^T (A A^T + lambda^2 I)^-1 y.
+  algo.set(Parameters::TikhonovImplementation, std::string("TikhonovSVD"));
+  algo.set(Parameters::LambdaMin, 1e-4);
+  algo.set(Parameters::LambdaNum, 30);
+  auto output = algo.run(input);
+  const double lambda = (*output.get<DenseMatrix>(TikhonovAlgoAbstractBase::RegularizationParameter))(0, 0);
+  DenseMatrix gram = A * A.transpose() + lambda * lambda * DenseMatrix::Identity(M, M);
+  DenseMatrix expected = A.transpose() * gram.ldlt().solve(y);
+  auto x = output.get<DenseMatrix>(TikhonovAlgoAbstractBase::InverseSolution);
+  EXPECT_LT((*x - expected).norm(), 1e-8 * expected.norm());
+}
+
+TEST(TikhonovLcurveTest, SweepDoesNotDependOnTaskCount)
+{
+  const int M = 15, N = 25, T = 4;
+  DenseMatrix A = DenseMatrix::Random(M, N);
+  DenseMatrix y = DenseMatrix::Random(M, T);
+  SolveInverseProblemWithTikhonovSVD_impl tikhonovSVDImpl(A, y, DenseMatrix(), DenseMatrix());
+  const TikhonovImpl& tikhonovSVD = tikhonovSVDImpl;
+  auto lambdas = tikhonovSVD.computeLambdaArray(1e-4, 1, 17);
+
+  std::vector<double> rho, eta, rhoSerial, etaSerial, rhoFiltered, etaFiltered, rhoFilteredSerial, etaFilteredSerial;
+  Parallel::SetMaximumCores(1);
+  tikhonovSVD.TikhonovImpl::computeLcurveNorms(lambdas, A, y, nullptr, nullptr, rhoSerial, etaSerial);
+  tikhonovSVD.computeLcurveNorms(lambdas, A, y, nullptr, nullptr, rhoFilteredSerial, etaFilteredSerial);
+  Parallel::SetMaximumCores(0);
+  tikhonovSVD.TikhonovImpl::computeLcurveNorms(lambdas, A, y, nullptr, nullptr, rho, eta);
+  tikhonovSVD.computeLcurveNorms(lambdas, A, y, nullptr, nullptr, rhoFiltered, etaFiltered);
+
+  // Every lambda is computed the same way by whichever task gets it.
+  EXPECT_EQ(rhoSerial, rho);
+  EXPECT_EQ(etaSerial, eta);
+  EXPECT_EQ(rhoFilteredSerial, rhoFiltered);
+  EXPECT_EQ(etaFilteredSerial, etaFiltered);
+}
@@ -28,6 +28,7 @@
 
 #include <Modules/Legacy/Math/ComputeSVD.h>
 #include <Core/Algorithms/Math/ComputeSVD.h>
+#include <Core/Algorithms/Math/RandomizedSVD.h>
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 
@@ -47,12 +48,25 @@ ComputeSVD::ComputeSVD() : Module(ModuleLookupInfo("ComputeSVD", "Math", "SCIRun
 	INITIALIZE_PORT(RightSingularMatrix);
 }
 
+void ComputeSVD::setStateDefaults()
+{
+	setStateStringFromAlgoOption(Parameters::SVDMethod);
+	setStateIntFromAlgo(Parameters::SVDRank);
+	setStateIntFromAlgo(Parameters::SVDOversampling);
+	setStateIntFromAlgo(Parameters::SVDPowerIterations);
+}
+
 void ComputeSVD::execute()
 {
 	auto input_matrix = getRequiredInput(InputMatrix);
 
 	if(needToExecute())
 	{
+		setAlgoOptionFromState(Parameters::SVDMethod);
+		setAlgoIntFromState(Parameters::SVDRank);
+		setAlgoIntFromState(Parameters::SVDOversampling);
+		setAlgoIntFromState(Parameters::SVDPowerIterations);
+
 		auto output = algo().run(withInputData((InputMatrix,input_matrix)));
 
 		sendOutputFromAlgorithm(LeftSingularMatrix, output);
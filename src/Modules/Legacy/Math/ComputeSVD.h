@@ -42,7 +42,7 @@ namespace SCIRun {
 			{
 				public:
 					ComputeSVD();
-					void setStateDefaults() override {}
+					void setStateDefaults() override;
 					void execute() override;
 
 					INPUT_PORT(0, InputMatrix, Matrix);
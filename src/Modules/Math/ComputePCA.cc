@@ -28,6 +28,7 @@
 
 #include <Modules/Math/ComputePCA.h>
 #include <Core/Algorithms/Math/ComputePCA.h>
+#include <Core/Algorithms/Math/RandomizedSVD.h>
 #include <Core/Datatypes/DenseMatrix.h>
 
 using namespace SCIRun::Modules::Math;
@@ -46,12 +47,25 @@ ComputePCA::ComputePCA() : Module(ModuleLookupInfo("ComputePCA", "Math", "SCIRun
     INITIALIZE_PORT(RightPrincipalMatrix);
 }
 
+void ComputePCA::setStateDefaults()
+{
+    setStateStringFromAlgoOption(Parameters::SVDMethod);
+    setStateIntFromAlgo(Parameters::SVDRank);
+    setStateIntFromAlgo(Parameters::SVDOversampling);
+    setStateIntFromAlgo(Parameters::SVDPowerIterations);
+}
+
 void ComputePCA::execute()
 {
     auto input_matrix = getRequiredInput(InputMatrix);
 
     if(needToExecute())
     {
+        setAlgoOptionFromState(Parameters::SVDMethod);
+        setAlgoIntFromState(Parameters::SVDRank);
+        setAlgoIntFromState(Parameters::SVDOversampling);
+        setAlgoIntFromState(Parameters::SVDPowerIterations);
+
         auto output = algo().run(withInputData((InputMatrix,input_matrix)));
 
         sendOutputFromAlgorithm(LeftPrincipalMatrix, output);
@@ -30,12 +30,14 @@
 
 #include <Modules/Math/EvaluateLinearAlgebraBinary.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Math/EvaluateLinearAlgebraUnaryAlgo.h>
 #include <Core/Datatypes/DenseMatrix.h>
 
 using namespace SCIRun::Modules::Math;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Math;
 
 EvaluateLinearAlgebraBinary::EvaluateLinearAlgebraBinary() :
 Module(ModuleLookupInfo("EvaluateLinearAlgebraBinary", "Math", "SCIRun"))
@@ -50,6 +52,7 @@ void EvaluateLinearAlgebraBinary::setStateDefaults()
   auto state = get_state();
   state->setValue(Variables::Operator, 0);
 	state->setValue(Variables::FunctionString, std::string("x+y"));
+  state->setValue(Parameters::LazyEvaluation, false);
 }
 
 void EvaluateLinearAlgebraBinary::execute()
@@ -65,6 +68,7 @@ void EvaluateLinearAlgebraBinary::execute()
 
     algo().set(Variables::Operator, oper);
 	  algo().set(Variables::FunctionString, func);
+    algo().set(Parameters::LazyEvaluation, state->getValue(Parameters::LazyEvaluation).toBool());
     auto output = algo().run(withInputData((LHS, lhs)(RHS, rhs)));
 
     sendOutputFromAlgorithm(Result, output);
@@ -32,11 +32,13 @@
 #include <stdexcept>
 #include <Modules/Math/EvaluateLinearAlgebraUnary.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Math/EvaluateLinearAlgebraUnaryAlgo.h>
 #include <Core/Datatypes/Datatype.h>
 #include <Core/Datatypes/DenseMatrix.h> /// @todo: try to remove this--now it's needed to convert pointers, but actually this module shouldn't need the full def of DenseMatrix.
 
 using namespace SCIRun::Modules::Math;
 using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Math;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Dataflow::Networks;
 
@@ -53,6 +55,7 @@ void EvaluateLinearAlgebraUnary::setStateDefaults()
   state->setValue(Variables::Operator, 0);
   state->setValue(Variables::ScalarValue, 0);
 	state->setValue(Variables::FunctionString, std::string("x+10"));
+  state->setValue(Parameters::LazyEvaluation, false);
 }
 
 void EvaluateLinearAlgebraUnary::execute()
@@ -70,6 +73,7 @@ void EvaluateLinearAlgebraUnary::execute()
     algo().set(Variables::Operator, oper);
     algo().set(Variables::ScalarValue, scalar);
 	  algo().set(Variables::FunctionString, func);
+    algo().set(Parameters::LazyEvaluation, state->getValue(Parameters::LazyEvaluation).toBool());
     auto output = algo().run(withInputData((InputMatrix, input)));
     sendOutputFromAlgorithm(Result, output);
   }
@@ -69,8 +69,8 @@ void SolveLinearSystem::execute()
     /// @todo: why aren't these checks in the algo class?
     if (rhs->ncols() != 1)
       THROW_ALGORITHM_INPUT_ERROR("Right-hand side matrix must contain only one column.");
-    if (!matrixIs::sparse(A))
-      THROW_ALGORITHM_INPUT_ERROR("Left-hand side matrix to solve must be sparse.");
+    if (!matrixIs::sparse(A) && !matrixIs::linearOperator(A))
+      THROW_ALGORITHM_INPUT_ERROR("Left-hand side matrix to solve must be sparse or a linear operator.");
 
     auto rhsCol = castMatrix::toColumn(rhs);
     if (!rhsCol)
@@ -29,6 +29,7 @@
 #include <Modules/Visualization/ShowField.h>
 #include <Core/Datatypes/Geometry.h>
 #include <Core/Algorithms/Visualization/RenderFieldState.h>
+#include <Core/Algorithms/Visualization/VolumeBoundaryFaces.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
@@ -37,6 +38,7 @@
 #include <Core/Datatypes/Feedback.h>
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Tensor.h>
+#include <Core/Thread/Parallel.h>
 #include <Graphics/Glyphs/GlyphGeom.h>
 
 using namespace SCIRun;
@@ -93,6 +95,24 @@ public:
     RenderState state, GeometryHandle geom,
     const std::string& id);
 
+  void renderFacesVolumeBoundary(
+    FieldHandle field,
+    boost::optional<ColorMapHandle> colorMap,
+    RenderState state, GeometryHandle geom,
+    const std::string& id);
+
+  void addFacePass(
+    GeometryHandle geom,
+    const std::string& uniqueNodeID,
+    std::shared_ptr<spire::VarBuffer> vboBuffer,
+    std::shared_ptr<spire::VarBuffer> iboBuffer,
+    bool useNormals,
+    bool useColorMap,
+    ColorScheme colorScheme,
+    ColorMapHandle textureMap,
+    const RenderState& state,
+    const BBox& bbox);
+
   void addFaceGeom(
     const std::vector<Point>  &points,
     const std::vector<Vector> &normals,
@@ -182,6 +202,8 @@ void ShowField::setStateDefaults()
 
   state->setValue(UseFaceNormals, false);
   state->setValue(FaceInvertNormals, false);
+  state->setValue(BoundaryFacesOnly, false);
+  state->setValue(BoundaryFacesByDomain, false);
 
   state->setValue(FieldName, std::string());
 
@@ -407,6 +429,11 @@ void GeometryBuilder::renderFaces(
   // if(mesh->is_regularmesh() && mesh->is_surface() &&
   //    get_flag(render_state, USE_TEXTURE))
 
+  // Interior faces of a volume mesh are hidden, only the boundary is drawn.
+  if (doLinear && mesh->dimensionality() == 3 && state_->getValue(BoundaryFacesOnly).toBool())
+  {
+    return renderFacesVolumeBoundary(field, colorMap, state, geom, id);
+  }
   if (doLinear)
   {
     return renderFacesLinear(field, colorMap, state, geom, id);
@@ -422,39 +449,39 @@ void GeometryBuilder::renderFaces(
 namespace
 {
   template <typename T>
-  inline void writeFloats(spire::VarBuffer* vboBuffer, std::initializer_list<T> ts)
+  inline void writeFloats(float*& vbo, std::initializer_list<T> ts)
   {
     for (const T& t : ts)
-      vboBuffer->writeUnsafe(static_cast<float>(t));
+      *vbo++ = static_cast<float>(t);
   }
 
-  inline void writeAtributeToVBO(const Point& point, spire::VarBuffer* vboBuffer)
+  inline void writeAtributeToVBO(const Point& point, float*& vbo)
   {
-    writeFloats(vboBuffer, {point.x(), point.y(), point.z()});
+    writeFloats(vbo, {point.x(), point.y(), point.z()});
   }
 
-  inline void writeAtributeToVBO(const Vector& vector, spire::VarBuffer* vboBuffer)
+  inline void writeAtributeToVBO(const Vector& vector, float*& vbo)
   {
-    writeFloats(vboBuffer, {vector.x(), vector.y(), vector.z()});
+    writeFloats(vbo, {vector.x(), vector.y(), vector.z()});
   }
 
-  inline void writeAtributeToVBO(const glm::vec2& coords, spire::VarBuffer* vboBuffer)
+  inline void writeAtributeToVBO(const glm::vec2& coords, float*& vbo)
   {
-    writeFloats(vboBuffer, {coords.x, coords.y});
+    writeFloats(vbo, {coords.x, coords.y});
   }
 
   template<typename ... Params>
-  void writeTri(spire::VarBuffer* vboBuffer, const Params& ... params)
+  void writeTri(float*& vbo, const Params& ... params)
   {
     for(int i = 0; i < 3; ++i)
-      (void)std::initializer_list<int>{(writeAtributeToVBO(params[i], vboBuffer), 0)...};
+      (void)std::initializer_list<int>{(writeAtributeToVBO(params[i], vbo), 0)...};
   }
 
   template<typename ...Params>
-  void writeQuad(spire::VarBuffer* vboBuffer, const Params& ... params)
+  void writeQuad(float*& vbo, const Params& ... params)
   {
     for(int i = 0; i < 4; ++i)
-      (void)std::initializer_list<int>{(writeAtributeToVBO(params[i], vboBuffer), 0)...};
+      (void)std::initializer_list<int>{(writeAtributeToVBO(params[i], vbo), 0)...};
   }
 
   enum : int
@@ -485,6 +512,30 @@ namespace
     coordinateMap = StandardColorMapFactory::create("Grayscale", 256, 0, false,
       realColorMap->getColorMapRescaleScale(), realColorMap->getColorMapRescaleShift());
   }
+
+  template <class Index>
+  double colorMapIndex(VField* fld, ColorMapHandle coordinateMap, Index index)
+  {
+    if (fld->is_scalar())
+    {
+      double v;
+      fld->get_value(v, index);
+      return coordinateMap->valueToIndex(v);
+    }
+    if (fld->is_vector())
+    {
+      Vector v;
+      fld->get_value(v, index);
+      return coordinateMap->valueToIndex(v);
+    }
+    if (fld->is_tensor())
+    {
+      Tensor v;
+      fld->get_value(v, index);
+      return coordinateMap->valueToIndex(v);
+    }
+    return 0.0;
+  }
 }
 
 
@@ -505,14 +556,9 @@ void GeometryBuilder::renderFacesLinear(
   mesh->size(numFaces);
   if (numFaces == 0) return;
 
-  Point idpt;
-  VMesh::Face::iterator fiter, fiterEnd;
-  VMesh::Node::array_type nodes;
-  mesh->get_nodes(nodes, *fiter);
-  mesh->get_point(idpt, nodes[0]);
-  mesh->begin(fiter);
-  mesh->end(fiterEnd);
-  int numNodesPerFace = nodes.size();
+  VMesh::Node::array_type firstFaceNodes;
+  mesh->get_nodes(firstFaceNodes, VMesh::Face::index_type(0));
+  int numNodesPerFace = firstFaceNodes.size();
   bool useQuads = (numNodesPerFace == 4);
   int numAttributes = 3; //intially 3 because we will atleast be rendering verticies (vec3's)
 
@@ -532,8 +578,6 @@ void GeometryBuilder::renderFacesLinear(
   bool isScalar = fld->is_scalar();
   bool isVector = fld->is_vector();
   bool isTensor = fld->is_tensor();
-  int colorMapCase = (isCellData * 0 + isFaceData * 1 + isNodeData * 2) * 3;
-  colorMapCase += isScalar * 0 + isVector * 1 + isTensor * 2;
 
   ColorScheme colorScheme = ColorScheme::COLOR_UNIFORM;
 
@@ -548,277 +592,472 @@ void GeometryBuilder::renderFacesLinear(
   }
 
   int writeCase = getWriteCase(useQuads, useNormals, useColorMap);
-
-  std::vector<Point> points(numNodesPerFace);
-  std::vector<Vector> normals(numNodesPerFace);
-  std::vector<glm::vec2> textureCoords(numNodesPerFace);
-  std::vector<double> svals(numNodesPerFace);
-  std::vector<Vector> vvals(numNodesPerFace);
-  std::vector<Tensor> tvals(numNodesPerFace);
+  const size_t floatsPerFace = static_cast<size_t>(numNodesPerFace) * numAttributes;
+  const size_t indicesPerFace = static_cast<size_t>(numNodesPerFace - 2) * 3;
 
   size_t passNumber = 0;
   size_t facesLeft = mesh->num_faces();
+  size_t firstFaceOfPass = 0;
 
   while(facesLeft > 0)
   {
     const static size_t maxFacesPerPass = 1 << 24;
-    int facesLeftInThisPass = std::min(facesLeft, maxFacesPerPass);
-    facesLeft -= facesLeftInThisPass;
-
-    // Three 32 bit ints for each triangle to index into the VBO (triangles = verticies - 2)
-    size_t iboSize = static_cast<size_t>(facesLeftInThisPass * sizeof(uint32_t) * (numNodesPerFace - 2) * 3);
-    size_t vboSize = static_cast<size_t>(facesLeftInThisPass * sizeof(float) * numNodesPerFace * numAttributes);
-    std::shared_ptr<spire::VarBuffer> iboBufferSPtr(new spire::VarBuffer(iboSize));
-    std::shared_ptr<spire::VarBuffer> vboBufferSPtr(new spire::VarBuffer(vboSize));
-    auto iboBuffer = iboBufferSPtr.get();
-    auto vboBuffer = vboBufferSPtr.get();
-
-    if(useQuads)
+    const size_t facesInThisPass = std::min(facesLeft, maxFacesPerPass);
+    facesLeft -= facesInThisPass;
+
+    // Every face owns a fixed-size slice of the VBO and IBO, so the faces of this pass are
+    // split into contiguous ranges and written in place by separate threads.
+    const size_t vboBytes = facesInThisPass * floatsPerFace * sizeof(float);
+    const size_t iboBytes = facesInThisPass * indicesPerFace * sizeof(uint32_t);
+    std::shared_ptr<spire::VarBuffer> iboBufferSPtr(new spire::VarBuffer(iboBytes));
+    std::shared_ptr<spire::VarBuffer> vboBufferSPtr(new spire::VarBuffer(vboBytes));
+    auto vertices = reinterpret_cast<float*>(vboBufferSPtr->reserveBytes(vboBytes));
+    auto indices = reinterpret_cast<uint32_t*>(iboBufferSPtr->reserveBytes(iboBytes));
+    const int numTasks = Parallel::NumTasks(facesInThisPass);
+
+    Parallel::RunRange(facesInThisPass, numTasks, [&](int, size_t begin, size_t end)
     {
-      uint32_t nodesInThisPass = facesLeftInThisPass * 4;
-      for(uint32_t i = 0; i < nodesInThisPass; i += 4)
+      VMesh::Node::array_type nodes;
+      std::vector<Point> points(numNodesPerFace);
+      std::vector<Vector> normals(numNodesPerFace);
+      std::vector<glm::vec2> textureCoords(numNodesPerFace);
+      std::vector<double> svals(numNodesPerFace);
+      std::vector<Vector> vvals(numNodesPerFace);
+      std::vector<Tensor> tvals(numNodesPerFace);
+
+      float* vbo = vertices + begin * floatsPerFace;
+      uint32_t* ibo = indices + begin * indicesPerFace;
+
+      for (size_t faceInPass = begin; faceInPass < end; ++faceInPass)
       {
-        iboBuffer->writeUnsafe(i+0);
-        iboBuffer->writeUnsafe(i+1);
-        iboBuffer->writeUnsafe(i+2);
-        iboBuffer->writeUnsafe(i+2);
-        iboBuffer->writeUnsafe(i+3);
-        iboBuffer->writeUnsafe(i+0);
-      }
-    }
-    else
-    {
-      uint32_t nodesInThisPass = facesLeftInThisPass * 3;
-      for(uint32_t i = 0; i <  nodesInThisPass; i += 3)
-      {
-        iboBuffer->writeUnsafe(i+0);
-        iboBuffer->writeUnsafe(i+1);
-        iboBuffer->writeUnsafe(i+2);
-      }
-    }
-
-    while (facesLeftInThisPass > 0)
-    {
-      mesh->get_nodes(nodes, *fiter);
-
-      for(size_t i = 0; i < numNodesPerFace; ++i)
-        mesh->get_point(points[i], nodes[i]);
+        const VMesh::Face::index_type face(static_cast<VMesh::index_type>(firstFaceOfPass + faceInPass));
+        mesh->get_nodes(nodes, face);
 
-      if (useNormals)
-      {
-        if (useFaceNormals)
+        const uint32_t first = static_cast<uint32_t>(faceInPass * numNodesPerFace);
+        if (useQuads)
         {
-          for(size_t i = 0; i < numNodesPerFace; ++i)
-            mesh->get_normal(normals[i], nodes[i]);
+          *ibo++ = first + 0; *ibo++ = first + 1; *ibo++ = first + 2;
+          *ibo++ = first + 2; *ibo++ = first + 3; *ibo++ = first + 0;
         }
         else
         {
-          Vector norm;
-          if (useQuads)
+          *ibo++ = first + 0; *ibo++ = first + 1; *ibo++ = first + 2;
+        }
+
+        for(size_t i = 0; i < numNodesPerFace; ++i)
+          mesh->get_point(points[i], nodes[i]);
+
+        if (useNormals)
+        {
+          if (useFaceNormals)
           {
-            Vector edge1 = points[1] - points[0];
-            Vector edge2 = points[2] - points[1];
-            Vector edge3 = points[3] - points[2];
-            Vector edge4 = points[0] - points[3];
-            norm = Cross(edge1, edge2) + Cross(edge2, edge3) + Cross(edge3, edge4) + Cross(edge4, edge1);
-            norm.normalize();
+            for(size_t i = 0; i < numNodesPerFace; ++i)
+              mesh->get_normal(normals[i], nodes[i]);
           }
           else
           {
-            Vector edge1 = points[1] - points[0];
-            Vector edge2 = points[2] - points[1];
-            norm = Cross(edge1, edge2);
-            norm.normalize();
+            Vector norm;
+            if (useQuads)
+            {
+              Vector edge1 = points[1] - points[0];
+              Vector edge2 = points[2] - points[1];
+              Vector edge3 = points[3] - points[2];
+              Vector edge4 = points[0] - points[3];
+              norm = Cross(edge1, edge2) + Cross(edge2, edge3) + Cross(edge3, edge4) + Cross(edge4, edge1);
+              norm.normalize();
+            }
+            else
+            {
+              Vector edge1 = points[1] - points[0];
+              Vector edge2 = points[2] - points[1];
+              norm = Cross(edge1, edge2);
+              norm.normalize();
+            }
+
+            for(size_t i = 0; i < numNodesPerFace; ++i)
+              normals[i] = norm;
           }
 
-          for(size_t i = 0; i < numNodesPerFace; ++i)
-            normals[i] = norm;
+          if(invertNormals)
+            for(size_t i = 0; i < numNodesPerFace; ++i)
+              normals[i] = -normals[i];
         }
 
-        if(invertNormals)
-          for(size_t i = 0; i < numNodesPerFace; ++i)
-            normals[i] = -normals[i];
-      }
-
-      if(useColorMap)
-      {
-        // Element data (Cells) so two sided faces.
-        if (isCellData)
+        if(useColorMap)
         {
-          VMesh::Elem::array_type cells;
-          mesh->get_elems(cells, *fiter);
-
-          if (isScalar)
+          // Element data (Cells) so two sided faces.
+          if (isCellData)
           {
-            fld->get_value(svals[0], cells[0]);
-            if (cells.size() > 1) fld->get_value(svals[1], cells[1]);
-            else svals[1] = svals[0];
+            VMesh::Elem::array_type cells;
+            mesh->get_elems(cells, face);
 
-            for (size_t i = 0; i < numNodesPerFace; ++i)
+            if (isScalar)
             {
-              textureCoords[i].x = coordinateMap->valueToIndex(svals[0]);
-              textureCoords[i].y = coordinateMap->valueToIndex(svals[1]);
+              fld->get_value(svals[0], cells[0]);
+              if (cells.size() > 1) fld->get_value(svals[1], cells[1]);
+              else svals[1] = svals[0];
+
+              for (size_t i = 0; i < numNodesPerFace; ++i)
+              {
+                textureCoords[i].x = coordinateMap->valueToIndex(svals[0]);
+                textureCoords[i].y = coordinateMap->valueToIndex(svals[1]);
+              }
             }
-          }
-          else if (isVector)
-          {
-            fld->get_value(vvals[0], cells[0]);
-            if (cells.size() > 1) fld->get_value(vvals[1], cells[1]);
-            else svals[1] = svals[0];
-
-            for (size_t i = 0; i < numNodesPerFace; ++i)
+            else if (isVector)
             {
-              textureCoords[i].x = coordinateMap->valueToIndex(vvals[0]);
-              textureCoords[i].y = coordinateMap->valueToIndex(vvals[1]);
+              fld->get_value(vvals[0], cells[0]);
+              if (cells.size() > 1) fld->get_value(vvals[1], cells[1]);
+              else vvals[1] = vvals[0];
+
+              for (size_t i = 0; i < numNodesPerFace; ++i)
+              {
+                textureCoords[i].x = coordinateMap->valueToIndex(vvals[0]);
+                textureCoords[i].y = coordinateMap->valueToIndex(vvals[1]);
+              }
             }
-          }
-          else if (isTensor)
-          {
-            fld->get_value(tvals[0], cells[0]);
-            if (cells.size() > 1) fld->get_value(tvals[1], cells[1]);
-            else svals[1] = svals[0];
-
-            for (size_t i = 0; i < numNodesPerFace; ++i)
+            else if (isTensor)
             {
-              textureCoords[i].x = coordinateMap->valueToIndex(tvals[0]);
-              textureCoords[i].y = coordinateMap->valueToIndex(tvals[1]);
+              fld->get_value(tvals[0], cells[0]);
+              if (cells.size() > 1) fld->get_value(tvals[1], cells[1]);
+              else tvals[1] = tvals[0];
+
+              for (size_t i = 0; i < numNodesPerFace; ++i)
+              {
+                textureCoords[i].x = coordinateMap->valueToIndex(tvals[0]);
+                textureCoords[i].y = coordinateMap->valueToIndex(tvals[1]);
+              }
             }
           }
-        }
-        // Element data (faces)
-        else if (isFaceData)
-        {
-          if (isScalar)
-          {
-            fld->get_value(svals[0], *fiter);
-            textureCoords[0].x = coordinateMap->valueToIndex(svals[0]);
-          }
-          else if (isVector)
-          {
-            fld->get_value(vvals[0], *fiter);
-            textureCoords[0].x = coordinateMap->valueToIndex(vvals[0]);
-          }
-          else if (isTensor)
+          // Element data (faces)
+          else if (isFaceData)
           {
-            fld->get_value(tvals[0], *fiter);
-            textureCoords[0].x = coordinateMap->valueToIndex(tvals[0]);
-          }
-
-          for (size_t i = 0; i < numNodesPerFace; ++i)
-            textureCoords[i].y = textureCoords[i].x = textureCoords[0].x;
-        }
-        // Data at nodes
-        else if (isNodeData)
-        {
-          if (isScalar)
-          {
-            for (size_t i = 0; i < numNodesPerFace; ++i)
+            if (isScalar)
             {
-              fld->get_value(svals[i], nodes[i]);
-              textureCoords[i].x = textureCoords[i].y = coordinateMap->valueToIndex(svals[i]);
+              fld->get_value(svals[0], face);
+              textureCoords[0].x = coordinateMap->valueToIndex(svals[0]);
             }
-          }
-          else if (isVector)
-          {
-            for (size_t i = 0; i < numNodesPerFace; ++i)
+            else if (isVector)
             {
-              fld->get_value(vvals[i], nodes[i]);
-              textureCoords[i].x = textureCoords[i].y = coordinateMap->valueToIndex(vvals[i]);
+              fld->get_value(vvals[0], face);
+              textureCoords[0].x = coordinateMap->valueToIndex(vvals[0]);
             }
+            else if (isTensor)
+            {
+              fld->get_value(tvals[0], face);
+              textureCoords[0].x = coordinateMap->valueToIndex(tvals[0]);
+            }
+
+            for (size_t i = 0; i < numNodesPerFace; ++i)
+              textureCoords[i].y = textureCoords[i].x = textureCoords[0].x;
           }
-          else if (isTensor)
+          // Data at nodes
+          else if (isNodeData)
           {
-            for (size_t i = 0; i < numNodesPerFace; ++i)
+            if (isScalar)
+            {
+              for (size_t i = 0; i < numNodesPerFace; ++i)
+              {
+                fld->get_value(svals[i], nodes[i]);
+                textureCoords[i].x = textureCoords[i].y = coordinateMap->valueToIndex(svals[i]);
+              }
+            }
+            else if (isVector)
+            {
+              for (size_t i = 0; i < numNodesPerFace; ++i)
+              {
+                fld->get_value(vvals[i], nodes[i]);
+                textureCoords[i].x = textureCoords[i].y = coordinateMap->valueToIndex(vvals[i]);
+              }
+            }
+            else if (isTensor)
             {
-              fld->get_value(tvals[i], nodes[i]);
-              textureCoords[i].x = textureCoords[i].y = coordinateMap->valueToIndex(tvals[i]);
+              for (size_t i = 0; i < numNodesPerFace; ++i)
+              {
+                fld->get_value(tvals[i], nodes[i]);
+                textureCoords[i].x = textureCoords[i].y = coordinateMap->valueToIndex(tvals[i]);
+              }
             }
           }
         }
-      }
 
-      switch(writeCase)
-      {
-        case TRI: writeTri(vboBuffer, points); break;
-        case TRI_TEXCOORDS: writeTri(vboBuffer, points, textureCoords); break;
-        case TRI_NORMALS: writeTri(vboBuffer, points, normals); break;
-        case TRI_NORMALS_TEXCOORDS: writeTri(vboBuffer, points, normals, textureCoords); break;
-        case QUAD: writeQuad(vboBuffer, points); break;
-        case QUAD_TEXCOORDS: writeQuad(vboBuffer, points, textureCoords); break;
-        case QUAD_NORMALS: writeQuad(vboBuffer, points, normals); break;
-        case QUAD_NORMALS_TEXCOORDS: writeQuad(vboBuffer, points, normals, textureCoords); break;
+        switch(writeCase)
+        {
+          case TRI: writeTri(vbo, points); break;
+          case TRI_TEXCOORDS: writeTri(vbo, points, textureCoords); break;
+          case TRI_NORMALS: writeTri(vbo, points, normals); break;
+          case TRI_NORMALS_TEXCOORDS: writeTri(vbo, points, normals, textureCoords); break;
+          case QUAD: writeQuad(vbo, points); break;
+          case QUAD_TEXCOORDS: writeQuad(vbo, points, textureCoords); break;
+          case QUAD_NORMALS: writeQuad(vbo, points, normals); break;
+          case QUAD_NORMALS_TEXCOORDS: writeQuad(vbo, points, normals, textureCoords); break;
+        }
       }
+    });
 
-      ++fiter;
-      --facesLeftInThisPass;
-    }
+    firstFaceOfPass += facesInThisPass;
 
     std::stringstream ss;
     ss << invertNormals << static_cast<int>(colorScheme) << faceTransparencyValue_ << "_" << passNumber;
 
-    std::string uniqueNodeID = id + "face" + ss.str();
-    std::string vboName = uniqueNodeID + "VBO";
-    std::string iboName = uniqueNodeID + "IBO";
-    std::string passName = uniqueNodeID + "Pass";
-    std::string shader = (useNormals ? "Shaders/Phong" : "Shaders/Flat");
+    addFacePass(geom, id + "face" + ss.str(), vboBufferSPtr, iboBufferSPtr, useNormals, useColorMap,
+      colorScheme, textureMap, state, mesh->get_bounding_box());
+    ++passNumber;
+  }
+}
+
+void GeometryBuilder::addFacePass(
+  GeometryHandle geom,
+  const std::string& uniqueNodeID,
+  std::shared_ptr<spire::VarBuffer> vboBufferSPtr,
+  std::shared_ptr<spire::VarBuffer> iboBufferSPtr,
+  bool useNormals,
+  bool useColorMap,
+  ColorScheme colorScheme,
+  ColorMapHandle textureMap,
+  const RenderState& state,
+  const BBox& bbox)
+{
+  std::string vboName = uniqueNodeID + "VBO";
+  std::string iboName = uniqueNodeID + "IBO";
+  std::string passName = uniqueNodeID + "Pass";
+  std::string shader = (useNormals ? "Shaders/Phong" : "Shaders/Flat");
 
-    std::vector<SpireVBO::AttributeData> attribs;
-    std::vector<SpireSubPass::Uniform> uniforms;
+  std::vector<SpireVBO::AttributeData> attribs;
+  std::vector<SpireSubPass::Uniform> uniforms;
 
-    attribs.push_back(SpireVBO::AttributeData("aPos", 3 * sizeof(float)));
-    uniforms.push_back(SpireSubPass::Uniform("uUseClippingPlanes", true));
-    uniforms.push_back(SpireSubPass::Uniform("uUseFog", true));
-    uniforms.push_back(SpireSubPass::Uniform("uTransparency", faceTransparencyValue_));
+  attribs.push_back(SpireVBO::AttributeData("aPos", 3 * sizeof(float)));
+  uniforms.push_back(SpireSubPass::Uniform("uUseClippingPlanes", true));
+  uniforms.push_back(SpireSubPass::Uniform("uUseFog", true));
+  uniforms.push_back(SpireSubPass::Uniform("uTransparency", faceTransparencyValue_));
 
-    if (useNormals)
+  if (useNormals)
+  {
+    attribs.push_back(SpireVBO::AttributeData("aNormal", 3 * sizeof(float)));
+    uniforms.push_back(SpireSubPass::Uniform("uAmbientColor", glm::vec4(0.1f, 0.1f, 0.1f, 1.0f)));
+    uniforms.push_back(SpireSubPass::Uniform("uSpecularColor", glm::vec4(0.1f, 0.1f, 0.1f, 0.1f)));
+    uniforms.push_back(SpireSubPass::Uniform("uSpecularPower", 32.0f));
+  }
+
+  SpireTexture2D texture;
+  if (useColorMap)
+  {
+    shader += "_ColorMap";
+    attribs.push_back(SpireVBO::AttributeData("aTexCoords", 2 * sizeof(float)));
+
+    const static int colorMapResolution = 256;
+    for(int i = 0; i < colorMapResolution; ++i)
     {
-      attribs.push_back(SpireVBO::AttributeData("aNormal", 3 * sizeof(float)));
-      uniforms.push_back(SpireSubPass::Uniform("uAmbientColor", glm::vec4(0.1f, 0.1f, 0.1f, 1.0f)));
-      uniforms.push_back(SpireSubPass::Uniform("uSpecularColor", glm::vec4(0.1f, 0.1f, 0.1f, 0.1f)));
-      uniforms.push_back(SpireSubPass::Uniform("uSpecularPower", 32.0f));
+      ColorRGB color = textureMap->valueToColor(static_cast<float>(i)/colorMapResolution * 2.0 - 1.0);
+      texture.bitmap.push_back(color.r()*255.99f);
+      texture.bitmap.push_back(color.g()*255.99f);
+      texture.bitmap.push_back(color.b()*255.99f);
+      texture.bitmap.push_back(color.a()*255.99f);
     }
+    texture.name = "ColorMap";
+    texture.height = 1;
+    texture.width = colorMapResolution;
+  }
+  else
+  {
+    uniforms.push_back(SpireSubPass::Uniform("uDiffuseColor",
+      glm::vec4(state.defaultColor.r(), state.defaultColor.g(), state.defaultColor.b(), 1.0f)));
+  }
 
-    SpireTexture2D texture;
-    if (useColorMap)
-    {
-      shader += "_ColorMap";
-      attribs.push_back(SpireVBO::AttributeData("aTexCoords", 2 * sizeof(float)));
+  //numVBOElements is only used in dead code and should be removed which is why its hard coded to 0
+  SpireVBO geomVBO(vboName, attribs, vboBufferSPtr, 0, bbox, true);
+  geom->vbos().push_back(geomVBO);
 
-      const static int colorMapResolution = 256;
-      for(int i = 0; i < colorMapResolution; ++i)
-      {
-        ColorRGB color = textureMap->valueToColor(static_cast<float>(i)/colorMapResolution * 2.0 - 1.0);
-        texture.bitmap.push_back(color.r()*255.99f);
-        texture.bitmap.push_back(color.g()*255.99f);
-        texture.bitmap.push_back(color.b()*255.99f);
-        texture.bitmap.push_back(color.a()*255.99f);
-      }
-      texture.name = "ColorMap";
-      texture.height = 1;
-      texture.width = colorMapResolution;
-    }
-    else
+  SpireIBO geomIBO(iboName, SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), iboBufferSPtr);
+  geom->ibos().push_back(geomIBO);
+
+  SpireText text;
+  SpireSubPass pass(passName, vboName, iboName, shader,
+    colorScheme, state, RenderType::RENDER_VBO_IBO, geomVBO, geomIBO, text, texture);
+
+  for (const auto& uniform : uniforms) pass.addUniform(uniform);
+
+  geom->passes().push_back(pass);
+}
+
+void GeometryBuilder::renderFacesVolumeBoundary(
+  FieldHandle field,
+  boost::optional<boost::shared_ptr<ColorMap>> colorMap,
+  RenderState state,
+  GeometryHandle geom,
+  const std::string& id)
+{
+  VField* fld = field->vfield();
+  VMesh*  mesh = field->vmesh();
+
+  // Topology is cached on the mesh, only vertex attributes are rebuilt here.
+  auto boundary = getVolumeBoundaryFaces(field, state_->getValue(BoundaryFacesByDomain).toBool());
+  if (!boundary || boundary->faces.empty()) return;
+
+  const int numNodesPerFace = boundary->nodesPerFace;
+  const size_t numFaces = boundary->faces.size();
+
+  bool useNormals = state.get(RenderState::USE_NORMALS);
+  bool useFaceNormals = state.get(RenderState::USE_FACE_NORMALS) && mesh->has_normals();
+  bool invertNormals = state_->getValue(FaceInvertNormals).toBool();
+  if (useFaceNormals)
+    mesh->synchronize(Mesh::NORMALS_E);
+
+  bool useColorMap = (fld->basis_order() >= 0 && state.get(RenderState::USE_COLORMAP));
+  bool isCellData = (fld->basis_order() == 0);
+
+  ColorScheme colorScheme = useColorMap ? ColorScheme::COLOR_MAP : ColorScheme::COLOR_UNIFORM;
+  ColorMapHandle textureMap, coordinateMap;
+  spiltColorMapToTextureAndCoordinates(colorMap, textureMap, coordinateMap);
+
+  auto valueIndex = [&](const VMesh::index_type index, bool atNode)
+  {
+    return atNode ? colorMapIndex(fld, coordinateMap, VMesh::Node::index_type(index))
+      : colorMapIndex(fld, coordinateMap, VMesh::Elem::index_type(index));
+  };
+
+  // Cell data is constant per face and needs its own vertices; everything else
+  // shares one vertex per boundary node.
+  const bool perFaceVertices = useColorMap && isCellData;
+  const size_t numVertices = perFaceVertices ? numFaces * numNodesPerFace : boundary->nodes.size();
+  const int floatsPerVertex = 3 + (useNormals ? 3 : 0) + (useColorMap ? 2 : 0);
+
+  std::vector<Vector> vertexNormals;
+  if (useNormals && !useFaceNormals && !perFaceVertices)
+  {
+    // area weighted average of the adjacent boundary triangles
+    vertexNormals.assign(numVertices, Vector(0, 0, 0));
+    const auto& tris = boundary->triangles;
+    for (size_t t = 0; t < tris.size(); t += 3)
     {
-      uniforms.push_back(SpireSubPass::Uniform("uDiffuseColor",
-        glm::vec4(state.defaultColor.r(), state.defaultColor.g(), state.defaultColor.b(), 1.0f)));
+      Point p0, p1, p2;
+      mesh->get_point(p0, boundary->nodes[tris[t]]);
+      mesh->get_point(p1, boundary->nodes[tris[t + 1]]);
+      mesh->get_point(p2, boundary->nodes[tris[t + 2]]);
+      Vector n = Cross(p1 - p0, p2 - p0);
+      for (int k = 0; k < 3; ++k)
+        vertexNormals[tris[t + k]] += n;
     }
+  }
 
-    //numVBOElements is only used in dead code and should be removed which is why its hard coded to 0
-    SpireVBO geomVBO(vboName, attribs, vboBufferSPtr, 0, mesh->get_bounding_box(), true);
-    geom->vbos().push_back(geomVBO);
+  std::vector<float> vertices(numVertices * floatsPerVertex);
+  const size_t numItems = perFaceVertices ? numFaces : numVertices;
+  const int numTasks = Parallel::NumTasks(numItems);
 
-    SpireIBO geomIBO(iboName, SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), iboBufferSPtr);
-    geom->ibos().push_back(geomIBO);
+  Parallel::RunRange(numItems, numTasks, [&](int, size_t begin, size_t end)
+  {
+    Point points[4];
+    Vector normals[4];
+    float texCoords[4][2] = {};
 
-    SpireText text;
-    SpireSubPass pass(passName, vboName, iboName, shader,
-      colorScheme, state, RenderType::RENDER_VBO_IBO, geomVBO, geomIBO, text, texture);
+    for (size_t item = begin; item < end; ++item)
+    {
+      const int corners = perFaceVertices ? numNodesPerFace : 1;
+      const VMesh::Node::index_type* nodes = perFaceVertices
+        ? &boundary->faceNodes[item * numNodesPerFace] : &boundary->nodes[item];
 
-    for (const auto& uniform : uniforms) pass.addUniform(uniform);
+      for (int i = 0; i < corners; ++i)
+        mesh->get_point(points[i], nodes[i]);
 
-    geom->passes().push_back(pass);
-    ++passNumber;
+      if (useNormals)
+      {
+        if (useFaceNormals)
+        {
+          for (int i = 0; i < corners; ++i)
+            mesh->get_normal(normals[i], nodes[i]);
+        }
+        else if (perFaceVertices)
+        {
+          Vector norm = Cross(points[1] - points[0], points[2] - points[1]);
+          if (numNodesPerFace == 4)
+            norm += Cross(points[2] - points[1], points[3] - points[2]) + Cross(points[3] - points[2], points[0] - points[3]) + Cross(points[0] - points[3], points[1] - points[0]);
+          norm.safe_normalize();
+          for (int i = 0; i < corners; ++i)
+            normals[i] = norm;
+        }
+        else
+        {
+          normals[0] = vertexNormals[item];
+          normals[0].safe_normalize();
+        }
+
+        if (invertNormals)
+          for (int i = 0; i < corners; ++i)
+            normals[i] = -normals[i];
+      }
+
+      if (useColorMap)
+      {
+        if (perFaceVertices)
+        {
+          // two sided: the shader picks the cell facing the viewer
+          const auto& cells = boundary->cells[item];
+          const float inside = static_cast<float>(valueIndex(cells.first, false));
+          const float outside = static_cast<float>(valueIndex(cells.second, false));
+          for (int i = 0; i < corners; ++i)
+          {
+            texCoords[i][0] = inside;
+            texCoords[i][1] = outside;
+          }
+        }
+        else if (fld->basis_order() == 1)
+        {
+          texCoords[0][0] = texCoords[0][1] = static_cast<float>(valueIndex(nodes[0], true));
+        }
+      }
+
+      float* out = &vertices[(perFaceVertices ? item * numNodesPerFace : item) * floatsPerVertex];
+      for (int i = 0; i < corners; ++i)
+      {
+        *out++ = static_cast<float>(points[i].x());
+        *out++ = static_cast<float>(points[i].y());
+        *out++ = static_cast<float>(points[i].z());
+        if (useNormals)
+        {
+          *out++ = static_cast<float>(normals[i].x());
+          *out++ = static_cast<float>(normals[i].y());
+          *out++ = static_cast<float>(normals[i].z());
+        }
+        if (useColorMap)
+        {
+          *out++ = texCoords[i][0];
+          *out++ = texCoords[i][1];
+        }
+      }
+    }
+  });
+
+  std::shared_ptr<spire::VarBuffer> vboBuffer(new spire::VarBuffer(vertices.size() * sizeof(float)));
+  vboBuffer->writeBytes(reinterpret_cast<const char*>(vertices.data()), vertices.size() * sizeof(float));
+
+  std::shared_ptr<spire::VarBuffer> iboBuffer;
+  if (perFaceVertices)
+  {
+    iboBuffer.reset(new spire::VarBuffer(numFaces * boundary->numTrianglesPerFace() * 3 * sizeof(uint32_t)));
+    for (uint32_t i = 0; i < numFaces * numNodesPerFace; i += numNodesPerFace)
+    {
+      iboBuffer->writeUnsafe(i + 0);
+      iboBuffer->writeUnsafe(i + 1);
+      iboBuffer->writeUnsafe(i + 2);
+      if (numNodesPerFace == 4)
+      {
+        iboBuffer->writeUnsafe(i + 2);
+        iboBuffer->writeUnsafe(i + 3);
+        iboBuffer->writeUnsafe(i + 0);
+      }
+    }
   }
+  else
+  {
+    const auto& tris = boundary->triangles;
+    iboBuffer.reset(new spire::VarBuffer(tris.size() * sizeof(uint32_t)));
+    iboBuffer->writeBytes(reinterpret_cast<const char*>(tris.data()), tris.size() * sizeof(uint32_t));
+  }
+
+  std::stringstream ss;
+  ss << invertNormals << static_cast<int>(colorScheme) << faceTransparencyValue_ << "_boundary";
+
+  addFacePass(geom, id + "face" + ss.str(), vboBuffer, iboBuffer, useNormals, useColorMap,
+    colorScheme, textureMap, state, mesh->get_bounding_box());
 }
 
 
@@ -833,12 +1072,7 @@ void GeometryBuilder::renderNodes(
   VField* fld = field->vfield();
   VMesh*  mesh = field->vmesh();
 
-  double sval;
-  Vector vval;
-  Tensor tval;
-
   ColorScheme colorScheme;
-  ColorRGB node_color;
 
   ColorMapHandle textureMap, coordinateMap;
   spiltColorMapToTextureAndCoordinates(colorMap, textureMap, coordinateMap);
@@ -852,10 +1086,6 @@ void GeometryBuilder::renderNodes(
 
   mesh->synchronize(Mesh::NODES_E);
 
-  VMesh::Node::iterator eiter, eiter_end;
-  mesh->begin(eiter);
-  mesh->end(eiter_end);
-
   double radius = state_->getValue(SphereScaleValue).toDouble();
   double num_strips = static_cast<double>(state_->getValue(SphereResolution).toInt());
   if (radius < 0) radius = 1.;
@@ -872,43 +1102,29 @@ void GeometryBuilder::renderNodes(
   if (state.get(RenderState::USE_SPHERE))
     primIn = SpireIBO::PRIMITIVE::TRIANGLES;
 
+  const bool useSpheres = state.get(RenderState::USE_SPHERE);
+  const bool useNodeValues = colorScheme != ColorScheme::COLOR_UNIFORM &&
+    (fld->is_scalar() || fld->is_vector() || fld->is_tensor());
+
   GlyphGeom glyphs;
-  while (eiter != eiter_end)
+  glyphs.addInParallel(mesh->num_nodes(), [&](GlyphGeom& nodeGlyphs, size_t begin, size_t end)
   {
-    Point p;
-    mesh->get_point(p, *eiter);
-    //coloring options
-    if (colorScheme != ColorScheme::COLOR_UNIFORM)
-    {
-      ColorMapHandle map = colorMap.get();
-      if (fld->is_scalar())
-      {
-        fld->get_value(sval, *eiter);
-        node_color = ColorRGB(coordinateMap->valueToIndex(sval));
-      }
-      else if (fld->is_vector())
-      {
-        fld->get_value(vval, *eiter);
-        node_color = ColorRGB(coordinateMap->valueToIndex(vval));
-      }
-      else if (fld->is_tensor())
-      {
-        fld->get_value(tval, *eiter);
-        node_color = ColorRGB(coordinateMap->valueToIndex(tval));
-      }
-    }
-    //accumulate VBO or IBO data
-    if (state.get(RenderState::USE_SPHERE))
+    ColorRGB node_color;
+    for (size_t i = begin; i < end; ++i)
     {
-      glyphs.addSphere(p, radius, num_strips, node_color);
-    }
-    else
-    {
-      glyphs.addPoint(p, node_color);
+      const VMesh::Node::index_type node(static_cast<VMesh::index_type>(i));
+      Point p;
+      mesh->get_point(p, node);
+      //coloring options
+      if (useNodeValues)
+        node_color = ColorRGB(colorMapIndex(fld, coordinateMap, node));
+      //accumulate VBO or IBO data
+      if (useSpheres)
+        nodeGlyphs.addSphere(p, radius, num_strips, node_color);
+      else
+        nodeGlyphs.addPoint(p, node_color);
     }
-
-    ++eiter;
-  }
+  });
 
   glyphs.buildObject(*geom, uniqueNodeID, state.get(RenderState::USE_TRANSPARENT_NODES), nodeTransparencyValue_,
     colorScheme, state, primIn, mesh->get_bounding_box(), true, textureMap);
@@ -926,12 +1142,7 @@ void GeometryBuilder::renderEdges(
   VField* fld = field->vfield();
   VMesh*  mesh = field->vmesh();
 
-  double sval0, sval1;
-  Vector vval0, vval1;
-  Tensor tval0, tval1;
-
   ColorScheme colorScheme;
-  ColorRGB edge_colors[2];
 
   ColorMapHandle textureMap, coordinateMap;
   spiltColorMapToTextureAndCoordinates(colorMap, textureMap, coordinateMap);
@@ -947,10 +1158,6 @@ void GeometryBuilder::renderEdges(
 
   mesh->synchronize(Mesh::EDGES_E);
 
-  VMesh::Edge::iterator eiter, eiter_end;
-  mesh->begin(eiter);
-  mesh->end(eiter_end);
-
   double num_strips = static_cast<double>(state_->getValue(CylinderResolution).toInt());
   double radius = state_->getValue(CylinderRadius).toDouble();
   if (num_strips < 0) num_strips = 50.;
@@ -966,86 +1173,52 @@ void GeometryBuilder::renderEdges(
   if (state.get(RenderState::USE_CYLINDER))
     primIn = SpireIBO::PRIMITIVE::TRIANGLES;
 
+  const bool useCylinders = state.get(RenderState::USE_CYLINDER);
+  const bool useEdgeValues = colorScheme != ColorScheme::COLOR_UNIFORM &&
+    (fld->is_scalar() || fld->is_vector() || fld->is_tensor());
+
   GlyphGeom glyphs;
-  while (eiter != eiter_end)
+  glyphs.addInParallel(mesh->num_edges(), [&](GlyphGeom& edgeGlyphs, size_t begin, size_t end)
   {
     VMesh::Node::array_type nodes;
-    mesh->get_nodes(nodes, *eiter);
-
-    Point p0, p1;
-    mesh->get_point(p0, nodes[0]);
-    mesh->get_point(p1, nodes[1]);
-    //coloring options
-    if (colorScheme != ColorScheme::COLOR_UNIFORM)
+    ColorRGB edge_colors[2];
+    for (size_t i = begin; i < end; ++i)
     {
-      ColorMapHandle map = colorMap.get();
-      if (fld->is_scalar())
+      const VMesh::Edge::index_type edge(static_cast<VMesh::index_type>(i));
+      mesh->get_nodes(nodes, edge);
+
+      Point p0, p1;
+      mesh->get_point(p0, nodes[0]);
+      mesh->get_point(p1, nodes[1]);
+      //coloring options
+      if (useEdgeValues)
       {
         if (fld->basis_order() == 1)
         {
-          fld->get_value(sval0, nodes[0]);
-          fld->get_value(sval1, nodes[1]);
+          edge_colors[0] = ColorRGB(colorMapIndex(fld, coordinateMap, nodes[0]));
+          edge_colors[1] = ColorRGB(colorMapIndex(fld, coordinateMap, nodes[1]));
         }
         else //if (mesh->dimensionality() == 1)
         {
-          fld->get_value(sval0, *eiter);
-
-          sval1 = sval0;
+          edge_colors[0] = edge_colors[1] = ColorRGB(colorMapIndex(fld, coordinateMap, edge));
         }
-        edge_colors[0] = ColorRGB(coordinateMap->valueToIndex(sval0));
-        edge_colors[1] = ColorRGB(coordinateMap->valueToIndex(sval1));
       }
-      else if (fld->is_vector())
+      //accumulate VBO or IBO data
+      if (p0 != p1)
       {
-        if (fld->basis_order() == 1)
+        if (useCylinders)
         {
-          fld->get_value(vval0, nodes[0]);
-          fld->get_value(vval1, nodes[1]);
+          edgeGlyphs.addCylinder(p0, p1, radius, num_strips, edge_colors[0], edge_colors[1]);
+          edgeGlyphs.addSphere(p0, radius, num_strips, edge_colors[0]);
+          edgeGlyphs.addSphere(p1, radius, num_strips, edge_colors[1]);
         }
-        else //if (mesh->dimensionality() == 1)
-        {
-          fld->get_value(vval0, *eiter);
-          vval1 = vval0;
-        }
-
-        edge_colors[0] = ColorRGB(coordinateMap->valueToIndex(vval0));
-        edge_colors[1] = ColorRGB(coordinateMap->valueToIndex(vval1));
-      }
-      else if (fld->is_tensor())
-      {
-        if (fld->basis_order() == 1)
-        {
-          fld->get_value(tval0, nodes[0]);
-          fld->get_value(tval1, nodes[1]);
-        }
-        else //if (mesh->dimensionality() == 1)
+        else
         {
-          fld->get_value(tval0, *eiter);
-          tval1 = tval0;
+          edgeGlyphs.addLine(p0, p1, edge_colors[0], edge_colors[1]);
         }
-
-        edge_colors[0] = ColorRGB(coordinateMap->valueToIndex(tval0));
-        edge_colors[1] = ColorRGB(coordinateMap->valueToIndex(tval1));
-      }
-    }
-    //accumulate VBO or IBO data
-
-    if (p0 != p1)
-    {
-      if (state.get(RenderState::USE_CYLINDER))
-      {
-        glyphs.addCylinder(p0, p1, radius, num_strips, edge_colors[0], edge_colors[1]);
-        glyphs.addSphere(p0, radius, num_strips, edge_colors[0]);
-        glyphs.addSphere(p1, radius, num_strips, edge_colors[1]);
-      }
-      else
-      {
-        glyphs.addLine(p0, p1, edge_colors[0], edge_colors[1]);
       }
     }
-
-    ++eiter;
-  }
+  });
 
   glyphs.buildObject(*geom, uniqueNodeID, state.get(RenderState::USE_TRANSPARENT_EDGES), edgeTransparencyValue_,
     colorScheme, state, primIn, mesh->get_bounding_box(), true, textureMap);
@@ -1120,3 +1293,5 @@ ALGORITHM_PARAMETER_DEF(Visualization, TextSize);
 ALGORITHM_PARAMETER_DEF(Visualization, TextPrecision);
 ALGORITHM_PARAMETER_DEF(Visualization, TextColoring);
 ALGORITHM_PARAMETER_DEF(Visualization, UseFaceNormals);
+ALGORITHM_PARAMETER_DEF(Visualization, BoundaryFacesOnly);
+ALGORITHM_PARAMETER_DEF(Visualization, BoundaryFacesByDomain);
@@ -37,11 +37,14 @@
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Tensor.h>
 #include <Graphics/Glyphs/GlyphGeom.h>
+#include <Graphics/Glyphs/InstancedGlyphGeom.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Datatypes/Color.h>
 #include <Graphics/Datatypes/GeometryImpl.h>
 
+#include <Core/Thread/Parallel.h>
+#include <numeric>
 #define _USE_MATH_DEFINES
 #include <math.h>
 
@@ -131,6 +134,18 @@ namespace SCIRun {
           bool render_base1,
           bool render_base2);
 
+        /// Template shape of vector glyphs that can be drawn as instances.
+        boost::optional<InstancedGlyphGeom::Shape> instancedVectorShape(int glyph_type, bool use_lines);
+
+        void addInstancedGlyph(
+          InstancedGlyphGeom& glyphs,
+          int glyph_type,
+          const Point& p1,
+          const Vector& dir,
+          double radius,
+          double scale,
+          const ColorRGB& node_color);
+
       };
     }
   }
@@ -225,6 +240,51 @@ void GlyphBuilder::addGlyph(
   }
 }
 
+boost::optional<InstancedGlyphGeom::Shape> GlyphBuilder::instancedVectorShape(int glyph_type, bool use_lines)
+{
+  switch (glyph_type)
+  {
+    case RenderState::GlyphType::CONE_GLYPH:
+      return InstancedGlyphGeom::Shape::CONE;
+    case RenderState::GlyphType::ARROW_GLYPH:
+      return InstancedGlyphGeom::Shape::ARROW;
+    case RenderState::GlyphType::DISK_GLYPH:
+      return InstancedGlyphGeom::Shape::DISK;
+    case RenderState::GlyphType::LINE_GLYPH:
+    case RenderState::GlyphType::NEEDLE_GLYPH:
+    case RenderState::GlyphType::COMET_GLYPH:
+    case RenderState::GlyphType::RING_GLYPH:
+    case RenderState::GlyphType::SPRING_GLYPH:
+      return boost::none;
+    default:
+      if (use_lines)
+        return boost::none;
+      return InstancedGlyphGeom::Shape::ARROW;
+  }
+}
+
+// Places the template the same way addGlyph places the tessellated glyph.
+void GlyphBuilder::addInstancedGlyph(
+  InstancedGlyphGeom& glyphs,
+  int glyph_type,
+  const Point& p1,
+  const Vector& dir,
+  double radius,
+  double scale,
+  const ColorRGB& node_color)
+{
+  double scaled_radius = scale * radius;
+  if (glyph_type == RenderState::GlyphType::DISK_GLYPH)
+  {
+    Point new_p2 = p1 + dir.normal() * scaled_radius * 2.0;
+    double new_radius = dir.length() * scale * 0.5;
+    glyphs.addAxial(p1, new_p2, new_radius, node_color);
+  }
+  else
+  {
+    glyphs.addAxial(p1, p1 + dir * scale, scaled_radius, node_color);
+  }
+}
 
 ShowFieldGlyphs::ShowFieldGlyphs() : GeometryGeneratingModule(staticInfo_), builder_(new GlyphBuilder(id().id_))
 {
@@ -292,6 +352,8 @@ void ShowFieldGlyphs::setStateDefaults()
   state->setValue(RenderTensorsBelowThreshold, true);
   state->setValue(TensorsThreshold, 0.0);
   state->setValue(TensorsResolution, 10);
+
+  state->setValue(GlyphInstancing, false);
 }
 
 void ShowFieldGlyphs::execute()
@@ -547,54 +609,86 @@ void GlyphBuilder::renderVectors(
   auto points = std::vector<Point>();
   getPoints(mesh, indices, points);
 
-  GlyphGeom glyphs;
-  // Render every item from facade
+  if (renState.mGlyphType == RenderState::GlyphType::SPRING_GLYPH)
+    BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Spring Geom is not supported yet."));
+
+  // The port handler caches the values it last looked up, so field data is gathered serially
+  // and only the glyph geometry is generated in parallel.
+  bool scaleByInput = state->getValue(ShowFieldGlyphs::SecondaryVectorParameterScalingType).toInt() == SecondaryVectorParameterScalingTypeEnum::USE_INPUT;
+  std::vector<size_t> visible;
+  std::vector<Vector> dirs;
+  std::vector<double> radii;
+  std::vector<ColorRGB> colors;
   for(int i = 0; i < indices.size(); i++)
   {
-    Vector v, pinputVector; Point p2, p3; double radius;
-
-    pinputVector = portHandler_->getPrimaryVector(indices[i]);
+    Vector pinputVector = portHandler_->getPrimaryVector(indices[i]);
+    if(!renderGlphysBelowThreshold && pinputVector.length() < threshold)
+      continue;
 
       // Normalize/Scale
     Vector dir = pinputVector;
     if(normalizeGlyphs)
     dir.normalize();
-    // v = pinputVector.normal() * scale;
-    // else
-    // v = pinputVector * scale;
-
-    // Calculate points
-    // p2 = points[i] + v;
-    // p3 = points[i] - v;
 
     // Get radius
-    // radius = scale * radiusWidthScale / 2.0;
-    radius = radiusWidthScale / 2.0;
-    if(state->getValue(ShowFieldGlyphs::SecondaryVectorParameterScalingType).toInt() == SecondaryVectorParameterScalingTypeEnum::USE_INPUT)
+    double radius = radiusWidthScale / 2.0;
+    if(scaleByInput)
       radius *= portHandler_->getSecondaryVectorParameter(indices[i]);
 
-    ColorRGB node_color = portHandler_->getNodeColor(indices[i]);
+    visible.push_back(i);
+    dirs.push_back(dir);
+    radii.push_back(radius);
+    colors.push_back(portHandler_->getNodeColor(indices[i]));
+  }
+
+  // No need to render cylinder base if arrow is bidirectional
+  bool render_cylinder_base = renderBases && !renderBidirectionaly;
+
+  std::stringstream ss;
+  ss << renState.mGlyphType << resolution << scale << static_cast<int>(colorScheme);
+
+  std::string uniqueNodeID = id + "vector_glyphs" + ss.str();
+
+  auto instancedShape = instancedVectorShape(renState.mGlyphType, useLines);
+  if (instancedShape && state->getValue(ShowFieldGlyphs::GlyphInstancing).toBool())
+  {
+    InstancedGlyphGeom glyphs(*instancedShape, resolution, arrowHeadRatio, render_cylinder_base, renderBases);
+    glyphs.addInParallel(visible.size(), [&](InstancedGlyphGeom& vectorGlyphs, size_t begin, size_t end)
+    {
+      for (size_t g = begin; g < end; ++g)
+      {
+        const Point& p = points[visible[g]];
+        addInstancedGlyph(vectorGlyphs, renState.mGlyphType, p, dirs[g], radii[g], scale, colors[g]);
+        if(renderBidirectionaly)
+          addInstancedGlyph(vectorGlyphs, renState.mGlyphType, p, -dirs[g], radii[g], scale, colors[g]);
+      }
+    });
+
+    glyphs.buildObject(*geom, uniqueNodeID, renState.get(RenderState::USE_TRANSPARENT_EDGES),
+                       state->getValue(ShowFieldGlyphs::VectorsUniformTransparencyValue).toDouble(),
+                       colorScheme, renState, mesh->get_bounding_box(), true, portHandler_->getTextureMap());
+    return;
+  }
 
-    if(renderGlphysBelowThreshold || pinputVector.length() >= threshold)
+  GlyphGeom glyphs;
+  glyphs.addInParallel(visible.size(), [&](GlyphGeom& vectorGlyphs, size_t begin, size_t end)
+  {
+    for (size_t g = begin; g < end; ++g)
     {
-      // No need to render cylinder base if arrow is bidirectional
-      bool render_cylinder_base = renderBases && !renderBidirectionaly;
-      addGlyph(glyphs, renState.mGlyphType, points[i], dir, radius, scale, arrowHeadRatio,
+      Point p = points[visible[g]];
+      Vector dir = dirs[g];
+      ColorRGB node_color = colors[g];
+      addGlyph(vectorGlyphs, renState.mGlyphType, p, dir, radii[g], scale, arrowHeadRatio,
                resolution, node_color, useLines, render_cylinder_base, renderBases);
 
       if(renderBidirectionaly)
       {
         Vector neg_dir = -dir;
-        addGlyph(glyphs, renState.mGlyphType, points[i], neg_dir, radius, scale, arrowHeadRatio,
+        addGlyph(vectorGlyphs, renState.mGlyphType, p, neg_dir, radii[g], scale, arrowHeadRatio,
                  resolution, node_color, useLines, render_cylinder_base, renderBases);
       }
     }
-  }
-
-  std::stringstream ss;
-  ss << renState.mGlyphType << resolution << scale << static_cast<int>(colorScheme);
-
-  std::string uniqueNodeID = id + "vector_glyphs" + ss.str();
+  });
 
   glyphs.buildObject(*geom, uniqueNodeID, renState.get(RenderState::USE_TRANSPARENT_EDGES),
                      state->getValue(ShowFieldGlyphs::VectorsUniformTransparencyValue).toDouble(),
@@ -631,34 +725,24 @@ void GlyphBuilder::renderScalars(
   auto points = std::vector<Point>();
   getPoints(mesh, indices, points);
 
-  GlyphGeom glyphs;
-  // Render every item from facade
-  for(int i = 0; i < indices.size(); i++)
+  switch (renState.mGlyphType)
   {
+    case RenderState::GlyphType::BOX_GLYPH:
+      BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Box Geom is not supported yet."));
+    case RenderState::GlyphType::AXIS_GLYPH:
+      BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Axis Geom is not supported yet."));
+    default:
+      break;
+  }
 
+  // Field data is gathered serially (the port handler is stateful), glyphs are built in parallel.
+  std::vector<double> radii(indices.size());
+  std::vector<ColorRGB> colors(indices.size());
+  for(int i = 0; i < indices.size(); i++)
+  {
     double v = portHandler_->getPrimaryScalar(indices[i]);
-    ColorRGB node_color = portHandler_->getNodeColor(indices[i]);
-    double radius = std::abs(v) * scale;
-
-    switch (renState.mGlyphType)
-    {
-      case RenderState::GlyphType::POINT_GLYPH:
-        glyphs.addPoint(points[i], node_color);
-        break;
-      case RenderState::GlyphType::SPHERE_GLYPH:
-        glyphs.addSphere(points[i], radius, resolution, node_color);
-        break;
-      case RenderState::GlyphType::BOX_GLYPH:
-        BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Box Geom is not supported yet."));
-      case RenderState::GlyphType::AXIS_GLYPH:
-        BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Axis Geom is not supported yet."));
-      default:
-        if (usePoints)
-          glyphs.addPoint(points[i], node_color);
-        else
-          glyphs.addSphere(points[i], radius, resolution, node_color);
-        break;
-    }
+    colors[i] = portHandler_->getNodeColor(indices[i]);
+    radii[i] = std::abs(v) * scale;
   }
 
   std::stringstream ss;
@@ -666,6 +750,34 @@ void GlyphBuilder::renderScalars(
 
   std::string uniqueNodeID = id + "scalar_glyphs" + ss.str();
 
+  if (!usePoints && state->getValue(ShowFieldGlyphs::GlyphInstancing).toBool())
+  {
+    InstancedGlyphGeom spheres(InstancedGlyphGeom::Shape::SPHERE, resolution);
+    spheres.addInParallel(indices.size(), [&](InstancedGlyphGeom& scalarGlyphs, size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+        scalarGlyphs.addSphere(points[i], radii[i], colors[i]);
+    });
+
+    spheres.buildObject(*geom, uniqueNodeID, renState.get(RenderState::USE_TRANSPARENT_NODES),
+                        state->getValue(ShowFieldGlyphs::ScalarsUniformTransparencyValue).toDouble(),
+                        colorScheme, renState, mesh->get_bounding_box(), true,
+                        portHandler_->getTextureMap());
+    return;
+  }
+
+  GlyphGeom glyphs;
+  glyphs.addInParallel(indices.size(), [&](GlyphGeom& scalarGlyphs, size_t begin, size_t end)
+  {
+    for (size_t i = begin; i < end; ++i)
+    {
+      if (usePoints)
+        scalarGlyphs.addPoint(points[i], colors[i]);
+      else
+        scalarGlyphs.addSphere(points[i], radii[i], resolution, colors[i]);
+    }
+  });
+
   glyphs.buildObject(*geom, uniqueNodeID, renState.get(RenderState::USE_TRANSPARENT_NODES),
                      state->getValue(ShowFieldGlyphs::ScalarsUniformTransparencyValue).toDouble(),
                      colorScheme, renState, primIn, mesh->get_bounding_box(), true,
@@ -717,100 +829,149 @@ void GlyphBuilder::renderTensors(
 
   SpireIBO::PRIMITIVE primIn = SpireIBO::PRIMITIVE::TRIANGLES;
 
-  GlyphGeom tensor_line_glyphs;
-  GlyphGeom point_glyphs;
-
-  int neg_eigval_count = 0;
-  int tensorcount = 0;
   static const double vectorThreshold = 0.001;
   static const double pointThreshold = 0.01;
   static const double epsilon = pow(2, -52);
+  const double emphasis = state->getValue(ShowFieldGlyphs::SuperquadricEmphasis).toDouble();
 
-  GlyphGeom glyphs;
-  // Render every item from facade
+  // Field data is gathered serially (the port handler is stateful); eigen decomposition and
+  // glyph geometry run on contiguous ranges in parallel and are appended in order.
+  std::vector<Tensor> tensors(indices.size());
+  std::vector<ColorRGB> colors(indices.size());
   for(int i = 0; i < indices.size(); i++)
   {
-    Tensor t = portHandler_->getPrimaryTensor(indices[i]);
+    tensors[i] = portHandler_->getPrimaryTensor(indices[i]);
+    colors[i] = portHandler_->getNodeColor(indices[i]);
+  }
 
-    double eigen1, eigen2, eigen3;
-    t.get_eigenvalues(eigen1, eigen2, eigen3);
-    Vector eigvals(fabs(eigen1), fabs(eigen2), fabs(eigen3));
+  // Ellipsoids and boxes are placed as instances of one template mesh.
+  boost::optional<InstancedGlyphGeom::Shape> instancedShape;
+  if (state->getValue(ShowFieldGlyphs::GlyphInstancing).toBool())
+  {
+    if (renState.mGlyphType == RenderState::GlyphType::BOX_GLYPH)
+      instancedShape = InstancedGlyphGeom::Shape::BOX;
+    else if (renState.mGlyphType == RenderState::GlyphType::ELLIPSOID_GLYPH ||
+             (renState.mGlyphType == RenderState::GlyphType::SUPERQUADRIC_TENSOR_GLYPH && emphasis <= 0.0))
+      instancedShape = InstancedGlyphGeom::Shape::ELLIPSOID;
+  }
 
-    // Counter for negative eigen values
-    if(eigen1 < -epsilon || eigen2 < -epsilon || eigen3 < -epsilon) ++neg_eigval_count;
+  const int numTasks = GlyphGeom::numParallelTasks(indices.size());
+  std::vector<GlyphGeom> taskGlyphs(numTasks), taskLineGlyphs(numTasks), taskPointGlyphs(numTasks);
+  std::vector<InstancedGlyphGeom> taskInstancedGlyphs;
+  if (instancedShape)
+    taskInstancedGlyphs.assign(numTasks, InstancedGlyphGeom(*instancedShape, resolution));
+  std::vector<int> taskNegEigvalCounts(numTasks, 0);
 
-    Vector eigvec1, eigvec2, eigvec3;
-    t.get_eigenvectors(eigvec1, eigvec2, eigvec3);
+  Parallel::RunRange(indices.size(), numTasks, [&](int task, size_t begin, size_t end)
+  {
+    GlyphGeom& glyphs = taskGlyphs[task];
+    GlyphGeom& tensor_line_glyphs = taskLineGlyphs[task];
+    GlyphGeom& point_glyphs = taskPointGlyphs[task];
+    int& neg_eigval_count = taskNegEigvalCounts[task];
 
-    // Checks to see if eigenvalues are below defined threshold
-    bool vector_eig_x_0 = eigvals.x() <= vectorThreshold;
-    bool vector_eig_y_0 = eigvals.y() <= vectorThreshold;
-    bool vector_eig_z_0 = eigvals.z() <= vectorThreshold;
-    bool point_eig_x_0 = eigvals.x() <= pointThreshold;
-    bool point_eig_y_0 = eigvals.y() <= pointThreshold;
-    bool point_eig_z_0 = eigvals.z() <= pointThreshold;
+    for (size_t i = begin; i < end; ++i)
+    {
+      Tensor t = tensors[i];
 
-    bool order0Tensor = (point_eig_x_0 && point_eig_y_0 && point_eig_z_0);
-    bool order1Tensor = (vector_eig_x_0 + vector_eig_y_0 + vector_eig_z_0) >= 2;
+      double eigen1, eigen2, eigen3;
+      t.get_eigenvalues(eigen1, eigen2, eigen3);
+      Vector eigvals(fabs(eigen1), fabs(eigen2), fabs(eigen3));
 
-    ColorRGB node_color = portHandler_->getNodeColor(indices[i]);
+      // Counter for negative eigen values
+      if(eigen1 < -epsilon || eigen2 < -epsilon || eigen3 < -epsilon) ++neg_eigval_count;
 
-    // Do not render tensors that are too small - because surfaces
-    // are not renderd at least two of the scales must be non zero.
-    if(!renderGlyphsBelowThreshold && t.magnitude() < threshold) continue;
+      Vector eigvec1, eigvec2, eigvec3;
+      t.get_eigenvectors(eigvec1, eigvec2, eigvec3);
 
-    if(order0Tensor)
-    {
-      point_glyphs.addPoint(points[i], node_color);
-    }
-    else if(order1Tensor)
-    {
-      Vector dir;
-      if(vector_eig_x_0 && vector_eig_y_0)
-        dir = eigvec3 * eigvals[2];
-      else if(vector_eig_y_0 && vector_eig_z_0)
-        dir = eigvec1 * eigvals[0];
-      else if(vector_eig_x_0 && vector_eig_z_0)
-        dir = eigvec2 * eigvals[1];
-      // Point p1 = points[i];
-      // Point p2 = points[i] + dir;
-      addGlyph(tensor_line_glyphs, RenderState::GlyphType::LINE_GLYPH, points[i], dir, scale, scale, scale, resolution, node_color, true);
-    }
-    // Render as order 2 or 3 tensor
-    else
-    {
-      switch (renState.mGlyphType)
+      // Checks to see if eigenvalues are below defined threshold
+      bool vector_eig_x_0 = eigvals.x() <= vectorThreshold;
+      bool vector_eig_y_0 = eigvals.y() <= vectorThreshold;
+      bool vector_eig_z_0 = eigvals.z() <= vectorThreshold;
+      bool point_eig_x_0 = eigvals.x() <= pointThreshold;
+      bool point_eig_y_0 = eigvals.y() <= pointThreshold;
+      bool point_eig_z_0 = eigvals.z() <= pointThreshold;
+
+      bool order0Tensor = (point_eig_x_0 && point_eig_y_0 && point_eig_z_0);
+      bool order1Tensor = (vector_eig_x_0 + vector_eig_y_0 + vector_eig_z_0) >= 2;
+
+      ColorRGB node_color = colors[i];
+      Point point = points[i];
+
+      // Do not render tensors that are too small - because surfaces
+      // are not renderd at least two of the scales must be non zero.
+      if(!renderGlyphsBelowThreshold && t.magnitude() < threshold) continue;
+
+      if(order0Tensor)
       {
-        case RenderState::GlyphType::BOX_GLYPH:
-          glyphs.addBox(points[i], t, scale, node_color, normalizeGlyphs);
-          break;
-        case RenderState::GlyphType::ELLIPSOID_GLYPH:
-          glyphs.addEllipsoid(points[i], t, scale, resolution, node_color, normalizeGlyphs);
-          break;
-        case RenderState::GlyphType::SUPERQUADRIC_TENSOR_GLYPH:
+        point_glyphs.addPoint(point, node_color);
+      }
+      else if(order1Tensor)
+      {
+        Vector dir;
+        if(vector_eig_x_0 && vector_eig_y_0)
+          dir = eigvec3 * eigvals[2];
+        else if(vector_eig_y_0 && vector_eig_z_0)
+          dir = eigvec1 * eigvals[0];
+        else if(vector_eig_x_0 && vector_eig_z_0)
+          dir = eigvec2 * eigvals[1];
+        addGlyph(tensor_line_glyphs, RenderState::GlyphType::LINE_GLYPH, point, dir, scale, scale, scale, resolution, node_color, true);
+      }
+      // Render as order 2 or 3 tensor
+      else if (instancedShape)
+      {
+        taskInstancedGlyphs[task].addTensor(point, t, scale, normalizeGlyphs, node_color);
+      }
+      else
+      {
+        switch (renState.mGlyphType)
         {
-          double emphasis = state->getValue(ShowFieldGlyphs::SuperquadricEmphasis).toDouble();
-          if(emphasis > 0.0)
-            glyphs.addSuperquadricTensor(points[i], t, scale, resolution, node_color, normalizeGlyphs, emphasis);
-          else
-            glyphs.addEllipsoid(points[i], t, scale, resolution, node_color, normalizeGlyphs);
+          case RenderState::GlyphType::BOX_GLYPH:
+            glyphs.addBox(point, t, scale, node_color, normalizeGlyphs);
+            break;
+          case RenderState::GlyphType::ELLIPSOID_GLYPH:
+            glyphs.addEllipsoid(point, t, scale, resolution, node_color, normalizeGlyphs);
+            break;
+          case RenderState::GlyphType::SUPERQUADRIC_TENSOR_GLYPH:
+          {
+            if(emphasis > 0.0)
+              glyphs.addSuperquadricTensor(point, t, scale, resolution, node_color, normalizeGlyphs, emphasis);
+            else
+              glyphs.addEllipsoid(point, t, scale, resolution, node_color, normalizeGlyphs);
+          }
+          default:
+            break;
         }
-        default:
-          break;
       }
-      tensorcount++;
     }
-  }
+  });
+
+  GlyphGeom glyphs, tensor_line_glyphs, point_glyphs;
+  glyphs.append(taskGlyphs);
+  tensor_line_glyphs.append(taskLineGlyphs);
+  point_glyphs.append(taskPointGlyphs);
+  int neg_eigval_count = std::accumulate(taskNegEigvalCounts.begin(), taskNegEigvalCounts.end(), 0);
 
   // Prints warning if there are negative eigen values
   if(neg_eigval_count > 0) {
       module_->warning(std::to_string(neg_eigval_count) + " negative eigen values in data.");
   }
 
-  glyphs.buildObject(*geom, uniqueNodeID, renState.get(RenderState::USE_TRANSPARENCY),
-                     state->getValue(ShowFieldGlyphs::TensorsUniformTransparencyValue).toDouble(),
-                     colorScheme, renState, primIn, mesh->get_bounding_box(), true,
-                     portHandler_->getTextureMap());
+  if (instancedShape)
+  {
+    InstancedGlyphGeom instancedGlyphs(*instancedShape, resolution);
+    instancedGlyphs.append(taskInstancedGlyphs);
+    instancedGlyphs.buildObject(*geom, uniqueNodeID, renState.get(RenderState::USE_TRANSPARENCY),
+                                state->getValue(ShowFieldGlyphs::TensorsUniformTransparencyValue).toDouble(),
+                                colorScheme, renState, mesh->get_bounding_box(), true,
+                                portHandler_->getTextureMap());
+  }
+  else
+  {
+    glyphs.buildObject(*geom, uniqueNodeID, renState.get(RenderState::USE_TRANSPARENCY),
+                       state->getValue(ShowFieldGlyphs::TensorsUniformTransparencyValue).toDouble(),
+                       colorScheme, renState, primIn, mesh->get_bounding_box(), true,
+                       portHandler_->getTextureMap());
+  }
 
   // Render lines(2 eigenvalues equalling 0)
   RenderState lineRenState = getVectorsRenderState(state);
@@ -1067,3 +1228,4 @@ const AlgorithmParameterName ShowFieldGlyphs::TensorsScale("TensorsScale");
 const AlgorithmParameterName ShowFieldGlyphs::RenderTensorsBelowThreshold("RenderTensorsBelowThreshold");
 const AlgorithmParameterName ShowFieldGlyphs::TensorsThreshold("TensorsThreshold");
 const AlgorithmParameterName ShowFieldGlyphs::TensorsResolution("TensorsResolution");
+const AlgorithmParameterName ShowFieldGlyphs::GlyphInstancing("GlyphInstancing");
@@ -99,6 +99,8 @@ namespace SCIRun {
         static const Core::Algorithms::AlgorithmParameterName RenderTensorsBelowThreshold;
         static const Core::Algorithms::AlgorithmParameterName TensorsThreshold;
         static const Core::Algorithms::AlgorithmParameterName TensorsResolution;
+        // Draw spheres, arrows, cones, disks, ellipsoids and boxes as instances of one template.
+        static const Core::Algorithms::AlgorithmParameterName GlyphInstancing;
 
         INPUT_PORT(0, PrimaryData, Field);
         INPUT_PORT(1, PrimaryColorMap, ColorMap);
@@ -30,6 +30,12 @@
 #include <Modules/Visualization/ShowField.h>
 #include <Core/Logging/Log.h>
 #include <Core/Datatypes/ColorMap.h>
+#include <Core/Algorithms/Visualization/VolumeBoundaryFaces.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Thread/Parallel.h>
+#include <Graphics/Datatypes/GeometryImpl.h>
 
 using namespace SCIRun::Testing;
 using namespace SCIRun::TestUtils;
@@ -42,6 +48,7 @@ using namespace SCIRun::Modules::Visualization;
 using namespace SCIRun::Core;
 using namespace SCIRun;
 using namespace Logging;
+using namespace SCIRun::Core::Geometry;
 using ::testing::Values;
 using ::testing::Combine;
 using ::testing::Range;
@@ -165,3 +172,158 @@ TEST_F(ShowFieldPerformanceTest, TestFacePerformance)
   }
   std::cout << "\n";
 }
+
+TEST(VolumeBoundaryFacesTest, LatVolBoundaryIsSharedAndOutwardFacing)
+{
+  const int n = 6;
+  auto field = CreateEmptyLatVol(n, n, n);
+  auto mesh = field->vmesh();
+  auto boundary = computeVolumeBoundaryFaces(mesh);
+
+  EXPECT_EQ(6 * (n - 1) * (n - 1), boundary->faces.size());
+  EXPECT_EQ(n * n * n - (n - 2) * (n - 2) * (n - 2), boundary->nodes.size());
+  EXPECT_EQ(2 * 3 * boundary->faces.size(), boundary->triangles.size());
+
+  for (size_t f = 0; f < boundary->faces.size(); ++f)
+  {
+    EXPECT_EQ(boundary->cells[f].first, boundary->cells[f].second);
+    Point p[3], cellCenter, faceCenter;
+    for (int i = 0; i < 3; ++i)
+      mesh->get_point(p[i], boundary->faceNodes[f * 4 + i]);
+    mesh->get_center(cellCenter, boundary->cells[f].first);
+    mesh->get_center(faceCenter, boundary->faces[f]);
+    EXPECT_GT(Dot(Cross(p[1] - p[0], p[2] - p[1]), faceCenter - cellCenter), 0);
+  }
+}
+
+TEST(VolumeBoundaryFacesTest, CachedOnMeshAndSplitsByDomain)
+{
+  const int n = 5;
+  FieldInformation fi(LATVOLMESH_E, CONSTANTDATA_E, DOUBLE_E);
+  auto field = CreateField(fi, CreateMesh(fi, n, n, n, Point(-1, -1, -1), Point(1, 1, 1)));
+  auto mesh = field->vmesh();
+  for (VMesh::index_type i = 0; i < mesh->num_elems(); ++i)
+  {
+    const VMesh::Elem::index_type c(i);
+    Point center;
+    mesh->get_center(center, c);
+    field->vfield()->set_value(center.x() < 0 ? 1.0 : 2.0, c);
+  }
+
+  auto outer = getVolumeBoundaryFaces(field, false);
+  EXPECT_EQ(outer, getVolumeBoundaryFaces(field, false));
+  EXPECT_EQ(6 * (n - 1) * (n - 1), outer->faces.size());
+
+  auto domains = getVolumeBoundaryFaces(field, true);
+  EXPECT_NE(outer, domains);
+  EXPECT_EQ(outer->faces.size() + (n - 1) * (n - 1), domains->faces.size());
+  EXPECT_EQ(domains, getVolumeBoundaryFaces(field, true));
+}
+
+TEST(VolumeBoundaryFacesTest, CacheIsDroppedWhenMeshIsEdited)
+{
+  auto field = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  auto cached = getVolumeBoundaryFaces(field, false);
+  ASSERT_EQ(4, cached->faces.size());
+  EXPECT_EQ(cached, getVolumeBoundaryFaces(field, false));
+
+  // Moving a node keeps the node and element counts.
+  auto mesh = field->vmesh();
+  const VMesh::Node::index_type node(0);
+  Point p;
+  mesh->get_point(p, node);
+  mesh->set_point(p + Vector(0.25, 0, 0), node);
+
+  auto edited = getVolumeBoundaryFaces(field, false);
+  EXPECT_NE(cached, edited);
+  EXPECT_EQ(edited, getVolumeBoundaryFaces(field, false));
+}
+
+TEST(VolumeBoundaryFacesTest, AssignedMeshDoesNotShareCache)
+{
+  auto field = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  auto other = TetrahedronTetVolLinearBasis(DOUBLE_E);
+  auto cached = getVolumeBoundaryFaces(field, false);
+
+  *other->mesh() = *field->mesh();
+  EXPECT_EQ(cached, getVolumeBoundaryFaces(field, false));
+  EXPECT_NE(cached, getVolumeBoundaryFaces(other, false));
+  EXPECT_EQ(cached, getVolumeBoundaryFaces(field, false));
+}
+
+namespace
+{
+  std::vector<std::string> geometryBuffers(DatatypeHandle data)
+  {
+    std::vector<std::string> buffers;
+    auto geom = boost::dynamic_pointer_cast<Graphics::Datatypes::GeometryObjectSpire>(data);
+    if (!geom) return buffers;
+    for (const auto& vbo : geom->vbos())
+      buffers.emplace_back(vbo.data->getBuffer(), vbo.data->getBufferSize());
+    for (const auto& ibo : geom->ibos())
+      buffers.emplace_back(ibo.data->getBuffer(), ibo.data->getBufferSize());
+    return buffers;
+  }
+}
+
+TEST_F(ShowFieldPerformanceTest, BoundaryFacesOnlyShrinksFaceGeometry)
+{
+  LogSettings::Instance().setVerbose(false);
+  UseRealModuleStateFactory f;
+  auto showField = makeModule("ShowField");
+  showField->setStateDefaults();
+  auto state = showField->get_state();
+  EXPECT_FALSE(state->getValue(BoundaryFacesOnly).toBool());
+  state->setValue(ShowFaces, true);
+  state->setValue(ShowEdges, false);
+  state->setValue(ShowNodes, false);
+  state->setValue(FacesColoring, 1);
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create());
+  stubPortNWithThisData(showField, 0, CreateEmptyLatVol(12, 12, 12));
+
+  size_t bytes[2];
+  for (bool boundaryOnly : { false, true })
+  {
+    state->setValue(BoundaryFacesOnly, boundaryOnly);
+    showField->execute();
+    size_t total = 0;
+    for (const auto& buffer : geometryBuffers(getDataOnThisOutputPort(showField, 0)))
+      total += buffer.size();
+    bytes[boundaryOnly] = total;
+  }
+  EXPECT_GT(bytes[1], 0u);
+  EXPECT_LT(bytes[1], bytes[0]);
+}
+
+TEST_F(ShowFieldPerformanceTest, ParallelGeometryBuffersMatchSingleThreaded)
+{
+  LogSettings::Instance().setVerbose(false);
+  UseRealModuleStateFactory f;
+  auto showField = makeModule("ShowField");
+  showField->setStateDefaults();
+  auto state = showField->get_state();
+  state->setValue(ShowFaces, true);
+  state->setValue(ShowEdges, true);
+  state->setValue(ShowNodes, true);
+  state->setValue(NodeAsSpheres, 1);
+  state->setValue(EdgesAsCylinders, 1);
+  state->setValue(BoundaryFacesOnly, false);
+  state->setValue(FacesColoring, 1);
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create());
+  stubPortNWithThisData(showField, 0, CreateEmptyLatVol(24, 24, 24));
+
+  std::vector<std::string> reference;
+  for (unsigned int cores : { 1u, 0u })
+  {
+    Thread::Parallel::SetMaximumCores(cores);
+    showField->execute();
+    Thread::Parallel::SetMaximumCores(0);
+
+    auto buffers = geometryBuffers(getDataOnThisOutputPort(showField, 0));
+    ASSERT_FALSE(buffers.empty());
+    if (reference.empty())
+      reference = buffers;
+    else
+      EXPECT_EQ(reference, buffers);
+  }
+}